@@ -1,12 +1,21 @@
 #version 330 core
 
+// warianty (Shader.h): HAS_TEXTURE, PACKED_MATERIALS wstawiane za #version
 struct Material {
     vec3 diffuseColor;
     sampler2D diffuseMap;
-    int hasTexture;
 };
 
 uniform Material uMaterial;
+
+#ifdef PACKED_MATERIALS
+// materiały upakowane (ModelMaterials.h): jedno wywołanie na tablicę tekstur
+uniform sampler2DArray uMaterialArray;
+uniform samplerBuffer  uMaterialData;  // 2 texele na materiał: (Kd, warstwa), (skala UV, przesunięcie UV)
+uniform usamplerBuffer uMaterialIds;   // materiał każdego trójkąta
+uniform int uPrimitiveBase;            // pierwszy trójkąt wywołania
+#endif
+
 uniform vec3 uLightDir;
 uniform vec3 uViewPos;
 
@@ -16,6 +25,26 @@ in vec2 TexCoord;
 
 out vec4 FragColor;
 
+vec3 material_color()
+{
+#ifdef PACKED_MATERIALS
+    int id = int(texelFetch(uMaterialIds, uPrimitiveBase + gl_PrimitiveID).r);
+    vec4 colorLayer = texelFetch(uMaterialData, id * 2);
+    vec4 uvTransform = texelFetch(uMaterialData, id * 2 + 1);
+
+    // fract() powtarza teksturę w obrębie fragmentu atlasu; pochodne
+    // z ciągłych UV, żeby szew fract() nie wybierał najmniejszej mipmapy
+    vec2 uv = uvTransform.zw + fract(TexCoord) * uvTransform.xy;
+    vec2 dx = dFdx(TexCoord) * uvTransform.xy;
+    vec2 dy = dFdy(TexCoord) * uvTransform.xy;
+    return colorLayer.rgb * textureGrad(uMaterialArray, vec3(uv, colorLayer.w), dx, dy).rgb;
+#elif defined(HAS_TEXTURE)
+    return uMaterial.diffuseColor * texture(uMaterial.diffuseMap, TexCoord).rgb;
+#else
+    return uMaterial.diffuseColor;
+#endif
+}
+
 void main()
 {
     vec3 norm = normalize(Normal);
@@ -23,10 +52,7 @@ void main()
 
     float diff = max(dot(norm, lightDir), 0.0);
 
-    vec3 baseColor = uMaterial.diffuseColor;
-    if (uMaterial.hasTexture == 1) {
-        baseColor *= texture(uMaterial.diffuseMap, TexCoord).rgb;
-    }
+    vec3 baseColor = material_color();
 
     vec3 ambient = 0.1 * baseColor;
     vec3 diffuse = diff * baseColor;
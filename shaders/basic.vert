@@ -4,19 +4,32 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoord;
 
-uniform mat4 uModel;
-uniform mat4 uView;
-uniform mat4 uProjection;
+// macierze z pierścieniowego bufora (GpuRing), układ std140
+layout (std140) uniform PerFrame
+{
+    mat4 uView;
+    mat4 uProjection;
+};
+
+layout (std140) uniform PerDraw
+{
+    mat4 uModel;
+    mat3 uNormalMatrix; // transpose(inverse(mat3(uModel))) liczona na CPU
+};
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoord;
 
+// głębia identyczna z shaders/depth.vert (GL_EQUAL po przebiegu głębi)
+invariant gl_Position;
+
 void main()
 {
-    FragPos = vec3(uModel * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(uModel))) * aNormal;
+    vec4 worldPos = uModel * vec4(aPos, 1.0);
+    FragPos = worldPos.xyz;
+    Normal = uNormalMatrix * aNormal;
     TexCoord = aTexCoord;
 
-    gl_Position = uProjection * uView * vec4(FragPos, 1.0);
+    gl_Position = uProjection * (uView * worldPos);
 }
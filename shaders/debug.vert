@@ -0,0 +1,18 @@
+#version 330 core
+
+layout (location = 0) in vec3 aPos;   // przestrzeń świata
+layout (location = 1) in vec3 aColor;
+
+layout (std140) uniform PerFrame
+{
+    mat4 uView;
+    mat4 uProjection;
+};
+
+out vec3 Color;
+
+void main()
+{
+    Color = aColor;
+    gl_Position = uProjection * uView * vec4(aPos, 1.0);
+}
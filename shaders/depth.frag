@@ -0,0 +1,6 @@
+#version 330 core
+
+// tylko głębia (zapis koloru wyłączony glColorMask)
+void main()
+{
+}
@@ -0,0 +1,24 @@
+#version 330 core
+
+// przebieg samej głębi (DepthPrepass): tylko strumień pozycji Mesh.positionVBO
+layout (location = 0) in vec3 aPos;
+
+layout (std140) uniform PerFrame
+{
+    mat4 uView;
+    mat4 uProjection;
+};
+
+layout (std140) uniform PerDraw
+{
+    mat4 uModel;
+    mat3 uNormalMatrix;
+};
+
+// główny przebieg testuje GL_EQUAL: ta sama kolejność działań co w basic/phong.vert
+invariant gl_Position;
+
+void main()
+{
+    gl_Position = uProjection * (uView * (uModel * vec4(aPos, 1.0)));
+}
@@ -0,0 +1,25 @@
+#version 330 core
+
+// pudełko testu zasłonięcia (OcclusionCull): sześcian [0,1]^3 rozciągnięty na AABB siatki
+layout (location = 0) in vec3 aPos;
+
+layout (std140) uniform PerFrame
+{
+    mat4 uView;
+    mat4 uProjection;
+};
+
+layout (std140) uniform PerDraw
+{
+    mat4 uModel;
+    mat3 uNormalMatrix;
+};
+
+uniform vec3 uBoxMin;
+uniform vec3 uBoxMax;
+
+void main()
+{
+    vec3 p = mix(uBoxMin, uBoxMax, aPos);
+    gl_Position = uProjection * (uView * (uModel * vec4(p, 1.0)));
+}
@@ -0,0 +1,130 @@
+#version 330 core
+
+// musi zgadzać się z ClusteredLights.h
+#define CLUSTER_X 16
+#define CLUSTER_Y 9
+#define CLUSTER_Z 24
+#define LIGHT_TEXELS 4
+#define LIGHT_SPOT 1
+
+// warianty (Shader.h): HAS_TEXTURE, PACKED_MATERIALS wstawiane za #version
+struct Material {
+    vec3 diffuseColor;
+    sampler2D diffuseMap;
+};
+
+uniform Material uMaterial;
+
+#ifdef PACKED_MATERIALS
+// materiały upakowane (ModelMaterials.h): jedno wywołanie na tablicę tekstur
+uniform sampler2DArray uMaterialArray;
+uniform samplerBuffer  uMaterialData;  // 2 texele na materiał: (Kd, warstwa), (skala UV, przesunięcie UV)
+uniform usamplerBuffer uMaterialIds;   // materiał każdego trójkąta
+uniform int uPrimitiveBase;            // pierwszy trójkąt wywołania
+#endif
+
+uniform vec3 uLightDir;      // światło kierunkowe (przestrzeń świata)
+
+layout (std140) uniform PerFrame
+{
+    mat4 uView;
+    mat4 uProjection;
+};
+uniform float uShininess;
+
+uniform samplerBuffer  uLightData;    // 4 texele na światło
+uniform usamplerBuffer uClusterGrid;  // (offset, count) na klaster
+uniform usamplerBuffer uLightIndices; // indeksy świateł
+uniform vec4 uClusterParams;          // near, far, CLUSTER_Z / log(far/near), -
+uniform vec2 uScreenSize;
+
+in vec3 ViewPos;
+in vec3 ViewNormal;
+in vec2 TexCoord;
+
+out vec4 FragColor;
+
+/**
+ * Wygaszanie z oknem: zero dokładnie na promieniu światła,
+ * więc światło spoza klastra nie daje skoku jasności.
+ */
+float attenuation(float dist, float radius)
+{
+    float x = dist / radius;
+    float window = clamp(1.0 - x * x * x * x, 0.0, 1.0);
+    return window * window / (1.0 + dist * dist);
+}
+
+int cluster_index()
+{
+    ivec2 tile = ivec2(gl_FragCoord.xy / uScreenSize * vec2(CLUSTER_X, CLUSTER_Y));
+    tile = clamp(tile, ivec2(0), ivec2(CLUSTER_X - 1, CLUSTER_Y - 1));
+
+    float depth = max(-ViewPos.z, uClusterParams.x);
+    int slice = int(log(depth / uClusterParams.x) * uClusterParams.z);
+    slice = clamp(slice, 0, CLUSTER_Z - 1);
+
+    return (slice * CLUSTER_Y + tile.y) * CLUSTER_X + tile.x;
+}
+
+vec3 material_color()
+{
+#ifdef PACKED_MATERIALS
+    int id = int(texelFetch(uMaterialIds, uPrimitiveBase + gl_PrimitiveID).r);
+    vec4 colorLayer = texelFetch(uMaterialData, id * 2);
+    vec4 uvTransform = texelFetch(uMaterialData, id * 2 + 1);
+
+    // fract() powtarza teksturę w obrębie fragmentu atlasu; pochodne
+    // z ciągłych UV, żeby szew fract() nie wybierał najmniejszej mipmapy
+    vec2 uv = uvTransform.zw + fract(TexCoord) * uvTransform.xy;
+    vec2 dx = dFdx(TexCoord) * uvTransform.xy;
+    vec2 dy = dFdy(TexCoord) * uvTransform.xy;
+    return colorLayer.rgb * textureGrad(uMaterialArray, vec3(uv, colorLayer.w), dx, dy).rgb;
+#elif defined(HAS_TEXTURE)
+    return uMaterial.diffuseColor * texture(uMaterial.diffuseMap, TexCoord).rgb;
+#else
+    return uMaterial.diffuseColor;
+#endif
+}
+
+void main()
+{
+    vec3 N = normalize(ViewNormal);
+    vec3 V = normalize(-ViewPos);
+
+    vec3 baseColor = material_color();
+
+    // ambient + światło kierunkowe (jak basic.frag)
+    vec3 sunDir = normalize(mat3(uView) * -uLightDir);
+    vec3 color = 0.1 * baseColor + max(dot(N, sunDir), 0.0) * baseColor;
+
+    // tylko światła przypisane do klastra tego fragmentu
+    uvec2 range = texelFetch(uClusterGrid, cluster_index()).xy;
+    for (uint i = 0u; i < range.y; i++) {
+        int li = int(texelFetch(uLightIndices, int(range.x + i)).r) * LIGHT_TEXELS;
+
+        vec4 posRadius = texelFetch(uLightData, li + 0);
+        vec4 colorType = texelFetch(uLightData, li + 1);
+
+        vec3 toLight = posRadius.xyz - ViewPos;
+        float dist = length(toLight);
+        if (dist >= posRadius.w)
+            continue;
+        vec3 L = toLight / dist;
+
+        float att = attenuation(dist, posRadius.w);
+        if (int(colorType.w) == LIGHT_SPOT) {
+            vec4 dirOuter = texelFetch(uLightData, li + 2);
+            float cosInner = texelFetch(uLightData, li + 3).x;
+            att *= smoothstep(dirOuter.w, cosInner, dot(-L, dirOuter.xyz));
+        }
+
+        float diff = max(dot(N, L), 0.0);
+        vec3 H = normalize(L + V);
+        float spec = diff > 0.0 ? pow(max(dot(N, H), 0.0), uShininess) : 0.0;
+
+        color += att * colorType.rgb * (diff * baseColor + 0.25 * spec);
+    }
+
+    FragColor = vec4(color, 1.0);
+}
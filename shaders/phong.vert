@@ -0,0 +1,35 @@
+#version 330 core
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoord;
+
+// macierze z pierścieniowego bufora (GpuRing), układ std140
+layout (std140) uniform PerFrame
+{
+    mat4 uView;
+    mat4 uProjection;
+};
+
+layout (std140) uniform PerDraw
+{
+    mat4 uModel;
+    mat3 uNormalMatrix; // transpose(inverse(mat3(uModel))) liczona na CPU
+};
+
+out vec3 ViewPos;    // pozycja w przestrzeni widoku (światła klastrów są w view space)
+out vec3 ViewNormal;
+out vec2 TexCoord;
+
+// głębia identyczna z shaders/depth.vert (GL_EQUAL po przebiegu głębi)
+invariant gl_Position;
+
+void main()
+{
+    vec4 viewPos = uView * (uModel * vec4(aPos, 1.0));
+    ViewPos = viewPos.xyz;
+    ViewNormal = mat3(uView) * (uNormalMatrix * aNormal);
+    TexCoord = aTexCoord;
+
+    gl_Position = uProjection * viewPos;
+}
@@ -0,0 +1,13 @@
+#version 330 core
+
+in vec3 Color;
+out vec4 FragColor;
+
+void main()
+{
+    // okrągłe punkty zamiast kwadratów
+    vec2 d = gl_PointCoord * 2.0 - 1.0;
+    if (dot(d, d) > 1.0)
+        discard;
+    FragColor = vec4(Color, 1.0);
+}
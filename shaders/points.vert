@@ -0,0 +1,30 @@
+#version 330 core
+
+layout (location = 0) in vec3 aPos;   // współrzędne względem węzła octree (0..65535)
+layout (location = 1) in vec4 aColor; // RGBA8 znormalizowane
+
+layout (std140) uniform PerFrame
+{
+    mat4 uView;
+    mat4 uProjection;
+};
+
+layout (std140) uniform PerDraw
+{
+    mat4 uModel;
+    mat3 uNormalMatrix;
+};
+
+uniform vec3 uNodeMin;     // narożnik węzła
+uniform float uNodeScale;  // jednostka współrzędnej węzła
+uniform float uPointSize;  // odstęp punktów węzła na ekranie (px)
+
+out vec3 Color;
+
+void main()
+{
+    vec3 pos = uNodeMin + (aPos + 0.5) * uNodeScale;
+    Color = aColor.rgb;
+    gl_Position = uProjection * uView * uModel * vec4(pos, 1.0);
+    gl_PointSize = uPointSize;
+}
@@ -0,0 +1,33 @@
+#version 330 core
+
+// obraz sceny zajmuje lewy dolny fragment tekstury o rozmiarze okna
+uniform sampler2D uSource;
+uniform vec2 uUvScale;    // rozmiar renderowania / rozmiar tekstury
+uniform vec2 uTexelSize;  // 1 / rozmiar tekstury
+uniform float uSharpness; // 0 = dwuliniowo
+
+in vec2 TexCoord;
+
+out vec4 FragColor;
+
+vec3 fetch(vec2 uv)
+{
+    // środki skrajnych texeli: filtr nie sięga poza narysowany fragment
+    return texture(uSource, clamp(uv, 0.5 * uTexelSize, uUvScale - 0.5 * uTexelSize)).rgb;
+}
+
+void main()
+{
+    vec2 uv = TexCoord * uUvScale;
+    vec3 c = fetch(uv);
+    vec3 n = fetch(uv + vec2(0.0, uTexelSize.y));
+    vec3 s = fetch(uv - vec2(0.0, uTexelSize.y));
+    vec3 e = fetch(uv + vec2(uTexelSize.x, 0.0));
+    vec3 w = fetch(uv - vec2(uTexelSize.x, 0.0));
+
+    // maska wyostrzająca, obcięta do zakresu sąsiadów: bez jasnych/ciemnych obwódek
+    vec3 sharp = c + uSharpness * (c - 0.25 * (n + s + e + w));
+    vec3 lo = min(c, min(min(n, s), min(e, w)));
+    vec3 hi = max(c, max(max(n, s), max(e, w)));
+    FragColor = vec4(clamp(sharp, lo, hi), 1.0);
+}
@@ -0,0 +1,109 @@
+#include "AssetPack.h"
+#include <stdio.h>
+#include <string.h>
+
+uint64_t asset_pack_hash(const char *name)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (const unsigned char *p = (const unsigned char *)name; *p; p++)
+    {
+        h ^= *p;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+int asset_pack_open(AssetPack *pack, const char *path)
+{
+    memset(pack, 0, sizeof(*pack));
+    if (!mapped_file_open(path, &pack->file))
+        return 0;
+
+    const unsigned char *base = pack->file.data;
+    size_t size = pack->file.size;
+    const AssetPackHeader *h = (const AssetPackHeader *)base;
+
+    if (size < sizeof(AssetPackHeader) || h->magic != ASSET_PACK_MAGIC || h->version != ASSET_PACK_VERSION)
+    {
+        printf("ERROR: not an asset pack: %s\n", path);
+        asset_pack_close(pack);
+        return 0;
+    }
+    if (h->slot_count == 0 || (h->slot_count & (h->slot_count - 1)) != 0 ||
+        h->dir_offset + (uint64_t)h->slot_count * sizeof(AssetPackEntry) > size ||
+        h->names_offset + h->names_size > size || h->names_size == 0 ||
+        base[h->names_offset + h->names_size - 1] != '\0')
+    {
+        printf("ERROR: corrupted asset pack directory: %s\n", path);
+        asset_pack_close(pack);
+        return 0;
+    }
+
+    pack->header = h;
+    pack->slots = (const AssetPackEntry *)(base + h->dir_offset);
+    pack->names = (const char *)(base + h->names_offset);
+    return 1;
+}
+
+const AssetPackEntry *asset_pack_find(const AssetPack *pack, const char *name, AssetType type)
+{
+    if (!pack->header)
+        return NULL;
+
+    uint64_t hash = asset_pack_hash(name);
+    uint32_t mask = pack->header->slot_count - 1;
+
+    for (uint32_t i = 0, slot = (uint32_t)hash & mask; i <= mask; i++, slot = (slot + 1) & mask)
+    {
+        const AssetPackEntry *e = &pack->slots[slot];
+        if (e->type == ASSET_NONE)
+            return NULL;
+        if (e->hash != hash || e->name_offset >= pack->header->names_size ||
+            strcmp(pack->names + e->name_offset, name) != 0)
+            continue;
+        if (type != ASSET_NONE && e->type != (uint32_t)type)
+            return NULL;
+        if (e->offset + e->size > pack->file.size)
+        {
+            printf("ERROR: asset pack entry out of bounds: %s\n", name);
+            return NULL;
+        }
+        return e;
+    }
+    return NULL;
+}
+
+const void *asset_pack_data(const AssetPack *pack, const AssetPackEntry *entry)
+{
+    return pack->file.data + entry->offset;
+}
+
+int asset_pack_mesh(const AssetPack *pack, const char *name, const AssetMeshHeader **header,
+                    const void **vertices, const uint32_t **indices)
+{
+    const AssetPackEntry *e = asset_pack_find(pack, name, ASSET_MESH);
+    if (!e || e->size < sizeof(AssetMeshHeader))
+        return 0;
+
+    const AssetMeshHeader *h = (const AssetMeshHeader *)asset_pack_data(pack, e);
+    // Vertex = 8 floatów (patrz Mesh.h)
+    uint64_t vbytes = (uint64_t)h->vertex_count * 8 * sizeof(float);
+    uint64_t ibytes = (uint64_t)h->index_count * sizeof(uint32_t);
+    if (sizeof(AssetMeshHeader) + vbytes + ibytes > e->size)
+    {
+        printf("ERROR: truncated mesh entry: %s\n", name);
+        return 0;
+    }
+
+    const unsigned char *p = (const unsigned char *)h + sizeof(AssetMeshHeader);
+    *header = h;
+    *vertices = p;
+    *indices = (const uint32_t *)(p + vbytes);
+    return 1;
+}
+
+void asset_pack_close(AssetPack *pack)
+{
+    mapped_file_close(&pack->file);
+    memset(pack, 0, sizeof(*pack));
+}
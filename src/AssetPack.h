@@ -0,0 +1,152 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "MappedFile.h"
+
+/**
+ * @brief Format pliku .pak — wszystkie zasoby sceny w jednym pliku.
+ *
+ * Układ pliku:
+ *  - AssetPackHeader (offset 0),
+ *  - dane wpisów, każdy wyrównany do ASSET_PACK_ALIGN,
+ *  - katalog: AssetPackEntry[slot_count] — tablica mieszająca
+ *    (open addressing, slot_count to potęga 2, pusty slot: type == 0),
+ *  - tablica nazw (ciągi zakończone zerem).
+ *
+ * Nazwą wpisu jest ścieżka, pod którą zasób leżałby jako luźny plik
+ * (np. "assets/textures/texture.png"), więc ten sam kod może czytać
+ * z paczki albo z dysku. Plik jest mapowany w całości; dane wpisów
+ * trafiają do glBufferData/glTexImage2D prosto z mapowania (bez kopii).
+ */
+
+#define ASSET_PACK_MAGIC 0x314B4150u /* "PAK1" */
+#define ASSET_PACK_VERSION 1u
+#define ASSET_PACK_ALIGN 64u
+#define ASSET_TEXTURE_MAX_LEVELS 16
+
+typedef enum AssetType
+{
+    ASSET_NONE = 0,
+    ASSET_MESH = 1,     // AssetMeshHeader + Vertex[] + uint32[]
+    ASSET_MATERIAL = 2, // AssetMaterialRecord
+    ASSET_TEXTURE = 3   // AssetTextureHeader + poziomy mip
+} AssetType;
+
+typedef struct AssetPackHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t slot_count;
+    uint64_t dir_offset;
+    uint64_t names_offset;
+    uint64_t names_size;
+} AssetPackHeader;
+
+typedef struct AssetPackEntry
+{
+    uint64_t hash;        // FNV-1a 64 nazwy
+    uint64_t offset;      // od początku pliku
+    uint64_t size;
+    uint32_t type;        // AssetType
+    uint32_t name_offset; // w tablicy nazw
+} AssetPackEntry;
+
+/**
+ * @brief Siatka gotowa do mesh_create(): po nagłówku Vertex[], potem indeksy.
+ */
+typedef struct AssetMeshHeader
+{
+    uint32_t vertex_count;
+    uint32_t index_count;
+    float bmin[3];
+    float bmax[3];
+} AssetMeshHeader;
+
+/**
+ * @brief Materiał (odpowiednik jednego pliku MTL).
+ */
+typedef struct AssetMaterialRecord
+{
+    float diffuse[3];
+    uint32_t reserved;
+    char diffuse_map[240]; // nazwa wpisu tekstury ("" jeśli brak)
+} AssetMaterialRecord;
+
+/**
+ * @brief Tekstura z gotowym łańcuchem mipmap (już odwrócona w pionie).
+ */
+typedef struct AssetTextureHeader
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t channels; // 3 = RGB, 4 = RGBA
+    uint32_t levels;
+    uint64_t level_offset[ASSET_TEXTURE_MAX_LEVELS]; // od początku wpisu
+} AssetTextureHeader;
+
+/**
+ * @brief Otwarta (zmapowana) paczka.
+ */
+typedef struct AssetPack
+{
+    MappedFile file;
+    const AssetPackHeader *header;
+    const AssetPackEntry *slots;
+    const char *names;
+} AssetPack;
+
+/**
+ * @brief Hash nazwy wpisu (FNV-1a 64).
+ */
+uint64_t asset_pack_hash(const char *name);
+
+/**
+ * @brief Mapuje paczkę i sprawdza nagłówek oraz granice katalogu.
+ *
+ * @param pack Paczka wyjściowa.
+ * @param path Ścieżka do pliku .pak.
+ * @return 1 jeśli OK, 0 jeśli błąd.
+ */
+int asset_pack_open(AssetPack *pack, const char *path);
+
+/**
+ * @brief Szuka wpisu po nazwie (jedno wyliczenie hasha + sondowanie).
+ *
+ * @param pack Paczka.
+ * @param name Nazwa wpisu.
+ * @param type Oczekiwany typ (ASSET_NONE = dowolny).
+ * @return Wpis lub NULL jeśli brak.
+ */
+const AssetPackEntry *asset_pack_find(const AssetPack *pack, const char *name, AssetType type);
+
+/**
+ * @brief Wskaźnik na dane wpisu w zmapowanym pliku.
+ */
+const void *asset_pack_data(const AssetPack *pack, const AssetPackEntry *entry);
+
+/**
+ * @brief Siatka z paczki: wskaźniki prosto do mapowania (bez kopii).
+ *
+ * @return 1 jeśli OK, 0 jeśli brak wpisu / uszkodzony wpis.
+ */
+int asset_pack_mesh(const AssetPack *pack, const char *name, const AssetMeshHeader **header,
+                    const void **vertices, const uint32_t **indices);
+
+/**
+ * @brief Odmapowuje paczkę.
+ */
+void asset_pack_close(AssetPack *pack);
+
+/**
+ * @brief Buduje paczkę z luźnych plików (.obj, .mtl, obrazy).
+ *
+ * .mtl dokłada też swoją teksturę map_Kd; obrazy dostają łańcuch mipmap.
+ *
+ * @param out_path Wyjściowy plik .pak.
+ * @param inputs   Ścieżki plików (stają się nazwami wpisów).
+ * @param count    Liczba plików.
+ * @return 1 jeśli OK, 0 jeśli błąd.
+ */
+int asset_pack_build(const char *out_path, const char **inputs, int count);
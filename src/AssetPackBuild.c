@@ -0,0 +1,361 @@
+#include "AssetPack.h"
+#include "ObjLoader.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* stb_image (narzędzie nie linkuje Material.c) */
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+/**
+ * @brief Wpis zapisany już do pliku (katalog powstaje na końcu).
+ */
+typedef struct PackItem
+{
+    char name[256];
+    uint32_t type;
+    uint64_t offset;
+    uint64_t size;
+} PackItem;
+
+typedef struct PackWriter
+{
+    FILE *out;
+    uint64_t offset;
+    PackItem *items;
+    size_t count;
+    size_t capacity;
+} PackWriter;
+
+/* =========================================================
+   Zapis
+   ========================================================= */
+
+static int write_bytes(PackWriter *w, const void *data, size_t bytes)
+{
+    if (bytes && fwrite(data, 1, bytes, w->out) != bytes)
+        return 0;
+    w->offset += bytes;
+    return 1;
+}
+
+static int pad_to(PackWriter *w, uint64_t align)
+{
+    static const unsigned char zeros[ASSET_PACK_ALIGN] = {0};
+    uint64_t rem = w->offset % align;
+    return rem == 0 || write_bytes(w, zeros, (size_t)(align - rem));
+}
+
+static int has_item(const PackWriter *w, const char *name)
+{
+    for (size_t i = 0; i < w->count; i++)
+        if (strcmp(w->items[i].name, name) == 0)
+            return 1;
+    return 0;
+}
+
+/**
+ * @brief Rozpoczyna wpis: wyrównanie + rejestracja w katalogu.
+ */
+static PackItem *begin_item(PackWriter *w, const char *name, AssetType type)
+{
+    if (strlen(name) >= sizeof(w->items[0].name))
+    {
+        printf("ERROR: asset name too long: %s\n", name);
+        return NULL;
+    }
+    if (w->count + 1 > w->capacity)
+    {
+        size_t newCap = w->capacity ? w->capacity * 2 : 64;
+        PackItem *n = (PackItem *)realloc(w->items, newCap * sizeof(PackItem));
+        if (!n)
+            return NULL;
+        w->items = n;
+        w->capacity = newCap;
+    }
+    if (!pad_to(w, ASSET_PACK_ALIGN))
+        return NULL;
+
+    PackItem *it = &w->items[w->count++];
+    strcpy(it->name, name);
+    it->type = (uint32_t)type;
+    it->offset = w->offset;
+    it->size = 0;
+    return it;
+}
+
+/* =========================================================
+   Zasoby
+   ========================================================= */
+
+static int add_mesh(PackWriter *w, const char *path)
+{
+    ObjModelData data;
+    if (!obj_load(path, &data))
+        return 0;
+
+    AssetMeshHeader h;
+    memset(&h, 0, sizeof(h));
+    h.vertex_count = (uint32_t)data.vertex_count;
+    h.index_count = (uint32_t)data.index_count;
+    obj_compute_bounds(&data, h.bmin, h.bmax);
+
+    PackItem *it = begin_item(w, path, ASSET_MESH);
+    int ok = it != NULL;
+    ok = ok && write_bytes(w, &h, sizeof(h));
+    ok = ok && write_bytes(w, data.vertices, data.vertex_count * sizeof(Vertex));
+    ok = ok && write_bytes(w, data.indices, data.index_count * sizeof(unsigned int));
+    if (ok)
+        it->size = w->offset - it->offset;
+
+    obj_free(&data);
+    return ok;
+}
+
+/**
+ * @brief Poziom mip o połowę mniejszy (filtr pudełkowy 2x2).
+ */
+static void downsample(const unsigned char *src, int sw, int sh, unsigned char *dst, int dw, int dh, int ch)
+{
+    for (int y = 0; y < dh; y++)
+    {
+        int y0 = y * 2 < sh ? y * 2 : sh - 1;
+        int y1 = y * 2 + 1 < sh ? y * 2 + 1 : y0;
+        for (int x = 0; x < dw; x++)
+        {
+            int x0 = x * 2 < sw ? x * 2 : sw - 1;
+            int x1 = x * 2 + 1 < sw ? x * 2 + 1 : x0;
+            for (int c = 0; c < ch; c++)
+            {
+                int s = src[(y0 * sw + x0) * ch + c] + src[(y0 * sw + x1) * ch + c] +
+                        src[(y1 * sw + x0) * ch + c] + src[(y1 * sw + x1) * ch + c];
+                dst[(y * dw + x) * ch + c] = (unsigned char)((s + 2) / 4);
+            }
+        }
+    }
+}
+
+static int add_texture(PackWriter *w, const char *path)
+{
+    int width, height, n;
+    // jak load_texture_2d(): obraz odwrócony w pionie, RGB albo RGBA
+    stbi_set_flip_vertically_on_load(1);
+    if (!stbi_info(path, &width, &height, &n))
+    {
+        printf("Failed to load texture: %s\n", path);
+        return 0;
+    }
+    int ch = n == 3 ? 3 : 4;
+    unsigned char *level = stbi_load(path, &width, &height, &n, ch);
+    if (!level)
+    {
+        printf("Failed to load texture: %s\n", path);
+        return 0;
+    }
+
+    AssetTextureHeader h;
+    memset(&h, 0, sizeof(h));
+    h.width = (uint32_t)width;
+    h.height = (uint32_t)height;
+    h.channels = (uint32_t)ch;
+
+    // offsety poziomów: zaraz po nagłówku, jeden za drugim
+    uint64_t off = sizeof(h);
+    int lw = width, lh = height;
+    while (h.levels < ASSET_TEXTURE_MAX_LEVELS)
+    {
+        h.level_offset[h.levels++] = off;
+        off += (uint64_t)lw * lh * ch;
+        if (lw == 1 && lh == 1)
+            break;
+        lw = lw > 1 ? lw / 2 : 1;
+        lh = lh > 1 ? lh / 2 : 1;
+    }
+
+    PackItem *it = begin_item(w, path, ASSET_TEXTURE);
+    int ok = it != NULL && write_bytes(w, &h, sizeof(h));
+
+    lw = width;
+    lh = height;
+    int fromStb = 1; // poziom 0 zwalnia stbi_image_free, kolejne free
+    for (uint32_t l = 0; ok && l < h.levels; l++)
+    {
+        ok = write_bytes(w, level, (size_t)lw * lh * ch);
+        if (!ok || l + 1 == h.levels)
+            break;
+
+        int nw = lw > 1 ? lw / 2 : 1;
+        int nh = lh > 1 ? lh / 2 : 1;
+        unsigned char *next = (unsigned char *)malloc((size_t)nw * nh * ch);
+        if (!next)
+        {
+            ok = 0;
+            break;
+        }
+        downsample(level, lw, lh, next, nw, nh, ch);
+        if (fromStb)
+            stbi_image_free(level);
+        else
+            free(level);
+        level = next;
+        fromStb = 0;
+        lw = nw;
+        lh = nh;
+    }
+    if (fromStb)
+        stbi_image_free(level);
+    else
+        free(level);
+
+    if (ok)
+        it->size = w->offset - it->offset;
+    return ok;
+}
+
+static int add_material(PackWriter *w, const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+    {
+        printf("Cannot open MTL: %s\n", path);
+        return 0;
+    }
+
+    AssetMaterialRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.diffuse[0] = rec.diffuse[1] = rec.diffuse[2] = 1.0f;
+
+    // ten sam podzbiór co material_load_mtl()
+    char line[512];
+    while (fgets(line, sizeof(line), f))
+    {
+        if (strncmp(line, "Kd ", 3) == 0)
+            sscanf(line, "Kd %f %f %f", &rec.diffuse[0], &rec.diffuse[1], &rec.diffuse[2]);
+        else if (strncmp(line, "map_Kd ", 7) == 0)
+            sscanf(line, "map_Kd %239s", rec.diffuse_map);
+    }
+    fclose(f);
+
+    PackItem *it = begin_item(w, path, ASSET_MATERIAL);
+    int ok = it != NULL && write_bytes(w, &rec, sizeof(rec));
+    if (ok)
+        it->size = sizeof(rec);
+
+    if (ok && rec.diffuse_map[0] && !has_item(w, rec.diffuse_map))
+        ok = add_texture(w, rec.diffuse_map);
+    return ok;
+}
+
+static int has_extension(const char *path, const char *ext)
+{
+    size_t n = strlen(path), e = strlen(ext);
+    if (n < e)
+        return 0;
+    for (size_t i = 0; i < e; i++)
+    {
+        char c = path[n - e + i];
+        if (c >= 'A' && c <= 'Z')
+            c = (char)(c - 'A' + 'a');
+        if (c != ext[i])
+            return 0;
+    }
+    return 1;
+}
+
+/* =========================================================
+   Katalog
+   ========================================================= */
+
+static int write_directory(PackWriter *w, AssetPackHeader *h)
+{
+    uint32_t slots = 16;
+    while (slots < w->count * 2)
+        slots <<= 1;
+
+    AssetPackEntry *dir = (AssetPackEntry *)calloc(slots, sizeof(AssetPackEntry));
+    if (!dir)
+        return 0;
+
+    uint32_t nameOffset = 0;
+    for (size_t i = 0; i < w->count; i++)
+    {
+        const PackItem *it = &w->items[i];
+        uint64_t hash = asset_pack_hash(it->name);
+        uint32_t slot = (uint32_t)hash & (slots - 1);
+        while (dir[slot].type != ASSET_NONE)
+            slot = (slot + 1) & (slots - 1);
+
+        dir[slot].hash = hash;
+        dir[slot].offset = it->offset;
+        dir[slot].size = it->size;
+        dir[slot].type = it->type;
+        dir[slot].name_offset = nameOffset;
+        nameOffset += (uint32_t)strlen(it->name) + 1;
+    }
+
+    int ok = pad_to(w, ASSET_PACK_ALIGN);
+    h->dir_offset = w->offset;
+    h->slot_count = slots;
+    ok = ok && write_bytes(w, dir, slots * sizeof(AssetPackEntry));
+
+    h->names_offset = w->offset;
+    for (size_t i = 0; ok && i < w->count; i++)
+        ok = write_bytes(w, w->items[i].name, strlen(w->items[i].name) + 1);
+    h->names_size = w->offset - h->names_offset;
+
+    free(dir);
+    return ok;
+}
+
+int asset_pack_build(const char *out_path, const char **inputs, int count)
+{
+    clock_t t0 = clock();
+
+    PackWriter w;
+    memset(&w, 0, sizeof(w));
+    w.out = fopen(out_path, "wb");
+    if (!w.out)
+    {
+        printf("ERROR: cannot create pack: %s\n", out_path);
+        return 0;
+    }
+
+    // nagłówek zostanie nadpisany na końcu
+    AssetPackHeader h;
+    memset(&h, 0, sizeof(h));
+    h.magic = ASSET_PACK_MAGIC;
+    h.version = ASSET_PACK_VERSION;
+    int ok = write_bytes(&w, &h, sizeof(h));
+
+    for (int i = 0; ok && i < count; i++)
+    {
+        const char *path = inputs[i];
+        if (has_item(&w, path))
+            continue;
+        if (has_extension(path, ".obj"))
+            ok = add_mesh(&w, path);
+        else if (has_extension(path, ".mtl"))
+            ok = add_material(&w, path);
+        else
+            ok = add_texture(&w, path);
+    }
+
+    h.entry_count = (uint32_t)w.count;
+    ok = ok && write_directory(&w, &h);
+    ok = ok && fseek(w.out, 0, SEEK_SET) == 0 && fwrite(&h, sizeof(h), 1, w.out) == 1;
+    ok = (fclose(w.out) == 0) && ok;
+
+    if (ok)
+        printf("Pack: %zu entries, %.1f MB, %.2f s\n", w.count,
+               (double)w.offset / (1024.0 * 1024.0), (double)(clock() - t0) / CLOCKS_PER_SEC);
+    else
+    {
+        printf("ERROR: building pack %s failed\n", out_path);
+        remove(out_path);
+    }
+
+    free(w.items);
+    return ok;
+}
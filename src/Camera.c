@@ -41,7 +41,7 @@ void camera_update_vectors(Camera* cam)
 /**
  * @brief Obsługa klawiatury (WASD).
  */
-void camera_process_keyboard(Camera* cam, float dt, int* keys)
+int camera_process_keyboard(Camera* cam, float dt, int* keys)
 {
     float velocity = cam->speed * dt;
     vec3 tmp;
@@ -62,6 +62,8 @@ void camera_process_keyboard(Camera* cam, float dt, int* keys)
         glm_vec3_scale(cam->right, velocity, tmp);
         glm_vec3_add(cam->position, tmp, cam->position);
     }
+
+    return keys['W'] || keys['S'] || keys['A'] || keys['D'];
 }
 
 /**
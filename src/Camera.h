@@ -41,8 +41,9 @@ void camera_update_vectors(Camera* cam);
  * @param cam   Kamera.
  * @param dt    Delta time (sekundy).
  * @param keys  Tablica stanów klawiszy GLFW.
+ * @return 1 jeśli wciśnięty jest klawisz ruchu (kamera się przesuwa).
  */
-void camera_process_keyboard(Camera* cam, float dt, int* keys);
+int camera_process_keyboard(Camera* cam, float dt, int* keys);
 
 /**
  * @brief Obraca kamerę na podstawie ruchu myszy.
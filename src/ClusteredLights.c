@@ -0,0 +1,505 @@
+#include "ClusteredLights.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <GLFW/glfw3.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CLUSTER_SIMD 1
+#include <emmintrin.h>
+#endif
+
+/* =========================================================
+   LightSet (SoA)
+   ========================================================= */
+
+void light_set_init(LightSet *s)
+{
+    memset(s, 0, sizeof(*s));
+}
+
+void light_set_free(LightSet *s)
+{
+    if (!s)
+        return;
+    free(s->px); free(s->py); free(s->pz);
+    free(s->radius);
+    free(s->r); free(s->g); free(s->b);
+    free(s->dx); free(s->dy); free(s->dz);
+    free(s->cos_outer);
+    free(s->cos_inner);
+    free(s->type);
+    memset(s, 0, sizeof(*s));
+}
+
+static int grow_floats(float **p, size_t count)
+{
+    float *n = (float *)realloc(*p, count * sizeof(float));
+    if (!n)
+        return 0;
+    *p = n;
+    return 1;
+}
+
+/**
+ * @brief Powiększa tablice SoA; nowe sloty zerowane (bezpieczne dla SIMD).
+ */
+static int light_set_reserve(LightSet *s, size_t need)
+{
+    if (need <= s->capacity)
+        return 1;
+
+    size_t newCap = s->capacity ? s->capacity * 2 : 64;
+    while (newCap < need)
+        newCap *= 2;
+
+    float **fields[] = {&s->px, &s->py, &s->pz, &s->radius, &s->r, &s->g, &s->b,
+                        &s->dx, &s->dy, &s->dz, &s->cos_outer, &s->cos_inner};
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++)
+    {
+        if (!grow_floats(fields[i], newCap))
+            return 0;
+        memset(*fields[i] + s->capacity, 0, (newCap - s->capacity) * sizeof(float));
+    }
+
+    unsigned char *t = (unsigned char *)realloc(s->type, newCap);
+    if (!t)
+        return 0;
+    memset(t + s->capacity, 0, newCap - s->capacity);
+    s->type = t;
+
+    s->capacity = newCap;
+    return 1;
+}
+
+int light_set_add_point(LightSet *s, const vec3 pos, float radius, const vec3 color)
+{
+    if (!light_set_reserve(s, s->count + 1))
+    {
+        printf("ERROR: light set allocation failed\n");
+        return -1;
+    }
+
+    size_t i = s->count++;
+    s->px[i] = pos[0]; s->py[i] = pos[1]; s->pz[i] = pos[2];
+    s->radius[i] = radius;
+    s->r[i] = color[0]; s->g[i] = color[1]; s->b[i] = color[2];
+    s->dx[i] = 0.0f; s->dy[i] = -1.0f; s->dz[i] = 0.0f;
+    s->cos_outer[i] = -1.0f;
+    s->cos_inner[i] = -1.0f;
+    s->type[i] = LIGHT_POINT;
+    return (int)i;
+}
+
+int light_set_add_spot(LightSet *s, const vec3 pos, float radius, const vec3 color,
+                       const vec3 dir, float outer_deg, float inner_deg)
+{
+    int i = light_set_add_point(s, pos, radius, color);
+    if (i < 0)
+        return -1;
+
+    vec3 d;
+    glm_vec3_normalize_to((float *)dir, d);
+    s->dx[i] = d[0]; s->dy[i] = d[1]; s->dz[i] = d[2];
+    s->cos_outer[i] = cosf(glm_rad(outer_deg));
+    s->cos_inner[i] = cosf(glm_rad(inner_deg));
+    s->type[i] = LIGHT_SPOT;
+    return i;
+}
+
+/**
+ * @brief Prosty generator liczb losowych [0,1) (LCG) — powtarzalny.
+ */
+static float rand01(unsigned int *state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return (float)(*state >> 8) / 16777216.0f;
+}
+
+void light_set_scatter(LightSet *s, size_t count, const vec3 bmin, const vec3 bmax, unsigned int seed)
+{
+    s->count = 0;
+
+    vec3 ext;
+    glm_vec3_sub((float *)bmax, (float *)bmin, ext);
+    float diag = glm_vec3_norm(ext);
+    // im więcej świateł, tym mniejszy zasięg — stała gęstość pokrycia
+    float radius = diag * 0.5f / cbrtf((float)(count ? count : 1));
+    if (radius < diag * 0.05f)
+        radius = diag * 0.05f;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        vec3 p = {bmin[0] + ext[0] * rand01(&seed),
+                  bmin[1] + ext[1] * rand01(&seed),
+                  bmin[2] + ext[2] * rand01(&seed)};
+        vec3 c = {0.2f + rand01(&seed), 0.2f + rand01(&seed), 0.2f + rand01(&seed)};
+
+        if (i % 4 == 3)
+            light_set_add_spot(s, p, radius * 2.0f, c, (vec3){0.0f, -1.0f, 0.0f}, 35.0f, 25.0f);
+        else
+            light_set_add_point(s, p, radius, c);
+    }
+}
+
+void light_set_orbit(LightSet *s, const vec3 center, float angle)
+{
+    float ca = cosf(angle), sa = sinf(angle);
+    for (size_t i = 0; i < s->count; i++)
+    {
+        float x = s->px[i] - center[0];
+        float z = s->pz[i] - center[2];
+        s->px[i] = center[0] + x * ca - z * sa;
+        s->pz[i] = center[2] + x * sa + z * ca;
+    }
+}
+
+/* =========================================================
+   Siatka klastrów
+   ========================================================= */
+
+/**
+ * @brief Indeks plasterka głębokości (podział wykładniczy).
+ */
+static int depth_slice(const ClusterGrid *c, float depth)
+{
+    float t = logf(depth / c->z_near) / logf(c->z_far / c->z_near);
+    int k = (int)floorf(t * (float)CLUSTER_Z);
+    if (k < 0)
+        k = 0;
+    if (k >= CLUSTER_Z)
+        k = CLUSTER_Z - 1;
+    return k;
+}
+
+void cluster_grid_set_projection(ClusterGrid *c, mat4 proj, float z_near, float z_far)
+{
+    c->z_near = z_near;
+    c->z_far = z_far;
+
+    float sx = 1.0f / proj[0][0];
+    float sy = 1.0f / proj[1][1];
+
+    for (int k = 0; k < CLUSTER_Z; k++)
+    {
+        float zn = z_near * powf(z_far / z_near, (float)k / CLUSTER_Z);
+        float zf = z_near * powf(z_far / z_near, (float)(k + 1) / CLUSTER_Z);
+
+        for (int j = 0; j < CLUSTER_Y; j++)
+        {
+            float y0 = -1.0f + 2.0f * (float)j / CLUSTER_Y;
+            float y1 = -1.0f + 2.0f * (float)(j + 1) / CLUSTER_Y;
+
+            for (int i = 0; i < CLUSTER_X; i++)
+            {
+                float x0 = -1.0f + 2.0f * (float)i / CLUSTER_X;
+                float x1 = -1.0f + 2.0f * (float)(i + 1) / CLUSTER_X;
+                size_t idx = ((size_t)k * CLUSTER_Y + j) * CLUSTER_X + i;
+
+                // narożniki kafelka na bliskiej i dalekiej głębokości plasterka
+                c->min_x[idx] = fminf(x0 * zn, x0 * zf) * sx;
+                c->max_x[idx] = fmaxf(x1 * zn, x1 * zf) * sx;
+                c->min_y[idx] = fminf(y0 * zn, y0 * zf) * sy;
+                c->max_y[idx] = fmaxf(y1 * zn, y1 * zf) * sy;
+                c->min_z[idx] = -zf;
+                c->max_z[idx] = -zn;
+            }
+        }
+    }
+}
+
+int cluster_grid_init(ClusterGrid *c, mat4 proj, float z_near, float z_far)
+{
+    memset(c, 0, sizeof(*c));
+
+    float **aabb[] = {&c->min_x, &c->min_y, &c->min_z, &c->max_x, &c->max_y, &c->max_z};
+    for (size_t i = 0; i < 6; i++)
+    {
+        *aabb[i] = (float *)malloc(CLUSTER_COUNT * sizeof(float));
+        if (!*aabb[i])
+        {
+            printf("ERROR: cluster grid allocation failed\n");
+            cluster_grid_destroy(c);
+            return 0;
+        }
+    }
+    c->grid = (uint32_t *)calloc(2 * CLUSTER_COUNT, sizeof(uint32_t));
+    if (!c->grid)
+    {
+        printf("ERROR: cluster grid allocation failed\n");
+        cluster_grid_destroy(c);
+        return 0;
+    }
+
+    cluster_grid_set_projection(c, proj, z_near, z_far);
+
+    glGenBuffers(3, c->buf);
+    glGenTextures(3, c->tex);
+    GLenum formats[3] = {GL_RGBA32F, GL_RG32UI, GL_R32UI};
+    for (int i = 0; i < 3; i++)
+    {
+        glBindBuffer(GL_TEXTURE_BUFFER, c->buf[i]);
+        glBufferData(GL_TEXTURE_BUFFER, 16, NULL, GL_STREAM_DRAW);
+        glBindTexture(GL_TEXTURE_BUFFER, c->tex[i]);
+        glTexBuffer(GL_TEXTURE_BUFFER, formats[i], c->buf[i]);
+    }
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    return 1;
+}
+
+/**
+ * @brief Zapewnia pojemność tablicy uint32.
+ */
+static int reserve_u32(uint32_t **p, size_t *cap, size_t need)
+{
+    if (need <= *cap)
+        return 1;
+    size_t newCap = *cap ? *cap * 2 : 4096;
+    while (newCap < need)
+        newCap *= 2;
+    uint32_t *n = (uint32_t *)realloc(*p, newCap * sizeof(uint32_t));
+    if (!n)
+        return 0;
+    *p = n;
+    *cap = newCap;
+    return 1;
+}
+
+/**
+ * @brief Dopisuje pary (klaster, światło) dla klastrów [base, base+n),
+ *        które przecina sfera (cx,cy,cz,r) — test 4 klastrów naraz.
+ */
+static int collect_slice(ClusterGrid *c, size_t base, size_t n,
+                         float cx, float cy, float cz, float r,
+                         uint32_t light, size_t *pairCount)
+{
+    if (!reserve_u32(&c->pairs, &c->pair_capacity, (*pairCount + n) * 2))
+        return 0;
+
+    uint32_t *out = c->pairs + *pairCount * 2;
+    size_t added = 0;
+
+#ifdef CLUSTER_SIMD
+    __m128 vx = _mm_set1_ps(cx), vy = _mm_set1_ps(cy), vz = _mm_set1_ps(cz);
+    __m128 r2 = _mm_set1_ps(r * r);
+    __m128 zero = _mm_setzero_ps();
+
+    for (size_t i = base; i < base + n; i += 4)
+    {
+        // odległość środka sfery od AABB: max(min - c, c - max, 0) na oś
+        __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(c->min_x + i), vx),
+                                          _mm_sub_ps(vx, _mm_loadu_ps(c->max_x + i))), zero);
+        __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(c->min_y + i), vy),
+                                          _mm_sub_ps(vy, _mm_loadu_ps(c->max_y + i))), zero);
+        __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(c->min_z + i), vz),
+                                          _mm_sub_ps(vz, _mm_loadu_ps(c->max_z + i))), zero);
+        __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        int mask = _mm_movemask_ps(_mm_cmple_ps(d2, r2));
+
+        while (mask)
+        {
+            int bit = 0;
+            while (!(mask & (1 << bit)))
+                bit++;
+            mask &= ~(1 << bit);
+            out[added * 2 + 0] = (uint32_t)(i + (size_t)bit);
+            out[added * 2 + 1] = light;
+            added++;
+        }
+    }
+#else
+    for (size_t i = base; i < base + n; i++)
+    {
+        float dx = fmaxf(fmaxf(c->min_x[i] - cx, cx - c->max_x[i]), 0.0f);
+        float dy = fmaxf(fmaxf(c->min_y[i] - cy, cy - c->max_y[i]), 0.0f);
+        float dz = fmaxf(fmaxf(c->min_z[i] - cz, cz - c->max_z[i]), 0.0f);
+        if (dx * dx + dy * dy + dz * dz <= r * r)
+        {
+            out[added * 2 + 0] = (uint32_t)i;
+            out[added * 2 + 1] = light;
+            added++;
+        }
+    }
+#endif
+
+    *pairCount += added;
+    return 1;
+}
+
+/**
+ * @brief Przekształca światła do przestrzeni widoku i pakuje je do light_data.
+ */
+static void pack_lights(ClusterGrid *c, const LightSet *s, mat4 view)
+{
+    for (size_t i = 0; i < s->count; i += 4)
+    {
+        float vx[4], vy[4], vz[4], wx[4], wy[4], wz[4];
+
+#ifdef CLUSTER_SIMD
+        __m128 px = _mm_loadu_ps(s->px + i), py = _mm_loadu_ps(s->py + i), pz = _mm_loadu_ps(s->pz + i);
+        __m128 dx = _mm_loadu_ps(s->dx + i), dy = _mm_loadu_ps(s->dy + i), dz = _mm_loadu_ps(s->dz + i);
+        float *outs[3][2] = {{vx, wx}, {vy, wy}, {vz, wz}};
+        for (int row = 0; row < 3; row++)
+        {
+            __m128 m0 = _mm_set1_ps(view[0][row]);
+            __m128 m1 = _mm_set1_ps(view[1][row]);
+            __m128 m2 = _mm_set1_ps(view[2][row]);
+            __m128 dir = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, dx), _mm_mul_ps(m1, dy)), _mm_mul_ps(m2, dz));
+            __m128 pos = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, px), _mm_mul_ps(m1, py)), _mm_mul_ps(m2, pz));
+            pos = _mm_add_ps(pos, _mm_set1_ps(view[3][row]));
+            _mm_storeu_ps(outs[row][0], pos);
+            _mm_storeu_ps(outs[row][1], dir);
+        }
+#else
+        for (size_t k = 0; k < 4; k++)
+        {
+            vec3 p = {s->px[i + k], s->py[i + k], s->pz[i + k]};
+            vec3 d = {s->dx[i + k], s->dy[i + k], s->dz[i + k]};
+            vec3 vp, vd;
+            glm_mat4_mulv3(view, p, 1.0f, vp);
+            glm_mat4_mulv3(view, d, 0.0f, vd);
+            vx[k] = vp[0]; vy[k] = vp[1]; vz[k] = vp[2];
+            wx[k] = vd[0]; wy[k] = vd[1]; wz[k] = vd[2];
+        }
+#endif
+
+        for (size_t k = 0; k < 4 && i + k < s->count; k++)
+        {
+            size_t l = i + k;
+            float *t = c->light_data + l * CLUSTER_LIGHT_TEXELS * 4;
+            t[0] = vx[k]; t[1] = vy[k]; t[2] = vz[k]; t[3] = s->radius[l];
+            t[4] = s->r[l]; t[5] = s->g[l]; t[6] = s->b[l]; t[7] = (float)s->type[l];
+            t[8] = wx[k]; t[9] = wy[k]; t[10] = wz[k]; t[11] = s->cos_outer[l];
+            t[12] = s->cos_inner[l]; t[13] = 0.0f; t[14] = 0.0f; t[15] = 0.0f;
+        }
+    }
+}
+
+/**
+ * @brief Wysyła bufor (orphaning: nowy magazyn co klatkę, bez synchronizacji).
+ */
+static void upload_buffer(GLuint buf, const void *data, size_t bytes)
+{
+    glBindBuffer(GL_TEXTURE_BUFFER, buf);
+    glBufferData(GL_TEXTURE_BUFFER, (GLsizeiptr)(bytes ? bytes : 16), NULL, GL_STREAM_DRAW);
+    if (bytes)
+        glBufferSubData(GL_TEXTURE_BUFFER, 0, (GLsizeiptr)bytes, data);
+}
+
+int cluster_grid_build(ClusterGrid *c, const LightSet *s, mat4 view)
+{
+    double t0 = glfwGetTime();
+
+    // 1) dane świateł w przestrzeni widoku
+    if (s->count > c->light_capacity)
+    {
+        float *n = (float *)realloc(c->light_data, s->capacity * CLUSTER_LIGHT_TEXELS * 4 * sizeof(float));
+        if (!n)
+        {
+            printf("ERROR: cluster light data allocation failed\n");
+            return 0;
+        }
+        c->light_data = n;
+        c->light_capacity = s->capacity;
+    }
+    pack_lights(c, s, view);
+
+    // 2) pary (klaster, światło) — tylko plasterki, które sfera obejmuje
+    size_t pairCount = 0;
+    const size_t sliceSize = (size_t)CLUSTER_X * CLUSTER_Y;
+
+    for (size_t l = 0; l < s->count; l++)
+    {
+        const float *t = c->light_data + l * CLUSTER_LIGHT_TEXELS * 4;
+        float r = t[3];
+        float depth = -t[2];
+        if (depth + r < c->z_near || depth - r > c->z_far)
+            continue;
+
+        int k0 = depth_slice(c, fmaxf(depth - r, c->z_near));
+        int k1 = depth_slice(c, fminf(depth + r, c->z_far));
+        for (int k = k0; k <= k1; k++)
+        {
+            if (!collect_slice(c, (size_t)k * sliceSize, sliceSize, t[0], t[1], t[2], r,
+                               (uint32_t)l, &pairCount))
+            {
+                printf("ERROR: cluster pair allocation failed\n");
+                return 0;
+            }
+        }
+    }
+
+    // 3) sortowanie przez zliczanie po klastrze -> offset/count + lista indeksów
+    uint32_t *grid = c->grid;
+    memset(grid, 0, 2 * CLUSTER_COUNT * sizeof(uint32_t));
+    for (size_t p = 0; p < pairCount; p++)
+        grid[c->pairs[p * 2] * 2 + 1]++;
+
+    uint32_t offset = 0;
+    c->max_per_cluster = 0;
+    for (size_t i = 0; i < CLUSTER_COUNT; i++)
+    {
+        grid[i * 2 + 0] = offset;
+        offset += grid[i * 2 + 1];
+        if (grid[i * 2 + 1] > c->max_per_cluster)
+            c->max_per_cluster = grid[i * 2 + 1];
+        grid[i * 2 + 1] = 0; // licznik wstawień w drugim przebiegu
+    }
+
+    if (!reserve_u32(&c->indices, &c->index_capacity, pairCount))
+    {
+        printf("ERROR: cluster index allocation failed\n");
+        return 0;
+    }
+    for (size_t p = 0; p < pairCount; p++)
+    {
+        uint32_t cl = c->pairs[p * 2];
+        c->indices[grid[cl * 2] + grid[cl * 2 + 1]++] = c->pairs[p * 2 + 1];
+    }
+    c->index_count = pairCount;
+
+    // 4) wysyłka na GPU
+    upload_buffer(c->buf[0], c->light_data, s->count * CLUSTER_LIGHT_TEXELS * 4 * sizeof(float));
+    upload_buffer(c->buf[1], c->grid, 2 * CLUSTER_COUNT * sizeof(uint32_t));
+    upload_buffer(c->buf[2], c->indices, c->index_count * sizeof(uint32_t));
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    c->build_ms = (glfwGetTime() - t0) * 1000.0;
+    return 1;
+}
+
+void cluster_grid_bind(const ClusterGrid *c, GLuint program, int first_unit, int width, int height)
+{
+    const char *names[3] = {"uLightData", "uClusterGrid", "uLightIndices"};
+    for (int i = 0; i < 3; i++)
+    {
+        glActiveTexture(GL_TEXTURE0 + first_unit + i);
+        glBindTexture(GL_TEXTURE_BUFFER, c->tex[i]);
+        glUniform1i(glGetUniformLocation(program, names[i]), first_unit + i);
+    }
+    glActiveTexture(GL_TEXTURE0);
+
+    glUniform4f(glGetUniformLocation(program, "uClusterParams"),
+                c->z_near, c->z_far,
+                (float)CLUSTER_Z / logf(c->z_far / c->z_near), 0.0f);
+    glUniform2f(glGetUniformLocation(program, "uScreenSize"), (float)width, (float)height);
+}
+
+void cluster_grid_destroy(ClusterGrid *c)
+{
+    if (!c)
+        return;
+    if (c->buf[0])
+        glDeleteBuffers(3, c->buf);
+    if (c->tex[0])
+        glDeleteTextures(3, c->tex);
+    free(c->min_x); free(c->min_y); free(c->min_z);
+    free(c->max_x); free(c->max_y); free(c->max_z);
+    free(c->grid);
+    free(c->indices);
+    free(c->pairs);
+    free(c->light_data);
+    memset(c, 0, sizeof(*c));
+}
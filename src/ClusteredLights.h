@@ -0,0 +1,161 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <glad/glad.h>
+#include <cglm/cglm.h>
+
+/* Podział frustum na klastry: kafelki ekranu x plasterki głębokości. */
+#define CLUSTER_X 16
+#define CLUSTER_Y 9
+#define CLUSTER_Z 24
+#define CLUSTER_COUNT (CLUSTER_X * CLUSTER_Y * CLUSTER_Z)
+
+/* Liczba texeli RGBA32F na jedno światło w buforze uLightData. */
+#define CLUSTER_LIGHT_TEXELS 4
+
+typedef enum LightType
+{
+    LIGHT_POINT = 0,
+    LIGHT_SPOT = 1
+} LightType;
+
+/**
+ * @brief Zbiór świateł punktowych i stożkowych (SoA).
+ *
+ * Pozycje i kierunki w przestrzeni świata; kolor zawiera już natężenie.
+ */
+typedef struct LightSet
+{
+    size_t count;
+    size_t capacity; // wielokrotność 4 (transformacja po 4 światła)
+
+    float *px, *py, *pz;
+    float *radius;
+    float *r, *g, *b;
+    float *dx, *dy, *dz;    // kierunek reflektora
+    float *cos_outer;       // cos kąta zewnętrznego stożka
+    float *cos_inner;       // cos kąta wewnętrznego stożka
+    unsigned char *type;    // LightType
+} LightSet;
+
+/**
+ * @brief Siatka klastrów + listy świateł + bufory GPU.
+ *
+ * Co klatkę CPU przypisuje światła do klastrów (test sfera vs AABB
+ * klastra w przestrzeni widoku, 4 klastry naraz) i wysyła wynik jako
+ * trzy bufory tekstur:
+ *  - uLightData    (RGBA32F, CLUSTER_LIGHT_TEXELS texeli na światło),
+ *  - uClusterGrid  (RG32UI: offset, liczba świateł klastra),
+ *  - uLightIndices (R32UI: indeksy świateł).
+ */
+typedef struct ClusterGrid
+{
+    float z_near, z_far;
+
+    /* AABB klastrów w przestrzeni widoku (SoA, indeks = (z*Y + y)*X + x) */
+    float *min_x, *min_y, *min_z;
+    float *max_x, *max_y, *max_z;
+
+    uint32_t *grid;      // 2 * CLUSTER_COUNT: offset, count
+    uint32_t *indices;   // indeksy świateł
+    size_t index_count;
+    size_t index_capacity;
+
+    uint32_t *pairs;     // tymczasowe pary (klaster << 32 | światło) -> 2 x uint32
+    size_t pair_capacity;
+
+    float *light_data;   // CLUSTER_LIGHT_TEXELS * 4 floaty na światło
+    size_t light_capacity;
+
+    GLuint buf[3];       // dane świateł, siatka, indeksy
+    GLuint tex[3];
+
+    /* statystyki ostatniej klatki */
+    double build_ms;
+    size_t max_per_cluster;
+} ClusterGrid;
+
+/**
+ * @brief Inicjalizuje pusty zbiór świateł.
+ */
+void light_set_init(LightSet *s);
+
+/**
+ * @brief Zwalnia pamięć zbioru świateł.
+ */
+void light_set_free(LightSet *s);
+
+/**
+ * @brief Dodaje światło punktowe.
+ *
+ * @return Indeks światła lub -1 jeśli błąd alokacji.
+ */
+int light_set_add_point(LightSet *s, const vec3 pos, float radius, const vec3 color);
+
+/**
+ * @brief Dodaje reflektor (spot).
+ *
+ * @param outer_deg Kąt zewnętrzny stożka (stopnie).
+ * @param inner_deg Kąt wewnętrzny stożka (stopnie).
+ * @return Indeks światła lub -1 jeśli błąd alokacji.
+ */
+int light_set_add_spot(LightSet *s, const vec3 pos, float radius, const vec3 color,
+                       const vec3 dir, float outer_deg, float inner_deg);
+
+/**
+ * @brief Rozrzuca losowo count świateł (punktowych i spot) w AABB.
+ *
+ * @param s     Zbiór (dotychczasowe światła zostają usunięte).
+ * @param count Liczba świateł.
+ * @param bmin  Minimum AABB sceny.
+ * @param bmax  Maksimum AABB sceny.
+ * @param seed  Ziarno generatora (powtarzalne sceny do benchmarku).
+ */
+void light_set_scatter(LightSet *s, size_t count, const vec3 bmin, const vec3 bmax, unsigned int seed);
+
+/**
+ * @brief Obraca światła wokół osi Y przechodzącej przez center (animacja demo).
+ */
+void light_set_orbit(LightSet *s, const vec3 center, float angle);
+
+/**
+ * @brief Tworzy siatkę klastrów i bufory GPU.
+ *
+ * @param c    Siatka.
+ * @param proj Macierz projekcji perspektywicznej.
+ * @param z_near Bliska płaszczyzna projekcji.
+ * @param z_far  Daleka płaszczyzna projekcji.
+ * @return 1 jeśli OK, 0 jeśli błąd.
+ */
+int cluster_grid_init(ClusterGrid *c, mat4 proj, float z_near, float z_far);
+
+/**
+ * @brief Przelicza AABB klastrów po zmianie projekcji.
+ */
+void cluster_grid_set_projection(ClusterGrid *c, mat4 proj, float z_near, float z_far);
+
+/**
+ * @brief Buduje listy świateł klastrów dla bieżącego widoku i wysyła je na GPU.
+ *
+ * @param c     Siatka.
+ * @param s     Światła (przestrzeń świata).
+ * @param view  Macierz widoku.
+ * @return 1 jeśli OK, 0 jeśli błąd alokacji.
+ */
+int cluster_grid_build(ClusterGrid *c, const LightSet *s, mat4 view);
+
+/**
+ * @brief Wiąże bufory klastrów z jednostkami tekstur i ustawia uniformy.
+ *
+ * @param c           Siatka.
+ * @param program     Program shaderów (phong).
+ * @param first_unit  Pierwsza wolna jednostka tekstur (używa 3 kolejnych).
+ * @param width       Szerokość framebuffera.
+ * @param height      Wysokość framebuffera.
+ */
+void cluster_grid_bind(const ClusterGrid *c, GLuint program, int first_unit, int width, int height);
+
+/**
+ * @brief Zwalnia pamięć i bufory GPU siatki.
+ */
+void cluster_grid_destroy(ClusterGrid *c);
@@ -0,0 +1,110 @@
+#include "DebugDraw.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEBUG_VERTEX_FLOATS 6
+
+int debug_draw_init(DebugDraw *dd, GLuint frame_binding)
+{
+    memset(dd, 0, sizeof(*dd));
+
+    dd->sh = shader_load_from_files("shaders/debug.vert", "shaders/debug.frag");
+    if (!dd->sh.id)
+        return 0;
+    shader_bind_block(dd->sh, "PerFrame", frame_binding);
+
+    // format stały; bufor i offset podpinane przy każdym flush
+    glGenVertexArrays(1, &dd->vao);
+    glBindVertexArray(dd->vao);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+    return 1;
+}
+
+static void push_vertex(DebugDraw *dd, const float p[3], const float color[3])
+{
+    if (dd->count + 1 > dd->capacity)
+    {
+        size_t newCap = dd->capacity ? dd->capacity * 2 : 256;
+        float *n = (float *)realloc(dd->verts, newCap * DEBUG_VERTEX_FLOATS * sizeof(float));
+        if (!n)
+            return;
+        dd->verts = n;
+        dd->capacity = newCap;
+    }
+    float *v = dd->verts + dd->count * DEBUG_VERTEX_FLOATS;
+    memcpy(v, p, 3 * sizeof(float));
+    memcpy(v + 3, color, 3 * sizeof(float));
+    dd->count++;
+}
+
+void debug_draw_line(DebugDraw *dd, const float a[3], const float b[3], const float color[3])
+{
+    push_vertex(dd, a, color);
+    push_vertex(dd, b, color);
+    if (dd->count % 2) // brak pamięci na drugi koniec
+        dd->count--;
+}
+
+void debug_draw_box(DebugDraw *dd, const float bmin[3], const float bmax[3], const float color[3])
+{
+    float c[8][3];
+    for (int i = 0; i < 8; i++)
+    {
+        c[i][0] = (i & 1) ? bmax[0] : bmin[0];
+        c[i][1] = (i & 2) ? bmax[1] : bmin[1];
+        c[i][2] = (i & 4) ? bmax[2] : bmin[2];
+    }
+    // 12 krawędzi: pary narożników różniące się jednym bitem
+    for (int i = 0; i < 8; i++)
+        for (int bit = 1; bit < 8; bit <<= 1)
+            if (!(i & bit))
+                debug_draw_line(dd, c[i], c[i | bit], color);
+}
+
+void debug_draw_cross(DebugDraw *dd, const float p[3], float size, const float color[3])
+{
+    for (int k = 0; k < 3; k++)
+    {
+        float a[3] = {p[0], p[1], p[2]};
+        float b[3] = {p[0], p[1], p[2]};
+        a[k] -= size;
+        b[k] += size;
+        debug_draw_line(dd, a, b, color);
+    }
+}
+
+void debug_draw_flush(DebugDraw *dd, GpuRing *ring)
+{
+    dd->last_vertices = 0;
+    if (dd->count == 0)
+        return;
+
+    GLsizeiptr bytes = (GLsizeiptr)(dd->count * DEBUG_VERTEX_FLOATS * sizeof(float));
+    GLintptr offset = gpu_ring_write(ring, dd->verts, bytes, 16);
+    if (offset >= 0)
+    {
+        shader_use(dd->sh);
+        glBindVertexArray(dd->vao);
+        glBindBuffer(GL_ARRAY_BUFFER, ring->buffer);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, DEBUG_VERTEX_FLOATS * sizeof(float),
+                              (void *)offset);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, DEBUG_VERTEX_FLOATS * sizeof(float),
+                              (void *)(offset + 3 * sizeof(float)));
+        glDrawArrays(GL_LINES, 0, (GLsizei)dd->count);
+        glBindVertexArray(0);
+        dd->last_vertices = dd->count;
+    }
+    dd->count = 0;
+}
+
+void debug_draw_destroy(DebugDraw *dd)
+{
+    if (dd->vao)
+        glDeleteVertexArrays(1, &dd->vao);
+    shader_destroy(&dd->sh);
+    free(dd->verts);
+    memset(dd, 0, sizeof(*dd));
+}
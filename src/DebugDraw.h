@@ -0,0 +1,58 @@
+#pragma once
+#include <stddef.h>
+#include <glad/glad.h>
+
+#include "Shader.h"
+#include "GpuRing.h"
+
+/**
+ * @brief Linie pomocnicze (AABB, pozycje świateł) rysowane raz na klatkę.
+ *
+ * Wierzchołki zbierane są na CPU i przy flush trafiają jednym zapisem
+ * do GpuRing — bez własnego VBO i bez glBufferData co klatkę.
+ */
+typedef struct DebugDraw
+{
+    ShaderProgram sh;
+    GLuint vao;
+    float *verts;          // x, y, z, r, g, b
+    size_t count;          // wierzchołki
+    size_t capacity;
+    size_t last_vertices;  // narysowane w ostatnim flush
+} DebugDraw;
+
+/**
+ * @brief Wczytuje shader i tworzy VAO.
+ *
+ * @param dd            Debug draw.
+ * @param frame_binding Punkt wiązania bloku PerFrame (view/projection).
+ * @return 1 jeśli OK, 0 jeśli błąd.
+ */
+int debug_draw_init(DebugDraw *dd, GLuint frame_binding);
+
+/**
+ * @brief Dodaje odcinek (przestrzeń świata).
+ */
+void debug_draw_line(DebugDraw *dd, const float a[3], const float b[3], const float color[3]);
+
+/**
+ * @brief Dodaje krawędzie AABB.
+ */
+void debug_draw_box(DebugDraw *dd, const float bmin[3], const float bmax[3], const float color[3]);
+
+/**
+ * @brief Dodaje krzyżyk 3D (np. pozycja światła).
+ */
+void debug_draw_cross(DebugDraw *dd, const float p[3], float size, const float color[3]);
+
+/**
+ * @brief Wysyła zebrane linie przez pierścień i rysuje je (GL_LINES).
+ *
+ * Wymaga podpiętego bloku PerFrame bieżącej klatki.
+ */
+void debug_draw_flush(DebugDraw *dd, GpuRing *ring);
+
+/**
+ * @brief Zwalnia zasoby.
+ */
+void debug_draw_destroy(DebugDraw *dd);
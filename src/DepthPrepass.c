@@ -0,0 +1,119 @@
+#include "DepthPrepass.h"
+#include <stdio.h>
+#include <string.h>
+
+enum
+{
+    QUERY_DEPTH_TIME = 0,
+    QUERY_COLOR_TIME,
+    QUERY_COLOR_SAMPLES
+};
+
+int depth_prepass_init(DepthPrepass *dp, GLuint frame_binding, GLuint draw_binding, int enabled)
+{
+    memset(dp, 0, sizeof(*dp));
+    dp->enabled = enabled;
+
+    dp->sh = shader_load_from_files("shaders/depth.vert", "shaders/depth.frag");
+    if (!dp->sh.id)
+        return 0;
+    shader_bind_block(dp->sh, "PerFrame", frame_binding);
+    shader_bind_block(dp->sh, "PerDraw", draw_binding);
+
+    glGenQueries(DEPTH_PREPASS_FRAMES * 3, &dp->queries[0][0]);
+    return 1;
+}
+
+/**
+ * @brief Dolicza wyniki klatki ze slotu (czeka, jeśli GPU jeszcze nie skończył).
+ */
+static void collect(DepthPrepass *dp, int slot)
+{
+    if (!dp->pending[slot])
+        return;
+
+    GLuint64 depthNs = 0, colorNs = 0, samples = 0;
+    int on = dp->slot_enabled[slot];
+    if (on)
+        glGetQueryObjectui64v(dp->queries[slot][QUERY_DEPTH_TIME], GL_QUERY_RESULT, &depthNs);
+    glGetQueryObjectui64v(dp->queries[slot][QUERY_COLOR_TIME], GL_QUERY_RESULT, &colorNs);
+    glGetQueryObjectui64v(dp->queries[slot][QUERY_COLOR_SAMPLES], GL_QUERY_RESULT, &samples);
+
+    DepthPrepassStats *s = &dp->stats[on];
+    s->frames++;
+    s->depth_ms += (double)depthNs / 1.0e6;
+    s->color_ms += (double)colorNs / 1.0e6;
+    s->samples += (double)samples;
+    s->pixels += dp->slot_pixels[slot];
+    dp->pending[slot] = 0;
+}
+
+void depth_prepass_begin(DepthPrepass *dp, const RenderQueue *q, int width, int height)
+{
+    dp->slot = (dp->slot + 1) % DEPTH_PREPASS_FRAMES;
+    int slot = dp->slot;
+    collect(dp, slot);
+
+    dp->slot_enabled[slot] = dp->enabled;
+    dp->slot_pixels[slot] = (double)width * (double)height;
+    dp->depth_draws = 0;
+
+    if (dp->enabled)
+    {
+        glBeginQuery(GL_TIME_ELAPSED, dp->queries[slot][QUERY_DEPTH_TIME]);
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        dp->depth_draws = render_queue_submit_depth(q, dp->sh.id);
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        glEndQuery(GL_TIME_ELAPSED);
+
+        // główny przebieg: tylko fragmenty leżące dokładnie na zapisanej głębi
+        glDepthFunc(GL_EQUAL);
+        glDepthMask(GL_FALSE);
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, dp->queries[slot][QUERY_COLOR_TIME]);
+    glBeginQuery(GL_SAMPLES_PASSED, dp->queries[slot][QUERY_COLOR_SAMPLES]);
+}
+
+void depth_prepass_end(DepthPrepass *dp)
+{
+    glEndQuery(GL_SAMPLES_PASSED);
+    glEndQuery(GL_TIME_ELAPSED);
+    dp->pending[dp->slot] = 1;
+
+    if (dp->slot_enabled[dp->slot])
+    {
+        glDepthFunc(GL_LESS);
+        glDepthMask(GL_TRUE);
+    }
+}
+
+static void print_mode(const char *name, const DepthPrepassStats *s)
+{
+    if (s->frames == 0)
+    {
+        printf("[prepass] %-4s no frames measured yet\n", name);
+        return;
+    }
+    double frames = (double)s->frames;
+    printf("[prepass] %-4s %lu frames | GPU depth %.3f ms + color %.3f ms = %.3f ms/frame | "
+           "shaded fragments %.2f per pixel\n",
+           name, s->frames, s->depth_ms / frames, s->color_ms / frames, (s->depth_ms + s->color_ms) / frames,
+           s->pixels > 0.0 ? s->samples / s->pixels : 0.0);
+}
+
+void depth_prepass_print_stats(const DepthPrepass *dp)
+{
+    printf("[prepass] depth pre-pass %s (F6), %zu depth draws last frame\n", dp->enabled ? "ON" : "OFF",
+           dp->depth_draws);
+    print_mode("off", &dp->stats[0]);
+    print_mode("on", &dp->stats[1]);
+}
+
+void depth_prepass_destroy(DepthPrepass *dp)
+{
+    if (dp->queries[0][0])
+        glDeleteQueries(DEPTH_PREPASS_FRAMES * 3, &dp->queries[0][0]);
+    shader_destroy(&dp->sh);
+    memset(dp, 0, sizeof(*dp));
+}
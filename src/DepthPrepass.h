@@ -0,0 +1,92 @@
+#pragma once
+#include <stddef.h>
+#include <glad/glad.h>
+
+#include "Shader.h"
+#include "Renderer.h"
+
+#define DEPTH_PREPASS_FRAMES 3 // klatki zapytań w locie (odczyt bez czekania na GPU)
+
+/**
+ * @brief Statystyki jednego trybu (z przebiegiem głębi albo bez).
+ */
+typedef struct DepthPrepassStats
+{
+    unsigned long frames;
+    double depth_ms;  // GPU: przebieg głębi
+    double color_ms;  // GPU: główny przebieg (cieniowanie)
+    double samples;   // fragmenty głównego przebiegu, które przeszły test głębi
+    double pixels;    // piksele framebuffera
+} DepthPrepassStats;
+
+/**
+ * @brief Przebieg samej głębi przed głównym rysowaniem kolejki.
+ *
+ * Gęsta, nakładająca się geometria cieniuje wiele fragmentów na piksel,
+ * z których większość jest potem zasłonięta. Z przebiegiem głębi:
+ *  - najpierw kolejka jest rysowana bez koloru, z samym strumieniem
+ *    pozycji (Mesh.depthVAO, 12 zamiast 32 bajtów na wierzchołek)
+ *    i pustym shaderem fragmentów,
+ *  - główny przebieg idzie z GL_EQUAL i bez zapisu głębi, więc
+ *    tekstura i oświetlenie liczą się raz na widoczny piksel.
+ *
+ * Zapytania GL_TIME_ELAPSED i GL_SAMPLES_PASSED mierzą oba przebiegi;
+ * statystyki są zbierane osobno dla trybu włączonego i wyłączonego,
+ * więc po przełączeniu (F6) widać porównanie na tej samej scenie.
+ *
+ * @note Elementy RENDER_PASS_TRANSPARENT nie trafiają do przebiegu głębi
+ *       i przy GL_EQUAL zostałyby odrzucone — trzeba je rysować po
+ *       depth_prepass_end().
+ */
+typedef struct DepthPrepass
+{
+    ShaderProgram sh;
+    int enabled;
+
+    GLuint queries[DEPTH_PREPASS_FRAMES][3]; // czas głębi, czas koloru, próbki koloru
+    int pending[DEPTH_PREPASS_FRAMES];       // wyniki do odczytu
+    int slot_enabled[DEPTH_PREPASS_FRAMES];  // tryb klatki w slocie
+    double slot_pixels[DEPTH_PREPASS_FRAMES];
+    int slot;
+
+    size_t depth_draws;            // ostatnia klatka
+    DepthPrepassStats stats[2];    // [0] bez, [1] z przebiegiem głębi
+} DepthPrepass;
+
+/**
+ * @brief Wczytuje shaders/depth i tworzy zapytania.
+ *
+ * @param dp            Przebieg głębi.
+ * @param frame_binding Punkt wiązania bloku PerFrame.
+ * @param draw_binding  Punkt wiązania bloku PerDraw.
+ * @param enabled       Tryb początkowy.
+ * @return 1 jeśli OK, 0 jeśli błąd.
+ */
+int depth_prepass_init(DepthPrepass *dp, GLuint frame_binding, GLuint draw_binding, int enabled);
+
+/**
+ * @brief Przed render_queue_submit(): przebieg głębi (gdy włączony) i stan GL_EQUAL.
+ *
+ * Odczytuje też gotowe wyniki zapytań sprzed DEPTH_PREPASS_FRAMES klatek.
+ *
+ * @param dp     Przebieg głębi.
+ * @param q      Posortowana kolejka.
+ * @param width  Framebuffer (do liczby fragmentów na piksel).
+ * @param height
+ */
+void depth_prepass_begin(DepthPrepass *dp, const RenderQueue *q, int width, int height);
+
+/**
+ * @brief Po render_queue_submit(): kończy zapytania, przywraca GL_LESS i zapis głębi.
+ */
+void depth_prepass_end(DepthPrepass *dp);
+
+/**
+ * @brief Wypisuje czasy GPU i fragmenty na piksel obu trybów.
+ */
+void depth_prepass_print_stats(const DepthPrepass *dp);
+
+/**
+ * @brief Zwalnia shader i zapytania.
+ */
+void depth_prepass_destroy(DepthPrepass *dp);
@@ -0,0 +1,288 @@
+#include "DynamicResolution.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+int dynamic_resolution_init(DynamicResolution *dr, int width, int height, float target_ms, float min_scale,
+                            float sharpness)
+{
+    memset(dr, 0, sizeof(*dr));
+    dr->window_width = width;
+    dr->window_height = height;
+    dr->target_ms = target_ms;
+    dr->min_scale = min_scale < 0.25f ? 0.25f : (min_scale > 1.0f ? 1.0f : min_scale);
+    dr->sharpness = sharpness > 0.0f ? sharpness : 0.0f;
+    dr->scale = 1.0f;
+    dr->frame_scale = 1.0f;
+    if (target_ms <= 0.0f)
+        return 1;
+
+    dr->sh = shader_load_from_files("shaders/upscale.vert", "shaders/upscale.frag");
+    if (!dr->sh.id)
+        return 0;
+    shader_use(dr->sh);
+    glUniform1i(glGetUniformLocation(dr->sh.id, "uSource"), 0);
+    dr->uv_scale_loc = glGetUniformLocation(dr->sh.id, "uUvScale");
+    dr->texel_size_loc = glGetUniformLocation(dr->sh.id, "uTexelSize");
+    dr->sharpness_loc = glGetUniformLocation(dr->sh.id, "uSharpness");
+
+    glGenVertexArrays(1, &dr->vao);
+    glGenQueries(DYNAMIC_RES_FRAMES * 2, &dr->queries[0][0]);
+    dr->available = 1;
+    dr->enabled = 1;
+    return 1;
+}
+
+void dynamic_resolution_resize(DynamicResolution *dr, int width, int height)
+{
+    dr->window_width = width;
+    dr->window_height = height;
+}
+
+void dynamic_resolution_set_enabled(DynamicResolution *dr, int enabled)
+{
+    if (!dr->available)
+        return;
+    dr->enabled = enabled;
+    dr->samples = 0;
+}
+
+static void destroy_targets(DynamicResolution *dr)
+{
+    if (dr->fbo)
+        glDeleteFramebuffers(1, &dr->fbo);
+    if (dr->color)
+        glDeleteTextures(1, &dr->color);
+    if (dr->depth)
+        glDeleteTextures(1, &dr->depth);
+    dr->fbo = dr->color = dr->depth = 0;
+    dr->target_width = dr->target_height = 0;
+}
+
+/**
+ * @brief Tworzy kolor i głębię w rozmiarze okna (scena zajmuje ich część).
+ */
+static int create_targets(DynamicResolution *dr)
+{
+    destroy_targets(dr);
+    int w = dr->window_width, h = dr->window_height;
+
+    glActiveTexture(GL_TEXTURE0);
+    glGenTextures(1, &dr->color);
+    glBindTexture(GL_TEXTURE_2D, dr->color);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glGenTextures(1, &dr->depth);
+    glBindTexture(GL_TEXTURE_2D, dr->depth);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, w, h, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &dr->fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, dr->fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, dr->color, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, dr->depth, 0);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        printf("ERROR: dynamic resolution framebuffer incomplete (0x%x)\n", status);
+        destroy_targets(dr);
+        return 0;
+    }
+
+    dr->target_width = w;
+    dr->target_height = h;
+    dr->stats.reallocations++;
+    return 1;
+}
+
+/**
+ * @brief Regulator: nowa skala z uśrednionego czasu przy obecnej skali.
+ *
+ * @return 1 jeśli skala wzrosła.
+ */
+static int adjust(DynamicResolution *dr)
+{
+    if (dr->samples < DYNAMIC_RES_SETTLE)
+        return 0;
+
+    // czas ~ liczba pikseli ~ skala^2: skala, przy której czas trafi w środek pasma
+    double target = dr->target_ms;
+    float next = dr->scale * sqrtf((float)(target * DYNAMIC_RES_GOAL / dr->average_ms));
+    if (dr->average_ms > target)
+        next = floorf(next / DYNAMIC_RES_STEP) * DYNAMIC_RES_STEP;
+    else if (dr->average_ms < target * DYNAMIC_RES_HEADROOM)
+    {
+        if (next > dr->scale + DYNAMIC_RES_MAX_UP)
+            next = dr->scale + DYNAMIC_RES_MAX_UP;
+        next = roundf(next / DYNAMIC_RES_STEP) * DYNAMIC_RES_STEP;
+    }
+    else
+        return 0;
+
+    if (next < dr->min_scale)
+        next = dr->min_scale;
+    if (next > 1.0f)
+        next = 1.0f;
+    if (fabsf(next - dr->scale) < 1.0e-4f)
+        return 0;
+
+    int raised = next > dr->scale;
+    if (raised)
+        dr->stats.increases++;
+    else
+        dr->stats.decreases++;
+    dr->scale = next;
+    dr->samples = 0;
+    return raised;
+}
+
+/**
+ * @brief Pomiar klatki ze slotu (czeka, jeśli GPU jeszcze nie skończył), potem regulator.
+ *
+ * @return 1 jeśli skala wzrosła.
+ */
+static int collect(DynamicResolution *dr, int slot)
+{
+    if (!dr->pending[slot])
+        return 0;
+    dr->pending[slot] = 0;
+
+    GLuint64 start = 0, end = 0;
+    glGetQueryObjectui64v(dr->queries[slot][0], GL_QUERY_RESULT, &start);
+    glGetQueryObjectui64v(dr->queries[slot][1], GL_QUERY_RESULT, &end);
+
+    // klatka sprzed zmiany skali (albo doszlifowania) nie opisuje obecnej skali
+    if (dr->slot_scale[slot] != dr->scale)
+        return 0;
+
+    double ms = end > start ? (double)(end - start) / 1.0e6 : 0.0;
+    dr->stats.frames++;
+    dr->stats.gpu_ms += ms;
+    dr->stats.scale += dr->scale;
+    if (ms > dr->target_ms)
+        dr->stats.over_target++;
+
+    dr->average_ms = dr->samples ? dr->average_ms + DYNAMIC_RES_SMOOTHING * (ms - dr->average_ms) : ms;
+    dr->samples++;
+    return adjust(dr);
+}
+
+int dynamic_resolution_begin(DynamicResolution *dr, int native, int *width, int *height)
+{
+    int raised = 0;
+    dr->active = dr->available && dr->enabled && dr->window_width > 0 && dr->window_height > 0;
+
+    // leniwie: seria zdarzeń zmiany rozmiaru kończy się jedną alokacją
+    if (dr->active && (dr->target_width != dr->window_width || dr->target_height != dr->window_height) &&
+        !create_targets(dr))
+    {
+        dr->available = 0;
+        dr->active = 0;
+    }
+
+    if (!dr->active)
+    {
+        dr->frame_scale = 1.0f;
+        dr->render_width = dr->window_width;
+        dr->render_height = dr->window_height;
+        if (dr->viewport_width != dr->window_width || dr->viewport_height != dr->window_height)
+        {
+            glViewport(0, 0, dr->window_width, dr->window_height);
+            dr->viewport_width = dr->window_width;
+            dr->viewport_height = dr->window_height;
+        }
+        *width = dr->render_width;
+        *height = dr->render_height;
+        return 0;
+    }
+
+    dr->slot = (dr->slot + 1) % DYNAMIC_RES_FRAMES;
+    raised = collect(dr, dr->slot);
+
+    dr->frame_scale = native ? 1.0f : dr->scale;
+    dr->render_width = (int)((float)dr->window_width * dr->frame_scale + 0.5f);
+    dr->render_height = (int)((float)dr->window_height * dr->frame_scale + 0.5f);
+    if (dr->render_width < 1)
+        dr->render_width = 1;
+    if (dr->render_height < 1)
+        dr->render_height = 1;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, dr->fbo);
+    glViewport(0, 0, dr->render_width, dr->render_height);
+    dr->slot_scale[dr->slot] = dr->frame_scale;
+    glQueryCounter(dr->queries[dr->slot][0], GL_TIMESTAMP);
+
+    *width = dr->render_width;
+    *height = dr->render_height;
+    return raised;
+}
+
+void dynamic_resolution_end(DynamicResolution *dr)
+{
+    if (!dr->active)
+        return;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, dr->window_width, dr->window_height);
+    dr->viewport_width = dr->window_width;
+    dr->viewport_height = dr->window_height;
+
+    // pełnoekranowy trójkąt; wyostrzenie tylko dla obrazu faktycznie powiększanego
+    glDisable(GL_DEPTH_TEST);
+    glUseProgram(dr->sh.id);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, dr->color);
+    glUniform2f(dr->uv_scale_loc, (float)dr->render_width / (float)dr->target_width,
+                (float)dr->render_height / (float)dr->target_height);
+    glUniform2f(dr->texel_size_loc, 1.0f / (float)dr->target_width, 1.0f / (float)dr->target_height);
+    glUniform1f(dr->sharpness_loc, dr->frame_scale < 1.0f ? dr->sharpness : 0.0f);
+    glBindVertexArray(dr->vao);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glEnable(GL_DEPTH_TEST);
+
+    glQueryCounter(dr->queries[dr->slot][1], GL_TIMESTAMP);
+    dr->pending[dr->slot] = 1;
+}
+
+void dynamic_resolution_print_stats(const DynamicResolution *dr)
+{
+    if (!dr->available)
+    {
+        printf("[dynres] not available: rendering at window resolution\n");
+        return;
+    }
+    printf("[dynres] %s (F8), target %.2f ms, scale %.2f (min %.2f), %dx%d of %dx%d, sharpen %.2f\n",
+           dr->enabled ? "ON" : "OFF", dr->target_ms, dr->scale, dr->min_scale, dr->render_width,
+           dr->render_height, dr->window_width, dr->window_height, dr->sharpness);
+
+    const DynamicResolutionStats *s = &dr->stats;
+    if (s->frames == 0)
+    {
+        printf("[dynres] no frames measured yet\n");
+        return;
+    }
+    double frames = (double)s->frames;
+    printf("[dynres] %lu frames measured: GPU %.3f ms/frame, %.1f%% over target, average scale %.2f\n",
+           s->frames, s->gpu_ms / frames, 100.0 * (double)s->over_target / frames, s->scale / frames);
+    printf("[dynres] scale changes: %zu up, %zu down; render targets allocated %zu times\n", s->increases,
+           s->decreases, s->reallocations);
+}
+
+void dynamic_resolution_destroy(DynamicResolution *dr)
+{
+    destroy_targets(dr);
+    if (dr->queries[0][0])
+        glDeleteQueries(DYNAMIC_RES_FRAMES * 2, &dr->queries[0][0]);
+    if (dr->vao)
+        glDeleteVertexArrays(1, &dr->vao);
+    shader_destroy(&dr->sh);
+    memset(dr, 0, sizeof(*dr));
+}
@@ -0,0 +1,139 @@
+#pragma once
+#include <stddef.h>
+#include <glad/glad.h>
+
+#include "Shader.h"
+
+#define DYNAMIC_RES_FRAMES 3         // pary znaczników czasu w locie (odczyt bez czekania na GPU)
+#define DYNAMIC_RES_SETTLE 8         // pomiary przy danej skali przed kolejną zmianą
+#define DYNAMIC_RES_SMOOTHING 0.2f   // waga nowego pomiaru w średniej wykładniczej
+#define DYNAMIC_RES_HEADROOM 0.8f    // poniżej tej części celu skala rośnie (między nią a celem: bez zmian)
+#define DYNAMIC_RES_GOAL 0.9f        // nowa skala celuje w tę część celu (środek pasma bez zmian)
+#define DYNAMIC_RES_STEP 0.05f       // skala zaokrąglana do wielokrotności
+#define DYNAMIC_RES_MAX_UP 0.1f      // najwyżej o tyle w górę na zmianę (w dół bez limitu poza minimum)
+
+/**
+ * @brief Statystyki skalowania.
+ */
+typedef struct DynamicResolutionStats
+{
+    unsigned long frames;       // zmierzone klatki (przy ustalonej skali)
+    unsigned long over_target;  // z czasem GPU powyżej celu
+    double gpu_ms;              // suma czasów GPU
+    double scale;               // suma skal (średnia = scale / frames)
+    size_t increases;
+    size_t decreases;
+    size_t reallocations;       // utworzenia tekstur (pierwsze i po każdej zmianie okna)
+} DynamicResolutionStats;
+
+/**
+ * @brief Rysowanie w mniejszej rozdzielczości, dobieranej do docelowego czasu klatki.
+ *
+ * Scena idzie do FBO (kolor + głębia) o rozmiarze okna, ale viewport
+ * obejmuje tylko jego część: skala * rozmiar okna. Zmiana skali nie
+ * alokuje więc niczego; tekstury są tworzone ponownie tylko po zmianie
+ * rozmiaru okna, leniwie na początku następnej klatki. Na końcu
+ * pełnoekranowy trójkąt skaluje obraz do domyślnego framebuffera
+ * (dwuliniowo, opcjonalnie z wyostrzeniem ograniczonym do zakresu
+ * sąsiednich texeli, więc bez obwódek).
+ *
+ * Czas klatki na GPU (scena + skalowanie) to różnica dwóch znaczników
+ * GL_TIMESTAMP (glQueryCounter), czytanych DYNAMIC_RES_FRAMES klatek
+ * później. Znaczniki nie są zapytaniem aktywnym, więc nie kolidują
+ * z GL_TIME_ELAPSED przebiegu głębi i testu zasłonięcia w środku klatki.
+ * Regulator jest odporny na oscylacje:
+ *  - pomiary sprzed zmiany skali są odrzucane (każdy slot pamięta skalę),
+ *  - decyzja dopiero po DYNAMIC_RES_SETTLE pomiarach przy obecnej skali,
+ *    na średniej wykładniczej,
+ *  - pasmo bez zmian między HEADROOM a 1.0 celu; nowa skala z modelu
+ *    czas ~ liczba pikseli celuje w jego środek (GOAL),
+ *  - w górę małymi krokami, w dół od razu do przewidywanej skali,
+ *  - skala zaokrąglana do DYNAMIC_RES_STEP.
+ *
+ * Bez celu (target_ms == 0) lub po wyłączeniu moduł tylko ustawia
+ * viewport okna i rysowanie idzie wprost do domyślnego framebuffera.
+ */
+typedef struct DynamicResolution
+{
+    ShaderProgram sh;
+    GLint uv_scale_loc, texel_size_loc, sharpness_loc;
+    GLuint vao;                 // pusty: wierzchołki z gl_VertexID
+    GLuint fbo, color, depth;
+    int target_width, target_height; // rozmiar tekstur (0 = nie utworzone)
+
+    int window_width, window_height;   // framebuffer okna (callback zmiany rozmiaru)
+    int viewport_width, viewport_height; // ostatnio ustawiony viewport
+    int render_width, render_height;   // bieżąca klatka
+    int available;              // shader wczytany (skalowanie możliwe)
+    int enabled;
+    int active;                 // bieżąca klatka idzie do FBO
+
+    float target_ms;
+    float min_scale;
+    float sharpness;
+    float scale;
+    float frame_scale;          // skala bieżącej klatki (1 przy doszlifowaniu)
+    double average_ms;          // średnia wykładnicza przy obecnej skali
+    int samples;                // pomiary przy obecnej skali
+
+    GLuint queries[DYNAMIC_RES_FRAMES][2]; // znaczniki początku i końca klatki
+    int pending[DYNAMIC_RES_FRAMES];
+    float slot_scale[DYNAMIC_RES_FRAMES];
+    int slot;
+
+    DynamicResolutionStats stats;
+} DynamicResolution;
+
+/**
+ * @brief Wczytuje shader skalowania (gdy target_ms > 0); tekstury powstają przy pierwszej klatce.
+ *
+ * @param dr        Skalowanie.
+ * @param width     Framebuffer okna.
+ * @param height
+ * @param target_ms Docelowy czas klatki na GPU (0 = zawsze pełna rozdzielczość, bez FBO).
+ * @param min_scale Najmniejsza skala boku (0.25 - 1).
+ * @param sharpness Siła wyostrzenia przy skalowaniu (0 = dwuliniowo).
+ * @return 1 jeśli OK, 0 jeśli shader się nie wczytał (działa jak bez celu).
+ */
+int dynamic_resolution_init(DynamicResolution *dr, int width, int height, float target_ms, float min_scale,
+                            float sharpness);
+
+/**
+ * @brief Nowy rozmiar okna; bez wywołań GL (viewport i tekstury w następnym begin).
+ */
+void dynamic_resolution_resize(DynamicResolution *dr, int width, int height);
+
+/**
+ * @brief Włącza/wyłącza skalowanie (gdy dostępne).
+ */
+void dynamic_resolution_set_enabled(DynamicResolution *dr, int enabled);
+
+/**
+ * @brief Początek klatki: pomiary, regulator, cel renderowania i viewport.
+ *
+ * Przed glClear() sceny.
+ *
+ * @param dr     Skalowanie.
+ * @param native 1 -> ta klatka w pełnej rozdzielczości (doszlifowanie w bezczynności; bez pomiaru).
+ * @param width  Wyjście: rozmiar renderowania (viewport; do uniformów zależnych od ekranu).
+ * @param height
+ * @return 1 jeśli skala wzrosła (obraz w bezczynności warto narysować ponownie).
+ */
+int dynamic_resolution_begin(DynamicResolution *dr, int native, int *width, int *height);
+
+/**
+ * @brief Koniec sceny: skalowanie do domyślnego framebuffera i koniec pomiaru.
+ *
+ * Po powrocie framebuffer 0, viewport okna, test głębi włączony.
+ */
+void dynamic_resolution_end(DynamicResolution *dr);
+
+/**
+ * @brief Wypisuje skalę, czasy GPU i liczbę zmian.
+ */
+void dynamic_resolution_print_stats(const DynamicResolution *dr);
+
+/**
+ * @brief Zwalnia FBO, tekstury, zapytania i shader.
+ */
+void dynamic_resolution_destroy(DynamicResolution *dr);
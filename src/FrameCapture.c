@@ -0,0 +1,539 @@
+#include "FrameCapture.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <GLFW/glfw3.h>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+static int cpu_count(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return (int)si.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+static const char *format_name(CaptureFormat f)
+{
+    switch (f)
+    {
+    case CAPTURE_PNG: return "png";
+    case CAPTURE_RAW: return "raw rgb24";
+    default: return "y4m";
+    }
+}
+
+static int ends_with(const char *s, const char *suffix)
+{
+    size_t n = strlen(s), m = strlen(suffix);
+    return n >= m && strcmp(s + n - m, suffix) == 0;
+}
+
+int frame_capture_format_from_path(const char *path, CaptureFormat *out)
+{
+    if (ends_with(path, ".png"))
+        *out = CAPTURE_PNG;
+    else if (ends_with(path, ".y4m"))
+        *out = CAPTURE_Y4M;
+    else if (ends_with(path, ".rgb") || ends_with(path, ".raw"))
+        *out = CAPTURE_RAW;
+    else
+        return 0;
+    return 1;
+}
+
+/* =========================================================
+   Kodowanie (wątki zapisu)
+   ========================================================= */
+
+/**
+ * @brief RGBA od dołu -> RGB od góry (kolejność wierszy w plikach).
+ */
+static void rgba_to_rgb_flipped(const CaptureFrame *f, unsigned char *dst)
+{
+    for (int y = 0; y < f->height; y++)
+    {
+        const unsigned char *src = f->pixels + (size_t)(f->height - 1 - y) * (size_t)f->width * 4;
+        unsigned char *row = dst + (size_t)y * (size_t)f->width * 3;
+        for (int x = 0; x < f->width; x++)
+        {
+            row[x * 3 + 0] = src[x * 4 + 0];
+            row[x * 3 + 1] = src[x * 4 + 1];
+            row[x * 3 + 2] = src[x * 4 + 2];
+        }
+    }
+}
+
+/**
+ * @brief RGBA od dołu -> płaszczyzny Y, Cb, Cr 4:2:0 (BT.601, zakres TV).
+ */
+static void rgba_to_yuv420(const CaptureFrame *f, unsigned char *dst)
+{
+    int w = f->width, h = f->height;
+    int cw = (w + 1) / 2, chh = (h + 1) / 2;
+    unsigned char *yp = dst;
+    unsigned char *up = dst + (size_t)w * h;
+    unsigned char *vp = up + (size_t)cw * chh;
+
+    for (int y = 0; y < h; y++)
+    {
+        const unsigned char *src = f->pixels + (size_t)(h - 1 - y) * (size_t)w * 4;
+        for (int x = 0; x < w; x++)
+        {
+            int r = src[x * 4 + 0], g = src[x * 4 + 1], b = src[x * 4 + 2];
+            yp[(size_t)y * w + x] = (unsigned char)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+        }
+    }
+
+    for (int cy = 0; cy < chh; cy++)
+    {
+        for (int cx = 0; cx < cw; cx++)
+        {
+            // średnia z bloku 2x2 (na krawędzi nieparzystego obrazu mniej pikseli)
+            int r = 0, g = 0, b = 0, n = 0;
+            for (int dy = 0; dy < 2; dy++)
+            {
+                int y = cy * 2 + dy;
+                if (y >= h)
+                    continue;
+                const unsigned char *src = f->pixels + (size_t)(h - 1 - y) * (size_t)w * 4;
+                for (int dx = 0; dx < 2; dx++)
+                {
+                    int x = cx * 2 + dx;
+                    if (x >= w)
+                        continue;
+                    r += src[x * 4 + 0];
+                    g += src[x * 4 + 1];
+                    b += src[x * 4 + 2];
+                    n++;
+                }
+            }
+            r /= n;
+            g /= n;
+            b /= n;
+            up[(size_t)cy * cw + cx] = (unsigned char)(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            vp[(size_t)cy * cw + cx] = (unsigned char)(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+}
+
+/**
+ * @brief Koduje i zapisuje jedną klatkę.
+ *
+ * @param scratch Bufor roboczy wątku (powiększany w razie potrzeby).
+ * @return 1 jeśli OK, 0 jeśli błąd zapisu.
+ */
+static int write_frame(FrameCapture *c, const CaptureFrame *f, unsigned char **scratch, size_t *scratch_cap)
+{
+    size_t need = (size_t)f->width * (size_t)f->height * 3;
+    if (need > *scratch_cap)
+    {
+        unsigned char *n = (unsigned char *)realloc(*scratch, need);
+        if (!n)
+            return 0;
+        *scratch = n;
+        *scratch_cap = need;
+    }
+
+    if (c->format == CAPTURE_PNG)
+    {
+        // "dir/shot.png" -> "dir/shot_000042.png"
+        char name[600];
+        size_t stem = strlen(c->path) - 4;
+        snprintf(name, sizeof(name), "%.*s_%06lu.png", (int)stem, c->path, f->index);
+        rgba_to_rgb_flipped(f, *scratch);
+        return stbi_write_png(name, f->width, f->height, 3, *scratch, f->width * 3) != 0;
+    }
+
+    // strumienie: jeden wątek zapisu, klatki w kolejności przechwycenia
+    if (c->format == CAPTURE_RAW)
+    {
+        rgba_to_rgb_flipped(f, *scratch);
+        return fwrite(*scratch, 1, need, c->stream) == need;
+    }
+
+    if (!c->stream_header)
+    {
+        // tempo nieznane z góry — zakładamy 60 Hz (vsync)
+        fprintf(c->stream, "YUV4MPEG2 W%d H%d F60:1 Ip A1:1 C420jpeg\n", f->width, f->height);
+        c->stream_header = 1;
+    }
+    size_t yuv = (size_t)f->width * f->height +
+                 2 * (size_t)((f->width + 1) / 2) * (size_t)((f->height + 1) / 2);
+    rgba_to_yuv420(f, *scratch);
+    fputs("FRAME\n", c->stream);
+    return fwrite(*scratch, 1, yuv, c->stream) == yuv;
+}
+
+static void *writer_main(void *arg)
+{
+    FrameCapture *c = (FrameCapture *)arg;
+    unsigned char *scratch = NULL;
+    size_t scratchCap = 0;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&c->lock);
+        while (c->ready_count == 0 && !c->quit)
+            pthread_cond_wait(&c->ready_cond, &c->lock);
+        if (c->ready_count == 0)
+        {
+            pthread_mutex_unlock(&c->lock);
+            break;
+        }
+        int slot = c->ready[c->ready_head];
+        c->ready_head = (c->ready_head + 1) % CAPTURE_QUEUE_FRAMES;
+        c->ready_count--;
+        pthread_mutex_unlock(&c->lock);
+
+        double t0 = glfwGetTime();
+        int ok = write_frame(c, &c->frames[slot], &scratch, &scratchCap);
+        double dt = glfwGetTime() - t0;
+
+        pthread_mutex_lock(&c->lock);
+        if (!ok && !c->write_failed)
+        {
+            c->write_failed = 1;
+            printf("ERROR: capture write failed (%s)\n", c->path);
+        }
+        c->write_seconds += dt;
+        c->free_list[c->free_count++] = slot;
+        pthread_cond_signal(&c->free_cond);
+        pthread_mutex_unlock(&c->lock);
+    }
+
+    free(scratch);
+    return NULL;
+}
+
+/* =========================================================
+   Wątek renderu
+   ========================================================= */
+
+/**
+ * @brief Wolny bufor kolejki (czeka na wątek zapisu, jeśli wszystkie zajęte).
+ */
+static CaptureFrame *acquire_frame(FrameCapture *c, int *slot)
+{
+    pthread_mutex_lock(&c->lock);
+    if (c->free_count == 0)
+    {
+        c->queue_stalls++;
+        while (c->free_count == 0)
+            pthread_cond_wait(&c->free_cond, &c->lock);
+    }
+    *slot = c->free_list[--c->free_count];
+    pthread_mutex_unlock(&c->lock);
+    return &c->frames[*slot];
+}
+
+static void submit_frame(FrameCapture *c, int slot)
+{
+    pthread_mutex_lock(&c->lock);
+    int tail = (c->ready_head + c->ready_count) % CAPTURE_QUEUE_FRAMES;
+    c->ready[tail] = slot;
+    c->ready_count++;
+    c->frames_sent++;
+    pthread_cond_signal(&c->ready_cond);
+    pthread_mutex_unlock(&c->lock);
+}
+
+/**
+ * @brief Zapewnia bufor na w x h RGBA; przy błędzie alokacji oddaje go do puli.
+ */
+static int reserve_frame(FrameCapture *c, CaptureFrame *f, int slot, int w, int h)
+{
+    size_t bytes = (size_t)w * (size_t)h * 4;
+    if (bytes > f->capacity)
+    {
+        unsigned char *n = (unsigned char *)realloc(f->pixels, bytes);
+        if (!n)
+        {
+            pthread_mutex_lock(&c->lock);
+            c->free_list[c->free_count++] = slot;
+            pthread_mutex_unlock(&c->lock);
+            c->skipped++;
+            return 0;
+        }
+        f->pixels = n;
+        f->capacity = bytes;
+    }
+    f->width = w;
+    f->height = h;
+    return 1;
+}
+
+/**
+ * @brief Mapuje PBO z gotowym odczytem i przekazuje kopię do zapisu.
+ */
+static void read_back(FrameCapture *c, int p)
+{
+    glDeleteSync(c->fence[p]);
+    c->fence[p] = 0;
+    c->pending--;
+
+    int slot;
+    CaptureFrame *f = acquire_frame(c, &slot);
+    if (!reserve_frame(c, f, slot, c->pbo_width[p], c->pbo_height[p]))
+        return;
+    f->index = c->pbo_frame[p];
+
+    size_t bytes = (size_t)f->width * (size_t)f->height * 4;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, c->pbo[p]);
+    void *src = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)bytes, GL_MAP_READ_BIT);
+    if (src)
+    {
+        memcpy(f->pixels, src, bytes);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (!src)
+    {
+        pthread_mutex_lock(&c->lock);
+        c->free_list[c->free_count++] = slot;
+        pthread_mutex_unlock(&c->lock);
+        c->skipped++;
+        return;
+    }
+    submit_frame(c, slot);
+}
+
+/**
+ * @brief Odbiera odczyty od najstarszego; blocking = 0 -> tylko gotowe.
+ */
+static void collect(FrameCapture *c, int blocking)
+{
+    while (c->pending > 0)
+    {
+        int oldest = (c->head - c->pending + CAPTURE_PBO_COUNT) % CAPTURE_PBO_COUNT;
+        GLenum s = glClientWaitSync(c->fence[oldest], 0, 0);
+        if (s == GL_TIMEOUT_EXPIRED)
+        {
+            if (!blocking)
+                return;
+            do
+                s = glClientWaitSync(c->fence[oldest], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+            while (s == GL_TIMEOUT_EXPIRED);
+        }
+        read_back(c, oldest);
+    }
+}
+
+int frame_capture_start(FrameCapture *c, const char *path, int sync)
+{
+    memset(c, 0, sizeof(*c));
+    if (!frame_capture_format_from_path(path, &c->format))
+    {
+        printf("ERROR: capture path must end with .png, .y4m, .rgb or .raw: %s\n", path);
+        return 0;
+    }
+    if (strlen(path) >= sizeof(c->path))
+    {
+        printf("ERROR: capture path too long: %s\n", path);
+        return 0;
+    }
+    strcpy(c->path, path);
+    c->sync = sync;
+
+    if (c->format != CAPTURE_PNG)
+    {
+        c->stream = fopen(path, "wb");
+        if (!c->stream)
+        {
+            printf("ERROR: cannot open capture file: %s\n", path);
+            return 0;
+        }
+    }
+
+    if (!c->sync)
+        glGenBuffers(CAPTURE_PBO_COUNT, c->pbo);
+
+    pthread_mutex_init(&c->lock, NULL);
+    pthread_cond_init(&c->ready_cond, NULL);
+    pthread_cond_init(&c->free_cond, NULL);
+    for (int i = 0; i < CAPTURE_QUEUE_FRAMES; i++)
+        c->free_list[c->free_count++] = i;
+
+    // PNG: pliki niezależne -> kilka koderów; strumień wymaga kolejności -> jeden
+    int writers = 1;
+    if (c->format == CAPTURE_PNG)
+    {
+        writers = cpu_count() - 1;
+        if (writers > CAPTURE_MAX_WRITERS) writers = CAPTURE_MAX_WRITERS;
+        if (writers < 1) writers = 1;
+    }
+    for (int i = 0; i < writers; i++)
+    {
+        if (pthread_create(&c->writers[c->writer_count], NULL, writer_main, c) != 0)
+            break;
+        c->writer_count++;
+    }
+    if (c->writer_count == 0)
+    {
+        printf("ERROR: cannot start capture writer thread\n");
+        frame_capture_stop(c);
+        return 0;
+    }
+
+    c->active = 1;
+    c->last_time = -1.0;
+    printf("[capture] %s -> %s (%s, %d writer%s)\n", format_name(c->format), path,
+           c->sync ? "synchronous glReadPixels" : "async PBO ring",
+           c->writer_count, c->writer_count > 1 ? "s" : "");
+    return 1;
+}
+
+void frame_capture_frame(FrameCapture *c, int width, int height)
+{
+    double t0 = glfwGetTime();
+    if (c->last_time >= 0.0)
+        c->frame_seconds += t0 - c->last_time;
+    c->last_time = t0;
+
+    // gotowe odczyty odbieramy także w pauzie
+    if (!c->sync)
+        collect(c, 0);
+
+    if (!c->active || width <= 0 || height <= 0)
+    {
+        c->cpu_seconds += glfwGetTime() - t0;
+        return;
+    }
+
+    // raw / Y4M: jeden rozmiar na cały plik
+    if (c->format != CAPTURE_PNG)
+    {
+        if (c->width == 0)
+        {
+            c->width = width;
+            c->height = height;
+        }
+        else if (c->width != width || c->height != height)
+        {
+            if (c->skipped++ == 0)
+                printf("WARNING: capture size changed (%dx%d -> %dx%d), frames skipped\n",
+                       c->width, c->height, width, height);
+            c->cpu_seconds += glfwGetTime() - t0;
+            return;
+        }
+    }
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+    if (c->sync)
+    {
+        // ścieżka porównawcza: glReadPixels czeka na zakończenie klatki
+        int slot;
+        CaptureFrame *f = acquire_frame(c, &slot);
+        if (reserve_frame(c, f, slot, width, height))
+        {
+            f->index = c->next_index++;
+            glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, f->pixels);
+            submit_frame(c, slot);
+        }
+        c->cpu_seconds += glfwGetTime() - t0;
+        return;
+    }
+
+    // pierścień pełny -> GPU jest CAPTURE_PBO_COUNT klatek z tyłu
+    if (c->pending == CAPTURE_PBO_COUNT)
+    {
+        c->fence_stalls++;
+        int oldest = c->head;
+        GLenum s;
+        do
+            s = glClientWaitSync(c->fence[oldest], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+        while (s == GL_TIMEOUT_EXPIRED);
+        read_back(c, oldest);
+    }
+
+    int p = c->head;
+    size_t bytes = (size_t)width * (size_t)height * 4;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, c->pbo[p]);
+    if (bytes > c->pbo_capacity[p])
+    {
+        glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)bytes, NULL, GL_STREAM_READ);
+        c->pbo_capacity[p] = bytes;
+    }
+    // kopiowanie do PBO po stronie GPU — wywołanie nie czeka na wynik
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, (void *)0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    c->fence[p] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    c->pbo_frame[p] = c->next_index++;
+    c->pbo_width[p] = width;
+    c->pbo_height[p] = height;
+    c->head = (c->head + 1) % CAPTURE_PBO_COUNT;
+    c->pending++;
+
+    c->cpu_seconds += glfwGetTime() - t0;
+}
+
+void frame_capture_print_stats(FrameCapture *c)
+{
+    // liczniki zapisu zmieniają wątki zapisu
+    pthread_mutex_lock(&c->lock);
+    unsigned long sent = c->frames_sent;
+    double writeSeconds = c->write_seconds;
+    pthread_mutex_unlock(&c->lock);
+
+    double calls = c->next_index ? (double)c->next_index : 1.0;
+    double cpuMs = c->cpu_seconds / calls * 1000.0;
+    double frameMs = c->next_index > 1 ? c->frame_seconds / (double)(c->next_index - 1) * 1000.0 : 0.0;
+
+    printf("[capture] %s %s | %lu frames, %lu skipped | render thread %.3f ms/frame",
+           c->sync ? "sync" : "async PBO", format_name(c->format), sent, c->skipped, cpuMs);
+    if (frameMs > 0.0)
+        printf(" (%.1f%% of %.2f ms frame)", cpuMs / frameMs * 100.0, frameMs);
+    printf(" | fence stalls %lu, queue stalls %lu | encode %.2f ms/frame on %d writer%s\n",
+           c->fence_stalls, c->queue_stalls, sent ? writeSeconds / (double)sent * 1000.0 : 0.0,
+           c->writer_count, c->writer_count > 1 ? "s" : "");
+}
+
+void frame_capture_stop(FrameCapture *c)
+{
+    if (c->writer_count > 0)
+    {
+        if (!c->sync)
+            collect(c, 1);
+
+        pthread_mutex_lock(&c->lock);
+        c->quit = 1;
+        pthread_cond_broadcast(&c->ready_cond);
+        pthread_mutex_unlock(&c->lock);
+        for (int i = 0; i < c->writer_count; i++)
+            pthread_join(c->writers[i], NULL);
+
+        frame_capture_print_stats(c);
+        printf("[capture] wrote %lu frames to %s\n", c->frames_sent, c->path);
+    }
+
+    if (c->stream)
+        fclose(c->stream);
+    if (c->pbo[0])
+        glDeleteBuffers(CAPTURE_PBO_COUNT, c->pbo);
+    for (int i = 0; i < CAPTURE_PBO_COUNT; i++)
+        if (c->fence[i])
+            glDeleteSync(c->fence[i]);
+    for (int i = 0; i < CAPTURE_QUEUE_FRAMES; i++)
+        free(c->frames[i].pixels);
+
+    pthread_mutex_destroy(&c->lock);
+    pthread_cond_destroy(&c->ready_cond);
+    pthread_cond_destroy(&c->free_cond);
+    memset(c, 0, sizeof(*c));
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include <stddef.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <glad/glad.h>
+
+#define CAPTURE_PBO_COUNT 3     // odczyty "w locie" (mapowanie po ~2 klatkach)
+#define CAPTURE_QUEUE_FRAMES 8  // bufory CPU czekające na zapis
+#define CAPTURE_MAX_WRITERS 4
+
+/**
+ * @brief Format zapisu przechwyconych klatek.
+ */
+typedef enum CaptureFormat
+{
+    CAPTURE_PNG = 0, // sekwencja plików prefix_000000.png (kilka wątków zapisu)
+    CAPTURE_RAW,     // jeden plik rgb24, klatki jedna za drugą (ffmpeg -f rawvideo)
+    CAPTURE_Y4M      // YUV4MPEG2 4:2:0 (BT.601)
+} CaptureFormat;
+
+/**
+ * @brief Klatka w kolejce zapisu.
+ */
+typedef struct CaptureFrame
+{
+    unsigned char *pixels; // RGBA, wiersz 0 = dół obrazu (jak glReadPixels)
+    size_t capacity;
+    int width, height;
+    unsigned long index;
+} CaptureFrame;
+
+/**
+ * @brief Asynchroniczne przechwytywanie klatek przez pierścień PBO.
+ *
+ * Co klatkę glReadPixels trafia do kolejnego PBO (kopiowanie po stronie
+ * GPU, bez czekania) i dostaje fence. PBO mapowany jest dopiero wtedy,
+ * gdy jego fence jest gotowy — zwykle po CAPTURE_PBO_COUNT - 1 klatkach —
+ * a jego zawartość jest kopiowana do bufora kolejki. Kodowanie
+ * (PNG / raw / Y4M) i zapis na dysk robią wątki zapisu.
+ */
+typedef struct FrameCapture
+{
+    CaptureFormat format;
+    char path[512];
+    int width, height; // rozmiar ustalony przy pierwszej klatce (raw/Y4M)
+    int active;        // 0 = wstrzymane
+    int sync;          // 1 = glReadPixels bez PBO (porównanie kosztu)
+
+    /* pierścień PBO */
+    GLuint pbo[CAPTURE_PBO_COUNT];
+    GLsync fence[CAPTURE_PBO_COUNT];
+    unsigned long pbo_frame[CAPTURE_PBO_COUNT];
+    int pbo_width[CAPTURE_PBO_COUNT];
+    int pbo_height[CAPTURE_PBO_COUNT];
+    size_t pbo_capacity[CAPTURE_PBO_COUNT];
+    int head;    // następny PBO do zapisu
+    int pending; // PBO z odczytem w locie
+
+    /* kolejka do wątków zapisu */
+    pthread_mutex_t lock;
+    pthread_cond_t ready_cond; // jest klatka do zapisu / koniec
+    pthread_cond_t free_cond;  // jest wolny bufor
+    CaptureFrame frames[CAPTURE_QUEUE_FRAMES];
+    int free_list[CAPTURE_QUEUE_FRAMES];
+    int free_count;
+    int ready[CAPTURE_QUEUE_FRAMES]; // FIFO
+    int ready_head, ready_count;
+    int quit;
+    pthread_t writers[CAPTURE_MAX_WRITERS];
+    int writer_count;
+    FILE *stream;      // raw / Y4M
+    int stream_header; // nagłówek Y4M zapisany
+    int write_failed;
+
+    unsigned long next_index;
+
+    /* statystyki */
+    unsigned long frames_sent;   // wysłane do zapisu
+    unsigned long skipped;       // pominięte (zmiana rozmiaru przy raw/Y4M)
+    unsigned long fence_stalls;  // pierścień pełny, czekanie na GPU
+    unsigned long queue_stalls;  // brak wolnego bufora, czekanie na zapis
+    double cpu_seconds;          // czas w frame_capture_frame (wątek renderu)
+    double frame_seconds;        // suma odstępów między klatkami
+    double last_time;
+    double write_seconds;        // kodowanie + zapis (wątki zapisu)
+} FrameCapture;
+
+/**
+ * @brief Format na podstawie rozszerzenia (.png, .y4m, .rgb/.raw).
+ *
+ * @return 1 jeśli rozpoznano, 0 w przeciwnym razie.
+ */
+int frame_capture_format_from_path(const char *path, CaptureFormat *out);
+
+/**
+ * @brief Tworzy PBO i uruchamia wątki zapisu.
+ *
+ * @param c    Stan przechwytywania.
+ * @param path Plik (raw/Y4M) albo wzorzec sekwencji PNG ("dir/shot.png").
+ * @param sync 1 -> synchroniczny glReadPixels (do porównań).
+ * @return 1 jeśli OK, 0 jeśli błąd.
+ */
+int frame_capture_start(FrameCapture *c, const char *path, int sync);
+
+/**
+ * @brief Przechwytuje bieżący tylny bufor (wołać przed glfwSwapBuffers).
+ *
+ * Zbiera też gotowe odczyty z poprzednich klatek.
+ *
+ * @param c      Stan przechwytywania.
+ * @param width  Rozmiar framebuffera.
+ * @param height Rozmiar framebuffera.
+ */
+void frame_capture_frame(FrameCapture *c, int width, int height);
+
+/**
+ * @brief Wypisuje koszt przechwytywania względem czasu klatki.
+ */
+void frame_capture_print_stats(FrameCapture *c);
+
+/**
+ * @brief Odbiera zaległe odczyty, kończy zapis i zwalnia zasoby.
+ */
+void frame_capture_stop(FrameCapture *c);
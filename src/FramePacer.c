@@ -0,0 +1,171 @@
+#include "FramePacer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <GLFW/glfw3.h>
+
+#define PACER_SPIN_MS 1.0   // ostatni odcinek snu: aktywne czekanie (dokładność timera)
+#define PACER_BUILD_EMA 0.1 // waga nowej próbki w średniej czasu budowy klatki
+
+static double pacer_now(void)
+{
+    return (double)glfwGetTimerValue() * 1000.0 / (double)glfwGetTimerFrequency();
+}
+
+static int cmp_float(const void *a, const void *b)
+{
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+void frame_pacer_init(FramePacer *p, int max_in_flight, float target_fps)
+{
+    memset(p, 0, sizeof(*p));
+    if (max_in_flight < 0)
+        max_in_flight = 0;
+    if (max_in_flight > FRAME_PACER_MAX_IN_FLIGHT)
+        max_in_flight = FRAME_PACER_MAX_IN_FLIGHT;
+    p->max_in_flight = max_in_flight;
+    p->target_ms = target_fps > 0.0f ? 1000.0 / (double)target_fps : 0.0;
+}
+
+/**
+ * @brief Czeka na fence najstarszej klatki w locie.
+ */
+static void wait_in_flight(FramePacer *p)
+{
+    GLsync fence = p->fences[p->fence_head];
+    if (!fence)
+        return;
+
+    double t0 = pacer_now();
+    GLenum s;
+    do
+        s = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+    while (s == GL_TIMEOUT_EXPIRED);
+    glDeleteSync(fence);
+    p->fences[p->fence_head] = 0;
+    p->fence_wait_ms += pacer_now() - t0;
+}
+
+/**
+ * @brief Śpi do chwili wake, obsługując zdarzenia na bieżąco.
+ *
+ * Zdarzenia z czasu snu dostają prawdziwy znacznik czasu
+ * (frame_pacer_input() w callbackach), więc pomiar opóźnienia
+ * obejmuje także oczekiwanie.
+ */
+static void sleep_until(FramePacer *p, double wake)
+{
+    double t0 = pacer_now();
+    double now = t0;
+    while (wake - now > PACER_SPIN_MS)
+    {
+        glfwWaitEventsTimeout((wake - now - PACER_SPIN_MS) / 1000.0);
+        now = pacer_now();
+    }
+    while (now < wake)
+        now = pacer_now();
+    p->sleep_ms += now - t0;
+}
+
+void frame_pacer_begin(FramePacer *p)
+{
+    if (p->max_in_flight > 0)
+        wait_in_flight(p);
+
+    if (p->target_ms > 0.0)
+    {
+        double now = pacer_now();
+        // spóźniona klatka -> nowy termin zamiast nadrabiania serią klatek
+        if (p->next_deadline < now)
+            p->next_deadline = now + p->target_ms;
+        // wejście zbierane tak, by klatka była gotowa akurat na termin
+        sleep_until(p, p->next_deadline - p->build_ms);
+    }
+}
+
+void frame_pacer_latch(FramePacer *p)
+{
+    p->latch_at = pacer_now();
+}
+
+void frame_pacer_input(FramePacer *p)
+{
+    if (p->input_at == 0.0)
+        p->input_at = pacer_now();
+}
+
+void frame_pacer_end(FramePacer *p)
+{
+    double now = pacer_now();
+
+    if (p->max_in_flight > 0)
+    {
+        p->fences[p->fence_head] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        p->fence_head = (p->fence_head + 1) % p->max_in_flight;
+    }
+
+    double build = now - p->latch_at;
+    p->build_ms = p->frames ? p->build_ms + (build - p->build_ms) * PACER_BUILD_EMA : build;
+    if (p->target_ms > 0.0)
+        p->next_deadline += p->target_ms;
+
+    // tylko zdarzenia zebrane przed zbudowaniem tej klatki
+    if (p->input_at > 0.0 && p->input_at <= p->latch_at)
+    {
+        p->samples[p->sample_count % FRAME_PACER_SAMPLES] = (float)(now - p->input_at);
+        p->sample_count++;
+        p->input_at = 0.0;
+    }
+    p->frames++;
+}
+
+void frame_pacer_print_stats(const FramePacer *p)
+{
+    double frames = p->frames ? (double)p->frames : 1.0;
+    char inFlight[32];
+    if (p->max_in_flight > 0)
+        snprintf(inFlight, sizeof(inFlight), "%d in flight", p->max_in_flight);
+    else
+        snprintf(inFlight, sizeof(inFlight), "unlimited in flight");
+
+    char target[32];
+    if (p->target_ms > 0.0)
+        snprintf(target, sizeof(target), "%.1f fps", 1000.0 / p->target_ms);
+    else
+        snprintf(target, sizeof(target), "off");
+
+    printf("[pacing] %s, target %s | fence wait %.3f ms/frame, sleep %.3f ms/frame, build %.3f ms\n",
+           inFlight, target, p->fence_wait_ms / frames, p->sleep_ms / frames, p->build_ms);
+
+    size_t n = p->sample_count < FRAME_PACER_SAMPLES ? p->sample_count : FRAME_PACER_SAMPLES;
+    if (n == 0)
+    {
+        printf("[pacing] input->swap: no input samples yet\n");
+        return;
+    }
+
+    float sorted[FRAME_PACER_SAMPLES];
+    memcpy(sorted, p->samples, n * sizeof(float));
+    qsort(sorted, n, sizeof(float), cmp_float);
+
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++)
+        sum += sorted[i];
+    printf("[pacing] input->swap over last %zu frames with input: mean %.2f ms, p50 %.2f, "
+           "p90 %.2f, p99 %.2f, max %.2f\n",
+           n, sum / (double)n, sorted[n / 2], sorted[n * 90 / 100], sorted[n * 99 / 100], sorted[n - 1]);
+}
+
+void frame_pacer_destroy(FramePacer *p)
+{
+    for (int i = 0; i < FRAME_PACER_MAX_IN_FLIGHT; i++)
+    {
+        if (p->fences[i])
+        {
+            glDeleteSync(p->fences[i]);
+            p->fences[i] = 0;
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <stddef.h>
+#include <glad/glad.h>
+
+#define FRAME_PACER_MAX_IN_FLIGHT 4
+#define FRAME_PACER_SAMPLES 1024 // okno pomiaru opóźnienia (ostatnie klatki z wejściem)
+
+/**
+ * @brief Tempo klatek z małym opóźnieniem wejścia.
+ *
+ * Bez ograniczenia sterownik kolejkuje kilka klatek, więc obraz
+ * pokazuje wejście sprzed kilku klatek. Pacer:
+ *  - po podmianie bufora stawia fence i przed kolejną klatką czeka,
+ *    aż na GPU zostanie najwyżej max_in_flight - 1 starszych klatek,
+ *  - opcjonalnie śpi do celu czasu klatki, budząc się tuż przed
+ *    terminem pomniejszonym o przewidywany czas budowy klatki,
+ *  - dopiero wtedy zbiera wejście (glfwPollEvents w pętli), więc
+ *    macierz widoku powstaje z najświeższych zdarzeń.
+ *
+ * Opóźnienie "wejście -> swap" to czas od pierwszego nieobsłużonego
+ * zdarzenia (frame_pacer_input()) do powrotu z glfwSwapBuffers.
+ */
+typedef struct FramePacer
+{
+    int max_in_flight;   // 1 = GPU kończy klatkę przed startem następnej
+    double target_ms;    // 0 = bez usypiania
+    GLsync fences[FRAME_PACER_MAX_IN_FLIGHT];
+    int fence_head;
+
+    double next_deadline; // ms, termin swapu kolejnej klatki
+    double build_ms;     // średnia krocząca: od zebrania wejścia do swapu
+    double input_at;     // pierwsze zdarzenie od ostatniego swapu (0 = brak)
+    double latch_at;     // chwila zebrania wejścia w bieżącej klatce
+
+    /* statystyki */
+    float samples[FRAME_PACER_SAMPLES]; // opóźnienie wejście -> swap (ms)
+    size_t sample_count;                // łącznie (okno = ostatnie FRAME_PACER_SAMPLES)
+    unsigned long frames;
+    double fence_wait_ms;
+    double sleep_ms;
+} FramePacer;
+
+/**
+ * @brief Inicjalizuje pacer.
+ *
+ * @param p             Pacer.
+ * @param max_in_flight Klatki w locie (1..FRAME_PACER_MAX_IN_FLIGHT, 0 = bez limitu).
+ * @param target_fps    Docelowe FPS (0 = bez usypiania).
+ */
+void frame_pacer_init(FramePacer *p, int max_in_flight, float target_fps);
+
+/**
+ * @brief Początek klatki: czeka na GPU i śpi do chwili zebrania wejścia.
+ *
+ * Po powrocie wywołać glfwPollEvents() i frame_pacer_latch().
+ */
+void frame_pacer_begin(FramePacer *p);
+
+/**
+ * @brief Zapamiętuje chwilę zebrania wejścia (po glfwPollEvents()).
+ */
+void frame_pacer_latch(FramePacer *p);
+
+/**
+ * @brief Zgłasza zdarzenie wejścia (z callbacków GLFW).
+ */
+void frame_pacer_input(FramePacer *p);
+
+/**
+ * @brief Koniec klatki (po glfwSwapBuffers): fence i pomiar opóźnienia.
+ */
+void frame_pacer_end(FramePacer *p);
+
+/**
+ * @brief Wypisuje percentyle opóźnienia wejście -> swap i czasy czekania.
+ */
+void frame_pacer_print_stats(const FramePacer *p);
+
+/**
+ * @brief Zwalnia fence.
+ */
+void frame_pacer_destroy(FramePacer *p);
@@ -0,0 +1,1096 @@
+#include "GlRecord.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glad/glad.h>
+
+#define REC_IO_BUFFER (1 << 20)
+#define REC_MAX_MAPS 8
+
+/* Nagrywane funkcje: nazwa i typ wskaźnika glad */
+#define REC_FUNCS(X)                                          \
+    X(ActiveTexture, PFNGLACTIVETEXTUREPROC)                  \
+    X(AttachShader, PFNGLATTACHSHADERPROC)                    \
+    X(BeginConditionalRender, PFNGLBEGINCONDITIONALRENDERPROC) \
+    X(BeginQuery, PFNGLBEGINQUERYPROC)                        \
+    X(BindBuffer, PFNGLBINDBUFFERPROC)                        \
+    X(BindBufferRange, PFNGLBINDBUFFERRANGEPROC)              \
+    X(BindFramebuffer, PFNGLBINDFRAMEBUFFERPROC)              \
+    X(BindTexture, PFNGLBINDTEXTUREPROC)                      \
+    X(BindVertexArray, PFNGLBINDVERTEXARRAYPROC)              \
+    X(BufferData, PFNGLBUFFERDATAPROC)                        \
+    X(BufferSubData, PFNGLBUFFERSUBDATAPROC)                  \
+    X(CheckFramebufferStatus, PFNGLCHECKFRAMEBUFFERSTATUSPROC) \
+    X(Clear, PFNGLCLEARPROC)                                  \
+    X(ClearColor, PFNGLCLEARCOLORPROC)                        \
+    X(ClientWaitSync, PFNGLCLIENTWAITSYNCPROC)                \
+    X(ColorMask, PFNGLCOLORMASKPROC)                          \
+    X(CompileShader, PFNGLCOMPILESHADERPROC)                  \
+    X(CreateProgram, PFNGLCREATEPROGRAMPROC)                  \
+    X(CreateShader, PFNGLCREATESHADERPROC)                    \
+    X(DeleteBuffers, PFNGLDELETEBUFFERSPROC)                  \
+    X(DeleteFramebuffers, PFNGLDELETEFRAMEBUFFERSPROC)        \
+    X(DeleteProgram, PFNGLDELETEPROGRAMPROC)                  \
+    X(DeleteQueries, PFNGLDELETEQUERIESPROC)                  \
+    X(DeleteShader, PFNGLDELETESHADERPROC)                    \
+    X(DeleteSync, PFNGLDELETESYNCPROC)                        \
+    X(DeleteTextures, PFNGLDELETETEXTURESPROC)                \
+    X(DeleteVertexArrays, PFNGLDELETEVERTEXARRAYSPROC)        \
+    X(DepthFunc, PFNGLDEPTHFUNCPROC)                          \
+    X(DepthMask, PFNGLDEPTHMASKPROC)                          \
+    X(Disable, PFNGLDISABLEPROC)                              \
+    X(DrawArrays, PFNGLDRAWARRAYSPROC)                        \
+    X(DrawElements, PFNGLDRAWELEMENTSPROC)                    \
+    X(Enable, PFNGLENABLEPROC)                                \
+    X(EnableVertexAttribArray, PFNGLENABLEVERTEXATTRIBARRAYPROC) \
+    X(EndConditionalRender, PFNGLENDCONDITIONALRENDERPROC)    \
+    X(EndQuery, PFNGLENDQUERYPROC)                            \
+    X(FenceSync, PFNGLFENCESYNCPROC)                          \
+    X(Finish, PFNGLFINISHPROC)                                \
+    X(FramebufferTexture2D, PFNGLFRAMEBUFFERTEXTURE2DPROC)    \
+    X(GenBuffers, PFNGLGENBUFFERSPROC)                        \
+    X(GenFramebuffers, PFNGLGENFRAMEBUFFERSPROC)              \
+    X(GenQueries, PFNGLGENQUERIESPROC)                        \
+    X(GenTextures, PFNGLGENTEXTURESPROC)                      \
+    X(GenVertexArrays, PFNGLGENVERTEXARRAYSPROC)              \
+    X(GenerateMipmap, PFNGLGENERATEMIPMAPPROC)                \
+    X(GetError, PFNGLGETERRORPROC)                            \
+    X(GetIntegerv, PFNGLGETINTEGERVPROC)                      \
+    X(GetProgramInfoLog, PFNGLGETPROGRAMINFOLOGPROC)          \
+    X(GetProgramiv, PFNGLGETPROGRAMIVPROC)                    \
+    X(GetQueryObjectui64v, PFNGLGETQUERYOBJECTUI64VPROC)      \
+    X(GetShaderInfoLog, PFNGLGETSHADERINFOLOGPROC)            \
+    X(GetShaderiv, PFNGLGETSHADERIVPROC)                      \
+    X(GetUniformBlockIndex, PFNGLGETUNIFORMBLOCKINDEXPROC)    \
+    X(GetUniformLocation, PFNGLGETUNIFORMLOCATIONPROC)        \
+    X(LinkProgram, PFNGLLINKPROGRAMPROC)                      \
+    X(MapBufferRange, PFNGLMAPBUFFERRANGEPROC)                \
+    X(PixelStorei, PFNGLPIXELSTOREIPROC)                      \
+    X(QueryCounter, PFNGLQUERYCOUNTERPROC)                    \
+    X(ReadPixels, PFNGLREADPIXELSPROC)                        \
+    X(ShaderSource, PFNGLSHADERSOURCEPROC)                    \
+    X(TexBuffer, PFNGLTEXBUFFERPROC)                          \
+    X(TexImage2D, PFNGLTEXIMAGE2DPROC)                        \
+    X(TexImage3D, PFNGLTEXIMAGE3DPROC)                        \
+    X(TexParameteri, PFNGLTEXPARAMETERIPROC)                  \
+    X(Uniform1f, PFNGLUNIFORM1FPROC)                          \
+    X(Uniform1i, PFNGLUNIFORM1IPROC)                          \
+    X(Uniform2f, PFNGLUNIFORM2FPROC)                          \
+    X(Uniform3f, PFNGLUNIFORM3FPROC)                          \
+    X(Uniform3fv, PFNGLUNIFORM3FVPROC)                        \
+    X(Uniform4f, PFNGLUNIFORM4FPROC)                          \
+    X(UniformBlockBinding, PFNGLUNIFORMBLOCKBINDINGPROC)      \
+    X(UnmapBuffer, PFNGLUNMAPBUFFERPROC)                      \
+    X(UseProgram, PFNGLUSEPROGRAMPROC)                        \
+    X(VertexAttribPointer, PFNGLVERTEXATTRIBPOINTERPROC)      \
+    X(Viewport, PFNGLVIEWPORTPROC)
+
+#define REC_REAL_DECL(name, type) static type real_##name;
+REC_FUNCS(REC_REAL_DECL)
+#undef REC_REAL_DECL
+
+#define REC_OP_NAME(name) #name,
+static const char *op_names[GLR_OP_COUNT] = {GL_RECORD_OPS(REC_OP_NAME)};
+#undef REC_OP_NAME
+
+const char *gl_record_op_name(int op)
+{
+    return op >= 0 && op < GLR_OP_COUNT ? op_names[op] : "?";
+}
+
+/* ===== Stan nagrania ===== */
+
+typedef struct RecMap
+{
+    GLenum target;
+    GLintptr offset;
+    GLsizeiptr length;
+    GLbitfield access;
+    void *ptr;
+} RecMap;
+
+typedef struct RecSync
+{
+    GLsync sync;
+    uint32_t id;
+} RecSync;
+
+static FILE *rec_file;
+static void *rec_io_buffer;
+
+static uint64_t *seen;      // hasze zapisanych blobów (0 = wolne miejsce)
+static size_t seen_cap, seen_count;
+
+static RecMap maps[REC_MAX_MAPS];
+static RecSync *syncs;
+static size_t sync_count, sync_cap;
+static uint32_t next_sync_id = 1;
+
+static GLint unpack_alignment = 4;
+static GLuint pack_buffer;
+
+/* statystyki */
+static unsigned long op_counts[GLR_OP_COUNT];
+static unsigned long frames;
+static uint64_t blob_bytes, blob_dedup_bytes, blob_dedup_hits;
+
+/* ===== Zapis ===== */
+
+static void w_bytes(const void *p, size_t n)
+{
+    fwrite(p, 1, n, rec_file);
+}
+
+static void w_u8(uint8_t v) { w_bytes(&v, 1); }
+static void w_u32(uint32_t v) { w_bytes(&v, 4); }
+static void w_i32(int32_t v) { w_bytes(&v, 4); }
+static void w_f32(float v) { w_bytes(&v, 4); }
+static void w_u64(uint64_t v) { w_bytes(&v, 8); }
+
+static void w_op(GlRecordOp op)
+{
+    op_counts[op]++;
+    w_u8((uint8_t)op);
+}
+
+static void w_str(const char *s)
+{
+    uint32_t n = s ? (uint32_t)strlen(s) : 0;
+    w_u32(n);
+    w_bytes(s, n);
+}
+
+static void w_names(GLsizei n, const GLuint *names)
+{
+    w_i32(n);
+    for (GLsizei i = 0; i < n; i++)
+        w_u32(names[i]);
+}
+
+/**
+ * @brief 64-bitowy hasz zawartości (8 bajtów na krok, mieszanie jak w splitmix64).
+ */
+static uint64_t hash_bytes(const void *data, size_t size)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ (uint64_t)size;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t k;
+        memcpy(&k, p + i, 8);
+        h = (h ^ k) * 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 31;
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, p + i, size - i);
+    h = (h ^ tail) * 0x94D049BB133111EBull;
+    h ^= h >> 29;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 32;
+    return h ? h : 1; // 0 zarezerwowane dla NULL
+}
+
+static int seen_insert(uint64_t h)
+{
+    if ((seen_count + 1) * 2 > seen_cap)
+    {
+        size_t cap = seen_cap ? seen_cap * 2 : 1024;
+        uint64_t *grown = (uint64_t *)calloc(cap, sizeof(uint64_t));
+        if (!grown)
+            return 1; // bez deduplikacji, blob zostanie zapisany ponownie
+        for (size_t i = 0; i < seen_cap; i++)
+        {
+            if (!seen[i])
+                continue;
+            size_t j = (size_t)seen[i] & (cap - 1);
+            while (grown[j])
+                j = (j + 1) & (cap - 1);
+            grown[j] = seen[i];
+        }
+        free(seen);
+        seen = grown;
+        seen_cap = cap;
+    }
+
+    size_t j = (size_t)h & (seen_cap - 1);
+    while (seen[j])
+    {
+        if (seen[j] == h)
+            return 0;
+        j = (j + 1) & (seen_cap - 1);
+    }
+    seen[j] = h;
+    seen_count++;
+    return 1;
+}
+
+/**
+ * @brief Zapisuje blob (jeśli nowy) i zwraca jego hasz (0 dla NULL).
+ */
+static uint64_t w_blob(const void *data, size_t size)
+{
+    if (!data)
+        return 0;
+    uint64_t h = hash_bytes(data, size);
+    if (seen_insert(h))
+    {
+        w_op(GLR_OP_BLOB);
+        w_u64(h);
+        w_u64((uint64_t)size);
+        w_bytes(data, size);
+        blob_bytes += size;
+    }
+    else
+    {
+        blob_dedup_hits++;
+        blob_dedup_bytes += size;
+    }
+    return h;
+}
+
+static uint32_t sync_id(GLsync sync)
+{
+    for (size_t i = 0; i < sync_count; i++)
+        if (syncs[i].sync == sync)
+            return syncs[i].id;
+    return 0;
+}
+
+/**
+ * @brief Rozmiar danych glTexImage* w pamięci klienta (z GL_UNPACK_ALIGNMENT).
+ */
+static size_t image_size(GLsizei w, GLsizei h, GLsizei d, GLenum format, GLenum type)
+{
+    size_t comps;
+    switch (format)
+    {
+    case GL_RED: case GL_RED_INTEGER: case GL_DEPTH_COMPONENT: comps = 1; break;
+    case GL_RG: case GL_RG_INTEGER: case GL_DEPTH_STENCIL: comps = 2; break;
+    case GL_RGB: case GL_BGR: case GL_RGB_INTEGER: comps = 3; break;
+    default: comps = 4; break;
+    }
+    size_t bytes;
+    switch (type)
+    {
+    case GL_UNSIGNED_BYTE: case GL_BYTE: bytes = 1; break;
+    case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT: bytes = 2; break;
+    case GL_UNSIGNED_INT_24_8: comps = 1; bytes = 4; break;
+    default: bytes = 4; break;
+    }
+    if (w <= 0 || h <= 0 || d <= 0)
+        return 0;
+    size_t row = (size_t)w * comps * bytes;
+    size_t a = (size_t)(unpack_alignment > 0 ? unpack_alignment : 1);
+    size_t stride = (row + a - 1) / a * a;
+    return stride * ((size_t)h * (size_t)d - 1) + row;
+}
+
+/* ===== Wrappery ===== */
+
+static void APIENTRY rec_ActiveTexture(GLenum texture)
+{
+    real_ActiveTexture(texture);
+    w_op(GLR_OP_ActiveTexture);
+    w_u32(texture);
+}
+
+static void APIENTRY rec_AttachShader(GLuint program, GLuint shader)
+{
+    real_AttachShader(program, shader);
+    w_op(GLR_OP_AttachShader);
+    w_u32(program);
+    w_u32(shader);
+}
+
+static void APIENTRY rec_BeginConditionalRender(GLuint id, GLenum mode)
+{
+    real_BeginConditionalRender(id, mode);
+    w_op(GLR_OP_BeginConditionalRender);
+    w_u32(id);
+    w_u32(mode);
+}
+
+static void APIENTRY rec_BeginQuery(GLenum target, GLuint id)
+{
+    real_BeginQuery(target, id);
+    w_op(GLR_OP_BeginQuery);
+    w_u32(target);
+    w_u32(id);
+}
+
+static void APIENTRY rec_BindBuffer(GLenum target, GLuint buffer)
+{
+    real_BindBuffer(target, buffer);
+    if (target == GL_PIXEL_PACK_BUFFER)
+        pack_buffer = buffer;
+    w_op(GLR_OP_BindBuffer);
+    w_u32(target);
+    w_u32(buffer);
+}
+
+static void APIENTRY rec_BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+    real_BindBufferRange(target, index, buffer, offset, size);
+    w_op(GLR_OP_BindBufferRange);
+    w_u32(target);
+    w_u32(index);
+    w_u32(buffer);
+    w_u64((uint64_t)offset);
+    w_u64((uint64_t)size);
+}
+
+static void APIENTRY rec_BindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    real_BindFramebuffer(target, framebuffer);
+    w_op(GLR_OP_BindFramebuffer);
+    w_u32(target);
+    w_u32(framebuffer);
+}
+
+static void APIENTRY rec_BindTexture(GLenum target, GLuint texture)
+{
+    real_BindTexture(target, texture);
+    w_op(GLR_OP_BindTexture);
+    w_u32(target);
+    w_u32(texture);
+}
+
+static void APIENTRY rec_BindVertexArray(GLuint array)
+{
+    real_BindVertexArray(array);
+    w_op(GLR_OP_BindVertexArray);
+    w_u32(array);
+}
+
+static void APIENTRY rec_BufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage)
+{
+    real_BufferData(target, size, data, usage);
+    uint64_t h = w_blob(data, (size_t)size);
+    w_op(GLR_OP_BufferData);
+    w_u32(target);
+    w_u64((uint64_t)size);
+    w_u64(h);
+    w_u32(usage);
+}
+
+static void APIENTRY rec_BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data)
+{
+    real_BufferSubData(target, offset, size, data);
+    uint64_t h = w_blob(data, (size_t)size);
+    w_op(GLR_OP_BufferSubData);
+    w_u32(target);
+    w_u64((uint64_t)offset);
+    w_u64((uint64_t)size);
+    w_u64(h);
+}
+
+static GLenum APIENTRY rec_CheckFramebufferStatus(GLenum target)
+{
+    GLenum r = real_CheckFramebufferStatus(target);
+    w_op(GLR_OP_CheckFramebufferStatus);
+    w_u32(target);
+    return r;
+}
+
+static void APIENTRY rec_Clear(GLbitfield mask)
+{
+    real_Clear(mask);
+    w_op(GLR_OP_Clear);
+    w_u32(mask);
+}
+
+static void APIENTRY rec_ClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a)
+{
+    real_ClearColor(r, g, b, a);
+    w_op(GLR_OP_ClearColor);
+    w_f32(r);
+    w_f32(g);
+    w_f32(b);
+    w_f32(a);
+}
+
+static GLenum APIENTRY rec_ClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+    GLenum r = real_ClientWaitSync(sync, flags, timeout);
+    w_op(GLR_OP_ClientWaitSync);
+    w_u32(sync_id(sync));
+    w_u32(flags);
+    w_u64(timeout);
+    return r;
+}
+
+static void APIENTRY rec_ColorMask(GLboolean r, GLboolean g, GLboolean b, GLboolean a)
+{
+    real_ColorMask(r, g, b, a);
+    w_op(GLR_OP_ColorMask);
+    w_u8(r);
+    w_u8(g);
+    w_u8(b);
+    w_u8(a);
+}
+
+static void APIENTRY rec_CompileShader(GLuint shader)
+{
+    real_CompileShader(shader);
+    w_op(GLR_OP_CompileShader);
+    w_u32(shader);
+}
+
+static GLuint APIENTRY rec_CreateProgram(void)
+{
+    GLuint r = real_CreateProgram();
+    w_op(GLR_OP_CreateProgram);
+    w_u32(r);
+    return r;
+}
+
+static GLuint APIENTRY rec_CreateShader(GLenum type)
+{
+    GLuint r = real_CreateShader(type);
+    w_op(GLR_OP_CreateShader);
+    w_u32(type);
+    w_u32(r);
+    return r;
+}
+
+static void APIENTRY rec_DeleteBuffers(GLsizei n, const GLuint *names)
+{
+    real_DeleteBuffers(n, names);
+    w_op(GLR_OP_DeleteBuffers);
+    w_names(n, names);
+}
+
+static void APIENTRY rec_DeleteFramebuffers(GLsizei n, const GLuint *names)
+{
+    real_DeleteFramebuffers(n, names);
+    w_op(GLR_OP_DeleteFramebuffers);
+    w_names(n, names);
+}
+
+static void APIENTRY rec_DeleteProgram(GLuint program)
+{
+    real_DeleteProgram(program);
+    w_op(GLR_OP_DeleteProgram);
+    w_u32(program);
+}
+
+static void APIENTRY rec_DeleteQueries(GLsizei n, const GLuint *names)
+{
+    real_DeleteQueries(n, names);
+    w_op(GLR_OP_DeleteQueries);
+    w_names(n, names);
+}
+
+static void APIENTRY rec_DeleteShader(GLuint shader)
+{
+    real_DeleteShader(shader);
+    w_op(GLR_OP_DeleteShader);
+    w_u32(shader);
+}
+
+static void APIENTRY rec_DeleteSync(GLsync sync)
+{
+    real_DeleteSync(sync);
+    w_op(GLR_OP_DeleteSync);
+    w_u32(sync_id(sync));
+    for (size_t i = 0; i < sync_count; i++)
+    {
+        if (syncs[i].sync == sync)
+        {
+            syncs[i] = syncs[--sync_count];
+            break;
+        }
+    }
+}
+
+static void APIENTRY rec_DeleteTextures(GLsizei n, const GLuint *names)
+{
+    real_DeleteTextures(n, names);
+    w_op(GLR_OP_DeleteTextures);
+    w_names(n, names);
+}
+
+static void APIENTRY rec_DeleteVertexArrays(GLsizei n, const GLuint *names)
+{
+    real_DeleteVertexArrays(n, names);
+    w_op(GLR_OP_DeleteVertexArrays);
+    w_names(n, names);
+}
+
+static void APIENTRY rec_DepthFunc(GLenum func)
+{
+    real_DepthFunc(func);
+    w_op(GLR_OP_DepthFunc);
+    w_u32(func);
+}
+
+static void APIENTRY rec_DepthMask(GLboolean flag)
+{
+    real_DepthMask(flag);
+    w_op(GLR_OP_DepthMask);
+    w_u8(flag);
+}
+
+static void APIENTRY rec_Disable(GLenum cap)
+{
+    real_Disable(cap);
+    w_op(GLR_OP_Disable);
+    w_u32(cap);
+}
+
+static void APIENTRY rec_DrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    real_DrawArrays(mode, first, count);
+    w_op(GLR_OP_DrawArrays);
+    w_u32(mode);
+    w_i32(first);
+    w_i32(count);
+}
+
+static void APIENTRY rec_DrawElements(GLenum mode, GLsizei count, GLenum type, const void *indices)
+{
+    real_DrawElements(mode, count, type, indices);
+    w_op(GLR_OP_DrawElements);
+    w_u32(mode);
+    w_i32(count);
+    w_u32(type);
+    w_u64((uint64_t)(uintptr_t)indices); // offset w GL_ELEMENT_ARRAY_BUFFER (core profile)
+}
+
+static void APIENTRY rec_Enable(GLenum cap)
+{
+    real_Enable(cap);
+    w_op(GLR_OP_Enable);
+    w_u32(cap);
+}
+
+static void APIENTRY rec_EnableVertexAttribArray(GLuint index)
+{
+    real_EnableVertexAttribArray(index);
+    w_op(GLR_OP_EnableVertexAttribArray);
+    w_u32(index);
+}
+
+static void APIENTRY rec_EndConditionalRender(void)
+{
+    real_EndConditionalRender();
+    w_op(GLR_OP_EndConditionalRender);
+}
+
+static void APIENTRY rec_EndQuery(GLenum target)
+{
+    real_EndQuery(target);
+    w_op(GLR_OP_EndQuery);
+    w_u32(target);
+}
+
+static GLsync APIENTRY rec_FenceSync(GLenum condition, GLbitfield flags)
+{
+    GLsync r = real_FenceSync(condition, flags);
+    uint32_t id = 0;
+    if (r)
+    {
+        if (sync_count == sync_cap)
+        {
+            size_t cap = sync_cap ? sync_cap * 2 : 16;
+            RecSync *grown = (RecSync *)realloc(syncs, cap * sizeof(RecSync));
+            if (grown)
+            {
+                syncs = grown;
+                sync_cap = cap;
+            }
+        }
+        if (sync_count < sync_cap)
+        {
+            id = next_sync_id++;
+            syncs[sync_count].sync = r;
+            syncs[sync_count].id = id;
+            sync_count++;
+        }
+    }
+    w_op(GLR_OP_FenceSync);
+    w_u32(condition);
+    w_u32(flags);
+    w_u32(id);
+    return r;
+}
+
+static void APIENTRY rec_Finish(void)
+{
+    real_Finish();
+    w_op(GLR_OP_Finish);
+}
+
+static void APIENTRY rec_FramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture,
+                                              GLint level)
+{
+    real_FramebufferTexture2D(target, attachment, textarget, texture, level);
+    w_op(GLR_OP_FramebufferTexture2D);
+    w_u32(target);
+    w_u32(attachment);
+    w_u32(textarget);
+    w_u32(texture);
+    w_i32(level);
+}
+
+static void APIENTRY rec_GenBuffers(GLsizei n, GLuint *names)
+{
+    real_GenBuffers(n, names);
+    w_op(GLR_OP_GenBuffers);
+    w_names(n, names);
+}
+
+static void APIENTRY rec_GenFramebuffers(GLsizei n, GLuint *names)
+{
+    real_GenFramebuffers(n, names);
+    w_op(GLR_OP_GenFramebuffers);
+    w_names(n, names);
+}
+
+static void APIENTRY rec_GenQueries(GLsizei n, GLuint *names)
+{
+    real_GenQueries(n, names);
+    w_op(GLR_OP_GenQueries);
+    w_names(n, names);
+}
+
+static void APIENTRY rec_GenTextures(GLsizei n, GLuint *names)
+{
+    real_GenTextures(n, names);
+    w_op(GLR_OP_GenTextures);
+    w_names(n, names);
+}
+
+static void APIENTRY rec_GenVertexArrays(GLsizei n, GLuint *names)
+{
+    real_GenVertexArrays(n, names);
+    w_op(GLR_OP_GenVertexArrays);
+    w_names(n, names);
+}
+
+static void APIENTRY rec_GenerateMipmap(GLenum target)
+{
+    real_GenerateMipmap(target);
+    w_op(GLR_OP_GenerateMipmap);
+    w_u32(target);
+}
+
+static GLenum APIENTRY rec_GetError(void)
+{
+    GLenum r = real_GetError();
+    w_op(GLR_OP_GetError);
+    return r;
+}
+
+static void APIENTRY rec_GetIntegerv(GLenum pname, GLint *data)
+{
+    real_GetIntegerv(pname, data);
+    w_op(GLR_OP_GetIntegerv);
+    w_u32(pname);
+}
+
+static void APIENTRY rec_GetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *log)
+{
+    real_GetProgramInfoLog(program, bufSize, length, log);
+    w_op(GLR_OP_GetProgramInfoLog);
+    w_u32(program);
+    w_i32(bufSize);
+}
+
+static void APIENTRY rec_GetProgramiv(GLuint program, GLenum pname, GLint *params)
+{
+    real_GetProgramiv(program, pname, params);
+    w_op(GLR_OP_GetProgramiv);
+    w_u32(program);
+    w_u32(pname);
+}
+
+static void APIENTRY rec_GetQueryObjectui64v(GLuint id, GLenum pname, GLuint64 *params)
+{
+    real_GetQueryObjectui64v(id, pname, params);
+    w_op(GLR_OP_GetQueryObjectui64v);
+    w_u32(id);
+    w_u32(pname);
+}
+
+static void APIENTRY rec_GetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *log)
+{
+    real_GetShaderInfoLog(shader, bufSize, length, log);
+    w_op(GLR_OP_GetShaderInfoLog);
+    w_u32(shader);
+    w_i32(bufSize);
+}
+
+static void APIENTRY rec_GetShaderiv(GLuint shader, GLenum pname, GLint *params)
+{
+    real_GetShaderiv(shader, pname, params);
+    w_op(GLR_OP_GetShaderiv);
+    w_u32(shader);
+    w_u32(pname);
+}
+
+static GLuint APIENTRY rec_GetUniformBlockIndex(GLuint program, const GLchar *name)
+{
+    GLuint r = real_GetUniformBlockIndex(program, name);
+    w_op(GLR_OP_GetUniformBlockIndex);
+    w_u32(program);
+    w_str(name);
+    w_u32(r);
+    return r;
+}
+
+static GLint APIENTRY rec_GetUniformLocation(GLuint program, const GLchar *name)
+{
+    GLint r = real_GetUniformLocation(program, name);
+    w_op(GLR_OP_GetUniformLocation);
+    w_u32(program);
+    w_str(name);
+    w_i32(r);
+    return r;
+}
+
+static void APIENTRY rec_LinkProgram(GLuint program)
+{
+    real_LinkProgram(program);
+    w_op(GLR_OP_LinkProgram);
+    w_u32(program);
+}
+
+static void *APIENTRY rec_MapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+    void *r = real_MapBufferRange(target, offset, length, access);
+    if (r)
+    {
+        for (int i = 0; i < REC_MAX_MAPS; i++)
+        {
+            if (!maps[i].ptr)
+            {
+                maps[i].target = target;
+                maps[i].offset = offset;
+                maps[i].length = length;
+                maps[i].access = access;
+                maps[i].ptr = r;
+                break;
+            }
+        }
+    }
+    w_op(GLR_OP_MapBufferRange);
+    w_u32(target);
+    w_u64((uint64_t)offset);
+    w_u64((uint64_t)length);
+    w_u32(access);
+    return r;
+}
+
+static GLboolean APIENTRY rec_UnmapBuffer(GLenum target)
+{
+    // zapisy aplikacji do zmapowanego zakresu trafiają do dziennika jako blob
+    uint64_t h = 0;
+    for (int i = 0; i < REC_MAX_MAPS; i++)
+    {
+        if (maps[i].ptr && maps[i].target == target)
+        {
+            if (maps[i].access & GL_MAP_WRITE_BIT)
+                h = w_blob(maps[i].ptr, (size_t)maps[i].length);
+            maps[i].ptr = NULL;
+            break;
+        }
+    }
+    GLboolean r = real_UnmapBuffer(target);
+    w_op(GLR_OP_UnmapBuffer);
+    w_u32(target);
+    w_u64(h);
+    return r;
+}
+
+static void APIENTRY rec_PixelStorei(GLenum pname, GLint param)
+{
+    real_PixelStorei(pname, param);
+    if (pname == GL_UNPACK_ALIGNMENT)
+        unpack_alignment = param;
+    w_op(GLR_OP_PixelStorei);
+    w_u32(pname);
+    w_i32(param);
+}
+
+static void APIENTRY rec_QueryCounter(GLuint id, GLenum target)
+{
+    real_QueryCounter(id, target);
+    w_op(GLR_OP_QueryCounter);
+    w_u32(id);
+    w_u32(target);
+}
+
+static void APIENTRY rec_ReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type,
+                                    void *pixels)
+{
+    real_ReadPixels(x, y, width, height, format, type, pixels);
+    w_op(GLR_OP_ReadPixels);
+    w_i32(x);
+    w_i32(y);
+    w_i32(width);
+    w_i32(height);
+    w_u32(format);
+    w_u32(type);
+    // do GL_PIXEL_PACK_BUFFER: offset; do pamięci: odtwarzanie czyta do bufora roboczego
+    w_u8(pack_buffer != 0);
+    w_u64(pack_buffer ? (uint64_t)(uintptr_t)pixels : 0);
+}
+
+static void APIENTRY rec_ShaderSource(GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length)
+{
+    real_ShaderSource(shader, count, string, length);
+
+    // części sklejone w jeden blob (odtwarzanie woła glShaderSource z count = 1)
+    size_t total = 0;
+    for (GLsizei i = 0; i < count; i++)
+        total += length && length[i] >= 0 ? (size_t)length[i] : strlen(string[i]);
+    char *joined = (char *)malloc(total + 1);
+    uint64_t h = 0;
+    if (joined)
+    {
+        size_t at = 0;
+        for (GLsizei i = 0; i < count; i++)
+        {
+            size_t n = length && length[i] >= 0 ? (size_t)length[i] : strlen(string[i]);
+            memcpy(joined + at, string[i], n);
+            at += n;
+        }
+        h = w_blob(joined, total);
+        free(joined);
+    }
+    w_op(GLR_OP_ShaderSource);
+    w_u32(shader);
+    w_u64(h);
+}
+
+static void APIENTRY rec_TexBuffer(GLenum target, GLenum internalformat, GLuint buffer)
+{
+    real_TexBuffer(target, internalformat, buffer);
+    w_op(GLR_OP_TexBuffer);
+    w_u32(target);
+    w_u32(internalformat);
+    w_u32(buffer);
+}
+
+static void APIENTRY rec_TexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+                                    GLint border, GLenum format, GLenum type, const void *pixels)
+{
+    real_TexImage2D(target, level, internalformat, width, height, border, format, type, pixels);
+    uint64_t h = w_blob(pixels, image_size(width, height, 1, format, type));
+    w_op(GLR_OP_TexImage2D);
+    w_u32(target);
+    w_i32(level);
+    w_i32(internalformat);
+    w_i32(width);
+    w_i32(height);
+    w_i32(border);
+    w_u32(format);
+    w_u32(type);
+    w_u64(h);
+}
+
+static void APIENTRY rec_TexImage3D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+                                    GLsizei depth, GLint border, GLenum format, GLenum type, const void *pixels)
+{
+    real_TexImage3D(target, level, internalformat, width, height, depth, border, format, type, pixels);
+    uint64_t h = w_blob(pixels, image_size(width, height, depth, format, type));
+    w_op(GLR_OP_TexImage3D);
+    w_u32(target);
+    w_i32(level);
+    w_i32(internalformat);
+    w_i32(width);
+    w_i32(height);
+    w_i32(depth);
+    w_i32(border);
+    w_u32(format);
+    w_u32(type);
+    w_u64(h);
+}
+
+static void APIENTRY rec_TexParameteri(GLenum target, GLenum pname, GLint param)
+{
+    real_TexParameteri(target, pname, param);
+    w_op(GLR_OP_TexParameteri);
+    w_u32(target);
+    w_u32(pname);
+    w_i32(param);
+}
+
+static void APIENTRY rec_Uniform1f(GLint location, GLfloat v0)
+{
+    real_Uniform1f(location, v0);
+    w_op(GLR_OP_Uniform1f);
+    w_i32(location);
+    w_f32(v0);
+}
+
+static void APIENTRY rec_Uniform1i(GLint location, GLint v0)
+{
+    real_Uniform1i(location, v0);
+    w_op(GLR_OP_Uniform1i);
+    w_i32(location);
+    w_i32(v0);
+}
+
+static void APIENTRY rec_Uniform2f(GLint location, GLfloat v0, GLfloat v1)
+{
+    real_Uniform2f(location, v0, v1);
+    w_op(GLR_OP_Uniform2f);
+    w_i32(location);
+    w_f32(v0);
+    w_f32(v1);
+}
+
+static void APIENTRY rec_Uniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2)
+{
+    real_Uniform3f(location, v0, v1, v2);
+    w_op(GLR_OP_Uniform3f);
+    w_i32(location);
+    w_f32(v0);
+    w_f32(v1);
+    w_f32(v2);
+}
+
+static void APIENTRY rec_Uniform3fv(GLint location, GLsizei count, const GLfloat *value)
+{
+    real_Uniform3fv(location, count, value);
+    w_op(GLR_OP_Uniform3fv);
+    w_i32(location);
+    w_i32(count);
+    w_bytes(value, (size_t)count * 3 * sizeof(float));
+}
+
+static void APIENTRY rec_Uniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)
+{
+    real_Uniform4f(location, v0, v1, v2, v3);
+    w_op(GLR_OP_Uniform4f);
+    w_i32(location);
+    w_f32(v0);
+    w_f32(v1);
+    w_f32(v2);
+    w_f32(v3);
+}
+
+static void APIENTRY rec_UniformBlockBinding(GLuint program, GLuint index, GLuint binding)
+{
+    real_UniformBlockBinding(program, index, binding);
+    w_op(GLR_OP_UniformBlockBinding);
+    w_u32(program);
+    w_u32(index);
+    w_u32(binding);
+}
+
+static void APIENTRY rec_UseProgram(GLuint program)
+{
+    real_UseProgram(program);
+    w_op(GLR_OP_UseProgram);
+    w_u32(program);
+}
+
+static void APIENTRY rec_VertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+                                             GLsizei stride, const void *pointer)
+{
+    real_VertexAttribPointer(index, size, type, normalized, stride, pointer);
+    w_op(GLR_OP_VertexAttribPointer);
+    w_u32(index);
+    w_i32(size);
+    w_u32(type);
+    w_u8(normalized);
+    w_i32(stride);
+    w_u64((uint64_t)(uintptr_t)pointer);
+}
+
+static void APIENTRY rec_Viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    real_Viewport(x, y, width, height);
+    w_op(GLR_OP_Viewport);
+    w_i32(x);
+    w_i32(y);
+    w_i32(width);
+    w_i32(height);
+}
+
+/* ===== API ===== */
+
+int gl_record_start(const char *path, int width, int height)
+{
+    if (rec_file)
+        return 1;
+
+    rec_file = fopen(path, "wb");
+    if (!rec_file)
+    {
+        printf("ERROR: cannot open %s for recording\n", path);
+        return 0;
+    }
+    rec_io_buffer = malloc(REC_IO_BUFFER);
+    if (rec_io_buffer)
+        setvbuf(rec_file, (char *)rec_io_buffer, _IOFBF, REC_IO_BUFFER);
+
+    GlRecordHeader h = {GL_RECORD_MAGIC, GL_RECORD_VERSION, (uint32_t)width, (uint32_t)height};
+    w_bytes(&h, sizeof(h));
+
+    GLint align = 4;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &align);
+    unpack_alignment = align;
+    GLint pack = 0;
+    glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &pack);
+    pack_buffer = (GLuint)pack;
+
+    memset(op_counts, 0, sizeof(op_counts));
+    frames = 0;
+    blob_bytes = blob_dedup_bytes = blob_dedup_hits = 0;
+
+#define REC_SWAP_IN(name, type)  \
+    real_##name = glad_gl##name; \
+    glad_gl##name = rec_##name;
+    REC_FUNCS(REC_SWAP_IN)
+#undef REC_SWAP_IN
+
+    printf("[record] recording GL commands to %s\n", path);
+    return 1;
+}
+
+void gl_record_frame(void)
+{
+    if (!rec_file)
+        return;
+    w_op(GLR_OP_FRAME);
+    frames++;
+}
+
+void gl_record_stop(void)
+{
+    if (!rec_file)
+        return;
+
+#define REC_SWAP_OUT(name, type) glad_gl##name = real_##name;
+    REC_FUNCS(REC_SWAP_OUT)
+#undef REC_SWAP_OUT
+
+    w_op(GLR_OP_END);
+    long size = ftell(rec_file);
+    fclose(rec_file);
+    rec_file = NULL;
+    free(rec_io_buffer);
+    rec_io_buffer = NULL;
+
+    unsigned long commands = 0;
+    for (int op = GLR_OP_ActiveTexture; op < GLR_OP_COUNT; op++)
+        commands += op_counts[op];
+    printf("[record] %lu frames, %lu commands, %.2f MB log | blobs %lu (%.2f MB), "
+           "%lu repeats deduplicated (%.2f MB saved)\n",
+           frames, commands, size / 1048576.0, op_counts[GLR_OP_BLOB], blob_bytes / 1048576.0,
+           (unsigned long)blob_dedup_hits, blob_dedup_bytes / 1048576.0);
+
+    free(seen);
+    seen = NULL;
+    seen_cap = seen_count = 0;
+    free(syncs);
+    syncs = NULL;
+    sync_count = sync_cap = 0;
+    next_sync_id = 1;
+    memset(maps, 0, sizeof(maps));
+}
@@ -0,0 +1,153 @@
+#pragma once
+#include <stdint.h>
+
+/**
+ * @brief Format dziennika poleceń GL (.glr).
+ *
+ * Nagłówek GlRecordHeader, potem rekordy: 1 bajt kodu GlRecordOp
+ * i argumenty w kolejności wywołania (liczby little-endian: u32/i32/f32,
+ * u64 dla offsetów, rozmiarów i haszy).
+ *
+ * Dane (bufory, tekstury, źródła shaderów, zapisy do zmapowanych
+ * buforów) nie są wpisywane w polecenie, tylko odwołują się do rekordu
+ * GLR_OP_BLOB przez 64-bitowy hasz zawartości. Blob jest zapisywany
+ * przy pierwszym wystąpieniu — powtarzające się dane (te same macierze
+ * co klatkę, ponowne wysłanie tekstury) kosztują 8 bajtów.
+ *
+ * Nazwy obiektów (bufory, tekstury, VAO, zapytania, framebuffery,
+ * programy, shadery, fence) są zapisywane tak, jak zwrócił je sterownik przy nagraniu;
+ * odtwarzanie mapuje je na własne. Lokalizacje uniformów i indeksy
+ * bloków są mapowane tak samo (nagrany wynik glGetUniformLocation ->
+ * wynik przy odtwarzaniu).
+ */
+
+#define GL_RECORD_MAGIC 0x31524C47u /* "GLR1" */
+#define GL_RECORD_VERSION 5u
+
+typedef struct GlRecordHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width;  // framebuffer przy starcie nagrania
+    uint32_t height;
+} GlRecordHeader;
+
+#define GL_RECORD_OPS(X)        \
+    X(BLOB)                     \
+    X(FRAME)                    \
+    X(END)                      \
+    X(ActiveTexture)            \
+    X(AttachShader)             \
+    X(BeginConditionalRender)   \
+    X(BeginQuery)               \
+    X(BindBuffer)               \
+    X(BindBufferRange)          \
+    X(BindFramebuffer)          \
+    X(BindTexture)              \
+    X(BindVertexArray)          \
+    X(BufferData)               \
+    X(BufferSubData)            \
+    X(CheckFramebufferStatus)   \
+    X(Clear)                    \
+    X(ClearColor)               \
+    X(ClientWaitSync)           \
+    X(ColorMask)                \
+    X(CompileShader)            \
+    X(CreateProgram)            \
+    X(CreateShader)             \
+    X(DeleteBuffers)            \
+    X(DeleteFramebuffers)       \
+    X(DeleteProgram)            \
+    X(DeleteQueries)            \
+    X(DeleteShader)             \
+    X(DeleteSync)               \
+    X(DeleteTextures)           \
+    X(DeleteVertexArrays)       \
+    X(DepthFunc)                \
+    X(DepthMask)                \
+    X(Disable)                  \
+    X(DrawArrays)               \
+    X(DrawElements)             \
+    X(Enable)                   \
+    X(EnableVertexAttribArray)  \
+    X(EndConditionalRender)     \
+    X(EndQuery)                 \
+    X(FenceSync)                \
+    X(Finish)                   \
+    X(FramebufferTexture2D)     \
+    X(GenBuffers)               \
+    X(GenFramebuffers)          \
+    X(GenQueries)               \
+    X(GenTextures)              \
+    X(GenVertexArrays)          \
+    X(GenerateMipmap)           \
+    X(GetError)                 \
+    X(GetIntegerv)              \
+    X(GetProgramInfoLog)        \
+    X(GetProgramiv)             \
+    X(GetQueryObjectui64v)      \
+    X(GetShaderInfoLog)         \
+    X(GetShaderiv)              \
+    X(GetUniformBlockIndex)     \
+    X(GetUniformLocation)       \
+    X(LinkProgram)              \
+    X(MapBufferRange)           \
+    X(PixelStorei)              \
+    X(QueryCounter)             \
+    X(ReadPixels)               \
+    X(ShaderSource)             \
+    X(TexBuffer)                \
+    X(TexImage2D)               \
+    X(TexImage3D)               \
+    X(TexParameteri)            \
+    X(Uniform1f)                \
+    X(Uniform1i)                \
+    X(Uniform2f)                \
+    X(Uniform3f)                \
+    X(Uniform3fv)               \
+    X(Uniform4f)                \
+    X(UniformBlockBinding)      \
+    X(UnmapBuffer)              \
+    X(UseProgram)               \
+    X(VertexAttribPointer)      \
+    X(Viewport)
+
+#define GL_RECORD_ENUM(name) GLR_OP_##name,
+typedef enum GlRecordOp
+{
+    GL_RECORD_OPS(GL_RECORD_ENUM)
+    GLR_OP_COUNT
+} GlRecordOp;
+#undef GL_RECORD_ENUM
+
+/**
+ * @brief Nazwa polecenia (statystyki odtwarzania).
+ */
+const char *gl_record_op_name(int op);
+
+/**
+ * @brief Zaczyna nagrywanie: podmienia wskaźniki glad na wersje zapisujące.
+ *
+ * Wołać po gladLoadGLLoader(), zanim powstaną pierwsze obiekty GL.
+ * Nagrywane są wszystkie wywołania przez glad (Mesh.c, Material.c,
+ * Shader.c, main.c i reszta viewera) z listy GL_RECORD_OPS.
+ *
+ * @note Zapisy przez trwale zmapowany bufor (glBufferStorage) są
+ *       niewidoczne — GpuRing trzeba utworzyć bez mapowania trwałego.
+ *
+ * @param path   Plik .glr.
+ * @param width  Rozmiar framebuffera (odtwarzanie tworzy taki sam).
+ * @param height
+ * @return 1 jeśli OK, 0 jeśli nie da się otworzyć pliku.
+ */
+int gl_record_start(const char *path, int width, int height);
+
+/**
+ * @brief Znacznik końca klatki (po glfwSwapBuffers).
+ */
+void gl_record_frame(void);
+
+/**
+ * @brief Przywraca wskaźniki glad, zamyka plik i wypisuje statystyki.
+ */
+void gl_record_stop(void);
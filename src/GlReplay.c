@@ -0,0 +1,993 @@
+#include "GlReplay.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#define REPLAY_TS_QUERIES 4 // znaczniki GL_TIMESTAMP w locie (odczyt z opóźnieniem, bez blokowania)
+#define REPLAY_MAX_MAPS 8
+
+/* ===== Odczyt ===== */
+
+typedef struct Reader
+{
+    const unsigned char *p;
+    const unsigned char *end;
+    int bad;
+} Reader;
+
+static const unsigned char *r_take(Reader *r, size_t n)
+{
+    if (r->bad || (size_t)(r->end - r->p) < n)
+    {
+        r->bad = 1;
+        return NULL;
+    }
+    const unsigned char *at = r->p;
+    r->p += n;
+    return at;
+}
+
+static uint8_t r_u8(Reader *r)
+{
+    const unsigned char *at = r_take(r, 1);
+    return at ? *at : 0;
+}
+
+static uint32_t r_u32(Reader *r)
+{
+    uint32_t v = 0;
+    const unsigned char *at = r_take(r, 4);
+    if (at)
+        memcpy(&v, at, 4);
+    return v;
+}
+
+static int32_t r_i32(Reader *r)
+{
+    return (int32_t)r_u32(r);
+}
+
+static float r_f32(Reader *r)
+{
+    uint32_t u = r_u32(r);
+    float f;
+    memcpy(&f, &u, 4);
+    return f;
+}
+
+static uint64_t r_u64(Reader *r)
+{
+    uint64_t v = 0;
+    const unsigned char *at = r_take(r, 8);
+    if (at)
+        memcpy(&v, at, 8);
+    return v;
+}
+
+/* ===== Mapy nagranych nazw ===== */
+
+/**
+ * @brief Nagrana nazwa -> nazwa przy odtwarzaniu (tablica indeksowana nazwą).
+ */
+typedef struct NameMap
+{
+    GLuint *names;
+    size_t cap;
+} NameMap;
+
+static void name_set(NameMap *m, uint32_t rec, GLuint name)
+{
+    if (rec >= m->cap)
+    {
+        size_t cap = m->cap ? m->cap : 256;
+        while (cap <= rec)
+            cap *= 2;
+        GLuint *grown = (GLuint *)realloc(m->names, cap * sizeof(GLuint));
+        if (!grown)
+            return;
+        memset(grown + m->cap, 0, (cap - m->cap) * sizeof(GLuint));
+        m->names = grown;
+        m->cap = cap;
+    }
+    m->names[rec] = name;
+}
+
+static GLuint name_get(const NameMap *m, uint32_t rec)
+{
+    return rec < m->cap ? m->names[rec] : 0;
+}
+
+/**
+ * @brief Klucz 64-bit (różny od 0) -> wartość (bloby, lokalizacje uniformów).
+ */
+typedef struct KeyMap
+{
+    uint64_t *keys; // 0 = wolne
+    uint64_t *values;
+    size_t cap, count;
+} KeyMap;
+
+static size_t key_slot(uint64_t key, size_t cap)
+{
+    uint64_t h = key * 0x9E3779B97F4A7C15ull;
+    return (size_t)(h >> 17) & (cap - 1);
+}
+
+static int key_put(KeyMap *m, uint64_t key, uint64_t value)
+{
+    if ((m->count + 1) * 2 > m->cap)
+    {
+        size_t cap = m->cap ? m->cap * 2 : 1024;
+        uint64_t *keys = (uint64_t *)calloc(cap, sizeof(uint64_t));
+        uint64_t *values = (uint64_t *)malloc(cap * sizeof(uint64_t));
+        if (!keys || !values)
+        {
+            free(keys);
+            free(values);
+            return 0;
+        }
+        for (size_t i = 0; i < m->cap; i++)
+        {
+            if (!m->keys[i])
+                continue;
+            size_t j = key_slot(m->keys[i], cap);
+            while (keys[j])
+                j = (j + 1) & (cap - 1);
+            keys[j] = m->keys[i];
+            values[j] = m->values[i];
+        }
+        free(m->keys);
+        free(m->values);
+        m->keys = keys;
+        m->values = values;
+        m->cap = cap;
+    }
+
+    size_t j = key_slot(key, m->cap);
+    while (m->keys[j] && m->keys[j] != key)
+        j = (j + 1) & (m->cap - 1);
+    if (!m->keys[j])
+        m->count++;
+    m->keys[j] = key;
+    m->values[j] = value;
+    return 1;
+}
+
+static int key_get(const KeyMap *m, uint64_t key, uint64_t *value)
+{
+    if (!m->cap)
+        return 0;
+    size_t j = key_slot(key, m->cap);
+    while (m->keys[j])
+    {
+        if (m->keys[j] == key)
+        {
+            *value = m->values[j];
+            return 1;
+        }
+        j = (j + 1) & (m->cap - 1);
+    }
+    return 0;
+}
+
+static void key_free(KeyMap *m)
+{
+    free(m->keys);
+    free(m->values);
+    memset(m, 0, sizeof(*m));
+}
+
+/* ===== Stan odtwarzania ===== */
+
+typedef struct Replay
+{
+    const unsigned char *base;
+
+    NameMap buffers, textures, vaos, queries, framebuffers;
+    NameMap programs; // programy i shadery mają wspólną przestrzeń nazw
+    GLsync *syncs;    // indeksowane nagranym id
+    size_t sync_cap;
+
+    KeyMap blobs;     // hasz -> offset rekordu BLOB (pole rozmiaru) w dzienniku
+    KeyMap locations; // (program << 32 | lokalizacja) -> lokalizacja
+    KeyMap blocks;    // (program << 32 | indeks bloku) -> indeks
+    uint32_t current_program; // nagrana nazwa
+
+    struct
+    {
+        GLenum target;
+        void *ptr;
+        GLsizeiptr length;
+    } maps[REPLAY_MAX_MAPS];
+
+    void *scratch;
+    size_t scratch_size;
+} Replay;
+
+static void *scratch(Replay *rp, size_t size)
+{
+    if (size > rp->scratch_size)
+    {
+        void *grown = realloc(rp->scratch, size);
+        if (!grown)
+            return NULL;
+        rp->scratch = grown;
+        rp->scratch_size = size;
+    }
+    return rp->scratch;
+}
+
+static const void *blob(const Replay *rp, uint64_t hash, size_t *size)
+{
+    uint64_t at = 0, n = 0;
+    if (!hash || !key_get(&rp->blobs, hash, &at))
+    {
+        if (size)
+            *size = 0;
+        return NULL;
+    }
+    memcpy(&n, rp->base + at, 8);
+    if (size)
+        *size = (size_t)n;
+    return rp->base + at + 8;
+}
+
+static GLint location(const Replay *rp, int32_t rec)
+{
+    if (rec < 0)
+        return rec;
+    uint64_t v;
+    if (key_get(&rp->locations, ((uint64_t)rp->current_program << 32) | (uint32_t)rec, &v))
+        return (GLint)(int32_t)v;
+    return -1;
+}
+
+static void sync_set(Replay *rp, uint32_t id, GLsync s)
+{
+    if (id >= rp->sync_cap)
+    {
+        size_t cap = rp->sync_cap ? rp->sync_cap : 64;
+        while (cap <= id)
+            cap *= 2;
+        GLsync *grown = (GLsync *)realloc(rp->syncs, cap * sizeof(GLsync));
+        if (!grown)
+            return;
+        memset(grown + rp->sync_cap, 0, (cap - rp->sync_cap) * sizeof(GLsync));
+        rp->syncs = grown;
+        rp->sync_cap = cap;
+    }
+    rp->syncs[id] = s;
+}
+
+static GLsync sync_get(const Replay *rp, uint32_t id)
+{
+    return id < rp->sync_cap ? rp->syncs[id] : NULL;
+}
+
+typedef void (APIENTRY *GenProc)(GLsizei, GLuint *);
+typedef void (APIENTRY *DeleteProc)(GLsizei, const GLuint *);
+
+static void replay_gen(Replay *rp, Reader *r, NameMap *m, GenProc gen)
+{
+    int32_t n = r_i32(r);
+    GLuint *names = n > 0 ? (GLuint *)scratch(rp, (size_t)n * sizeof(GLuint)) : NULL;
+    if (!names)
+    {
+        r->bad |= n != 0;
+        return;
+    }
+    gen(n, names);
+    for (int32_t i = 0; i < n; i++)
+        name_set(m, r_u32(r), names[i]);
+}
+
+static void replay_delete(Replay *rp, Reader *r, NameMap *m, DeleteProc del)
+{
+    int32_t n = r_i32(r);
+    GLuint *names = n > 0 ? (GLuint *)scratch(rp, (size_t)n * sizeof(GLuint)) : NULL;
+    if (!names)
+    {
+        r->bad |= n != 0;
+        return;
+    }
+    for (int32_t i = 0; i < n; i++)
+    {
+        uint32_t rec = r_u32(r);
+        names[i] = name_get(m, rec);
+        name_set(m, rec, 0);
+    }
+    del(n, names);
+}
+
+/**
+ * @brief Nazwa (string z dziennika) jako C-string w buforze roboczym.
+ */
+static const char *replay_str(Replay *rp, Reader *r)
+{
+    uint32_t n = r_u32(r);
+    const unsigned char *at = r_take(r, n);
+    char *s = (char *)scratch(rp, (size_t)n + 1);
+    if (!at || !s)
+        return NULL;
+    memcpy(s, at, n);
+    s[n] = '\0';
+    return s;
+}
+
+static double timer_ms(uint64_t ticks, double freq)
+{
+    return (double)ticks * 1000.0 / freq;
+}
+
+/* ===== Wykonanie ===== */
+
+/**
+ * @brief Wykonuje jedno polecenie (kod już odczytany).
+ */
+static void execute(Replay *rp, Reader *r, int op)
+{
+    switch (op)
+    {
+    case GLR_OP_BLOB:
+    {
+        uint64_t h = r_u64(r);
+        uint64_t at = (uint64_t)(r->p - rp->base);
+        uint64_t n = r_u64(r);
+        if (r_take(r, (size_t)n))
+            key_put(&rp->blobs, h, at);
+        break;
+    }
+    case GLR_OP_ActiveTexture:
+        glActiveTexture(r_u32(r));
+        break;
+    case GLR_OP_AttachShader:
+    {
+        GLuint program = name_get(&rp->programs, r_u32(r));
+        glAttachShader(program, name_get(&rp->programs, r_u32(r)));
+        break;
+    }
+    case GLR_OP_BeginConditionalRender:
+    {
+        GLuint id = name_get(&rp->queries, r_u32(r));
+        glBeginConditionalRender(id, r_u32(r));
+        break;
+    }
+    case GLR_OP_BeginQuery:
+    {
+        GLenum target = r_u32(r);
+        glBeginQuery(target, name_get(&rp->queries, r_u32(r)));
+        break;
+    }
+    case GLR_OP_BindBuffer:
+    {
+        GLenum target = r_u32(r);
+        glBindBuffer(target, name_get(&rp->buffers, r_u32(r)));
+        break;
+    }
+    case GLR_OP_BindBufferRange:
+    {
+        GLenum target = r_u32(r);
+        GLuint index = r_u32(r);
+        GLuint buffer = name_get(&rp->buffers, r_u32(r));
+        GLintptr offset = (GLintptr)r_u64(r);
+        glBindBufferRange(target, index, buffer, offset, (GLsizeiptr)r_u64(r));
+        break;
+    }
+    case GLR_OP_BindFramebuffer:
+    {
+        GLenum target = r_u32(r);
+        glBindFramebuffer(target, name_get(&rp->framebuffers, r_u32(r)));
+        break;
+    }
+    case GLR_OP_BindTexture:
+    {
+        GLenum target = r_u32(r);
+        glBindTexture(target, name_get(&rp->textures, r_u32(r)));
+        break;
+    }
+    case GLR_OP_BindVertexArray:
+        glBindVertexArray(name_get(&rp->vaos, r_u32(r)));
+        break;
+    case GLR_OP_BufferData:
+    {
+        GLenum target = r_u32(r);
+        GLsizeiptr size = (GLsizeiptr)r_u64(r);
+        const void *data = blob(rp, r_u64(r), NULL);
+        glBufferData(target, size, data, r_u32(r));
+        break;
+    }
+    case GLR_OP_BufferSubData:
+    {
+        GLenum target = r_u32(r);
+        GLintptr offset = (GLintptr)r_u64(r);
+        GLsizeiptr size = (GLsizeiptr)r_u64(r);
+        size_t have;
+        const void *data = blob(rp, r_u64(r), &have);
+        if (data && have >= (size_t)size)
+            glBufferSubData(target, offset, size, data);
+        break;
+    }
+    case GLR_OP_CheckFramebufferStatus:
+        glCheckFramebufferStatus(r_u32(r));
+        break;
+    case GLR_OP_Clear:
+        glClear(r_u32(r));
+        break;
+    case GLR_OP_ClearColor:
+    {
+        float c[4];
+        for (int i = 0; i < 4; i++)
+            c[i] = r_f32(r);
+        glClearColor(c[0], c[1], c[2], c[3]);
+        break;
+    }
+    case GLR_OP_ClientWaitSync:
+    {
+        GLsync s = sync_get(rp, r_u32(r));
+        GLbitfield flags = r_u32(r);
+        GLuint64 timeout = r_u64(r);
+        if (s)
+            glClientWaitSync(s, flags, timeout);
+        break;
+    }
+    case GLR_OP_ColorMask:
+    {
+        GLboolean c[4];
+        for (int i = 0; i < 4; i++)
+            c[i] = r_u8(r);
+        glColorMask(c[0], c[1], c[2], c[3]);
+        break;
+    }
+    case GLR_OP_CompileShader:
+        glCompileShader(name_get(&rp->programs, r_u32(r)));
+        break;
+    case GLR_OP_CreateProgram:
+        name_set(&rp->programs, r_u32(r), glCreateProgram());
+        break;
+    case GLR_OP_CreateShader:
+    {
+        GLenum type = r_u32(r);
+        name_set(&rp->programs, r_u32(r), glCreateShader(type));
+        break;
+    }
+    case GLR_OP_DeleteBuffers:
+        replay_delete(rp, r, &rp->buffers, glDeleteBuffers);
+        break;
+    case GLR_OP_DeleteFramebuffers:
+        replay_delete(rp, r, &rp->framebuffers, glDeleteFramebuffers);
+        break;
+    case GLR_OP_DeleteProgram:
+    {
+        uint32_t rec = r_u32(r);
+        glDeleteProgram(name_get(&rp->programs, rec));
+        name_set(&rp->programs, rec, 0);
+        break;
+    }
+    case GLR_OP_DeleteQueries:
+        replay_delete(rp, r, &rp->queries, glDeleteQueries);
+        break;
+    case GLR_OP_DeleteShader:
+    {
+        uint32_t rec = r_u32(r);
+        glDeleteShader(name_get(&rp->programs, rec));
+        name_set(&rp->programs, rec, 0);
+        break;
+    }
+    case GLR_OP_DeleteSync:
+    {
+        uint32_t id = r_u32(r);
+        GLsync s = sync_get(rp, id);
+        if (s)
+        {
+            glDeleteSync(s);
+            sync_set(rp, id, NULL);
+        }
+        break;
+    }
+    case GLR_OP_DeleteTextures:
+        replay_delete(rp, r, &rp->textures, glDeleteTextures);
+        break;
+    case GLR_OP_DeleteVertexArrays:
+        replay_delete(rp, r, &rp->vaos, glDeleteVertexArrays);
+        break;
+    case GLR_OP_DepthFunc:
+        glDepthFunc(r_u32(r));
+        break;
+    case GLR_OP_DepthMask:
+        glDepthMask(r_u8(r));
+        break;
+    case GLR_OP_Disable:
+        glDisable(r_u32(r));
+        break;
+    case GLR_OP_DrawArrays:
+    {
+        GLenum mode = r_u32(r);
+        GLint first = r_i32(r);
+        glDrawArrays(mode, first, r_i32(r));
+        break;
+    }
+    case GLR_OP_DrawElements:
+    {
+        GLenum mode = r_u32(r);
+        GLsizei count = r_i32(r);
+        GLenum type = r_u32(r);
+        glDrawElements(mode, count, type, (const void *)(uintptr_t)r_u64(r));
+        break;
+    }
+    case GLR_OP_Enable:
+        glEnable(r_u32(r));
+        break;
+    case GLR_OP_EnableVertexAttribArray:
+        glEnableVertexAttribArray(r_u32(r));
+        break;
+    case GLR_OP_EndConditionalRender:
+        glEndConditionalRender();
+        break;
+    case GLR_OP_EndQuery:
+        glEndQuery(r_u32(r));
+        break;
+    case GLR_OP_FenceSync:
+    {
+        GLenum condition = r_u32(r);
+        GLbitfield flags = r_u32(r);
+        uint32_t id = r_u32(r);
+        GLsync s = glFenceSync(condition, flags);
+        if (id)
+            sync_set(rp, id, s);
+        else
+            glDeleteSync(s);
+        break;
+    }
+    case GLR_OP_Finish:
+        glFinish();
+        break;
+    case GLR_OP_FramebufferTexture2D:
+    {
+        GLenum target = r_u32(r);
+        GLenum attachment = r_u32(r);
+        GLenum textarget = r_u32(r);
+        GLuint texture = name_get(&rp->textures, r_u32(r));
+        glFramebufferTexture2D(target, attachment, textarget, texture, r_i32(r));
+        break;
+    }
+    case GLR_OP_GenBuffers:
+        replay_gen(rp, r, &rp->buffers, glGenBuffers);
+        break;
+    case GLR_OP_GenFramebuffers:
+        replay_gen(rp, r, &rp->framebuffers, glGenFramebuffers);
+        break;
+    case GLR_OP_GenQueries:
+        replay_gen(rp, r, &rp->queries, glGenQueries);
+        break;
+    case GLR_OP_GenTextures:
+        replay_gen(rp, r, &rp->textures, glGenTextures);
+        break;
+    case GLR_OP_GenVertexArrays:
+        replay_gen(rp, r, &rp->vaos, glGenVertexArrays);
+        break;
+    case GLR_OP_GenerateMipmap:
+        glGenerateMipmap(r_u32(r));
+        break;
+    case GLR_OP_GetError:
+        glGetError();
+        break;
+    case GLR_OP_GetIntegerv:
+    {
+        GLint v[16]; // parametry wielowartościowe (np. GL_VIEWPORT)
+        glGetIntegerv(r_u32(r), v);
+        break;
+    }
+    case GLR_OP_GetProgramInfoLog:
+    case GLR_OP_GetShaderInfoLog:
+    {
+        GLuint name = name_get(&rp->programs, r_u32(r));
+        GLsizei bufSize = r_i32(r);
+        GLchar *log = bufSize > 0 ? (GLchar *)scratch(rp, (size_t)bufSize) : NULL;
+        if (!log)
+            break;
+        if (op == GLR_OP_GetProgramInfoLog)
+            glGetProgramInfoLog(name, bufSize, NULL, log);
+        else
+            glGetShaderInfoLog(name, bufSize, NULL, log);
+        break;
+    }
+    case GLR_OP_GetProgramiv:
+    {
+        GLint v;
+        GLuint program = name_get(&rp->programs, r_u32(r));
+        glGetProgramiv(program, r_u32(r), &v);
+        break;
+    }
+    case GLR_OP_GetShaderiv:
+    {
+        GLint v;
+        GLuint shader = name_get(&rp->programs, r_u32(r));
+        glGetShaderiv(shader, r_u32(r), &v);
+        break;
+    }
+    case GLR_OP_GetQueryObjectui64v:
+    {
+        GLuint64 v;
+        GLuint id = name_get(&rp->queries, r_u32(r));
+        glGetQueryObjectui64v(id, r_u32(r), &v);
+        break;
+    }
+    case GLR_OP_GetUniformBlockIndex:
+    case GLR_OP_GetUniformLocation:
+    {
+        uint32_t rec = r_u32(r);
+        const char *name = replay_str(rp, r);
+        uint32_t recorded = r_u32(r);
+        if (!name)
+            break;
+        uint64_t key = ((uint64_t)rec << 32) | recorded;
+        GLuint program = name_get(&rp->programs, rec);
+        if (op == GLR_OP_GetUniformLocation)
+            key_put(&rp->locations, key, (uint32_t)glGetUniformLocation(program, name));
+        else
+            key_put(&rp->blocks, key, glGetUniformBlockIndex(program, name));
+        break;
+    }
+    case GLR_OP_LinkProgram:
+        glLinkProgram(name_get(&rp->programs, r_u32(r)));
+        break;
+    case GLR_OP_MapBufferRange:
+    {
+        GLenum target = r_u32(r);
+        GLintptr offset = (GLintptr)r_u64(r);
+        GLsizeiptr length = (GLsizeiptr)r_u64(r);
+        void *ptr = glMapBufferRange(target, offset, length, r_u32(r));
+        for (int i = 0; ptr && i < REPLAY_MAX_MAPS; i++)
+        {
+            if (!rp->maps[i].ptr)
+            {
+                rp->maps[i].target = target;
+                rp->maps[i].ptr = ptr;
+                rp->maps[i].length = length;
+                break;
+            }
+        }
+        break;
+    }
+    case GLR_OP_UnmapBuffer:
+    {
+        GLenum target = r_u32(r);
+        size_t have;
+        const void *data = blob(rp, r_u64(r), &have);
+        for (int i = 0; i < REPLAY_MAX_MAPS; i++)
+        {
+            if (rp->maps[i].ptr && rp->maps[i].target == target)
+            {
+                if (data)
+                    memcpy(rp->maps[i].ptr, data,
+                           have < (size_t)rp->maps[i].length ? have : (size_t)rp->maps[i].length);
+                rp->maps[i].ptr = NULL;
+                glUnmapBuffer(target);
+                break;
+            }
+        }
+        break;
+    }
+    case GLR_OP_PixelStorei:
+    {
+        GLenum pname = r_u32(r);
+        glPixelStorei(pname, r_i32(r));
+        break;
+    }
+    case GLR_OP_QueryCounter:
+    {
+        GLuint id = name_get(&rp->queries, r_u32(r));
+        glQueryCounter(id, r_u32(r));
+        break;
+    }
+    case GLR_OP_ReadPixels:
+    {
+        GLint x = r_i32(r), y = r_i32(r);
+        GLsizei w = r_i32(r), h = r_i32(r);
+        GLenum format = r_u32(r), type = r_u32(r);
+        int to_buffer = r_u8(r);
+        uint64_t offset = r_u64(r);
+        void *dst = to_buffer ? (void *)(uintptr_t)offset
+                              : scratch(rp, (size_t)(w > 0 ? w : 1) * (size_t)(h > 0 ? h : 1) * 16 + 16);
+        if (dst || to_buffer)
+            glReadPixels(x, y, w, h, format, type, dst);
+        break;
+    }
+    case GLR_OP_ShaderSource:
+    {
+        GLuint shader = name_get(&rp->programs, r_u32(r));
+        size_t n;
+        const GLchar *src = (const GLchar *)blob(rp, r_u64(r), &n);
+        GLint len = (GLint)n;
+        if (src)
+            glShaderSource(shader, 1, &src, &len);
+        break;
+    }
+    case GLR_OP_TexBuffer:
+    {
+        GLenum target = r_u32(r);
+        GLenum format = r_u32(r);
+        glTexBuffer(target, format, name_get(&rp->buffers, r_u32(r)));
+        break;
+    }
+    case GLR_OP_TexImage2D:
+    {
+        GLenum target = r_u32(r);
+        GLint level = r_i32(r), ifmt = r_i32(r);
+        GLsizei w = r_i32(r), h = r_i32(r);
+        GLint border = r_i32(r);
+        GLenum format = r_u32(r), type = r_u32(r);
+        glTexImage2D(target, level, ifmt, w, h, border, format, type, blob(rp, r_u64(r), NULL));
+        break;
+    }
+    case GLR_OP_TexImage3D:
+    {
+        GLenum target = r_u32(r);
+        GLint level = r_i32(r), ifmt = r_i32(r);
+        GLsizei w = r_i32(r), h = r_i32(r), d = r_i32(r);
+        GLint border = r_i32(r);
+        GLenum format = r_u32(r), type = r_u32(r);
+        glTexImage3D(target, level, ifmt, w, h, d, border, format, type, blob(rp, r_u64(r), NULL));
+        break;
+    }
+    case GLR_OP_TexParameteri:
+    {
+        GLenum target = r_u32(r);
+        GLenum pname = r_u32(r);
+        glTexParameteri(target, pname, r_i32(r));
+        break;
+    }
+    case GLR_OP_Uniform1f:
+    {
+        GLint loc = location(rp, r_i32(r));
+        glUniform1f(loc, r_f32(r));
+        break;
+    }
+    case GLR_OP_Uniform1i:
+    {
+        GLint loc = location(rp, r_i32(r));
+        glUniform1i(loc, r_i32(r));
+        break;
+    }
+    case GLR_OP_Uniform2f:
+    {
+        GLint loc = location(rp, r_i32(r));
+        float a = r_f32(r);
+        glUniform2f(loc, a, r_f32(r));
+        break;
+    }
+    case GLR_OP_Uniform3f:
+    {
+        GLint loc = location(rp, r_i32(r));
+        float a = r_f32(r), b = r_f32(r);
+        glUniform3f(loc, a, b, r_f32(r));
+        break;
+    }
+    case GLR_OP_Uniform3fv:
+    {
+        GLint loc = location(rp, r_i32(r));
+        int32_t count = r_i32(r);
+        size_t bytes = count > 0 ? (size_t)count * 3 * sizeof(float) : 0;
+        const unsigned char *at = r_take(r, bytes);
+        float *v = bytes ? (float *)scratch(rp, bytes) : NULL; // dane w dzienniku nie są wyrównane
+        if (at && v)
+        {
+            memcpy(v, at, bytes);
+            glUniform3fv(loc, count, v);
+        }
+        break;
+    }
+    case GLR_OP_Uniform4f:
+    {
+        GLint loc = location(rp, r_i32(r));
+        float a = r_f32(r), b = r_f32(r), c = r_f32(r);
+        glUniform4f(loc, a, b, c, r_f32(r));
+        break;
+    }
+    case GLR_OP_UniformBlockBinding:
+    {
+        uint32_t rec = r_u32(r);
+        uint32_t index = r_u32(r);
+        GLuint binding = r_u32(r);
+        uint64_t v = index;
+        if (index != GL_INVALID_INDEX)
+            key_get(&rp->blocks, ((uint64_t)rec << 32) | index, &v);
+        glUniformBlockBinding(name_get(&rp->programs, rec), (GLuint)v, binding);
+        break;
+    }
+    case GLR_OP_UseProgram:
+        rp->current_program = r_u32(r);
+        glUseProgram(name_get(&rp->programs, rp->current_program));
+        break;
+    case GLR_OP_VertexAttribPointer:
+    {
+        GLuint index = r_u32(r);
+        GLint size = r_i32(r);
+        GLenum type = r_u32(r);
+        GLboolean normalized = r_u8(r);
+        GLsizei stride = r_i32(r);
+        glVertexAttribPointer(index, size, type, normalized, stride, (const void *)(uintptr_t)r_u64(r));
+        break;
+    }
+    case GLR_OP_Viewport:
+    {
+        GLint x = r_i32(r), y = r_i32(r);
+        GLsizei w = r_i32(r);
+        glViewport(x, y, w, r_i32(r));
+        break;
+    }
+    default:
+        r->bad = 1;
+        break;
+    }
+}
+
+/**
+ * @brief Odczytuje znaczniki GL_TIMESTAMP starszych klatek (czas GPU klatki).
+ */
+static void collect_timestamps(GLuint *queries, unsigned long issued, unsigned long *collected,
+                               GLuint64 *last, unsigned long max_pending, GlReplayStats *st)
+{
+    while (*collected < issued)
+    {
+        GLuint q = queries[*collected % REPLAY_TS_QUERIES];
+        // czekanie tylko gdy w locie jest więcej niż max_pending znaczników
+        if (issued - *collected <= max_pending)
+        {
+            GLint ready = 0;
+            glGetQueryObjectiv(q, GL_QUERY_RESULT_AVAILABLE, &ready);
+            if (!ready)
+                return;
+        }
+        GLuint64 ts = 0;
+        glGetQueryObjectui64v(q, GL_QUERY_RESULT, &ts);
+        if (*collected > 0)
+        {
+            double ms = (double)(ts - *last) / 1.0e6;
+            st->gpu_ms += ms;
+            if (ms > st->gpu_max_ms)
+                st->gpu_max_ms = ms;
+            st->gpu_frames++;
+        }
+        *last = ts;
+        (*collected)++;
+    }
+}
+
+int gl_replay_run(const unsigned char *data, size_t size, GlReplayStats *st)
+{
+    GlRecordHeader h;
+    if (size < sizeof(h))
+        return 0;
+    memcpy(&h, data, sizeof(h));
+    if (h.magic != GL_RECORD_MAGIC || h.version != GL_RECORD_VERSION)
+    {
+        printf("ERROR: not a GL command log (version %u expected)\n", GL_RECORD_VERSION);
+        return 0;
+    }
+
+    Replay rp;
+    memset(&rp, 0, sizeof(rp));
+    rp.base = data;
+    Reader r = {data + sizeof(h), data + size, 0};
+
+    GLuint ts_queries[REPLAY_TS_QUERIES];
+    glGenQueries(REPLAY_TS_QUERIES, ts_queries);
+    unsigned long ts_issued = 0, ts_collected = 0;
+    GLuint64 ts_last = 0;
+
+    double freq = (double)glfwGetTimerFrequency();
+    uint64_t start = glfwGetTimerValue();
+    uint64_t frame_start = start;
+    int in_setup = 1;
+    int done = 0;
+
+    while (!done && !r.bad)
+    {
+        int op = r_u8(&r);
+        if (r.bad)
+            break;
+
+        if (op == GLR_OP_END)
+        {
+            done = 1;
+        }
+        else if (op == GLR_OP_FRAME)
+        {
+            uint64_t now = glfwGetTimerValue();
+            if (in_setup)
+            {
+                st->setup_ms += timer_ms(now - frame_start, freq);
+                in_setup = 0;
+            }
+            else
+            {
+                double ms = timer_ms(now - frame_start, freq);
+                st->cpu_ms += ms;
+                if (ms > st->cpu_max_ms)
+                    st->cpu_max_ms = ms;
+                st->frames++;
+            }
+            collect_timestamps(ts_queries, ts_issued, &ts_collected, &ts_last, REPLAY_TS_QUERIES - 1, st);
+            glQueryCounter(ts_queries[ts_issued++ % REPLAY_TS_QUERIES], GL_TIMESTAMP);
+            frame_start = glfwGetTimerValue();
+        }
+        else if (op < GLR_OP_COUNT)
+        {
+            uint64_t t0 = glfwGetTimerValue();
+            execute(&rp, &r, op);
+            st->ms[op] += timer_ms(glfwGetTimerValue() - t0, freq);
+            st->counts[op]++;
+        }
+        else
+        {
+            r.bad = 1;
+        }
+    }
+
+    glFinish();
+    collect_timestamps(ts_queries, ts_issued, &ts_collected, &ts_last, 0, st);
+    glDeleteQueries(REPLAY_TS_QUERIES, ts_queries);
+    st->total_ms += timer_ms(glfwGetTimerValue() - start, freq);
+
+    if (r.bad || !done)
+        printf("ERROR: GL command log is truncated or corrupt at byte %zu\n", (size_t)(r.p - data));
+
+    free(rp.buffers.names);
+    free(rp.textures.names);
+    free(rp.vaos.names);
+    free(rp.queries.names);
+    free(rp.framebuffers.names);
+    free(rp.programs.names);
+    for (size_t i = 0; i < rp.sync_cap; i++)
+        if (rp.syncs[i])
+            glDeleteSync(rp.syncs[i]);
+    free(rp.syncs);
+    key_free(&rp.blobs);
+    key_free(&rp.locations);
+    key_free(&rp.blocks);
+    free(rp.scratch);
+    return !r.bad && done;
+}
+
+static const GlReplayStats *sort_stats;
+
+static int cmp_op_ms(const void *a, const void *b)
+{
+    double x = sort_stats->ms[*(const int *)a], y = sort_stats->ms[*(const int *)b];
+    return (x < y) - (x > y);
+}
+
+void gl_replay_print_stats(const GlReplayStats *st)
+{
+    double frames = st->frames ? (double)st->frames : 1.0;
+    double gpu_frames = st->gpu_frames ? (double)st->gpu_frames : 1.0;
+    printf("[replay] total %.2f ms, setup %.2f ms, %lu frames | CPU %.3f ms/frame (max %.3f), "
+           "GPU %.3f ms/frame (max %.3f)\n",
+           st->total_ms, st->setup_ms, st->frames, st->cpu_ms / frames, st->cpu_max_ms,
+           st->gpu_ms / gpu_frames, st->gpu_max_ms);
+
+    int order[GLR_OP_COUNT];
+    int n = 0;
+    double sum = 0.0;
+    for (int op = 0; op < GLR_OP_COUNT; op++)
+    {
+        if (st->counts[op])
+        {
+            order[n++] = op;
+            sum += st->ms[op];
+        }
+    }
+    sort_stats = st;
+    qsort(order, (size_t)n, sizeof(int), cmp_op_ms);
+
+    printf("  %-24s %10s %12s %10s %7s\n", "command", "count", "total ms", "avg us", "share");
+    for (int i = 0; i < n; i++)
+    {
+        int op = order[i];
+        printf("  %-24s %10lu %12.3f %10.3f %6.1f%%\n", gl_record_op_name(op), st->counts[op], st->ms[op],
+               st->ms[op] * 1000.0 / (double)st->counts[op], sum > 0.0 ? st->ms[op] * 100.0 / sum : 0.0);
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <stddef.h>
+#include "GlRecord.h"
+
+/**
+ * @brief Wynik odtworzenia dziennika .glr.
+ *
+ * Czasy poleceń to czas CPU w wywołaniu GL (sterownik), liczony osobno
+ * dla każdego kodu GlRecordOp. Czas klatki GPU to różnica znaczników
+ * GL_TIMESTAMP stawianych na rekordach GLR_OP_FRAME.
+ */
+typedef struct GlReplayStats
+{
+    unsigned long counts[GLR_OP_COUNT];
+    double ms[GLR_OP_COUNT];
+
+    double setup_ms;     // CPU: do pierwszego znacznika klatki (ładowanie + pierwsza klatka)
+    unsigned long frames;
+    double cpu_ms;       // CPU: suma czasów klatek (od FRAME do FRAME)
+    double cpu_max_ms;
+    double gpu_ms;       // GPU: suma czasów klatek z GL_TIMESTAMP
+    double gpu_max_ms;
+    unsigned long gpu_frames;
+    double total_ms;
+} GlReplayStats;
+
+/**
+ * @brief Odtwarza dziennik w bieżącym kontekście GL (jak najszybciej, bez swapów).
+ *
+ * Dziennik jest samowystarczalny (nagranie obejmuje tworzenie i usuwanie
+ * obiektów), więc można go odtwarzać wielokrotnie w tym samym kontekście.
+ * Dane blobów są czytane wprost z pamięci dziennika (bez kopii).
+ *
+ * @param data Zawartość pliku .glr.
+ * @param size Rozmiar.
+ * @param st   Statystyki (dopisywane — zerować przed pierwszym przebiegiem).
+ * @return 1 jeśli OK, 0 jeśli dziennik jest uszkodzony.
+ */
+int gl_replay_run(const unsigned char *data, size_t size, GlReplayStats *st);
+
+/**
+ * @brief Wypisuje czasy klatek i tabelę czasów według typu polecenia.
+ */
+void gl_replay_print_stats(const GlReplayStats *st);
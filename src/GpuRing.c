@@ -0,0 +1,272 @@
+#include "GpuRing.h"
+#include <stdio.h>
+#include <string.h>
+#include <GLFW/glfw3.h>
+
+/* GL_ARB_buffer_storage — brak w wygenerowanym glad (tylko GL 3.3 core) */
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+typedef void (APIENTRY *BufferStorageProc)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+
+static double ring_now(void)
+{
+    return (double)glfwGetTimerValue() / (double)glfwGetTimerFrequency();
+}
+
+/**
+ * @brief glBufferStorage z GL 4.4 albo z rozszerzenia (NULL jeśli brak).
+ */
+static BufferStorageProc load_buffer_storage(void)
+{
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    int core44 = major > 4 || (major == 4 && minor >= 4);
+
+    if (!core44 && !glfwExtensionSupported("GL_ARB_buffer_storage"))
+        return NULL;
+    return (BufferStorageProc)glfwGetProcAddress("glBufferStorage");
+}
+
+/**
+ * @brief Czeka na wszystkie fence (GPU skończył czytać każdy segment).
+ */
+static void wait_all(GpuRing *r)
+{
+    for (int i = 0; i < GPU_RING_FRAMES; i++)
+    {
+        if (r->fences[i])
+        {
+            glClientWaitSync(r->fences[i], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+            glDeleteSync(r->fences[i]);
+            r->fences[i] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Usuwa bufor (bez czekania na GPU).
+ */
+static void release(GpuRing *r)
+{
+    if (r->buffer)
+    {
+        if (r->persistent)
+        {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, r->buffer);
+            glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        }
+        glDeleteBuffers(1, &r->buffer);
+    }
+    r->buffer = 0;
+    r->mapped = NULL;
+    r->persistent = 0;
+}
+
+/**
+ * @brief Tworzy bufor GPU_RING_FRAMES * segment_size (trwale mapowany, jeśli się da).
+ *
+ * @return 1 jeśli OK, 0 jeśli błąd (bufor usunięty).
+ */
+static int allocate(GpuRing *r, GLsizeiptr segment_size)
+{
+    while (glGetError() != GL_NO_ERROR) {}
+
+    r->segment_size = segment_size & ~(GLsizeiptr)255;
+    r->size = r->segment_size * GPU_RING_FRAMES;
+
+    glGenBuffers(1, &r->buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, r->buffer);
+
+    BufferStorageProc bufferStorage = r->allow_persistent ? load_buffer_storage() : NULL;
+    if (bufferStorage)
+    {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        bufferStorage(GL_COPY_WRITE_BUFFER, r->size, NULL, flags);
+        r->mapped = (unsigned char *)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, r->size, flags);
+        r->persistent = r->mapped != NULL;
+        if (!r->persistent)
+        {
+            // bufor z glBufferStorage jest niezmienny -> nowy dla ścieżki zapasowej
+            glDeleteBuffers(1, &r->buffer);
+            glGenBuffers(1, &r->buffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, r->buffer);
+        }
+    }
+    if (!r->persistent)
+        glBufferData(GL_COPY_WRITE_BUFFER, r->size, NULL, GL_STREAM_DRAW);
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    if (glGetError() != GL_NO_ERROR)
+    {
+        release(r);
+        r->segment_size = r->size = 0;
+        return 0;
+    }
+    return 1;
+}
+
+int gpu_ring_init(GpuRing *r, GLsizeiptr size, int allow_persistent)
+{
+    memset(r, 0, sizeof(*r));
+    r->allow_persistent = allow_persistent;
+    r->segment = GPU_RING_FRAMES - 1; // pierwsze begin_frame -> segment 0
+
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &r->ubo_align);
+    if (r->ubo_align < 16)
+        r->ubo_align = 16;
+
+    if (!allocate(r, size / GPU_RING_FRAMES))
+    {
+        printf("ERROR: ring buffer allocation failed\n");
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Nowy, większy bufor po przepełnieniu (GPU musi skończyć ze starym).
+ */
+static void grow(GpuRing *r)
+{
+    GLsizeiptr old = r->segment_size;
+    GLsizeiptr next = old;
+    while (next > 0 && next < r->grow_to && next < GPU_RING_MAX_SEGMENT)
+        next *= 2;
+    if (next > GPU_RING_MAX_SEGMENT)
+        next = GPU_RING_MAX_SEGMENT;
+    r->grow_to = 0;
+    if (next <= old)
+        return;
+
+    double t0 = ring_now();
+    wait_all(r);
+    release(r);
+    if (allocate(r, next))
+    {
+        r->grows++;
+        printf("[ring] segment grown to %.1f KB after overflow\n", (double)r->segment_size / 1024.0);
+    }
+    else if (!allocate(r, old))
+        printf("ERROR: ring buffer reallocation failed\n");
+    r->wait_seconds += ring_now() - t0;
+}
+
+void gpu_ring_begin_frame(GpuRing *r)
+{
+    if (r->grow_to > r->segment_size)
+        grow(r);
+
+    r->segment = (r->segment + 1) % GPU_RING_FRAMES;
+    r->head = 0;
+    r->rejected = 0;
+
+    GLsync fence = r->fences[r->segment];
+    if (!fence)
+        return;
+
+    double t0 = ring_now();
+    GLenum s = glClientWaitSync(fence, 0, 0);
+    if (s == GL_TIMEOUT_EXPIRED)
+    {
+        // GPU jest GPU_RING_FRAMES klatek z tyłu: czekamy (z flush)
+        r->stalls++;
+        do
+            s = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+        while (s == GL_TIMEOUT_EXPIRED);
+    }
+    glDeleteSync(fence);
+    r->fences[r->segment] = 0;
+    r->wait_seconds += ring_now() - t0;
+}
+
+void gpu_ring_end_frame(GpuRing *r)
+{
+    r->fences[r->segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    r->frames++;
+    r->bytes_total += (double)r->head;
+    if (r->head > r->frame_peak)
+        r->frame_peak = r->head;
+    // bez wyrównań odrzuconych zapisów; grow() i tak zaokrągla w górę do potęgi 2
+    if (r->rejected > 0 && r->head + r->rejected > r->grow_to)
+        r->grow_to = r->head + r->rejected;
+}
+
+GLintptr gpu_ring_write(GpuRing *r, const void *data, GLsizeiptr size, GLsizeiptr align)
+{
+    GLsizeiptr start = (r->head + align - 1) & ~(align - 1);
+    if (size <= 0)
+        return -1;
+    if (start + size > r->segment_size)
+    {
+        r->overflows++;
+        r->rejected += size + align;
+        return -1;
+    }
+
+    double t0 = ring_now();
+    GLintptr offset = r->segment * r->segment_size + start;
+
+    if (r->persistent)
+    {
+        memcpy(r->mapped + offset, data, (size_t)size);
+    }
+    else
+    {
+        // fence segmentu gwarantuje, że GPU nie czyta tego zakresu
+        glBindBuffer(GL_COPY_WRITE_BUFFER, r->buffer);
+        void *dst = glMapBufferRange(GL_COPY_WRITE_BUFFER, offset, size,
+                                     GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT |
+                                         GL_MAP_INVALIDATE_RANGE_BIT);
+        if (dst)
+        {
+            memcpy(dst, data, (size_t)size);
+            glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        if (!dst)
+        {
+            r->overflows++;
+            r->update_seconds += ring_now() - t0;
+            return -1;
+        }
+    }
+
+    r->head = start + size;
+    r->update_seconds += ring_now() - t0;
+    return offset;
+}
+
+int gpu_ring_bind_uniform(GpuRing *r, GLuint binding, const void *data, GLsizeiptr size)
+{
+    GLintptr offset = gpu_ring_write(r, data, size, r->ubo_align);
+    if (offset < 0)
+        return 0;
+    glBindBufferRange(GL_UNIFORM_BUFFER, binding, r->buffer, offset, size);
+    return 1;
+}
+
+void gpu_ring_print_stats(const GpuRing *r)
+{
+    double frames = r->frames ? (double)r->frames : 1.0;
+    printf("[ring] %s, %.1f KB/segment | %.2f KB/frame avg, peak %.2f KB | "
+           "update CPU %.2f us/frame | fence wait %.2f us/frame, stalls %lu, overflows %lu, grows %lu\n",
+           r->persistent ? "persistent (buffer_storage)" : "map unsynchronized",
+           (double)r->segment_size / 1024.0,
+           r->bytes_total / frames / 1024.0, (double)r->frame_peak / 1024.0,
+           r->update_seconds / frames * 1.0e6,
+           r->wait_seconds / frames * 1.0e6, r->stalls, r->overflows, r->grows);
+}
+
+void gpu_ring_destroy(GpuRing *r)
+{
+    wait_all(r);
+    release(r);
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <stddef.h>
+#include <glad/glad.h>
+
+#define GPU_RING_FRAMES 3 // klatki "w locie" (każda ma własny segment i fence)
+#define GPU_RING_MAX_SEGMENT ((GLsizeiptr)64 << 20) // granica powiększania segmentu
+
+/**
+ * @brief Pierścieniowy bufor GPU na dane zmieniane co klatkę.
+ *
+ * Jeden duży bufor podzielony na GPU_RING_FRAMES segmentów. Klatka pisze
+ * tylko do swojego segmentu; przed ponownym użyciem segmentu czekamy na
+ * fence klatki, która go ostatnio czytała — sterownik nie musi niczego
+ * kopiować ani synchronizować (brak glBufferData/glBufferSubData).
+ *
+ * Zapis:
+ *  - GL_ARB_buffer_storage (lub GL 4.4): mapowanie trwałe i koherentne,
+ *    zapis to zwykły memcpy,
+ *  - w przeciwnym razie: glMapBufferRange z GL_MAP_UNSYNCHRONIZED_BIT.
+ *
+ * Ten sam bufor służy jako UBO (macierze), VBO (geometria debug)
+ * i bufor danych instancji.
+ *
+ * Zapis, który nie mieści się w segmencie, jest odrzucany (wołający
+ * pomija rysowanie); na początku następnej klatki bufor jest tworzony
+ * od nowa z segmentem mieszczącym całe zapotrzebowanie tamtej klatki
+ * (do GPU_RING_MAX_SEGMENT). Nazwa bufora może się wtedy zmienić.
+ */
+typedef struct GpuRing
+{
+    GLuint buffer;
+    GLsizeiptr size;
+    GLsizeiptr segment_size;
+    int persistent;          // 1 = mapowanie trwałe
+    int allow_persistent;    // z gpu_ring_init (ponowna alokacja tą samą ścieżką)
+    unsigned char *mapped;   // tylko persistent
+
+    GLsync fences[GPU_RING_FRAMES];
+    int segment;             // bieżący segment
+    GLsizeiptr head;         // zajęte bajty w bieżącym segmencie
+    GLsizeiptr rejected;     // bajty odrzucone w bieżącej klatce
+    GLsizeiptr grow_to;      // > segment_size -> nowy bufor w następnym begin_frame
+    GLint ubo_align;         // GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+
+    /* statystyki */
+    unsigned long frames;
+    double bytes_total;
+    double update_seconds;   // CPU: mapowanie + kopiowanie
+    double wait_seconds;     // CPU: czekanie na fence
+    unsigned long stalls;    // ile razy fence nie był jeszcze gotowy
+    unsigned long overflows; // zapisy odrzucone (segment pełny)
+    unsigned long grows;     // ponowne alokacje po przepełnieniu
+    GLsizeiptr frame_peak;   // maksymalne zużycie segmentu
+} GpuRing;
+
+/**
+ * @brief Tworzy bufor i (jeśli się da) mapuje go trwale.
+ *
+ * @param r                Pierścień.
+ * @param size             Rozmiar całkowity (dzielony na segmenty).
+ * @param allow_persistent 0 wymusza ścieżkę glMapBufferRange (porównania).
+ * @return 1 jeśli OK, 0 jeśli błąd.
+ */
+int gpu_ring_init(GpuRing *r, GLsizeiptr size, int allow_persistent);
+
+/**
+ * @brief Początek klatki: przejście do następnego segmentu (czeka na jego fence).
+ *
+ * Po przepełnieniu w poprzedniej klatce czeka na wszystkie segmenty
+ * i alokuje większy bufor.
+ */
+void gpu_ring_begin_frame(GpuRing *r);
+
+/**
+ * @brief Koniec klatki: fence za ostatnim poleceniem czytającym segment.
+ *
+ * Zapisuje zapotrzebowanie klatki, jeśli część zapisów została odrzucona.
+ */
+void gpu_ring_end_frame(GpuRing *r);
+
+/**
+ * @brief Kopiuje dane do bieżącego segmentu.
+ *
+ * @param r     Pierścień.
+ * @param data  Dane.
+ * @param size  Rozmiar w bajtach.
+ * @param align Wyrównanie offsetu (potęga 2).
+ * @return Offset w r->buffer lub -1 jeśli segment jest pełny (dane nie trafiły do GPU).
+ */
+GLintptr gpu_ring_write(GpuRing *r, const void *data, GLsizeiptr size, GLsizeiptr align);
+
+/**
+ * @brief Zapisuje blok uniformów i podpina go (glBindBufferRange).
+ *
+ * @param r       Pierścień.
+ * @param binding Punkt wiązania GL_UNIFORM_BUFFER.
+ * @param data    Dane w układzie std140.
+ * @param size    Rozmiar w bajtach.
+ * @return 1 jeśli OK, 0 jeśli segment jest pełny.
+ */
+int gpu_ring_bind_uniform(GpuRing *r, GLuint binding, const void *data, GLsizeiptr size);
+
+/**
+ * @brief Wypisuje koszt aktualizacji buforów (CPU) i zużycie.
+ */
+void gpu_ring_print_stats(const GpuRing *r);
+
+/**
+ * @brief Czeka na GPU i usuwa bufor.
+ */
+void gpu_ring_destroy(GpuRing *r);
@@ -0,0 +1,510 @@
+#include "HotReload.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <GLFW/glfw3.h>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#define HOT_RELOAD_INOTIFY 1
+#elif defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// indeksy plików w FileWatch
+#define WATCH_OBJ 0
+#define WATCH_MTL 1
+#define WATCH_TEX 2
+
+#define WATCH_POLL_MS 200
+#define WATCH_SETTLE_MS 150 // cisza po ostatniej zmianie, zanim zaczniemy parsować
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+}
+
+static void sleep_ms(int ms)
+{
+#ifdef _WIN32
+    Sleep((DWORD)ms);
+#else
+    usleep((useconds_t)ms * 1000);
+#endif
+}
+
+static time_t file_mtime(const char *path)
+{
+    struct stat st;
+    return stat(path, &st) == 0 ? st.st_mtime : 0;
+}
+
+/* =========================================================
+   Obserwacja plików
+   ========================================================= */
+
+static const char *base_name(const char *path)
+{
+    const char *s = strrchr(path, '/');
+#ifdef _WIN32
+    const char *b = strrchr(path, '\\');
+    if (b && (!s || b > s))
+        s = b;
+#endif
+    return s ? s + 1 : path;
+}
+
+/**
+ * @brief Otwiera obserwację; puste ścieżki są pomijane (slot zostaje).
+ */
+static void watch_open(FileWatch *w, const char *paths[], int count)
+{
+    memset(w, 0, sizeof(*w));
+    w->fd = -1;
+    w->count = count;
+    for (int i = 0; i < count; i++)
+    {
+        snprintf(w->path[i], sizeof(w->path[i]), "%s", paths[i] ? paths[i] : "");
+        w->mtime[i] = w->path[i][0] ? file_mtime(w->path[i]) : 0;
+        w->wd[i] = -1;
+    }
+
+#ifdef HOT_RELOAD_INOTIFY
+    w->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (w->fd < 0)
+    {
+        printf("[reload] inotify unavailable, polling file times\n");
+        return;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        if (!w->path[i][0])
+            continue;
+        char dir[1024];
+        const char *name = base_name(w->path[i]);
+        size_t len = (size_t)(name - w->path[i]);
+        if (len == 0)
+            strcpy(dir, ".");
+        else
+            snprintf(dir, sizeof(dir), "%.*s", (int)len, w->path[i]);
+
+        // ten sam katalog -> ten sam wd
+        w->wd[i] = inotify_add_watch(w->fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    }
+#endif
+}
+
+static void watch_close(FileWatch *w)
+{
+#ifdef HOT_RELOAD_INOTIFY
+    if (w->fd >= 0)
+        close(w->fd);
+#endif
+    w->fd = -1;
+}
+
+/**
+ * @brief Czeka do timeout_ms na zmiany.
+ *
+ * @return Maska bitowa zmienionych plików (bit i = path[i]).
+ */
+static unsigned watch_poll(FileWatch *w, int timeout_ms)
+{
+    unsigned changed = 0;
+
+#ifdef HOT_RELOAD_INOTIFY
+    if (w->fd >= 0)
+    {
+        struct pollfd pfd = {w->fd, POLLIN, 0};
+        if (poll(&pfd, 1, timeout_ms) <= 0)
+            return 0;
+
+        char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+        ssize_t len;
+        while ((len = read(w->fd, buf, sizeof(buf))) > 0)
+        {
+            for (char *p = buf; p < buf + len;)
+            {
+                const struct inotify_event *ev = (const struct inotify_event *)p;
+                for (int i = 0; ev->len > 0 && i < w->count; i++)
+                    if (w->wd[i] == ev->wd && strcmp(ev->name, base_name(w->path[i])) == 0)
+                        changed |= 1u << i;
+                p += sizeof(struct inotify_event) + ev->len;
+            }
+        }
+        return changed;
+    }
+#endif
+
+    // bez inotify: porównanie czasów modyfikacji
+    sleep_ms(timeout_ms);
+    for (int i = 0; i < w->count; i++)
+    {
+        if (!w->path[i][0])
+            continue;
+        time_t t = file_mtime(w->path[i]);
+        if (t != w->mtime[i])
+        {
+            w->mtime[i] = t;
+            changed |= 1u << i;
+        }
+    }
+    return changed;
+}
+
+/* =========================================================
+   Wątek przeładowania
+   ========================================================= */
+
+static void reload_free(ModelReload *rl)
+{
+    if (rl->has_mesh)
+        obj_free(&rl->data);
+    texture_image_free(&rl->texture);
+    memset(rl, 0, sizeof(*rl));
+}
+
+static int reloader_should_quit(ModelReloader *r)
+{
+    pthread_mutex_lock(&r->lock);
+    int q = r->quit;
+    pthread_mutex_unlock(&r->lock);
+    return q;
+}
+
+static void watch_model(ModelReloader *r, FileWatch *w, const char *texture)
+{
+    const char *paths[3];
+    paths[WATCH_OBJ] = r->obj_path;
+    paths[WATCH_MTL] = r->mtl_path;
+    paths[WATCH_TEX] = texture;
+    watch_open(w, paths, 3);
+}
+
+/**
+ * @brief Łączy wynik z jeszcze nieodebranym (nowszy wygrywa).
+ */
+static void publish_reload(ModelReloader *r, ModelReload *rl, double parseMs)
+{
+    pthread_mutex_lock(&r->lock);
+    ModelReload *p = &r->pending;
+    if (rl->has_mesh)
+    {
+        if (p->has_mesh)
+            obj_free(&p->data);
+        p->has_mesh = 1;
+        p->data = rl->data;
+        memcpy(p->bmin, rl->bmin, sizeof(p->bmin));
+        memcpy(p->bmax, rl->bmax, sizeof(p->bmax));
+    }
+    if (rl->has_material)
+    {
+        texture_image_free(&p->texture);
+        p->has_material = 1;
+        p->material = rl->material;
+        p->texture = rl->texture;
+    }
+    r->has_pending = p->has_mesh || p->has_material;
+    r->last_parse_ms = parseMs;
+    pthread_mutex_unlock(&r->lock);
+
+    memset(rl, 0, sizeof(*rl)); // własność przeszła do pending
+    glfwPostEmptyEvent();
+}
+
+static void *reload_thread_main(void *arg)
+{
+    ModelReloader *r = (ModelReloader *)arg;
+
+    MaterialDesc desc;
+    if (!material_parse_mtl(r->mtl_path, &desc))
+        desc.diffuseMap[0] = '\0';
+    char texture[256];
+    strcpy(texture, desc.diffuseMap);
+
+    FileWatch w;
+    watch_model(r, &w, texture);
+
+    while (!reloader_should_quit(r))
+    {
+        unsigned changed = watch_poll(&w, WATCH_POLL_MS);
+        if (!changed)
+            continue;
+
+        // eksport zapisuje plik kawałkami: czekamy na chwilę ciszy
+        unsigned more;
+        while ((more = watch_poll(&w, WATCH_SETTLE_MS)) != 0 && !reloader_should_quit(r))
+            changed |= more;
+
+        double t0 = now_ms();
+        ModelReload rl;
+        memset(&rl, 0, sizeof(rl));
+
+        if (changed & (1u << WATCH_OBJ))
+        {
+            if (obj_load_ex(r->obj_path, &rl.data, &r->normals))
+            {
+                if (r->weld.position_eps > 0.0f)
+                {
+                    WeldStats ws;
+                    if (weld_model(&rl.data, &r->weld, &ws))
+                        weld_print_stats(&ws);
+                }
+                rl.has_mesh = 1;
+                obj_compute_bounds(&rl.data, rl.bmin, rl.bmax);
+            }
+            else
+            {
+                printf("[reload] %s failed to parse, keeping the current mesh\n", r->obj_path);
+            }
+        }
+
+        if (changed & ((1u << WATCH_MTL) | (1u << WATCH_TEX)))
+        {
+            if (material_parse_mtl(r->mtl_path, &rl.material))
+            {
+                rl.has_material = 1;
+                if (rl.material.diffuseMap[0])
+                    texture_image_load(rl.material.diffuseMap, &rl.texture);
+
+                // inna tekstura -> obserwujemy nowy plik
+                if (strcmp(texture, rl.material.diffuseMap) != 0)
+                {
+                    strcpy(texture, rl.material.diffuseMap);
+                    watch_close(&w);
+                    watch_model(r, &w, texture);
+                }
+            }
+        }
+
+        if (rl.has_mesh || rl.has_material)
+            publish_reload(r, &rl, now_ms() - t0);
+    }
+
+    watch_close(&w);
+    return NULL;
+}
+
+/* =========================================================
+   Wątek główny (GL)
+   ========================================================= */
+
+static int fence_signaled(GLsync fence, GLuint64 timeout)
+{
+    GLenum s = glClientWaitSync(fence, timeout ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, timeout);
+    return s == GL_ALREADY_SIGNALED || s == GL_CONDITION_SATISFIED;
+}
+
+static void retired_destroy(RetiredResources *res)
+{
+    if (res->mesh.VAO)
+        mesh_destroy(&res->mesh);
+    if (res->texture)
+        glDeleteTextures(1, &res->texture);
+    glDeleteSync(res->fence);
+}
+
+/**
+ * @brief Usuwa zasoby, których fence już minął (bez czekania).
+ */
+static void release_retired(ModelReloader *r)
+{
+    int kept = 0;
+    for (int i = 0; i < r->retired_count; i++)
+    {
+        if (fence_signaled(r->retired[i].fence, 0))
+            retired_destroy(&r->retired[i]);
+        else
+            r->retired[kept++] = r->retired[i];
+    }
+    r->retired_count = kept;
+}
+
+static void retire(ModelReloader *r, RetiredResources res)
+{
+    res.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    if (r->retired_count == RELOAD_MAX_RETIRED)
+    {
+        // bardzo częste przeładowania: najstarszy musi zostać zwolniony teraz
+        fence_signaled(r->retired[0].fence, 1000000000ull);
+        retired_destroy(&r->retired[0]);
+        memmove(r->retired, r->retired + 1, (RELOAD_MAX_RETIRED - 1) * sizeof(RetiredResources));
+        r->retired_count--;
+    }
+    r->retired[r->retired_count++] = res;
+}
+
+/**
+ * @brief Dosyła kolejną porcję wierzchołków/indeksów do r->next.
+ *
+ * @return 1 gdy całość jest już na GPU.
+ */
+static int upload_step(ModelReloader *r)
+{
+    const ObjModelData *d = &r->staging.data;
+    size_t vbytes = d->vertex_count * sizeof(Vertex);
+    size_t ibytes = d->index_count * sizeof(unsigned int);
+    size_t budget = r->upload_budget;
+
+    // GL_COPY_WRITE_BUFFER: nie rusza stanu VAO (EBO należy do VAO)
+    if (r->vertex_bytes_done < vbytes && budget > 0)
+    {
+        size_t n = vbytes - r->vertex_bytes_done;
+        if (n > budget) n = budget;
+        glBindBuffer(GL_COPY_WRITE_BUFFER, r->next.VBO);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)r->vertex_bytes_done, (GLsizeiptr)n,
+                        (const unsigned char *)d->vertices + r->vertex_bytes_done);
+
+        // strumień pozycji: wierzchołki, które w tej porcji doszły w całości
+        unsigned int first = (unsigned int)(r->vertex_bytes_done / sizeof(Vertex));
+        r->vertex_bytes_done += n;
+        unsigned int end = (unsigned int)(r->vertex_bytes_done / sizeof(Vertex));
+        mesh_upload_positions(&r->next, d->vertices + first, first, end - first);
+        budget -= n;
+    }
+    if (r->index_bytes_done < ibytes && budget > 0)
+    {
+        size_t n = ibytes - r->index_bytes_done;
+        if (n > budget) n = budget;
+        glBindBuffer(GL_COPY_WRITE_BUFFER, r->next.EBO);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)r->index_bytes_done, (GLsizeiptr)n,
+                        (const unsigned char *)d->indices + r->index_bytes_done);
+        r->index_bytes_done += n;
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    r->upload_frames++;
+    return r->vertex_bytes_done == vbytes && r->index_bytes_done == ibytes;
+}
+
+int model_reloader_start(ModelReloader *r, const char *obj_path, const char *mtl_path,
+                         const NormalGenParams *normals, const WeldParams *weld)
+{
+    memset(r, 0, sizeof(*r));
+    snprintf(r->obj_path, sizeof(r->obj_path), "%s", obj_path);
+    snprintf(r->mtl_path, sizeof(r->mtl_path), "%s", mtl_path);
+    r->normals = normals ? *normals : normal_gen_params_default();
+    r->weld = weld ? *weld : weld_params_default();
+    r->upload_budget = 32u << 20;
+
+    pthread_mutex_init(&r->lock, NULL);
+    if (pthread_create(&r->thread, NULL, reload_thread_main, r) != 0)
+    {
+        printf("ERROR: cannot start reload thread\n");
+        pthread_mutex_destroy(&r->lock);
+        return 0;
+    }
+    r->thread_started = 1;
+    return 1;
+}
+
+int model_reloader_update(ModelReloader *r, Mesh *mesh, Material *mat, float bmin[3], float bmax[3])
+{
+    release_retired(r);
+
+    if (!r->staging_active)
+    {
+        pthread_mutex_lock(&r->lock);
+        if (r->has_pending)
+        {
+            r->staging = r->pending;
+            memset(&r->pending, 0, sizeof(r->pending));
+            r->has_pending = 0;
+            r->staging_active = 1;
+        }
+        pthread_mutex_unlock(&r->lock);
+
+        if (!r->staging_active)
+            return 0;
+
+        if (r->staging.has_mesh)
+        {
+            // druga siatka: tylko rezerwacja, dane dochodzą porcjami
+            r->next = mesh_create(NULL, (unsigned int)r->staging.data.vertex_count,
+                                  NULL, (unsigned int)r->staging.data.index_count);
+            r->vertex_bytes_done = 0;
+            r->index_bytes_done = 0;
+        }
+        r->upload_frames = 0;
+    }
+
+    if (r->staging.has_mesh && !upload_step(r))
+        return 0;
+
+    // podmiana na granicy klatek; stare zasoby czekają na fence
+    RetiredResources old;
+    memset(&old, 0, sizeof(old));
+
+    if (r->staging.has_mesh)
+    {
+        old.mesh = *mesh;
+        *mesh = r->next;
+        memset(&r->next, 0, sizeof(r->next));
+        memcpy(bmin, r->staging.bmin, sizeof(float) * 3);
+        memcpy(bmax, r->staging.bmax, sizeof(float) * 3);
+    }
+    if (r->staging.has_material)
+    {
+        old.texture = mat->diffuseTex;
+        memcpy(mat->diffuse, r->staging.material.diffuse, sizeof(mat->diffuse));
+        mat->diffuseTex = texture_create_2d(&r->staging.texture);
+    }
+    retire(r, old);
+
+    r->reloads++;
+    r->last_upload_frames = r->upload_frames;
+    pthread_mutex_lock(&r->lock);
+    double parseMs = r->last_parse_ms;
+    pthread_mutex_unlock(&r->lock);
+
+    printf("[reload] #%d:%s%s parsed in %.1f ms, uploaded over %d frame(s)\n",
+           r->reloads, r->staging.has_mesh ? " mesh" : "", r->staging.has_material ? " material" : "",
+           parseMs, r->last_upload_frames);
+
+    reload_free(&r->staging);
+    r->staging_active = 0;
+    return 1;
+}
+
+int model_reloader_busy(ModelReloader *r)
+{
+    pthread_mutex_lock(&r->lock);
+    int pending = r->has_pending;
+    pthread_mutex_unlock(&r->lock);
+    return pending || r->staging_active || r->retired_count > 0;
+}
+
+void model_reloader_stop(ModelReloader *r)
+{
+    if (r->thread_started)
+    {
+        pthread_mutex_lock(&r->lock);
+        r->quit = 1;
+        pthread_mutex_unlock(&r->lock);
+        pthread_join(r->thread, NULL);
+        pthread_mutex_destroy(&r->lock);
+        r->thread_started = 0;
+    }
+
+    reload_free(&r->pending);
+    reload_free(&r->staging);
+    if (r->next.VAO)
+        mesh_destroy(&r->next);
+    r->staging_active = 0;
+    r->has_pending = 0;
+
+    for (int i = 0; i < r->retired_count; i++)
+    {
+        fence_signaled(r->retired[i].fence, 1000000000ull);
+        retired_destroy(&r->retired[i]);
+    }
+    r->retired_count = 0;
+}
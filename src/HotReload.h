@@ -0,0 +1,130 @@
+#pragma once
+#include <stddef.h>
+#include <time.h>
+#include <pthread.h>
+#include <glad/glad.h>
+
+#include "Mesh.h"
+#include "Material.h"
+#include "ObjLoader.h"
+#include "Weld.h"
+
+#define WATCH_MAX_FILES 4
+#define RELOAD_MAX_RETIRED 8
+
+/**
+ * @brief Obserwacja zmian plików: inotify (Linux) lub odpytywanie mtime.
+ *
+ * Obserwowane są katalogi plików, nie same pliki — edytory i eksportery
+ * często zapisują plik tymczasowy i podmieniają go przez rename().
+ */
+typedef struct FileWatch
+{
+    char path[WATCH_MAX_FILES][1024];
+    int count;
+    int fd;                         // inotify (-1 -> odpytywanie)
+    int wd[WATCH_MAX_FILES];        // watch katalogu danego pliku
+    time_t mtime[WATCH_MAX_FILES];  // tryb odpytywania
+} FileWatch;
+
+/**
+ * @brief Wynik wczytania w tle (dane CPU czekające na upload).
+ */
+typedef struct ModelReload
+{
+    int has_mesh;
+    ObjModelData data;
+    float bmin[3];
+    float bmax[3];
+
+    int has_material;
+    MaterialDesc material;
+    TextureImage texture;
+} ModelReload;
+
+/**
+ * @brief Zasoby GPU czekające na zakończenie pracy GPU (fence).
+ */
+typedef struct RetiredResources
+{
+    Mesh mesh;
+    GLuint texture;
+    GLsync fence;
+} RetiredResources;
+
+/**
+ * @brief Przeładowanie modelu OBJ/MTL na gorąco.
+ *
+ * Wątek w tle obserwuje pliki, parsuje OBJ/MTL i dekoduje teksturę.
+ * Wątek główny (model_reloader_update, raz na klatkę):
+ *  - wysyła nową siatkę do drugiego Mesh porcjami (upload_budget bajtów
+ *    na klatkę), więc duży model nie powoduje przycięcia,
+ *  - podmienia siatkę/materiał na granicy klatek,
+ *  - stare bufory usuwa dopiero po sygnale fence (GPU już ich nie czyta).
+ */
+typedef struct ModelReloader
+{
+    char obj_path[1024];
+    char mtl_path[1024];
+    NormalGenParams normals;
+    WeldParams weld;
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    int thread_started;
+    int quit;                 // chronione lock
+    ModelReload pending;      // chronione lock
+    int has_pending;          // chronione lock
+
+    /* wątek główny: upload porcjami */
+    ModelReload staging;
+    int staging_active;
+    Mesh next;
+    size_t vertex_bytes_done;
+    size_t index_bytes_done;
+    size_t upload_budget;
+
+    RetiredResources retired[RELOAD_MAX_RETIRED];
+    int retired_count;
+
+    /* statystyki */
+    int reloads;
+    double last_parse_ms;     // chronione lock
+    int last_upload_frames;
+    int upload_frames;
+} ModelReloader;
+
+/**
+ * @brief Uruchamia obserwację plików i wątek przeładowania.
+ *
+ * @param r        Reloader.
+ * @param obj_path Plik .obj.
+ * @param mtl_path Plik .mtl (jego map_Kd też jest obserwowany).
+ * @param normals  Parametry generowania normalnych (NULL -> domyślne).
+ * @param weld     Scalanie wierzchołków (NULL -> wyłączone).
+ * @return 1 jeśli OK, 0 jeśli błąd.
+ */
+int model_reloader_start(ModelReloader *r, const char *obj_path, const char *mtl_path,
+                         const NormalGenParams *normals, const WeldParams *weld);
+
+/**
+ * @brief Krok na klatkę (wątek GL): upload, podmiana, zwalnianie po fence.
+ *
+ * @param r    Reloader.
+ * @param mesh Aktualnie rysowana siatka (podmieniana na miejscu).
+ * @param mat  Aktualny materiał (podmieniany na miejscu).
+ * @param bmin AABB nowego modelu (aktualizowany przy podmianie siatki).
+ * @param bmax j.w.
+ * @return 1 jeśli w tej klatce coś podmieniono.
+ */
+int model_reloader_update(ModelReloader *r, Mesh *mesh, Material *mat, float bmin[3], float bmax[3]);
+
+/**
+ * @brief Czy trwa upload albo czekają zasoby do zwolnienia (tryb on-demand).
+ */
+int model_reloader_busy(ModelReloader *r);
+
+/**
+ * @brief Zatrzymuje wątek i zwalnia wszystkie zasoby pośrednie.
+ */
+void model_reloader_stop(ModelReloader *r);
@@ -0,0 +1,368 @@
+#include "JobSystem.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+}
+
+static int cpu_count(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return (int)si.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+/* =========================================================
+   Kolejki
+   ========================================================= */
+
+static void deque_push(JobDeque *d, JobId id)
+{
+    pthread_mutex_lock(&d->lock);
+    d->items[d->bottom % JOB_MAX] = id;
+    d->bottom++;
+    pthread_mutex_unlock(&d->lock);
+}
+
+static JobId deque_pop(JobDeque *d)
+{
+    JobId id = JOB_NONE;
+    pthread_mutex_lock(&d->lock);
+    if (d->bottom > d->top)
+    {
+        d->bottom--;
+        id = d->items[d->bottom % JOB_MAX];
+    }
+    pthread_mutex_unlock(&d->lock);
+    return id;
+}
+
+static JobId deque_steal(JobDeque *d)
+{
+    JobId id = JOB_NONE;
+    pthread_mutex_lock(&d->lock);
+    if (d->bottom > d->top)
+    {
+        id = d->items[d->top % JOB_MAX];
+        d->top++;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return id;
+}
+
+/**
+ * @brief Gotowe zadanie do właściwej kolejki (wątek główny albo deque wątku self).
+ */
+static void enqueue_ready(JobSystem *js, JobId id, int self)
+{
+    if (js->jobs[id].main_thread)
+    {
+        pthread_mutex_lock(&js->lock);
+        js->main_queue[js->main_tail % JOB_MAX] = id;
+        js->main_tail++;
+        pthread_cond_broadcast(&js->cond);
+        pthread_mutex_unlock(&js->lock);
+        return;
+    }
+
+    deque_push(&js->deques[self], id);
+    pthread_mutex_lock(&js->lock);
+    js->queued++;
+    pthread_cond_broadcast(&js->cond);
+    pthread_mutex_unlock(&js->lock);
+}
+
+/**
+ * @brief Następne zadanie dla wątku self: własna kolejka, potem kradzież.
+ *
+ * Kolejka zgłoszeń z wątku głównego (deques[worker_count]) jest
+ * brana od góry przez wszystkich, więc zachowuje kolejność zgłoszeń.
+ */
+static JobId take_job(JobSystem *js, int self)
+{
+    int n = js->worker_count;
+    JobId id = self < n ? deque_pop(&js->deques[self]) : JOB_NONE;
+    int stolen = 0;
+
+    for (int k = 0; id == JOB_NONE && k <= n; k++)
+    {
+        int victim = (self + 1 + k) % (n + 1);
+        if (victim == self && self < n)
+            continue;
+        id = deque_steal(&js->deques[victim]);
+        stolen = victim != n;
+    }
+    if (id == JOB_NONE)
+        return JOB_NONE;
+
+    pthread_mutex_lock(&js->lock);
+    js->queued--;
+    js->steals += (size_t)stolen;
+    pthread_mutex_unlock(&js->lock);
+    return id;
+}
+
+static void run_job(JobSystem *js, JobId id, int self)
+{
+    Job *j = &js->jobs[id];
+    double t0 = now_ms();
+    j->fn(j->arg);
+    double t1 = now_ms();
+
+    JobId ready[JOB_MAX_SUCCESSORS];
+    int ready_count = 0;
+
+    pthread_mutex_lock(&js->lock);
+    j->worker = self;
+    j->start_ms = t0 - js->start_ms;
+    j->ms = t1 - t0;
+    j->done = 1;
+    js->finished++;
+    for (int s = 0; s < j->successor_count; s++)
+    {
+        Job *n = &js->jobs[j->successors[s]];
+        if (--n->pending == 0 && n->submitted)
+            ready[ready_count++] = j->successors[s];
+    }
+    pthread_cond_broadcast(&js->cond);
+    pthread_mutex_unlock(&js->lock);
+
+    for (int r = 0; r < ready_count; r++)
+        enqueue_ready(js, ready[r], self);
+}
+
+static void *worker_main(void *arg)
+{
+    JobWorker *w = (JobWorker *)arg;
+    JobSystem *js = w->js;
+
+    for (;;)
+    {
+        JobId id = take_job(js, w->index);
+        if (id != JOB_NONE)
+        {
+            run_job(js, id, w->index);
+            continue;
+        }
+
+        pthread_mutex_lock(&js->lock);
+        while (!js->quit && js->queued == 0)
+            pthread_cond_wait(&js->cond, &js->lock);
+        int quit = js->quit && js->queued == 0;
+        pthread_mutex_unlock(&js->lock);
+        if (quit)
+            break;
+    }
+    return NULL;
+}
+
+/* =========================================================
+   API
+   ========================================================= */
+
+int job_system_init(JobSystem *js, int workers)
+{
+    memset(js, 0, sizeof(*js));
+    js->jobs = (Job *)calloc(JOB_MAX, sizeof(Job));
+    if (!js->jobs)
+        return 0;
+
+    if (workers < 0)
+        workers = cpu_count() - 1 > 1 ? cpu_count() - 1 : 1;
+    if (workers > JOB_MAX_WORKERS)
+        workers = JOB_MAX_WORKERS;
+
+    pthread_mutex_init(&js->lock, NULL);
+    pthread_cond_init(&js->cond, NULL);
+    for (int i = 0; i <= JOB_MAX_WORKERS; i++)
+        pthread_mutex_init(&js->deques[i].lock, NULL);
+    js->start_ms = now_ms();
+
+    // kolejka zgłoszeń z wątku głównego ma indeks worker_count
+    js->worker_count = workers;
+    for (int i = 0; i < workers; i++)
+    {
+        js->workers[i].js = js;
+        js->workers[i].index = i;
+        if (pthread_create(&js->threads[i], NULL, worker_main, &js->workers[i]) != 0)
+        {
+            printf("ERROR: cannot start job worker %d\n", i);
+            js->worker_count = i;
+            break;
+        }
+    }
+    return 1;
+}
+
+JobId job_create(JobSystem *js, const char *name, JobFn fn, void *arg, int main_thread)
+{
+    // także z wnętrza zadania (graf dobudowywany w trakcie)
+    pthread_mutex_lock(&js->lock);
+    JobId id = js->job_count < JOB_MAX ? js->job_count++ : JOB_NONE;
+    pthread_mutex_unlock(&js->lock);
+    if (id == JOB_NONE)
+    {
+        printf("ERROR: job pool full (%d)\n", JOB_MAX);
+        return JOB_NONE;
+    }
+
+    Job *j = &js->jobs[id];
+    memset(j, 0, sizeof(*j));
+    j->name = name;
+    j->fn = fn;
+    j->arg = arg;
+    j->main_thread = main_thread;
+    return id;
+}
+
+void job_depend(JobSystem *js, JobId job, JobId on)
+{
+    if (job == JOB_NONE || on == JOB_NONE)
+        return;
+
+    pthread_mutex_lock(&js->lock);
+    Job *d = &js->jobs[on];
+    if (!d->done)
+    {
+        if (d->successor_count < JOB_MAX_SUCCESSORS)
+        {
+            d->successors[d->successor_count++] = job;
+            js->jobs[job].pending++;
+        }
+        else
+        {
+            printf("ERROR: job '%s' has too many dependents\n", d->name);
+        }
+    }
+    pthread_mutex_unlock(&js->lock);
+}
+
+void job_submit(JobSystem *js, JobId job)
+{
+    if (job == JOB_NONE)
+        return;
+
+    pthread_mutex_lock(&js->lock);
+    Job *j = &js->jobs[job];
+    j->submitted = 1;
+    js->submitted++;
+    int ready = j->pending == 0;
+    pthread_mutex_unlock(&js->lock);
+
+    if (ready)
+        enqueue_ready(js, job, js->worker_count);
+}
+
+/**
+ * @brief Pętla wątku głównego: zadania GL, pomoc workerom, sen.
+ *
+ * @param job Zadanie, na które czekamy (JOB_NONE -> wszystkie zgłoszone).
+ */
+static void main_thread_wait(JobSystem *js, JobId job)
+{
+    int self = js->worker_count;
+    for (;;)
+    {
+        JobId id = JOB_NONE;
+
+        pthread_mutex_lock(&js->lock);
+        int done = job != JOB_NONE ? js->jobs[job].done : js->finished == js->submitted;
+        if (!done && js->main_head != js->main_tail)
+        {
+            id = js->main_queue[js->main_head % JOB_MAX];
+            js->main_head++;
+        }
+        pthread_mutex_unlock(&js->lock);
+        if (done)
+            return;
+
+        if (id == JOB_NONE)
+            id = take_job(js, self);
+        if (id != JOB_NONE)
+        {
+            run_job(js, id, self);
+            continue;
+        }
+
+        pthread_mutex_lock(&js->lock);
+        while (js->main_head == js->main_tail && js->queued == 0 &&
+               !(job != JOB_NONE ? js->jobs[job].done : js->finished == js->submitted))
+            pthread_cond_wait(&js->cond, &js->lock);
+        pthread_mutex_unlock(&js->lock);
+    }
+}
+
+void job_system_wait(JobSystem *js, JobId job)
+{
+    if (job != JOB_NONE)
+        main_thread_wait(js, job);
+}
+
+void job_system_wait_all(JobSystem *js)
+{
+    main_thread_wait(js, JOB_NONE);
+}
+
+void job_system_print_stats(const JobSystem *js)
+{
+    double busy = 0.0, end = 0.0;
+    for (int i = 0; i < js->job_count; i++)
+    {
+        const Job *j = &js->jobs[i];
+        busy += j->ms;
+        end = j->start_ms + j->ms > end ? j->start_ms + j->ms : end;
+    }
+
+    printf("[jobs] %d jobs on %d workers + main thread, %zu steals, busy %.1f ms in %.1f ms\n",
+           js->job_count, js->worker_count, js->steals, busy, end);
+    for (int i = 0; i < js->job_count; i++)
+    {
+        const Job *j = &js->jobs[i];
+        if (!j->done)
+            continue;
+        if (j->worker == js->worker_count)
+            printf("  %-16s main      +%7.1f ms %7.1f ms\n", j->name, j->start_ms, j->ms);
+        else
+            printf("  %-16s worker %-2d +%7.1f ms %7.1f ms\n", j->name, j->worker, j->start_ms, j->ms);
+    }
+}
+
+void job_system_destroy(JobSystem *js)
+{
+    if (!js->jobs)
+        return;
+
+    job_system_wait_all(js);
+
+    pthread_mutex_lock(&js->lock);
+    js->quit = 1;
+    pthread_cond_broadcast(&js->cond);
+    pthread_mutex_unlock(&js->lock);
+    for (int i = 0; i < js->worker_count; i++)
+        pthread_join(js->threads[i], NULL);
+
+    for (int i = 0; i <= JOB_MAX_WORKERS; i++)
+        pthread_mutex_destroy(&js->deques[i].lock);
+    pthread_cond_destroy(&js->cond);
+    pthread_mutex_destroy(&js->lock);
+    free(js->jobs);
+    js->jobs = NULL;
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include <stddef.h>
+#include <pthread.h>
+
+#define JOB_MAX 256
+#define JOB_MAX_SUCCESSORS 8
+#define JOB_MAX_WORKERS 32
+#define JOB_NONE (-1)
+
+typedef int JobId;
+typedef void (*JobFn)(void *arg);
+
+/**
+ * @brief Zadanie w grafie: funkcja, zależności, pomiar czasu.
+ */
+typedef struct Job
+{
+    const char *name;
+    JobFn fn;
+    void *arg;
+    int main_thread; // 1 -> tylko wątek główny (kontekst GL)
+
+    int pending;   // niezakończone zależności (chronione lock)
+    int submitted; // chronione lock
+    int done;      // chronione lock
+    JobId successors[JOB_MAX_SUCCESSORS];
+    int successor_count;
+
+    int worker;      // kto wykonał (worker_count = wątek główny)
+    double start_ms; // od job_system_init()
+    double ms;
+} Job;
+
+/**
+ * @brief Kolejka dwustronna wątku: właściciel bierze od dołu (LIFO),
+ *        pozostali kradną od góry (najstarsze zadania).
+ */
+typedef struct JobDeque
+{
+    pthread_mutex_t lock;
+    JobId items[JOB_MAX];
+    size_t top;    // kradzież
+    size_t bottom; // właściciel
+} JobDeque;
+
+struct JobSystem;
+
+typedef struct JobWorker
+{
+    struct JobSystem *js;
+    int index;
+} JobWorker;
+
+/**
+ * @brief System zadań z podkradaniem pracy i zależnościami.
+ *
+ * Każdy wątek roboczy ma własną kolejkę; gotowe następniki zadania
+ * trafiają do kolejki wątku, który je odblokował (dane są jeszcze
+ * w jego cache), a bezczynne wątki kradną najstarsze zadania innych.
+ * Zadania zgłoszone z wątku głównego trafiają do dodatkowej kolejki
+ * deques[worker_count], z której wszyscy biorą w kolejności zgłoszeń.
+ *
+ * Zadania main_thread (wywołania GL) czekają w osobnej kolejce
+ * i wykonuje je tylko wątek główny w job_system_wait(), który przy
+ * okazji pomaga workerom. Przy 0 workerach wszystko wykonuje wątek
+ * główny w kolejności gotowości (tryb szeregowy do porównań).
+ */
+typedef struct JobSystem
+{
+    Job *jobs;
+    int job_count;
+
+    JobWorker workers[JOB_MAX_WORKERS];
+    pthread_t threads[JOB_MAX_WORKERS];
+    int worker_count;
+    JobDeque deques[JOB_MAX_WORKERS + 1];
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    JobId main_queue[JOB_MAX]; // chronione lock
+    size_t main_head, main_tail;
+    int queued;   // zadania w kolejkach workerów (chronione lock)
+    int submitted; // chronione lock
+    int finished;  // chronione lock
+    int quit;
+    size_t steals;
+
+    double start_ms;
+} JobSystem;
+
+/**
+ * @brief Uruchamia wątki robocze.
+ *
+ * @param js      System.
+ * @param workers Liczba wątków (< 0 -> rdzenie - 1, co najmniej 1;
+ *                0 -> wszystko na wątku głównym).
+ * @return 1 jeśli OK, 0 jeśli błąd.
+ */
+int job_system_init(JobSystem *js, int workers);
+
+/**
+ * @brief Tworzy zadanie (jeszcze nie zgłoszone).
+ *
+ * Można wołać z wnętrza zadania (razem z job_depend() i job_submit()),
+ * np. żeby rozdzielić pracę poznaną dopiero po wczytaniu danych.
+ *
+ * @param js          System.
+ * @param name        Nazwa do statystyk (literał).
+ * @param fn          Funkcja zadania.
+ * @param arg         Argument.
+ * @param main_thread 1 -> wykonuje tylko wątek główny.
+ * @return Id zadania albo JOB_NONE, jeśli pula jest pełna.
+ */
+JobId job_create(JobSystem *js, const char *name, JobFn fn, void *arg, int main_thread);
+
+/**
+ * @brief job czeka na zakończenie on.
+ *
+ * Wołać przed job_submit(job) albo z zadania, na które job już czeka
+ * (job nie może wtedy jeszcze ruszyć).
+ */
+void job_depend(JobSystem *js, JobId job, JobId on);
+
+/**
+ * @brief Zgłasza zadanie; rusza, gdy wszystkie zależności się zakończą.
+ */
+void job_submit(JobSystem *js, JobId job);
+
+/**
+ * @brief Czeka na zadanie, wykonując w tym czasie zadania GL i pomagając workerom.
+ *
+ * Tylko z wątku głównego.
+ */
+void job_system_wait(JobSystem *js, JobId job);
+
+/**
+ * @brief Czeka na wszystkie zgłoszone zadania (jak job_system_wait()).
+ */
+void job_system_wait_all(JobSystem *js);
+
+/**
+ * @brief Wypisuje podsumowanie i czas każdego zadania.
+ */
+void job_system_print_stats(const JobSystem *js);
+
+/**
+ * @brief Czeka na zgłoszone zadania i zatrzymuje wątki.
+ */
+void job_system_destroy(JobSystem *js);
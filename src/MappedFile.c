@@ -0,0 +1,118 @@
+#include "MappedFile.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+int mapped_file_open(const char *path, MappedFile *out)
+{
+    memset(out, 0, sizeof(*out));
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        printf("ERROR: cannot open file: %s\n", path);
+        return 0;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return 0;
+    }
+    out->file = file;
+    out->is_open = 1;
+    out->size = (size_t)size.QuadPart;
+    if (out->size == 0)
+        return 1;
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping)
+    {
+        printf("ERROR: cannot map file: %s\n", path);
+        mapped_file_close(out);
+        return 0;
+    }
+    out->mapping = mapping;
+    out->data = (const unsigned char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!out->data)
+    {
+        printf("ERROR: cannot map file: %s\n", path);
+        mapped_file_close(out);
+        return 0;
+    }
+    return 1;
+}
+
+void mapped_file_close(MappedFile *f)
+{
+    if (!f || !f->is_open)
+        return;
+    if (f->data)
+        UnmapViewOfFile(f->data);
+    if (f->mapping)
+        CloseHandle((HANDLE)f->mapping);
+    if (f->file)
+        CloseHandle((HANDLE)f->file);
+    memset(f, 0, sizeof(*f));
+}
+
+#else /* POSIX */
+
+int mapped_file_open(const char *path, MappedFile *out)
+{
+    memset(out, 0, sizeof(*out));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        printf("ERROR: cannot open file: %s\n", path);
+        return 0;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return 0;
+    }
+    out->fd = fd;
+    out->is_open = 1;
+    out->size = (size_t)st.st_size;
+    if (out->size == 0)
+        return 1;
+
+    void *p = mmap(NULL, out->size, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED)
+    {
+        printf("ERROR: cannot map file: %s\n", path);
+        mapped_file_close(out);
+        return 0;
+    }
+    out->data = (const unsigned char *)p;
+    return 1;
+}
+
+void mapped_file_close(MappedFile *f)
+{
+    if (!f || !f->is_open)
+        return;
+    if (f->data)
+        munmap((void *)f->data, f->size);
+    close(f->fd);
+    memset(f, 0, sizeof(*f));
+}
+
+#endif
@@ -0,0 +1,37 @@
+#pragma once
+#include <stddef.h>
+
+/**
+ * @brief Plik zmapowany w pamięci tylko do odczytu (mmap / MapViewOfFile).
+ *
+ * System stronicuje dane na żądanie, więc można "otworzyć" plik większy
+ * niż dostępna pamięć RAM.
+ */
+typedef struct MappedFile
+{
+    const unsigned char *data; // NULL jeśli plik pusty / niezmapowany
+    size_t size;
+    int is_open;               // 1 po udanym mapped_file_open()
+#ifdef _WIN32
+    void *file;    // HANDLE
+    void *mapping; // HANDLE
+#else
+    int fd;
+#endif
+} MappedFile;
+
+/**
+ * @brief Mapuje cały plik do pamięci (tylko odczyt).
+ *
+ * @param path Ścieżka do pliku.
+ * @param out  Struktura wyjściowa.
+ * @return 1 jeśli OK, 0 jeśli błąd.
+ */
+int mapped_file_open(const char *path, MappedFile *out);
+
+/**
+ * @brief Odmapowuje plik i zamyka uchwyty.
+ *
+ * @param f Zmapowany plik.
+ */
+void mapped_file_close(MappedFile *f);
@@ -1,5 +1,6 @@
 #include "material.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 /* stb_image */
@@ -18,25 +19,52 @@ void material_init(Material* m)
 }
 
 /**
- * @brief Wczytuje teksturę 2D z pliku.
+ * @brief Dekoduje obraz (stb_image), RGB zostaje RGB, reszta -> RGBA.
  */
-static GLuint load_texture_2d(const char* path)
+int texture_image_load(const char* path, TextureImage* out)
 {
+    memset(out, 0, sizeof(*out));
+
     int w, h, n;
     stbi_set_flip_vertically_on_load(1);
-    unsigned char* data = stbi_load(path, &w, &h, &n, 0);
-    if (!data) {
+    if (!stbi_info(path, &w, &h, &n)) {
         printf("Failed to load texture: %s\n", path);
         return 0;
     }
+    int req = (n == 3) ? 3 : 4;
+    out->pixels = stbi_load(path, &w, &h, &n, req);
+    if (!out->pixels) {
+        printf("Failed to load texture: %s\n", path);
+        return 0;
+    }
+    out->width = w;
+    out->height = h;
+    out->channels = req;
+    return 1;
+}
+
+void texture_image_free(TextureImage* img)
+{
+    if (!img) return;
+    stbi_image_free(img->pixels);
+    memset(img, 0, sizeof(*img));
+}
+
+/**
+ * @brief Wysyła obraz na GPU i generuje mipmapy.
+ */
+GLuint texture_create_2d(const TextureImage* img)
+{
+    if (!img->pixels)
+        return 0;
 
-    GLenum format = (n == 3) ? GL_RGB : GL_RGBA;
+    GLenum format = (img->channels == 3) ? GL_RGB : GL_RGBA;
 
     GLuint tex;
     glGenTextures(1, &tex);
     glBindTexture(GL_TEXTURE_2D, tex);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, format, w, h, 0, format, GL_UNSIGNED_BYTE, data);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, img->width, img->height, 0, format, GL_UNSIGNED_BYTE, img->pixels);
     glGenerateMipmap(GL_TEXTURE_2D);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -44,16 +72,87 @@ static GLuint load_texture_2d(const char* path)
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    stbi_image_free(data);
     return tex;
 }
 
 /**
- * @brief Parser MTL (minimalny).
+ * @brief Wczytuje teksturę 2D z pliku.
  */
-int material_load_mtl(const char* path, Material* out)
+static GLuint load_texture_2d(const char* path)
 {
-    material_init(out);
+    TextureImage img;
+    if (!texture_image_load(path, &img))
+        return 0;
+    GLuint tex = texture_create_2d(&img);
+    texture_image_free(&img);
+    return tex;
+}
+
+/**
+ * @brief Tworzy teksturę 2D z wpisu paczki (gotowe mipmapy).
+ */
+static GLuint load_texture_2d_from_pack(const AssetPack* pack, const char* name)
+{
+    const AssetPackEntry* e = asset_pack_find(pack, name, ASSET_TEXTURE);
+    if (!e || e->size < sizeof(AssetTextureHeader)) {
+        printf("Failed to load texture: %s (not in pack)\n", name);
+        return 0;
+    }
+
+    const unsigned char* base = (const unsigned char*)asset_pack_data(pack, e);
+    const AssetTextureHeader* h = (const AssetTextureHeader*)base;
+    if (h->levels == 0 || h->levels > ASSET_TEXTURE_MAX_LEVELS) {
+        printf("Failed to load texture: %s (corrupted)\n", name);
+        return 0;
+    }
+
+    GLenum format = (h->channels == 3) ? GL_RGB : GL_RGBA;
+
+    GLuint tex;
+    glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_2D, tex);
+
+    // wiersze RGB nie muszą być wyrównane do 4 bajtów
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    GLsizei w = (GLsizei)h->width, hgt = (GLsizei)h->height;
+    uint32_t uploaded = 0;
+    for (uint32_t l = 0; l < h->levels; l++) {
+        uint64_t bytes = (uint64_t)w * hgt * h->channels;
+        if (h->level_offset[l] + bytes > e->size)
+            break;
+        glTexImage2D(GL_TEXTURE_2D, (GLint)l, format, w, hgt, 0, format, GL_UNSIGNED_BYTE,
+                     base + h->level_offset[l]);
+        uploaded++;
+        w = w > 1 ? w / 2 : 1;
+        hgt = hgt > 1 ? hgt / 2 : 1;
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    if (uploaded == 0) {
+        printf("Failed to load texture: %s (truncated)\n", name);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glDeleteTextures(1, &tex);
+        return 0;
+    }
+    // obcięty łańcuch: MAX_LEVEL na ostatnim wysłanym poziomie, inaczej tekstura niekompletna (czarna)
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)uploaded - 1);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    return tex;
+}
+
+/**
+ * @brief Parser MTL (minimalny, bez GL).
+ */
+int material_parse_mtl(const char* path, MaterialDesc* out)
+{
+    out->name[0] = '\0';
+    out->diffuse[0] = 1.0f;
+    out->diffuse[1] = 1.0f;
+    out->diffuse[2] = 1.0f;
+    out->diffuseMap[0] = '\0';
 
     FILE* f = fopen(path, "r");
     if (!f) {
@@ -70,9 +169,7 @@ int material_load_mtl(const char* path, Material* out)
                    &out->diffuse[2]);
         }
         else if (strncmp(line, "map_Kd ", 7) == 0) {
-            char texPath[256];
-            sscanf(line, "map_Kd %255s", texPath);
-            out->diffuseTex = load_texture_2d(texPath);
+            sscanf(line, "map_Kd %255s", out->diffuseMap);
         }
     }
 
@@ -80,6 +177,101 @@ int material_load_mtl(const char* path, Material* out)
     return 1;
 }
 
+/**
+ * @brief Parser MTL: każdy newmtl to osobny opis.
+ */
+int material_parse_library(const char* path, MaterialDesc** out, size_t* count)
+{
+    *out = NULL;
+    *count = 0;
+
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        printf("Cannot open MTL: %s\n", path);
+        return 0;
+    }
+
+    MaterialDesc* list = NULL;
+    size_t n = 0, cap = 0;
+    char line[512];
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "newmtl ", 7) == 0) {
+            if (n == cap) {
+                size_t newCap = cap ? cap * 2 : 8;
+                MaterialDesc* grown = (MaterialDesc*)realloc(list, newCap * sizeof(MaterialDesc));
+                if (!grown) {
+                    break;
+                }
+                list = grown;
+                cap = newCap;
+            }
+            MaterialDesc* d = &list[n++];
+            memset(d, 0, sizeof(*d));
+            d->diffuse[0] = d->diffuse[1] = d->diffuse[2] = 1.0f;
+            sscanf(line, "newmtl %63s", d->name);
+        }
+        else if (n > 0 && strncmp(line, "Kd ", 3) == 0) {
+            MaterialDesc* d = &list[n - 1];
+            sscanf(line, "Kd %f %f %f", &d->diffuse[0], &d->diffuse[1], &d->diffuse[2]);
+        }
+        else if (n > 0 && strncmp(line, "map_Kd ", 7) == 0) {
+            sscanf(line, "map_Kd %255s", list[n - 1].diffuseMap);
+        }
+    }
+
+    fclose(f);
+    *out = list;
+    *count = n;
+    return 1;
+}
+
+/**
+ * @brief Parser MTL + wczytanie tekstury.
+ */
+int material_load_mtl(const char* path, Material* out)
+{
+    material_init(out);
+
+    MaterialDesc desc;
+    if (!material_parse_mtl(path, &desc))
+        return 0;
+
+    memcpy(out->diffuse, desc.diffuse, sizeof(out->diffuse));
+    if (desc.diffuseMap[0])
+        out->diffuseTex = load_texture_2d(desc.diffuseMap);
+    return 1;
+}
+
+/**
+ * @brief Materiał z paczki (rekord zamiast parsowania tekstu MTL).
+ */
+int material_load_from_pack(const AssetPack* pack, const char* name, Material* out)
+{
+    material_init(out);
+
+    const AssetPackEntry* e = asset_pack_find(pack, name, ASSET_MATERIAL);
+    if (!e || e->size < sizeof(AssetMaterialRecord)) {
+        printf("Cannot find material in pack: %s\n", name);
+        return 0;
+    }
+
+    const AssetMaterialRecord* rec = (const AssetMaterialRecord*)asset_pack_data(pack, e);
+    memcpy(out->diffuse, rec->diffuse, sizeof(out->diffuse));
+    if (rec->diffuse_map[0] && memchr(rec->diffuse_map, '\0', sizeof(rec->diffuse_map)))
+        out->diffuseTex = load_texture_2d_from_pack(pack, rec->diffuse_map);
+    return 1;
+}
+
+/**
+ * @brief Usuwa teksturę materiału (GL).
+ */
+void material_destroy(Material* m)
+{
+    if (m->diffuseTex)
+        glDeleteTextures(1, &m->diffuseTex);
+    m->diffuseTex = 0;
+}
+
 /**
  * @brief Aktywuje materiał w shaderze.
  */
@@ -98,14 +290,10 @@ void material_bind(const Material* m, GLuint shaderProgram)
             glGetUniformLocation(shaderProgram, "uMaterial.diffuseMap"),
             0
         );
-        glUniform1i(
-            glGetUniformLocation(shaderProgram, "uMaterial.hasTexture"),
-            1
-        );
-    } else {
-        glUniform1i(
-            glGetUniformLocation(shaderProgram, "uMaterial.hasTexture"),
-            0
-        );
     }
 }
+
+unsigned material_shader_features(const Material* m)
+{
+    return m->diffuseTex ? SHADER_FEATURE_TEXTURE : 0u;
+}
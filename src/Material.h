@@ -1,5 +1,7 @@
 #pragma once
 #include <glad/glad.h>
+#include "AssetPack.h"
+#include "Shader.h"
 
 /**
  * @brief Struktura materiału (MTL).
@@ -13,11 +15,70 @@ typedef struct Material {
     GLuint diffuseTex;  // mapa_Kd (0 jeśli brak)
 } Material;
 
+/**
+ * @brief Opis materiału po stronie CPU (wynik parsowania MTL, bez GL).
+ */
+typedef struct MaterialDesc {
+    char name[64];          // newmtl ("" jeśli brak)
+    float diffuse[3];       // Kd
+    char diffuseMap[256];   // map_Kd ("" jeśli brak)
+} MaterialDesc;
+
+/**
+ * @brief Zdekodowany obraz tekstury (CPU, odwrócony w pionie jak dla GL).
+ */
+typedef struct TextureImage {
+    unsigned char* pixels;
+    int width;
+    int height;
+    int channels;
+} TextureImage;
+
 /**
  * @brief Inicjalizuje domyślny materiał.
  */
 void material_init(Material* m);
 
+/**
+ * @brief Parsuje plik MTL bez wywołań GL (bezpieczne na dowolnym wątku).
+ *
+ * @param path Ścieżka do pliku .mtl
+ * @param out  Opis wyjściowy
+ * @return 1 jeśli OK, 0 jeśli błąd
+ */
+int material_parse_mtl(const char* path, MaterialDesc* out);
+
+/**
+ * @brief Parsuje wszystkie materiały (bloki newmtl) pliku MTL, bez GL.
+ *
+ * @param path  Ścieżka do pliku .mtl
+ * @param out   Tablica wyjściowa (malloc; zwolnić free())
+ * @param count Liczba materiałów
+ * @return 1 jeśli OK, 0 jeśli błąd
+ */
+int material_parse_library(const char* path, MaterialDesc** out, size_t* count);
+
+/**
+ * @brief Dekoduje obraz tekstury (bez GL, dowolny wątek).
+ *
+ * @param path Ścieżka do obrazu
+ * @param out  Obraz wyjściowy (zwolnić texture_image_free())
+ * @return 1 jeśli OK, 0 jeśli błąd
+ */
+int texture_image_load(const char* path, TextureImage* out);
+
+/**
+ * @brief Zwalnia piksele obrazu.
+ */
+void texture_image_free(TextureImage* img);
+
+/**
+ * @brief Tworzy teksturę GL z obrazu (mipmapy, REPEAT, trilinear).
+ *
+ * @return ID tekstury lub 0 jeśli obraz jest pusty
+ */
+GLuint texture_create_2d(const TextureImage* img);
+
 /**
  * @brief Wczytuje plik MTL (obsługa newmtl, Kd, map_Kd).
  *
@@ -27,10 +88,35 @@ void material_init(Material* m);
  */
 int material_load_mtl(const char* path, Material* out);
 
+/**
+ * @brief Wczytuje materiał i jego teksturę z paczki zasobów.
+ *
+ * Poziomy mip są gotowe w paczce i wysyłane prosto z mapowania
+ * (bez dekodowania obrazu i bez glGenerateMipmap).
+ *
+ * @param pack Otwarta paczka.
+ * @param name Nazwa wpisu (ścieżka pliku .mtl użyta przy budowie).
+ * @param out  Materiał wyjściowy
+ * @return 1 jeśli OK, 0 jeśli brak wpisu
+ */
+int material_load_from_pack(const AssetPack* pack, const char* name, Material* out);
+
+/**
+ * @brief Usuwa teksturę materiału.
+ */
+void material_destroy(Material* m);
+
 /**
  * @brief Aktywuje materiał (bindowanie tekstury + uniformy).
  *
+ * Program musi być wariantem z material_shader_features(m).
+ *
  * @param m   Materiał
  * @param sh  ID programu shaderów
  */
 void material_bind(const Material* m, GLuint shaderProgram);
+
+/**
+ * @brief Cechy wariantu shadera dla materiału (ShaderFeature).
+ */
+unsigned material_shader_features(const Material* m);
@@ -1,14 +1,27 @@
 #include "mesh.h"
 #include <stddef.h> 
+#include <stdlib.h>
+
+#define MESH_POSITION_CHUNK 65536 // wierzchołki rozplatane naraz (768 KB bufora)
+
+Mesh mesh_create(
+    const Vertex *vertices,
+    unsigned int vertex_count,
+    const unsigned int *indices,
+    unsigned int index_count)
+{
+    return mesh_create_ex(vertices, vertex_count, indices, index_count, 1);
+}
 
 /**
  * @brief Tworzy i inicjalizuje VAO/VBO/EBO dla siatki.
  */
-Mesh mesh_create(
+Mesh mesh_create_ex(
     const Vertex *vertices,
     unsigned int vertex_count,
     const unsigned int *indices,
-    unsigned int index_count)
+    unsigned int index_count,
+    int positions)
 {
     Mesh mesh = {0};
     mesh.index_count = index_count;
@@ -66,10 +79,71 @@ Mesh mesh_create(
         (void *)offsetof(Vertex, texcoord));
     glEnableVertexAttribArray(2);
 
+    if (!positions)
+    {
+        glBindVertexArray(0);
+        return mesh;
+    }
+
+    // strumień samych pozycji dla przebiegu głębi (DepthPrepass)
+    glGenVertexArrays(1, &mesh.depthVAO);
+    glGenBuffers(1, &mesh.positionVBO);
+    glBindVertexArray(mesh.depthVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.positionVBO);
+    glBufferData(
+        GL_ARRAY_BUFFER,
+        vertex_count * 3 * sizeof(float),
+        NULL,
+        GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)0);
+    glEnableVertexAttribArray(0);
+
     glBindVertexArray(0);
+
+    if (vertices)
+        mesh_upload_positions(&mesh, vertices, 0, vertex_count);
     return mesh;
 }
 
+/**
+ * @brief Rozplata pozycje porcjami i dosyła je do positionVBO.
+ */
+void mesh_upload_positions(const Mesh *mesh, const Vertex *vertices, unsigned int first, unsigned int count)
+{
+    if (count == 0 || !mesh->positionVBO)
+        return;
+    unsigned int chunk = count < MESH_POSITION_CHUNK ? count : MESH_POSITION_CHUNK;
+    float *positions = (float *)malloc((size_t)chunk * 3 * sizeof(float));
+    if (!positions)
+        return;
+
+    // GL_COPY_WRITE_BUFFER: nie rusza stanu VAO ani GL_ARRAY_BUFFER
+    glBindBuffer(GL_COPY_WRITE_BUFFER, mesh->positionVBO);
+    for (unsigned int done = 0; done < count; done += chunk)
+    {
+        unsigned int n = count - done < chunk ? count - done : chunk;
+        for (unsigned int i = 0; i < n; i++)
+        {
+            positions[i * 3 + 0] = vertices[done + i].position[0];
+            positions[i * 3 + 1] = vertices[done + i].position[1];
+            positions[i * 3 + 2] = vertices[done + i].position[2];
+        }
+        glBufferSubData(
+            GL_COPY_WRITE_BUFFER,
+            (GLintptr)(first + done) * 3 * sizeof(float),
+            (GLsizeiptr)n * 3 * sizeof(float),
+            positions);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    free(positions);
+}
+
+size_t mesh_gpu_bytes(size_t vertex_count, size_t index_count)
+{
+    return vertex_count * (sizeof(Vertex) + 3 * sizeof(float)) + index_count * sizeof(unsigned int);
+}
+
 /**
  * @brief Rysuje siatkę.
  */
@@ -95,9 +169,15 @@ void mesh_destroy(Mesh *mesh)
     glDeleteVertexArrays(1, &mesh->VAO);
     glDeleteBuffers(1, &mesh->VBO);
     glDeleteBuffers(1, &mesh->EBO);
+    if (mesh->depthVAO)
+        glDeleteVertexArrays(1, &mesh->depthVAO);
+    if (mesh->positionVBO)
+        glDeleteBuffers(1, &mesh->positionVBO);
 
     mesh->VAO = 0;
     mesh->VBO = 0;
     mesh->EBO = 0;
+    mesh->depthVAO = 0;
+    mesh->positionVBO = 0;
     mesh->index_count = 0;
 }
@@ -1,4 +1,5 @@
 #pragma once
+#include <stddef.h>
 #include <glad/glad.h>
 
 /**
@@ -20,23 +21,33 @@ typedef struct Vertex {
  *
  * Przechowuje:
  *  - bufory OpenGL (VAO, VBO, EBO)
+ *  - opcjonalnie osobny strumień samych pozycji (12 bajtów na wierzchołek)
+ *    z własnym VAO dla przebiegu samej głębi — bez pobierania normalnych i UV
  *  - liczbę indeksów potrzebną do rysowania
  */
 typedef struct Mesh {
     GLuint VAO;
     GLuint VBO;
     GLuint EBO;
+    GLuint depthVAO;    // location 0 -> positionVBO, ten sam EBO (0 = bez strumienia pozycji)
+    GLuint positionVBO; // vec3 ciasno upakowane
     unsigned int index_count;
 } Mesh;
 
 /**
- * @brief Tworzy siatkę GPU z tablic wierzchołków i indeksów.
+ * @brief Tworzy siatkę GPU z tablic wierzchołków i indeksów (ze strumieniem pozycji).
+ *
+ * mesh_create_ex(..., 1).
  *
  * @param vertices      Tablica wierzchołków.
  * @param vertex_count  Liczba wierzchołków.
  * @param indices       Tablica indeksów.
  * @param index_count   Liczba indeksów.
  * @return Mesh gotowy do rysowania przez glDrawElements.
+ *
+ * @note vertices/indices == NULL rezerwuje tylko pamięć buforów
+ *       (dane można dosłać później przez glBufferSubData,
+ *       pozycje przez mesh_upload_positions()).
  */
 Mesh mesh_create(
     const Vertex* vertices,
@@ -45,6 +56,39 @@ Mesh mesh_create(
     unsigned int index_count
 );
 
+/**
+ * @brief Jak mesh_create(), strumień pozycji tylko na życzenie.
+ *
+ * Siatki, które nie idą do przebiegu głębi (np. chunki OctreePager),
+ * nie płacą za drugi bufor wierzchołków.
+ *
+ * @param positions 1 -> positionVBO i depthVAO (przebieg głębi), 0 -> bez.
+ */
+Mesh mesh_create_ex(
+    const Vertex* vertices,
+    unsigned int vertex_count,
+    const unsigned int* indices,
+    unsigned int index_count,
+    int positions
+);
+
+/**
+ * @brief Wypełnia fragment strumienia pozycji z tablicy wierzchołków.
+ *
+ * Bez strumienia pozycji (mesh_create_ex(..., 0)) nic nie robi.
+ *
+ * @param mesh     Siatka.
+ * @param vertices Wierzchołki first..first+count-1.
+ * @param first    Pierwszy wierzchołek.
+ * @param count    Liczba wierzchołków.
+ */
+void mesh_upload_positions(const Mesh* mesh, const Vertex* vertices, unsigned int first, unsigned int count);
+
+/**
+ * @brief Pamięć GPU siatki z mesh_create() (bufory wierzchołków, pozycji i indeksów) w bajtach.
+ */
+size_t mesh_gpu_bytes(size_t vertex_count, size_t index_count);
+
 /**
  * @brief Rysuje siatkę przy użyciu glDrawElements.
  *
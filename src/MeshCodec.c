@@ -0,0 +1,1005 @@
+#include "MeshCodec.h"
+#include "MappedFile.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MESH_CODEC_SIMD 1
+#include <emmintrin.h>
+#endif
+
+#define CODEC_BLOCK 16         // elementy w bloku (wierzchołki / indeksy)
+#define CODEC_VERTEX_PLANES 16 // 8 liczb 16-bit na wierzchołek
+#define CODEC_INDEX_PLANES 4   // indeks 32-bit
+#define CODEC_LANES 8
+
+#define TIPSIFY_CACHE 16 // rozmiar cache zakładany przy przestawianiu trójkątów
+#define ACMR_CACHE 32    // FIFO do pomiaru (typowy post-transform cache)
+
+// liczby w wierzchołku: pozycja, UV, normalna oktaedryczna, pusta
+enum
+{
+    LANE_PX,
+    LANE_PY,
+    LANE_PZ,
+    LANE_U,
+    LANE_V,
+    LANE_NX,
+    LANE_NY,
+    LANE_PAD
+};
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+}
+
+/**
+ * @brief Kolejność płaszczyzn w bloku: odwrócone bity numeru bajtu.
+ *
+ * Transpozycja 16x16 w dekoderze (4 rundy unpack lo/hi na parach k, k+8)
+ * oddaje wiersze z bajtami w odwróconej kolejności bitów, więc koder
+ * zapisuje płaszczyzny już przestawione i dekoder czyta je po kolei.
+ */
+static const unsigned char g_plane_order[CODEC_VERTEX_PLANES] = {
+    0, 8, 4, 12, 2, 10, 6, 14, 1, 9, 5, 13, 3, 11, 7, 15};
+
+/* =========================================================
+   Przestawienie trójkątów (Tipsify) i wierzchołków
+   ========================================================= */
+
+/**
+ * @brief Średnia liczba chybień cache FIFO na trójkąt (ACMR).
+ */
+static float measure_acmr(const unsigned int *indices, size_t index_count, size_t vertex_count)
+{
+    if (index_count < 3)
+        return 0.0f;
+
+    size_t *stamp = (size_t *)calloc(vertex_count, sizeof(size_t));
+    if (!stamp)
+        return 0.0f;
+
+    // chybienie: wierzchołek wypadł z FIFO (ACMR_CACHE chybień temu albo dawniej)
+    size_t time = ACMR_CACHE + 1, misses = 0;
+    for (size_t i = 0; i < index_count; i++)
+    {
+        unsigned int v = indices[i];
+        if (time - stamp[v] > ACMR_CACHE)
+        {
+            stamp[v] = time++;
+            misses++;
+        }
+    }
+
+    free(stamp);
+    return (float)misses / (float)(index_count / 3);
+}
+
+typedef struct Tipsify
+{
+    const unsigned int *indices;
+    size_t *adj_start; // CSR: trójkąty wierzchołka (vertex_count + 1)
+    uint32_t *adj;
+    int *live;         // nieodesłane trójkąty wierzchołka w bieżącym zakresie
+    size_t *stamp;     // czas wejścia do cache
+    unsigned char *emitted;
+    uint32_t *dead;    // stos wierzchołków do powrotu po ślepym zaułku
+    uint32_t *cand;    // kandydaci na następny wachlarz
+    size_t time;
+} Tipsify;
+
+/**
+ * @brief Następny wierzchołek wachlarza po ślepym zaułku.
+ *
+ * Najpierw ostatnio użyte wierzchołki ze stosu, potem pierwszy
+ * nieodesłany trójkąt zakresu (kursor tylko rośnie).
+ */
+static int64_t tipsify_skip_dead_end(Tipsify *t, size_t *dead_count, size_t *cursor, size_t t1)
+{
+    while (*dead_count > 0)
+    {
+        uint32_t d = t->dead[--*dead_count];
+        if (t->live[d] > 0)
+            return d;
+    }
+    while (*cursor < t1)
+    {
+        size_t tri = (*cursor)++;
+        if (!t->emitted[tri])
+            return t->indices[tri * 3];
+    }
+    return -1;
+}
+
+/**
+ * @brief Tipsify (Sander, Nehab, Barczak 2007) dla trójkątów [t0, t1).
+ *
+ * Emituje wachlarze wokół kolejnych wierzchołków; następny wierzchołek
+ * to kandydat, który będzie jeszcze w cache po odesłaniu swoich trójkątów.
+ */
+static void tipsify_range(Tipsify *t, size_t t0, size_t t1, unsigned int *out)
+{
+    for (size_t tri = t0; tri < t1; tri++)
+        for (int k = 0; k < 3; k++)
+            t->live[t->indices[tri * 3 + k]]++;
+
+    size_t dead_count = 0, cursor = t0;
+    int64_t fan = t0 < t1 ? (int64_t)t->indices[t0 * 3] : -1;
+
+    while (fan >= 0)
+    {
+        size_t cand_count = 0;
+        uint32_t f = (uint32_t)fan;
+
+        for (size_t a = t->adj_start[f]; a < t->adj_start[f + 1]; a++)
+        {
+            uint32_t tri = t->adj[a];
+            if (tri < t0 || tri >= t1 || t->emitted[tri])
+                continue;
+
+            for (int k = 0; k < 3; k++)
+            {
+                unsigned int v = t->indices[(size_t)tri * 3 + k];
+                *out++ = v;
+                t->dead[dead_count++] = v;
+                t->cand[cand_count++] = v;
+                t->live[v]--;
+                if (t->time - t->stamp[v] > TIPSIFY_CACHE)
+                    t->stamp[v] = t->time++;
+            }
+            t->emitted[tri] = 1;
+        }
+
+        // kandydat, który przeżyje w cache emisję swoich trójkątów; najstarszy wygrywa
+        int64_t best = -1;
+        size_t best_priority = 0;
+        for (size_t c = 0; c < cand_count; c++)
+        {
+            uint32_t v = t->cand[c];
+            if (t->live[v] <= 0)
+                continue;
+
+            size_t priority = 0;
+            size_t age = t->time - t->stamp[v];
+            if (age + 2 * (size_t)t->live[v] <= TIPSIFY_CACHE)
+                priority = age;
+            if (best < 0 || priority > best_priority)
+            {
+                best = v;
+                best_priority = priority;
+            }
+        }
+
+        fan = best >= 0 ? best : tipsify_skip_dead_end(t, &dead_count, &cursor, t1);
+    }
+}
+
+/**
+ * @brief Przestawia trójkąty każdego zakresu usemtl pod cache wierzchołków.
+ *
+ * @return 1 jeśli OK, 0 jeśli błąd alokacji (indeksy bez zmian).
+ */
+static int reorder_triangles(unsigned int *indices, size_t index_count, size_t vertex_count,
+                             const ObjSubmesh *subs, size_t sub_count)
+{
+    size_t tri_count = index_count / 3;
+    Tipsify t = {0};
+    t.indices = indices;
+    t.adj_start = (size_t *)calloc(vertex_count + 1, sizeof(size_t));
+    t.adj = (uint32_t *)malloc(tri_count * 3 * sizeof(uint32_t));
+    t.live = (int *)calloc(vertex_count, sizeof(int));
+    t.stamp = (size_t *)calloc(vertex_count, sizeof(size_t));
+    t.emitted = (unsigned char *)calloc(tri_count, 1);
+    t.dead = (uint32_t *)malloc(tri_count * 3 * sizeof(uint32_t));
+    t.cand = (uint32_t *)malloc(tri_count * 3 * sizeof(uint32_t));
+    unsigned int *out = (unsigned int *)malloc(tri_count * 3 * sizeof(unsigned int));
+    int ok = t.adj_start && t.adj && t.live && t.stamp && t.emitted && t.dead && t.cand && out;
+
+    if (ok)
+    {
+        // trójkąty spoza zakresów usemtl zostają na miejscu
+        memcpy(out, indices, tri_count * 3 * sizeof(unsigned int));
+        for (size_t i = 0; i < tri_count * 3; i++)
+            t.adj_start[indices[i] + 1]++;
+        for (size_t v = 0; v < vertex_count; v++)
+            t.adj_start[v + 1] += t.adj_start[v];
+
+        // trójkąty wierzchołka rosnąco (kursor zapisu = początek listy + wypełnienie)
+        size_t *fill = t.stamp;
+        for (size_t tri = 0; tri < tri_count; tri++)
+            for (int k = 0; k < 3; k++)
+            {
+                unsigned int v = indices[tri * 3 + k];
+                t.adj[t.adj_start[v] + fill[v]++] = (uint32_t)tri;
+            }
+        memset(t.stamp, 0, vertex_count * sizeof(size_t));
+        t.time = TIPSIFY_CACHE + 1;
+
+        if (sub_count == 0)
+        {
+            tipsify_range(&t, 0, tri_count, out);
+        }
+        else
+        {
+            for (size_t s = 0; s < sub_count; s++)
+            {
+                size_t t0 = subs[s].index_offset / 3;
+                tipsify_range(&t, t0, t0 + subs[s].index_count / 3, out + subs[s].index_offset);
+            }
+        }
+        memcpy(indices, out, tri_count * 3 * sizeof(unsigned int));
+    }
+
+    free(t.adj_start);
+    free(t.adj);
+    free(t.live);
+    free(t.stamp);
+    free(t.emitted);
+    free(t.dead);
+    free(t.cand);
+    free(out);
+    return ok;
+}
+
+/**
+ * @brief Numeruje wierzchołki w kolejności pierwszego użycia (nieużywane odpadają).
+ *
+ * Sąsiednie wierzchołki strumienia leżą wtedy blisko siebie, więc
+ * delty pozycji są małe, a indeksy rosną prawie zawsze o 0..kilka.
+ *
+ * @param dst_count Wyjście: liczba wierzchołków po przestawieniu.
+ * @return 1 jeśli OK, 0 jeśli błąd alokacji.
+ */
+static int reorder_vertices(const Vertex *src, size_t vertex_count, unsigned int *indices,
+                            size_t index_count, Vertex *dst, size_t *dst_count)
+{
+    uint32_t *remap = (uint32_t *)malloc((vertex_count ? vertex_count : 1) * sizeof(uint32_t));
+    if (!remap)
+        return 0;
+    memset(remap, 0xFF, vertex_count * sizeof(uint32_t));
+
+    size_t next = 0;
+    for (size_t i = 0; i < index_count; i++)
+    {
+        unsigned int v = indices[i];
+        if (remap[v] == UINT32_MAX)
+        {
+            remap[v] = (uint32_t)next;
+            dst[next++] = src[v];
+        }
+        indices[i] = remap[v];
+    }
+
+    free(remap);
+    *dst_count = next;
+    return 1;
+}
+
+/* =========================================================
+   Kwantyzacja
+   ========================================================= */
+
+static uint16_t quantize_unorm(float v, float lo, float extent)
+{
+    if (extent <= 0.0f)
+        return 0;
+    float t = (v - lo) / extent;
+    t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+    return (uint16_t)(t * 65535.0f + 0.5f);
+}
+
+static int16_t quantize_snorm(float v)
+{
+    v = v < -1.0f ? -1.0f : (v > 1.0f ? 1.0f : v);
+    return (int16_t)lrintf(v * 32767.0f);
+}
+
+/**
+ * @brief Normalna -> współrzędne oktaedryczne w [-1, 1]^2.
+ */
+static void oct_encode(const float n[3], float out[2])
+{
+    float l1 = fabsf(n[0]) + fabsf(n[1]) + fabsf(n[2]);
+    if (l1 <= 0.0f)
+    {
+        out[0] = out[1] = 0.0f;
+        return;
+    }
+
+    float x = n[0] / l1, y = n[1] / l1;
+    if (n[2] < 0.0f)
+    {
+        float ox = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float oy = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = ox;
+        y = oy;
+    }
+    out[0] = x;
+    out[1] = y;
+}
+
+static void oct_decode(float x, float y, float out[3])
+{
+    float z = 1.0f - fabsf(x) - fabsf(y);
+    if (z < 0.0f)
+    {
+        float ox = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float oy = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = ox;
+        y = oy;
+    }
+    float inv = 1.0f / sqrtf(x * x + y * y + z * z);
+    out[0] = x * inv;
+    out[1] = y * inv;
+    out[2] = z * inv;
+}
+
+/**
+ * @brief Skale dekwantyzacji (wspólne dla kodera i dekodera).
+ */
+typedef struct CodecScale
+{
+    float offset[5]; // px, py, pz, u, v
+    float step[5];
+} CodecScale;
+
+static CodecScale codec_scale(const MeshCodecHeader *h)
+{
+    CodecScale s;
+    for (int k = 0; k < 3; k++)
+    {
+        s.offset[k] = h->bmin[k];
+        s.step[k] = (h->bmax[k] - h->bmin[k]) / 65535.0f;
+    }
+    for (int k = 0; k < 2; k++)
+    {
+        s.offset[3 + k] = h->uvmin[k];
+        s.step[3 + k] = (h->uvmax[k] - h->uvmin[k]) / 65535.0f;
+    }
+    return s;
+}
+
+static void quantize_vertex(const Vertex *v, const MeshCodecHeader *h, uint16_t q[CODEC_LANES])
+{
+    float oct[2];
+    oct_encode(v->normal, oct);
+
+    for (int k = 0; k < 3; k++)
+        q[LANE_PX + k] = quantize_unorm(v->position[k], h->bmin[k], h->bmax[k] - h->bmin[k]);
+    for (int k = 0; k < 2; k++)
+        q[LANE_U + k] = quantize_unorm(v->texcoord[k], h->uvmin[k], h->uvmax[k] - h->uvmin[k]);
+    q[LANE_NX] = (uint16_t)quantize_snorm(oct[0]);
+    q[LANE_NY] = (uint16_t)quantize_snorm(oct[1]);
+    q[LANE_PAD] = 0;
+}
+
+static void dequantize_vertex(const uint16_t q[CODEC_LANES], const CodecScale *s, Vertex *v)
+{
+    for (int k = 0; k < 3; k++)
+        v->position[k] = s->offset[k] + (float)q[LANE_PX + k] * s->step[k];
+    for (int k = 0; k < 2; k++)
+        v->texcoord[k] = s->offset[3 + k] + (float)q[LANE_U + k] * s->step[3 + k];
+    oct_decode((float)(int16_t)q[LANE_NX] * (1.0f / 32767.0f),
+               (float)(int16_t)q[LANE_NY] * (1.0f / 32767.0f), v->normal);
+}
+
+/* =========================================================
+   Strumień bajtów: grupy 16 bajtów na 0/2/4/8 bitach
+   ========================================================= */
+
+static const size_t g_group_bytes[4] = {0, 4, 8, 16};
+
+static uint16_t zigzag16(uint16_t d)
+{
+    return (uint16_t)((d << 1) ^ (uint16_t)((int16_t)d >> 15));
+}
+
+static uint32_t zigzag32(uint32_t d)
+{
+    return (d << 1) ^ (uint32_t)((int32_t)d >> 31);
+}
+
+/**
+ * @brief Pakuje 16 bajtów płaszczyzny; zwraca tryb (0..3).
+ *
+ * Tryb 1: bajt i niesie wartości i, 4+i, 8+i, 12+i (po 2 bity od najmłodszych).
+ * Tryb 2: bajt i niesie wartości i (młodsza połówka) i 8+i (starsza).
+ */
+static int pack_group(const uint8_t v[CODEC_BLOCK], uint8_t **dst)
+{
+    uint8_t max = 0;
+    for (int i = 0; i < CODEC_BLOCK; i++)
+        max = v[i] > max ? v[i] : max;
+
+    uint8_t *o = *dst;
+    int mode;
+    if (max == 0)
+    {
+        mode = 0;
+    }
+    else if (max < 4)
+    {
+        mode = 1;
+        for (int i = 0; i < 4; i++)
+            o[i] = (uint8_t)(v[i] | (v[4 + i] << 2) | (v[8 + i] << 4) | (v[12 + i] << 6));
+    }
+    else if (max < 16)
+    {
+        mode = 2;
+        for (int i = 0; i < 8; i++)
+            o[i] = (uint8_t)(v[i] | (v[8 + i] << 4));
+    }
+    else
+    {
+        mode = 3;
+        memcpy(o, v, CODEC_BLOCK);
+    }
+    *dst = o + g_group_bytes[mode];
+    return mode;
+}
+
+/**
+ * @brief Koduje bloki elementów (po planes bajtów) do strumienia.
+ *
+ * Blok: nagłówek (2 bity trybu na płaszczyznę), potem grupy płaszczyzn
+ * w kolejności order[]. Ostatni blok dopełniony zerami.
+ *
+ * @param elems  Elementy po zigzag(delta), elem_count * planes bajtów.
+ * @param dst    Bufor o rozmiarze co najmniej encode_bound().
+ * @return Liczba zapisanych bajtów.
+ */
+static size_t encode_blocks(const uint8_t *elems, size_t elem_count, int planes,
+                            const unsigned char *order, uint8_t *dst)
+{
+    uint8_t *o = dst;
+    for (size_t b = 0; b < elem_count; b += CODEC_BLOCK)
+    {
+        size_t n = elem_count - b < CODEC_BLOCK ? elem_count - b : CODEC_BLOCK;
+        uint8_t *header = o;
+        o += (size_t)planes / 4;
+        memset(header, 0, (size_t)planes / 4);
+
+        for (int p = 0; p < planes; p++)
+        {
+            int plane = order ? order[p] : p;
+            uint8_t group[CODEC_BLOCK] = {0};
+            for (size_t i = 0; i < n; i++)
+                group[i] = elems[(b + i) * (size_t)planes + (size_t)plane];
+
+            int mode = pack_group(group, &o);
+            header[p / 4] |= (uint8_t)(mode << ((p % 4) * 2));
+        }
+    }
+    return (size_t)(o - dst);
+}
+
+static size_t encode_bound(size_t elem_count, int planes)
+{
+    size_t blocks = (elem_count + CODEC_BLOCK - 1) / CODEC_BLOCK;
+    return blocks * ((size_t)planes / 4 + (size_t)planes * CODEC_BLOCK);
+}
+
+/**
+ * @brief Rozmiar danych bloku z nagłówka (bez samego nagłówka).
+ */
+static size_t block_payload(const uint8_t *header, int planes)
+{
+    size_t bytes = 0;
+    for (int p = 0; p < planes; p++)
+        bytes += g_group_bytes[(header[p / 4] >> ((p % 4) * 2)) & 3];
+    return bytes;
+}
+
+/* =========================================================
+   Dekoder bloku
+   ========================================================= */
+
+#ifdef MESH_CODEC_SIMD
+
+static __m128i unpack_group(const uint8_t **src, int mode)
+{
+    const uint8_t *s = *src;
+    __m128i r;
+    switch (mode)
+    {
+    case 0:
+        r = _mm_setzero_si128();
+        break;
+    case 1:
+    {
+        int32_t w;
+        memcpy(&w, s, 4);
+        __m128i x = _mm_cvtsi32_si128(w);
+        __m128i m = _mm_set1_epi8(3);
+        // przesunięcia 16-bit przenoszą bity sąsiedniego bajtu tylko do bitów maskowanych
+        __m128i a = _mm_and_si128(x, m);
+        __m128i b = _mm_and_si128(_mm_srli_epi16(x, 2), m);
+        __m128i c = _mm_and_si128(_mm_srli_epi16(x, 4), m);
+        __m128i d = _mm_and_si128(_mm_srli_epi16(x, 6), m);
+        r = _mm_unpacklo_epi64(_mm_unpacklo_epi32(a, b), _mm_unpacklo_epi32(c, d));
+        break;
+    }
+    case 2:
+    {
+        __m128i x = _mm_loadl_epi64((const __m128i *)s);
+        __m128i m = _mm_set1_epi8(15);
+        r = _mm_unpacklo_epi64(_mm_and_si128(x, m), _mm_and_si128(_mm_srli_epi16(x, 4), m));
+        break;
+    }
+    default:
+        r = _mm_loadu_si128((const __m128i *)s);
+        break;
+    }
+    *src = s + g_group_bytes[mode];
+    return r;
+}
+
+/**
+ * @brief Płaszczyzny (w kolejności g_plane_order) -> 16 wierszy po 16 bajtów.
+ */
+static void transpose16(__m128i r[16])
+{
+    __m128i t[16];
+    for (int k = 0; k < 8; k++)
+    {
+        t[2 * k] = _mm_unpacklo_epi8(r[k], r[k + 8]);
+        t[2 * k + 1] = _mm_unpackhi_epi8(r[k], r[k + 8]);
+    }
+    for (int k = 0; k < 8; k++)
+    {
+        r[2 * k] = _mm_unpacklo_epi16(t[k], t[k + 8]);
+        r[2 * k + 1] = _mm_unpackhi_epi16(t[k], t[k + 8]);
+    }
+    for (int k = 0; k < 8; k++)
+    {
+        t[2 * k] = _mm_unpacklo_epi32(r[k], r[k + 8]);
+        t[2 * k + 1] = _mm_unpackhi_epi32(r[k], r[k + 8]);
+    }
+    for (int k = 0; k < 8; k++)
+    {
+        r[2 * k] = _mm_unpacklo_epi64(t[k], t[k + 8]);
+        r[2 * k + 1] = _mm_unpackhi_epi64(t[k], t[k + 8]);
+    }
+}
+
+/**
+ * @brief Dekoduje blok 16 wierzchołków; state = poprzedni wierzchołek (8 x 16 bit).
+ */
+static void decode_vertex_block(const uint8_t **src, __m128i *state, const CodecScale *s,
+                                Vertex *out, size_t n)
+{
+    const uint8_t *header = *src;
+    const uint8_t *p = header + CODEC_VERTEX_PLANES / 4;
+    __m128i r[16];
+    for (int k = 0; k < CODEC_VERTEX_PLANES; k++)
+        r[k] = unpack_group(&p, (header[k / 4] >> ((k % 4) * 2)) & 3);
+    *src = p;
+
+    transpose16(r);
+
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 step = _mm_setr_ps(s->step[0], s->step[1], s->step[2], s->step[3]);
+    const __m128 offset = _mm_setr_ps(s->offset[0], s->offset[1], s->offset[2], s->offset[3]);
+    const __m128 snorm = _mm_set1_ps(1.0f / 32767.0f);
+    __m128i q = *state;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        // zigzag -> delta, suma z poprzednim wierzchołkiem na 8 liczbach naraz
+        __m128i z = r[i];
+        __m128i d = _mm_xor_si128(_mm_srli_epi16(z, 1), _mm_sub_epi16(zero, _mm_and_si128(z, one)));
+        q = _mm_add_epi16(q, d);
+
+        // px py pz u (bez znaku) oraz v nx ny (nx, ny ze znakiem)
+        __m128 lo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(q, zero));
+        __m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(zero, q), 16));
+        float f[4], g[4];
+        _mm_storeu_ps(f, _mm_add_ps(_mm_mul_ps(lo, step), offset));
+        _mm_storeu_ps(g, _mm_mul_ps(hi, snorm));
+
+        Vertex *v = &out[i];
+        v->position[0] = f[0];
+        v->position[1] = f[1];
+        v->position[2] = f[2];
+        v->texcoord[0] = f[3];
+        v->texcoord[1] = s->offset[4] + (float)(uint16_t)_mm_extract_epi16(q, LANE_V) * s->step[4];
+        oct_decode(g[1], g[2], v->normal);
+    }
+    *state = q;
+}
+
+/**
+ * @brief Dekoduje blok 16 indeksów; prev = ostatni indeks (w każdym pasie).
+ */
+static void decode_index_block(const uint8_t **src, __m128i *prev, unsigned int *out, size_t n)
+{
+    const uint8_t *header = *src;
+    const uint8_t *p = header + 1;
+    __m128i b0 = unpack_group(&p, header[0] & 3);
+    __m128i b1 = unpack_group(&p, (header[0] >> 2) & 3);
+    __m128i b2 = unpack_group(&p, (header[0] >> 4) & 3);
+    __m128i b3 = unpack_group(&p, (header[0] >> 6) & 3);
+    *src = p;
+
+    __m128i l01 = _mm_unpacklo_epi8(b0, b1), h01 = _mm_unpackhi_epi8(b0, b1);
+    __m128i l23 = _mm_unpacklo_epi8(b2, b3), h23 = _mm_unpackhi_epi8(b2, b3);
+    __m128i z[4] = {
+        _mm_unpacklo_epi16(l01, l23), _mm_unpackhi_epi16(l01, l23),
+        _mm_unpacklo_epi16(h01, h23), _mm_unpackhi_epi16(h01, h23)};
+
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i base = *prev;
+    unsigned int tmp[CODEC_BLOCK];
+    unsigned int *dst = n == CODEC_BLOCK ? out : tmp;
+
+    for (int k = 0; k < 4; k++)
+    {
+        __m128i d = _mm_xor_si128(_mm_srli_epi32(z[k], 1), _mm_sub_epi32(zero, _mm_and_si128(z[k], one)));
+        // suma prefiksowa w 4 pasach + ostatni indeks poprzedniej czwórki
+        d = _mm_add_epi32(d, _mm_slli_si128(d, 4));
+        d = _mm_add_epi32(d, _mm_slli_si128(d, 8));
+        d = _mm_add_epi32(d, base);
+        base = _mm_shuffle_epi32(d, 0xFF);
+        _mm_storeu_si128((__m128i *)(dst + k * 4), d);
+    }
+
+    if (dst == tmp)
+    {
+        memcpy(out, tmp, n * sizeof(unsigned int));
+        base = _mm_set1_epi32((int)tmp[n - 1]);
+    }
+    *prev = base;
+}
+
+#else
+
+static void unpack_group(const uint8_t **src, int mode, uint8_t v[CODEC_BLOCK])
+{
+    const uint8_t *s = *src;
+    switch (mode)
+    {
+    case 0:
+        memset(v, 0, CODEC_BLOCK);
+        break;
+    case 1:
+        for (int i = 0; i < 4; i++)
+        {
+            v[i] = s[i] & 3;
+            v[4 + i] = (s[i] >> 2) & 3;
+            v[8 + i] = (s[i] >> 4) & 3;
+            v[12 + i] = (s[i] >> 6) & 3;
+        }
+        break;
+    case 2:
+        for (int i = 0; i < 8; i++)
+        {
+            v[i] = s[i] & 15;
+            v[8 + i] = s[i] >> 4;
+        }
+        break;
+    default:
+        memcpy(v, s, CODEC_BLOCK);
+        break;
+    }
+    *src = s + g_group_bytes[mode];
+}
+
+static void decode_vertex_block(const uint8_t **src, uint16_t state[CODEC_LANES], const CodecScale *s,
+                                Vertex *out, size_t n)
+{
+    const uint8_t *header = *src;
+    const uint8_t *p = header + CODEC_VERTEX_PLANES / 4;
+    uint8_t planes[CODEC_VERTEX_PLANES][CODEC_BLOCK];
+    for (int k = 0; k < CODEC_VERTEX_PLANES; k++)
+        unpack_group(&p, (header[k / 4] >> ((k % 4) * 2)) & 3, planes[g_plane_order[k]]);
+    *src = p;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        for (int l = 0; l < CODEC_LANES; l++)
+        {
+            uint16_t z = (uint16_t)(planes[2 * l][i] | (planes[2 * l + 1][i] << 8));
+            state[l] = (uint16_t)(state[l] + ((z >> 1) ^ (uint16_t)-(z & 1)));
+        }
+        dequantize_vertex(state, s, &out[i]);
+    }
+}
+
+static void decode_index_block(const uint8_t **src, uint32_t *prev, unsigned int *out, size_t n)
+{
+    const uint8_t *header = *src;
+    const uint8_t *p = header + 1;
+    uint8_t planes[CODEC_INDEX_PLANES][CODEC_BLOCK];
+    for (int k = 0; k < CODEC_INDEX_PLANES; k++)
+        unpack_group(&p, (header[0] >> (k * 2)) & 3, planes[k]);
+    *src = p;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        uint32_t z = planes[0][i] | (planes[1][i] << 8) | (planes[2][i] << 16) | ((uint32_t)planes[3][i] << 24);
+        *prev += (z >> 1) ^ (uint32_t)-(int32_t)(z & 1);
+        out[i] = *prev;
+    }
+}
+
+#endif
+
+/* =========================================================
+   API
+   ========================================================= */
+
+int mesh_codec_encode(const ObjModelData *data, void **out, size_t *size, MeshCodecStats *stats)
+{
+    double t0 = now_ms();
+    size_t vcount = data->vertex_count, icount = data->index_count;
+    if (vcount > UINT32_MAX || icount > UINT32_MAX || data->submesh_count > UINT32_MAX)
+    {
+        printf("ERROR: mesh too large for .omc\n");
+        return 0;
+    }
+
+    unsigned int *indices = (unsigned int *)malloc((icount ? icount : 1) * sizeof(unsigned int));
+    Vertex *vertices = (Vertex *)malloc((vcount ? vcount : 1) * sizeof(Vertex));
+    uint16_t *quant = (uint16_t *)malloc((vcount ? vcount : 1) * CODEC_LANES * sizeof(uint16_t));
+    uint32_t *zidx = (uint32_t *)malloc((icount ? icount : 1) * sizeof(uint32_t));
+    if (!indices || !vertices || !quant || !zidx)
+    {
+        free(indices);
+        free(vertices);
+        free(quant);
+        free(zidx);
+        return 0;
+    }
+    memcpy(indices, data->indices, icount * sizeof(unsigned int));
+
+    MeshCodecStats st = {0};
+    st.raw_bytes = vcount * sizeof(Vertex) + icount * sizeof(unsigned int);
+    st.acmr_before = measure_acmr(indices, icount, vcount);
+    reorder_triangles(indices, icount, vcount, data->submeshes, data->submesh_count);
+    st.acmr_after = measure_acmr(indices, icount, vcount);
+    if (!reorder_vertices(data->vertices, vcount, indices, icount, vertices, &vcount))
+    {
+        free(indices);
+        free(vertices);
+        free(quant);
+        free(zidx);
+        return 0;
+    }
+
+    MeshCodecHeader h;
+    memset(&h, 0, sizeof(h));
+    h.magic = MESH_CODEC_MAGIC;
+    h.version = MESH_CODEC_VERSION;
+    h.vertex_count = (uint32_t)vcount;
+    h.index_count = (uint32_t)icount;
+    h.submesh_count = (uint32_t)data->submesh_count;
+    for (int k = 0; k < 3; k++)
+    {
+        h.bmin[k] = vcount ? vertices[0].position[k] : 0.0f;
+        h.bmax[k] = h.bmin[k];
+    }
+    for (int k = 0; k < 2; k++)
+        h.uvmin[k] = h.uvmax[k] = vcount ? vertices[0].texcoord[k] : 0.0f;
+    for (size_t i = 0; i < vcount; i++)
+    {
+        for (int k = 0; k < 3; k++)
+        {
+            h.bmin[k] = fminf(h.bmin[k], vertices[i].position[k]);
+            h.bmax[k] = fmaxf(h.bmax[k], vertices[i].position[k]);
+        }
+        for (int k = 0; k < 2; k++)
+        {
+            h.uvmin[k] = fminf(h.uvmin[k], vertices[i].texcoord[k]);
+            h.uvmax[k] = fmaxf(h.uvmax[k], vertices[i].texcoord[k]);
+        }
+    }
+
+    // kwantyzacja, błąd pozycji, potem zigzag(delta) w miejscu
+    CodecScale sc = codec_scale(&h);
+    uint16_t prev[CODEC_LANES] = {0};
+    for (size_t i = 0; i < vcount; i++)
+    {
+        uint16_t *q = quant + i * CODEC_LANES;
+        Vertex back;
+        quantize_vertex(&vertices[i], &h, q);
+        dequantize_vertex(q, &sc, &back);
+        for (int k = 0; k < 3; k++)
+        {
+            float e = fabsf(back.position[k] - vertices[i].position[k]);
+            st.max_position_error = e > st.max_position_error ? e : st.max_position_error;
+        }
+        for (int l = 0; l < CODEC_LANES; l++)
+        {
+            uint16_t cur = q[l];
+            q[l] = zigzag16((uint16_t)(cur - prev[l]));
+            prev[l] = cur;
+        }
+    }
+
+    uint32_t prev_index = 0;
+    for (size_t i = 0; i < icount; i++)
+    {
+        zidx[i] = zigzag32(indices[i] - prev_index);
+        prev_index = indices[i];
+    }
+
+    size_t head = sizeof(MeshCodecHeader) + data->submesh_count * sizeof(MeshCodecSubmesh);
+    size_t bound = head + encode_bound(vcount, CODEC_VERTEX_PLANES) + encode_bound(icount, CODEC_INDEX_PLANES);
+    uint8_t *buf = (uint8_t *)malloc(bound);
+    if (!buf)
+    {
+        free(indices);
+        free(vertices);
+        free(quant);
+        free(zidx);
+        return 0;
+    }
+
+    h.vertex_bytes = encode_blocks((const uint8_t *)quant, vcount, CODEC_VERTEX_PLANES, g_plane_order, buf + head);
+    h.index_bytes = encode_blocks((const uint8_t *)zidx, icount, CODEC_INDEX_PLANES, NULL,
+                                  buf + head + h.vertex_bytes);
+    memcpy(buf, &h, sizeof(h));
+    for (size_t s = 0; s < data->submesh_count; s++)
+    {
+        MeshCodecSubmesh ms;
+        memset(&ms, 0, sizeof(ms));
+        memcpy(ms.material, data->submeshes[s].material, OBJ_MATERIAL_NAME);
+        ms.index_offset = (uint32_t)data->submeshes[s].index_offset;
+        ms.index_count = (uint32_t)data->submeshes[s].index_count;
+        memcpy(buf + sizeof(h) + s * sizeof(ms), &ms, sizeof(ms));
+    }
+
+    free(indices);
+    free(vertices);
+    free(quant);
+    free(zidx);
+
+    *out = buf;
+    *size = head + h.vertex_bytes + h.index_bytes;
+    st.packed_bytes = *size;
+    st.ms = now_ms() - t0;
+    if (stats)
+        *stats = st;
+    return 1;
+}
+
+const MeshCodecHeader *mesh_codec_header(const void *buf, size_t size)
+{
+    const MeshCodecHeader *h = (const MeshCodecHeader *)buf;
+    if (!buf || size < sizeof(*h) || h->magic != MESH_CODEC_MAGIC || h->version != MESH_CODEC_VERSION)
+        return NULL;
+
+    uint64_t need = sizeof(*h) + (uint64_t)h->submesh_count * sizeof(MeshCodecSubmesh);
+    if (need > size || h->vertex_bytes > size - need || h->index_bytes > size - need - h->vertex_bytes)
+        return NULL;
+    return h;
+}
+
+int mesh_codec_decode(const void *buf, size_t size, Vertex *vertices, unsigned int *indices)
+{
+    const MeshCodecHeader *h = mesh_codec_header(buf, size);
+    if (!h)
+        return 0;
+
+    const uint8_t *src = (const uint8_t *)buf + sizeof(*h) + (size_t)h->submesh_count * sizeof(MeshCodecSubmesh);
+    const uint8_t *vend = src + h->vertex_bytes;
+    const uint8_t *iend = vend + h->index_bytes;
+    CodecScale sc = codec_scale(h);
+
+#ifdef MESH_CODEC_SIMD
+    __m128i vstate = _mm_setzero_si128();
+    __m128i istate = _mm_setzero_si128();
+#else
+    uint16_t vstate[CODEC_LANES] = {0};
+    uint32_t istate = 0;
+#endif
+
+    // rozmiar bloku z nagłówka przed czytaniem, więc uszkodzony plik nie wyjdzie poza bufor
+    for (size_t i = 0; i < h->vertex_count; i += CODEC_BLOCK)
+    {
+        size_t n = h->vertex_count - i < CODEC_BLOCK ? h->vertex_count - i : CODEC_BLOCK;
+        if ((size_t)(vend - src) < CODEC_VERTEX_PLANES / 4 ||
+            block_payload(src, CODEC_VERTEX_PLANES) > (size_t)(vend - src) - CODEC_VERTEX_PLANES / 4)
+            return 0;
+#ifdef MESH_CODEC_SIMD
+        decode_vertex_block(&src, &vstate, &sc, vertices + i, n);
+#else
+        decode_vertex_block(&src, vstate, &sc, vertices + i, n);
+#endif
+    }
+    if (src != vend)
+        return 0;
+
+    for (size_t i = 0; i < h->index_count; i += CODEC_BLOCK)
+    {
+        size_t n = h->index_count - i < CODEC_BLOCK ? h->index_count - i : CODEC_BLOCK;
+        if (src >= iend || block_payload(src, CODEC_INDEX_PLANES) > (size_t)(iend - src) - 1)
+            return 0;
+        decode_index_block(&src, &istate, indices + i, n);
+    }
+    if (src != iend)
+        return 0;
+
+    // indeks poza zakresem wysypałby rysowanie, sprawdzenie kosztuje jedno przejście
+    unsigned int bad = 0;
+    for (size_t i = 0; i < h->index_count; i++)
+        bad |= indices[i] >= h->vertex_count;
+    return !bad;
+}
+
+int mesh_codec_load(const char *path, ObjModelData *out)
+{
+    memset(out, 0, sizeof(*out));
+
+    MappedFile f;
+    if (!mapped_file_open(path, &f))
+        return 0;
+
+    const MeshCodecHeader *h = mesh_codec_header(f.data, f.size);
+    if (!h)
+    {
+        printf("ERROR: not a valid .omc file: %s\n", path);
+        mapped_file_close(&f);
+        return 0;
+    }
+
+    out->vertex_count = h->vertex_count;
+    out->index_count = h->index_count;
+    out->submesh_count = h->submesh_count;
+    out->vertices = (Vertex *)malloc((out->vertex_count ? out->vertex_count : 1) * sizeof(Vertex));
+    out->indices = (unsigned int *)malloc((out->index_count ? out->index_count : 1) * sizeof(unsigned int));
+    out->submeshes = out->submesh_count ? (ObjSubmesh *)calloc(out->submesh_count, sizeof(ObjSubmesh)) : NULL;
+
+    int ok = out->vertices && out->indices && (out->submesh_count == 0 || out->submeshes);
+    if (ok)
+    {
+        const MeshCodecSubmesh *subs = (const MeshCodecSubmesh *)(f.data + sizeof(*h));
+        for (size_t s = 0; s < out->submesh_count; s++)
+        {
+            MeshCodecSubmesh ms;
+            memcpy(&ms, subs + s, sizeof(ms));
+            memcpy(out->submeshes[s].material, ms.material, OBJ_MATERIAL_NAME);
+            out->submeshes[s].material[OBJ_MATERIAL_NAME - 1] = '\0';
+            out->submeshes[s].index_offset = ms.index_offset;
+            out->submeshes[s].index_count = ms.index_count;
+            ok &= (uint64_t)ms.index_offset + ms.index_count <= h->index_count;
+        }
+    }
+    if (ok)
+        ok = mesh_codec_decode(f.data, f.size, out->vertices, out->indices);
+    if (!ok)
+    {
+        printf("ERROR: corrupt .omc file: %s\n", path);
+        obj_free(out);
+    }
+
+    mapped_file_close(&f);
+    return ok;
+}
+
+int mesh_codec_save(const char *path, const ObjModelData *data, MeshCodecStats *stats)
+{
+    void *buf;
+    size_t size;
+    if (!mesh_codec_encode(data, &buf, &size, stats))
+        return 0;
+
+    FILE *f = fopen(path, "wb");
+    int ok = f && fwrite(buf, 1, size, f) == size;
+    if (f)
+        ok &= fclose(f) == 0;
+    if (!ok)
+        printf("ERROR: cannot write %s\n", path);
+
+    free(buf);
+    return ok;
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ObjLoader.h"
+
+/**
+ * @brief Skompresowana siatka na dysku (.omc).
+ *
+ * Układ pliku:
+ *  - MeshCodecHeader,
+ *  - MeshCodecSubmesh[submesh_count] (zakresy usemtl),
+ *  - strumień wierzchołków (vertex_bytes),
+ *  - strumień indeksów (index_bytes).
+ *
+ * Kodowanie:
+ *  - trójkąty przestawione pod cache wierzchołków (Tipsify, w obrębie
+ *    każdego zakresu usemtl), wierzchołki w kolejności pierwszego użycia,
+ *  - wierzchołek kwantyzowany do 8 liczb 16-bit: pozycja względem AABB,
+ *    normalna oktaedryczna, UV względem zakresu UV (ostatnia pusta),
+ *  - każda liczba to zigzag(delta) względem poprzedniego wierzchołka,
+ *    indeksy to zigzag(delta) względem poprzedniego indeksu,
+ *  - bajty transponowane (płaszczyzna = ten sam bajt kolejnych elementów)
+ *    w blokach po 16 elementów,
+ *  - etap entropijny: każda 16-bajtowa grupa płaszczyzny zapisana na
+ *    0, 2, 4 albo 8 bitach na bajt (2-bitowy nagłówek grupy).
+ *    Dekoder rozpakowuje grupę, transponuje blok i sumuje delty
+ *    na rejestrach SSE2, bez rozgałęzień na bajt.
+ */
+
+#define MESH_CODEC_MAGIC 0x31434D4Fu /* "OMC1" */
+#define MESH_CODEC_VERSION 1u
+
+typedef struct MeshCodecHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vertex_count;
+    uint32_t index_count;
+    uint32_t submesh_count;
+    uint32_t reserved;
+    float bmin[3], bmax[3];   // AABB pozycji (kwantyzacja)
+    float uvmin[2], uvmax[2]; // zakres UV (kwantyzacja)
+    uint64_t vertex_bytes;
+    uint64_t index_bytes;
+} MeshCodecHeader;
+
+typedef struct MeshCodecSubmesh
+{
+    char material[OBJ_MATERIAL_NAME];
+    uint32_t index_offset;
+    uint32_t index_count;
+} MeshCodecSubmesh;
+
+/**
+ * @brief Wynik kodowania (do logów / benchmarku).
+ */
+typedef struct MeshCodecStats
+{
+    size_t raw_bytes;    // Vertex[] + uint32[]
+    size_t packed_bytes; // cały plik .omc
+    float acmr_before;   // średnia liczba chybień cache (32 wpisy FIFO) na trójkąt
+    float acmr_after;
+    float max_position_error; // po kwantyzacji, w jednostkach modelu
+    double ms;
+} MeshCodecStats;
+
+/**
+ * @brief Koduje model do bufora w formacie .omc.
+ *
+ * Model nie jest zmieniany (przestawienie idzie na kopii).
+ *
+ * @param data  Model (np. z obj_load()).
+ * @param out   Wyjście: bufor z malloc (zwalnia wołający).
+ * @param size  Wyjście: rozmiar bufora.
+ * @param stats Statystyki (może być NULL).
+ * @return 1 jeśli OK, 0 jeśli błąd alokacji lub model za duży.
+ */
+int mesh_codec_encode(const ObjModelData *data, void **out, size_t *size, MeshCodecStats *stats);
+
+/**
+ * @brief Sprawdza nagłówek i rozmiary strumieni.
+ *
+ * @param buf  Zawartość pliku .omc.
+ * @param size Rozmiar.
+ * @return Nagłówek w buforze albo NULL, jeśli plik jest niepoprawny.
+ */
+const MeshCodecHeader *mesh_codec_header(const void *buf, size_t size);
+
+/**
+ * @brief Dekoduje strumienie prosto do tablic dla mesh_create().
+ *
+ * @param buf      Zawartość pliku .omc (po mesh_codec_header()).
+ * @param size     Rozmiar.
+ * @param vertices Wyjście: header->vertex_count wierzchołków.
+ * @param indices  Wyjście: header->index_count indeksów.
+ * @return 1 jeśli OK, 0 jeśli strumień jest uszkodzony.
+ */
+int mesh_codec_decode(const void *buf, size_t size, Vertex *vertices, unsigned int *indices);
+
+/**
+ * @brief Wczytuje plik .omc do ObjModelData (z zakresami usemtl).
+ *
+ * @param path Ścieżka.
+ * @param out  Wynik (zwalniany przez obj_free()).
+ * @return 1 jeśli OK, 0 jeśli błąd.
+ */
+int mesh_codec_load(const char *path, ObjModelData *out);
+
+/**
+ * @brief Zapisuje model do pliku .omc.
+ *
+ * @return 1 jeśli OK, 0 jeśli błąd.
+ */
+int mesh_codec_save(const char *path, const ObjModelData *data, MeshCodecStats *stats);
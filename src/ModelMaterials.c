@@ -0,0 +1,418 @@
+#include "ModelMaterials.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Zakres indeksów z przypisanym materiałem i kluczem sortowania.
+ */
+typedef struct MaterialRange
+{
+    unsigned long long key;
+    size_t index_offset;
+    size_t index_count;
+    int material;
+    int array;
+} MaterialRange;
+
+static int cmp_range(const void *a, const void *b)
+{
+    const MaterialRange *x = (const MaterialRange *)a, *y = (const MaterialRange *)b;
+    if (x->key != y->key)
+        return x->key < y->key ? -1 : 1;
+    // kolejność z pliku w obrębie klucza
+    return (x->index_offset > y->index_offset) - (x->index_offset < y->index_offset);
+}
+
+static int find_material(const MaterialDesc *descs, size_t count, const char *name)
+{
+    for (size_t i = 0; i < count; i++)
+        if (strcmp(descs[i].name, name) == 0)
+            return (int)i;
+    return -1;
+}
+
+/* =========================================================
+ * Tekstury
+ * ========================================================= */
+
+/**
+ * @brief Obraz materiału i (własny albo aliasu); pusty, jeśli brak mapy.
+ */
+static const TextureImage *material_image(const ModelMaterials *m, size_t i)
+{
+    return &m->images[m->alias[i] >= 0 ? (size_t)m->alias[i] : i];
+}
+
+static int load_classic(ModelMaterials *m)
+{
+    m->classic = (Material *)calloc(m->count, sizeof(Material));
+    if (!m->classic)
+        return 0;
+
+    for (size_t i = 0; i < m->count; i++)
+    {
+        material_init(&m->classic[i]);
+        memcpy(m->classic[i].diffuse, m->descs[i].diffuse, sizeof(m->classic[i].diffuse));
+
+        const TextureImage *img = material_image(m, i);
+        if (img->pixels)
+            m->classic[i].diffuseTex = texture_create_2d(img);
+    }
+    return 1;
+}
+
+/**
+ * @brief Pakuje tekstury i wysyła dane materiałów do bufora tekstury.
+ *
+ * Materiał = 2 texele RGBA32F: (Kd.rgb, warstwa), (skala UV, przesunięcie UV).
+ */
+static int load_packed(ModelMaterials *m)
+{
+    float *data = (float *)malloc(m->count * 8 * sizeof(float));
+    if (!data)
+        return 0;
+
+    // aliasy bez obrazu -> bez warstwy; wpis kopiowany od materiału z obrazem
+    int ok = texture_pack_build(&m->pack, m->images, m->count);
+
+    if (ok)
+    {
+        for (size_t i = 0; i < m->count; i++)
+        {
+            if (m->alias[i] >= 0)
+                m->pack.entries[i] = m->pack.entries[m->alias[i]];
+
+            const TexturePackEntry *e = &m->pack.entries[i];
+            float *t = data + i * 8;
+            t[0] = m->descs[i].diffuse[0];
+            t[1] = m->descs[i].diffuse[1];
+            t[2] = m->descs[i].diffuse[2];
+            t[3] = e->layer;
+            t[4] = e->uv_scale[0];
+            t[5] = e->uv_scale[1];
+            t[6] = e->uv_offset[0];
+            t[7] = e->uv_offset[1];
+        }
+
+        glGenBuffers(1, &m->data_buf);
+        glGenTextures(1, &m->data_tex);
+        glBindBuffer(GL_TEXTURE_BUFFER, m->data_buf);
+        glBufferData(GL_TEXTURE_BUFFER, (GLsizeiptr)(m->count * 8 * sizeof(float)), data, GL_STATIC_DRAW);
+        glBindTexture(GL_TEXTURE_BUFFER, m->data_tex);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, m->data_buf);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    }
+
+    free(data);
+    return ok;
+}
+
+/**
+ * @brief Bufor tekstury R16UI: materiał każdego trójkąta w kolejności rysowania.
+ */
+static int upload_triangle_ids(ModelMaterials *m, const MaterialRange *ranges, size_t range_count,
+                               size_t index_count)
+{
+    size_t tris = index_count / 3;
+    unsigned short *ids = (unsigned short *)malloc((tris ? tris : 1) * sizeof(unsigned short));
+    if (!ids)
+        return 0;
+
+    for (size_t r = 0; r < range_count; r++)
+    {
+        size_t first = ranges[r].index_offset / 3;
+        for (size_t t = 0; t < ranges[r].index_count / 3; t++)
+            ids[first + t] = (unsigned short)ranges[r].material;
+    }
+
+    glGenBuffers(1, &m->id_buf);
+    glGenTextures(1, &m->id_tex);
+    glBindBuffer(GL_TEXTURE_BUFFER, m->id_buf);
+    glBufferData(GL_TEXTURE_BUFFER, (GLsizeiptr)((tris ? tris : 1) * sizeof(unsigned short)), ids,
+                 GL_STATIC_DRAW);
+    glBindTexture(GL_TEXTURE_BUFFER, m->id_tex);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R16UI, m->id_buf);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    free(ids);
+    return 1;
+}
+
+/* =========================================================
+ * API
+ * ========================================================= */
+
+/**
+ * @brief Zwalnia obrazy po wysłaniu (albo przy zwalnianiu materiałów).
+ */
+static void free_images(ModelMaterials *m)
+{
+    if (m->images)
+    {
+        for (size_t i = 0; i < m->count; i++)
+            texture_image_free(&m->images[i]);
+    }
+    free(m->images);
+    free(m->alias);
+    free(m->textures);
+    m->images = NULL;
+    m->alias = NULL;
+    m->textures = NULL;
+    m->texture_count = 0;
+}
+
+int model_materials_init(ModelMaterials *m, ObjModelData *data, const char *mtl_path, int packed)
+{
+    if (!model_materials_parse(m, mtl_path, packed))
+    {
+        printf("Failed to set up materials: %s\n", mtl_path);
+        return 0;
+    }
+    for (size_t t = 0; t < m->texture_count; t++)
+        model_materials_decode(m, t);
+    if (!model_materials_upload(m, data))
+    {
+        printf("Failed to set up materials: %s\n", mtl_path);
+        return 0;
+    }
+    return 1;
+}
+
+int model_materials_parse(ModelMaterials *m, const char *mtl_path, int packed)
+{
+    memset(m, 0, sizeof(*m));
+    m->packed = packed;
+
+    size_t parsed = 0;
+    material_parse_library(mtl_path, &m->descs, &parsed);
+
+    // domyślny biały materiał dla nieznanych nazw i ścian przed pierwszym usemtl
+    MaterialDesc *grown = (MaterialDesc *)realloc(m->descs, (parsed + 1) * sizeof(MaterialDesc));
+    if (!grown)
+    {
+        model_materials_destroy(m);
+        return 0;
+    }
+    m->descs = grown;
+    memset(&m->descs[parsed], 0, sizeof(MaterialDesc));
+    m->descs[parsed].diffuse[0] = m->descs[parsed].diffuse[1] = m->descs[parsed].diffuse[2] = 1.0f;
+    m->count = parsed + 1;
+
+    if (packed && m->count > 65535)
+    {
+        printf("Too many materials for packed rendering (%zu), using per-material textures\n", m->count);
+        m->packed = 0;
+    }
+
+    m->images = (TextureImage *)calloc(m->count, sizeof(TextureImage));
+    m->alias = (int *)malloc(m->count * sizeof(int));
+    m->textures = (size_t *)malloc(m->count * sizeof(size_t));
+    if (!m->images || !m->alias || !m->textures)
+    {
+        model_materials_destroy(m);
+        return 0;
+    }
+
+    // ta sama mapa w kilku materiałach -> jeden obraz (i jedna warstwa w trybie upakowanym)
+    for (size_t i = 0; i < m->count; i++)
+    {
+        m->alias[i] = -1;
+        const char *path = m->descs[i].diffuseMap;
+        if (!path[0])
+            continue;
+        for (size_t j = 0; j < i && m->alias[i] < 0; j++)
+            if (strcmp(m->descs[j].diffuseMap, path) == 0)
+                m->alias[i] = m->alias[j] >= 0 ? m->alias[j] : (int)j;
+        if (m->alias[i] < 0)
+            m->textures[m->texture_count++] = i;
+    }
+    return 1;
+}
+
+void model_materials_decode(ModelMaterials *m, size_t texture)
+{
+    size_t i = m->textures[texture];
+    texture_image_load(m->descs[i].diffuseMap, &m->images[i]);
+}
+
+int model_materials_upload(ModelMaterials *m, ObjModelData *data)
+{
+    int packed = m->packed;
+    size_t parsed = m->count - 1;
+
+    size_t range_count = data->submesh_count;
+    MaterialRange *ranges = (MaterialRange *)malloc((range_count ? range_count : 1) * sizeof(MaterialRange));
+    unsigned int *sorted = (unsigned int *)malloc((data->index_count ? data->index_count : 1) *
+                                                  sizeof(unsigned int));
+    int ok = ranges && sorted && (packed ? load_packed(m) : load_classic(m));
+
+    for (size_t i = 0; ok && i < range_count; i++)
+    {
+        const ObjSubmesh *s = &data->submeshes[i];
+        int mat = find_material(m->descs, parsed, s->material);
+        if (mat < 0)
+        {
+            if (s->material[0])
+                printf("Unknown material '%s', using default\n", s->material);
+            mat = (int)parsed;
+        }
+
+        MaterialRange *r = &ranges[i];
+        r->index_offset = s->index_offset;
+        r->index_count = s->index_count;
+        r->material = mat;
+        r->array = packed ? m->pack.entries[mat].array : 0;
+        // upakowane: tablica tekstur wyznacza wywołanie, materiał tylko porządkuje
+        r->key = ((unsigned long long)(unsigned)r->array << 32) | (unsigned)mat;
+    }
+
+    if (ok)
+    {
+        // trójkąty w kolejności rysowania
+        qsort(ranges, range_count, sizeof(MaterialRange), cmp_range);
+        size_t at = 0;
+        for (size_t i = 0; i < range_count; i++)
+        {
+            memcpy(sorted + at, data->indices + ranges[i].index_offset,
+                   ranges[i].index_count * sizeof(unsigned int));
+            ranges[i].index_offset = at;
+            at += ranges[i].index_count;
+        }
+        memcpy(data->indices, sorted, at * sizeof(unsigned int));
+
+        // sąsiednie zakresy z tym samym stanem -> jedno wywołanie
+        m->batches = (MaterialBatch *)malloc((range_count ? range_count : 1) * sizeof(MaterialBatch));
+        ok = m->batches != NULL;
+        for (size_t i = 0; ok && i < range_count; i++)
+        {
+            const MaterialRange *r = &ranges[i];
+            MaterialBatch *last = m->batch_count ? &m->batches[m->batch_count - 1] : NULL;
+            int same = last && (packed ? last->array == r->array : last->material == r->material);
+            if (same)
+            {
+                last->index_count += r->index_count;
+                continue;
+            }
+            MaterialBatch *b = &m->batches[m->batch_count++];
+            b->index_offset = r->index_offset;
+            b->index_count = r->index_count;
+            b->material = r->material;
+            b->array = r->array;
+        }
+    }
+
+    if (ok && packed)
+        ok = upload_triangle_ids(m, ranges, range_count, data->index_count);
+
+    free(ranges);
+    free(sorted);
+    free_images(m);
+    if (!ok)
+    {
+        model_materials_destroy(m);
+        return 0;
+    }
+
+    if (packed)
+    {
+        const TexturePackStats *s = &m->pack.stats;
+        printf("[materials] %zu materials, %d textures -> %d arrays + %d atlas pages "
+               "(%d textures), %.1f MB, %.1f ms\n",
+               m->count - 1, s->textures, s->arrays, s->atlas_pages, s->atlas_textures,
+               (double)s->bytes / (1024.0 * 1024.0), s->ms);
+    }
+    return 1;
+}
+
+void model_materials_setup_program(GLuint program)
+{
+    glUniform1i(glGetUniformLocation(program, "uMaterialArray"), MATERIAL_UNIT_ARRAY);
+    glUniform1i(glGetUniformLocation(program, "uMaterialData"), MATERIAL_UNIT_DATA);
+    glUniform1i(glGetUniformLocation(program, "uMaterialIds"), MATERIAL_UNIT_IDS);
+}
+
+/**
+ * @brief RenderBindFn trybu upakowanego: bufory materiałów dla shadera.
+ */
+static int bind_packed(const void *state, GLuint program)
+{
+    const ModelMaterials *m = (const ModelMaterials *)state;
+    glActiveTexture(GL_TEXTURE0 + MATERIAL_UNIT_DATA);
+    glBindTexture(GL_TEXTURE_BUFFER, m->data_tex);
+    glActiveTexture(GL_TEXTURE0 + MATERIAL_UNIT_IDS);
+    glBindTexture(GL_TEXTURE_BUFFER, m->id_tex);
+    glActiveTexture(GL_TEXTURE0);
+    (void)program;
+    return 1;
+}
+
+void model_materials_enqueue(const ModelMaterials *m, RenderQueue *q, ShaderVariants *shader, const Mesh *mesh,
+                             const void *transform, RenderBindFn bind_transform, float depth,
+                             GLuint occlusion_query)
+{
+    for (size_t i = 0; i < m->batch_count; i++)
+    {
+        const MaterialBatch *b = &m->batches[i];
+        RenderItem item;
+        memset(&item, 0, sizeof(item));
+        item.vao = mesh->VAO;
+        item.depth_vao = mesh->depthVAO;
+        item.transform = transform;
+        item.bind_transform = bind_transform;
+        item.index_offset = b->index_offset;
+        item.index_count = b->index_count;
+        item.primitive_base = -1;
+        item.occlusion_query = occlusion_query;
+
+        if (m->packed)
+        {
+            item.program = shader_variants_get(shader, SHADER_FEATURE_PACKED);
+            item.texture_target = GL_TEXTURE_2D_ARRAY;
+            item.texture = m->pack.arrays[b->array].texture;
+            item.texture_unit = MATERIAL_UNIT_ARRAY;
+            item.material = m;
+            item.bind_material = bind_packed;
+            // gl_PrimitiveID liczy od zera w każdym wywołaniu
+            item.primitive_base = (GLint)(b->index_offset / 3);
+        }
+        else
+        {
+            const Material *mat = &m->classic[b->material];
+            item.program = shader_variants_get(shader, material_shader_features(mat));
+            render_item_from_material(&item, mat);
+        }
+        render_queue_push(q, RENDER_PASS_OPAQUE, &item, depth);
+    }
+}
+
+void model_materials_print_stats(const ModelMaterials *m)
+{
+    printf("[materials] %s: %zu materials in %zu draws\n",
+           m->packed ? "packed" : "per-material", m->count - 1, m->batch_count);
+}
+
+void model_materials_destroy(ModelMaterials *m)
+{
+    if (m->classic)
+    {
+        for (size_t i = 0; i < m->count; i++)
+            material_destroy(&m->classic[i]);
+        free(m->classic);
+    }
+    texture_pack_destroy(&m->pack);
+    if (m->data_tex)
+        glDeleteTextures(1, &m->data_tex);
+    if (m->data_buf)
+        glDeleteBuffers(1, &m->data_buf);
+    if (m->id_tex)
+        glDeleteTextures(1, &m->id_tex);
+    if (m->id_buf)
+        glDeleteBuffers(1, &m->id_buf);
+    free(m->batches);
+    free_images(m);
+    free(m->descs);
+    memset(m, 0, sizeof(*m));
+}
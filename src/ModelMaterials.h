@@ -0,0 +1,145 @@
+#pragma once
+#include <stddef.h>
+#include <glad/glad.h>
+
+#include "Material.h"
+#include "Mesh.h"
+#include "Renderer.h"
+#include "ObjLoader.h"
+#include "TexturePack.h"
+
+#define MATERIAL_UNIT_ARRAY 4 // sampler2DArray z upakowanymi teksturami
+#define MATERIAL_UNIT_DATA 5  // samplerBuffer: Kd + warstwa, transformacja UV
+#define MATERIAL_UNIT_IDS 6   // usamplerBuffer: materiał każdego trójkąta
+
+/**
+ * @brief Jedno wywołanie glDrawElements.
+ */
+typedef struct MaterialBatch
+{
+    size_t index_offset;
+    size_t index_count;
+    int material; // tryb klasyczny: indeks materiału
+    int array;    // tryb upakowany: indeks tablicy tekstur
+} MaterialBatch;
+
+/**
+ * @brief Materiały modelu z wieloma usemtl.
+ *
+ * Tryb klasyczny: każdy materiał ma własną teksturę 2D i osobne
+ * wywołanie rysowania.
+ *
+ * Tryb upakowany: tekstury w TexturePack, trójkąty posortowane po
+ * tablicy tekstur, więc jedno wywołanie rysuje wszystkie materiały
+ * z danej tablicy. Fragment shader czyta materiał trójkąta
+ * (gl_PrimitiveID) z bufora tekstury i stamtąd kolor, warstwę
+ * i transformację UV.
+ *
+ * Wczytywanie w trzech krokach, żeby dekodowanie tekstur mogło iść
+ * równolegle na workerach (Startup): model_materials_parse() (CPU),
+ * model_materials_decode() dla każdej tekstury (CPU, niezależne)
+ * i model_materials_upload() (GL). model_materials_init() robi wszystko
+ * po kolei.
+ */
+typedef struct ModelMaterials
+{
+    int packed;
+    size_t count;          // materiały (ostatni = domyślny biały)
+    MaterialDesc *descs;
+
+    /* dekodowanie (do model_materials_upload) */
+    TextureImage *images;  // obraz materiału (pusty dla aliasów i materiałów bez mapy)
+    int *alias;            // materiał z tą samą mapą (-1 = własny obraz)
+    size_t *textures;      // materiały z obrazem do zdekodowania
+    size_t texture_count;
+
+    Material *classic;     // tryb klasyczny
+    TexturePack pack;      // tryb upakowany
+    GLuint data_buf, data_tex;
+    GLuint id_buf, id_tex;
+
+    MaterialBatch *batches;
+    size_t batch_count;
+} ModelMaterials;
+
+/**
+ * @brief Wczytuje bibliotekę MTL i przygotowuje rysowanie zakresów modelu.
+ *
+ * model_materials_parse() + model_materials_decode() każdej tekstury
+ * + model_materials_upload().
+ *
+ * @param m        Wynik.
+ * @param data     Model z zakresami usemtl.
+ * @param mtl_path Plik .mtl.
+ * @param packed   1 -> tablice tekstur i scalone rysowanie.
+ * @return 1 jeśli OK, 0 jeśli błąd.
+ */
+int model_materials_init(ModelMaterials *m, ObjModelData *data, const char *mtl_path, int packed);
+
+/**
+ * @brief Parsuje bibliotekę MTL i wyznacza tekstury do zdekodowania (bez GL).
+ *
+ * Ta sama mapa w kilku materiałach jest dekodowana raz.
+ *
+ * @param m        Wynik (model_materials_destroy() także po błędzie dalszych kroków).
+ * @param mtl_path Plik .mtl.
+ * @param packed   1 -> tablice tekstur i scalone rysowanie.
+ * @return 1 jeśli OK, 0 jeśli błąd alokacji.
+ */
+int model_materials_parse(ModelMaterials *m, const char *mtl_path, int packed);
+
+/**
+ * @brief Dekoduje jedną teksturę (bez GL).
+ *
+ * Różne indeksy można dekodować równolegle z różnych wątków.
+ *
+ * @param m       Materiały po model_materials_parse().
+ * @param texture Indeks 0 .. m->texture_count - 1.
+ */
+void model_materials_decode(ModelMaterials *m, size_t texture);
+
+/**
+ * @brief Tworzy tekstury i bufory z obrazów, przestawia zakresy modelu.
+ *
+ * Przestawia trójkąty w data->indices (kolejność rysowania), więc
+ * wołać przed mesh_create(). Zwalnia obrazy.
+ *
+ * @param m    Materiały po model_materials_parse() i dekodowaniu.
+ * @param data Model z zakresami usemtl.
+ * @return 1 jeśli OK, 0 jeśli błąd (m jest wtedy zwolniony).
+ */
+int model_materials_upload(ModelMaterials *m, ObjModelData *data);
+
+/**
+ * @brief Ustawia jednostki samplerów materiałów w programie.
+ *
+ * Wołać raz po wczytaniu shadera, także dla modeli z jednym materiałem:
+ * samplery różnych typów nie mogą zostać na wspólnej jednostce 0.
+ */
+void model_materials_setup_program(GLuint program);
+
+/**
+ * @brief Dodaje rysowania modelu (jedno na partię) do kolejki.
+ *
+ * @param m         Materiały.
+ * @param q         Kolejka klatki.
+ * @param shader    Warianty shadera (packed: PACKED_MATERIALS, inaczej wg materiału partii).
+ * @param mesh      Siatka utworzona z przestawionych indeksów.
+ * @param transform Stan transformacji (RenderItem.transform).
+ * @param bind_transform Ustawia transformację.
+ * @param depth     Głębokość modelu w przestrzeni widoku.
+ * @param occlusion_query Zapytanie dla wszystkich partii (RenderItem.occlusion_query, 0 = bez).
+ */
+void model_materials_enqueue(const ModelMaterials *m, RenderQueue *q, ShaderVariants *shader, const Mesh *mesh,
+                             const void *transform, RenderBindFn bind_transform, float depth,
+                             GLuint occlusion_query);
+
+/**
+ * @brief Wypisuje tryb, liczbę materiałów i partii.
+ */
+void model_materials_print_stats(const ModelMaterials *m);
+
+/**
+ * @brief Zwalnia tekstury, bufory i pamięć.
+ */
+void model_materials_destroy(ModelMaterials *m);
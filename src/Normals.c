@@ -0,0 +1,695 @@
+#include "Normals.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NORMALS_SIMD 1
+#include <emmintrin.h>
+#endif
+
+#define NORMALS_MAX_THREADS 64
+#define NORMALS_MIN_TRIS_PER_THREAD 65536
+
+// powyżej tylu narożników w jednej pozycji crease jest pomijany (koszt O(m^2))
+#define CREASE_GROUP_LIMIT 1024
+
+// normalne o takim cosinusie traktujemy jako identyczne (bez podziału wierzchołka)
+#define SAME_NORMAL_DOT 0.9999f
+
+#define NO_SPLIT UINT32_MAX
+
+/* =========================================================
+   Dane wątków
+   ========================================================= */
+
+typedef struct NormalSplit
+{
+    uint32_t src;    // wierzchołek źródłowy (pozycja/UV)
+    float normal[3];
+} NormalSplit;
+
+typedef struct NormalPatch
+{
+    uint32_t corner; // pozycja w tablicy indeksów
+    uint32_t split;  // indeks w NormalSplit[] wątku
+} NormalPatch;
+
+typedef struct GroupVertex
+{
+    uint32_t vertex;
+    uint32_t split;  // NO_SPLIT -> oryginalny wierzchołek
+    float normal[3];
+} GroupVertex;
+
+/**
+ * @brief Zadanie jednego wątku (zakres trójkątów albo grup pozycji).
+ */
+typedef struct NormalJob
+{
+    /* współdzielone, tylko do odczytu (poza normalnymi "swoich" wierzchołków) */
+    Vertex *verts;
+    const unsigned int *indices;
+    float *faces;                 // na trójkąt: nx, ny, nz, |e1 x e2|
+    const uint32_t *group_start;  // CSR: grupa -> narożniki
+    const uint32_t *group_corners;
+    NormalWeighting weighting;
+    float cos_crease;
+    int crease;
+
+    size_t begin, end;
+
+    /* wyniki wątku */
+    NormalSplit *splits;
+    size_t split_count, split_cap;
+    NormalPatch *patches;
+    size_t patch_count, patch_cap;
+    size_t generated;
+    int failed;
+
+    /* bufory robocze */
+    float *weights;
+    unsigned char *need;
+    GroupVertex *local;
+    size_t scratch_cap;
+} NormalJob;
+
+/* =========================================================
+   Pomocnicze
+   ========================================================= */
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+}
+
+static int cpu_count(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return (int)si.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+static uint64_t mix_u64(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+static int is_zero_normal(const float n[3])
+{
+    return n[0] == 0.0f && n[1] == 0.0f && n[2] == 0.0f;
+}
+
+static void normalize_or_default(float n[3])
+{
+    float len = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    if (len > 0.0f)
+    {
+        n[0] /= len; n[1] /= len; n[2] /= len;
+    }
+    else
+    {
+        n[0] = 0.0f; n[1] = 0.0f; n[2] = 1.0f;
+    }
+}
+
+/**
+ * @brief Zastępuje pozostałe normalne (0,0,0) domyślnym (0,0,1) — ścieżka błędu.
+ */
+static void fill_default_normals(Vertex *v, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        if (is_zero_normal(v[i].normal))
+            v[i].normal[2] = 1.0f;
+}
+
+/* =========================================================
+   Grupy pozycji: wierzchołki o identycznej pozycji dzielą normalną
+   ========================================================= */
+
+static uint64_t position_hash(const float p[3])
+{
+    uint32_t b[3];
+    for (int k = 0; k < 3; k++)
+    {
+        float f = p[k] + 0.0f; // -0 -> +0
+        memcpy(&b[k], &f, sizeof(f));
+    }
+    return mix_u64(((uint64_t)b[0] << 32 | b[1]) ^ mix_u64(b[2]));
+}
+
+static int same_position(const float a[3], const float b[3])
+{
+    return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+}
+
+/**
+ * @brief Nadaje każdemu wierzchołkowi id grupy pozycji (open addressing).
+ *
+ * @return Tablica id (malloc) lub NULL przy błędzie.
+ */
+static uint32_t *position_groups(const Vertex *v, size_t count, size_t *groupCount)
+{
+    size_t cap = 1024;
+    while (cap < count * 2)
+        cap <<= 1;
+
+    uint32_t *table = (uint32_t *)malloc(cap * sizeof(uint32_t));
+    uint32_t *gid = (uint32_t *)malloc(count * sizeof(uint32_t));
+    if (!table || !gid)
+    {
+        free(table); free(gid);
+        return NULL;
+    }
+    memset(table, 0xff, cap * sizeof(uint32_t));
+
+    size_t mask = cap - 1;
+    uint32_t groups = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t slot = (size_t)position_hash(v[i].position) & mask;
+        for (;;)
+        {
+            uint32_t rep = table[slot];
+            if (rep == UINT32_MAX)
+            {
+                table[slot] = (uint32_t)i;
+                gid[i] = groups++;
+                break;
+            }
+            if (same_position(v[rep].position, v[i].position))
+            {
+                gid[i] = gid[rep];
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+    }
+
+    free(table);
+    *groupCount = groups;
+    return gid;
+}
+
+/* =========================================================
+   Faza 1: normalne ścian (równolegle po trójkątach)
+   ========================================================= */
+
+static void face_normal_scalar(const Vertex *v, const unsigned int *tri, float out[4])
+{
+    const float *p0 = v[tri[0]].position;
+    const float *p1 = v[tri[1]].position;
+    const float *p2 = v[tri[2]].position;
+    float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+    float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+
+    float n[3] = {
+        e1[1] * e2[2] - e1[2] * e2[1],
+        e1[2] * e2[0] - e1[0] * e2[2],
+        e1[0] * e2[1] - e1[1] * e2[0]};
+    float len = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    float inv = len > 0.0f ? 1.0f / len : 0.0f;
+
+    out[0] = n[0] * inv;
+    out[1] = n[1] * inv;
+    out[2] = n[2] * inv;
+    out[3] = len;
+}
+
+static void *face_normals_main(void *arg)
+{
+    NormalJob *j = (NormalJob *)arg;
+    const Vertex *v = j->verts;
+    const unsigned int *idx = j->indices;
+    size_t t = j->begin;
+
+#ifdef NORMALS_SIMD
+    // 4 trójkąty naraz: SoA w rejestrach, wynik transponowany do (nx,ny,nz,len)
+    for (; t + 4 <= j->end; t += 4)
+    {
+        float ax[4], ay[4], az[4], bx[4], by[4], bz[4], cx[4], cy[4], cz[4];
+        for (int k = 0; k < 4; k++)
+        {
+            const unsigned int *tri = idx + (t + k) * 3;
+            const float *p0 = v[tri[0]].position;
+            const float *p1 = v[tri[1]].position;
+            const float *p2 = v[tri[2]].position;
+            ax[k] = p0[0]; ay[k] = p0[1]; az[k] = p0[2];
+            bx[k] = p1[0]; by[k] = p1[1]; bz[k] = p1[2];
+            cx[k] = p2[0]; cy[k] = p2[1]; cz[k] = p2[2];
+        }
+
+        __m128 x0 = _mm_loadu_ps(ax), y0 = _mm_loadu_ps(ay), z0 = _mm_loadu_ps(az);
+        __m128 e1x = _mm_sub_ps(_mm_loadu_ps(bx), x0);
+        __m128 e1y = _mm_sub_ps(_mm_loadu_ps(by), y0);
+        __m128 e1z = _mm_sub_ps(_mm_loadu_ps(bz), z0);
+        __m128 e2x = _mm_sub_ps(_mm_loadu_ps(cx), x0);
+        __m128 e2y = _mm_sub_ps(_mm_loadu_ps(cy), y0);
+        __m128 e2z = _mm_sub_ps(_mm_loadu_ps(cz), z0);
+
+        __m128 nx = _mm_sub_ps(_mm_mul_ps(e1y, e2z), _mm_mul_ps(e1z, e2y));
+        __m128 ny = _mm_sub_ps(_mm_mul_ps(e1z, e2x), _mm_mul_ps(e1x, e2z));
+        __m128 nz = _mm_sub_ps(_mm_mul_ps(e1x, e2y), _mm_mul_ps(e1y, e2x));
+
+        __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)),
+                                            _mm_mul_ps(nz, nz)));
+        // zdegenerowane trójkąty: 1/0 = inf, maska zeruje wynik
+        __m128 valid = _mm_cmpgt_ps(len, _mm_setzero_ps());
+        __m128 inv = _mm_and_ps(valid, _mm_div_ps(_mm_set1_ps(1.0f), len));
+        nx = _mm_mul_ps(nx, inv);
+        ny = _mm_mul_ps(ny, inv);
+        nz = _mm_mul_ps(nz, inv);
+
+        _MM_TRANSPOSE4_PS(nx, ny, nz, len);
+        float *out = j->faces + t * 4;
+        _mm_storeu_ps(out + 0, nx);
+        _mm_storeu_ps(out + 4, ny);
+        _mm_storeu_ps(out + 8, nz);
+        _mm_storeu_ps(out + 12, len);
+    }
+#endif
+
+    for (; t < j->end; t++)
+        face_normal_scalar(v, idx + t * 3, j->faces + t * 4);
+    return NULL;
+}
+
+/* =========================================================
+   Faza 2: akumulacja w grupach pozycji (równolegle po grupach)
+   ========================================================= */
+
+/**
+ * @brief Kąt trójkąta w narożniku c (radiany).
+ */
+static float corner_angle(const Vertex *v, const unsigned int *tri, int c)
+{
+    const float *p = v[tri[c]].position;
+    const float *a = v[tri[(c + 1) % 3]].position;
+    const float *b = v[tri[(c + 2) % 3]].position;
+    float e1[3] = {a[0] - p[0], a[1] - p[1], a[2] - p[2]};
+    float e2[3] = {b[0] - p[0], b[1] - p[1], b[2] - p[2]};
+
+    float l = sqrtf((e1[0] * e1[0] + e1[1] * e1[1] + e1[2] * e1[2]) *
+                    (e2[0] * e2[0] + e2[1] * e2[1] + e2[2] * e2[2]));
+    if (l <= 0.0f)
+        return 0.0f;
+    float d = (e1[0] * e2[0] + e1[1] * e2[1] + e1[2] * e2[2]) / l;
+    if (d > 1.0f) d = 1.0f;
+    if (d < -1.0f) d = -1.0f;
+    return acosf(d);
+}
+
+static int job_reserve_scratch(NormalJob *j, size_t m)
+{
+    if (m <= j->scratch_cap)
+        return 1;
+    size_t cap = j->scratch_cap ? j->scratch_cap : 64;
+    while (cap < m)
+        cap *= 2;
+
+    float *w = (float *)realloc(j->weights, cap * sizeof(float));
+    if (w) j->weights = w;
+    unsigned char *n = (unsigned char *)realloc(j->need, cap);
+    if (n) j->need = n;
+    GroupVertex *l = (GroupVertex *)realloc(j->local, cap * sizeof(GroupVertex));
+    if (l) j->local = l;
+    if (!w || !n || !l)
+        return 0;
+    j->scratch_cap = cap;
+    return 1;
+}
+
+static int job_push_split(NormalJob *j, uint32_t src, const float n[3])
+{
+    if (j->split_count + 1 > j->split_cap)
+    {
+        size_t cap = j->split_cap ? j->split_cap * 2 : 256;
+        NormalSplit *s = (NormalSplit *)realloc(j->splits, cap * sizeof(NormalSplit));
+        if (!s)
+            return 0;
+        j->splits = s;
+        j->split_cap = cap;
+    }
+    NormalSplit *s = &j->splits[j->split_count++];
+    s->src = src;
+    memcpy(s->normal, n, sizeof(s->normal));
+    return 1;
+}
+
+static int job_push_patch(NormalJob *j, uint32_t corner, uint32_t split)
+{
+    if (j->patch_count + 1 > j->patch_cap)
+    {
+        size_t cap = j->patch_cap ? j->patch_cap * 2 : 256;
+        NormalPatch *p = (NormalPatch *)realloc(j->patches, cap * sizeof(NormalPatch));
+        if (!p)
+            return 0;
+        j->patches = p;
+        j->patch_cap = cap;
+    }
+    j->patches[j->patch_count].corner = corner;
+    j->patches[j->patch_count].split = split;
+    j->patch_count++;
+    return 1;
+}
+
+/**
+ * @brief Liczy normalne wszystkich narożników jednej grupy pozycji.
+ *
+ * Wszystkie narożniki danego wierzchołka należą do tej samej grupy,
+ * więc zapis normalnej do verts[] nie koliduje z innymi wątkami.
+ */
+static int process_group(NormalJob *j, const uint32_t *corners, size_t m)
+{
+    Vertex *v = j->verts;
+    const unsigned int *idx = j->indices;
+
+    if (!job_reserve_scratch(j, m))
+        return 0;
+
+    int any = 0;
+    for (size_t i = 0; i < m; i++)
+    {
+        j->need[i] = (unsigned char)is_zero_normal(v[idx[corners[i]]].normal);
+        any |= j->need[i];
+    }
+    if (!any)
+        return 1;
+
+    float sum[3] = {0.0f, 0.0f, 0.0f};
+    for (size_t i = 0; i < m; i++)
+    {
+        uint32_t c = corners[i];
+        const float *fn = j->faces + (size_t)(c / 3) * 4;
+        float w = j->weighting == NORMAL_WEIGHT_AREA ? fn[3]
+                                                     : corner_angle(v, idx + (c - c % 3), (int)(c % 3));
+        j->weights[i] = w;
+        sum[0] += fn[0] * w;
+        sum[1] += fn[1] * w;
+        sum[2] += fn[2] * w;
+    }
+
+    int crease = j->crease && m <= CREASE_GROUP_LIMIT;
+    size_t localCount = 0;
+
+    for (size_t i = 0; i < m; i++)
+    {
+        if (!j->need[i])
+            continue;
+
+        uint32_t c = corners[i];
+        const float *fi = j->faces + (size_t)(c / 3) * 4;
+        float n[3] = {sum[0], sum[1], sum[2]};
+
+        if (crease && fi[3] > 0.0f)
+        {
+            n[0] = n[1] = n[2] = 0.0f;
+            for (size_t k = 0; k < m; k++)
+            {
+                const float *fk = j->faces + (size_t)(corners[k] / 3) * 4;
+                if (fk[0] * fi[0] + fk[1] * fi[1] + fk[2] * fi[2] < j->cos_crease)
+                    continue;
+                n[0] += fk[0] * j->weights[k];
+                n[1] += fk[1] * j->weights[k];
+                n[2] += fk[2] * j->weights[k];
+            }
+        }
+        normalize_or_default(n);
+
+        // ten sam wierzchołek z tą samą normalną -> nic do zrobienia
+        uint32_t vi = idx[c];
+        int seen = 0;
+        GroupVertex *match = NULL;
+        for (size_t l = 0; l < localCount; l++)
+        {
+            GroupVertex *g = &j->local[l];
+            if (g->vertex != vi)
+                continue;
+            seen = 1;
+            if (g->normal[0] * n[0] + g->normal[1] * n[1] + g->normal[2] * n[2] >= SAME_NORMAL_DOT)
+            {
+                match = g;
+                break;
+            }
+        }
+
+        if (match)
+        {
+            if (match->split != NO_SPLIT && !job_push_patch(j, c, match->split))
+                return 0;
+            continue;
+        }
+
+        GroupVertex *g = &j->local[localCount++];
+        g->vertex = vi;
+        memcpy(g->normal, n, sizeof(g->normal));
+        j->generated++;
+
+        if (!seen)
+        {
+            g->split = NO_SPLIT;
+            memcpy(v[vi].normal, n, sizeof(n));
+        }
+        else
+        {
+            // ostra krawędź: narożnik dostaje kopię wierzchołka z inną normalną
+            g->split = (uint32_t)j->split_count;
+            if (!job_push_split(j, vi, n) || !job_push_patch(j, c, g->split))
+                return 0;
+        }
+    }
+    return 1;
+}
+
+static void *group_normals_main(void *arg)
+{
+    NormalJob *j = (NormalJob *)arg;
+    for (size_t g = j->begin; g < j->end && !j->failed; g++)
+    {
+        uint32_t s = j->group_start[g];
+        uint32_t e = j->group_start[g + 1];
+        if (!process_group(j, j->group_corners + s, e - s))
+            j->failed = 1;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Uruchamia fn na wszystkich zadaniach; zadanie 0 na bieżącym wątku.
+ */
+static void run_jobs(NormalJob *jobs, int count, void *(*fn)(void *))
+{
+    pthread_t th[NORMALS_MAX_THREADS];
+    int started[NORMALS_MAX_THREADS] = {0};
+
+    for (int i = 1; i < count; i++)
+        started[i] = pthread_create(&th[i], NULL, fn, &jobs[i]) == 0;
+    fn(&jobs[0]);
+    for (int i = 1; i < count; i++)
+    {
+        if (started[i])
+            pthread_join(th[i], NULL);
+        else
+            fn(&jobs[i]); // brak wątku -> licz na bieżącym
+    }
+}
+
+/**
+ * @brief Pierwsza grupa, której narożniki zaczynają się od >= target.
+ */
+static size_t group_lower_bound(const uint32_t *start, size_t groups, uint32_t target)
+{
+    size_t lo = 0, hi = groups;
+    while (lo < hi)
+    {
+        size_t mid = (lo + hi) / 2;
+        if (start[mid] < target)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/* =========================================================
+   API
+   ========================================================= */
+
+NormalGenParams normal_gen_params_default(void)
+{
+    NormalGenParams p;
+    p.weighting = NORMAL_WEIGHT_ANGLE;
+    p.crease_angle = 180.0f;
+    p.threads = 0;
+    return p;
+}
+
+int normals_generate(Vertex **vertices, size_t *vertex_count,
+                     unsigned int *indices, size_t index_count,
+                     const NormalGenParams *params, NormalGenStats *stats)
+{
+    double t0 = now_ms();
+    NormalGenParams prm = params ? *params : normal_gen_params_default();
+    NormalGenStats st = {0};
+
+    Vertex *v = *vertices;
+    size_t vcount = *vertex_count;
+    size_t triCount = index_count / 3;
+
+    if (stats)
+        *stats = st;
+    if (triCount == 0 || vcount == 0)
+        return 1;
+    if (index_count > UINT32_MAX || vcount >= UINT32_MAX)
+    {
+        printf("ERROR: mesh too large for normal generation\n");
+        fill_default_normals(v, vcount);
+        return 0;
+    }
+
+    int threads = prm.threads > 0 ? prm.threads : cpu_count();
+    size_t maxUseful = 1 + triCount / NORMALS_MIN_TRIS_PER_THREAD;
+    if ((size_t)threads > maxUseful) threads = (int)maxUseful;
+    if (threads > NORMALS_MAX_THREADS) threads = NORMALS_MAX_THREADS;
+    if (threads < 1) threads = 1;
+
+    size_t groupCount = 0;
+    uint32_t *gid = position_groups(v, vcount, &groupCount);
+    float *faces = (float *)malloc(triCount * 4 * sizeof(float));
+    uint32_t *start = (uint32_t *)calloc(groupCount + 1, sizeof(uint32_t));
+    uint32_t *cursor = (uint32_t *)malloc((groupCount + 1) * sizeof(uint32_t));
+    uint32_t *corners = (uint32_t *)malloc(index_count * sizeof(uint32_t));
+    NormalJob *jobs = (NormalJob *)calloc((size_t)threads, sizeof(NormalJob));
+    int ok = gid && faces && start && cursor && corners && jobs;
+
+    if (ok)
+    {
+        // CSR: narożniki posortowane wg grupy pozycji (zliczanie, O(n))
+        for (size_t k = 0; k < index_count; k++)
+            start[gid[indices[k]] + 1]++;
+        for (size_t g = 0; g < groupCount; g++)
+            start[g + 1] += start[g];
+        memcpy(cursor, start, (groupCount + 1) * sizeof(uint32_t));
+        for (size_t k = 0; k < index_count; k++)
+            corners[cursor[gid[indices[k]]]++] = (uint32_t)k;
+
+        float crease = prm.crease_angle;
+        for (int i = 0; i < threads; i++)
+        {
+            NormalJob *j = &jobs[i];
+            j->verts = v;
+            j->indices = indices;
+            j->faces = faces;
+            j->group_start = start;
+            j->group_corners = corners;
+            j->weighting = prm.weighting;
+            j->crease = crease > 0.0f && crease < 180.0f;
+            j->cos_crease = cosf(crease * 3.14159265f / 180.0f);
+            j->begin = triCount * (size_t)i / (size_t)threads;
+            j->end = triCount * (size_t)(i + 1) / (size_t)threads;
+        }
+        run_jobs(jobs, threads, face_normals_main);
+
+        // grupy dzielone wg liczby narożników, nie liczby grup
+        for (int i = 0; i < threads; i++)
+        {
+            jobs[i].begin = group_lower_bound(start, groupCount, (uint32_t)(index_count * (size_t)i / (size_t)threads));
+            jobs[i].end = group_lower_bound(start, groupCount, (uint32_t)(index_count * (size_t)(i + 1) / (size_t)threads));
+        }
+        jobs[threads - 1].end = groupCount;
+        run_jobs(jobs, threads, group_normals_main);
+
+        size_t splits = 0;
+        for (int i = 0; i < threads; i++)
+        {
+            ok = ok && !jobs[i].failed;
+            splits += jobs[i].split_count;
+            st.generated += jobs[i].generated;
+        }
+
+        // scalenie: kopie wierzchołków na końcu tablicy, poprawa indeksów
+        if (ok && splits > 0)
+        {
+            Vertex *nv = (Vertex *)realloc(v, (vcount + splits) * sizeof(Vertex));
+            if (nv)
+            {
+                v = nv;
+                size_t base = vcount;
+                for (int i = 0; i < threads; i++)
+                {
+                    NormalJob *j = &jobs[i];
+                    for (size_t s = 0; s < j->split_count; s++)
+                    {
+                        v[base + s] = v[j->splits[s].src];
+                        memcpy(v[base + s].normal, j->splits[s].normal, sizeof(v->normal));
+                    }
+                    for (size_t p = 0; p < j->patch_count; p++)
+                        indices[j->patches[p].corner] = (unsigned int)(base + j->patches[p].split);
+                    base += j->split_count;
+                }
+                vcount += splits;
+                st.split = splits;
+            }
+            else
+            {
+                ok = 0;
+            }
+        }
+    }
+
+    if (!ok)
+    {
+        printf("ERROR: normal generation failed (out of memory)\n");
+        fill_default_normals(v, vcount);
+    }
+
+    if (jobs)
+    {
+        for (int i = 0; i < threads; i++)
+        {
+            free(jobs[i].splits);
+            free(jobs[i].patches);
+            free(jobs[i].weights);
+            free(jobs[i].need);
+            free(jobs[i].local);
+        }
+    }
+    free(jobs);
+    free(corners);
+    free(cursor);
+    free(start);
+    free(faces);
+    free(gid);
+
+    *vertices = v;
+    *vertex_count = vcount;
+
+    st.threads = threads;
+    st.ms = now_ms() - t0;
+    if (stats)
+        *stats = st;
+    return ok;
+}
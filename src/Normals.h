@@ -0,0 +1,62 @@
+#pragma once
+#include <stddef.h>
+#include "Mesh.h"
+
+/**
+ * @brief Sposób ważenia normalnych ścian przy uśrednianiu w wierzchołku.
+ */
+typedef enum NormalWeighting
+{
+    NORMAL_WEIGHT_AREA = 0, // pole trójkąta (duże ściany dominują)
+    NORMAL_WEIGHT_ANGLE     // kąt w narożniku (niezależne od teselacji)
+} NormalWeighting;
+
+/**
+ * @brief Parametry generowania normalnych.
+ */
+typedef struct NormalGenParams
+{
+    NormalWeighting weighting;
+    float crease_angle; // stopnie; ściany różniące się bardziej nie są uśredniane (>= 180 -> pełne wygładzanie)
+    int threads;        // 0 -> liczba rdzeni
+} NormalGenParams;
+
+/**
+ * @brief Wynik generowania (do logów / porównań).
+ */
+typedef struct NormalGenStats
+{
+    size_t generated; // wierzchołki, którym policzono normalną
+    size_t split;     // wierzchołki dodane na krawędziach ostrych
+    int threads;
+    double ms;
+} NormalGenStats;
+
+/**
+ * @brief Domyślne parametry: ważenie kątem, pełne wygładzanie, wszystkie rdzenie.
+ */
+NormalGenParams normal_gen_params_default(void);
+
+/**
+ * @brief Generuje gładkie normalne dla wierzchołków z normalną (0,0,0).
+ *
+ * Wierzchołki o identycznej pozycji (np. różniące się tylko UV) są
+ * uśredniane razem. Normalne ścian liczone są równolegle (SIMD, po 4
+ * trójkąty), a akumulacja idzie bez atomików: narożniki są grupowane
+ * wg pozycji i każdą grupę przetwarza dokładnie jeden wątek.
+ *
+ * Przy aktywnym crease_angle wierzchołek leżący na ostrej krawędzi może
+ * zostać rozdzielony — wtedy *vertices jest realokowane, a indeksy
+ * poprawiane w miejscu.
+ *
+ * @param vertices     Tablica wierzchołków (malloc; może zostać powiększona).
+ * @param vertex_count Liczba wierzchołków (aktualizowana).
+ * @param indices      Indeksy trójkątów.
+ * @param index_count  Liczba indeksów (wielokrotność 3).
+ * @param params       Parametry (NULL -> domyślne).
+ * @param stats        Statystyki (może być NULL).
+ * @return 1 jeśli OK, 0 jeśli błąd alokacji (dane pozostają poprawne).
+ */
+int normals_generate(Vertex **vertices, size_t *vertex_count,
+                     unsigned int *indices, size_t index_count,
+                     const NormalGenParams *params, NormalGenStats *stats);
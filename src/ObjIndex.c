@@ -0,0 +1,914 @@
+#include "ObjIndex.h"
+#include "MappedFile.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#define OBJ_INDEX_MAX_CORNERS 64
+#define OBJ_INDEX_MAX_LINE 1024
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+}
+
+static int file_info(const char *path, uint64_t *size, int64_t *mtime)
+{
+    struct stat st;
+    if (stat(path, &st) != 0)
+        return 0;
+    *size = (uint64_t)st.st_size;
+    *mtime = (int64_t)st.st_mtime;
+    return 1;
+}
+
+/* =========================================================
+   Linie OBJ (bez kopiowania)
+   ========================================================= */
+
+static const char *line_end(const char *s, const char *end)
+{
+    const char *nl = (const char *)memchr(s, '\n', (size_t)(end - s));
+    return nl ? nl : end;
+}
+
+static int is_blank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+/**
+ * @brief Rodzaj linii atrybutu: OBJ_INDEX_V / VT / VN albo -1.
+ */
+static int attribute_kind(const char *s, const char *e)
+{
+    if (e - s < 2 || s[0] != 'v')
+        return -1;
+    if (is_blank(s[1]))
+        return OBJ_INDEX_V;
+    if (e - s < 3 || !is_blank(s[2]))
+        return -1;
+    if (s[1] == 't')
+        return OBJ_INDEX_VT;
+    if (s[1] == 'n')
+        return OBJ_INDEX_VN;
+    return -1;
+}
+
+/**
+ * @brief Kopiuje tekst [s, e) bez białych znaków na brzegach (first_token: do pierwszej spacji).
+ */
+static void copy_name(char *dst, size_t cap, const char *s, const char *e, int first_token)
+{
+    while (s < e && is_blank(*s))
+        s++;
+    const char *t = s;
+    while (t < e && !(first_token && is_blank(*t)))
+        t++;
+    while (t > s && is_blank(t[-1]))
+        t--;
+    size_t n = (size_t)(t - s) < cap - 1 ? (size_t)(t - s) : cap - 1;
+    memcpy(dst, s, n);
+    dst[n] = '\0';
+}
+
+static const double g_pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/**
+ * @brief Liczba zmiennoprzecinkowa (bez locale, bez kopiowania linii).
+ *
+ * @return Wskaźnik za liczbą albo NULL, jeśli jej nie ma.
+ */
+static const char *parse_float(const char *s, const char *end, float *out)
+{
+    while (s < end && (*s == ' ' || *s == '\t'))
+        s++;
+
+    int neg = 0;
+    if (s < end && (*s == '-' || *s == '+'))
+        neg = *s++ == '-';
+
+    uint64_t mant = 0;
+    int exp10 = 0, digits = 0;
+    for (; s < end && *s >= '0' && *s <= '9'; s++, digits++)
+    {
+        if (mant < 100000000000000000ull)
+            mant = mant * 10 + (uint64_t)(*s - '0');
+        else
+            exp10++;
+    }
+    if (s < end && *s == '.')
+    {
+        for (s++; s < end && *s >= '0' && *s <= '9'; s++, digits++)
+        {
+            if (mant < 100000000000000000ull)
+            {
+                mant = mant * 10 + (uint64_t)(*s - '0');
+                exp10--;
+            }
+        }
+    }
+    if (digits == 0)
+        return NULL;
+
+    if (s < end && (*s == 'e' || *s == 'E'))
+    {
+        const char *e = s + 1;
+        int eneg = 0, ev = 0, edigits = 0;
+        if (e < end && (*e == '-' || *e == '+'))
+            eneg = *e++ == '-';
+        for (; e < end && *e >= '0' && *e <= '9'; e++, edigits++)
+            ev = ev < 10000 ? ev * 10 + (*e - '0') : ev;
+        if (edigits)
+        {
+            exp10 += eneg ? -ev : ev;
+            s = e;
+        }
+    }
+
+    double v = (double)mant;
+    if (exp10 >= 0 && exp10 <= 22)
+        v *= g_pow10[exp10];
+    else if (exp10 < 0 && exp10 >= -22)
+        v /= g_pow10[-exp10];
+    else
+        v *= pow(10.0, exp10);
+    *out = (float)(neg ? -v : v);
+    return s;
+}
+
+/* =========================================================
+   Budowa indeksu
+   ========================================================= */
+
+typedef struct U64Vec
+{
+    uint64_t *data;
+    size_t count, cap;
+} U64Vec;
+
+typedef struct ObjectVec
+{
+    ObjIndexObject *data;
+    size_t count, cap;
+} ObjectVec;
+
+static int u64_push(U64Vec *v, uint64_t x)
+{
+    if (v->count == v->cap)
+    {
+        size_t cap = v->cap ? v->cap * 2 : 256;
+        uint64_t *p = (uint64_t *)realloc(v->data, cap * sizeof(*p));
+        if (!p)
+            return 0;
+        v->data = p;
+        v->cap = cap;
+    }
+    v->data[v->count++] = x;
+    return 1;
+}
+
+static int object_push(ObjectVec *v, const ObjIndexObject *o)
+{
+    if (v->count == v->cap)
+    {
+        size_t cap = v->cap ? v->cap * 2 : 64;
+        ObjIndexObject *p = (ObjIndexObject *)realloc(v->data, cap * sizeof(*p));
+        if (!p)
+            return 0;
+        v->data = p;
+        v->cap = cap;
+    }
+    v->data[v->count++] = *o;
+    return 1;
+}
+
+static void begin_object(ObjIndexObject *o, const char *name, const char *name_end, uint64_t begin,
+                         const uint32_t counts[OBJ_INDEX_KINDS], const char *material)
+{
+    memset(o, 0, sizeof(*o));
+    copy_name(o->name, sizeof(o->name), name, name_end, 0);
+    snprintf(o->material, sizeof(o->material), "%s", material);
+    o->begin = begin;
+    memcpy(o->first, counts, sizeof(o->first));
+}
+
+int obj_index_build(const char *path, ObjIndex *out)
+{
+    memset(out, 0, sizeof(*out));
+    double t0 = now_ms();
+
+    uint64_t fileSize = 0;
+    int64_t mtime = 0;
+    MappedFile f;
+    if (!file_info(path, &fileSize, &mtime) || !mapped_file_open(path, &f))
+    {
+        printf("ERROR: cannot open OBJ: %s\n", path);
+        return 0;
+    }
+    if (!f.data)
+    {
+        printf("ERROR: empty OBJ: %s\n", path);
+        mapped_file_close(&f);
+        return 0;
+    }
+
+    const char *base = (const char *)f.data;
+    const char *end = base + f.size;
+    uint32_t counts[OBJ_INDEX_KINDS] = {0};
+    U64Vec checkpoints[OBJ_INDEX_KINDS] = {{0}};
+    ObjectVec objects = {0};
+    char material[OBJ_MATERIAL_NAME] = "";
+
+    // ściany przed pierwszym o/g -> obiekt bez nazwy
+    ObjIndexObject cur;
+    begin_object(&cur, "", "", 0, counts, material);
+
+    int ok = 1;
+    for (const char *s = base; s < end && ok;)
+    {
+        const char *line = s;
+        const char *e = line_end(s, end);
+        while (s < e && is_blank(*s))
+            s++;
+
+        int kind = attribute_kind(s, e);
+        if (kind >= 0)
+        {
+            if (counts[kind] % OBJ_INDEX_STRIDE == 0)
+                ok = u64_push(&checkpoints[kind], (uint64_t)(line - base));
+            counts[kind]++;
+        }
+        else if (e - s > 1 && s[0] == 'f' && is_blank(s[1]))
+        {
+            cur.face_count++;
+        }
+        else if (e - s > 1 && (s[0] == 'o' || s[0] == 'g') && is_blank(s[1]))
+        {
+            cur.end = (uint64_t)(line - base);
+            if (cur.face_count > 0)
+                ok = object_push(&objects, &cur);
+            begin_object(&cur, s + 2, e, (uint64_t)(line - base), counts, material);
+        }
+        else if (e - s > 6 && strncmp(s, "usemtl", 6) == 0 && is_blank(s[6]))
+        {
+            copy_name(material, sizeof(material), s + 6, e, 1);
+        }
+        s = e + 1;
+    }
+    cur.end = (uint64_t)f.size;
+    if (ok && cur.face_count > 0)
+        ok = object_push(&objects, &cur);
+    mapped_file_close(&f);
+
+    if (!ok)
+    {
+        printf("ERROR: out of memory indexing %s\n", path);
+        for (int k = 0; k < OBJ_INDEX_KINDS; k++)
+            free(checkpoints[k].data);
+        free(objects.data);
+        return 0;
+    }
+
+    ObjIndexHeader *h = &out->header;
+    h->magic = OBJ_INDEX_MAGIC;
+    h->version = OBJ_INDEX_VERSION;
+    h->stride = OBJ_INDEX_STRIDE;
+    h->object_count = (uint32_t)objects.count;
+    h->file_size = fileSize;
+    h->file_mtime = mtime;
+    for (int k = 0; k < OBJ_INDEX_KINDS; k++)
+    {
+        h->counts[k] = counts[k];
+        h->checkpoint_counts[k] = (uint32_t)checkpoints[k].count;
+        out->checkpoints[k] = checkpoints[k].data;
+    }
+    out->objects = objects.data;
+    out->ms = now_ms() - t0;
+    return 1;
+}
+
+/* =========================================================
+   Plik .idx
+   ========================================================= */
+
+int obj_index_save(const ObjIndex *index, const char *idx_path)
+{
+    FILE *f = fopen(idx_path, "wb");
+    if (!f)
+        return 0;
+
+    const ObjIndexHeader *h = &index->header;
+    int ok = fwrite(h, sizeof(*h), 1, f) == 1;
+    for (int k = 0; k < OBJ_INDEX_KINDS && ok; k++)
+        ok = fwrite(index->checkpoints[k], sizeof(uint64_t), h->checkpoint_counts[k], f) ==
+             h->checkpoint_counts[k];
+    if (ok)
+        ok = fwrite(index->objects, sizeof(ObjIndexObject), h->object_count, f) == h->object_count;
+    ok = fclose(f) == 0 && ok;
+    if (!ok)
+        remove(idx_path);
+    return ok;
+}
+
+int obj_index_load(const char *idx_path, const char *obj_path, ObjIndex *out)
+{
+    memset(out, 0, sizeof(*out));
+    double t0 = now_ms();
+
+    uint64_t fileSize = 0;
+    int64_t mtime = 0;
+    if (!file_info(obj_path, &fileSize, &mtime))
+        return 0;
+
+    FILE *f = fopen(idx_path, "rb");
+    if (!f)
+        return 0;
+
+    ObjIndexHeader *h = &out->header;
+    int ok = fread(h, sizeof(*h), 1, f) == 1 && h->magic == OBJ_INDEX_MAGIC &&
+             h->version == OBJ_INDEX_VERSION && h->stride > 0 && h->file_size == fileSize &&
+             h->file_mtime == mtime;
+
+    for (int k = 0; k < OBJ_INDEX_KINDS && ok; k++)
+    {
+        uint32_t n = h->checkpoint_counts[k];
+        ok = n == (h->counts[k] + h->stride - 1) / h->stride;
+        if (ok && n > 0)
+        {
+            out->checkpoints[k] = (uint64_t *)malloc(n * sizeof(uint64_t));
+            ok = out->checkpoints[k] && fread(out->checkpoints[k], sizeof(uint64_t), n, f) == n;
+        }
+    }
+    if (ok && h->object_count > 0)
+    {
+        out->objects = (ObjIndexObject *)malloc(h->object_count * sizeof(ObjIndexObject));
+        ok = out->objects && fread(out->objects, sizeof(ObjIndexObject), h->object_count, f) == h->object_count;
+    }
+    fclose(f);
+
+    for (uint32_t i = 0; ok && i < h->object_count; i++)
+    {
+        ObjIndexObject *o = &out->objects[i];
+        o->name[sizeof(o->name) - 1] = '\0';
+        o->material[sizeof(o->material) - 1] = '\0';
+        ok = o->begin <= o->end && o->end <= fileSize;
+    }
+
+    if (!ok)
+    {
+        obj_index_free(out);
+        return 0;
+    }
+    out->ms = now_ms() - t0;
+    out->from_sidecar = 1;
+    return 1;
+}
+
+int obj_index_open(const char *path, ObjIndex *out)
+{
+    char idxPath[1024];
+    snprintf(idxPath, sizeof(idxPath), "%s.idx", path);
+
+    if (obj_index_load(idxPath, path, out))
+    {
+        printf("[objindex] %s: %u objects, %u v / %u vt / %u vn (index %.1f ms)\n", idxPath,
+               out->header.object_count, out->header.counts[0], out->header.counts[1], out->header.counts[2],
+               out->ms);
+        return 1;
+    }
+
+    if (!obj_index_build(path, out))
+        return 0;
+    printf("[objindex] indexed %s: %u objects, %u v / %u vt / %u vn in %.1f ms\n", path,
+           out->header.object_count, out->header.counts[0], out->header.counts[1], out->header.counts[2], out->ms);
+    if (!obj_index_save(out, idxPath))
+        printf("WARNING: cannot write %s (the file will be indexed again next time)\n", idxPath);
+    return 1;
+}
+
+int obj_index_find(const ObjIndex *index, const char *name)
+{
+    for (uint32_t i = 0; i < index->header.object_count; i++)
+    {
+        if (strcmp(index->objects[i].name, name) == 0)
+            return (int)i;
+    }
+    return -1;
+}
+
+void obj_index_print(const ObjIndex *index)
+{
+    printf("[objindex] %u objects:\n", index->header.object_count);
+    for (uint32_t i = 0; i < index->header.object_count; i++)
+    {
+        const ObjIndexObject *o = &index->objects[i];
+        printf("  %-32s %10u faces %10.2f MB%s%s\n", o->name[0] ? o->name : "(unnamed)", o->face_count,
+               (double)(o->end - o->begin) / 1048576.0, o->material[0] ? "  usemtl " : "", o->material);
+    }
+}
+
+/* =========================================================
+   Wczytanie wybranych obiektów
+   ========================================================= */
+
+typedef struct CornerVec
+{
+    int (*data)[3]; // {vi, ti, ni} narożników trójkątów, 0-based globalnie
+    size_t count, cap;
+} CornerVec;
+
+typedef struct SubmeshVec
+{
+    ObjSubmesh *data;
+    size_t count, cap;
+} SubmeshVec;
+
+static int corner_push(CornerVec *v, const int c[3])
+{
+    if (v->count == v->cap)
+    {
+        size_t cap = v->cap ? v->cap * 2 : 1024;
+        int(*p)[3] = (int(*)[3])realloc(v->data, cap * sizeof(*p));
+        if (!p)
+            return 0;
+        v->data = p;
+        v->cap = cap;
+    }
+    memcpy(v->data[v->count++], c, sizeof(int) * 3);
+    return 1;
+}
+
+/**
+ * @brief Zaczyna zakres materiału od narożnika first (pusty poprzedni jest zastępowany, jak w obj_load()).
+ */
+static int submesh_begin(SubmeshVec *v, const char *name, size_t first)
+{
+    if (v->count > 0 && v->data[v->count - 1].index_offset == first)
+        v->count--;
+    if (v->count > 0 && strcmp(v->data[v->count - 1].material, name) == 0)
+        return 1; // ten sam materiał na granicy obiektów: zakres trwa dalej
+    if (v->count == v->cap)
+    {
+        size_t cap = v->cap ? v->cap * 2 : 16;
+        ObjSubmesh *p = (ObjSubmesh *)realloc(v->data, cap * sizeof(*p));
+        if (!p)
+            return 0;
+        v->data = p;
+        v->cap = cap;
+    }
+    ObjSubmesh *sm = &v->data[v->count++];
+    snprintf(sm->material, sizeof(sm->material), "%s", name);
+    sm->index_offset = first;
+    sm->index_count = 0;
+    return 1;
+}
+
+/**
+ * @brief Ściany jednego obiektu -> narożniki trójkątów (triangulacja fan) i zakresy usemtl.
+ *
+ * Linie v/vt/vn wewnątrz zakresu są tylko liczone (indeksy ujemne).
+ */
+static int parse_object(const ObjIndexObject *o, const char *base, CornerVec *corners, SubmeshVec *submeshes,
+                        size_t *faces)
+{
+    const char *s = base + o->begin;
+    const char *end = base + o->end;
+    int counts[OBJ_INDEX_KINDS] = {(int)o->first[0], (int)o->first[1], (int)o->first[2]};
+
+    if (o->material[0] || submeshes->count > 0)
+    {
+        // ściany wcześniejszych obiektów bez usemtl -> zakres bez nazwy
+        if (submeshes->count == 0 && corners->count > 0 && !submesh_begin(submeshes, "", 0))
+            return 0;
+        if (!submesh_begin(submeshes, o->material, corners->count))
+            return 0;
+    }
+
+    while (s < end)
+    {
+        const char *e = line_end(s, end);
+        while (s < e && is_blank(*s))
+            s++;
+
+        int kind = attribute_kind(s, e);
+        if (kind >= 0)
+        {
+            counts[kind]++;
+        }
+        else if (e - s > 1 && s[0] == 'f' && is_blank(s[1]))
+        {
+            char line[OBJ_INDEX_MAX_LINE];
+            size_t n = (size_t)(e - s) < sizeof(line) - 1 ? (size_t)(e - s) : sizeof(line) - 1;
+            memcpy(line, s, n);
+            line[n] = '\0';
+
+            int c[OBJ_INDEX_MAX_CORNERS][3];
+            int cornerN = obj_parse_face_line(line, counts[0], counts[1], counts[2], c, OBJ_INDEX_MAX_CORNERS);
+            if (cornerN < 0)
+                return 0;
+            for (int i = 1; i + 1 < cornerN; i++)
+            {
+                if (!corner_push(corners, c[0]) || !corner_push(corners, c[i]) || !corner_push(corners, c[i + 1]))
+                    return 0;
+            }
+            (*faces)++;
+        }
+        else if (e - s > 6 && strncmp(s, "usemtl", 6) == 0 && is_blank(s[6]))
+        {
+            char name[OBJ_MATERIAL_NAME];
+            copy_name(name, sizeof(name), s + 6, e, 1);
+            // ściany przed pierwszym usemtl -> zakres bez nazwy
+            if (submeshes->count == 0 && corners->count > 0 && !submesh_begin(submeshes, "", 0))
+                return 0;
+            if (!submesh_begin(submeshes, name, corners->count))
+                return 0;
+        }
+        s = e + 1;
+    }
+    return 1;
+}
+
+/**
+ * @brief Czyta elementy [lo, hi] listy v/vt/vn, zaczynając od najbliższego punktu kontrolnego.
+ *
+ * @return 1 jeśli OK, 0 jeśli plik nie zgadza się z indeksem.
+ */
+static int read_attributes(const ObjIndex *index, const char *base, const char *end, int kind, uint32_t lo,
+                           uint32_t hi, float *dst, size_t *parsed, uint64_t *bytes)
+{
+    int dim = kind == OBJ_INDEX_VT ? 2 : 3;
+    uint32_t cp = lo / index->header.stride;
+    if (cp >= index->header.checkpoint_counts[kind])
+        return 0;
+
+    uint32_t elem = cp * index->header.stride;
+    const char *start = base + index->checkpoints[kind][cp];
+
+    // początek obiektu to też punkt kontrolny (first rośnie w kolejności pliku), zwykle tuż przed jego v/vt/vn
+    uint32_t l = 0, r = index->header.object_count;
+    while (l < r)
+    {
+        uint32_t m = l + (r - l) / 2;
+        if (index->objects[m].first[kind] <= lo)
+            l = m + 1;
+        else
+            r = m;
+    }
+    if (l > 0 && index->objects[l - 1].first[kind] > elem)
+    {
+        elem = index->objects[l - 1].first[kind];
+        start = base + index->objects[l - 1].begin;
+    }
+    const char *s = start;
+    while (s < end && elem <= hi)
+    {
+        const char *e = line_end(s, end);
+        while (s < e && is_blank(*s))
+            s++;
+
+        if (attribute_kind(s, e) == kind)
+        {
+            if (elem >= lo)
+            {
+                float *d = dst + (size_t)(elem - lo) * dim;
+                const char *p = s + (kind == OBJ_INDEX_V ? 1 : 2);
+                for (int k = 0; k < dim; k++)
+                {
+                    p = p ? parse_float(p, e, &d[k]) : NULL;
+                    if (!p)
+                        d[k] = 0.0f;
+                }
+                (*parsed)++;
+            }
+            elem++;
+        }
+        s = e + 1;
+    }
+    *bytes += (uint64_t)(s - start);
+    return elem > hi;
+}
+
+/**
+ * @brief Wczytany zakres elementów listy v, vt albo vn.
+ */
+typedef struct AttributeRange
+{
+    uint32_t lo, hi;
+    size_t offset; // pierwszy element w AttributeSet.data
+} AttributeRange;
+
+typedef struct AttributeSet
+{
+    AttributeRange *ranges; // po load_attributes(): posortowane i rozłączne
+    size_t count;
+    float *data;
+} AttributeSet;
+
+static int range_push(AttributeSet *a, uint32_t lo, uint32_t hi)
+{
+    AttributeRange *p = (AttributeRange *)realloc(a->ranges, (a->count + 1) * sizeof(*p));
+    if (!p)
+        return 0;
+    a->ranges = p;
+    a->ranges[a->count].lo = lo;
+    a->ranges[a->count].hi = hi;
+    a->ranges[a->count].offset = 0;
+    a->count++;
+    return 1;
+}
+
+static int range_cmp(const void *a, const void *b)
+{
+    uint32_t x = ((const AttributeRange *)a)->lo, y = ((const AttributeRange *)b)->lo;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Scala nakładające się zakresy obiektów i czyta je z pliku.
+ */
+static int load_attributes(const ObjIndex *index, const char *base, const char *end, int kind, AttributeSet *a,
+                           ObjIndexLoadStats *st)
+{
+    if (a->count == 0)
+        return 1;
+
+    qsort(a->ranges, a->count, sizeof(*a->ranges), range_cmp);
+    size_t n = 0;
+    for (size_t i = 0; i < a->count; i++)
+    {
+        AttributeRange r = a->ranges[i];
+        if (n > 0 && (uint64_t)r.lo <= (uint64_t)a->ranges[n - 1].hi + 1)
+        {
+            if (r.hi > a->ranges[n - 1].hi)
+                a->ranges[n - 1].hi = r.hi;
+        }
+        else
+        {
+            a->ranges[n++] = r;
+        }
+    }
+    a->count = n;
+
+    size_t dim = kind == OBJ_INDEX_VT ? 2 : 3;
+    size_t total = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        a->ranges[i].offset = total;
+        total += (size_t)(a->ranges[i].hi - a->ranges[i].lo) + 1;
+    }
+    a->data = (float *)malloc(total * dim * sizeof(float));
+    if (!a->data)
+        return 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        const AttributeRange *r = &a->ranges[i];
+        if (!read_attributes(index, base, end, kind, r->lo, r->hi, a->data + r->offset * dim, &st->attributes,
+                             &st->bytes_read))
+            return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Element listy (leży w jednym z wczytanych zakresów).
+ */
+static const float *attribute_at(const AttributeSet *a, uint32_t element, size_t dim)
+{
+    size_t l = 0, r = a->count;
+    while (r - l > 1)
+    {
+        size_t m = (l + r) / 2;
+        if (a->ranges[m].lo <= element)
+            l = m;
+        else
+            r = m;
+    }
+    const AttributeRange *q = &a->ranges[l];
+    return a->data + (q->offset + (element - q->lo)) * dim;
+}
+
+/**
+ * @brief Mapa (vi,ti,ni) -> indeks wierzchołka (adresowanie otwarte, stały rozmiar).
+ */
+typedef struct CornerSlot
+{
+    int key[3];
+    unsigned int value;
+    int used;
+} CornerSlot;
+
+static uint64_t corner_hash(const int c[3])
+{
+    uint64_t x = ((uint64_t)(uint32_t)(c[0] + 1) << 42) ^ ((uint64_t)(uint32_t)(c[1] + 1) << 21) ^
+                 (uint64_t)(uint32_t)(c[2] + 1);
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+int obj_index_load_objects(const ObjIndex *index, const char *path, const char *const *names,
+                           size_t name_count, ObjModelData *out, const NormalGenParams *normals,
+                           ObjIndexLoadStats *stats)
+{
+    memset(out, 0, sizeof(*out));
+    ObjIndexLoadStats st;
+    memset(&st, 0, sizeof(st));
+    double t0 = now_ms();
+
+    for (size_t n = 0; n < name_count; n++)
+    {
+        if (obj_index_find(index, names[n]) < 0)
+        {
+            printf("ERROR: no object or group '%s' in %s\n", names[n], path);
+            obj_index_print(index);
+            return 0;
+        }
+    }
+
+    MappedFile f;
+    if (!mapped_file_open(path, &f))
+    {
+        printf("ERROR: cannot open OBJ: %s\n", path);
+        return 0;
+    }
+    if (f.size != index->header.file_size || !f.data)
+    {
+        printf("ERROR: %s changed since it was indexed\n", path);
+        mapped_file_close(&f);
+        return 0;
+    }
+    const char *base = (const char *)f.data;
+    const char *end = base + f.size;
+    st.file_size = f.size;
+
+    /* ---- ściany wybranych obiektów (w kolejności pliku) ---- */
+    CornerVec corners = {0};
+    SubmeshVec submeshes = {0};
+    AttributeSet attributes[OBJ_INDEX_KINDS];
+    memset(attributes, 0, sizeof(attributes));
+    int ok = 1;
+    for (uint32_t i = 0; i < index->header.object_count && ok; i++)
+    {
+        const ObjIndexObject *o = &index->objects[i];
+        int wanted = 0;
+        for (size_t n = 0; n < name_count && !wanted; n++)
+            wanted = strcmp(o->name, names[n]) == 0;
+        if (!wanted)
+            continue;
+
+        size_t first = corners.count;
+        ok = parse_object(o, base, &corners, &submeshes, &st.faces);
+        st.objects++;
+        st.bytes_read += o->end - o->begin;
+        if (!ok)
+        {
+            printf("ERROR: face references invalid position index in %s (object '%s')\n", path, o->name);
+            break;
+        }
+
+        // zakresy v/vt/vn, do których odwołują się ściany obiektu
+        for (int k = 0; k < OBJ_INDEX_KINDS && ok; k++)
+        {
+            uint32_t lo = UINT32_MAX, hi = 0;
+            for (size_t c = first; c < corners.count; c++)
+            {
+                int *v = &corners.data[c][k];
+                if (*v < 0 || (uint32_t)*v >= index->header.counts[k])
+                {
+                    *v = -1; // brak vt/vn (jak w obj_load(): 0,0 / normalna do wygenerowania)
+                    continue;
+                }
+                lo = (uint32_t)*v < lo ? (uint32_t)*v : lo;
+                hi = (uint32_t)*v > hi ? (uint32_t)*v : hi;
+            }
+            if (lo <= hi)
+                ok = range_push(&attributes[k], lo, hi);
+        }
+    }
+
+    for (int k = 0; k < OBJ_INDEX_KINDS && ok; k++)
+    {
+        ok = load_attributes(index, base, end, k, &attributes[k], &st);
+        if (!ok)
+            printf("ERROR: %s does not match its index (rebuild: delete %s.idx)\n", path, path);
+    }
+    mapped_file_close(&f);
+
+    /* ---- unikalne wierzchołki i indeksy (jak obj_load()) ---- */
+    size_t cap = 1024;
+    while (cap < corners.count * 2)
+        cap *= 2;
+    CornerSlot *slots = ok ? (CornerSlot *)calloc(cap, sizeof(CornerSlot)) : NULL;
+    Vertex *vertices = ok ? (Vertex *)malloc((corners.count ? corners.count : 1) * sizeof(Vertex)) : NULL;
+    unsigned int *indices = ok ? (unsigned int *)malloc((corners.count ? corners.count : 1) * sizeof(unsigned int))
+                               : NULL;
+    ok = ok && slots && vertices && indices;
+
+    size_t vertexCount = 0;
+    size_t missingNormals = 0;
+    for (size_t i = 0; i < corners.count && ok; i++)
+    {
+        const int *c = corners.data[i];
+        size_t slot = (size_t)corner_hash(c) & (cap - 1);
+        while (slots[slot].used && memcmp(slots[slot].key, c, sizeof(slots[slot].key)) != 0)
+            slot = (slot + 1) & (cap - 1);
+
+        if (!slots[slot].used)
+        {
+            CornerSlot *e = &slots[slot];
+            memcpy(e->key, c, sizeof(e->key));
+            e->value = (unsigned int)vertexCount;
+            e->used = 1;
+
+            Vertex *v = &vertices[vertexCount++];
+            memset(v, 0, sizeof(*v));
+            memcpy(v->position, attribute_at(&attributes[OBJ_INDEX_V], (uint32_t)c[0], 3), sizeof(v->position));
+            if (c[1] >= 0)
+                memcpy(v->texcoord, attribute_at(&attributes[OBJ_INDEX_VT], (uint32_t)c[1], 2), sizeof(v->texcoord));
+            if (c[2] >= 0)
+                memcpy(v->normal, attribute_at(&attributes[OBJ_INDEX_VN], (uint32_t)c[2], 3), sizeof(v->normal));
+            else
+                missingNormals++;
+        }
+        indices[i] = slots[slot].value;
+    }
+
+    free(slots);
+    for (int k = 0; k < OBJ_INDEX_KINDS; k++)
+    {
+        free(attributes[k].ranges);
+        free(attributes[k].data);
+    }
+    size_t indexCount = corners.count;
+    free(corners.data);
+
+    if (!ok || indexCount == 0)
+    {
+        if (ok)
+            printf("ERROR: selected objects of %s have no faces\n", path);
+        free(vertices);
+        free(indices);
+        free(submeshes.data);
+        return 0;
+    }
+
+    // długości zakresów = odstępy między początkami
+    for (size_t i = 0; i < submeshes.count; i++)
+    {
+        size_t next = (i + 1 < submeshes.count) ? submeshes.data[i + 1].index_offset : indexCount;
+        submeshes.data[i].index_count = next - submeshes.data[i].index_offset;
+    }
+    if (submeshes.count > 0 && submeshes.data[submeshes.count - 1].index_count == 0)
+        submeshes.count--;
+
+    // zmniejszenie bufora; gdy się nie uda, zostaje oryginał
+    Vertex *shrunk = (Vertex *)realloc(vertices, vertexCount * sizeof(Vertex));
+    out->vertices = shrunk ? shrunk : vertices;
+    out->vertex_count = vertexCount;
+    out->indices = indices;
+    out->index_count = indexCount;
+    out->submeshes = submeshes.data;
+    out->submesh_count = submeshes.count;
+
+    if (missingNormals > 0)
+    {
+        NormalGenStats ns;
+        normals_generate(&out->vertices, &out->vertex_count, out->indices, out->index_count, normals, &ns);
+        printf("[normals] %zu vertices without vn: generated %zu (+%zu split) in %.1f ms, %d threads\n",
+               missingNormals, ns.generated, ns.split, ns.ms, ns.threads);
+    }
+
+    st.ms = now_ms() - t0;
+    if (stats)
+        *stats = st;
+    return 1;
+}
+
+void obj_index_print_load_stats(const ObjIndexLoadStats *stats)
+{
+    printf("[objindex] loaded %zu object range(s): %zu faces, %zu v/vt/vn lines parsed, "
+           "scanned %.2f of %.2f MB (%.2f%%) in %.1f ms\n",
+           stats->objects, stats->faces, stats->attributes, (double)stats->bytes_read / 1048576.0,
+           (double)stats->file_size / 1048576.0,
+           stats->file_size ? 100.0 * (double)stats->bytes_read / (double)stats->file_size : 0.0, stats->ms);
+}
+
+void obj_index_free(ObjIndex *index)
+{
+    for (int k = 0; k < OBJ_INDEX_KINDS; k++)
+        free(index->checkpoints[k]);
+    free(index->objects);
+    memset(index, 0, sizeof(*index));
+}
@@ -0,0 +1,158 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ObjLoader.h"
+
+/**
+ * @brief Indeks obiektów dużego pliku OBJ (plik obok: model.obj.idx).
+ *
+ * obj_load() musi sparsować cały plik, nawet gdy interesuje nas jeden
+ * obiekt `o`/`g` z gigabajtowego skanu. Przebieg indeksujący tylko
+ * klasyfikuje linie (bez parsowania liczb) i zapisuje:
+ *  - zakres bajtów każdego obiektu/grupy (od linii o/g do następnej),
+ *    liczby v/vt/vn sprzed niego (indeksy ujemne) i aktywny usemtl,
+ *  - przesunięcie co OBJ_INDEX_STRIDE-tej linii v, vt i vn, więc
+ *    element N globalnej listy jest najwyżej STRIDE linii od punktu
+ *    kontrolnego.
+ *
+ * obj_index_load_objects() parsuje wtedy tylko ściany wybranych obiektów,
+ * a z list v/vt/vn czyta wyłącznie zakresy, do których te ściany się
+ * odwołują (od najbliższego punktu kontrolnego albo początku obiektu,
+ * za którym zwykle leżą jego wierzchołki). Plik jest zmapowany
+ * w pamięci, więc reszta nie jest nawet wczytywana z dysku.
+ */
+
+#define OBJ_INDEX_MAGIC 0x3158494Fu /* "OIX1" */
+#define OBJ_INDEX_VERSION 1u
+#define OBJ_INDEX_STRIDE 4096u // elementy v/vt/vn między punktami kontrolnymi
+#define OBJ_INDEX_NAME 64
+
+enum
+{
+    OBJ_INDEX_V = 0,
+    OBJ_INDEX_VT,
+    OBJ_INDEX_VN,
+    OBJ_INDEX_KINDS
+};
+
+/**
+ * @brief Nagłówek pliku .idx; po nim punkty kontrolne v, vt, vn (uint64) i obiekty.
+ */
+typedef struct ObjIndexHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t stride;
+    uint32_t object_count;
+    uint64_t file_size;   // rozmiar OBJ w chwili indeksowania
+    int64_t file_mtime;   // czas modyfikacji OBJ (indeks nieaktualny, jeśli inny)
+    uint32_t counts[OBJ_INDEX_KINDS];
+    uint32_t checkpoint_counts[OBJ_INDEX_KINDS];
+} ObjIndexHeader;
+
+/**
+ * @brief Jeden obiekt `o` albo grupa `g` (ściany sprzed pierwszej: nazwa "").
+ */
+typedef struct ObjIndexObject
+{
+    char name[OBJ_INDEX_NAME];
+    char material[OBJ_MATERIAL_NAME]; // usemtl aktywny na początku zakresu
+    uint64_t begin, end;              // bajty linii obiektu w OBJ
+    uint32_t first[OBJ_INDEX_KINDS];  // liczba v/vt/vn przed begin
+    uint32_t face_count;
+} ObjIndexObject;
+
+typedef struct ObjIndex
+{
+    ObjIndexHeader header;
+    uint64_t *checkpoints[OBJ_INDEX_KINDS]; // bajt linii elementu k * stride
+    ObjIndexObject *objects;
+    double ms; // budowa albo wczytanie
+    int from_sidecar;
+} ObjIndex;
+
+/**
+ * @brief Wynik obj_index_load_objects() (do logów).
+ */
+typedef struct ObjIndexLoadStats
+{
+    size_t objects;
+    size_t faces;
+    size_t attributes;  // sparsowane linie v/vt/vn
+    uint64_t bytes_read; // przeskanowane: linie obiektów + zakresy v/vt/vn
+    uint64_t file_size;
+    double ms;
+} ObjIndexLoadStats;
+
+/**
+ * @brief Indeksuje plik OBJ (jeden przebieg po zmapowanym pliku).
+ *
+ * @param path Ścieżka do .obj.
+ * @param out  Indeks wyjściowy.
+ * @return 1 jeśli OK, 0 jeśli błąd.
+ */
+int obj_index_build(const char *path, ObjIndex *out);
+
+/**
+ * @brief Zapisuje indeks do pliku.
+ *
+ * @return 1 jeśli OK, 0 jeśli błąd zapisu.
+ */
+int obj_index_save(const ObjIndex *index, const char *idx_path);
+
+/**
+ * @brief Wczytuje indeks, jeśli pasuje do bieżącego pliku OBJ (rozmiar i mtime).
+ *
+ * @return 1 jeśli OK, 0 jeśli brak pliku, zły format albo indeks nieaktualny.
+ */
+int obj_index_load(const char *idx_path, const char *obj_path, ObjIndex *out);
+
+/**
+ * @brief Wczytuje path.idx albo indeksuje plik i zapisuje path.idx.
+ *
+ * @return 1 jeśli OK, 0 jeśli błąd (nieudany zapis indeksu nie jest błędem).
+ */
+int obj_index_open(const char *path, ObjIndex *out);
+
+/**
+ * @brief Pierwszy obiekt o danej nazwie.
+ *
+ * @return Indeks w index->objects albo -1.
+ */
+int obj_index_find(const ObjIndex *index, const char *name);
+
+/**
+ * @brief Wypisuje listę obiektów (nazwa, ściany, rozmiar zakresu).
+ */
+void obj_index_print(const ObjIndex *index);
+
+/**
+ * @brief Wczytuje tylko wybrane obiekty jako jeden model.
+ *
+ * Obiekty o tej samej nazwie (np. grupa `g` powtórzona w pliku) są
+ * wczytywane wszystkie. Wynik ma postać jak z obj_load_ex(): unikalne
+ * wierzchołki, indeksy, zakresy usemtl, wygenerowane brakujące normalne.
+ *
+ * @param index      Indeks pliku (obj_index_open()).
+ * @param path       Ścieżka do .obj.
+ * @param names      Nazwy obiektów.
+ * @param name_count Liczba nazw.
+ * @param out        Model wyjściowy (zwalniać obj_free()).
+ * @param normals    Parametry generowania normalnych (NULL -> domyślne).
+ * @param stats      Statystyki (może być NULL).
+ * @return 1 jeśli OK, 0 jeśli błąd (np. nieznana nazwa).
+ */
+int obj_index_load_objects(const ObjIndex *index, const char *path, const char *const *names,
+                           size_t name_count, ObjModelData *out, const NormalGenParams *normals,
+                           ObjIndexLoadStats *stats);
+
+/**
+ * @brief Wypisuje statystyki wczytania.
+ */
+void obj_index_print_load_stats(const ObjIndexLoadStats *stats);
+
+/**
+ * @brief Zwalnia indeks.
+ */
+void obj_index_free(ObjIndex *index);
@@ -54,6 +54,33 @@ static void va_push(VertexArray* a, Vertex v) {
     a->data[a->count++] = v;
 }
 
+/**
+ * @brief Dynamiczna tablica zakresów usemtl.
+ */
+typedef struct SubmeshArray {
+    ObjSubmesh* data;
+    size_t count;
+    size_t capacity;
+} SubmeshArray;
+
+/**
+ * @brief Zaczyna nowy zakres materiału od indeksu first (pusty poprzedni jest zastępowany).
+ */
+static void sa_begin(SubmeshArray* a, const char* name, size_t first) {
+    if (a->count > 0 && a->data[a->count - 1].index_offset == first) {
+        a->count--;
+    }
+    if (a->count + 1 > a->capacity) {
+        size_t newCap = a->capacity ? a->capacity * 2 : 16;
+        a->data = (ObjSubmesh*)realloc(a->data, newCap * sizeof(ObjSubmesh));
+        a->capacity = newCap;
+    }
+    ObjSubmesh* sm = &a->data[a->count++];
+    snprintf(sm->material, sizeof(sm->material), "%s", name);
+    sm->index_offset = first;
+    sm->index_count = 0;
+}
+
 static void ua_push(UIntArray* a, unsigned int v) {
     if (a->count + 1 > a->capacity) {
         size_t newCap = a->capacity ? a->capacity * 2 : 256;
@@ -261,6 +288,44 @@ static void parse_face_token(const char* tok, int* out_vi, int* out_ti, int* out
     *out_ni = (*c) ? atoi(c) : 0;
 }
 
+/**
+ * @brief Parsuje linię "f ..." do listy narożników.
+ */
+int obj_parse_face_line(const char* line, int posCount, int uvCount, int norCount,
+                        int corners[][3], int maxCorners)
+{
+    const char* p = line;
+    while (*p && isspace((unsigned char)*p)) p++;
+    if (*p == 'f') p++;
+
+    int n = 0;
+    while (*p && n < maxCorners) {
+        while (*p && isspace((unsigned char)*p)) p++;
+        if (!*p) break;
+
+        // token do spacji
+        char tok[128];
+        int ti = 0;
+        while (*p && !isspace((unsigned char)*p) && ti < (int)sizeof(tok)-1) {
+            tok[ti++] = *p++;
+        }
+        tok[ti] = '\0';
+        if (ti == 0) break;
+
+        int v_i, t_i, n_i;
+        parse_face_token(tok, &v_i, &t_i, &n_i);
+
+        int vi0 = resolve_index(v_i, posCount);
+        if (vi0 < 0 || vi0 >= posCount) return -1;
+
+        corners[n][0] = vi0;
+        corners[n][1] = resolve_index(t_i, uvCount);
+        corners[n][2] = resolve_index(n_i, norCount);
+        n++;
+    }
+    return n;
+}
+
 /**
  * @brief Buduje Vertex (pos/normal/uv) na podstawie indeksów.
  *
@@ -281,13 +346,13 @@ static Vertex make_vertex(const FloatArray* pos, const FloatArray* uv, const Flo
     v.position[1] = pos->data[vi*3 + 1];
     v.position[2] = pos->data[vi*3 + 2];
 
-    // normal (jeśli brak -> default 0,0,1)
+    // normal (jeśli brak -> 0,0,0; policzy ją normals_generate())
     if (ni >= 0 && (size_t)(ni*3 + 2) < nor->count) {
         v.normal[0] = nor->data[ni*3 + 0];
         v.normal[1] = nor->data[ni*3 + 1];
         v.normal[2] = nor->data[ni*3 + 2];
     } else {
-        v.normal[0] = 0.0f; v.normal[1] = 0.0f; v.normal[2] = 1.0f;
+        v.normal[0] = 0.0f; v.normal[1] = 0.0f; v.normal[2] = 0.0f;
     }
 
     // texcoord (jeśli brak -> 0,0)
@@ -305,6 +370,14 @@ static Vertex make_vertex(const FloatArray* pos, const FloatArray* uv, const Flo
  * @brief Wczytuje OBJ i tworzy unikalne wierzchołki + indeksy.
  */
 int obj_load(const char* path, ObjModelData* out)
+{
+    return obj_load_ex(path, out, NULL);
+}
+
+/**
+ * @brief Wczytuje OBJ; brakujące normalne są generowane po zbudowaniu indeksów.
+ */
+int obj_load_ex(const char* path, ObjModelData* out, const NormalGenParams* normalParams)
 {
     if (!out) return 0;
     memset(out, 0, sizeof(*out));
@@ -321,6 +394,7 @@ int obj_load(const char* path, ObjModelData* out)
 
     VertexArray vertices = {0};
     UIntArray indices    = {0};
+    SubmeshArray submeshes = {0};
 
     KeyMap map;
     map_init(&map, 1024);
@@ -331,6 +405,7 @@ int obj_load(const char* path, ObjModelData* out)
     int posCount = 0; // ile v
     int uvCount  = 0; // ile vt
     int norCount = 0; // ile vn
+    size_t missingNormals = 0; // wierzchołki bez poprawnego vn
 
     while (fgets(line, sizeof(line), f))
     {
@@ -374,42 +449,27 @@ int obj_load(const char* path, ObjModelData* out)
 
         // f
         if (s[0] == 'f' && isspace((unsigned char)s[1])) {
-            // zbierz tokeny wierzchołków face
             // obsłużymy dowolną liczbę wierzchołków i zrobimy triangulację fan
-            char* p = s + 1;
+            int corners[64][3];
+            int cornerN = obj_parse_face_line(s, posCount, uvCount, norCount, corners, 64);
+
+            if (cornerN < 0) {
+                printf("ERROR: face references invalid position index in %s\n", path);
+                fclose(f);
+                map_free(&map);
+                free(positions.data); free(texcoords.data); free(normals.data);
+                free(vertices.data); free(indices.data); free(submeshes.data);
+                return 0;
+            }
 
             // tymczasowo przechowamy indeksy wierzchołków face (po deduplikacji)
             unsigned int faceIdx[64];
             int faceN = 0;
 
-            while (*p) {
-                p = skip_ws(p);
-                if (!*p || *p == '\n' || *p == '\r') break;
-
-                // token do spacji
-                char tok[128];
-                int ti = 0;
-                while (*p && !isspace((unsigned char)*p) && ti < (int)sizeof(tok)-1) {
-                    tok[ti++] = *p++;
-                }
-                tok[ti] = '\0';
-                if (ti == 0) break;
-
-                int v_i, t_i, n_i;
-                parse_face_token(tok, &v_i, &t_i, &n_i);
-
-                int vi0 = resolve_index(v_i, posCount);
-                int ti0 = resolve_index(t_i, uvCount);
-                int ni0 = resolve_index(n_i, norCount);
-
-                if (vi0 < 0 || vi0 >= posCount) {
-                    printf("ERROR: face references invalid position index in %s\n", path);
-                    fclose(f);
-                    map_free(&map);
-                    free(positions.data); free(texcoords.data); free(normals.data);
-                    free(vertices.data); free(indices.data);
-                    return 0;
-                }
+            for (int c = 0; c < cornerN; c++) {
+                int vi0 = corners[c][0];
+                int ti0 = corners[c][1];
+                int ni0 = corners[c][2];
 
                 Key key = {vi0, ti0, ni0};
 
@@ -419,6 +479,7 @@ int obj_load(const char* path, ObjModelData* out)
 
                 if (inserted) {
                     Vertex vtx = make_vertex(&positions, &texcoords, &normals, vi0, ti0, ni0);
+                    if (ni0 < 0 || ni0 >= norCount) missingNormals++;
                     unsigned int newIndex = (unsigned int)vertices.count;
                     va_push(&vertices, vtx);
 
@@ -439,8 +500,6 @@ int obj_load(const char* path, ObjModelData* out)
                 } else {
                     faceIdx[faceN++] = existing;
                 }
-
-                if (faceN >= 64) break; // proste zabezpieczenie
             }
 
             // triangulacja fan: (0, i, i+1)
@@ -455,9 +514,28 @@ int obj_load(const char* path, ObjModelData* out)
             continue;
         }
 
-        // resztę ignorujemy na tym etapie (usemtl/mtllib zrobimy później)
+        // usemtl: kolejne ściany należą do innego materiału
+        if (strncmp(s, "usemtl", 6) == 0 && isspace((unsigned char)s[6])) {
+            char name[OBJ_MATERIAL_NAME] = "";
+            sscanf(s + 6, " %63s", name);
+            // ściany przed pierwszym usemtl -> zakres bez nazwy
+            if (submeshes.count == 0 && indices.count > 0)
+                sa_begin(&submeshes, "", 0);
+            sa_begin(&submeshes, name, indices.count);
+            continue;
+        }
+
+        // resztę ignorujemy (mtllib: viewer używa pliku MTL o stałej nazwie)
     }
 
+    // długości zakresów = odstępy między początkami
+    for (size_t i = 0; i < submeshes.count; i++) {
+        size_t end = (i + 1 < submeshes.count) ? submeshes.data[i + 1].index_offset : indices.count;
+        submeshes.data[i].index_count = end - submeshes.data[i].index_offset;
+    }
+    if (submeshes.count > 0 && submeshes.data[submeshes.count - 1].index_count == 0)
+        submeshes.count--;
+
     fclose(f);
     map_free(&map);
 
@@ -465,21 +543,54 @@ int obj_load(const char* path, ObjModelData* out)
     out->indices = indices.data;
     out->vertex_count = vertices.count;
     out->index_count = indices.count;
+    out->submeshes = submeshes.data;
+    out->submesh_count = submeshes.count;
 
     // pos/uv/nor już nie potrzebne po zbudowaniu VBO/EBO
+    size_t positionCount = positions.count;
     free(positions.data);
     free(texcoords.data);
     free(normals.data);
 
     if (out->vertex_count == 0 || out->index_count == 0) {
         printf("ERROR: OBJ produced empty mesh: %s\n", path);
+        // same linie v (skany LiDAR) -> tryb chmury punktów
+        if (positionCount > 0)
+            printf("       %zu vertices without faces: open it as a point cloud (--points FILE)\n",
+                   positionCount);
         obj_free(out);
         return 0;
     }
 
+    if (missingNormals > 0) {
+        NormalGenStats ns;
+        normals_generate(&out->vertices, &out->vertex_count, out->indices, out->index_count,
+                         normalParams, &ns);
+        printf("[normals] %zu vertices without vn: generated %zu (+%zu split) in %.1f ms, %d threads\n",
+               missingNormals, ns.generated, ns.split, ns.ms, ns.threads);
+    }
+
     return 1;
 }
 
+/**
+ * @brief AABB pozycji (0,0,0 dla pustego modelu).
+ */
+void obj_compute_bounds(const ObjModelData* data, float bmin[3], float bmax[3])
+{
+    for (int k = 0; k < 3; k++) {
+        bmin[k] = data->vertex_count ? data->vertices[0].position[k] : 0.0f;
+        bmax[k] = bmin[k];
+    }
+    for (size_t i = 1; i < data->vertex_count; i++) {
+        const float* p = data->vertices[i].position;
+        for (int k = 0; k < 3; k++) {
+            if (p[k] < bmin[k]) bmin[k] = p[k];
+            if (p[k] > bmax[k]) bmax[k] = p[k];
+        }
+    }
+}
+
 /**
  * @brief Zwalnia dane modelu OBJ.
  */
@@ -488,8 +599,11 @@ void obj_free(ObjModelData* data)
     if (!data) return;
     free(data->vertices);
     free(data->indices);
+    free(data->submeshes);
     data->vertices = NULL;
     data->indices = NULL;
+    data->submeshes = NULL;
     data->vertex_count = 0;
     data->index_count = 0;
+    data->submesh_count = 0;
 }
@@ -1,6 +1,18 @@
 #pragma once
 #include <stddef.h>
 #include "Mesh.h"
+#include "Normals.h"
+
+#define OBJ_MATERIAL_NAME 64
+
+/**
+ * @brief Ciągły zakres indeksów rysowany jednym materiałem (usemtl).
+ */
+typedef struct ObjSubmesh {
+    char material[OBJ_MATERIAL_NAME]; // nazwa z usemtl ("" przed pierwszym usemtl)
+    size_t index_offset;
+    size_t index_count;
+} ObjSubmesh;
 
 /**
  * @brief Wynik wczytania OBJ w postaci “CPU modelu”.
@@ -12,6 +24,9 @@ typedef struct ObjModelData {
     unsigned int* indices;
     size_t vertex_count;
     size_t index_count;
+
+    ObjSubmesh* submeshes;   // 0 zakresów -> plik bez usemtl (jeden materiał)
+    size_t submesh_count;
 } ObjModelData;
 
 /**
@@ -28,6 +43,44 @@ typedef struct ObjModelData {
  */
 int obj_load(const char* path, ObjModelData* out);
 
+/**
+ * @brief Jak obj_load(), z parametrami generowania brakujących normalnych.
+ *
+ * Wierzchołki bez vn dostają gładkie normalne z normals_generate().
+ *
+ * @param path    Ścieżka do pliku .obj.
+ * @param out     Struktura wyjściowa.
+ * @param normals Parametry generowania (NULL -> domyślne).
+ * @return 1 jeśli OK, 0 jeśli błąd.
+ */
+int obj_load_ex(const char* path, ObjModelData* out, const NormalGenParams* normals);
+
+/**
+ * @brief Parsuje linię ściany OBJ ("f v/t/n ...") do listy narożników.
+ *
+ * Używane przez obj_load() i narzędzia strumieniowe (np. budowa octree),
+ * które nie trzymają całego modelu w pamięci.
+ *
+ * @param line       Linia zaczynająca się od "f".
+ * @param posCount   Liczba dotychczasowych v (do indeksów ujemnych).
+ * @param uvCount    Liczba dotychczasowych vt.
+ * @param norCount   Liczba dotychczasowych vn.
+ * @param corners    Wyjście: {vi, ti, ni} 0-based, -1 jeśli brak vt/vn.
+ * @param maxCorners Maksymalna liczba narożników.
+ * @return Liczba narożników lub -1 jeśli indeks pozycji jest niepoprawny.
+ */
+int obj_parse_face_line(const char* line, int posCount, int uvCount, int norCount,
+                        int corners[][3], int maxCorners);
+
+/**
+ * @brief Liczy AABB pozycji wierzchołków modelu.
+ *
+ * @param data Dane modelu.
+ * @param bmin Minimum (wyjście).
+ * @param bmax Maksimum (wyjście).
+ */
+void obj_compute_bounds(const ObjModelData* data, float bmin[3], float bmax[3]);
+
 /**
  * @brief Zwalnia pamięć zaalokowaną w ObjModelData.
  *
@@ -0,0 +1,260 @@
+#include "OcclusionCull.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+}
+
+int occlusion_init(OcclusionCuller *oc, GLuint frame_binding, GLuint draw_binding, int enabled)
+{
+    static const float corners[8 * 3] = {
+        0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0,
+        0, 0, 1, 1, 0, 1, 1, 1, 1, 0, 1, 1,
+    };
+    static const unsigned short faces[36] = {
+        0, 2, 1, 0, 3, 2, // z = 0
+        4, 5, 6, 4, 6, 7, // z = 1
+        0, 1, 5, 0, 5, 4, // y = 0
+        3, 7, 6, 3, 6, 2, // y = 1
+        0, 4, 7, 0, 7, 3, // x = 0
+        1, 2, 6, 1, 6, 5, // x = 1
+    };
+
+    memset(oc, 0, sizeof(*oc));
+    oc->enabled = enabled;
+
+    // bez koloru: pusty shader fragmentów przebiegu głębi
+    oc->sh = shader_load_from_files("shaders/occlusion.vert", "shaders/depth.frag");
+    if (!oc->sh.id)
+        return 0;
+    shader_bind_block(oc->sh, "PerFrame", frame_binding);
+    shader_bind_block(oc->sh, "PerDraw", draw_binding);
+    oc->box_min_loc = glGetUniformLocation(oc->sh.id, "uBoxMin");
+    oc->box_max_loc = glGetUniformLocation(oc->sh.id, "uBoxMax");
+
+    glGenVertexArrays(1, &oc->vao);
+    glGenBuffers(1, &oc->vbo);
+    glGenBuffers(1, &oc->ebo);
+    glBindVertexArray(oc->vao);
+    glBindBuffer(GL_ARRAY_BUFFER, oc->vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, oc->ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(faces), faces, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)0);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glGenQueries(OCCLUSION_FRAMES, oc->timers);
+    return 1;
+}
+
+/**
+ * @brief Zapewnia obiekty [0, count) (nowe z parą zapytań).
+ */
+static int grow(OcclusionCuller *oc, size_t count)
+{
+    if (count <= oc->count)
+        return 1;
+
+    OcclusionObject *p = (OcclusionObject *)realloc(oc->objects, count * sizeof(*p));
+    if (!p)
+        return 0;
+    oc->objects = p;
+    for (size_t i = oc->count; i < count; i++)
+    {
+        memset(&p[i], 0, sizeof(p[i]));
+        glGenQueries(2, p[i].query);
+    }
+    oc->count = count;
+    return 1;
+}
+
+int occlusion_begin_frame(OcclusionCuller *oc, const float *view_proj)
+{
+    oc->frame++;
+    int changed = memcmp(oc->last_view_proj, view_proj, sizeof(oc->last_view_proj)) != 0;
+    memcpy(oc->last_view_proj, view_proj, sizeof(oc->last_view_proj));
+    return changed;
+}
+
+GLuint occlusion_query(OcclusionCuller *oc, int object, const float bmin[3], const float bmax[3],
+                       const float cam_model[3], const void *transform, RenderBindFn bind_transform)
+{
+    if (!oc->enabled || object < 0 || !grow(oc, (size_t)object + 1))
+        return 0;
+
+    OcclusionObject *o = &oc->objects[object];
+    int prev = (int)((oc->frame - 1) & 1);
+
+    // ściany pudełka przed powierzchnią siatki: siatka nie zasłania własnego testu
+    float dx = bmax[0] - bmin[0], dy = bmax[1] - bmin[1], dz = bmax[2] - bmin[2];
+    float margin = sqrtf(dx * dx + dy * dy + dz * dz) * OCCLUSION_BOX_MARGIN;
+    int inside = 1;
+    for (int k = 0; k < 3; k++)
+    {
+        o->bmin[k] = bmin[k] - margin;
+        o->bmax[k] = bmax[k] + margin;
+        if (cam_model[k] < o->bmin[k] - OCCLUSION_NEAR_MARGIN || cam_model[k] > o->bmax[k] + OCCLUSION_NEAR_MARGIN)
+            inside = 0;
+    }
+
+    // pudełko przecięte bliską płaszczyzną nie daje wiarygodnego wyniku
+    if (inside)
+    {
+        oc->stats.skipped++;
+        return 0;
+    }
+    o->test = 1;
+    o->transform = transform;
+    o->bind_transform = bind_transform;
+    return o->issued[prev] ? o->query[prev] : 0;
+}
+
+/**
+ * @brief Wynik zapytania sprzed dwóch klatek do statystyk (tylko gdy gotowy).
+ */
+static void collect_result(OcclusionCuller *oc, const OcclusionObject *o, int slot)
+{
+    if (!o->issued[slot])
+        return;
+
+    GLuint64 ready = 0;
+    glGetQueryObjectui64v(o->query[slot], GL_QUERY_RESULT_AVAILABLE, &ready);
+    if (!ready)
+    {
+        oc->stats.late++;
+        return;
+    }
+    GLuint64 any = 0;
+    glGetQueryObjectui64v(o->query[slot], GL_QUERY_RESULT, &any);
+    if (any)
+        oc->stats.visible++;
+    else
+        oc->stats.occluded++;
+}
+
+/**
+ * @brief Dolicza czas GPU przebiegu pudełek ze slotu (czeka, jeśli GPU jeszcze nie skończył).
+ */
+static void collect_timer(OcclusionCuller *oc, int slot)
+{
+    if (!oc->timer_pending[slot])
+        return;
+    GLuint64 ns = 0;
+    glGetQueryObjectui64v(oc->timers[slot], GL_QUERY_RESULT, &ns);
+    oc->stats.gpu_ms += (double)ns / 1.0e6;
+    oc->stats.gpu_frames++;
+    oc->timer_pending[slot] = 0;
+}
+
+void occlusion_test(OcclusionCuller *oc)
+{
+    int cur = (int)(oc->frame & 1);
+    oc->last_tested = 0;
+
+    if (!oc->enabled)
+    {
+        // po włączeniu pierwsza klatka rysuje bez warunku
+        for (size_t i = 0; i < oc->count; i++)
+            oc->objects[i].issued[0] = oc->objects[i].issued[1] = oc->objects[i].test = 0;
+        return;
+    }
+
+    double t0 = now_ms();
+    oc->timer_slot = (oc->timer_slot + 1) % OCCLUSION_FRAMES;
+    collect_timer(oc, oc->timer_slot);
+    glBeginQuery(GL_TIME_ELAPSED, oc->timers[oc->timer_slot]);
+
+    // GL_LEQUAL: pudełko na głębi siatki (margines 0 przy płaskiej ścianie) nadal widoczne
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDepthMask(GL_FALSE);
+    glDepthFunc(GL_LEQUAL);
+    glUseProgram(oc->sh.id);
+    glBindVertexArray(oc->vao);
+
+    const void *transform = NULL;
+    int transformOk = 1;
+    for (size_t i = 0; i < oc->count; i++)
+    {
+        OcclusionObject *o = &oc->objects[i];
+        if (!o->test)
+        {
+            // bez testu w tej klatce: następna nie może użyć starszego wyniku
+            o->issued[cur] = 0;
+            continue;
+        }
+        o->test = 0;
+        collect_result(oc, o, cur);
+
+        if (o->transform != transform)
+        {
+            transform = o->transform;
+            transformOk = !o->bind_transform || o->bind_transform(transform, oc->sh.id);
+        }
+        if (!transformOk)
+        {
+            // pudełko w złym miejscu dałoby błędny wynik: obiekt rysowany bez warunku
+            o->issued[cur] = 0;
+            continue;
+        }
+        glUniform3fv(oc->box_min_loc, 1, o->bmin);
+        glUniform3fv(oc->box_max_loc, 1, o->bmax);
+        glBeginQuery(GL_ANY_SAMPLES_PASSED, o->query[cur]);
+        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_SHORT, (void *)0);
+        glEndQuery(GL_ANY_SAMPLES_PASSED);
+        o->issued[cur] = 1;
+        oc->last_tested++;
+    }
+
+    glBindVertexArray(0);
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glEndQuery(GL_TIME_ELAPSED);
+    oc->timer_pending[oc->timer_slot] = 1;
+
+    oc->stats.frames++;
+    oc->stats.tested += oc->last_tested;
+    oc->stats.cpu_ms += now_ms() - t0;
+}
+
+void occlusion_print_stats(const OcclusionCuller *oc)
+{
+    const OcclusionStats *s = &oc->stats;
+    size_t results = s->visible + s->occluded;
+    printf("[occlusion] %s (F7), %zu boxes tested last frame, %zu times drawn unconditionally near the camera\n",
+           oc->enabled ? "ON" : "OFF", oc->last_tested, s->skipped);
+    if (s->frames == 0)
+        return;
+    printf("[occlusion] %zu results read: %zu visible, %zu occluded (%.1f%%: draws skipped next frame), "
+           "%zu not ready in time\n",
+           results, s->visible, s->occluded, results ? 100.0 * (double)s->occluded / (double)results : 0.0, s->late);
+    printf("[occlusion] query overhead: %.1f boxes/frame, CPU %.3f ms/frame, GPU %.3f ms/frame\n",
+           (double)s->tested / (double)s->frames, s->cpu_ms / (double)s->frames,
+           s->gpu_frames ? s->gpu_ms / (double)s->gpu_frames : 0.0);
+}
+
+void occlusion_destroy(OcclusionCuller *oc)
+{
+    for (size_t i = 0; i < oc->count; i++)
+        glDeleteQueries(2, oc->objects[i].query);
+    free(oc->objects);
+    if (oc->timers[0])
+        glDeleteQueries(OCCLUSION_FRAMES, oc->timers);
+    if (oc->vao)
+    {
+        glDeleteVertexArrays(1, &oc->vao);
+        glDeleteBuffers(1, &oc->vbo);
+        glDeleteBuffers(1, &oc->ebo);
+    }
+    shader_destroy(&oc->sh);
+    memset(oc, 0, sizeof(*oc));
+}
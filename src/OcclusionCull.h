@@ -0,0 +1,134 @@
+#pragma once
+#include <stddef.h>
+#include <glad/glad.h>
+
+#include "Shader.h"
+#include "Renderer.h"
+
+#define OCCLUSION_FRAMES 3          // zapytania czasu w locie (odczyt bez czekania na GPU)
+#define OCCLUSION_BOX_MARGIN 0.01f  // powiększenie AABB (część przekątnej): ściany nie na głębi siatki
+#define OCCLUSION_NEAR_MARGIN 0.2f  // kamera bliżej pudełka niż to -> bez testu (bliska płaszczyzna 0.1)
+
+/**
+ * @brief Jeden testowany obiekt (siatka albo instancja sceny).
+ *
+ * Dwa zapytania na zmianę: w klatce N testowane jest query[N & 1],
+ * a rysowanie zależy od query[(N - 1) & 1] z poprzedniej klatki.
+ */
+typedef struct OcclusionObject
+{
+    GLuint query[2];
+    int issued[2];   // zapytanie ma wynik (pudełko narysowane)
+    int counted[2];  // wynik doliczony do statystyk
+
+    int test;        // testować w tej klatce
+    float bmin[3];
+    float bmax[3];
+    const void *transform;
+    RenderBindFn bind_transform;
+} OcclusionObject;
+
+typedef struct OcclusionStats
+{
+    unsigned long frames;    // klatki z testem
+    size_t tested;           // pudełka narysowane z zapytaniem
+    size_t visible;          // odczytane wyniki: coś przeszło test głębi
+    size_t occluded;         // odczytane wyniki: zasłonięte -> rysowania w następnej klatce pominięte
+    size_t late;             // wynik niegotowy przed ponownym użyciem zapytania (nie liczony)
+    size_t skipped;          // kamera przy pudełku: rysowanie bez warunku
+    double cpu_ms;           // wywołania przebiegu pudełek
+    double gpu_ms;           // GPU: przebieg pudełek (GL_TIME_ELAPSED)
+    unsigned long gpu_frames;
+} OcclusionStats;
+
+/**
+ * @brief Sprzętowe zapytania o zasłonięcie z rysowaniem warunkowym.
+ *
+ * Po narysowaniu kolejki każdy obiekt, o który zapytano w tej klatce,
+ * rysuje swoje AABB (bez zapisu koloru i głębi) w zapytaniu
+ * GL_ANY_SAMPLES_PASSED. W następnej klatce rysowania obiektu idą
+ * w glBeginConditionalRender() z tym zapytaniem: GPU pomija je, jeśli
+ * żaden fragment pudełka nie był widoczny. CPU nie czyta wyników, więc
+ * nie czeka na GPU; spójność czasowa (obraz zmienia się niewiele między
+ * klatkami) sprawia, że wynik z poprzedniej klatki prawie zawsze pasuje.
+ * Odsłonięty obiekt pojawia się z opóźnieniem jednej klatki.
+ *
+ * Zasłonięty obiekt dalej rysuje pudełko, więc wraca, gdy tylko się
+ * odsłoni. Wyniki do statystyk są czytane dopiero przed ponownym użyciem
+ * zapytania (dwie klatki później) i tylko gdy są już gotowe.
+ *
+ * Obiekty są identyfikowane indeksem wybranym przez wołającego (model: 0,
+ * instancje sceny: kolejne); tablica rośnie w miarę potrzeby.
+ */
+typedef struct OcclusionCuller
+{
+    ShaderProgram sh;
+    GLint box_min_loc, box_max_loc;
+    GLuint vao, vbo, ebo;  // sześcian [0,1]^3
+
+    OcclusionObject *objects;
+    size_t count;
+    int enabled;
+    unsigned long frame;
+    float last_view_proj[16];
+
+    GLuint timers[OCCLUSION_FRAMES];
+    int timer_pending[OCCLUSION_FRAMES];
+    int timer_slot;
+
+    size_t last_tested;    // ostatnia klatka
+    OcclusionStats stats;
+} OcclusionCuller;
+
+/**
+ * @brief Wczytuje shader pudełek i tworzy sześcian.
+ *
+ * @param oc            Culler.
+ * @param frame_binding Punkt wiązania bloku PerFrame.
+ * @param draw_binding  Punkt wiązania bloku PerDraw.
+ * @param enabled       Tryb początkowy.
+ * @return 1 jeśli OK, 0 jeśli błąd.
+ */
+int occlusion_init(OcclusionCuller *oc, GLuint frame_binding, GLuint draw_binding, int enabled);
+
+/**
+ * @brief Zaczyna klatkę.
+ *
+ * @param oc        Culler.
+ * @param view_proj Macierz projekcja * widok.
+ * @return 1 jeśli widok zmienił się od poprzedniej klatki — wyniki tej
+ *         klatki trzeba zastosować w następnej (tryb on-demand).
+ */
+int occlusion_begin_frame(OcclusionCuller *oc, const float *view_proj);
+
+/**
+ * @brief Zgłasza obiekt do testu w tej klatce.
+ *
+ * @param oc             Culler.
+ * @param object         Indeks obiektu (>= 0).
+ * @param bmin           AABB w przestrzeni modelu.
+ * @param bmax
+ * @param cam_model      Pozycja kamery w przestrzeni modelu.
+ * @param transform      Transformacja (jak RenderItem.transform; ważna do occlusion_test()).
+ * @param bind_transform Ustawia transformację.
+ * @return Zapytanie dla RenderItem.occlusion_query (0 -> rysować bez warunku).
+ */
+GLuint occlusion_query(OcclusionCuller *oc, int object, const float bmin[3], const float bmax[3],
+                       const float cam_model[3], const void *transform, RenderBindFn bind_transform);
+
+/**
+ * @brief Po rysowaniu kolejki: pudełka zgłoszonych obiektów w zapytaniach.
+ *
+ * Po powrocie VAO 0, GL_LESS, zapis koloru i głębi włączony.
+ */
+void occlusion_test(OcclusionCuller *oc);
+
+/**
+ * @brief Wypisuje liczby testów, zasłoniętych obiektów i koszt zapytań.
+ */
+void occlusion_print_stats(const OcclusionCuller *oc);
+
+/**
+ * @brief Zwalnia zapytania, sześcian i shader.
+ */
+void occlusion_destroy(OcclusionCuller *oc);
@@ -0,0 +1,70 @@
+#pragma once
+#include <stdint.h>
+
+/**
+ * @brief Format pliku .oct — model podzielony na przestrzenne octree.
+ *
+ * Układ pliku:
+ *  - OctreeFileHeader (offset 0),
+ *  - dane liści: Vertex[vertex_count] + uint32 indeksy[index_count],
+ *    każdy chunk wyrównany do OCTREE_CHUNK_ALIGN,
+ *  - tablica OctreeNodeRecord[node_count] (offset node_table_offset).
+ *
+ * Węzły wewnętrzne nie mają geometrii (vertex_count == 0); liście mają
+ * jeden chunk gotowy do mesh_create(). Bounding box węzła to rzeczywisty
+ * AABB jego trójkątów (wewnętrzne: suma dzieci).
+ */
+
+#define OCTREE_MAGIC 0x3154434Fu /* "OCT1" */
+#define OCTREE_VERSION 1u
+#define OCTREE_CHUNK_ALIGN 4096u
+
+typedef struct OctreeFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t node_count;
+    uint32_t root;
+    float bmin[3];
+    float bmax[3];
+    uint64_t node_table_offset;
+} OctreeFileHeader;
+
+typedef struct OctreeNodeRecord
+{
+    float bmin[3];
+    float bmax[3];
+    int32_t child[8];      // -1 jeśli brak
+    uint64_t data_offset;  // offset chunku (liście)
+    uint32_t vertex_count;
+    uint32_t index_count;
+} OctreeNodeRecord;
+
+/**
+ * @brief Parametry podziału.
+ */
+typedef struct OctreeBuildParams
+{
+    unsigned int max_triangles; // maksymalna liczba trójkątów w liściu
+    unsigned int max_depth;     // maksymalna głębokość drzewa
+} OctreeBuildParams;
+
+/**
+ * @brief Domyślne parametry (64K trójkątów na liść, głębokość 16).
+ */
+void octree_build_params_default(OctreeBuildParams *p);
+
+/**
+ * @brief Dzieli model OBJ na octree i zapisuje plik .oct.
+ *
+ * Budowa jest strumieniowa (out-of-core): pozycje, UV i normalne trafiają
+ * do plików tymczasowych czytanych przez mmap, a trójkąty są rozdzielane
+ * na dzieci przez kolejne przebiegi po plikach kubełków. W pamięci jest
+ * naraz co najwyżej jeden liść.
+ *
+ * @param obj_path Wejściowy plik .obj.
+ * @param out_path Wyjściowy plik .oct (pliki tymczasowe obok niego).
+ * @param params   Parametry podziału (NULL = domyślne).
+ * @return 1 jeśli OK, 0 jeśli błąd.
+ */
+int octree_build_from_obj(const char *obj_path, const char *out_path, const OctreeBuildParams *params);
@@ -0,0 +1,623 @@
+#include "Octree.h"
+#include "ObjLoader.h"
+#include "MappedFile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <float.h>
+#include <time.h>
+
+/**
+ * @brief Trójkąt w pliku kubełka: środek ciężkości + 3 narożniki (vi,ti,ni).
+ */
+typedef struct TriRecord
+{
+    float centroid[3];
+    int32_t corner[3][3];
+} TriRecord;
+
+/**
+ * @brief Narożnik liścia do deduplikacji przez sortowanie.
+ */
+typedef struct LeafCorner
+{
+    int32_t vi, ti, ni;
+    uint32_t slot; // pozycja w tablicy indeksów liścia
+} LeafCorner;
+
+typedef struct OctreeBuilder
+{
+    OctreeBuildParams params;
+
+    MappedFile pos, uv, nor;
+    size_t posCount, uvCount, norCount;
+
+    FILE *out;
+    uint64_t out_offset;
+
+    OctreeNodeRecord *nodes;
+    size_t node_count;
+    size_t node_capacity;
+    size_t leaf_count;
+
+    char prefix[1024];
+    unsigned int serial;
+} OctreeBuilder;
+
+void octree_build_params_default(OctreeBuildParams *p)
+{
+    p->max_triangles = 65536;
+    p->max_depth = 16;
+}
+
+/* =========================================================
+   Pliki tymczasowe
+   ========================================================= */
+
+static void temp_path(const OctreeBuilder *b, const char *suffix, char *out, size_t outSize)
+{
+    snprintf(out, outSize, "%s.%s", b->prefix, suffix);
+}
+
+static void bucket_path(OctreeBuilder *b, char *out, size_t outSize)
+{
+    snprintf(out, outSize, "%s.b%u", b->prefix, b->serial++);
+}
+
+/**
+ * @brief Dopisuje zera, aby out_offset był wielokrotnością align.
+ */
+static int pad_output(OctreeBuilder *b, uint64_t align)
+{
+    static const unsigned char zeros[OCTREE_CHUNK_ALIGN] = {0};
+    uint64_t rem = b->out_offset % align;
+    if (rem == 0)
+        return 1;
+    size_t pad = (size_t)(align - rem);
+    if (fwrite(zeros, 1, pad, b->out) != pad)
+        return 0;
+    b->out_offset += pad;
+    return 1;
+}
+
+static int write_output(OctreeBuilder *b, const void *data, size_t bytes)
+{
+    if (bytes && fwrite(data, 1, bytes, b->out) != bytes)
+        return 0;
+    b->out_offset += bytes;
+    return 1;
+}
+
+/* =========================================================
+   Przebieg 1: strumieniowe czytanie OBJ
+   ========================================================= */
+
+/**
+ * @brief Rozdziela OBJ na pliki binarne: pozycje, UV, normalne, trójkąty.
+ */
+static int split_obj(OctreeBuilder *b, const char *obj_path, size_t *outTris,
+                     float bmin[3], float bmax[3])
+{
+    char pPos[1100], pUv[1100], pNor[1100], pTri[1100];
+    temp_path(b, "pos", pPos, sizeof(pPos));
+    temp_path(b, "uv", pUv, sizeof(pUv));
+    temp_path(b, "nor", pNor, sizeof(pNor));
+    temp_path(b, "tri", pTri, sizeof(pTri));
+
+    FILE *in = fopen(obj_path, "rb");
+    if (!in)
+    {
+        printf("ERROR: cannot open OBJ: %s\n", obj_path);
+        return 0;
+    }
+    FILE *fPos = fopen(pPos, "wb");
+    FILE *fUv = fopen(pUv, "wb");
+    FILE *fNor = fopen(pNor, "wb");
+    FILE *fTri = fopen(pTri, "wb");
+    if (!fPos || !fUv || !fNor || !fTri)
+    {
+        printf("ERROR: cannot create temporary files next to %s\n", b->prefix);
+        fclose(in);
+        if (fPos) fclose(fPos);
+        if (fUv) fclose(fUv);
+        if (fNor) fclose(fNor);
+        if (fTri) fclose(fTri);
+        return 0;
+    }
+
+    for (int k = 0; k < 3; k++)
+    {
+        bmin[k] = FLT_MAX;
+        bmax[k] = -FLT_MAX;
+    }
+
+    int ok = 1;
+    size_t tris = 0;
+    char line[1024];
+    while (ok && fgets(line, sizeof(line), in))
+    {
+        char *s = line;
+        while (*s && isspace((unsigned char)*s))
+            s++;
+
+        if (s[0] == 'v' && isspace((unsigned char)s[1]))
+        {
+            float p[3];
+            if (sscanf(s, "v %f %f %f", &p[0], &p[1], &p[2]) == 3)
+            {
+                fwrite(p, sizeof(float), 3, fPos);
+                for (int k = 0; k < 3; k++)
+                {
+                    if (p[k] < bmin[k]) bmin[k] = p[k];
+                    if (p[k] > bmax[k]) bmax[k] = p[k];
+                }
+                b->posCount++;
+            }
+        }
+        else if (s[0] == 'v' && s[1] == 't' && isspace((unsigned char)s[2]))
+        {
+            float t[2];
+            if (sscanf(s, "vt %f %f", &t[0], &t[1]) >= 2)
+            {
+                fwrite(t, sizeof(float), 2, fUv);
+                b->uvCount++;
+            }
+        }
+        else if (s[0] == 'v' && s[1] == 'n' && isspace((unsigned char)s[2]))
+        {
+            float n[3];
+            if (sscanf(s, "vn %f %f %f", &n[0], &n[1], &n[2]) == 3)
+            {
+                fwrite(n, sizeof(float), 3, fNor);
+                b->norCount++;
+            }
+        }
+        else if (s[0] == 'f' && isspace((unsigned char)s[1]))
+        {
+            int corners[64][3];
+            int n = obj_parse_face_line(s, (int)b->posCount, (int)b->uvCount, (int)b->norCount, corners, 64);
+            if (n < 0)
+            {
+                printf("ERROR: face references invalid position index in %s\n", obj_path);
+                ok = 0;
+                break;
+            }
+            // triangulacja fan jak w obj_load()
+            for (int i = 1; i + 1 < n; i++)
+            {
+                int32_t tri[9];
+                const int *c[3] = {corners[0], corners[i], corners[i + 1]};
+                for (int k = 0; k < 3; k++)
+                {
+                    tri[k * 3 + 0] = c[k][0];
+                    tri[k * 3 + 1] = c[k][1];
+                    tri[k * 3 + 2] = c[k][2];
+                }
+                if (fwrite(tri, sizeof(tri), 1, fTri) != 1)
+                {
+                    printf("ERROR: write failed (disk full?)\n");
+                    ok = 0;
+                    break;
+                }
+                tris++;
+            }
+        }
+    }
+
+    fclose(in);
+    if (fclose(fPos) || fclose(fUv) || fclose(fNor) || fclose(fTri))
+        ok = 0;
+
+    *outTris = tris;
+    return ok;
+}
+
+/* =========================================================
+   Przebieg 2: środki ciężkości -> kubełek korzenia
+   ========================================================= */
+
+static const float *position_at(const OctreeBuilder *b, int32_t vi)
+{
+    return (const float *)b->pos.data + (size_t)vi * 3;
+}
+
+static int write_root_bucket(OctreeBuilder *b, const char *rootPath)
+{
+    char pTri[1100];
+    temp_path(b, "tri", pTri, sizeof(pTri));
+
+    FILE *in = fopen(pTri, "rb");
+    FILE *out = fopen(rootPath, "wb");
+    if (!in || !out)
+    {
+        if (in) fclose(in);
+        if (out) fclose(out);
+        printf("ERROR: cannot create bucket file %s\n", rootPath);
+        return 0;
+    }
+
+    int32_t tri[9];
+    int ok = 1;
+    while (fread(tri, sizeof(tri), 1, in) == 1)
+    {
+        TriRecord r;
+        memcpy(r.corner, tri, sizeof(tri));
+        for (int k = 0; k < 3; k++)
+        {
+            r.centroid[k] = (position_at(b, tri[0])[k] +
+                             position_at(b, tri[3])[k] +
+                             position_at(b, tri[6])[k]) / 3.0f;
+        }
+        if (fwrite(&r, sizeof(r), 1, out) != 1)
+        {
+            ok = 0;
+            break;
+        }
+    }
+
+    fclose(in);
+    if (fclose(out))
+        ok = 0;
+    remove(pTri);
+    return ok;
+}
+
+/* =========================================================
+   Liście
+   ========================================================= */
+
+static int corner_cmp(const void *pa, const void *pb)
+{
+    const LeafCorner *a = (const LeafCorner *)pa;
+    const LeafCorner *b = (const LeafCorner *)pb;
+    if (a->vi != b->vi) return a->vi < b->vi ? -1 : 1;
+    if (a->ti != b->ti) return a->ti < b->ti ? -1 : 1;
+    if (a->ni != b->ni) return a->ni < b->ni ? -1 : 1;
+    return 0;
+}
+
+/**
+ * @brief Buduje Vertex z plików atrybutów (brak vn/vt -> jak w obj_load()).
+ *
+ * Brak vn -> normalna (0,0,0), uzupełniana potem przez normals_generate().
+ */
+static Vertex leaf_vertex(const OctreeBuilder *b, const LeafCorner *c)
+{
+    Vertex v;
+    memcpy(v.position, position_at(b, c->vi), sizeof(v.position));
+
+    if (c->ni >= 0 && (size_t)c->ni < b->norCount)
+        memcpy(v.normal, (const float *)b->nor.data + (size_t)c->ni * 3, sizeof(v.normal));
+    else
+    {
+        v.normal[0] = 0.0f; v.normal[1] = 0.0f; v.normal[2] = 0.0f;
+    }
+
+    if (c->ti >= 0 && (size_t)c->ti < b->uvCount)
+        memcpy(v.texcoord, (const float *)b->uv.data + (size_t)c->ti * 2, sizeof(v.texcoord));
+    else
+    {
+        v.texcoord[0] = 0.0f; v.texcoord[1] = 0.0f;
+    }
+    return v;
+}
+
+/**
+ * @brief Wczytuje kubełek liścia, deduplikuje wierzchołki i zapisuje chunk.
+ */
+static int write_leaf(OctreeBuilder *b, int nodeIdx, const char *path, size_t count)
+{
+    TriRecord *recs = (TriRecord *)malloc(count * sizeof(TriRecord));
+    LeafCorner *corners = (LeafCorner *)malloc(count * 3 * sizeof(LeafCorner));
+    uint32_t *indices = (uint32_t *)malloc(count * 3 * sizeof(uint32_t));
+    Vertex *verts = (Vertex *)malloc(count * 3 * sizeof(Vertex));
+    if (!recs || !corners || !indices || !verts)
+    {
+        printf("ERROR: leaf allocation failed (%zu triangles)\n", count);
+        free(recs); free(corners); free(indices); free(verts);
+        return 0;
+    }
+
+    FILE *in = fopen(path, "rb");
+    size_t got = in ? fread(recs, sizeof(TriRecord), count, in) : 0;
+    if (in)
+        fclose(in);
+    if (got != count)
+    {
+        printf("ERROR: cannot read bucket file %s\n", path);
+        free(recs); free(corners); free(indices); free(verts);
+        return 0;
+    }
+
+    for (size_t t = 0; t < count; t++)
+    {
+        for (int k = 0; k < 3; k++)
+        {
+            LeafCorner *c = &corners[t * 3 + k];
+            c->vi = recs[t].corner[k][0];
+            c->ti = recs[t].corner[k][1];
+            c->ni = recs[t].corner[k][2];
+            c->slot = (uint32_t)(t * 3 + k);
+        }
+    }
+
+    // deduplikacja (vi,ti,ni): sortowanie zamiast mapy — liść jest mały
+    qsort(corners, count * 3, sizeof(LeafCorner), corner_cmp);
+
+    OctreeNodeRecord *node = &b->nodes[nodeIdx];
+    uint32_t vcount = 0;
+    int missingNormals = 0;
+    for (size_t i = 0; i < count * 3; i++)
+    {
+        if (i == 0 || corner_cmp(&corners[i - 1], &corners[i]) != 0)
+        {
+            verts[vcount] = leaf_vertex(b, &corners[i]);
+            missingNormals |= corners[i].ni < 0 || (size_t)corners[i].ni >= b->norCount;
+            for (int k = 0; k < 3; k++)
+            {
+                float p = verts[vcount].position[k];
+                if (p < node->bmin[k]) node->bmin[k] = p;
+                if (p > node->bmax[k]) node->bmax[k] = p;
+            }
+            vcount++;
+        }
+        indices[corners[i].slot] = vcount - 1;
+    }
+
+    // normalne liczone w obrębie liścia (na granicy liści mogą być lekkie szwy)
+    if (missingNormals)
+    {
+        size_t n = vcount;
+        NormalGenParams np = normal_gen_params_default();
+        np.threads = 1;
+        normals_generate(&verts, &n, indices, count * 3, &np, NULL);
+        vcount = (uint32_t)n;
+    }
+
+    int ok = pad_output(b, OCTREE_CHUNK_ALIGN);
+    node->data_offset = b->out_offset;
+    node->vertex_count = vcount;
+    node->index_count = (uint32_t)(count * 3);
+    ok = ok && write_output(b, verts, vcount * sizeof(Vertex));
+    ok = ok && write_output(b, indices, count * 3 * sizeof(uint32_t));
+    if (!ok)
+        printf("ERROR: write failed (disk full?)\n");
+
+    b->leaf_count++;
+    free(recs); free(corners); free(indices); free(verts);
+    return ok;
+}
+
+/* =========================================================
+   Podział rekurencyjny
+   ========================================================= */
+
+static int push_node(OctreeBuilder *b)
+{
+    if (b->node_count + 1 > b->node_capacity)
+    {
+        size_t newCap = b->node_capacity ? b->node_capacity * 2 : 256;
+        OctreeNodeRecord *n = (OctreeNodeRecord *)realloc(b->nodes, newCap * sizeof(OctreeNodeRecord));
+        if (!n)
+            return -1;
+        b->nodes = n;
+        b->node_capacity = newCap;
+    }
+
+    OctreeNodeRecord *node = &b->nodes[b->node_count];
+    memset(node, 0, sizeof(*node));
+    for (int k = 0; k < 3; k++)
+    {
+        node->bmin[k] = FLT_MAX;
+        node->bmax[k] = -FLT_MAX;
+    }
+    for (int c = 0; c < 8; c++)
+        node->child[c] = -1;
+    return (int)b->node_count++;
+}
+
+/**
+ * @brief Buduje węzeł z kubełka; plik kubełka jest usuwany.
+ *
+ * @return Indeks węzła lub -1 jeśli błąd.
+ */
+static int build_node(OctreeBuilder *b, const char *path, size_t count,
+                      const float cellMin[3], const float cellMax[3], unsigned int depth)
+{
+    int idx = push_node(b);
+    if (idx < 0)
+    {
+        printf("ERROR: octree node allocation failed\n");
+        remove(path);
+        return -1;
+    }
+
+    if (count <= b->params.max_triangles || depth >= b->params.max_depth)
+    {
+        int ok = write_leaf(b, idx, path, count);
+        remove(path);
+        return ok ? idx : -1;
+    }
+
+    float center[3];
+    for (int k = 0; k < 3; k++)
+        center[k] = 0.5f * (cellMin[k] + cellMax[k]);
+
+    char childPath[8][1100];
+    FILE *childFile[8];
+    size_t childCount[8] = {0};
+    for (int c = 0; c < 8; c++)
+    {
+        bucket_path(b, childPath[c], sizeof(childPath[c]));
+        childFile[c] = fopen(childPath[c], "wb");
+        if (!childFile[c])
+        {
+            printf("ERROR: cannot create bucket file %s\n", childPath[c]);
+            for (int k = 0; k < c; k++)
+            {
+                fclose(childFile[k]);
+                remove(childPath[k]);
+            }
+            remove(path);
+            return -1;
+        }
+    }
+
+    // rozdział trójkątów wg oktantu środka ciężkości
+    FILE *in = fopen(path, "rb");
+    int ok = in != NULL;
+    TriRecord r;
+    while (ok && fread(&r, sizeof(r), 1, in) == 1)
+    {
+        int o = (r.centroid[0] >= center[0]) |
+                ((r.centroid[1] >= center[1]) << 1) |
+                ((r.centroid[2] >= center[2]) << 2);
+        ok = fwrite(&r, sizeof(r), 1, childFile[o]) == 1;
+        childCount[o]++;
+    }
+    if (in)
+        fclose(in);
+    remove(path);
+    for (int c = 0; c < 8; c++)
+    {
+        if (fclose(childFile[c]))
+            ok = 0;
+    }
+    if (!ok)
+    {
+        printf("ERROR: octree bucket split failed\n");
+        for (int c = 0; c < 8; c++)
+            remove(childPath[c]);
+        return -1;
+    }
+
+    for (int c = 0; c < 8; c++)
+    {
+        if (childCount[c] == 0)
+        {
+            remove(childPath[c]);
+            continue;
+        }
+
+        float cMin[3], cMax[3];
+        for (int k = 0; k < 3; k++)
+        {
+            int upper = (c >> k) & 1;
+            cMin[k] = upper ? center[k] : cellMin[k];
+            cMax[k] = upper ? cellMax[k] : center[k];
+        }
+
+        int ci = build_node(b, childPath[c], childCount[c], cMin, cMax, depth + 1);
+        if (ci < 0)
+        {
+            for (int k = c + 1; k < 8; k++)
+                remove(childPath[k]);
+            return -1;
+        }
+
+        // b->nodes mógł zostać przealokowany — tylko przez indeks
+        b->nodes[idx].child[c] = ci;
+        for (int k = 0; k < 3; k++)
+        {
+            if (b->nodes[ci].bmin[k] < b->nodes[idx].bmin[k]) b->nodes[idx].bmin[k] = b->nodes[ci].bmin[k];
+            if (b->nodes[ci].bmax[k] > b->nodes[idx].bmax[k]) b->nodes[idx].bmax[k] = b->nodes[ci].bmax[k];
+        }
+    }
+
+    return idx;
+}
+
+/* =========================================================
+   API
+   ========================================================= */
+
+int octree_build_from_obj(const char *obj_path, const char *out_path, const OctreeBuildParams *params)
+{
+    clock_t t0 = clock();
+
+    OctreeBuilder b;
+    memset(&b, 0, sizeof(b));
+    if (params)
+        b.params = *params;
+    else
+        octree_build_params_default(&b.params);
+    if (b.params.max_triangles == 0)
+        b.params.max_triangles = 1;
+    snprintf(b.prefix, sizeof(b.prefix), "%s.tmp", out_path);
+
+    char pPos[1100], pUv[1100], pNor[1100], rootPath[1100];
+    temp_path(&b, "pos", pPos, sizeof(pPos));
+    temp_path(&b, "uv", pUv, sizeof(pUv));
+    temp_path(&b, "nor", pNor, sizeof(pNor));
+
+    size_t triCount = 0;
+    float bmin[3], bmax[3];
+    int ok = split_obj(&b, obj_path, &triCount, bmin, bmax);
+    if (ok && triCount == 0)
+    {
+        printf("ERROR: OBJ has no faces: %s\n", obj_path);
+        ok = 0;
+    }
+
+    ok = ok && mapped_file_open(pPos, &b.pos);
+    ok = ok && (b.uvCount == 0 || mapped_file_open(pUv, &b.uv));
+    ok = ok && (b.norCount == 0 || mapped_file_open(pNor, &b.nor));
+
+    bucket_path(&b, rootPath, sizeof(rootPath));
+    ok = ok && write_root_bucket(&b, rootPath);
+
+    b.out = ok ? fopen(out_path, "wb") : NULL;
+    if (ok && !b.out)
+    {
+        printf("ERROR: cannot create %s\n", out_path);
+        ok = 0;
+    }
+
+    OctreeFileHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    ok = ok && write_output(&b, &hdr, sizeof(hdr)); // nagłówek uzupełniany na końcu
+
+    int root = ok ? build_node(&b, rootPath, triCount, bmin, bmax, 0) : -1;
+    ok = ok && root >= 0;
+
+    if (ok)
+    {
+        ok = pad_output(&b, 8);
+        hdr.magic = OCTREE_MAGIC;
+        hdr.version = OCTREE_VERSION;
+        hdr.node_count = (uint32_t)b.node_count;
+        hdr.root = (uint32_t)root;
+        memcpy(hdr.bmin, b.nodes[root].bmin, sizeof(hdr.bmin));
+        memcpy(hdr.bmax, b.nodes[root].bmax, sizeof(hdr.bmax));
+        hdr.node_table_offset = b.out_offset;
+        ok = ok && write_output(&b, b.nodes, b.node_count * sizeof(OctreeNodeRecord));
+        ok = ok && fseek(b.out, 0, SEEK_SET) == 0;
+        ok = ok && fwrite(&hdr, sizeof(hdr), 1, b.out) == 1;
+    }
+
+    if (b.out && fclose(b.out))
+        ok = 0;
+    mapped_file_close(&b.pos);
+    mapped_file_close(&b.uv);
+    mapped_file_close(&b.nor);
+    remove(pPos);
+    remove(pUv);
+    remove(pNor);
+    remove(rootPath);
+
+    if (ok)
+    {
+        printf("Octree: %zu triangles -> %zu nodes (%zu leaves), %.1f MB, %.2f s\n",
+               triCount, b.node_count, b.leaf_count,
+               (double)b.out_offset / (1024.0 * 1024.0),
+               (double)(clock() - t0) / CLOCKS_PER_SEC);
+    }
+    else
+    {
+        remove(out_path);
+    }
+
+    free(b.nodes);
+    return ok;
+}
@@ -0,0 +1,474 @@
+#include "OctreePager.h"
+#include <stdlib.h>
+#include <string.h>
+#include <GLFW/glfw3.h>
+
+/* =========================================================
+   I/O (offsety 64-bit)
+   ========================================================= */
+
+static int file_seek64(FILE *f, uint64_t offset)
+{
+#ifdef _WIN32
+    return _fseeki64(f, (long long)offset, SEEK_SET) == 0;
+#else
+    return fseeko(f, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+static size_t chunk_bytes(const OctreeNodeRecord *n)
+{
+    return (size_t)n->vertex_count * sizeof(Vertex) + (size_t)n->index_count * sizeof(uint32_t);
+}
+
+/**
+ * @brief Wątek I/O: czyta najważniejszy oczekujący chunk, jeśli mieści
+ *        się w budżecie CPU. Nie dotyka OpenGL.
+ */
+static void *io_thread_main(void *arg)
+{
+    OctreePager *p = (OctreePager *)arg;
+
+    FILE *f = fopen(p->path, "rb");
+    if (!f)
+    {
+        printf("ERROR: pager cannot open %s\n", p->path);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&p->lock);
+    while (!p->quit)
+    {
+        int pick = -1;
+        for (size_t i = 0; i < p->request_count; i++)
+        {
+            int n = p->requests[i];
+            if (p->rt[n].state == OCT_NODE_QUEUED &&
+                p->cpu_used + p->rt[n].bytes <= p->cpu_budget)
+            {
+                pick = n;
+                break;
+            }
+        }
+        if (pick < 0)
+        {
+            pthread_cond_wait(&p->cond, &p->lock);
+            continue;
+        }
+
+        // rezerwacja budżetu przed czytaniem
+        OctreePagerNode *node = &p->rt[pick];
+        size_t bytes = node->bytes;
+        uint64_t offset = p->nodes[pick].data_offset;
+        node->state = OCT_NODE_LOADING;
+        p->cpu_used += bytes;
+        pthread_mutex_unlock(&p->lock);
+
+        void *buf = malloc(bytes);
+        int ok = buf && file_seek64(f, offset) && fread(buf, 1, bytes, f) == bytes;
+
+        pthread_mutex_lock(&p->lock);
+        if (ok)
+        {
+            node->cpu_data = buf;
+            node->state = OCT_NODE_CPU;
+            p->loads_total++;
+        }
+        else
+        {
+            printf("ERROR: pager failed to read node %d\n", pick);
+            free(buf);
+            node->state = OCT_NODE_EMPTY;
+            p->cpu_used -= bytes;
+        }
+        pthread_mutex_unlock(&p->lock);
+
+        // obudź pętlę renderującą (tryb on-demand czeka na zdarzenia)
+        glfwPostEmptyEvent();
+
+        pthread_mutex_lock(&p->lock);
+    }
+    pthread_mutex_unlock(&p->lock);
+
+    fclose(f);
+    return NULL;
+}
+
+/* =========================================================
+   Otwieranie / zamykanie
+   ========================================================= */
+
+int octree_pager_open(OctreePager *p, const char *path, size_t cpu_budget, size_t gpu_budget)
+{
+    memset(p, 0, sizeof(*p));
+    snprintf(p->path, sizeof(p->path), "%s", path);
+    p->cpu_budget = cpu_budget;
+    p->gpu_budget = gpu_budget;
+    p->upload_budget = 16u * 1024u * 1024u;
+
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        printf("ERROR: cannot open octree: %s\n", path);
+        return 0;
+    }
+
+    int ok = fread(&p->header, sizeof(p->header), 1, f) == 1 &&
+             p->header.magic == OCTREE_MAGIC &&
+             p->header.version == OCTREE_VERSION &&
+             p->header.node_count > 0 &&
+             p->header.root < p->header.node_count;
+    if (ok)
+    {
+        size_t n = p->header.node_count;
+        p->nodes = (OctreeNodeRecord *)malloc(n * sizeof(OctreeNodeRecord));
+        p->rt = (OctreePagerNode *)calloc(n, sizeof(OctreePagerNode));
+        p->visible = (OctreeVisibleLeaf *)malloc(n * sizeof(OctreeVisibleLeaf));
+        p->stack = (int *)malloc(n * sizeof(int));
+        p->requests = (int *)malloc(n * sizeof(int));
+        ok = p->nodes && p->rt && p->visible && p->stack && p->requests &&
+             file_seek64(f, p->header.node_table_offset) &&
+             fread(p->nodes, sizeof(OctreeNodeRecord), n, f) == n;
+    }
+    fclose(f);
+
+    if (!ok)
+    {
+        printf("ERROR: invalid octree file: %s\n", path);
+        octree_pager_close(p);
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < p->header.node_count; i++)
+        p->rt[i].bytes = chunk_bytes(&p->nodes[i]);
+
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->cond, NULL);
+    if (pthread_create(&p->thread, NULL, io_thread_main, p) != 0)
+    {
+        printf("ERROR: cannot start pager I/O thread\n");
+        pthread_cond_destroy(&p->cond);
+        pthread_mutex_destroy(&p->lock);
+        octree_pager_close(p);
+        return 0;
+    }
+    p->thread_started = 1;
+
+    printf("Octree: %u nodes, budgets CPU %zu MB / GPU %zu MB\n",
+           p->header.node_count, cpu_budget >> 20, gpu_budget >> 20);
+    return 1;
+}
+
+void octree_pager_close(OctreePager *p)
+{
+    if (!p)
+        return;
+
+    if (p->thread_started)
+    {
+        pthread_mutex_lock(&p->lock);
+        p->quit = 1;
+        pthread_cond_signal(&p->cond);
+        pthread_mutex_unlock(&p->lock);
+        pthread_join(p->thread, NULL);
+        pthread_cond_destroy(&p->cond);
+        pthread_mutex_destroy(&p->lock);
+    }
+
+    if (p->rt)
+    {
+        for (uint32_t i = 0; i < p->header.node_count; i++)
+        {
+            free(p->rt[i].cpu_data);
+            if (p->rt[i].mesh.VAO)
+                mesh_destroy(&p->rt[i].mesh);
+        }
+    }
+    free(p->nodes);
+    free(p->rt);
+    free(p->visible);
+    free(p->stack);
+    free(p->requests);
+    memset(p, 0, sizeof(*p));
+}
+
+/* =========================================================
+   Aktualizacja na klatkę
+   ========================================================= */
+
+static int visible_cmp(const void *pa, const void *pb)
+{
+    float a = ((const OctreeVisibleLeaf *)pa)->priority;
+    float b = ((const OctreeVisibleLeaf *)pb)->priority;
+    return (a < b) - (a > b); // malejąco
+}
+
+/**
+ * @brief Przejście drzewa z odrzucaniem poza frustum; zbiera liście.
+ */
+static void collect_visible(OctreePager *p, mat4 mvp, const vec3 cam_pos)
+{
+    vec4 planes[6];
+    glm_frustum_planes(mvp, planes);
+
+    size_t top = 0;
+    p->visible_count = 0;
+    p->stack[top++] = (int)p->header.root;
+
+    while (top > 0)
+    {
+        int n = p->stack[--top];
+        const OctreeNodeRecord *rec = &p->nodes[n];
+
+        vec3 box[2] = {{rec->bmin[0], rec->bmin[1], rec->bmin[2]},
+                       {rec->bmax[0], rec->bmax[1], rec->bmax[2]}};
+        if (!glm_aabb_frustum(box, planes))
+            continue;
+
+        if (rec->vertex_count > 0)
+        {
+            // priorytet: promień AABB / odległość (rozmiar kątowy)
+            vec3 center, half;
+            glm_vec3_add(box[0], box[1], center);
+            glm_vec3_scale(center, 0.5f, center);
+            glm_vec3_sub(box[1], center, half);
+            float radius = glm_vec3_norm(half);
+            float dist = glm_vec3_distance(center, (float *)cam_pos) - radius;
+
+            OctreeVisibleLeaf *v = &p->visible[p->visible_count++];
+            v->node = n;
+            v->priority = radius / (dist > 1e-3f ? dist : 1e-3f);
+            p->rt[n].last_used = p->frame;
+        }
+
+        for (int c = 0; c < 8; c++)
+        {
+            if (rec->child[c] >= 0)
+                p->stack[top++] = rec->child[c];
+        }
+    }
+
+    qsort(p->visible, p->visible_count, sizeof(OctreeVisibleLeaf), visible_cmp);
+}
+
+/**
+ * @brief Zwalnia z GPU najdawniej używany liść spoza bieżącego zestawu.
+ *
+ * @return 1 jeśli coś zwolniono.
+ */
+static int evict_gpu_lru(OctreePager *p)
+{
+    int victim = -1;
+    for (uint32_t i = 0; i < p->header.node_count; i++)
+    {
+        const OctreePagerNode *n = &p->rt[i];
+        if (!n->mesh.VAO || n->wanted_frame == p->frame)
+            continue;
+        if (victim < 0 || n->last_used < p->rt[victim].last_used)
+            victim = (int)i;
+    }
+    if (victim < 0)
+        return 0;
+
+    mesh_destroy(&p->rt[victim].mesh);
+    p->gpu_used -= p->rt[victim].bytes;
+    p->evictions_gpu++;
+    return 1;
+}
+
+/**
+ * @brief Zwalnia z RAM najdawniej używany chunk (wywoływać pod lock).
+ *
+ * Najpierw liście niechciane, potem chciane, które są już na GPU.
+ * @return 1 jeśli coś zwolniono.
+ */
+static int evict_cpu_lru(OctreePager *p)
+{
+    int victim = -1;
+    int victimWanted = 1;
+    for (uint32_t i = 0; i < p->header.node_count; i++)
+    {
+        const OctreePagerNode *n = &p->rt[i];
+        if (n->state != OCT_NODE_CPU)
+            continue;
+
+        int wanted = n->wanted_frame == p->frame;
+        if (wanted && !n->mesh.VAO)
+            continue; // czeka na upload
+
+        if (victim < 0 || wanted < victimWanted ||
+            (wanted == victimWanted && n->last_used < p->rt[victim].last_used))
+        {
+            victim = (int)i;
+            victimWanted = wanted;
+        }
+    }
+    if (victim < 0)
+        return 0;
+
+    free(p->rt[victim].cpu_data);
+    p->rt[victim].cpu_data = NULL;
+    p->rt[victim].state = OCT_NODE_EMPTY;
+    p->cpu_used -= p->rt[victim].bytes;
+    p->evictions_cpu++;
+    return 1;
+}
+
+size_t octree_pager_update(OctreePager *p, mat4 mvp, const vec3 cam_pos)
+{
+    p->frame++;
+    collect_visible(p, mvp, cam_pos);
+
+    // prefiks widocznych mieszczący się w budżecie GPU
+    size_t wanted = 0, wantedBytes = 0;
+    while (wanted < p->visible_count)
+    {
+        size_t b = p->rt[p->visible[wanted].node].bytes;
+        if (wantedBytes + b > p->gpu_budget)
+            break;
+        wantedBytes += b;
+        p->rt[p->visible[wanted].node].wanted_frame = p->frame;
+        wanted++;
+    }
+
+    /* ---------- kolejka I/O + cache CPU ---------- */
+    pthread_mutex_lock(&p->lock);
+
+    for (size_t i = 0; i < p->request_count; i++)
+    {
+        OctreePagerNode *n = &p->rt[p->requests[i]];
+        if (n->state == OCT_NODE_QUEUED && n->wanted_frame != p->frame)
+            n->state = OCT_NODE_EMPTY;
+    }
+
+    p->request_count = 0;
+    size_t firstNeed = 0;
+    for (size_t i = 0; i < wanted; i++)
+    {
+        int id = p->visible[i].node;
+        OctreePagerNode *n = &p->rt[id];
+        // chunk większy niż cały budżet RAM nigdy nie zostanie wczytany: bez żądania
+        if (n->bytes > p->cpu_budget)
+            continue;
+        if (n->state == OCT_NODE_EMPTY || n->state == OCT_NODE_QUEUED)
+        {
+            if (p->request_count == 0)
+                firstNeed = n->bytes;
+            n->state = OCT_NODE_QUEUED;
+            p->requests[p->request_count++] = id;
+        }
+    }
+
+    // zrób miejsce w RAM dla najważniejszego żądania
+    while (p->request_count > 0 && p->cpu_used + firstNeed > p->cpu_budget)
+    {
+        if (!evict_cpu_lru(p))
+            break;
+    }
+
+    if (p->request_count > 0)
+        pthread_cond_signal(&p->cond);
+
+    // migawka: które chciane liście mają już dane w RAM
+    // (stan OCT_NODE_CPU zmienia potem tylko wątek główny)
+    int *ready = p->stack;
+    size_t readyCount = 0;
+    for (size_t i = 0; i < wanted; i++)
+    {
+        int id = p->visible[i].node;
+        if (p->rt[id].state == OCT_NODE_CPU && !p->rt[id].mesh.VAO)
+            ready[readyCount++] = id;
+    }
+    pthread_mutex_unlock(&p->lock);
+
+    /* ---------- upload (limit na klatkę) ---------- */
+    size_t uploaded = 0, uploadedBytes = 0;
+    for (size_t i = 0; i < readyCount; i++)
+    {
+        int id = ready[i];
+        OctreePagerNode *n = &p->rt[id];
+
+        if (uploaded > 0 && uploadedBytes + n->bytes > p->upload_budget)
+            break;
+        while (p->gpu_used + n->bytes > p->gpu_budget)
+        {
+            if (!evict_gpu_lru(p))
+                break;
+        }
+        if (p->gpu_used + n->bytes > p->gpu_budget)
+            break;
+
+        const OctreeNodeRecord *rec = &p->nodes[id];
+        const Vertex *verts = (const Vertex *)n->cpu_data;
+        const unsigned int *idx = (const unsigned int *)(verts + rec->vertex_count);
+        // bez strumienia pozycji: paged nie ma przebiegu głębi, a chunk_bytes() go nie liczy
+        n->mesh = mesh_create_ex(verts, rec->vertex_count, idx, rec->index_count, 0);
+
+        p->gpu_used += n->bytes;
+        uploadedBytes += n->bytes;
+        uploaded++;
+        p->uploads_total++;
+    }
+
+    return uploaded;
+}
+
+size_t octree_pager_draw(const OctreePager *p)
+{
+    size_t drawn = 0;
+    for (size_t i = 0; i < p->visible_count; i++)
+    {
+        const Mesh *m = &p->rt[p->visible[i].node].mesh;
+        if (m->VAO)
+        {
+            mesh_draw(m);
+            drawn++;
+        }
+    }
+    return drawn;
+}
+
+int octree_pager_busy(OctreePager *p)
+{
+    pthread_mutex_lock(&p->lock);
+    int busy = 0;
+    for (size_t i = 0; i < p->request_count && !busy; i++)
+    {
+        // żądanie ponad wolny budżet czeka, aż upload (sam zgłasza klatkę) pozwoli na eviction;
+        // liczone jako praca trzymałoby pętlę on-demand w ruchu bez postępu
+        const OctreePagerNode *n = &p->rt[p->requests[i]];
+        busy = n->state == OCT_NODE_LOADING ||
+               (n->state == OCT_NODE_QUEUED && p->cpu_used + n->bytes <= p->cpu_budget);
+    }
+    pthread_mutex_unlock(&p->lock);
+    return busy;
+}
+
+void octree_pager_print_stats(OctreePager *p)
+{
+    size_t onGpu = 0, inCpu = 0, drawable = 0;
+    pthread_mutex_lock(&p->lock);
+    for (uint32_t i = 0; i < p->header.node_count; i++)
+    {
+        if (p->rt[i].mesh.VAO)
+            onGpu++;
+        if (p->rt[i].state == OCT_NODE_CPU)
+            inCpu++;
+    }
+    size_t cpuUsed = p->cpu_used;
+    size_t loads = p->loads_total;
+    pthread_mutex_unlock(&p->lock);
+
+    for (size_t i = 0; i < p->visible_count; i++)
+    {
+        if (p->rt[p->visible[i].node].mesh.VAO)
+            drawable++;
+    }
+
+    printf("[octree] visible %zu (drawn %zu) | GPU %zu nodes %.1f/%.1f MB | CPU %zu nodes %.1f/%.1f MB"
+           " | loads %zu uploads %zu evict gpu %zu cpu %zu\n",
+           p->visible_count, drawable,
+           onGpu, (double)p->gpu_used / 1048576.0, (double)p->gpu_budget / 1048576.0,
+           inCpu, (double)cpuUsed / 1048576.0, (double)p->cpu_budget / 1048576.0,
+           loads, p->uploads_total, p->evictions_gpu, p->evictions_cpu);
+}
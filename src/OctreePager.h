@@ -0,0 +1,137 @@
+#pragma once
+#include <stddef.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <cglm/cglm.h>
+
+#include "Octree.h"
+#include "Mesh.h"
+
+/**
+ * @brief Stan liścia po stronie CPU.
+ */
+typedef enum OctreeNodeState
+{
+    OCT_NODE_EMPTY = 0, // brak danych w RAM
+    OCT_NODE_QUEUED,    // w kolejce do wczytania
+    OCT_NODE_LOADING,   // wątek I/O właśnie czyta
+    OCT_NODE_CPU        // dane w RAM (cache)
+} OctreeNodeState;
+
+/**
+ * @brief Stan węzła w czasie działania.
+ */
+typedef struct OctreePagerNode
+{
+    int state;            // OctreeNodeState (chroniony mutexem)
+    void *cpu_data;       // Vertex[] + uint32[] (gdy OCT_NODE_CPU)
+    size_t bytes;         // rozmiar chunku (RAM i VRAM)
+    Mesh mesh;            // VAO == 0 jeśli nie ma na GPU
+    unsigned long last_used; // numer klatki ostatniej widoczności (LRU)
+    unsigned long wanted_frame; // klatka, w której liść mieścił się w budżecie GPU
+} OctreePagerNode;
+
+/**
+ * @brief Widoczny liść z priorytetem (rozmiar kątowy).
+ */
+typedef struct OctreeVisibleLeaf
+{
+    int node;
+    float priority;
+} OctreeVisibleLeaf;
+
+/**
+ * @brief Stronicowanie modelu .oct pod stałymi budżetami pamięci.
+ *
+ * Co klatkę (wątek główny):
+ *  - widoczne liście (frustum) sortowane są wg priorytetu
+ *    (rozmiar kątowy AABB),
+ *  - prefiks mieszczący się w budżecie GPU jest "chciany": brakujące
+ *    liście trafiają do kolejki wątku I/O,
+ *  - wczytane chunki są wysyłane na GPU (limit bajtów na klatkę),
+ *  - nadmiar ponad budżety GPU/CPU jest zwalniany wg LRU.
+ *
+ * Wątek I/O czyta chunki z dysku do RAM; wątek główny nigdy nie czeka
+ * na dysk (niewczytane liście po prostu nie są rysowane).
+ */
+typedef struct OctreePager
+{
+    OctreeFileHeader header;
+    OctreeNodeRecord *nodes;
+    OctreePagerNode *rt;
+    char path[1024];
+
+    size_t cpu_budget;
+    size_t gpu_budget;
+    size_t upload_budget; // bajty wysyłane na GPU w jednej klatce
+
+    size_t cpu_used;      // chroniony mutexem
+    size_t gpu_used;
+
+    /* komunikacja z wątkiem I/O (chroniona lock) */
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int thread_started;
+    int quit;
+    int *requests;        // liście do wczytania, od najważniejszego
+    size_t request_count;
+
+    /* wynik ostatniego octree_pager_update (wątek główny) */
+    OctreeVisibleLeaf *visible;
+    size_t visible_count;
+    int *stack;
+    unsigned long frame;
+
+    /* statystyki */
+    size_t uploads_total;
+    size_t evictions_gpu;
+    size_t evictions_cpu;
+    size_t loads_total;
+} OctreePager;
+
+/**
+ * @brief Otwiera plik .oct i uruchamia wątek I/O.
+ *
+ * @param p          Pager.
+ * @param path       Ścieżka do pliku .oct.
+ * @param cpu_budget Budżet RAM na chunki (bajty).
+ * @param gpu_budget Budżet VRAM na chunki (bajty).
+ * @return 1 jeśli OK, 0 jeśli błąd.
+ */
+int octree_pager_open(OctreePager *p, const char *path, size_t cpu_budget, size_t gpu_budget);
+
+/**
+ * @brief Aktualizacja na klatkę: widoczność, kolejka I/O, upload, eviction.
+ *
+ * @param p        Pager.
+ * @param mvp      Macierz projection * view * model.
+ * @param cam_pos  Pozycja kamery w przestrzeni modelu.
+ * @return Liczba liści wysłanych na GPU w tej klatce (0 = bez zmian).
+ */
+size_t octree_pager_update(OctreePager *p, mat4 mvp, const vec3 cam_pos);
+
+/**
+ * @brief Rysuje widoczne liście obecne na GPU.
+ *
+ * @return Liczba narysowanych liści.
+ */
+size_t octree_pager_draw(const OctreePager *p);
+
+/**
+ * @brief Czy wątek I/O ma jeszcze coś do zrobienia (do trybu on-demand).
+ *
+ * Liczą się tylko wczytywane chunki i żądania mieszczące się teraz
+ * w budżecie RAM — te, które wątek faktycznie może podjąć.
+ */
+int octree_pager_busy(OctreePager *p);
+
+/**
+ * @brief Wypisuje statystyki rezydencji.
+ */
+void octree_pager_print_stats(OctreePager *p);
+
+/**
+ * @brief Zatrzymuje wątek I/O i zwalnia wszystkie zasoby.
+ */
+void octree_pager_close(OctreePager *p);
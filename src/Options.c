@@ -0,0 +1,253 @@
+#include "Options.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Domyślne opcje: rysowanie ciągłe, bez doszlifowania.
+ */
+void options_init(AppOptions *o)
+{
+    memset(o, 0, sizeof(*o));
+    o->cpu_budget_mb = 512;
+    o->gpu_budget_mb = 512;
+    o->crease_angle = 180.0f;
+    o->weld_eps = 0.0f;
+    o->weld_angle = 10.0f;
+    o->weld_uv = 1.0e-3f;
+    o->point_budget_m = 10.0f;
+    o->point_error = 1.5f;
+    o->dynamic_res_min = 0.5f;
+}
+
+/**
+ * @brief Pobiera wartość opcji (kolejny argument).
+ *
+ * @return Wskaźnik na wartość lub NULL jeśli jej brak.
+ */
+static const char *option_value(int argc, char **argv, int *i)
+{
+    if (*i + 1 >= argc)
+    {
+        printf("ERROR: option %s requires a value\n", argv[*i]);
+        return NULL;
+    }
+    (*i)++;
+    return argv[*i];
+}
+
+/**
+ * @brief Wartość liczbowa opcji.
+ *
+ * @return 1 jeśli OK, 0 jeśli brak wartości.
+ */
+static int int_value(int argc, char **argv, int *i, int *out)
+{
+    const char *v = option_value(argc, argv, i);
+    if (!v)
+        return 0;
+    *out = atoi(v);
+    return 1;
+}
+
+/**
+ * @brief Wartość zmiennoprzecinkowa opcji.
+ *
+ * @return 1 jeśli OK, 0 jeśli brak wartości.
+ */
+static int float_value(int argc, char **argv, int *i, float *out)
+{
+    const char *v = option_value(argc, argv, i);
+    if (!v)
+        return 0;
+    *out = (float)atof(v);
+    return 1;
+}
+
+/**
+ * @brief Wartość tekstowa opcji (wskaźnik do argv).
+ *
+ * @return 1 jeśli OK, 0 jeśli brak wartości.
+ */
+static int str_value(int argc, char **argv, int *i, const char **out)
+{
+    const char *v = option_value(argc, argv, i);
+    if (!v)
+        return 0;
+    *out = v;
+    return 1;
+}
+
+/**
+ * @brief Parser opcji w stylu --nazwa [wartość].
+ */
+int options_parse(int argc, char **argv, AppOptions *out)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char *a = argv[i];
+        int ok = 1;
+
+        if (strcmp(a, "--on-demand") == 0)
+            out->on_demand = 1;
+        else if (strcmp(a, "--lights") == 0)
+            ok = int_value(argc, argv, &i, &out->lights);
+        else if (strcmp(a, "--bench-lights") == 0)
+            out->bench_lights = 1;
+        else if (strcmp(a, "--bench-queue") == 0)
+            ok = int_value(argc, argv, &i, &out->bench_queue);
+        else if (strcmp(a, "--depth-prepass") == 0)
+            out->depth_prepass = 1;
+        else if (strcmp(a, "--occlusion") == 0)
+            out->occlusion = 1;
+        else if (strcmp(a, "--dynamic-res") == 0)
+            ok = float_value(argc, argv, &i, &out->dynamic_res_ms);
+        else if (strcmp(a, "--dynamic-res-min") == 0)
+            ok = float_value(argc, argv, &i, &out->dynamic_res_min);
+        else if (strcmp(a, "--sharpen") == 0)
+            ok = float_value(argc, argv, &i, &out->sharpen);
+        else if (strcmp(a, "--pacing") == 0)
+            ok = int_value(argc, argv, &i, &out->max_frames_in_flight);
+        else if (strcmp(a, "--target-fps") == 0)
+            ok = float_value(argc, argv, &i, &out->target_fps);
+        else if (strcmp(a, "--serial-startup") == 0)
+            out->serial_startup = 1;
+        else if (strcmp(a, "--no-watch") == 0)
+            out->no_watch = 1;
+        else if (strcmp(a, "--no-tex-pack") == 0)
+            out->no_tex_pack = 1;
+        else if (strcmp(a, "--ring-unsync") == 0)
+            out->ring_unsync = 1;
+        else if (strcmp(a, "--capture") == 0)
+            ok = str_value(argc, argv, &i, &out->capture_path);
+        else if (strcmp(a, "--capture-sync") == 0)
+            out->capture_sync = 1;
+        else if (strcmp(a, "--record") == 0)
+            ok = str_value(argc, argv, &i, &out->record_path);
+        else if (strcmp(a, "--pack") == 0)
+            ok = str_value(argc, argv, &i, &out->pack_path);
+        else if (strcmp(a, "--octree") == 0)
+            ok = str_value(argc, argv, &i, &out->octree_path);
+        else if (strcmp(a, "--mesh") == 0)
+            ok = str_value(argc, argv, &i, &out->mesh_path);
+        else if (strcmp(a, "--objects") == 0)
+            ok = str_value(argc, argv, &i, &out->objects);
+        else if (strcmp(a, "--points") == 0)
+            ok = str_value(argc, argv, &i, &out->points_path);
+        else if (strcmp(a, "--point-budget") == 0)
+            ok = float_value(argc, argv, &i, &out->point_budget_m);
+        else if (strcmp(a, "--point-error") == 0)
+            ok = float_value(argc, argv, &i, &out->point_error);
+        else if (strcmp(a, "--scene") == 0)
+            ok = str_value(argc, argv, &i, &out->scene_path);
+        else if (strcmp(a, "--res-budget") == 0)
+            ok = int_value(argc, argv, &i, &out->res_budget_mb);
+        else if (strcmp(a, "--cpu-budget") == 0)
+            ok = int_value(argc, argv, &i, &out->cpu_budget_mb);
+        else if (strcmp(a, "--gpu-budget") == 0)
+            ok = int_value(argc, argv, &i, &out->gpu_budget_mb);
+        else if (strcmp(a, "--tex-stream") == 0)
+            ok = int_value(argc, argv, &i, &out->tex_stream_mb);
+        else if (strcmp(a, "--normals") == 0)
+        {
+            const char *w = NULL;
+            ok = str_value(argc, argv, &i, &w);
+            if (ok && strcmp(w, "area") != 0 && strcmp(w, "angle") != 0)
+            {
+                printf("ERROR: --normals expects 'area' or 'angle'\n");
+                ok = 0;
+            }
+            if (ok)
+                out->area_normals = strcmp(w, "area") == 0;
+        }
+        else if (strcmp(a, "--crease") == 0)
+            ok = float_value(argc, argv, &i, &out->crease_angle);
+        else if (strcmp(a, "--weld") == 0)
+            ok = float_value(argc, argv, &i, &out->weld_eps);
+        else if (strcmp(a, "--weld-angle") == 0)
+            ok = float_value(argc, argv, &i, &out->weld_angle);
+        else if (strcmp(a, "--weld-uv") == 0)
+            ok = float_value(argc, argv, &i, &out->weld_uv);
+        else if (strcmp(a, "--help") == 0 || strcmp(a, "-h") == 0)
+        {
+            options_print_usage(argv[0]);
+            return 0;
+        }
+        else
+        {
+            printf("ERROR: unknown option: %s\n", a);
+            options_print_usage(argv[0]);
+            return 0;
+        }
+
+        if (!ok)
+            return 0;
+    }
+    return 1;
+}
+
+void options_print_usage(const char *exe)
+{
+    printf("Usage: %s [options]\n"
+           "  --on-demand     render only when the view changes (toggle: F1)\n"
+           "  --lights N      N point/spot lights, clustered forward shading (orbit: F2)\n"
+           "  --bench-lights  sweep the light count and print CPU/GPU cost, then exit\n"
+           "  --bench-queue N sort N synthetic draws per frame, print sort cost and state changes\n"
+           "                  before/after sorting (CPU only), then exit\n"
+           "  --depth-prepass render depth with a position-only stream first, then shade with\n"
+           "                  GL_EQUAL (toggle: F6; F3 prints GPU time and shaded fragments per pixel)\n"
+           "  --occlusion     skip draws whose bounding box was hidden last frame (occlusion queries +\n"
+           "                  conditional rendering; toggle: F7; F3 prints culled objects and query cost)\n"
+           "  --dynamic-res MS  render the scene offscreen at a resolution scaled to keep the GPU frame\n"
+           "                  time under MS (timer queries), then upscale to the window (toggle: F8;\n"
+           "                  F3 prints scale and GPU time); with --on-demand an idle view is redrawn\n"
+           "                  once at full resolution\n"
+           "  --dynamic-res-min S  smallest scale of each side for --dynamic-res (default 0.5)\n"
+           "  --sharpen S     sharpen the upscaled image, 0-1 (default 0: bilinear)\n"
+           "  --pacing N      low-latency mode: at most N frames (1-4) queued on the GPU,\n"
+           "                  input sampled right before the view matrix is built\n"
+           "  --target-fps F  sleep to a fixed frame time, waking just in time to build the frame\n"
+           "  --serial-startup  load shaders, model and textures one after another on the\n"
+           "                  main thread instead of the startup task graph (for comparison)\n"
+           "  --no-watch      do not hot-reload model.obj/model.mtl when they change on disk\n"
+           "  --pack FILE     load model, material and textures from a .pak (see ObjPackBuild)\n"
+           "  --octree FILE   page a .oct model (see ObjOctreeBuild) instead of model.obj\n"
+           "  --mesh FILE     load a compressed .omc mesh (see ObjMeshCodec) instead of model.obj\n"
+           "  --objects A,B   load only the listed o/g objects of model.obj; the first run\n"
+           "                  indexes the file into model.obj.idx, later runs parse only those\n"
+           "                  objects and the vertex ranges they use\n"
+           "  --points FILE   render a vertex-only OBJ (v x y z [r g b]) as a point cloud with\n"
+           "                  octree LOD; GPU memory is capped by --gpu-budget\n"
+           "  --point-budget M  max points drawn per frame, in millions (default 10)\n"
+           "  --point-error PX  refine octree nodes while point spacing exceeds PX pixels (default 1.5)\n"
+           "  --scene FILE    load several models from a scene file (see assets/scenes); shared\n"
+           "                  meshes, materials, textures and shaders are loaded once\n"
+           "  --res-budget MB keep unused scene resources cached up to MB (default 0: free at once)\n"
+           "  --cpu-budget MB RAM budget for paged octree chunks (default 512)\n"
+           "  --gpu-budget MB VRAM budget for paged octree chunks / point cloud nodes (default 512)\n"
+           "  --tex-stream MB stream texture mip levels by on-screen size within MB of VRAM; textures\n"
+           "                  start at 64x64, finer levels are decoded in the background and the least\n"
+           "                  recently used are dropped when over budget (F3 prints residency)\n"
+           "  --normals W     weighting of generated normals: angle (default) or area\n"
+           "  --crease DEG    keep edges sharper than DEG when generating normals (default 180)\n"
+           "  --weld EPS      merge vertices closer than EPS (model units) with compatible\n"
+           "                  normals/UVs, drop degenerate triangles (default off)\n"
+           "  --weld-angle DEG  max angle between merged normals (default 10)\n"
+           "  --weld-uv EPS   max UV difference of merged vertices (default 0.001)\n"
+           "  --no-tex-pack   multi-material models: one texture bind and draw per material\n"
+           "                  instead of packed texture arrays (for comparison)\n"
+           "  --ring-unsync   stream uniforms with unsynchronized glMapBufferRange\n"
+           "                  instead of a persistent mapping (for comparison)\n"
+           "  --capture FILE  record every frame: shot.png (numbered PNGs), .y4m or .rgb/.raw (pause: F5)\n"
+           "  --capture-sync  read frames back with a blocking glReadPixels (for comparison)\n"
+           "  --record FILE   log every GL command with buffer/texture data to FILE (.glr)\n"
+           "                  for ObjGlReplay; forces --ring-unsync\n"
+           "  F3              print statistics\n"
+           "  F4              draw debug lines (model bounds, light positions)\n"
+           "  F5              pause/resume --capture\n"
+           "  F6              toggle the depth pre-pass\n"
+           "  F7              toggle occlusion culling\n"
+           "  F8              toggle dynamic resolution\n"
+           "  -h, --help      show this help\n",
+           exe);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+/**
+ * @brief Opcje uruchomienia viewera (z linii poleceń).
+ */
+typedef struct AppOptions
+{
+    int on_demand; // --on-demand: rysuj tylko gdy coś się zmieniło
+    int lights;    // --lights N: N świateł punktowych/spot (shader phong, klastry)
+    int bench_lights; // --bench-lights: pomiar kosztu dla rosnącej liczby świateł
+    int bench_queue;  // --bench-queue N: sortowanie kolejki rysowania dla N rysowań
+    int depth_prepass; // --depth-prepass: przebieg samej głębi, potem cieniowanie z GL_EQUAL (F6)
+    int occlusion;     // --occlusion: zapytania o zasłonięcie AABB, rysowanie warunkowe (F7)
+    float dynamic_res_ms;  // --dynamic-res MS: rozdzielczość sceny dobierana do czasu klatki GPU (F8; 0 = bez)
+    float dynamic_res_min; // --dynamic-res-min S: najmniejsza skala boku
+    float sharpen;         // --sharpen S: wyostrzenie przy skalowaniu (0 = dwuliniowo)
+
+    int max_frames_in_flight; // --pacing N: najwyżej N klatek w kolejce GPU, wejście tuż przed klatką
+    float target_fps;         // --target-fps F: usypianie do stałego czasu klatki (0 = bez)
+
+    int serial_startup;      // --serial-startup: wczytywanie bez grafu zadań (porównanie)
+    int no_watch;            // --no-watch: bez przeładowania OBJ/MTL na gorąco
+    int no_tex_pack;         // --no-tex-pack: osobna tekstura i wywołanie na materiał
+    int ring_unsync;         // --ring-unsync: GpuRing bez mapowania trwałego
+    const char *capture_path; // --capture FILE: zapis klatek (.png, .y4m, .rgb)
+    int capture_sync;        // --capture-sync: glReadPixels bez PBO (porównanie)
+    const char *record_path; // --record FILE: dziennik poleceń GL (.glr) dla ObjGlReplay
+    const char *pack_path;   // --pack FILE: zasoby z paczki .pak zamiast luźnych plików
+    const char *octree_path; // --octree FILE: stronicowany model .oct zamiast OBJ
+    const char *mesh_path;   // --mesh FILE: skompresowana siatka .omc zamiast OBJ
+    const char *objects;     // --objects A,B: tylko te obiekty/grupy OBJ (indeks model.obj.idx)
+    const char *points_path; // --points FILE: OBJ z samymi liniami v jako chmura punktów
+    float point_budget_m;    // --point-budget M: miliony punktów na klatkę
+    float point_error;       // --point-error PX: odstęp punktów na ekranie, od którego dzielimy węzeł
+    const char *scene_path;  // --scene FILE: wiele modeli z pliku sceny
+    int res_budget_mb;       // --res-budget MB: nieużywane zasoby sceny trzymane w pamięci
+    int cpu_budget_mb;       // --cpu-budget MB
+    int gpu_budget_mb;       // --gpu-budget MB
+    int tex_stream_mb;       // --tex-stream MB: poziomy mip tekstur strumieniowane w budżecie VRAM (0 = bez)
+
+    int area_normals;   // --normals area|angle: ważenie generowanych normalnych
+    float crease_angle; // --crease DEG: kąt ostrej krawędzi (180 = pełne wygładzanie)
+
+    float weld_eps;     // --weld EPS: scalanie wierzchołków bliższych niż EPS (0 = wyłączone)
+    float weld_angle;   // --weld-angle DEG: maksymalny kąt między normalnymi scalanych
+    float weld_uv;      // --weld-uv EPS: maksymalna różnica UV scalanych
+} AppOptions;
+
+/**
+ * @brief Ustawia wartości domyślne.
+ *
+ * @param o Opcje.
+ */
+void options_init(AppOptions *o);
+
+/**
+ * @brief Parsuje argumenty linii poleceń.
+ *
+ * @param argc Liczba argumentów.
+ * @param argv Argumenty.
+ * @param out  Opcje wyjściowe (wcześniej options_init()).
+ * @return 1 jeśli OK, 0 jeśli błąd (wypisuje sposób użycia).
+ */
+int options_parse(int argc, char **argv, AppOptions *out);
+
+/**
+ * @brief Wypisuje sposób użycia na stdout.
+ *
+ * @param exe Nazwa programu (argv[0]).
+ */
+void options_print_usage(const char *exe);
@@ -0,0 +1,1126 @@
+#include "PointCloud.h"
+#include "MappedFile.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#define POINT_MAX_THREADS 64
+#define POINT_MIN_BYTES_PER_THREAD (1u << 20)
+#define POINT_MIN_POINTS_PER_THREAD 65536
+#define POINT_TASK_LEVEL 2 // poddrzewa od tego poziomu budowane równolegle
+#define POINT_UPLOAD_BUDGET (32u << 20)
+#define POINT_WHITE 0xFFFFFFFFu
+
+/**
+ * @brief Wierzchołek na GPU: współrzędne względem węzła + kolor.
+ */
+typedef struct PointVertex
+{
+    uint16_t x, y, z, pad;
+    uint32_t color;
+} PointVertex;
+
+/**
+ * @brief Zakres punktów czekający na podział (budowa drzewa).
+ */
+typedef struct PointTask
+{
+    int node;
+    size_t begin, end;
+} PointTask;
+
+typedef struct PointNodeVec
+{
+    PointCloudNode *data;
+    int count, cap;
+} PointNodeVec;
+
+typedef struct PointTaskVec
+{
+    PointTask *data;
+    size_t count, cap;
+} PointTaskVec;
+
+/**
+ * @brief Dane wątku (parsowanie, klucze, sortowanie, poddrzewa).
+ */
+typedef struct PointJob
+{
+    /* parsowanie */
+    const char *text_begin, *text_end;
+    size_t first;       // pierwszy punkt fragmentu w tablicach wyjściowych
+    size_t lines;       // linie v (przebieg liczenia)
+    size_t parsed;      // poprawne linie v (przebieg wczytania)
+    size_t faces;
+    int has_colors;
+    float *positions;
+    uint32_t *colors;
+    float bmin[3], bmax[3];
+
+    /* klucze / sortowanie */
+    size_t begin, end;
+    float cube_min[3];
+    float cell_scale;
+    uint64_t *keys, *keys_out;
+    uint32_t *colors_out;
+    int shift;
+    size_t hist[256];
+
+    /* poddrzewa */
+    PointCloud *pc;
+    uint64_t *scratch_keys;
+    uint32_t *scratch_colors;
+    const PointTask *tasks;
+    size_t task_count;
+    int thread, threads;
+    PointNodeVec *subtrees; // [task]
+    int ok;
+} PointJob;
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+}
+
+static int cpu_count(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return (int)si.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+/**
+ * @brief Uruchamia fn na wszystkich zadaniach; zadanie 0 na bieżącym wątku.
+ */
+static void run_jobs(PointJob *jobs, int count, void *(*fn)(void *))
+{
+    pthread_t th[POINT_MAX_THREADS];
+    int started[POINT_MAX_THREADS] = {0};
+
+    for (int i = 1; i < count; i++)
+        started[i] = pthread_create(&th[i], NULL, fn, &jobs[i]) == 0;
+    fn(&jobs[0]);
+    for (int i = 1; i < count; i++)
+    {
+        if (started[i])
+            pthread_join(th[i], NULL);
+        else
+            fn(&jobs[i]); // brak wątku -> licz na bieżącym
+    }
+}
+
+static void split_range(PointJob *jobs, int threads, size_t count)
+{
+    for (int i = 0; i < threads; i++)
+    {
+        jobs[i].begin = count * (size_t)i / (size_t)threads;
+        jobs[i].end = count * (size_t)(i + 1) / (size_t)threads;
+    }
+}
+
+/* =========================================================
+   Kody Morton
+   ========================================================= */
+
+static uint64_t expand_bits21(uint32_t v)
+{
+    uint64_t x = v & 0x1FFFFFu;
+    x = (x | x << 32) & 0x1F00000000FFFFull;
+    x = (x | x << 16) & 0x1F0000FF0000FFull;
+    x = (x | x << 8) & 0x100F00F00F00F00Full;
+    x = (x | x << 4) & 0x10C30C30C30C30C3ull;
+    x = (x | x << 2) & 0x1249249249249249ull;
+    return x;
+}
+
+static uint32_t compact_bits21(uint64_t x)
+{
+    x &= 0x1249249249249249ull;
+    x = (x ^ (x >> 2)) & 0x10C30C30C30C30C3ull;
+    x = (x ^ (x >> 4)) & 0x100F00F00F00F00Full;
+    x = (x ^ (x >> 8)) & 0x1F0000FF0000FFull;
+    x = (x ^ (x >> 16)) & 0x1F00000000FFFFull;
+    x = (x ^ (x >> 32)) & 0x1FFFFFull;
+    return (uint32_t)x;
+}
+
+/* =========================================================
+   Parsowanie (równoległe fragmenty pliku)
+   ========================================================= */
+
+static const double g_pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/**
+ * @brief Liczba zmiennoprzecinkowa (bez locale, bez kopiowania linii).
+ *
+ * @return Wskaźnik za liczbą albo NULL, jeśli jej nie ma.
+ */
+static const char *parse_float(const char *s, const char *end, float *out)
+{
+    while (s < end && (*s == ' ' || *s == '\t'))
+        s++;
+
+    int neg = 0;
+    if (s < end && (*s == '-' || *s == '+'))
+        neg = *s++ == '-';
+
+    uint64_t mant = 0;
+    int exp10 = 0, digits = 0;
+    for (; s < end && *s >= '0' && *s <= '9'; s++, digits++)
+    {
+        if (mant < 100000000000000000ull)
+            mant = mant * 10 + (uint64_t)(*s - '0');
+        else
+            exp10++;
+    }
+    if (s < end && *s == '.')
+    {
+        for (s++; s < end && *s >= '0' && *s <= '9'; s++, digits++)
+        {
+            if (mant < 100000000000000000ull)
+            {
+                mant = mant * 10 + (uint64_t)(*s - '0');
+                exp10--;
+            }
+        }
+    }
+    if (digits == 0)
+        return NULL;
+
+    if (s < end && (*s == 'e' || *s == 'E'))
+    {
+        const char *e = s + 1;
+        int eneg = 0, ev = 0, edigits = 0;
+        if (e < end && (*e == '-' || *e == '+'))
+            eneg = *e++ == '-';
+        for (; e < end && *e >= '0' && *e <= '9'; e++, edigits++)
+            ev = ev < 10000 ? ev * 10 + (*e - '0') : ev;
+        if (edigits)
+        {
+            exp10 += eneg ? -ev : ev;
+            s = e;
+        }
+    }
+
+    double v = (double)mant;
+    if (exp10 >= 0 && exp10 <= 22)
+        v *= g_pow10[exp10];
+    else if (exp10 < 0 && exp10 >= -22)
+        v /= g_pow10[-exp10];
+    else
+        v *= pow(10.0, exp10);
+    *out = (float)(neg ? -v : v);
+    return s;
+}
+
+static const char *line_end(const char *s, const char *end)
+{
+    const char *nl = (const char *)memchr(s, '\n', (size_t)(end - s));
+    return nl ? nl : end;
+}
+
+static int is_blank(char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+/**
+ * @brief Przebieg 1: liczy linie v (i f, do komunikatu).
+ */
+static void *count_main(void *arg)
+{
+    PointJob *j = (PointJob *)arg;
+    const char *s = j->text_begin;
+    while (s < j->text_end)
+    {
+        const char *e = line_end(s, j->text_end);
+        while (s < e && is_blank(*s))
+            s++;
+        if (e - s > 1 && s[0] == 'v' && is_blank(s[1]))
+            j->lines++;
+        else if (e - s > 1 && s[0] == 'f' && is_blank(s[1]))
+            j->faces++;
+        s = e + 1;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Przebieg 2: pozycje i kolory (v x y z [r g b]) do tablic wyjściowych.
+ */
+static void *parse_main(void *arg)
+{
+    PointJob *j = (PointJob *)arg;
+    float *pos = j->positions + j->first * 3;
+    uint32_t *col = j->colors + j->first;
+    const char *s = j->text_begin;
+
+    for (int k = 0; k < 3; k++)
+    {
+        j->bmin[k] = FLT_MAX;
+        j->bmax[k] = -FLT_MAX;
+    }
+
+    while (s < j->text_end && j->parsed < j->lines)
+    {
+        const char *e = line_end(s, j->text_end);
+        while (s < e && is_blank(*s))
+            s++;
+
+        if (e - s > 1 && s[0] == 'v' && is_blank(s[1]))
+        {
+            float v[7];
+            int n = 0;
+            const char *p = s + 1;
+            while (n < 7 && (p = parse_float(p, e, &v[n])) != NULL)
+                n++;
+
+            if (n >= 3)
+            {
+                float *dst = pos + j->parsed * 3;
+                for (int k = 0; k < 3; k++)
+                {
+                    dst[k] = v[k];
+                    j->bmin[k] = v[k] < j->bmin[k] ? v[k] : j->bmin[k];
+                    j->bmax[k] = v[k] > j->bmax[k] ? v[k] : j->bmax[k];
+                }
+
+                // v x y z w -> waga, v x y z r g b -> kolor (0..1 albo 0..255)
+                uint32_t c = POINT_WHITE;
+                if (n >= 6)
+                {
+                    float scale = (v[3] > 1.0f || v[4] > 1.0f || v[5] > 1.0f) ? 1.0f : 255.0f;
+                    c = 0xFF000000u;
+                    for (int k = 0; k < 3; k++)
+                    {
+                        float f = v[3 + k] * scale;
+                        f = f < 0.0f ? 0.0f : (f > 255.0f ? 255.0f : f);
+                        c |= (uint32_t)(f + 0.5f) << (8 * k);
+                    }
+                    j->has_colors = 1;
+                }
+                col[j->parsed++] = c;
+            }
+        }
+        s = e + 1;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Dzieli plik na fragmenty zaczynające się od początku linii.
+ */
+static void split_text(PointJob *jobs, int threads, const char *data, size_t size)
+{
+    const char *end = data + size;
+    const char *prev = data;
+    for (int i = 0; i < threads; i++)
+    {
+        const char *cut = data + size * (size_t)(i + 1) / (size_t)threads;
+        if (i + 1 < threads && cut < end)
+        {
+            const char *nl = (const char *)memchr(cut, '\n', (size_t)(end - cut));
+            cut = nl ? nl + 1 : end;
+        }
+        else
+        {
+            cut = end;
+        }
+        if (cut < prev)
+            cut = prev;
+        jobs[i].text_begin = prev;
+        jobs[i].text_end = cut;
+        prev = cut;
+    }
+}
+
+/* =========================================================
+   Klucze i sortowanie pozycyjne (radix, równoległe)
+   ========================================================= */
+
+static void *keys_main(void *arg)
+{
+    PointJob *j = (PointJob *)arg;
+    const uint32_t maxq = (1u << POINT_CLOUD_MORTON_BITS) - 1u;
+    for (size_t i = j->begin; i < j->end; i++)
+    {
+        uint32_t q[3];
+        for (int k = 0; k < 3; k++)
+        {
+            float f = (j->positions[i * 3 + k] - j->cube_min[k]) * j->cell_scale;
+            q[k] = f <= 0.0f ? 0u : (f >= (float)maxq ? maxq : (uint32_t)f);
+        }
+        j->keys[i] = expand_bits21(q[0]) | expand_bits21(q[1]) << 1 | expand_bits21(q[2]) << 2;
+    }
+    return NULL;
+}
+
+static void *histogram_main(void *arg)
+{
+    PointJob *j = (PointJob *)arg;
+    memset(j->hist, 0, sizeof(j->hist));
+    for (size_t i = j->begin; i < j->end; i++)
+        j->hist[(j->keys[i] >> j->shift) & 0xFFu]++;
+    return NULL;
+}
+
+static void *scatter_main(void *arg)
+{
+    PointJob *j = (PointJob *)arg;
+    size_t *off = j->hist; // po prefiksach: pierwsza pozycja cyfry dla tego wątku
+    for (size_t i = j->begin; i < j->end; i++)
+    {
+        size_t d = off[(j->keys[i] >> j->shift) & 0xFFu]++;
+        j->keys_out[d] = j->keys[i];
+        if (j->colors)
+            j->colors_out[d] = j->colors[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief LSD radix sort par (klucz, kolor) po 8 bitów; pomija stałe cyfry.
+ *
+ * Wynik trafia do *keys / *colors (wskaźniki mogą zamienić się z buforami).
+ */
+static void radix_sort(PointJob *jobs, int threads, size_t count,
+                       uint64_t **keys, uint32_t **colors, uint64_t **tmp_keys, uint32_t **tmp_colors)
+{
+    split_range(jobs, threads, count);
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        for (int t = 0; t < threads; t++)
+        {
+            jobs[t].keys = *keys;
+            jobs[t].colors = *colors;
+            jobs[t].keys_out = *tmp_keys;
+            jobs[t].colors_out = *tmp_colors;
+            jobs[t].shift = shift;
+        }
+        run_jobs(jobs, threads, histogram_main);
+
+        size_t total = 0;
+        int skip = 0;
+        for (int d = 0; d < 256 && !skip; d++)
+        {
+            size_t n = 0;
+            for (int t = 0; t < threads; t++)
+                n += jobs[t].hist[d];
+            skip = n == count;
+        }
+        if (skip)
+            continue;
+
+        for (int d = 0; d < 256; d++)
+        {
+            for (int t = 0; t < threads; t++)
+            {
+                size_t n = jobs[t].hist[d];
+                jobs[t].hist[d] = total;
+                total += n;
+            }
+        }
+        run_jobs(jobs, threads, scatter_main);
+
+        uint64_t *k = *keys;
+        *keys = *tmp_keys;
+        *tmp_keys = k;
+        uint32_t *c = *colors;
+        *colors = *tmp_colors;
+        *tmp_colors = c;
+    }
+}
+
+/* =========================================================
+   Budowa octree
+   ========================================================= */
+
+static int node_push(PointNodeVec *v, const PointCloudNode *n)
+{
+    if (v->count == v->cap)
+    {
+        int ncap = v->cap ? v->cap * 2 : 64;
+        PointCloudNode *d = (PointCloudNode *)realloc(v->data, (size_t)ncap * sizeof(PointCloudNode));
+        if (!d)
+            return -1;
+        v->data = d;
+        v->cap = ncap;
+    }
+    v->data[v->count] = *n;
+    return v->count++;
+}
+
+static int task_push(PointTaskVec *v, int node, size_t begin, size_t end)
+{
+    if (v->count == v->cap)
+    {
+        size_t ncap = v->cap ? v->cap * 2 : 64;
+        PointTask *d = (PointTask *)realloc(v->data, ncap * sizeof(PointTask));
+        if (!d)
+            return 0;
+        v->data = d;
+        v->cap = ncap;
+    }
+    PointTask t = {node, begin, end};
+    v->data[v->count++] = t;
+    return 1;
+}
+
+/**
+ * @brief Pierwszy indeks w [lo, hi) z cyfrą poziomu >= digit (zakres posortowany).
+ */
+static size_t lower_bound_digit(const uint64_t *keys, size_t lo, size_t hi, int shift, unsigned digit)
+{
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (((keys[mid] >> shift) & 7u) < digit)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * @brief Dzieli węzeł: próbka na początek zakresu, reszta do dzieci.
+ *
+ * Dzieci na poziomie >= task_level nie są dzielone od razu, tylko
+ * trafiają do tasks (budowa równoległa); tasks == NULL -> rekurencja.
+ *
+ * @return 1 jeśli OK, 0 jeśli brak pamięci.
+ */
+static int split_node(PointCloud *pc, uint64_t *scratch_keys, uint32_t *scratch_colors,
+                      PointNodeVec *v, int idx, size_t begin, size_t end,
+                      PointTaskVec *tasks, uint32_t task_level)
+{
+    PointCloudNode *n = &v->data[idx];
+    for (int c = 0; c < 8; c++)
+        n->child[c] = -1;
+    n->first = begin;
+    n->count = (uint32_t)(end - begin);
+
+    if (end - begin <= POINT_CLOUD_LEAF_MAX || n->level >= POINT_CLOUD_MORTON_BITS)
+        return 1;
+
+    // próbka: pierwszy punkt każdej komórki siatki 2^GRID_BITS w węźle
+    uint32_t cellLevel = n->level + POINT_CLOUD_GRID_BITS;
+    if (cellLevel > POINT_CLOUD_MORTON_BITS)
+        cellLevel = POINT_CLOUD_MORTON_BITS;
+    int cellShift = 3 * (POINT_CLOUD_MORTON_BITS - (int)cellLevel);
+
+    uint64_t *keys = pc->keys;
+    uint32_t *colors = pc->colors;
+    size_t sampled = 1;
+    for (size_t i = begin + 1; i < end; i++)
+        sampled += (keys[i] >> cellShift) != (keys[i - 1] >> cellShift);
+
+    // podział stabilny (reszta zostaje posortowana) przez bufor pomocniczy
+    size_t s = begin, r = begin + sampled;
+    for (size_t i = begin; i < end; i++)
+    {
+        int take = i == begin || (keys[i] >> cellShift) != (keys[i - 1] >> cellShift);
+        size_t d = take ? s++ : r++;
+        scratch_keys[d] = keys[i];
+        if (colors)
+            scratch_colors[d] = colors[i];
+    }
+    memcpy(keys + begin, scratch_keys + begin, (end - begin) * sizeof(uint64_t));
+    if (colors)
+        memcpy(colors + begin, scratch_colors + begin, (end - begin) * sizeof(uint32_t));
+
+    n->count = (uint32_t)sampled;
+    size_t restBegin = begin + sampled;
+    if (restBegin == end)
+        return 1;
+
+    int childShift = 3 * (POINT_CLOUD_MORTON_BITS - 1 - (int)n->level);
+    uint32_t level = n->level + 1;
+    float half = n->size * 0.5f;
+    float origin[3] = {n->bmin[0], n->bmin[1], n->bmin[2]};
+
+    size_t lo = restBegin;
+    for (unsigned c = 0; c < 8; c++)
+    {
+        size_t hi = lower_bound_digit(keys, lo, end, childShift, c + 1);
+        if (hi == lo)
+            continue;
+
+        PointCloudNode child;
+        memset(&child, 0, sizeof(child));
+        child.bmin[0] = origin[0] + ((c & 1) ? half : 0.0f);
+        child.bmin[1] = origin[1] + ((c & 2) ? half : 0.0f);
+        child.bmin[2] = origin[2] + ((c & 4) ? half : 0.0f);
+        child.size = half;
+        child.level = level;
+
+        int ci = node_push(v, &child);
+        if (ci < 0)
+            return 0;
+        v->data[idx].child[c] = ci; // v->data mógł się przenieść
+
+        if (tasks && level >= task_level)
+        {
+            if (!task_push(tasks, ci, lo, hi))
+                return 0;
+        }
+        else if (!split_node(pc, scratch_keys, scratch_colors, v, ci, lo, hi, tasks, task_level))
+        {
+            return 0;
+        }
+        lo = hi;
+    }
+    return 1;
+}
+
+/**
+ * @brief Wątek: poddrzewa zadań thread, thread + threads, ...
+ */
+static void *subtree_main(void *arg)
+{
+    PointJob *j = (PointJob *)arg;
+    j->ok = 1;
+    for (size_t t = (size_t)j->thread; t < j->task_count && j->ok; t += (size_t)j->threads)
+    {
+        const PointTask *task = &j->tasks[t];
+        PointNodeVec *v = &j->subtrees[t];
+        PointCloudNode root = j->pc->nodes[task->node];
+        j->ok = node_push(v, &root) == 0 &&
+                split_node(j->pc, j->scratch_keys, j->scratch_colors, v, 0, task->begin, task->end, NULL, 0);
+    }
+    return NULL;
+}
+
+static int task_size_cmp(const void *a, const void *b)
+{
+    const PointTask *x = (const PointTask *)a, *y = (const PointTask *)b;
+    size_t nx = x->end - x->begin, ny = y->end - y->begin;
+    return (nx < ny) - (nx > ny);
+}
+
+/**
+ * @brief Buduje drzewo: górne poziomy szeregowo, poddrzewa równolegle.
+ */
+static int build_tree(PointCloud *pc, PointJob *jobs, int threads, const float cube_min[3], float cube_size,
+                      uint64_t *scratch_keys, uint32_t *scratch_colors)
+{
+    PointNodeVec top = {0};
+    PointTaskVec tasks = {0};
+    PointCloudNode root;
+    memset(&root, 0, sizeof(root));
+    memcpy(root.bmin, cube_min, sizeof(root.bmin));
+    root.size = cube_size;
+
+    int ok = node_push(&top, &root) == 0 &&
+             split_node(pc, scratch_keys, scratch_colors, &top, 0, 0, pc->count, &tasks, POINT_TASK_LEVEL);
+
+    PointNodeVec *subtrees = NULL;
+    if (ok && tasks.count > 0)
+    {
+        // największe najpierw: lepszy podział między wątki
+        qsort(tasks.data, tasks.count, sizeof(PointTask), task_size_cmp);
+        subtrees = (PointNodeVec *)calloc(tasks.count, sizeof(PointNodeVec));
+        ok = subtrees != NULL;
+    }
+    if (ok && tasks.count > 0)
+    {
+        pc->nodes = top.data; // subtree_main czyta korzenie zadań
+        for (int t = 0; t < threads; t++)
+        {
+            jobs[t].pc = pc;
+            jobs[t].scratch_keys = scratch_keys;
+            jobs[t].scratch_colors = scratch_colors;
+            jobs[t].tasks = tasks.data;
+            jobs[t].task_count = tasks.count;
+            jobs[t].thread = t;
+            jobs[t].threads = threads;
+            jobs[t].subtrees = subtrees;
+        }
+        run_jobs(jobs, threads, subtree_main);
+        for (int t = 0; t < threads; t++)
+            ok = ok && jobs[t].ok;
+    }
+
+    // scalenie: korzeń poddrzewa zastępuje węzeł zadania, reszta na koniec
+    size_t total = (size_t)top.count;
+    for (size_t t = 0; ok && t < tasks.count; t++)
+        total += (size_t)subtrees[t].count - 1;
+    PointCloudNode *nodes = ok ? (PointCloudNode *)realloc(top.data, total * sizeof(PointCloudNode)) : NULL;
+    if (nodes)
+    {
+        int next = top.count;
+        for (size_t t = 0; t < tasks.count; t++)
+        {
+            const PointNodeVec *v = &subtrees[t];
+            int base = next - 1; // lokalny i > 0 -> base + i
+            for (int i = 0; i < v->count; i++)
+            {
+                PointCloudNode n = v->data[i];
+                for (int c = 0; c < 8; c++)
+                    if (n.child[c] > 0)
+                        n.child[c] += base;
+                nodes[i == 0 ? tasks.data[t].node : base + i] = n;
+            }
+            next += v->count - 1;
+        }
+        pc->nodes = nodes;
+        pc->node_count = (int)total;
+    }
+    else
+    {
+        free(top.data);
+        pc->nodes = NULL;
+    }
+
+    for (size_t t = 0; subtrees && t < tasks.count; t++)
+        free(subtrees[t].data);
+    free(subtrees);
+    free(tasks.data);
+    return pc->nodes != NULL;
+}
+
+/* =========================================================
+   Wczytanie
+   ========================================================= */
+
+int point_cloud_load_obj(PointCloud *pc, const char *path)
+{
+    memset(pc, 0, sizeof(*pc));
+    pc->point_budget = 10u * 1000u * 1000u;
+    pc->gpu_budget = (size_t)512 << 20;
+    pc->upload_budget = POINT_UPLOAD_BUDGET;
+    pc->max_pixel_error = 1.5f;
+
+    MappedFile file;
+    if (!mapped_file_open(path, &file))
+    {
+        printf("ERROR: cannot open point cloud: %s\n", path);
+        return 0;
+    }
+
+    double t0 = now_ms();
+    int threads = cpu_count();
+    if (threads > POINT_MAX_THREADS)
+        threads = POINT_MAX_THREADS;
+    if ((size_t)threads > file.size / POINT_MIN_BYTES_PER_THREAD + 1)
+        threads = (int)(file.size / POINT_MIN_BYTES_PER_THREAD) + 1;
+
+    PointJob jobs[POINT_MAX_THREADS];
+    memset(jobs, 0, sizeof(jobs));
+    split_text(jobs, threads, (const char *)file.data, file.size);
+    run_jobs(jobs, threads, count_main);
+
+    size_t lines = 0, faces = 0;
+    for (int t = 0; t < threads; t++)
+    {
+        jobs[t].first = lines;
+        lines += jobs[t].lines;
+        faces += jobs[t].faces;
+    }
+    if (faces > 0)
+        printf("NOTE: %s has %zu faces; point cloud mode uses vertices only\n", path, faces);
+
+    float *positions = lines ? (float *)malloc(lines * 3 * sizeof(float)) : NULL;
+    uint32_t *colors = lines ? (uint32_t *)malloc(lines * sizeof(uint32_t)) : NULL;
+    if (!positions || !colors)
+    {
+        printf("ERROR: %s has no vertices or is too large (%zu points)\n", path, lines);
+        free(positions);
+        free(colors);
+        mapped_file_close(&file);
+        return 0;
+    }
+
+    for (int t = 0; t < threads; t++)
+    {
+        jobs[t].positions = positions;
+        jobs[t].colors = colors;
+    }
+    run_jobs(jobs, threads, parse_main);
+    mapped_file_close(&file);
+
+    // linie v z błędem: dosunięcie fragmentów
+    size_t count = 0;
+    int hasColors = 0;
+    for (int k = 0; k < 3; k++)
+    {
+        pc->bmin[k] = FLT_MAX;
+        pc->bmax[k] = -FLT_MAX;
+    }
+    for (int t = 0; t < threads; t++)
+    {
+        const PointJob *j = &jobs[t];
+        if (j->first != count)
+        {
+            memmove(positions + count * 3, positions + j->first * 3, j->parsed * 3 * sizeof(float));
+            memmove(colors + count, colors + j->first, j->parsed * sizeof(uint32_t));
+        }
+        count += j->parsed;
+        hasColors |= j->has_colors;
+        if (j->parsed == 0)
+            continue;
+        for (int k = 0; k < 3; k++)
+        {
+            pc->bmin[k] = j->bmin[k] < pc->bmin[k] ? j->bmin[k] : pc->bmin[k];
+            pc->bmax[k] = j->bmax[k] > pc->bmax[k] ? j->bmax[k] : pc->bmax[k];
+        }
+    }
+    if (count == 0)
+    {
+        printf("ERROR: no valid 'v' lines in %s\n", path);
+        free(positions);
+        free(colors);
+        return 0;
+    }
+    if (!hasColors)
+    {
+        free(colors);
+        colors = NULL;
+    }
+    pc->parse_ms = now_ms() - t0;
+
+    /* ---------- klucze w sześcianie obejmującym chmurę ---------- */
+    double t1 = now_ms();
+    float cubeSize = 0.0f;
+    for (int k = 0; k < 3; k++)
+        cubeSize = pc->bmax[k] - pc->bmin[k] > cubeSize ? pc->bmax[k] - pc->bmin[k] : cubeSize;
+    cubeSize = cubeSize > 0.0f ? cubeSize * 1.0001f : 1.0f;
+    float cellScale = (float)(1u << POINT_CLOUD_MORTON_BITS) / cubeSize;
+
+    uint64_t *keys = (uint64_t *)malloc(count * sizeof(uint64_t));
+    int sortThreads = threads;
+    if ((size_t)sortThreads > count / POINT_MIN_POINTS_PER_THREAD + 1)
+        sortThreads = (int)(count / POINT_MIN_POINTS_PER_THREAD) + 1;
+    if (keys)
+    {
+        split_range(jobs, sortThreads, count);
+        for (int t = 0; t < sortThreads; t++)
+        {
+            jobs[t].positions = positions;
+            memcpy(jobs[t].cube_min, pc->bmin, sizeof(jobs[t].cube_min));
+            jobs[t].cell_scale = cellScale;
+            jobs[t].keys = keys;
+        }
+        run_jobs(jobs, sortThreads, keys_main);
+    }
+    free(positions);
+
+    uint64_t *tmpKeys = keys ? (uint64_t *)malloc(count * sizeof(uint64_t)) : NULL;
+    uint32_t *tmpColors = colors ? (uint32_t *)malloc(count * sizeof(uint32_t)) : NULL;
+    if (!keys || !tmpKeys || (colors && !tmpColors))
+    {
+        printf("ERROR: out of memory for %zu points\n", count);
+        free(keys);
+        free(tmpKeys);
+        free(colors);
+        free(tmpColors);
+        return 0;
+    }
+
+    radix_sort(jobs, sortThreads, count, &keys, &colors, &tmpKeys, &tmpColors);
+    pc->keys = keys;
+    pc->colors = colors;
+    pc->count = count;
+
+    int ok = build_tree(pc, jobs, sortThreads, pc->bmin, cubeSize, tmpKeys, tmpColors);
+    free(tmpKeys);
+    free(tmpColors);
+
+    for (int i = 0; ok && i < pc->node_count; i++)
+        if (pc->nodes[i].count > pc->max_node_points)
+            pc->max_node_points = pc->nodes[i].count;
+
+    pc->draws = ok ? (PointCloudDraw *)malloc((size_t)pc->node_count * sizeof(PointCloudDraw)) : NULL;
+    pc->heap = ok ? (PointCloudDraw *)malloc((size_t)pc->node_count * sizeof(PointCloudDraw)) : NULL;
+    pc->upload_scratch = ok ? malloc((size_t)pc->max_node_points * sizeof(PointVertex)) : NULL;
+    if (!pc->draws || !pc->heap || !pc->upload_scratch)
+    {
+        printf("ERROR: point cloud octree build failed: %s\n", path);
+        point_cloud_free(pc);
+        return 0;
+    }
+    pc->build_ms = now_ms() - t1;
+
+    printf("Point cloud %s: %zu points%s, %d nodes, parse %.1f ms, octree %.1f ms (%d threads)\n",
+           path, count, colors ? " with colors" : "", pc->node_count, pc->parse_ms, pc->build_ms, threads);
+    return 1;
+}
+
+/* =========================================================
+   Wybór węzłów na klatkę
+   ========================================================= */
+
+static void heap_push(PointCloudDraw *heap, size_t *count, PointCloudDraw d)
+{
+    size_t i = (*count)++;
+    while (i > 0)
+    {
+        size_t parent = (i - 1) / 2;
+        if (heap[parent].priority >= d.priority)
+            break;
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i] = d;
+}
+
+static PointCloudDraw heap_pop(PointCloudDraw *heap, size_t *count)
+{
+    PointCloudDraw top = heap[0];
+    PointCloudDraw last = heap[--(*count)];
+    size_t i = 0;
+    for (;;)
+    {
+        size_t c = i * 2 + 1;
+        if (c >= *count)
+            break;
+        if (c + 1 < *count && heap[c + 1].priority > heap[c].priority)
+            c++;
+        if (heap[c].priority <= last.priority)
+            break;
+        heap[i] = heap[c];
+        i = c;
+    }
+    if (*count > 0)
+        heap[i] = last;
+    return top;
+}
+
+/**
+ * @brief Rozmiar kątowy sześcianu węzła i odległość od kamery.
+ */
+static float node_priority(const PointCloudNode *n, const vec3 cam_pos, float *dist_out)
+{
+    float half = n->size * 0.5f;
+    vec3 center = {n->bmin[0] + half, n->bmin[1] + half, n->bmin[2] + half};
+    float radius = half * 1.7320508f;
+    float dist = glm_vec3_distance(center, (float *)cam_pos) - radius;
+    dist = dist > 1e-3f ? dist : 1e-3f;
+    *dist_out = dist;
+    return radius / dist;
+}
+
+/**
+ * @brief Wysyła węzeł na GPU (współrzędne 16-bitowe względem węzła).
+ */
+static void upload_node(PointCloud *pc, PointCloudNode *n)
+{
+    PointVertex *out = (PointVertex *)pc->upload_scratch;
+    int localBits = POINT_CLOUD_MORTON_BITS - (int)n->level;
+    int drop = localBits > 16 ? localBits - 16 : 0;
+    uint32_t mask = (1u << localBits) - 1u;
+
+    for (uint32_t i = 0; i < n->count; i++)
+    {
+        uint64_t key = pc->keys[n->first + i];
+        out[i].x = (uint16_t)((compact_bits21(key) & mask) >> drop);
+        out[i].y = (uint16_t)((compact_bits21(key >> 1) & mask) >> drop);
+        out[i].z = (uint16_t)((compact_bits21(key >> 2) & mask) >> drop);
+        out[i].pad = 0;
+        out[i].color = pc->colors ? pc->colors[n->first + i] : POINT_WHITE;
+    }
+
+    glGenVertexArrays(1, &n->vao);
+    glGenBuffers(1, &n->vbo);
+    glBindVertexArray(n->vao);
+    glBindBuffer(GL_ARRAY_BUFFER, n->vbo);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)n->count * (GLsizeiptr)sizeof(PointVertex), out, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_FALSE, sizeof(PointVertex), (void *)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(PointVertex), (void *)offsetof(PointVertex, color));
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    pc->gpu_used += (size_t)n->count * sizeof(PointVertex);
+    pc->uploads_total++;
+}
+
+static void release_node(PointCloud *pc, PointCloudNode *n)
+{
+    glDeleteVertexArrays(1, &n->vao);
+    glDeleteBuffers(1, &n->vbo);
+    n->vao = n->vbo = 0;
+    pc->gpu_used -= (size_t)n->count * sizeof(PointVertex);
+}
+
+/**
+ * @brief Zwalnia najdawniej użyty węzeł spoza bieżącej klatki.
+ *
+ * @return 1 jeśli coś zwolniono.
+ */
+static int evict_lru(PointCloud *pc)
+{
+    int victim = -1;
+    for (int i = 0; i < pc->node_count; i++)
+    {
+        const PointCloudNode *n = &pc->nodes[i];
+        if (n->vao && n->last_used != pc->frame &&
+            (victim < 0 || n->last_used < pc->nodes[victim].last_used))
+            victim = i;
+    }
+    if (victim < 0)
+        return 0;
+    release_node(pc, &pc->nodes[victim]);
+    pc->evictions++;
+    return 1;
+}
+
+size_t point_cloud_update(PointCloud *pc, mat4 mvp, const vec3 cam_pos, float screen_scale)
+{
+    vec4 planes[6];
+    glm_frustum_planes(mvp, planes);
+    pc->frame++;
+    pc->draw_count = 0;
+    pc->drawn_points = 0;
+
+    size_t heapCount = 0;
+    float dist;
+    PointCloudDraw rootItem = {0, node_priority(&pc->nodes[0], cam_pos, &dist), 1.0f};
+    heap_push(pc->heap, &heapCount, rootItem);
+
+    // od największego rozmiaru kątowego, dopóki starcza budżetu punktów
+    while (heapCount > 0)
+    {
+        PointCloudDraw item = heap_pop(pc->heap, &heapCount);
+        PointCloudNode *n = &pc->nodes[item.node];
+
+        vec3 box[2] = {{n->bmin[0], n->bmin[1], n->bmin[2]},
+                       {n->bmin[0] + n->size, n->bmin[1] + n->size, n->bmin[2] + n->size}};
+        if (!glm_aabb_frustum(box, planes))
+            continue;
+        if (pc->drawn_points + n->count > pc->point_budget)
+            continue;
+
+        // odstęp punktów węzła na ekranie: komórka siatki próbkowania
+        node_priority(n, cam_pos, &dist);
+        float spacing = n->size / (float)(1u << POINT_CLOUD_GRID_BITS);
+        float pixels = spacing / dist * screen_scale;
+        int refine = pixels > pc->max_pixel_error;
+        int hasChildren = 0;
+
+        for (int c = 0; c < 8 && refine; c++)
+        {
+            if (n->child[c] < 0)
+                continue;
+            PointCloudDraw d = {n->child[c], node_priority(&pc->nodes[n->child[c]], cam_pos, &dist), 1.0f};
+            heap_push(pc->heap, &heapCount, d);
+            hasChildren = 1;
+        }
+
+        // dzieci dogęszczają obraz -> mniejsze punkty przodka
+        float size = hasChildren ? pixels * 0.5f : pixels;
+        item.point_size = size < 1.0f ? 1.0f : (size > POINT_CLOUD_POINT_SIZE_MAX ? POINT_CLOUD_POINT_SIZE_MAX : size);
+        pc->draws[pc->draw_count++] = item;
+        pc->drawn_points += n->count;
+        n->last_used = pc->frame;
+    }
+
+    // upload brakujących (od najważniejszych) pod budżetem na klatkę i VRAM
+    size_t uploaded = 0, missing = 0;
+    for (size_t i = 0; i < pc->draw_count; i++)
+    {
+        PointCloudNode *n = &pc->nodes[pc->draws[i].node];
+        if (n->vao)
+            continue;
+
+        size_t bytes = (size_t)n->count * sizeof(PointVertex);
+        while (pc->gpu_used + bytes > pc->gpu_budget && evict_lru(pc))
+        {
+        }
+        if (uploaded + bytes > pc->upload_budget || pc->gpu_used + bytes > pc->gpu_budget)
+        {
+            missing++;
+            continue;
+        }
+        upload_node(pc, n);
+        uploaded += bytes;
+    }
+
+    // zmniejszony budżet albo nadmiar z poprzednich klatek
+    while (pc->gpu_used > pc->gpu_budget && evict_lru(pc))
+    {
+    }
+    return missing;
+}
+
+size_t point_cloud_draw(const PointCloud *pc, GLuint program)
+{
+    GLint locMin = glGetUniformLocation(program, "uNodeMin");
+    GLint locScale = glGetUniformLocation(program, "uNodeScale");
+    GLint locSize = glGetUniformLocation(program, "uPointSize");
+    size_t points = 0;
+
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    for (size_t i = 0; i < pc->draw_count; i++)
+    {
+        const PointCloudNode *n = &pc->nodes[pc->draws[i].node];
+        if (!n->vao)
+            continue;
+
+        // jednostka współrzędnej 16-bitowej węzła
+        int localBits = POINT_CLOUD_MORTON_BITS - (int)n->level;
+        int stored = localBits > 16 ? 16 : localBits;
+        glUniform3fv(locMin, 1, n->bmin);
+        glUniform1f(locScale, n->size / (float)(1u << stored));
+        glUniform1f(locSize, pc->draws[i].point_size);
+
+        glBindVertexArray(n->vao);
+        glDrawArrays(GL_POINTS, 0, (GLsizei)n->count);
+        points += n->count;
+    }
+    glBindVertexArray(0);
+    glDisable(GL_PROGRAM_POINT_SIZE);
+    return points;
+}
+
+void point_cloud_print_stats(const PointCloud *pc)
+{
+    int resident = 0;
+    for (int i = 0; i < pc->node_count; i++)
+        resident += pc->nodes[i].vao != 0;
+
+    printf("[points] %zu points, %d nodes (max %u points/node), %.1f MB RAM | parse %.1f ms, octree %.1f ms\n",
+           pc->count, pc->node_count, pc->max_node_points,
+           (double)pc->count * (sizeof(uint64_t) + (pc->colors ? sizeof(uint32_t) : 0)) / (1024.0 * 1024.0),
+           pc->parse_ms, pc->build_ms);
+    printf("[points] frame: %zu nodes, %zu points (budget %zu) | GPU %d nodes, %.1f / %.1f MB, "
+           "uploads %zu, evictions %zu\n",
+           pc->draw_count, pc->drawn_points, pc->point_budget, resident,
+           (double)pc->gpu_used / (1024.0 * 1024.0), (double)pc->gpu_budget / (1024.0 * 1024.0),
+           pc->uploads_total, pc->evictions);
+}
+
+void point_cloud_free(PointCloud *pc)
+{
+    for (int i = 0; pc->nodes && i < pc->node_count; i++)
+        if (pc->nodes[i].vao)
+            release_node(pc, &pc->nodes[i]);
+    free(pc->nodes);
+    free(pc->keys);
+    free(pc->colors);
+    free(pc->draws);
+    free(pc->heap);
+    free(pc->upload_scratch);
+    memset(pc, 0, sizeof(*pc));
+}
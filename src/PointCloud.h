@@ -0,0 +1,131 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <glad/glad.h>
+#include <cglm/cglm.h>
+
+#define POINT_CLOUD_MORTON_BITS 21 // bity na oś w kodzie Morton (63 bity klucza)
+#define POINT_CLOUD_GRID_BITS 7    // próbka węzła: 1 punkt na komórkę siatki 128^3
+#define POINT_CLOUD_LEAF_MAX 32768 // więcej punktów -> węzeł jest dzielony
+#define POINT_CLOUD_POINT_SIZE_MAX 8.0f
+
+/**
+ * @brief Węzeł octree chmury punktów.
+ *
+ * Każdy punkt należy do dokładnie jednego węzła. Węzeł wewnętrzny
+ * trzyma równomierną próbkę swojego sześcianu (pierwszy punkt z każdej
+ * komórki siatki 2^GRID_BITS), reszta schodzi do dzieci — rysowanie
+ * przodków i dzieci razem daje pełną gęstość bez duplikatów.
+ */
+typedef struct PointCloudNode
+{
+    float bmin[3];
+    float size;         // bok sześcianu
+    int32_t child[8];   // -1 jeśli brak
+    size_t first;       // pierwszy punkt węzła w keys/colors
+    uint32_t count;     // punkty własne węzła
+    uint32_t level;     // 0 = korzeń
+
+    /* GPU (wątek główny) */
+    GLuint vao, vbo;
+    unsigned long last_used;
+} PointCloudNode;
+
+/**
+ * @brief Węzeł wybrany do narysowania w bieżącej klatce.
+ */
+typedef struct PointCloudDraw
+{
+    int node;
+    float priority;   // rozmiar kątowy (kolejka wyboru)
+    float point_size; // px
+} PointCloudDraw;
+
+/**
+ * @brief Chmura punktów z OBJ zawierającego tylko linie v.
+ *
+ * Pozycje są przechowywane jako 63-bitowe kody Morton (21 bitów na oś
+ * w sześcianie obejmującym chmurę), kolory jako RGBA8 — 12 bajtów na
+ * punkt w RAM. Po sortowaniu kodów każdy węzeł octree to ciągły zakres,
+ * a na GPU trafiają tylko wybrane węzły (16-bitowe współrzędne względem
+ * węzła + kolor, 12 bajtów na punkt) pod budżetem VRAM z LRU.
+ *
+ * Co klatkę węzły są wybierane od korzenia w kolejności rozmiaru
+ * kątowego: węzeł jest dzielony, dopóki odstęp jego punktów na ekranie
+ * przekracza max_pixel_error, a suma punktów mieści się w point_budget.
+ */
+typedef struct PointCloud
+{
+    uint64_t *keys;    // kody Morton, rosnąco w obrębie węzła
+    uint32_t *colors;  // RGBA8 albo NULL (brak kolorów w pliku)
+    size_t count;
+    float bmin[3];     // AABB punktów
+    float bmax[3];
+
+    PointCloudNode *nodes; // [0] = korzeń
+    int node_count;
+    uint32_t max_node_points;
+
+    size_t point_budget;     // punkty rysowane w jednej klatce
+    size_t gpu_budget;       // bajty VRAM na węzły
+    size_t upload_budget;    // bajty wysyłane w jednej klatce
+    float max_pixel_error;   // odstęp punktów (px), poniżej którego węzeł nie jest dzielony
+    size_t gpu_used;
+
+    /* wynik ostatniego point_cloud_update */
+    PointCloudDraw *draws;
+    size_t draw_count;
+    size_t drawn_points;
+    PointCloudDraw *heap;
+    void *upload_scratch;
+    unsigned long frame;
+
+    /* statystyki */
+    double parse_ms;
+    double build_ms;
+    size_t uploads_total;
+    size_t evictions;
+} PointCloud;
+
+/**
+ * @brief Wczytuje linie v (x y z [r g b]) z OBJ i buduje octree.
+ *
+ * Parsowanie, sortowanie kodów i budowa poddrzew idą równolegle na
+ * wszystkich rdzeniach. Ściany i pozostałe linie są ignorowane.
+ * Nie wymaga kontekstu GL (węzły trafiają na GPU w point_cloud_update).
+ *
+ * @param pc   Chmura.
+ * @param path Plik OBJ.
+ * @return 1 jeśli OK, 0 jeśli błąd lub brak punktów.
+ */
+int point_cloud_load_obj(PointCloud *pc, const char *path);
+
+/**
+ * @brief Wybór węzłów na klatkę: frustum, błąd ekranowy, budżety, upload.
+ *
+ * @param pc           Chmura.
+ * @param mvp          Macierz projection * view * model.
+ * @param cam_pos      Pozycja kamery w przestrzeni modelu.
+ * @param screen_scale Piksele na jednostkę w odległości 1 (wysokość / (2 tg(fov/2))).
+ * @return Liczba wybranych węzłów, których jeszcze nie ma na GPU (0 = obraz kompletny).
+ */
+size_t point_cloud_update(PointCloud *pc, mat4 mvp, const vec3 cam_pos, float screen_scale);
+
+/**
+ * @brief Rysuje wybrane węzły jako GL_POINTS.
+ *
+ * @param pc      Chmura.
+ * @param program Program shaders/points (uniformy uNodeMin, uNodeScale, uPointSize).
+ * @return Liczba narysowanych punktów.
+ */
+size_t point_cloud_draw(const PointCloud *pc, GLuint program);
+
+/**
+ * @brief Wypisuje rozmiar drzewa, czasy budowy i rezydencję GPU.
+ */
+void point_cloud_print_stats(const PointCloud *pc);
+
+/**
+ * @brief Zwalnia bufory GPU (wymaga kontekstu) i pamięć CPU.
+ */
+void point_cloud_free(PointCloud *pc);
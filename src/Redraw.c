@@ -0,0 +1,172 @@
+#include "Redraw.h"
+#include <stdio.h>
+#include <GLFW/glfw3.h>
+
+/* Powody, które oznaczają interakcję użytkownika (przerywają bezczynność). */
+#define REDRAW_INTERACTION (REDRAW_CAMERA | REDRAW_RESIZE | REDRAW_INPUT)
+
+/**
+ * @brief Inicjalizacja stanu i liczników.
+ */
+void redraw_init(RedrawState *r, int enabled, double now)
+{
+    r->enabled = enabled;
+    r->dirty = REDRAW_INPUT; // pierwsza klatka zawsze
+    r->frame = 0;
+    r->animations = 0;
+    r->resumed = 0;
+
+    r->refine_level = 0;
+    r->refine_max = 0;
+
+    r->wait_timeout = 1.0;
+    r->idle_after = 1.0;
+
+    r->last_interaction = now;
+    r->stats_start = now;
+    r->last_tick = now;
+    r->idle_time = 0.0;
+    r->idle_frames = 0;
+    r->idle_wakeups = 0;
+    r->active_time = 0.0;
+    r->active_frames = 0;
+}
+
+void redraw_set_enabled(RedrawState *r, int enabled)
+{
+    r->enabled = enabled;
+    r->dirty |= REDRAW_INPUT;
+}
+
+void redraw_mark(RedrawState *r, unsigned int reasons)
+{
+    r->dirty |= reasons;
+}
+
+void redraw_animation_begin(RedrawState *r)
+{
+    r->animations++;
+}
+
+void redraw_animation_end(RedrawState *r)
+{
+    if (r->animations > 0)
+        r->animations--;
+    r->dirty |= REDRAW_ANIMATION; // ostatnia klatka animacji
+}
+
+int redraw_needed(const RedrawState *r)
+{
+    return !r->enabled || r->dirty != 0 || r->animations > 0;
+}
+
+/**
+ * @brief Czy w chwili t widok był statyczny (bez interakcji).
+ */
+static int is_idle(const RedrawState *r, double t)
+{
+    return t - r->last_interaction >= r->idle_after && r->animations == 0;
+}
+
+/**
+ * @brief Dolicza przedział [last_tick, now] do czasu bezczynności
+ *        albo aktywności (wg stanu na początku przedziału).
+ */
+static void account_time(RedrawState *r, double now)
+{
+    double dt = now - r->last_tick;
+    if (dt <= 0.0)
+        return;
+
+    if (is_idle(r, r->last_tick))
+        r->idle_time += dt;
+    else
+        r->active_time += dt;
+    r->last_tick = now;
+}
+
+/**
+ * @brief Czeka na zdarzenie; w bezczynności planuje kroki doszlifowania.
+ */
+void redraw_wait(RedrawState *r, double now)
+{
+    double timeout = r->wait_timeout;
+
+    if (r->refine_level < r->refine_max)
+    {
+        double due = r->last_interaction + r->idle_after - now;
+        if (due <= 0.0)
+        {
+            r->refine_level++;
+            r->dirty |= REDRAW_REFINE;
+            return;
+        }
+        if (due < timeout)
+            timeout = due;
+    }
+
+    if (is_idle(r, now))
+        r->idle_wakeups++;
+
+    glfwWaitEventsTimeout(timeout);
+    // krótkie czekanie (zdarzenie zaraz po zaśnięciu) nie psuje delta time
+    if (glfwGetTime() - now >= REDRAW_LONG_WAIT)
+        r->resumed = 1;
+}
+
+int redraw_frame_begin(RedrawState *r)
+{
+    int resumed = r->resumed;
+    r->resumed = 0;
+    r->frame = r->dirty;
+    r->dirty = 0;
+    return resumed;
+}
+
+void redraw_frame_end(RedrawState *r, double now)
+{
+    account_time(r, now);
+
+    if ((r->frame | r->dirty) & REDRAW_INTERACTION)
+    {
+        r->last_interaction = now;
+        r->refine_level = 0;
+    }
+
+    if (is_idle(r, now))
+        r->idle_frames++;
+    else
+        r->active_frames++;
+
+    r->frame = 0;
+}
+
+/**
+ * @brief Liczba zdarzeń na minutę (0 jeśli brak czasu pomiaru).
+ */
+static double per_minute(unsigned long count, double seconds)
+{
+    return seconds > 0.0 ? (double)count * 60.0 / seconds : 0.0;
+}
+
+void redraw_report(RedrawState *r, double now)
+{
+    account_time(r, now);
+
+    printf("[redraw] mode=%s | idle: %.1f s, %lu frames (%.1f frames/min), %.1f wakeups/min"
+           " | active: %.1f s, %.1f frames/min\n",
+           r->enabled ? "on-demand" : "continuous",
+           r->idle_time,
+           r->idle_frames,
+           per_minute(r->idle_frames, r->idle_time),
+           per_minute(r->idle_wakeups, r->idle_time),
+           r->active_time,
+           per_minute(r->active_frames, r->active_time));
+
+    r->stats_start = now;
+    r->idle_time = 0.0;
+    r->idle_frames = 0;
+    r->idle_wakeups = 0;
+    r->active_time = 0.0;
+    r->active_frames = 0;
+}
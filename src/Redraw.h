@@ -0,0 +1,136 @@
+#pragma once
+
+#define REDRAW_LONG_WAIT 0.1 // czekanie dłuższe niż tyle sekund zeruje delta time
+
+/**
+ * @brief Powody, dla których klatka musi zostać narysowana ponownie.
+ *
+ * Maska bitowa — kilka powodów może być aktywnych naraz.
+ */
+typedef enum RedrawReason
+{
+    REDRAW_CAMERA    = 1 << 0, // ruch / obrót kamery
+    REDRAW_RESIZE    = 1 << 1, // zmiana rozmiaru framebuffera
+    REDRAW_UPLOAD    = 1 << 2, // nowe dane na GPU (mesh, tekstura, shader)
+    REDRAW_ANIMATION = 1 << 3, // aktywna animacja
+    REDRAW_INPUT     = 1 << 4, // inne zdarzenie wejścia (klawisz, przełącznik trybu)
+    REDRAW_REFINE    = 1 << 5  // progresywne doszlifowanie jakości w bezczynności
+} RedrawReason;
+
+/**
+ * @brief Stan trybu "render on demand".
+ *
+ * W trybie ciągłym (enabled == 0) każda iteracja pętli rysuje klatkę.
+ * W trybie on-demand pętla blokuje się w glfwWaitEventsTimeout, dopóki
+ * któryś z modułów nie zgłosi zmiany przez redraw_mark().
+ * Zgłoszenia w trakcie klatki (np. ruch kamery przy wciśniętym klawiszu,
+ * dane doczytane w tle) przechodzą na następną, więc pętla nie zasypia,
+ * dopóki coś się zmienia.
+ *
+ * Statystyki liczone są w obu trybach, więc można je porównać:
+ * "bezczynność" to okres bez ruchu kamery, wejścia i resize
+ * dłuższy niż idle_after sekund.
+ */
+typedef struct RedrawState
+{
+    int enabled;          // 1 = rysuj tylko gdy dirty
+    unsigned int dirty;   // maska RedrawReason (na następną klatkę)
+    unsigned int frame;   // powody bieżącej klatki (dirty przejęte w redraw_frame_begin)
+    int animations;       // liczba aktywnych animacji (wymuszają ciągłe rysowanie)
+    int resumed;          // 1 jeśli od ostatniej klatki pętla długo czekała na zdarzenia
+
+    int refine_level;     // bieżący poziom doszlifowania (0 = zwykła jakość)
+    int refine_max;       // ile kroków doszlifowania po przejściu w bezczynność (ustawia pętla; 0 = brak)
+
+    double wait_timeout;  // maksymalny czas blokowania w glfwWaitEventsTimeout (s)
+    double idle_after;    // po ilu sekundach bez interakcji uznajemy widok za statyczny
+
+    /* statystyki (proxy zużycia energii) */
+    double last_interaction;
+    double stats_start;
+    double idle_time;        // łączny czas w bezczynności
+    unsigned long idle_frames;
+    unsigned long idle_wakeups;
+    double active_time;
+    unsigned long active_frames;
+    double last_tick;
+} RedrawState;
+
+/**
+ * @brief Inicjalizuje stan odświeżania.
+ *
+ * @param r       Stan.
+ * @param enabled 1 = tryb on-demand, 0 = rysowanie ciągłe.
+ * @param now     Bieżący czas (glfwGetTime()).
+ */
+void redraw_init(RedrawState *r, int enabled, double now);
+
+/**
+ * @brief Włącza/wyłącza tryb on-demand (wymusza jedną klatkę).
+ */
+void redraw_set_enabled(RedrawState *r, int enabled);
+
+/**
+ * @brief Zgłasza potrzebę narysowania klatki.
+ *
+ * @param r       Stan.
+ * @param reasons Maska RedrawReason.
+ *
+ * @note Wywoływać tylko z wątku głównego. Wątki w tle powinny
+ *       zamiast tego obudzić pętlę przez glfwPostEmptyEvent().
+ */
+void redraw_mark(RedrawState *r, unsigned int reasons);
+
+/**
+ * @brief Rejestruje początek / koniec animacji.
+ *
+ * Dopóki jakakolwiek animacja jest aktywna, klatki rysowane są ciągle.
+ */
+void redraw_animation_begin(RedrawState *r);
+void redraw_animation_end(RedrawState *r);
+
+/**
+ * @brief Sprawdza, czy w tej iteracji pętli trzeba rysować.
+ *
+ * @return 1 jeśli klatka jest potrzebna.
+ */
+int redraw_needed(const RedrawState *r);
+
+/**
+ * @brief Blokuje wątek do czasu zdarzenia lub upływu wait_timeout.
+ *
+ * @param r   Stan.
+ * @param now Bieżący czas.
+ */
+void redraw_wait(RedrawState *r, double now);
+
+/**
+ * @brief Rozpoczyna klatkę: przejmuje dirty jako powody tej klatki.
+ *
+ * Zgłoszenia przez redraw_mark() od tej chwili dotyczą następnej klatki.
+ *
+ * @param r   Stan.
+ * @return 1 jeśli klatka następuje po czekaniu na zdarzenia dłuższym niż
+ *         REDRAW_LONG_WAIT (delta time należy wtedy wyzerować).
+ */
+int redraw_frame_begin(RedrawState *r);
+
+/**
+ * @brief Kończy klatkę: aktualizuje statystyki i planuje kolejny
+ *        krok doszlifowania.
+ *
+ * Zgłoszenia w trakcie klatki zostają w dirty (następna iteracja rysuje).
+ *
+ * @param r   Stan.
+ * @param now Bieżący czas (po glfwSwapBuffers).
+ */
+void redraw_frame_end(RedrawState *r, double now);
+
+/**
+ * @brief Wypisuje statystyki (klatki/min w bezczynności i aktywności)
+ *        i zeruje liczniki.
+ *
+ * @param r   Stan.
+ * @param now Bieżący czas.
+ */
+void redraw_report(RedrawState *r, double now);
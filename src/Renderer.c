@@ -0,0 +1,461 @@
+#include "Renderer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define RENDER_MAX_UNITS 16
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+}
+
+/* =========================================================
+ * Gęste identyfikatory stanu
+ * ========================================================= */
+
+static int id_map_init(RenderIdMap *m, uint32_t capacity, int bits)
+{
+    memset(m, 0, sizeof(*m));
+    m->keys = (uintptr_t *)malloc(capacity * sizeof(uintptr_t));
+    m->ids = (uint32_t *)malloc(capacity * sizeof(uint32_t));
+    m->stamp = (uint32_t *)calloc(capacity, sizeof(uint32_t));
+    m->capacity = capacity;
+    m->limit = (1u << bits) - 1u;
+    return m->keys && m->ids && m->stamp;
+}
+
+static void id_map_free(RenderIdMap *m)
+{
+    free(m->keys);
+    free(m->ids);
+    free(m->stamp);
+    memset(m, 0, sizeof(*m));
+}
+
+static uint32_t id_hash(uintptr_t key, uint32_t capacity)
+{
+    uint64_t h = (uint64_t)key * 0x9E3779B97F4A7C15ull;
+    return (uint32_t)(h >> 32) & (capacity - 1);
+}
+
+/**
+ * @brief Podwaja tablicę (przenosi tylko wpisy bieżącej generacji).
+ */
+static int id_map_grow(RenderIdMap *m, uint32_t generation)
+{
+    RenderIdMap grown;
+    if (!id_map_init(&grown, m->capacity * 2, 1))
+    {
+        id_map_free(&grown);
+        return 0;
+    }
+    grown.limit = m->limit;
+    grown.count = m->count;
+    for (uint32_t i = 0; i < m->capacity; i++)
+    {
+        if (m->stamp[i] != generation)
+            continue;
+        uint32_t slot = id_hash(m->keys[i], grown.capacity);
+        while (grown.stamp[slot] == generation)
+            slot = (slot + 1) & (grown.capacity - 1);
+        grown.keys[slot] = m->keys[i];
+        grown.ids[slot] = m->ids[i];
+        grown.stamp[slot] = generation;
+    }
+    id_map_free(m);
+    *m = grown;
+    return 1;
+}
+
+/**
+ * @brief Identyfikator stanu w tej klatce (kolejne liczby od zera).
+ *
+ * Po wyczerpaniu pola klucza nadmiarowe stany dzielą ostatni
+ * identyfikator — sortowanie słabiej grupuje, ale eliminacja stanu
+ * porównuje prawdziwe wartości, więc wynik jest poprawny.
+ */
+static uint32_t id_map_get(RenderIdMap *m, uint32_t generation, uintptr_t key)
+{
+    if ((m->count + 1) * 2 > m->capacity)
+        id_map_grow(m, generation);
+
+    uint32_t slot = id_hash(key, m->capacity);
+    while (m->stamp[slot] == generation)
+    {
+        if (m->keys[slot] == key)
+            return m->ids[slot];
+        slot = (slot + 1) & (m->capacity - 1);
+    }
+    if ((m->count + 1) * 2 > m->capacity)
+        return m->limit; // wzrost się nie udał: bez wpisu
+
+    m->keys[slot] = key;
+    m->ids[slot] = m->count < m->limit ? m->count : m->limit;
+    m->stamp[slot] = generation;
+    m->count++;
+    return m->ids[slot];
+}
+
+/* =========================================================
+ * Kolejka
+ * ========================================================= */
+
+static int reserve(RenderQueue *q, size_t capacity)
+{
+    if (capacity <= q->capacity)
+        return 1;
+    size_t n = q->capacity ? q->capacity : 256;
+    while (n < capacity)
+        n *= 2;
+
+    RenderItem *items = (RenderItem *)realloc(q->items, n * sizeof(RenderItem));
+    if (items)
+        q->items = items;
+    uint64_t *keys = (uint64_t *)realloc(q->keys, n * sizeof(uint64_t));
+    if (keys)
+        q->keys = keys;
+    uint64_t *tmpKeys = (uint64_t *)realloc(q->tmp_keys, n * sizeof(uint64_t));
+    if (tmpKeys)
+        q->tmp_keys = tmpKeys;
+    uint32_t *order = (uint32_t *)realloc(q->order, n * sizeof(uint32_t));
+    if (order)
+        q->order = order;
+    uint32_t *tmpOrder = (uint32_t *)realloc(q->tmp_order, n * sizeof(uint32_t));
+    if (tmpOrder)
+        q->tmp_order = tmpOrder;
+
+    if (!items || !keys || !tmpKeys || !order || !tmpOrder)
+        return 0;
+    q->capacity = n;
+    return 1;
+}
+
+int render_queue_init(RenderQueue *q, size_t capacity, float depth_far)
+{
+    memset(q, 0, sizeof(*q));
+    q->depth_far = depth_far > 0.0f ? depth_far : 1.0f;
+    q->generation = 1;
+
+    int ok = reserve(q, capacity);
+    ok = id_map_init(&q->programs, 64, RENDER_KEY_PROGRAM_BITS) && ok;
+    ok = id_map_init(&q->textures, 256, RENDER_KEY_TEXTURE_BITS) && ok;
+    ok = id_map_init(&q->materials, 256, RENDER_KEY_MATERIAL_BITS) && ok;
+    if (!ok)
+    {
+        render_queue_destroy(q);
+        return 0;
+    }
+    return 1;
+}
+
+void render_queue_begin(RenderQueue *q)
+{
+    q->count = 0;
+    q->sorted = 0;
+
+    // nowa generacja unieważnia wszystkie identyfikatory bez czyszczenia tablic
+    if (++q->generation == 0)
+    {
+        memset(q->programs.stamp, 0, q->programs.capacity * sizeof(uint32_t));
+        memset(q->textures.stamp, 0, q->textures.capacity * sizeof(uint32_t));
+        memset(q->materials.stamp, 0, q->materials.capacity * sizeof(uint32_t));
+        q->generation = 1;
+    }
+    q->programs.count = q->textures.count = q->materials.count = 0;
+}
+
+int render_queue_push(RenderQueue *q, RenderPass pass, const RenderItem *item, float depth)
+{
+    if (q->count == q->capacity && !reserve(q, q->count + 1))
+        return 0;
+
+    const uint32_t depthMax = (1u << RENDER_KEY_DEPTH_BITS) - 1u;
+    float d = depth / q->depth_far;
+    d = d < 0.0f ? 0.0f : (d > 1.0f ? 1.0f : d);
+    uint32_t qd = (uint32_t)(d * (float)depthMax);
+    if (pass == RENDER_PASS_TRANSPARENT)
+        qd = depthMax - qd; // od tyłu do przodu
+
+    uint64_t program = id_map_get(&q->programs, q->generation, (uintptr_t)item->program);
+    uint64_t texture = id_map_get(&q->textures, q->generation,
+                                  ((uintptr_t)item->texture << 4) | item->texture_unit);
+    uint64_t material = id_map_get(&q->materials, q->generation, (uintptr_t)item->material);
+
+    uint64_t key = (uint64_t)pass;
+    key = (key << RENDER_KEY_PROGRAM_BITS) | program;
+    key = (key << RENDER_KEY_TEXTURE_BITS) | texture;
+    key = (key << RENDER_KEY_MATERIAL_BITS) | material;
+    key = (key << RENDER_KEY_DEPTH_BITS) | qd;
+
+    q->items[q->count] = *item;
+    q->keys[q->count] = key;
+    q->order[q->count] = (uint32_t)q->count;
+    q->count++;
+    q->sorted = 0;
+    return 1;
+}
+
+/**
+ * @brief Radix sort LSD par (klucz, indeks), stabilny.
+ *
+ * Histogramy wszystkich 8 bajtów liczone w jednym przejściu; bajt, który
+ * jest taki sam we wszystkich kluczach (np. pass przy samym opaque),
+ * nie zmienia kolejności i jest pomijany.
+ */
+void render_queue_sort(RenderQueue *q)
+{
+    double t0 = now_ms();
+    size_t n = q->count;
+
+    uint32_t hist[8][256];
+    memset(hist, 0, sizeof(hist));
+    for (size_t i = 0; i < n; i++)
+    {
+        uint64_t k = q->keys[i];
+        for (int b = 0; b < 8; b++)
+            hist[b][(k >> (b * 8)) & 0xFF]++;
+    }
+
+    for (int b = 0; b < 8; b++)
+    {
+        uint32_t *h = hist[b];
+        if (n == 0 || h[(q->keys[0] >> (b * 8)) & 0xFF] == n)
+            continue;
+
+        uint32_t sum = 0;
+        for (int i = 0; i < 256; i++)
+        {
+            uint32_t c = h[i];
+            h[i] = sum;
+            sum += c;
+        }
+
+        const int shift = b * 8;
+        for (size_t i = 0; i < n; i++)
+        {
+            uint64_t k = q->keys[i];
+            uint32_t dst = h[(k >> shift) & 0xFF]++;
+            q->tmp_keys[dst] = k;
+            q->tmp_order[dst] = q->order[i];
+        }
+
+        uint64_t *keys = q->keys;
+        q->keys = q->tmp_keys;
+        q->tmp_keys = keys;
+        uint32_t *order = q->order;
+        q->order = q->tmp_order;
+        q->tmp_order = order;
+    }
+
+    q->sorted = 1;
+    q->stats.sort_ms = now_ms() - t0;
+}
+
+/**
+ * @brief Przechodzi kolejkę, ustawiając tylko zmieniony stan.
+ *
+ * @param issue 1 -> wywołania GL, 0 -> tylko liczenie zmian.
+ */
+static void walk(const RenderQueue *q, int sorted, int issue, RenderQueueStats *s)
+{
+    GLuint program = 0, vao = 0;
+    GLuint bound[RENDER_MAX_UNITS] = {0};
+    GLuint activeUnit = 0;
+    const void *material = NULL, *transform = NULL;
+    int materialOk = 1, transformOk = 1;
+    GLint primitiveBase = -1;
+    GLint primitiveLoc = -1;
+
+    for (size_t i = 0; i < q->count; i++)
+    {
+        const RenderItem *it = &q->items[sorted ? q->order[i] : i];
+
+        if (it->program != program)
+        {
+            program = it->program;
+            if (issue)
+            {
+                glUseProgram(program);
+                primitiveLoc = glGetUniformLocation(program, "uPrimitiveBase");
+            }
+            s->programs++;
+            // uniformy i dane rysowania należą do programu
+            material = transform = NULL;
+            primitiveBase = -1;
+        }
+        if (it->vao != vao)
+        {
+            vao = it->vao;
+            if (issue)
+                glBindVertexArray(vao);
+            s->vaos++;
+        }
+        if (it->texture && it->texture_unit < RENDER_MAX_UNITS && bound[it->texture_unit] != it->texture)
+        {
+            bound[it->texture_unit] = it->texture;
+            if (issue)
+            {
+                if (activeUnit != it->texture_unit)
+                {
+                    activeUnit = it->texture_unit;
+                    glActiveTexture(GL_TEXTURE0 + activeUnit);
+                }
+                glBindTexture(it->texture_target, it->texture);
+            }
+            s->textures++;
+        }
+        if (it->material != material)
+        {
+            material = it->material;
+            materialOk = !issue || !it->bind_material || it->bind_material(material, program);
+            s->materials++;
+        }
+        if (it->transform != transform)
+        {
+            transform = it->transform;
+            transformOk = !issue || !it->bind_transform || it->bind_transform(transform, program);
+            s->transforms++;
+        }
+        if (!materialOk || !transformOk)
+        {
+            // nieaktualne dane (np. macierze poprzedniego obiektu) gorsze niż brak rysowania
+            s->skipped++;
+            continue;
+        }
+        if (it->primitive_base >= 0 && it->primitive_base != primitiveBase)
+        {
+            primitiveBase = it->primitive_base;
+            if (issue)
+                glUniform1i(primitiveLoc, primitiveBase);
+            s->uniforms++;
+        }
+
+        if (issue)
+        {
+            if (it->occlusion_query)
+                glBeginConditionalRender(it->occlusion_query, GL_QUERY_WAIT);
+            glDrawElements(GL_TRIANGLES, (GLsizei)it->index_count, GL_UNSIGNED_INT,
+                           (const void *)(it->index_offset * sizeof(unsigned int)));
+            if (it->occlusion_query)
+                glEndConditionalRender();
+        }
+        s->draws++;
+        s->conditional += it->occlusion_query != 0;
+    }
+
+    if (issue)
+    {
+        if (vao)
+            glBindVertexArray(0);
+        if (activeUnit)
+            glActiveTexture(GL_TEXTURE0);
+    }
+}
+
+void render_queue_submit(RenderQueue *q)
+{
+    double t0 = now_ms();
+    double sortMs = q->sorted ? q->stats.sort_ms : 0.0;
+
+    memset(&q->stats, 0, sizeof(q->stats));
+    q->stats.items = q->count;
+    q->stats.sort_ms = sortMs;
+    walk(q, q->sorted, 1, &q->stats);
+    q->stats.submit_ms = now_ms() - t0;
+}
+
+size_t render_queue_submit_depth(const RenderQueue *q, GLuint program)
+{
+    const int passShift = 64 - RENDER_KEY_PASS_BITS;
+    GLuint vao = 0;
+    const void *transform = NULL;
+    int transformOk = 1;
+    size_t draws = 0;
+
+    glUseProgram(program);
+    for (size_t i = 0; i < q->count; i++)
+    {
+        // keys[i] odpowiada i-temu elementowi w kolejności rysowania
+        if ((RenderPass)(q->keys[i] >> passShift) != RENDER_PASS_OPAQUE)
+            continue;
+        const RenderItem *it = &q->items[q->sorted ? q->order[i] : i];
+
+        GLuint itemVao = it->depth_vao ? it->depth_vao : it->vao;
+        if (itemVao != vao)
+        {
+            vao = itemVao;
+            glBindVertexArray(vao);
+        }
+        if (it->transform != transform)
+        {
+            transform = it->transform;
+            transformOk = !it->bind_transform || it->bind_transform(transform, program);
+        }
+        if (!transformOk)
+            continue;
+        if (it->occlusion_query)
+            glBeginConditionalRender(it->occlusion_query, GL_QUERY_WAIT);
+        glDrawElements(GL_TRIANGLES, (GLsizei)it->index_count, GL_UNSIGNED_INT,
+                       (const void *)(it->index_offset * sizeof(unsigned int)));
+        if (it->occlusion_query)
+            glEndConditionalRender();
+        draws++;
+    }
+    if (vao)
+        glBindVertexArray(0);
+    return draws;
+}
+
+void render_queue_count_changes(const RenderQueue *q, int sorted, RenderQueueStats *out)
+{
+    memset(out, 0, sizeof(*out));
+    out->items = q->count;
+    walk(q, sorted && q->sorted, 0, out);
+}
+
+void render_queue_print_stats(const RenderQueue *q)
+{
+    const RenderQueueStats *s = &q->stats;
+    printf("[queue] %zu items, %zu draws (%zu conditional, %zu skipped) | state changes: %zu programs, %zu VAOs, "
+           "%zu textures, %zu materials, %zu transforms, %zu uniforms | sort %.3f ms, submit %.3f ms\n",
+           s->items, s->draws, s->conditional, s->skipped, s->programs, s->vaos, s->textures, s->materials,
+           s->transforms, s->uniforms, s->sort_ms, s->submit_ms);
+}
+
+void render_queue_destroy(RenderQueue *q)
+{
+    free(q->items);
+    free(q->keys);
+    free(q->order);
+    free(q->tmp_keys);
+    free(q->tmp_order);
+    id_map_free(&q->programs);
+    id_map_free(&q->textures);
+    id_map_free(&q->materials);
+    memset(q, 0, sizeof(*q));
+}
+
+/* =========================================================
+ * Materiał
+ * ========================================================= */
+
+int render_bind_material(const void *material, GLuint program)
+{
+    const Material *m = (const Material *)material;
+    glUniform3fv(glGetUniformLocation(program, "uMaterial.diffuseColor"), 1, m->diffuse);
+    glUniform1i(glGetUniformLocation(program, "uMaterial.diffuseMap"), 0);
+    return 1;
+}
+
+void render_item_from_material(RenderItem *item, const Material *m)
+{
+    item->texture_target = GL_TEXTURE_2D;
+    item->texture = m->diffuseTex;
+    item->texture_unit = 0;
+    item->material = m;
+    item->bind_material = render_bind_material;
+}
@@ -0,0 +1,213 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <glad/glad.h>
+
+#include "Material.h"
+
+/*
+ * Klucz sortowania (od najstarszego bitu):
+ *
+ *   pass:4 | program:8 | texture:12 | material:16 | depth:24
+ *
+ * Tekstura jest przed materiałem: bindowanie tekstury kosztuje więcej
+ * niż kilka uniformów, więc materiały z tą samą teksturą są obok siebie.
+ * Głębokość na końcu: w obrębie jednego stanu opaque od przodu do tyłu
+ * (wcześniejszy test głębi), przezroczyste od tyłu do przodu.
+ */
+#define RENDER_KEY_PASS_BITS 4
+#define RENDER_KEY_PROGRAM_BITS 8
+#define RENDER_KEY_TEXTURE_BITS 12
+#define RENDER_KEY_MATERIAL_BITS 16
+#define RENDER_KEY_DEPTH_BITS 24
+
+typedef enum RenderPass
+{
+    RENDER_PASS_OPAQUE = 0,
+    RENDER_PASS_TRANSPARENT,
+    RENDER_PASS_COUNT
+} RenderPass;
+
+/**
+ * @brief Ustawia stan wskazany przez wskaźnik (materiał, transformacja).
+ *
+ * @return 1 jeśli OK, 0 jeśli stanu nie udało się ustawić (np. pełny
+ *         GpuRing) — rysowania z tym stanem są pomijane.
+ */
+typedef int (*RenderBindFn)(const void *state, GLuint program);
+
+/**
+ * @brief Jedno wywołanie rysowania z pełnym opisem stanu.
+ *
+ * Stan jest porównywany wartościami (program, VAO, tekstura) albo
+ * wskaźnikami (materiał, transformacja) — ten sam wskaźnik oznacza
+ * ten sam stan i nie jest ustawiany ponownie.
+ */
+typedef struct RenderItem
+{
+    GLuint program;
+    GLuint vao;
+    GLuint depth_vao;      // same pozycje (Mesh.depthVAO); 0 -> przebieg głębi używa vao
+
+    GLenum texture_target; // GL_TEXTURE_2D / GL_TEXTURE_2D_ARRAY
+    GLuint texture;        // 0 = materiał bez tekstury (nic nie bindujemy)
+    GLuint texture_unit;
+
+    const void *material;
+    RenderBindFn bind_material;
+    const void *transform;
+    RenderBindFn bind_transform;
+
+    GLint primitive_base;  // uPrimitiveBase (-1 = nie używa)
+    size_t index_offset;
+    size_t index_count;
+
+    GLuint occlusion_query; // 0 = zawsze; inaczej rysowanie warunkowe (wynik testu z poprzedniej klatki)
+} RenderItem;
+
+/**
+ * @brief Zmiany stanu w jednej klatce (po eliminacji powtórzeń).
+ */
+typedef struct RenderQueueStats
+{
+    size_t items;
+    size_t draws;
+    size_t programs;
+    size_t vaos;
+    size_t textures;
+    size_t materials;
+    size_t transforms;
+    size_t uniforms;  // uPrimitiveBase
+    size_t skipped;   // rysowania pominięte, bo RenderBindFn zwróciła 0
+    size_t conditional; // rysowania w glBeginConditionalRender (ile GPU pominął: OcclusionCull)
+    double sort_ms;   // budowa kluczy nie wlicza się (push)
+    double submit_ms;
+} RenderQueueStats;
+
+/**
+ * @brief Gęste identyfikatory stanu do klucza (mapowanie z generacją).
+ */
+typedef struct RenderIdMap
+{
+    uintptr_t *keys;
+    uint32_t *ids;
+    uint32_t *stamp;
+    uint32_t capacity; // potęga dwójki
+    uint32_t count;
+    uint32_t limit;    // maksymalny identyfikator (pole klucza)
+} RenderIdMap;
+
+/**
+ * @brief Kolejka rysowania sortowana kluczami 64-bitowymi.
+ *
+ * Co klatkę: render_queue_begin(), render_queue_push() dla widocznych
+ * obiektów, render_queue_sort() (radix sort LSD, 8 przebiegów po 8 bitów,
+ * przebiegi ze wspólnym bajtem są pomijane) i render_queue_submit().
+ */
+typedef struct RenderQueue
+{
+    RenderItem *items;
+    uint64_t *keys;
+    uint32_t *order;   // kolejność rysowania (indeksy items)
+    uint64_t *tmp_keys;
+    uint32_t *tmp_order;
+    size_t count;
+    size_t capacity;
+    int sorted;
+
+    uint32_t generation;
+    RenderIdMap programs, textures, materials;
+
+    float depth_far;   // głębokość widoku mapowana na pełny zakres pola
+    RenderQueueStats stats;
+} RenderQueue;
+
+/**
+ * @brief Inicjalizuje kolejkę.
+ *
+ * @param q         Kolejka.
+ * @param capacity  Początkowa liczba elementów (rośnie w razie potrzeby).
+ * @param depth_far Daleka płaszczyzna (kwantyzacja głębokości).
+ * @return 1 jeśli OK, 0 jeśli błąd alokacji.
+ */
+int render_queue_init(RenderQueue *q, size_t capacity, float depth_far);
+
+/**
+ * @brief Czyści kolejkę na początku klatki.
+ */
+void render_queue_begin(RenderQueue *q);
+
+/**
+ * @brief Dodaje rysowanie.
+ *
+ * @param q     Kolejka.
+ * @param pass  Przebieg.
+ * @param item  Opis (kopiowany).
+ * @param depth Głębokość w przestrzeni widoku (dodatnia przed kamerą).
+ * @return 1 jeśli OK, 0 jeśli błąd alokacji.
+ */
+int render_queue_push(RenderQueue *q, RenderPass pass, const RenderItem *item, float depth);
+
+/**
+ * @brief Sortuje klucze (radix sort).
+ */
+void render_queue_sort(RenderQueue *q);
+
+/**
+ * @brief Rysuje kolejkę, pomijając stan równy poprzedniemu.
+ *
+ * Elementy z occlusion_query są rysowane w glBeginConditionalRender
+ * z GL_QUERY_WAIT: zapytanie jest z poprzedniej klatki, więc GPU ma już
+ * wynik, a przebieg głębi i główny pomijają ten sam zestaw rysowań.
+ *
+ * Po powrocie aktywna jest jednostka tekstury 0, VAO 0.
+ */
+void render_queue_submit(RenderQueue *q);
+
+/**
+ * @brief Przebieg samej głębi: rysowania opaque z depth_vao i podanym programem.
+ *
+ * Program, materiały i tekstury elementów są pomijane; ustawiana jest
+ * tylko transformacja (bind_transform z programem przebiegu głębi).
+ * Po powrocie VAO 0.
+ *
+ * @param q       Kolejka (po render_queue_sort()).
+ * @param program Program z samą pozycją (shaders/depth).
+ * @return Liczba wywołań rysowania.
+ */
+size_t render_queue_submit_depth(const RenderQueue *q, GLuint program);
+
+/**
+ * @brief Liczy zmiany stanu bez wywołań GL (benchmark).
+ *
+ * @param q      Kolejka.
+ * @param sorted 1 -> kolejność po sortowaniu, 0 -> kolejność dodania.
+ * @param out    Wynik (pola zmian stanu).
+ */
+void render_queue_count_changes(const RenderQueue *q, int sorted, RenderQueueStats *out);
+
+/**
+ * @brief Wypisuje zmiany stanu i koszt sortowania ostatniej klatki.
+ */
+void render_queue_print_stats(const RenderQueue *q);
+
+/**
+ * @brief Zwalnia pamięć.
+ */
+void render_queue_destroy(RenderQueue *q);
+
+/**
+ * @brief RenderBindFn dla Material: kolor i sampler.
+ *
+ * Tekstura materiału idzie osobno (RenderItem.texture), żeby kolejka
+ * mogła ją pominąć, gdy jest już zbindowana. Obecność tekstury wybiera
+ * wariant programu (material_shader_features()), nie uniform.
+ */
+int render_bind_material(const void *material, GLuint program);
+
+/**
+ * @brief Wypełnia RenderItem dla materiału z własną teksturą 2D.
+ *
+ * Nie ustawia programu: wołający wybiera wariant z material_shader_features().
+ */
+void render_item_from_material(RenderItem *item, const Material *m);
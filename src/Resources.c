@@ -0,0 +1,610 @@
+#include "Resources.h"
+#include "MeshCodec.h"
+#include "ObjLoader.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define RESOURCE_INITIAL_CAPACITY 64
+#define RESOURCE_INITIAL_BUCKETS 64
+
+static const char *g_kind_names[RESOURCE_KIND_COUNT] = {"none", "mesh", "material", "texture", "program"};
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+}
+
+static uint64_t fnv1a64(const char *s)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (; *s; s++)
+    {
+        h ^= (unsigned char)*s;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+/**
+ * @brief Kanoniczna ścieżka pliku (bez "..", dowiązań, z pełnym katalogiem).
+ *
+ * @return 1 jeśli OK, 0 jeśli plik nie istnieje albo ścieżka za długa.
+ */
+static int canonical_path(const char *path, char out[RESOURCE_PATH_MAX])
+{
+#ifdef _WIN32
+    if (!_fullpath(out, path, RESOURCE_PATH_MAX))
+        return 0;
+    FILE *f = fopen(out, "rb");
+    if (!f)
+        return 0;
+    fclose(f);
+    return 1;
+#else
+    char buf[PATH_MAX];
+    if (!realpath(path, buf) || strlen(buf) >= RESOURCE_PATH_MAX)
+        return 0;
+    strcpy(out, buf);
+    return 1;
+#endif
+}
+
+static int ends_with(const char *s, const char *suffix)
+{
+    size_t n = strlen(s), m = strlen(suffix);
+    return n >= m && strcmp(s + n - m, suffix) == 0;
+}
+
+/* =========================================================
+   Wpisy i tablica kubełków
+   ========================================================= */
+
+static int grow_entries(ResourceManager *rm)
+{
+    int cap = rm->capacity ? rm->capacity * 2 : RESOURCE_INITIAL_CAPACITY;
+    ResourceEntry *e = (ResourceEntry *)realloc(rm->entries, (size_t)cap * sizeof(ResourceEntry));
+    if (!e)
+        return 0;
+
+    // nowe wpisy na listę wolnych (wpis 0 zostaje pustym uchwytem)
+    memset(e + rm->capacity, 0, (size_t)(cap - rm->capacity) * sizeof(ResourceEntry));
+    for (int i = cap - 1; i >= rm->capacity; i--)
+    {
+        if (i == 0)
+            continue;
+        e[i].generation = 1;
+        e[i].next = rm->free_list;
+        rm->free_list = i;
+    }
+    rm->entries = e;
+    rm->capacity = cap;
+    return 1;
+}
+
+static int rehash(ResourceManager *rm, int bucket_count)
+{
+    int *b = (int *)malloc((size_t)bucket_count * sizeof(int));
+    if (!b)
+        return 0;
+    for (int i = 0; i < bucket_count; i++)
+        b[i] = -1;
+
+    for (int i = 1; i < rm->capacity; i++)
+    {
+        ResourceEntry *e = &rm->entries[i];
+        if (e->kind == RESOURCE_NONE)
+            continue;
+        int slot = (int)(e->hash & (uint64_t)(bucket_count - 1));
+        e->next = b[slot];
+        b[slot] = i;
+    }
+    free(rm->buckets);
+    rm->buckets = b;
+    rm->bucket_count = bucket_count;
+    return 1;
+}
+
+static int find_entry(const ResourceManager *rm, ResourceKind kind, const char *key, uint64_t hash)
+{
+    for (int i = rm->buckets[hash & (uint64_t)(rm->bucket_count - 1)]; i >= 0; i = rm->entries[i].next)
+    {
+        const ResourceEntry *e = &rm->entries[i];
+        if (e->hash == hash && e->kind == kind && strcmp(e->key, key) == 0)
+            return i;
+    }
+    return 0;
+}
+
+static void unlink_entry(ResourceManager *rm, int index)
+{
+    int *link = &rm->buckets[rm->entries[index].hash & (uint64_t)(rm->bucket_count - 1)];
+    while (*link != index)
+        link = &rm->entries[*link].next;
+    *link = rm->entries[index].next;
+}
+
+static ResourceHandle handle_of(const ResourceManager *rm, int index)
+{
+    ResourceHandle h = {(uint32_t)index, rm->entries[index].generation};
+    return h;
+}
+
+static ResourceEntry *entry_of(const ResourceManager *rm, ResourceHandle h, ResourceKind kind)
+{
+    if (h.index == 0 || h.index >= (uint32_t)rm->capacity)
+        return NULL;
+    ResourceEntry *e = &rm->entries[h.index];
+    if (e->generation != h.generation || e->kind != kind)
+        return NULL;
+    return e;
+}
+
+static void enforce_budget(ResourceManager *rm);
+
+/**
+ * @brief Zwalnia zasób wpisu (GL) i oddaje wpis na listę wolnych.
+ */
+static void drop_entry(ResourceManager *rm, int index)
+{
+    ResourceEntry e = rm->entries[index];
+
+    unlink_entry(rm, index);
+    free(e.key);
+    rm->resident_bytes -= e.bytes;
+    rm->live--;
+
+    ResourceEntry *slot = &rm->entries[index];
+    memset(&slot->u, 0, sizeof(slot->u));
+    slot->kind = RESOURCE_NONE;
+    slot->key = NULL;
+    slot->generation++;
+    slot->next = rm->free_list;
+    rm->free_list = index;
+
+    // po odłączeniu wpisu: zwolnienie tekstury materiału może usuwać inne wpisy
+    switch (e.kind)
+    {
+    case RESOURCE_MESH:
+        mesh_destroy(&e.u.mesh.mesh);
+        if (e.u.mesh.multi_material)
+            model_materials_destroy(&e.u.mesh.materials);
+        break;
+    case RESOURCE_MATERIAL:
+        resources_release(rm, e.u.material.texture);
+        break;
+    case RESOURCE_TEXTURE:
+        if (e.u.texture.stream >= 0)
+            texture_streamer_remove(rm->streamer, e.u.texture.stream);
+        else
+            glDeleteTextures(1, &e.u.texture.id);
+        break;
+    case RESOURCE_PROGRAM:
+        shader_variants_destroy(&e.u.program);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Istniejący wpis o danym kluczu: +1 referencja.
+ */
+static ResourceHandle acquire_existing(ResourceManager *rm, ResourceKind kind, const char *key)
+{
+    ResourceHandle none = {0, 0};
+    int i = find_entry(rm, kind, key, fnv1a64(key));
+    if (!i)
+        return none;
+
+    rm->entries[i].refcount++;
+    rm->entries[i].last_used = ++rm->tick;
+    rm->stats.hits[kind]++;
+    return handle_of(rm, i);
+}
+
+/**
+ * @brief Dodaje wczytany zasób z jedną referencją.
+ *
+ * @param e Wpis z ustawionym kind, bytes i u (reszta uzupełniana tutaj).
+ * @return Uchwyt albo pusty uchwyt, jeśli zabrakło pamięci.
+ */
+static ResourceHandle insert_entry(ResourceManager *rm, ResourceEntry *e, const char *key)
+{
+    ResourceHandle none = {0, 0};
+    char *k = (char *)malloc(strlen(key) + 1);
+    if (!k || (rm->free_list < 0 && !grow_entries(rm)) ||
+        (rm->live + 1 > rm->bucket_count * 2 && !rehash(rm, rm->bucket_count * 2)))
+    {
+        free(k);
+        return none;
+    }
+    strcpy(k, key);
+
+    int index = rm->free_list;
+    ResourceEntry *slot = &rm->entries[index];
+    rm->free_list = slot->next;
+
+    e->key = k;
+    e->hash = fnv1a64(key);
+    e->generation = slot->generation;
+    e->refcount = 1;
+    e->last_used = ++rm->tick;
+    int bucket = (int)(e->hash & (uint64_t)(rm->bucket_count - 1));
+    e->next = rm->buckets[bucket];
+    *slot = *e;
+    rm->buckets[bucket] = index;
+
+    rm->live++;
+    rm->resident_bytes += e->bytes;
+    rm->stats.loads[e->kind]++;
+
+    // nowy zasób mógł przekroczyć budżet: miejsce robią nieużywane
+    enforce_budget(rm);
+    return handle_of(rm, index);
+}
+
+/**
+ * @brief Usuwa najdawniej używane wpisy bez referencji, aż suma zmieści się w budżecie.
+ */
+static void enforce_budget(ResourceManager *rm)
+{
+    while (rm->budget_bytes > 0 && rm->resident_bytes > rm->budget_bytes)
+    {
+        int victim = 0;
+        for (int i = 1; i < rm->capacity; i++)
+        {
+            const ResourceEntry *e = &rm->entries[i];
+            if (e->kind != RESOURCE_NONE && e->refcount == 0 &&
+                (!victim || e->last_used < rm->entries[victim].last_used))
+                victim = i;
+        }
+        if (!victim)
+            break;
+
+        rm->stats.evictions[rm->entries[victim].kind]++;
+        drop_entry(rm, victim);
+    }
+}
+
+/* =========================================================
+   Wczytywanie zasobów
+   ========================================================= */
+
+ResourceHandle resources_acquire_mesh(ResourceManager *rm, const char *path, const char *mtl_path)
+{
+    ResourceHandle none = {0, 0};
+    char mkey[RESOURCE_PATH_MAX], lkey[RESOURCE_PATH_MAX], key[2 * RESOURCE_PATH_MAX];
+    if (!canonical_path(path, mkey))
+    {
+        printf("ERROR: model not found: %s\n", path);
+        return none;
+    }
+    // ta sama siatka z inną biblioteką MTL ma inne materiały (i kolejność indeksów)
+    if (mtl_path && !canonical_path(mtl_path, lkey))
+        snprintf(lkey, sizeof(lkey), "%s", mtl_path);
+    snprintf(key, sizeof(key), "%s\n%s", mkey, mtl_path ? lkey : "");
+
+    ResourceHandle h = acquire_existing(rm, RESOURCE_MESH, key);
+    if (h.index)
+        return h;
+
+    double t0 = now_ms();
+    ObjModelData data;
+    int ok = ends_with(mkey, ".omc") ? mesh_codec_load(mkey, &data) : obj_load_ex(mkey, &data, &rm->normals);
+    if (!ok)
+        return none;
+
+    if (rm->weld.position_eps > 0.0f)
+    {
+        WeldStats ws;
+        if (weld_model(&data, &rm->weld, &ws))
+            weld_print_stats(&ws);
+    }
+
+    ResourceEntry e;
+    memset(&e, 0, sizeof(e));
+    e.kind = RESOURCE_MESH;
+    ResourceMesh *m = &e.u.mesh;
+
+    // usemtl -> materiały z biblioteki (przestawia indeksy, więc przed mesh_create)
+    if (data.submesh_count > 0 && mtl_path)
+    {
+        m->multi_material = model_materials_init(&m->materials, &data, mtl_path, rm->tex_pack);
+        if (m->multi_material && m->materials.packed)
+            e.bytes += m->materials.pack.stats.bytes;
+    }
+
+    m->mesh = mesh_create(data.vertices, (unsigned int)data.vertex_count,
+                          data.indices, (unsigned int)data.index_count);
+    obj_compute_bounds(&data, m->bmin, m->bmax);
+    if (rm->streamer)
+        m->uv_density = texture_stream_uv_density(data.vertices, data.indices, data.index_count);
+    e.bytes += mesh_gpu_bytes(data.vertex_count, data.index_count);
+    obj_free(&data);
+    rm->stats.load_ms += now_ms() - t0;
+
+    h = insert_entry(rm, &e, key);
+    if (!h.index)
+    {
+        mesh_destroy(&m->mesh);
+        if (m->multi_material)
+            model_materials_destroy(&m->materials);
+    }
+    return h;
+}
+
+ResourceHandle resources_acquire_texture(ResourceManager *rm, const char *path)
+{
+    ResourceHandle none = {0, 0};
+    char key[RESOURCE_PATH_MAX];
+    if (!canonical_path(path, key))
+    {
+        printf("Failed to load texture: %s\n", path);
+        return none;
+    }
+
+    ResourceHandle h = acquire_existing(rm, RESOURCE_TEXTURE, key);
+    if (h.index)
+        return h;
+
+    double t0 = now_ms();
+    TextureImage img;
+    if (!texture_image_load(key, &img))
+        return none;
+
+    ResourceEntry e;
+    memset(&e, 0, sizeof(e));
+    e.kind = RESOURCE_TEXTURE;
+    e.u.texture.width = img.width;
+    e.u.texture.height = img.height;
+    e.u.texture.stream = -1;
+    // mipmapy: + 1/3 poziomu 0
+    e.bytes = (size_t)img.width * (size_t)img.height * (size_t)img.channels * 4 / 3;
+    if (rm->streamer)
+    {
+        // streamer przejmuje obraz; VRAM liczy we własnym budżecie
+        e.u.texture.stream = texture_streamer_add(rm->streamer, key, &img);
+        e.u.texture.id = texture_streamer_texture(rm->streamer, e.u.texture.stream);
+        if (e.u.texture.stream < 0)
+            return none;
+    }
+    else
+    {
+        e.u.texture.id = texture_create_2d(&img);
+        texture_image_free(&img);
+    }
+    rm->stats.load_ms += now_ms() - t0;
+
+    h = insert_entry(rm, &e, key);
+    if (!h.index)
+    {
+        if (e.u.texture.stream >= 0)
+            texture_streamer_remove(rm->streamer, e.u.texture.stream);
+        else
+            glDeleteTextures(1, &e.u.texture.id);
+    }
+    return h;
+}
+
+ResourceHandle resources_acquire_material(ResourceManager *rm, const char *mtl_path)
+{
+    ResourceHandle none = {0, 0};
+    char key[RESOURCE_PATH_MAX];
+    if (!canonical_path(mtl_path, key))
+    {
+        printf("ERROR: material not found: %s\n", mtl_path);
+        return none;
+    }
+
+    ResourceHandle h = acquire_existing(rm, RESOURCE_MATERIAL, key);
+    if (h.index)
+        return h;
+
+    MaterialDesc desc;
+    if (!material_parse_mtl(key, &desc))
+        return none;
+
+    ResourceEntry e;
+    memset(&e, 0, sizeof(e));
+    e.kind = RESOURCE_MATERIAL;
+    ResourceMaterial *m = &e.u.material;
+    material_init(&m->material);
+    memcpy(m->material.diffuse, desc.diffuse, sizeof(m->material.diffuse));
+
+    // ścieżka map_Kd jak w material_load_mtl() (względem katalogu roboczego)
+    if (desc.diffuseMap[0])
+    {
+        m->texture = resources_acquire_texture(rm, desc.diffuseMap);
+        const ResourceTexture *t = resources_texture(rm, m->texture);
+        m->material.diffuseTex = t ? t->id : 0;
+    }
+
+    h = insert_entry(rm, &e, key);
+    if (!h.index)
+        resources_release(rm, m->texture);
+    return h;
+}
+
+ResourceHandle resources_acquire_program(ResourceManager *rm, const char *vertex_path, const char *fragment_path)
+{
+    ResourceHandle none = {0, 0};
+    char vkey[RESOURCE_PATH_MAX], fkey[RESOURCE_PATH_MAX], key[2 * RESOURCE_PATH_MAX];
+    if (!canonical_path(vertex_path, vkey) || !canonical_path(fragment_path, fkey))
+    {
+        printf("ERROR: shader not found: %s / %s\n", vertex_path, fragment_path);
+        return none;
+    }
+    snprintf(key, sizeof(key), "%s\n%s", vkey, fkey);
+
+    ResourceHandle h = acquire_existing(rm, RESOURCE_PROGRAM, key);
+    if (h.index)
+        return h;
+
+    double t0 = now_ms();
+    ResourceEntry e;
+    memset(&e, 0, sizeof(e));
+    e.kind = RESOURCE_PROGRAM;
+    if (!shader_variants_load(&e.u.program, vertex_path, fragment_path))
+        return none;
+    shader_variants_set_setup(&e.u.program, rm->program_setup, rm->program_setup_user);
+    if (!shader_variants_get(&e.u.program, 0))
+    {
+        shader_variants_destroy(&e.u.program);
+        return none;
+    }
+    rm->stats.load_ms += now_ms() - t0;
+
+    h = insert_entry(rm, &e, key);
+    if (!h.index)
+        shader_variants_destroy(&e.u.program);
+    return h;
+}
+
+/* =========================================================
+   API
+   ========================================================= */
+
+int resources_init(ResourceManager *rm, size_t budget_bytes)
+{
+    memset(rm, 0, sizeof(*rm));
+    rm->free_list = -1;
+    rm->budget_bytes = budget_bytes;
+    rm->normals = normal_gen_params_default();
+    rm->weld = weld_params_default();
+    rm->tex_pack = 1;
+
+    if (!grow_entries(rm) || !rehash(rm, RESOURCE_INITIAL_BUCKETS))
+    {
+        free(rm->entries);
+        rm->entries = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+void resources_addref(ResourceManager *rm, ResourceHandle h)
+{
+    if (h.index == 0 || h.index >= (uint32_t)rm->capacity)
+        return;
+    ResourceEntry *e = &rm->entries[h.index];
+    if (e->kind != RESOURCE_NONE && e->generation == h.generation)
+    {
+        e->refcount++;
+        e->last_used = ++rm->tick;
+    }
+}
+
+void resources_release(ResourceManager *rm, ResourceHandle h)
+{
+    if (h.index == 0 || h.index >= (uint32_t)rm->capacity)
+        return;
+    ResourceEntry *e = &rm->entries[h.index];
+    if (e->kind == RESOURCE_NONE || e->generation != h.generation || e->refcount <= 0)
+        return;
+
+    e->last_used = ++rm->tick;
+    if (--e->refcount > 0)
+        return;
+
+    if (rm->budget_bytes == 0)
+    {
+        rm->stats.releases[e->kind]++;
+        drop_entry(rm, (int)h.index);
+    }
+    else
+    {
+        enforce_budget(rm);
+    }
+}
+
+const ResourceMesh *resources_mesh(const ResourceManager *rm, ResourceHandle h)
+{
+    const ResourceEntry *e = entry_of(rm, h, RESOURCE_MESH);
+    return e ? &e->u.mesh : NULL;
+}
+
+const ResourceMaterial *resources_material(const ResourceManager *rm, ResourceHandle h)
+{
+    const ResourceEntry *e = entry_of(rm, h, RESOURCE_MATERIAL);
+    return e ? &e->u.material : NULL;
+}
+
+const ResourceTexture *resources_texture(const ResourceManager *rm, ResourceHandle h)
+{
+    const ResourceEntry *e = entry_of(rm, h, RESOURCE_TEXTURE);
+    return e ? &e->u.texture : NULL;
+}
+
+GLuint resources_program(const ResourceManager *rm, ResourceHandle h)
+{
+    const ResourceEntry *e = entry_of(rm, h, RESOURCE_PROGRAM);
+    return e ? e->u.program.programs[0] : 0;
+}
+
+ShaderVariants *resources_program_variants(ResourceManager *rm, ResourceHandle h)
+{
+    ResourceEntry *e = entry_of(rm, h, RESOURCE_PROGRAM);
+    return e ? &e->u.program : NULL;
+}
+
+void resources_set_budget(ResourceManager *rm, size_t budget_bytes)
+{
+    rm->budget_bytes = budget_bytes;
+    if (budget_bytes > 0)
+    {
+        enforce_budget(rm);
+        return;
+    }
+
+    // bez budżetu nic nieużywanego nie zostaje
+    for (int i = 1; i < rm->capacity; i++)
+    {
+        ResourceEntry *e = &rm->entries[i];
+        if (e->kind != RESOURCE_NONE && e->refcount == 0)
+        {
+            rm->stats.releases[e->kind]++;
+            drop_entry(rm, i);
+        }
+    }
+}
+
+void resources_print_stats(const ResourceManager *rm)
+{
+    int unused = 0;
+    for (int i = 1; i < rm->capacity; i++)
+        unused += rm->entries[i].kind != RESOURCE_NONE && rm->entries[i].refcount == 0;
+
+    if (rm->budget_bytes > 0)
+        printf("[resources] %d live (%d unused), %.1f MB resident, budget %.1f MB, loading %.1f ms\n",
+               rm->live, unused, rm->resident_bytes / 1048576.0, rm->budget_bytes / 1048576.0,
+               rm->stats.load_ms);
+    else
+        printf("[resources] %d live, %.1f MB resident, no cache for unused, loading %.1f ms\n",
+               rm->live, rm->resident_bytes / 1048576.0, rm->stats.load_ms);
+
+    for (int k = RESOURCE_MESH; k < RESOURCE_KIND_COUNT; k++)
+        printf("  %-8s %zu loads, %zu hits, %zu released, %zu evicted\n", g_kind_names[k],
+               rm->stats.loads[k], rm->stats.hits[k], rm->stats.releases[k], rm->stats.evictions[k]);
+}
+
+void resources_destroy(ResourceManager *rm)
+{
+    if (!rm->entries)
+        return;
+
+    // materiały przed teksturami: zwolnienie materiału oddaje referencję tekstury
+    for (int kind = RESOURCE_MESH; kind < RESOURCE_KIND_COUNT; kind++)
+        for (int i = 1; i < rm->capacity; i++)
+            if (rm->entries[i].kind == (ResourceKind)kind)
+                drop_entry(rm, i);
+
+    free(rm->entries);
+    free(rm->buckets);
+    memset(rm, 0, sizeof(*rm));
+}
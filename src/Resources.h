@@ -0,0 +1,214 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <glad/glad.h>
+
+#include "Shader.h"
+#include "Mesh.h"
+#include "Material.h"
+#include "ModelMaterials.h"
+#include "Normals.h"
+#include "Weld.h"
+#include "TextureStream.h"
+
+#define RESOURCE_PATH_MAX 1024
+
+typedef enum ResourceKind
+{
+    RESOURCE_NONE = 0,
+    RESOURCE_MESH,
+    RESOURCE_MATERIAL,
+    RESOURCE_TEXTURE,
+    RESOURCE_PROGRAM,
+    RESOURCE_KIND_COUNT
+} ResourceKind;
+
+/**
+ * @brief Uchwyt zasobu: indeks wpisu + generacja.
+ *
+ * Po zwolnieniu wpisu generacja rośnie, więc stary uchwyt przestaje
+ * pasować (getter zwraca NULL) zamiast wskazywać na cudzy zasób.
+ * index == 0 oznacza pusty uchwyt.
+ */
+typedef struct ResourceHandle
+{
+    uint32_t index;
+    uint32_t generation;
+} ResourceHandle;
+
+/**
+ * @brief Model: siatka GPU, AABB i opcjonalnie materiały usemtl.
+ */
+typedef struct ResourceMesh
+{
+    Mesh mesh;
+    float bmin[3];
+    float bmax[3];
+    int multi_material;
+    ModelMaterials materials;
+    float uv_density; // texture_stream_uv_density() (0 bez streamera)
+} ResourceMesh;
+
+/**
+ * @brief Materiał (pierwszy z pliku MTL); tekstura jest osobnym zasobem.
+ */
+typedef struct ResourceMaterial
+{
+    Material material;      // diffuseTex = tekstura zasobu texture (nie zwalniać)
+    ResourceHandle texture;
+} ResourceMaterial;
+
+typedef struct ResourceTexture
+{
+    GLuint id;
+    int width, height;
+    int stream; // uchwyt w ResourceManager.streamer (-1 -> id jest własne)
+} ResourceTexture;
+
+typedef struct ResourceEntry
+{
+    ResourceKind kind;
+    char *key;          // kanoniczna ścieżka (program: "vert\nfrag")
+    uint64_t hash;      // FNV-1a 64 klucza
+    uint32_t generation;
+    int next;           // następny wpis w kubełku / na liście wolnych (-1 = koniec)
+    int refcount;
+    uint64_t last_used; // takt menedżera (LRU nieużywanych)
+    size_t bytes;       // szacunek pamięci (GPU + CPU)
+    union
+    {
+        ResourceMesh mesh;
+        ResourceMaterial material;
+        ResourceTexture texture;
+        ShaderVariants program;
+    } u;
+} ResourceEntry;
+
+typedef struct ResourceStats
+{
+    size_t loads[RESOURCE_KIND_COUNT];    // wczytania z dysku
+    size_t hits[RESOURCE_KIND_COUNT];     // acquire trafione w istniejący wpis
+    size_t releases[RESOURCE_KIND_COUNT]; // zwolnione od razu (brak budżetu)
+    size_t evictions[RESOURCE_KIND_COUNT];
+    double load_ms;
+} ResourceStats;
+
+/**
+ * @brief Ustawia stan programu po wczytaniu (bloki uniformów, samplery).
+ */
+typedef void (*ResourceProgramSetupFn)(GLuint program, void *user);
+
+/**
+ * @brief Menedżer zasobów z licznikami referencji.
+ *
+ * Zasoby są kluczowane kanoniczną ścieżką (realpath), więc
+ * "a/../model.obj" i "model.obj" to ten sam wpis, wyszukiwany przez
+ * hasz w tablicy kubełków. Model użyty N razy jest parsowany
+ * i wysyłany na GPU raz; każde acquire zwiększa licznik, release
+ * zmniejsza.
+ *
+ * Wpis z licznikiem 0:
+ *  - budget_bytes == 0 -> zwalniany od razu,
+ *  - budget_bytes > 0  -> zostaje w pamięci (kolejne acquire bez
+ *    wczytywania) i jest usuwany od najdawniej używanego, gdy suma
+ *    zasobów przekracza budżet. Używane zasoby nie są usuwane nigdy.
+ */
+typedef struct ResourceManager
+{
+    ResourceEntry *entries; // [0] nieużywany (pusty uchwyt)
+    int capacity;
+    int free_list;
+    int *buckets;
+    int bucket_count;       // potęga dwójki
+    int live;
+
+    size_t budget_bytes;
+    size_t resident_bytes;
+    uint64_t tick;
+
+    NormalGenParams normals;
+    WeldParams weld;
+    int tex_pack;
+    ResourceProgramSetupFn program_setup;
+    void *program_setup_user;
+    TextureStreamer *streamer; // tekstury strumieniowane (NULL -> od razu pełne)
+
+    ResourceStats stats;
+} ResourceManager;
+
+/**
+ * @brief Inicjalizuje pusty menedżer.
+ *
+ * @param rm           Menedżer.
+ * @param budget_bytes Budżet zasobów nieużywanych (0 -> zwalniaj od razu).
+ * @return 1 jeśli OK, 0 jeśli błąd alokacji.
+ */
+int resources_init(ResourceManager *rm, size_t budget_bytes);
+
+/**
+ * @brief Model OBJ (albo .omc) z materiałami usemtl z mtl_path.
+ *
+ * Dla modelu z wieloma materiałami pierwsze acquire ustala bibliotekę MTL.
+ */
+ResourceHandle resources_acquire_mesh(ResourceManager *rm, const char *path, const char *mtl_path);
+
+/**
+ * @brief Pierwszy materiał pliku MTL i jego tekstura (map_Kd).
+ */
+ResourceHandle resources_acquire_material(ResourceManager *rm, const char *mtl_path);
+
+/**
+ * @brief Tekstura 2D z mipmapami.
+ *
+ * Z ustawionym streamerem na GPU trafia sam ogon łańcucha mip, a drobniejsze
+ * poziomy według texture_streamer_request() (id tekstury się nie zmienia).
+ */
+ResourceHandle resources_acquire_texture(ResourceManager *rm, const char *path);
+
+/**
+ * @brief Program z pary plików; po linkowaniu woła program_setup.
+ *
+ * Przy wczytaniu kompilowany jest wariant bazowy (bez cech); pozostałe
+ * przy pierwszym resources_program_variants() + shader_variants_get().
+ */
+ResourceHandle resources_acquire_program(ResourceManager *rm, const char *vertex_path, const char *fragment_path);
+
+/**
+ * @brief Dodatkowa referencja do istniejącego uchwytu.
+ */
+void resources_addref(ResourceManager *rm, ResourceHandle h);
+
+/**
+ * @brief Oddaje referencję (wpis zwalniany lub zostaje w budżecie).
+ */
+void resources_release(ResourceManager *rm, ResourceHandle h);
+
+/**
+ * @brief Gettery; NULL dla pustego, nieaktualnego lub innego rodzaju uchwytu.
+ */
+const ResourceMesh *resources_mesh(const ResourceManager *rm, ResourceHandle h);
+const ResourceMaterial *resources_material(const ResourceManager *rm, ResourceHandle h);
+const ResourceTexture *resources_texture(const ResourceManager *rm, ResourceHandle h);
+GLuint resources_program(const ResourceManager *rm, ResourceHandle h);
+
+/**
+ * @brief Warianty programu (shader_variants_get() kompiluje brakujące i woła program_setup).
+ *
+ * Wskaźnik ważny do następnego acquire (tablica wpisów może urosnąć).
+ */
+ShaderVariants *resources_program_variants(ResourceManager *rm, ResourceHandle h);
+
+/**
+ * @brief Zmienia budżet i od razu usuwa nieużywane zasoby ponad nim.
+ */
+void resources_set_budget(ResourceManager *rm, size_t budget_bytes);
+
+/**
+ * @brief Wypisuje liczby wpisów, wczytań, trafień i usunięć.
+ */
+void resources_print_stats(const ResourceManager *rm);
+
+/**
+ * @brief Zwalnia wszystkie zasoby (także używane) i pamięć menedżera.
+ */
+void resources_destroy(ResourceManager *rm);
@@ -0,0 +1,212 @@
+#include "SceneFile.h"
+
+#include <ctype.h>
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SCENE_LINE_MAX 4096
+#define SCENE_NAME_MAX 64
+
+typedef struct SceneModelDecl
+{
+    char name[SCENE_NAME_MAX];
+    char path[RESOURCE_PATH_MAX];
+    char mtl[RESOURCE_PATH_MAX];  // "" -> bez materiału
+    char vert[RESOURCE_PATH_MAX]; // "" -> program viewera
+    char frag[RESOURCE_PATH_MAX];
+} SceneModelDecl;
+
+static const SceneModelDecl *find_model(const SceneModelDecl *models, size_t count, const char *name)
+{
+    for (size_t i = 0; i < count; i++)
+        if (strcmp(models[i].name, name) == 0)
+            return &models[i];
+    return NULL;
+}
+
+/**
+ * @brief Rozszerza AABB o narożniki pudełka modelu po transformacji węzła.
+ */
+static void grow_world_bounds(const float *world, const float bmin[3], const float bmax[3],
+                              float out_min[3], float out_max[3])
+{
+    for (int c = 0; c < 8; c++)
+    {
+        float p[3] = {(c & 1) ? bmax[0] : bmin[0], (c & 2) ? bmax[1] : bmin[1], (c & 4) ? bmax[2] : bmin[2]};
+        for (int k = 0; k < 3; k++)
+        {
+            float w = world[k] * p[0] + world[4 + k] * p[1] + world[8 + k] * p[2] + world[12 + k];
+            out_min[k] = w < out_min[k] ? w : out_min[k];
+            out_max[k] = w > out_max[k] ? w : out_max[k];
+        }
+    }
+}
+
+/**
+ * @brief Instancja: węzeł + zasoby (każdy acquire to osobna referencja).
+ */
+static int add_instance(SceneFile *s, size_t *cap, const SceneModelDecl *m, ResourceManager *rm,
+                        SceneGraph *graph, const float pos[3], float yaw, float scale)
+{
+    SceneInstance inst;
+    memset(&inst, 0, sizeof(inst));
+
+    inst.mesh = resources_acquire_mesh(rm, m->path, m->mtl[0] ? m->mtl : NULL);
+    if (!inst.mesh.index)
+        return 0;
+    if (m->mtl[0])
+        inst.material = resources_acquire_material(rm, m->mtl);
+    if (m->vert[0])
+        inst.program = resources_acquire_program(rm, m->vert, m->frag);
+
+    // najpierw miejsce w tablicy: gdy realloc zawiedzie, w grafie nie zostaje osierocony węzeł
+    if (s->count == *cap)
+    {
+        size_t ncap = *cap ? *cap * 2 : 16;
+        SceneInstance *n = (SceneInstance *)realloc(s->instances, ncap * sizeof(SceneInstance));
+        if (n)
+        {
+            s->instances = n;
+            *cap = ncap;
+        }
+    }
+    if (s->count < *cap)
+        inst.node = scene_graph_add_node(graph, -1);
+    if (s->count == *cap || inst.node < 0)
+    {
+        resources_release(rm, inst.mesh);
+        resources_release(rm, inst.material);
+        resources_release(rm, inst.program);
+        return 0;
+    }
+
+    versor q;
+    vec3 t = {pos[0], pos[1], pos[2]};
+    vec3 sc = {scale, scale, scale};
+    glm_quatv(q, glm_rad(yaw), (vec3){0.0f, 1.0f, 0.0f});
+    scene_graph_set_translation(graph, inst.node, t);
+    scene_graph_set_rotation(graph, inst.node, q);
+    scene_graph_set_scale(graph, inst.node, sc);
+
+    s->instances[s->count++] = inst;
+    return 1;
+}
+
+int scene_file_load(const char *path, ResourceManager *rm, SceneGraph *graph, SceneFile *out)
+{
+    memset(out, 0, sizeof(*out));
+
+    FILE *f = fopen(path, "r");
+    if (!f)
+    {
+        printf("ERROR: cannot open scene: %s\n", path);
+        return 0;
+    }
+
+    SceneModelDecl *models = NULL;
+    size_t modelCount = 0, modelCap = 0, instCap = 0;
+    char line[SCENE_LINE_MAX];
+    int lineNo = 0;
+
+    while (fgets(line, sizeof(line), f))
+    {
+        lineNo++;
+        char *s = line;
+        while (isspace((unsigned char)*s))
+            s++;
+        if (*s == '\0' || *s == '#')
+            continue;
+
+        char cmd[16], name[SCENE_NAME_MAX];
+        if (sscanf(s, "%15s %63s", cmd, name) != 2)
+        {
+            printf("WARNING: %s:%d: expected 'model' or 'instance'\n", path, lineNo);
+            continue;
+        }
+
+        if (strcmp(cmd, "model") == 0)
+        {
+            SceneModelDecl m;
+            memset(&m, 0, sizeof(m));
+            strcpy(m.name, name);
+            int n = sscanf(s, "%*s %*s %1023s %1023s %1023s %1023s", m.path, m.mtl, m.vert, m.frag);
+            if (n < 2 || n == 3)
+            {
+                printf("WARNING: %s:%d: model NAME file.obj file.mtl|- [vert frag]\n", path, lineNo);
+                continue;
+            }
+            if (strcmp(m.mtl, "-") == 0)
+                m.mtl[0] = '\0';
+            if (find_model(models, modelCount, name))
+            {
+                printf("WARNING: %s:%d: model '%s' declared twice\n", path, lineNo, name);
+                continue;
+            }
+
+            if (modelCount == modelCap)
+            {
+                size_t ncap = modelCap ? modelCap * 2 : 16;
+                SceneModelDecl *nm = (SceneModelDecl *)realloc(models, ncap * sizeof(SceneModelDecl));
+                if (!nm)
+                    break;
+                models = nm;
+                modelCap = ncap;
+            }
+            models[modelCount++] = m;
+        }
+        else if (strcmp(cmd, "instance") == 0)
+        {
+            float pos[3] = {0.0f, 0.0f, 0.0f}, yaw = 0.0f, scale = 1.0f;
+            int n = sscanf(s, "%*s %*s %f %f %f %f %f", &pos[0], &pos[1], &pos[2], &yaw, &scale);
+            const SceneModelDecl *m = find_model(models, modelCount, name);
+            if (n < 3 || !m)
+            {
+                printf("WARNING: %s:%d: %s\n", path, lineNo,
+                       m ? "instance NAME x y z [yaw [scale]]" : "unknown model");
+                continue;
+            }
+            add_instance(out, &instCap, m, rm, graph, pos, yaw, scale);
+        }
+        else
+        {
+            printf("WARNING: %s:%d: unknown command '%s'\n", path, lineNo, cmd);
+        }
+    }
+    fclose(f);
+    free(models);
+
+    if (out->count == 0)
+    {
+        printf("ERROR: scene %s has no loadable instances\n", path);
+        scene_file_unload(out, rm);
+        return 0;
+    }
+
+    scene_graph_update(graph);
+    for (int k = 0; k < 3; k++)
+    {
+        out->bmin[k] = FLT_MAX;
+        out->bmax[k] = -FLT_MAX;
+    }
+    for (size_t i = 0; i < out->count; i++)
+    {
+        const ResourceMesh *m = resources_mesh(rm, out->instances[i].mesh);
+        grow_world_bounds(scene_graph_world(graph, out->instances[i].node), m->bmin, m->bmax,
+                          out->bmin, out->bmax);
+    }
+    return 1;
+}
+
+void scene_file_unload(SceneFile *scene, ResourceManager *rm)
+{
+    for (size_t i = 0; i < scene->count; i++)
+    {
+        resources_release(rm, scene->instances[i].mesh);
+        resources_release(rm, scene->instances[i].material);
+        resources_release(rm, scene->instances[i].program);
+    }
+    free(scene->instances);
+    memset(scene, 0, sizeof(*scene));
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <stddef.h>
+
+#include "Resources.h"
+#include "SceneGraph.h"
+
+/**
+ * @brief Instancja modelu: węzeł grafu i uchwyty zasobów.
+ */
+typedef struct SceneInstance
+{
+    int node;
+    ResourceHandle mesh;
+    ResourceHandle material; // pusty -> materiał domyślny
+    ResourceHandle program;  // pusty -> program viewera
+} SceneInstance;
+
+/**
+ * @brief Scena wczytana z pliku tekstowego.
+ *
+ * Format (linie, '#' = komentarz):
+ *
+ *   model NAZWA model.obj|model.omc model.mtl|- [shader.vert shader.frag]
+ *   instance NAZWA x y z [yaw_deg [skala]]
+ *
+ * model tylko deklaruje nazwę; zasoby są pobierane z menedżera przy
+ * każdej instancji, więc model użyty N razy jest wczytany raz i ma
+ * N referencji (tak samo wspólne MTL, tekstury i programy).
+ */
+typedef struct SceneFile
+{
+    SceneInstance *instances;
+    size_t count;
+    float bmin[3]; // AABB wszystkich instancji w świecie
+    float bmax[3];
+} SceneFile;
+
+/**
+ * @brief Wczytuje scenę: węzły w grafie, zasoby przez menedżer.
+ *
+ * Instancje z błędami (nieznany model, brak pliku) są pomijane
+ * z komunikatem.
+ *
+ * @param path  Plik sceny.
+ * @param rm    Menedżer zasobów.
+ * @param graph Graf sceny (węzły dodawane jako korzenie).
+ * @param out   Wynik.
+ * @return 1 jeśli wczytano co najmniej jedną instancję, 0 jeśli błąd.
+ */
+int scene_file_load(const char *path, ResourceManager *rm, SceneGraph *graph, SceneFile *out);
+
+/**
+ * @brief Oddaje referencje zasobów instancji.
+ */
+void scene_file_unload(SceneFile *scene, ResourceManager *rm);
@@ -0,0 +1,376 @@
+#include "SceneGraph.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCENE_SIMD 1
+#include <emmintrin.h>
+#endif
+
+/* =========================================================
+   Alokacja (tablice SoA rosną razem)
+   ========================================================= */
+
+/**
+ * @brief realloc z kontrolą błędu (przy błędzie stary blok zostaje).
+ */
+static int grow_array(void **p, size_t elem, size_t count)
+{
+    void *n = realloc(*p, elem * count);
+    if (!n)
+        return 0;
+    *p = n;
+    return 1;
+}
+
+/**
+ * @brief Ustawia transformację jednostkową w slotach [from, to).
+ */
+static void reset_slots(SceneGraph *g, size_t from, size_t to)
+{
+    for (size_t i = from; i < to; i++)
+    {
+        g->parent[i] = -1;
+        g->tx[i] = g->ty[i] = g->tz[i] = 0.0f;
+        g->qx[i] = g->qy[i] = g->qz[i] = 0.0f;
+        g->qw[i] = 1.0f;
+        g->sx[i] = g->sy[i] = g->sz[i] = 1.0f;
+        g->dirty[i] = 0;
+        g->world_dirty[i] = 0;
+    }
+}
+
+/**
+ * @brief Powiększa wszystkie tablice do newCap (wielokrotność 4).
+ */
+static int scene_graph_grow(SceneGraph *g, size_t newCap)
+{
+    newCap = (newCap + 3) & ~(size_t)3;
+
+    int ok = 1;
+    ok &= grow_array((void **)&g->parent, sizeof(int), newCap);
+    ok &= grow_array((void **)&g->tx, sizeof(float), newCap);
+    ok &= grow_array((void **)&g->ty, sizeof(float), newCap);
+    ok &= grow_array((void **)&g->tz, sizeof(float), newCap);
+    ok &= grow_array((void **)&g->qx, sizeof(float), newCap);
+    ok &= grow_array((void **)&g->qy, sizeof(float), newCap);
+    ok &= grow_array((void **)&g->qz, sizeof(float), newCap);
+    ok &= grow_array((void **)&g->qw, sizeof(float), newCap);
+    ok &= grow_array((void **)&g->sx, sizeof(float), newCap);
+    ok &= grow_array((void **)&g->sy, sizeof(float), newCap);
+    ok &= grow_array((void **)&g->sz, sizeof(float), newCap);
+    ok &= grow_array((void **)&g->dirty, 1, newCap);
+    ok &= grow_array((void **)&g->world_dirty, 1, newCap);
+    ok &= grow_array((void **)&g->local, sizeof(float) * 16, newCap);
+    ok &= grow_array((void **)&g->world, sizeof(float) * 16, newCap);
+    ok &= grow_array((void **)&g->normal, sizeof(float) * 9, newCap);
+    if (!ok)
+    {
+        printf("ERROR: scene graph allocation failed (%zu nodes)\n", newCap);
+        return 0;
+    }
+
+    reset_slots(g, g->capacity, newCap);
+    g->capacity = newCap;
+    return 1;
+}
+
+int scene_graph_init(SceneGraph *g, size_t capacity)
+{
+    memset(g, 0, sizeof(*g));
+    return scene_graph_grow(g, capacity ? capacity : 4);
+}
+
+void scene_graph_free(SceneGraph *g)
+{
+    if (!g)
+        return;
+    free(g->parent);
+    free(g->tx); free(g->ty); free(g->tz);
+    free(g->qx); free(g->qy); free(g->qz); free(g->qw);
+    free(g->sx); free(g->sy); free(g->sz);
+    free(g->dirty);
+    free(g->world_dirty);
+    free(g->local);
+    free(g->world);
+    free(g->normal);
+    memset(g, 0, sizeof(*g));
+}
+
+int scene_graph_add_node(SceneGraph *g, int parent)
+{
+    if (parent >= (int)g->count)
+    {
+        printf("ERROR: scene node parent %d does not exist\n", parent);
+        return -1;
+    }
+    if (g->count + 1 > g->capacity && !scene_graph_grow(g, g->capacity * 2))
+        return -1;
+
+    int idx = (int)g->count++;
+    reset_slots(g, (size_t)idx, (size_t)idx + 1);
+    g->parent[idx] = parent;
+    g->dirty[idx] = 1;
+    return idx;
+}
+
+void scene_graph_set_translation(SceneGraph *g, int node, const vec3 t)
+{
+    g->tx[node] = t[0];
+    g->ty[node] = t[1];
+    g->tz[node] = t[2];
+    g->dirty[node] = 1;
+}
+
+void scene_graph_set_rotation(SceneGraph *g, int node, const versor q)
+{
+    g->qx[node] = q[0];
+    g->qy[node] = q[1];
+    g->qz[node] = q[2];
+    g->qw[node] = q[3];
+    g->dirty[node] = 1;
+}
+
+void scene_graph_set_scale(SceneGraph *g, int node, const vec3 s)
+{
+    g->sx[node] = s[0];
+    g->sy[node] = s[1];
+    g->sz[node] = s[2];
+    g->dirty[node] = 1;
+}
+
+/* =========================================================
+   Macierze lokalne: TRS -> mat4, 4 węzły naraz
+   ========================================================= */
+
+#ifdef SCENE_SIMD
+
+/**
+ * @brief Liczy macierze lokalne węzłów [i, i+4) z tablic SoA.
+ *
+ * Każdy rejestr trzyma tę samą składową dla 4 węzłów; na końcu
+ * transpozycja 4x4 rozkłada wyniki do macierzy poszczególnych węzłów.
+ */
+static void local_matrices_x4(SceneGraph *g, size_t i)
+{
+    __m128 x = _mm_loadu_ps(g->qx + i), y = _mm_loadu_ps(g->qy + i);
+    __m128 z = _mm_loadu_ps(g->qz + i), w = _mm_loadu_ps(g->qw + i);
+    __m128 one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f);
+
+    __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+    __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+    __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+    __m128 sx = _mm_loadu_ps(g->sx + i);
+    __m128 sy = _mm_loadu_ps(g->sy + i);
+    __m128 sz = _mm_loadu_ps(g->sz + i);
+
+    // kolumna 0
+    __m128 c0x = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+    __m128 c0y = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+    __m128 c0z = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+    // kolumna 1
+    __m128 c1x = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+    __m128 c1y = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+    __m128 c1z = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+    // kolumna 2
+    __m128 c2x = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+    __m128 c2y = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+    __m128 c2z = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+    // kolumna 3
+    __m128 c3x = _mm_loadu_ps(g->tx + i);
+    __m128 c3y = _mm_loadu_ps(g->ty + i);
+    __m128 c3z = _mm_loadu_ps(g->tz + i);
+    __m128 zero = _mm_setzero_ps();
+
+    _MM_TRANSPOSE4_PS(c0x, c0y, c0z, zero);
+    _mm_storeu_ps(g->local[i + 0] + 0, c0x);
+    _mm_storeu_ps(g->local[i + 1] + 0, c0y);
+    _mm_storeu_ps(g->local[i + 2] + 0, c0z);
+    _mm_storeu_ps(g->local[i + 3] + 0, zero);
+
+    zero = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(c1x, c1y, c1z, zero);
+    _mm_storeu_ps(g->local[i + 0] + 4, c1x);
+    _mm_storeu_ps(g->local[i + 1] + 4, c1y);
+    _mm_storeu_ps(g->local[i + 2] + 4, c1z);
+    _mm_storeu_ps(g->local[i + 3] + 4, zero);
+
+    zero = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(c2x, c2y, c2z, zero);
+    _mm_storeu_ps(g->local[i + 0] + 8, c2x);
+    _mm_storeu_ps(g->local[i + 1] + 8, c2y);
+    _mm_storeu_ps(g->local[i + 2] + 8, c2z);
+    _mm_storeu_ps(g->local[i + 3] + 8, zero);
+
+    __m128 ones = one;
+    _MM_TRANSPOSE4_PS(c3x, c3y, c3z, ones);
+    _mm_storeu_ps(g->local[i + 0] + 12, c3x);
+    _mm_storeu_ps(g->local[i + 1] + 12, c3y);
+    _mm_storeu_ps(g->local[i + 2] + 12, c3z);
+    _mm_storeu_ps(g->local[i + 3] + 12, ones);
+}
+
+/**
+ * @brief out = a * b (column-major), po jednej kolumnie na rejestr.
+ */
+static void mat4_mul(const float *a, const float *b, float *out)
+{
+    __m128 a0 = _mm_loadu_ps(a + 0), a1 = _mm_loadu_ps(a + 4);
+    __m128 a2 = _mm_loadu_ps(a + 8), a3 = _mm_loadu_ps(a + 12);
+    float tmp[16];
+
+    for (int c = 0; c < 4; c++)
+    {
+        const float *bc = b + c * 4;
+        __m128 r = _mm_mul_ps(a0, _mm_set1_ps(bc[0]));
+        r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(bc[1])));
+        r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(bc[2])));
+        r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(bc[3])));
+        _mm_storeu_ps(tmp + c * 4, r);
+    }
+    memcpy(out, tmp, sizeof(tmp));
+}
+
+/**
+ * @brief Iloczyn wektorowy na rejestrach (składowa w ignorowana).
+ */
+static __m128 cross_ps(__m128 a, __m128 b)
+{
+    __m128 a_yzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 b_yzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 c = _mm_sub_ps(_mm_mul_ps(a, b_yzx), _mm_mul_ps(a_yzx, b));
+    return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+/**
+ * @brief Macierz normalnych = transpose(inverse(M3x3)).
+ *
+ * Kolumny wyniku to iloczyny wektorowe kolumn M podzielone przez
+ * wyznacznik — bez pełnego odwracania macierzy.
+ */
+static void normal_matrix(const float *m, float *out)
+{
+    __m128 c0 = _mm_loadu_ps(m + 0);
+    __m128 c1 = _mm_loadu_ps(m + 4);
+    __m128 c2 = _mm_loadu_ps(m + 8);
+
+    __m128 r0 = cross_ps(c1, c2);
+    __m128 r1 = cross_ps(c2, c0);
+    __m128 r2 = cross_ps(c0, c1);
+
+    float d[4];
+    _mm_storeu_ps(d, _mm_mul_ps(c0, r0));
+    float det = d[0] + d[1] + d[2];
+    __m128 inv = _mm_set1_ps(det != 0.0f ? 1.0f / det : 0.0f);
+
+    float tmp[12];
+    _mm_storeu_ps(tmp + 0, _mm_mul_ps(r0, inv));
+    _mm_storeu_ps(tmp + 4, _mm_mul_ps(r1, inv));
+    _mm_storeu_ps(tmp + 8, _mm_mul_ps(r2, inv));
+
+    memcpy(out + 0, tmp + 0, 3 * sizeof(float));
+    memcpy(out + 3, tmp + 4, 3 * sizeof(float));
+    memcpy(out + 6, tmp + 8, 3 * sizeof(float));
+}
+
+#else /* !SCENE_SIMD */
+
+static void local_matrices_x4(SceneGraph *g, size_t i)
+{
+    for (size_t k = i; k < i + 4; k++)
+    {
+        versor q = {g->qx[k], g->qy[k], g->qz[k], g->qw[k]};
+        mat4 m;
+        glm_quat_mat4(q, m);
+        glm_scale(m, (vec3){g->sx[k], g->sy[k], g->sz[k]});
+        m[3][0] = g->tx[k];
+        m[3][1] = g->ty[k];
+        m[3][2] = g->tz[k];
+        memcpy(g->local[k], m, sizeof(float) * 16);
+    }
+}
+
+static void mat4_mul(const float *a, const float *b, float *out)
+{
+    mat4 ma, mb, r;
+    memcpy(ma, a, sizeof(ma));
+    memcpy(mb, b, sizeof(mb));
+    glm_mat4_mul(ma, mb, r);
+    memcpy(out, r, sizeof(r));
+}
+
+static void normal_matrix(const float *m, float *out)
+{
+    vec3 c0 = {m[0], m[1], m[2]};
+    vec3 c1 = {m[4], m[5], m[6]};
+    vec3 c2 = {m[8], m[9], m[10]};
+    vec3 r0, r1, r2;
+    glm_vec3_cross(c1, c2, r0);
+    glm_vec3_cross(c2, c0, r1);
+    glm_vec3_cross(c0, c1, r2);
+
+    float det = glm_vec3_dot(c0, r0);
+    float inv = det != 0.0f ? 1.0f / det : 0.0f;
+    for (int k = 0; k < 3; k++)
+    {
+        out[0 + k] = r0[k] * inv;
+        out[3 + k] = r1[k] * inv;
+        out[6 + k] = r2[k] * inv;
+    }
+}
+
+#endif /* SCENE_SIMD */
+
+/* =========================================================
+   Aktualizacja
+   ========================================================= */
+
+size_t scene_graph_update(SceneGraph *g)
+{
+    size_t updated = 0;
+
+    // 1) macierze lokalne — grupy po 4, jeśli którykolwiek węzeł zmieniony
+    for (size_t i = 0; i < g->count; i += 4)
+    {
+        if (g->dirty[i] | g->dirty[i + 1] | g->dirty[i + 2] | g->dirty[i + 3])
+            local_matrices_x4(g, i);
+    }
+
+    // 2) macierze świata — rodzic zawsze przed dzieckiem
+    for (size_t i = 0; i < g->count; i++)
+    {
+        int p = g->parent[i];
+        int wd = g->dirty[i] || (p >= 0 && g->world_dirty[p]);
+        g->world_dirty[i] = (unsigned char)wd;
+        g->dirty[i] = 0;
+        if (!wd)
+            continue;
+
+        if (p >= 0)
+            mat4_mul(g->world[p], g->local[i], g->world[i]);
+        else
+            memcpy(g->world[i], g->local[i], sizeof(float) * 16);
+        updated++;
+    }
+
+    // 3) macierze normalnych tylko dla zmienionych
+    for (size_t i = 0; i < g->count; i++)
+    {
+        if (g->world_dirty[i])
+            normal_matrix(g->world[i], g->normal[i]);
+    }
+
+    return updated;
+}
+
+const float *scene_graph_world(const SceneGraph *g, int node)
+{
+    return g->world[node];
+}
+
+const float *scene_graph_normal(const SceneGraph *g, int node)
+{
+    return g->normal[node];
+}
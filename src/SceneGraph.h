@@ -0,0 +1,95 @@
+#pragma once
+#include <stddef.h>
+#include <cglm/cglm.h>
+
+/**
+ * @brief Graf sceny z hierarchicznymi transformacjami (układ SoA).
+ *
+ * Lokalne transformacje (translacja, kwaternion obrotu, skala) trzymane są
+ * w osobnych tablicach na każdą składową, dzięki czemu macierze lokalne
+ * liczone są po 4 węzły naraz (SSE).
+ *
+ * Węzły są w kolejności topologicznej: rodzic ma zawsze mniejszy indeks
+ * niż dziecko, więc macierze świata liczy jeden liniowy przebieg.
+ *
+ * Dla każdego węzła przechowywane są gotowe do wysłania na GPU:
+ *  - world  — macierz modelu (mat4, column-major),
+ *  - normal — macierz normalnych (mat3 = transpose(inverse(world3x3))).
+ */
+typedef struct SceneGraph
+{
+    size_t count;
+    size_t capacity; // zawsze wielokrotność 4
+
+    int *parent; // -1 = korzeń
+
+    /* transformacja lokalna (SoA) */
+    float *tx, *ty, *tz;
+    float *qx, *qy, *qz, *qw;
+    float *sx, *sy, *sz;
+
+    unsigned char *dirty;       // zmieniona transformacja lokalna
+    unsigned char *world_dirty; // przeliczona w ostatnim scene_update
+
+    /* wyniki (AoS, gotowe do glUniformMatrix*) */
+    float (*local)[16];
+    float (*world)[16];
+    float (*normal)[9];
+} SceneGraph;
+
+/**
+ * @brief Inicjalizuje pusty graf.
+ *
+ * @param g        Graf.
+ * @param capacity Początkowa pojemność (węzły).
+ * @return 1 jeśli OK, 0 jeśli błąd alokacji.
+ */
+int scene_graph_init(SceneGraph *g, size_t capacity);
+
+/**
+ * @brief Zwalnia pamięć grafu.
+ */
+void scene_graph_free(SceneGraph *g);
+
+/**
+ * @brief Dodaje węzeł z transformacją jednostkową.
+ *
+ * @param g      Graf.
+ * @param parent Indeks rodzica (musi już istnieć) albo -1.
+ * @return Indeks nowego węzła lub -1 jeśli błąd.
+ */
+int scene_graph_add_node(SceneGraph *g, int parent);
+
+/**
+ * @brief Ustawia lokalną translację węzła.
+ */
+void scene_graph_set_translation(SceneGraph *g, int node, const vec3 t);
+
+/**
+ * @brief Ustawia lokalny obrót węzła (kwaternion x,y,z,w).
+ */
+void scene_graph_set_rotation(SceneGraph *g, int node, const versor q);
+
+/**
+ * @brief Ustawia lokalną skalę węzła.
+ */
+void scene_graph_set_scale(SceneGraph *g, int node, const vec3 s);
+
+/**
+ * @brief Przelicza macierze lokalne, świata i normalnych zmienionych
+ *        węzłów (i ich potomków).
+ *
+ * @param g Graf.
+ * @return Liczba węzłów, których macierz świata się zmieniła.
+ */
+size_t scene_graph_update(SceneGraph *g);
+
+/**
+ * @brief Zwraca macierz świata węzła (16 floatów, column-major).
+ */
+const float *scene_graph_world(const SceneGraph *g, int node);
+
+/**
+ * @brief Zwraca macierz normalnych węzła (9 floatów, column-major).
+ */
+const float *scene_graph_normal(const SceneGraph *g, int node);
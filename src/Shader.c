@@ -1,6 +1,7 @@
 #include "shader.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 /**
  * @brief Wczytuje cały plik tekstowy do bufora w pamięci.
@@ -10,7 +11,7 @@
  *
  * @note Caller musi zrobić free() na zwróconym wskaźniku.
  */
-static char *read_file_text(const char *path)
+char *shader_read_file(const char *path)
 {
     FILE *f = fopen(path, "rb");
     if (!f)
@@ -63,29 +64,15 @@ static GLuint compile_shader(GLenum type, const char *src, const char *label)
 }
 
 /**
- * @brief Wczytuje shadery z plików, kompiluje i linkuje program.
- *
- * @param vertex_path   Ścieżka do .vert.
- * @param fragment_path Ścieżka do .frag.
- * @return ShaderProgram (.id==0 oznacza błąd).
+ * @brief Kompiluje i linkuje program z kodu źródłowego.
  */
-ShaderProgram shader_load_from_files(const char *vertex_path, const char *fragment_path)
+ShaderProgram shader_load_from_source(const char *vertex_src, const char *fragment_src,
+                                      const char *vertex_label, const char *fragment_label)
 {
     ShaderProgram out = {0};
 
-    char *vsrc = read_file_text(vertex_path);
-    char *fsrc = read_file_text(fragment_path);
-    if (!vsrc || !fsrc)
-    {
-        free(vsrc);
-        free(fsrc);
-        return out;
-    }
-
-    GLuint vs = compile_shader(GL_VERTEX_SHADER, vsrc, vertex_path);
-    GLuint fs = compile_shader(GL_FRAGMENT_SHADER, fsrc, fragment_path);
-    free(vsrc);
-    free(fsrc);
+    GLuint vs = compile_shader(GL_VERTEX_SHADER, vertex_src, vertex_label);
+    GLuint fs = compile_shader(GL_FRAGMENT_SHADER, fragment_src, fragment_label);
 
     if (!vs || !fs)
     {
@@ -119,6 +106,196 @@ ShaderProgram shader_load_from_files(const char *vertex_path, const char *fragme
     return out;
 }
 
+/**
+ * @brief Wczytuje shadery z plików, kompiluje i linkuje program.
+ *
+ * @param vertex_path   Ścieżka do .vert.
+ * @param fragment_path Ścieżka do .frag.
+ * @return ShaderProgram (.id==0 oznacza błąd).
+ */
+ShaderProgram shader_load_from_files(const char *vertex_path, const char *fragment_path)
+{
+    ShaderProgram out = {0};
+
+    char *vsrc = shader_read_file(vertex_path);
+    char *fsrc = shader_read_file(fragment_path);
+    if (vsrc && fsrc)
+        out = shader_load_from_source(vsrc, fsrc, vertex_path, fragment_path);
+
+    free(vsrc);
+    free(fsrc);
+    return out;
+}
+
+/* ===================== Warianty ===================== */
+
+static const char *g_feature_names[SHADER_FEATURE_COUNT] = {
+    "HAS_TEXTURE",
+    "PACKED_MATERIALS",
+};
+
+const char *shader_feature_name(unsigned feature)
+{
+    for (int i = 0; i < SHADER_FEATURE_COUNT; i++)
+        if (feature == (1u << i))
+            return g_feature_names[i];
+    return "?";
+}
+
+/**
+ * @brief Kopia napisu (malloc) lub NULL.
+ */
+static char *copy_string(const char *s)
+{
+    if (!s)
+        return NULL;
+    size_t len = strlen(s) + 1;
+    char *out = (char *)malloc(len);
+    if (out)
+        memcpy(out, s, len);
+    return out;
+}
+
+char *shader_inject_defines(const char *src, unsigned features)
+{
+    char defines[256];
+    size_t defines_len = 0;
+    defines[0] = '\0';
+    for (int i = 0; i < SHADER_FEATURE_COUNT; i++)
+    {
+        if (features & (1u << i))
+            defines_len += (size_t)snprintf(defines + defines_len, sizeof(defines) - defines_len, "#define %s\n",
+                                            g_feature_names[i]);
+    }
+
+    // #version musi być pierwszą dyrektywą: definicje idą za jej linią
+    size_t src_len = strlen(src);
+    size_t head = 0;
+    const char *version = strstr(src, "#version");
+    if (version)
+    {
+        const char *eol = strchr(version, '\n');
+        head = eol ? (size_t)(eol + 1 - src) : src_len;
+    }
+
+    char *out = (char *)malloc(src_len + defines_len + 2);
+    if (!out)
+        return NULL;
+    size_t pos = head;
+    memcpy(out, src, head);
+    if (head > 0 && src[head - 1] != '\n')
+        out[pos++] = '\n';
+    memcpy(out + pos, defines, defines_len);
+    memcpy(out + pos + defines_len, src + head, src_len - head + 1);
+    return out;
+}
+
+/**
+ * @brief Kompiluje i linkuje wariant ze źródeł bez definicji.
+ */
+static ShaderProgram load_variant_source(const char *vertex_src, const char *fragment_src, const char *vertex_label,
+                                         const char *fragment_label, unsigned features)
+{
+    ShaderProgram out = {0};
+
+    char *vsrc = shader_inject_defines(vertex_src, features);
+    char *fsrc = shader_inject_defines(fragment_src, features);
+    if (vsrc && fsrc)
+        out = shader_load_from_source(vsrc, fsrc, vertex_label, fragment_label);
+
+    free(vsrc);
+    free(fsrc);
+    return out;
+}
+
+ShaderProgram shader_load_variant(const char *vertex_path, const char *fragment_path, unsigned features)
+{
+    ShaderProgram out = {0};
+
+    char *vsrc = shader_read_file(vertex_path);
+    char *fsrc = shader_read_file(fragment_path);
+    if (vsrc && fsrc)
+        out = load_variant_source(vsrc, fsrc, vertex_path, fragment_path, features);
+
+    free(vsrc);
+    free(fsrc);
+    return out;
+}
+
+void shader_variants_init(ShaderVariants *v, char *vertex_src, char *fragment_src, const char *vertex_label,
+                          const char *fragment_label)
+{
+    memset(v, 0, sizeof(*v));
+    v->vertex_src = vertex_src;
+    v->fragment_src = fragment_src;
+    v->vertex_label = copy_string(vertex_label);
+    v->fragment_label = copy_string(fragment_label);
+}
+
+int shader_variants_load(ShaderVariants *v, const char *vertex_path, const char *fragment_path)
+{
+    char *vsrc = shader_read_file(vertex_path);
+    char *fsrc = shader_read_file(fragment_path);
+    if (!vsrc || !fsrc)
+    {
+        free(vsrc);
+        free(fsrc);
+        memset(v, 0, sizeof(*v));
+        return 0;
+    }
+    shader_variants_init(v, vsrc, fsrc, vertex_path, fragment_path);
+    return 1;
+}
+
+void shader_variants_set_setup(ShaderVariants *v, ShaderSetupFn setup, void *user)
+{
+    v->setup = setup;
+    v->setup_user = user;
+    if (!setup)
+        return;
+    for (unsigned i = 0; i < SHADER_VARIANT_COUNT; i++)
+    {
+        if (v->programs[i])
+            setup(v->programs[i], user);
+    }
+}
+
+GLuint shader_variants_get(ShaderVariants *v, unsigned features)
+{
+    if (features >= SHADER_VARIANT_COUNT)
+        return 0;
+    if (v->programs[features] || v->failed[features] || !v->vertex_src || !v->fragment_src)
+        return v->programs[features];
+
+    ShaderProgram p = load_variant_source(v->vertex_src, v->fragment_src, v->vertex_label ? v->vertex_label : "vertex",
+                                          v->fragment_label ? v->fragment_label : "fragment", features);
+    if (!p.id)
+    {
+        printf("ERROR: shader variant 0x%x failed\n", features);
+        v->failed[features] = 1;
+        return 0;
+    }
+    v->programs[features] = p.id;
+    v->compiled++;
+    if (v->setup)
+        v->setup(p.id, v->setup_user);
+    return p.id;
+}
+
+void shader_variants_destroy(ShaderVariants *v)
+{
+    for (unsigned i = 0; i < SHADER_VARIANT_COUNT; i++)
+    {
+        if (v->programs[i])
+            glDeleteProgram(v->programs[i]);
+    }
+    free(v->vertex_src);
+    free(v->fragment_src);
+    free(v->vertex_label);
+    free(v->fragment_label);
+    memset(v, 0, sizeof(*v));
+}
+
 /**
  * @brief Ustawia program shaderów jako aktywny.
  *
@@ -129,6 +306,16 @@ void shader_use(ShaderProgram s)
     glUseProgram(s.id);
 }
 
+/**
+ * @brief Wiąże blok uniformów z punktem wiązania (jeśli blok istnieje).
+ */
+void shader_bind_block(ShaderProgram s, const char *block, GLuint binding)
+{
+    GLuint idx = glGetUniformBlockIndex(s.id, block);
+    if (idx != GL_INVALID_INDEX)
+        glUniformBlockBinding(s.id, idx, binding);
+}
+
 /**
  * @brief Usuwa program shaderów z GPU.
  *
@@ -1,4 +1,5 @@
 #pragma once
+#include <stddef.h>
 #include <glad/glad.h>
 
 /**
@@ -22,6 +23,122 @@ typedef struct ShaderProgram
  */
 ShaderProgram shader_load_from_files(const char *vertex_path, const char *fragment_path);
 
+/**
+ * @brief Wczytuje plik tekstowy (źródło shadera) — bez GL, można wołać z wątku roboczego.
+ *
+ * @param path Ścieżka do pliku.
+ * @return Bufor zakończony '\0' (free() po stronie wołającego) lub NULL jeśli błąd.
+ */
+char *shader_read_file(const char *path);
+
+/**
+ * @brief Kompiluje i linkuje program z gotowego kodu źródłowego.
+ *
+ * @param vertex_src     Kod shadera wierzchołków.
+ * @param fragment_src   Kod shadera fragmentów.
+ * @param vertex_label   Etykieta do logów (np. ścieżka pliku).
+ * @param fragment_label Etykieta do logów.
+ * @return ShaderProgram (.id==0 oznacza błąd).
+ */
+ShaderProgram shader_load_from_source(const char *vertex_src, const char *fragment_src,
+                                      const char *vertex_label, const char *fragment_label);
+
+/**
+ * @brief Cechy wariantu shadera; każda to #define wstawiany za linią #version.
+ *
+ * Shader materiału sprawdza je przez #ifdef zamiast gałęzi po uniformie,
+ * więc wariant bez tekstury nie próbkuje, a zwykły nie ma kodu tablic
+ * tekstur. Kolejna cecha = kolejny bit i nazwa w shader_feature_name().
+ */
+typedef enum ShaderFeature
+{
+    SHADER_FEATURE_TEXTURE = 1u << 0, // HAS_TEXTURE: mapa dyfuzyjna materiału
+    SHADER_FEATURE_PACKED = 1u << 1   // PACKED_MATERIALS: tablice tekstur ModelMaterials
+} ShaderFeature;
+
+#define SHADER_FEATURE_COUNT 2
+#define SHADER_VARIANT_COUNT (1u << SHADER_FEATURE_COUNT)
+
+/**
+ * @brief Stan programu po linkowaniu (bloki uniformów, samplery).
+ */
+typedef void (*ShaderSetupFn)(GLuint program, void *user);
+
+/**
+ * @brief Warianty jednej pary shaderów, kompilowane przy pierwszym użyciu.
+ *
+ * Źródła zostają w pamięci; program dla maski cech powstaje w
+ * shader_variants_get() i jest trzymany w tablicy indeksowanej maską.
+ * Rysowanie wybiera dokładny wariant, więc kolejka sortuje po nim jak po
+ * każdym innym programie.
+ */
+typedef struct ShaderVariants
+{
+    char *vertex_src;
+    char *fragment_src;
+    char *vertex_label;
+    char *fragment_label;
+    GLuint programs[SHADER_VARIANT_COUNT]; // 0 = jeszcze nie kompilowany
+    int failed[SHADER_VARIANT_COUNT];      // błąd kompilacji: bez ponownych prób co klatkę
+    size_t compiled;
+
+    ShaderSetupFn setup; // wołane dla każdego nowego wariantu (może być NULL)
+    void *setup_user;
+} ShaderVariants;
+
+/**
+ * @brief Nazwa #define cechy (np. "HAS_TEXTURE").
+ */
+const char *shader_feature_name(unsigned feature);
+
+/**
+ * @brief Kopia źródła z #define dla cech wstawionymi za linią #version.
+ *
+ * @return Bufor (free() po stronie wołającego) lub NULL jeśli błąd alokacji.
+ */
+char *shader_inject_defines(const char *src, unsigned features);
+
+/**
+ * @brief Jak shader_load_from_files(), z #define dla podanych cech.
+ */
+ShaderProgram shader_load_variant(const char *vertex_path, const char *fragment_path, unsigned features);
+
+/**
+ * @brief Przejmuje źródła (free() w shader_variants_destroy()); nic nie kompiluje.
+ *
+ * @param v              Warianty.
+ * @param vertex_src     Kod shadera wierzchołków (malloc).
+ * @param fragment_src   Kod shadera fragmentów (malloc).
+ * @param vertex_label   Etykieta do logów (kopiowana).
+ * @param fragment_label Etykieta do logów (kopiowana).
+ */
+void shader_variants_init(ShaderVariants *v, char *vertex_src, char *fragment_src, const char *vertex_label,
+                          const char *fragment_label);
+
+/**
+ * @brief Wczytuje pliki do shader_variants_init().
+ *
+ * @return 1 jeśli OK, 0 jeśli nie da się odczytać pliku.
+ */
+int shader_variants_load(ShaderVariants *v, const char *vertex_path, const char *fragment_path);
+
+/**
+ * @brief Ustawia funkcję stanu i woła ją dla już skompilowanych wariantów.
+ */
+void shader_variants_set_setup(ShaderVariants *v, ShaderSetupFn setup, void *user);
+
+/**
+ * @brief Program wariantu; kompiluje go przy pierwszym zapytaniu.
+ *
+ * @return Program albo 0, jeśli wariant się nie kompiluje.
+ */
+GLuint shader_variants_get(ShaderVariants *v, unsigned features);
+
+/**
+ * @brief Usuwa wszystkie warianty i źródła.
+ */
+void shader_variants_destroy(ShaderVariants *v);
+
 /**
  * @brief Ustawia dany program shaderów jako aktywny (glUseProgram).
  *
@@ -29,6 +146,18 @@ ShaderProgram shader_load_from_files(const char *vertex_path, const char *fragme
  */
 void shader_use(ShaderProgram s);
 
+/**
+ * @brief Przypisuje blok uniformów do punktu wiązania GL_UNIFORM_BUFFER.
+ *
+ * GLSL 330 nie ma layout(binding), więc robimy to po linkowaniu.
+ * Brak bloku w programie nie jest błędem.
+ *
+ * @param s       Program.
+ * @param block   Nazwa bloku (np. "PerFrame").
+ * @param binding Punkt wiązania.
+ */
+void shader_bind_block(ShaderProgram s, const char *block, GLuint binding);
+
 /**
  * @brief Usuwa program shaderów z GPU (glDeleteProgram) i zeruje id.
  *
@@ -0,0 +1,937 @@
+#include "SoftRaster.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SOFT_SIMD 1
+#include <emmintrin.h>
+#endif
+
+#define SOFT_VERTEX_FLOATS 12 // clip x, y, z, w | nx, ny, nz, u, v | wyrównanie
+#define SOFT_ATTRS 5          // nx, ny, nz, u, v
+
+#define SOFT_MAX_CHUNKS 128
+#define SOFT_TRIS_PER_CHUNK 4096
+#define SOFT_VERTS_PER_TASK 8192
+#define SOFT_MAX_TRANSFORM_TASKS 256
+
+// pas ochronny: |x/w|, |y/w| <= SOFT_GUARD — współrzędne 28.4 mieszczą się w int32
+#define SOFT_GUARD 2.0f
+
+#define SOFT_CLIP_MAX 12 // trójkąt po obcięciu 6 płaszczyznami ma najwyżej 9 wierzchołków
+
+/* =========================================================
+   Dane wewnętrzne
+   ========================================================= */
+
+/**
+ * @brief Trójkąt po setupie (przestrzeń ekranu, gotowy do rasteryzacji).
+ */
+typedef struct SoftTri
+{
+    int32_t x[3], y[3];          // 28.4, CCW po ewentualnej zamianie wierzchołków
+    float z[3];                  // głębokość [0, 1]
+    float iw[3];                 // 1/w (interpolacja perspektywiczna)
+    float attr[3][SOFT_ATTRS];   // atrybuty * 1/w
+    float inv_area;              // 1 / (2 * pole) w jednostkach 28.4^2
+    int minx, miny, maxx, maxy;  // piksele (włącznie), obcięte do obrazu
+} SoftTri;
+
+typedef struct SoftTileBin
+{
+    uint32_t *items;
+    uint32_t count, cap;
+} SoftTileBin;
+
+/**
+ * @brief Fragment listy trójkątów: własne trójkąty i kosze kafli.
+ */
+struct SoftChunk
+{
+    size_t begin, end; // zakres trójkątów wejściowych
+    SoftTri *tris;
+    size_t tri_count, tri_cap;
+    SoftTileBin *bins; // tiles_x * tiles_y
+    int failed;
+};
+
+typedef struct ClipVert
+{
+    float c[4];
+    float a[SOFT_ATTRS];
+} ClipVert;
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+}
+
+static int cpu_count(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return (int)si.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+/**
+ * @brief out = a * b (macierze kolumnowe 4x4).
+ */
+static void mat4_mul(const float a[16], const float b[16], float out[16])
+{
+    for (int c = 0; c < 4; c++)
+        for (int row = 0; row < 4; row++)
+            out[c * 4 + row] = a[0 * 4 + row] * b[c * 4 + 0] + a[1 * 4 + row] * b[c * 4 + 1] +
+                               a[2 * 4 + row] * b[c * 4 + 2] + a[3 * 4 + row] * b[c * 4 + 3];
+}
+
+/* =========================================================
+   Pula wątków z podkradaniem pracy
+   ========================================================= */
+
+/**
+ * @brief Następne zadanie: własna kolejka, a gdy pusta — połowa cudzej.
+ */
+static int take_task(SoftRenderer *r, int worker, int *task)
+{
+    SoftWorkQueue *own = &r->queues[worker];
+
+    pthread_mutex_lock(&own->lock);
+    if (own->lo < own->hi)
+    {
+        *task = own->lo++;
+        pthread_mutex_unlock(&own->lock);
+        return 1;
+    }
+    pthread_mutex_unlock(&own->lock);
+
+    for (int k = 1; k < r->threads; k++)
+    {
+        SoftWorkQueue *victim = &r->queues[(worker + k) % r->threads];
+
+        pthread_mutex_lock(&victim->lock);
+        int n = victim->hi - victim->lo;
+        if (n <= 0)
+        {
+            pthread_mutex_unlock(&victim->lock);
+            continue;
+        }
+        // górna połowa (zadania najdalej od tego, co właściciel robi teraz)
+        int take = n - n / 2;
+        int start = victim->hi - take;
+        victim->hi = start;
+        pthread_mutex_unlock(&victim->lock);
+
+        pthread_mutex_lock(&own->lock);
+        own->lo = start + 1;
+        own->hi = start + take;
+        own->steals++;
+        pthread_mutex_unlock(&own->lock);
+
+        *task = start;
+        return 1;
+    }
+    return 0;
+}
+
+static void run_tasks(SoftRenderer *r, int worker)
+{
+    int task;
+    while (take_task(r, worker, &task))
+        r->task_fn(r, task, worker);
+}
+
+static void *worker_main(void *arg)
+{
+    SoftWorkQueue *q = (SoftWorkQueue *)arg;
+    SoftRenderer *r = q->owner;
+    unsigned long seen = 0;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&r->lock);
+        while (r->generation == seen && !r->quit)
+            pthread_cond_wait(&r->wake, &r->lock);
+        if (r->quit)
+        {
+            pthread_mutex_unlock(&r->lock);
+            break;
+        }
+        seen = r->generation;
+        pthread_mutex_unlock(&r->lock);
+
+        run_tasks(r, q->index);
+
+        pthread_mutex_lock(&r->lock);
+        if (--r->pending == 0)
+            pthread_cond_signal(&r->done);
+        pthread_mutex_unlock(&r->lock);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Wykonuje fn dla zadań [0, count); wątek wywołujący pracuje jako wątek 0.
+ *
+ * Zadania dzielone są na ciągłe zakresy po jednym na wątek — przy
+ * nierównym koszcie (np. kafle z dużą liczbą trójkątów) resztę
+ * wyrównuje podkradanie.
+ */
+static void pool_run(SoftRenderer *r, int count, void (*fn)(SoftRenderer *, int, int))
+{
+    if (count <= 0)
+        return;
+
+    r->task_fn = fn;
+    r->task_count = count;
+    for (int w = 0; w < r->threads; w++)
+    {
+        pthread_mutex_lock(&r->queues[w].lock);
+        r->queues[w].lo = (int)((long long)count * w / r->threads);
+        r->queues[w].hi = (int)((long long)count * (w + 1) / r->threads);
+        pthread_mutex_unlock(&r->queues[w].lock);
+    }
+
+    if (r->threads > 1)
+    {
+        pthread_mutex_lock(&r->lock);
+        r->generation++;
+        r->pending = r->threads - 1;
+        pthread_cond_broadcast(&r->wake);
+        pthread_mutex_unlock(&r->lock);
+    }
+
+    run_tasks(r, 0);
+
+    if (r->threads > 1)
+    {
+        pthread_mutex_lock(&r->lock);
+        while (r->pending > 0)
+            pthread_cond_wait(&r->done, &r->lock);
+        pthread_mutex_unlock(&r->lock);
+    }
+}
+
+/* =========================================================
+   Etap 1: transformacja wierzchołków
+   ========================================================= */
+
+static void task_transform(SoftRenderer *r, int task, int worker)
+{
+    (void)worker;
+    size_t n = r->in_vertex_count;
+    size_t begin = n * (size_t)task / (size_t)r->task_count;
+    size_t end = n * (size_t)(task + 1) / (size_t)r->task_count;
+
+#ifdef SOFT_SIMD
+    const __m128 m0 = _mm_loadu_ps(r->mvp + 0);
+    const __m128 m1 = _mm_loadu_ps(r->mvp + 4);
+    const __m128 m2 = _mm_loadu_ps(r->mvp + 8);
+    const __m128 m3 = _mm_loadu_ps(r->mvp + 12);
+    const __m128 n0 = _mm_loadu_ps(r->normal + 0);
+    const __m128 n1 = _mm_loadu_ps(r->normal + 4);
+    const __m128 n2 = _mm_loadu_ps(r->normal + 8);
+
+    for (size_t i = begin; i < end; i++)
+    {
+        const Vertex *v = &r->in_vertices[i];
+        float *o = r->verts + i * SOFT_VERTEX_FLOATS;
+
+        // kolumny macierzy * składowe: cały wektor clip w jednym rejestrze
+        __m128 p = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(m0, _mm_set1_ps(v->position[0])),
+                       _mm_mul_ps(m1, _mm_set1_ps(v->position[1]))),
+            _mm_add_ps(_mm_mul_ps(m2, _mm_set1_ps(v->position[2])), m3));
+        __m128 nn = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(n0, _mm_set1_ps(v->normal[0])),
+                       _mm_mul_ps(n1, _mm_set1_ps(v->normal[1]))),
+            _mm_mul_ps(n2, _mm_set1_ps(v->normal[2])));
+
+        _mm_storeu_ps(o, p);
+        _mm_storeu_ps(o + 4, nn); // o[7] nadpisane przez u
+        o[7] = v->texcoord[0];
+        o[8] = v->texcoord[1];
+    }
+#else
+    const float *m = r->mvp;
+    const float *nm = r->normal;
+    for (size_t i = begin; i < end; i++)
+    {
+        const Vertex *v = &r->in_vertices[i];
+        float *o = r->verts + i * SOFT_VERTEX_FLOATS;
+        float x = v->position[0], y = v->position[1], z = v->position[2];
+        for (int k = 0; k < 4; k++)
+            o[k] = m[k] * x + m[4 + k] * y + m[8 + k] * z + m[12 + k];
+        for (int k = 0; k < 3; k++)
+            o[4 + k] = nm[k] * v->normal[0] + nm[4 + k] * v->normal[1] + nm[8 + k] * v->normal[2];
+        o[7] = v->texcoord[0];
+        o[8] = v->texcoord[1];
+    }
+#endif
+}
+
+/* =========================================================
+   Etap 2: obcinanie, setup, przydział do kafli
+   ========================================================= */
+
+static float plane_distance(const float c[4], int plane)
+{
+    switch (plane)
+    {
+    case 0: return c[2] + c[3];              // near
+    case 1: return c[3] - c[2];              // far
+    case 2: return SOFT_GUARD * c[3] - c[0]; // pas ochronny
+    case 3: return SOFT_GUARD * c[3] + c[0];
+    case 4: return SOFT_GUARD * c[3] - c[1];
+    default: return SOFT_GUARD * c[3] + c[1];
+    }
+}
+
+static unsigned outcode(const float c[4])
+{
+    unsigned code = 0;
+    for (int p = 0; p < 6; p++)
+        if (plane_distance(c, p) < 0.0f)
+            code |= 1u << p;
+    return code;
+}
+
+/**
+ * @brief Sutherland-Hodgman w przestrzeni clip dla płaszczyzn z maski.
+ *
+ * @return Liczba wierzchołków wielokąta (0 jeśli całkowicie poza).
+ */
+static int clip_polygon(ClipVert *poly, int count, unsigned planes)
+{
+    ClipVert tmp[SOFT_CLIP_MAX];
+    ClipVert *in = poly, *out = tmp;
+
+    for (int p = 0; p < 6 && count > 0; p++)
+    {
+        if (!(planes & (1u << p)))
+            continue;
+
+        int n = 0;
+        for (int i = 0; i < count; i++)
+        {
+            const ClipVert *a = &in[i];
+            const ClipVert *b = &in[(i + 1) % count];
+            float da = plane_distance(a->c, p);
+            float db = plane_distance(b->c, p);
+
+            if (da >= 0.0f)
+                out[n++] = *a;
+            if ((da >= 0.0f) != (db >= 0.0f))
+            {
+                float t = da / (da - db);
+                ClipVert *v = &out[n++];
+                for (int k = 0; k < 4; k++)
+                    v->c[k] = a->c[k] + (b->c[k] - a->c[k]) * t;
+                for (int k = 0; k < SOFT_ATTRS; k++)
+                    v->a[k] = a->a[k] + (b->a[k] - a->a[k]) * t;
+            }
+        }
+        count = n;
+        ClipVert *swap = in;
+        in = out;
+        out = swap;
+    }
+
+    if (in != poly)
+        memcpy(poly, in, (size_t)count * sizeof(ClipVert));
+    return count;
+}
+
+static int bin_push(SoftTileBin *bin, uint32_t item)
+{
+    if (bin->count == bin->cap)
+    {
+        uint32_t newCap = bin->cap ? bin->cap * 2 : 64;
+        uint32_t *n = (uint32_t *)realloc(bin->items, newCap * sizeof(uint32_t));
+        if (!n)
+            return 0;
+        bin->items = n;
+        bin->cap = newCap;
+    }
+    bin->items[bin->count++] = item;
+    return 1;
+}
+
+/**
+ * @brief Rzutowanie na ekran, odrzucenie pustych trójkątów i wpis do koszy kafli.
+ */
+static void setup_triangle(SoftRenderer *r, SoftChunk *ch,
+                           const ClipVert *v0, const ClipVert *v1, const ClipVert *v2)
+{
+    const ClipVert *v[3] = {v0, v1, v2};
+    int32_t x[3], y[3];
+    float z[3], iw[3];
+
+    for (int k = 0; k < 3; k++)
+    {
+        iw[k] = 1.0f / v[k]->c[3];
+        float sx = (v[k]->c[0] * iw[k] * 0.5f + 0.5f) * (float)r->width;
+        float sy = (0.5f - v[k]->c[1] * iw[k] * 0.5f) * (float)r->height;
+        x[k] = (int32_t)lrintf(sx * 16.0f);
+        y[k] = (int32_t)lrintf(sy * 16.0f);
+        z[k] = v[k]->c[2] * iw[k] * 0.5f + 0.5f;
+    }
+
+    int64_t area = (int64_t)(x[1] - x[0]) * (y[2] - y[0]) - (int64_t)(y[1] - y[0]) * (x[2] - x[0]);
+    if (area == 0)
+        return;
+
+    // bez odrzucania tylnych ścian (jak viewer) — ujednolicamy tylko kierunek
+    int order[3] = {0, 1, 2};
+    if (area < 0)
+    {
+        order[1] = 2;
+        order[2] = 1;
+        area = -area;
+    }
+
+    int32_t minX = x[0], maxX = x[0], minY = y[0], maxY = y[0];
+    for (int k = 1; k < 3; k++)
+    {
+        if (x[k] < minX) minX = x[k];
+        if (x[k] > maxX) maxX = x[k];
+        if (y[k] < minY) minY = y[k];
+        if (y[k] > maxY) maxY = y[k];
+    }
+
+    // piksele, których środek (px * 16 + 8) leży w prostokącie
+    int minx = (minX - 8 + 15) >> 4;
+    int maxx = (maxX - 8) >> 4;
+    int miny = (minY - 8 + 15) >> 4;
+    int maxy = (maxY - 8) >> 4;
+    if (minx < 0) minx = 0;
+    if (miny < 0) miny = 0;
+    if (maxx > r->width - 1) maxx = r->width - 1;
+    if (maxy > r->height - 1) maxy = r->height - 1;
+    if (minx > maxx || miny > maxy)
+        return;
+
+    if (ch->tri_count == ch->tri_cap)
+    {
+        size_t newCap = ch->tri_cap ? ch->tri_cap * 2 : 1024;
+        SoftTri *n = (SoftTri *)realloc(ch->tris, newCap * sizeof(SoftTri));
+        if (!n)
+        {
+            ch->failed = 1;
+            return;
+        }
+        ch->tris = n;
+        ch->tri_cap = newCap;
+    }
+
+    uint32_t index = (uint32_t)ch->tri_count++;
+    SoftTri *t = &ch->tris[index];
+    for (int k = 0; k < 3; k++)
+    {
+        int s = order[k];
+        t->x[k] = x[s];
+        t->y[k] = y[s];
+        t->z[k] = z[s];
+        t->iw[k] = iw[s];
+        for (int a = 0; a < SOFT_ATTRS; a++)
+            t->attr[k][a] = v[s]->a[a] * iw[s];
+    }
+    t->inv_area = 1.0f / (float)area;
+    t->minx = minx;
+    t->miny = miny;
+    t->maxx = maxx;
+    t->maxy = maxy;
+
+    int tx0 = minx / SOFT_TILE_SIZE, tx1 = maxx / SOFT_TILE_SIZE;
+    int ty0 = miny / SOFT_TILE_SIZE, ty1 = maxy / SOFT_TILE_SIZE;
+    for (int ty = ty0; ty <= ty1; ty++)
+        for (int tx = tx0; tx <= tx1; tx++)
+            if (!bin_push(&ch->bins[ty * r->tiles_x + tx], index))
+                ch->failed = 1;
+}
+
+static void load_clip_vert(const SoftRenderer *r, unsigned int index, ClipVert *out)
+{
+    const float *src = r->verts + (size_t)index * SOFT_VERTEX_FLOATS;
+    memcpy(out->c, src, 4 * sizeof(float));
+    memcpy(out->a, src + 4, SOFT_ATTRS * sizeof(float));
+}
+
+static void task_bin(SoftRenderer *r, int task, int worker)
+{
+    (void)worker;
+    SoftChunk *ch = &r->chunks[task];
+    int tiles = r->tiles_x * r->tiles_y;
+
+    ch->tri_count = 0;
+    for (int t = 0; t < tiles; t++)
+        ch->bins[t].count = 0;
+
+    for (size_t tri = ch->begin; tri < ch->end; tri++)
+    {
+        const unsigned int *idx = r->in_indices + tri * 3;
+        if (idx[0] >= r->in_vertex_count || idx[1] >= r->in_vertex_count ||
+            idx[2] >= r->in_vertex_count)
+            continue;
+
+        ClipVert poly[SOFT_CLIP_MAX];
+        for (int k = 0; k < 3; k++)
+            load_clip_vert(r, idx[k], &poly[k]);
+
+        unsigned c0 = outcode(poly[0].c), c1 = outcode(poly[1].c), c2 = outcode(poly[2].c);
+        if (c0 & c1 & c2)
+            continue; // w całości poza jedną płaszczyzną
+
+        if ((c0 | c1 | c2) == 0)
+        {
+            setup_triangle(r, ch, &poly[0], &poly[1], &poly[2]);
+            continue;
+        }
+
+        int n = clip_polygon(poly, 3, c0 | c1 | c2);
+        for (int k = 1; k + 1 < n; k++)
+            setup_triangle(r, ch, &poly[0], &poly[k], &poly[k + 1]);
+    }
+}
+
+/* =========================================================
+   Etap 3: rasteryzacja kafli
+   ========================================================= */
+
+static int wrap_texel(int i, int n)
+{
+    i %= n;
+    return i < 0 ? i + n : i;
+}
+
+/**
+ * @brief Próbkowanie dwuliniowe z powtarzaniem (GL_REPEAT, poziom 0).
+ */
+static void sample_texture(const TextureImage *tex, float u, float v, float out[3])
+{
+    float fx = u * (float)tex->width - 0.5f;
+    float fy = v * (float)tex->height - 0.5f;
+    if (!(fx > -1.0e6f && fx < 1.0e6f && fy > -1.0e6f && fy < 1.0e6f))
+    {
+        out[0] = out[1] = out[2] = 0.0f;
+        return;
+    }
+
+    float flx = floorf(fx), fly = floorf(fy);
+    float ax = fx - flx, ay = fy - fly;
+    int x0 = wrap_texel((int)flx, tex->width), x1 = wrap_texel((int)flx + 1, tex->width);
+    int y0 = wrap_texel((int)fly, tex->height), y1 = wrap_texel((int)fly + 1, tex->height);
+
+    const unsigned char *p = tex->pixels;
+    int ch = tex->channels;
+    size_t stride = (size_t)tex->width * (size_t)ch;
+    const unsigned char *t00 = p + (size_t)y0 * stride + (size_t)x0 * ch;
+    const unsigned char *t10 = p + (size_t)y0 * stride + (size_t)x1 * ch;
+    const unsigned char *t01 = p + (size_t)y1 * stride + (size_t)x0 * ch;
+    const unsigned char *t11 = p + (size_t)y1 * stride + (size_t)x1 * ch;
+
+    for (int k = 0; k < 3; k++)
+    {
+        float top = t00[k] + (t10[k] - t00[k]) * ax;
+        float bottom = t01[k] + (t11[k] - t01[k]) * ax;
+        out[k] = (top + (bottom - top) * ay) * (1.0f / 255.0f);
+    }
+}
+
+static uint32_t pack_color(const float c[3])
+{
+    uint32_t out = 0xff000000u;
+    for (int k = 0; k < 3; k++)
+    {
+        float v = c[k] < 0.0f ? 0.0f : (c[k] > 1.0f ? 1.0f : c[k]);
+        out |= (uint32_t)(v * 255.0f + 0.5f) << (8 * k);
+    }
+    return out;
+}
+
+/**
+ * @brief basic.frag: ambient 0.1 + lambert, kolor = Kd * tekstura.
+ */
+static uint32_t shade(const SoftRenderer *r, const float a[SOFT_ATTRS])
+{
+    float n[3] = {a[0], a[1], a[2]};
+    float len = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    float diff = 0.0f;
+    if (len > 0.0f)
+    {
+        diff = (n[0] * r->light_dir[0] + n[1] * r->light_dir[1] + n[2] * r->light_dir[2]) / len;
+        if (diff < 0.0f)
+            diff = 0.0f;
+    }
+
+    float base[3] = {r->material.diffuse[0], r->material.diffuse[1], r->material.diffuse[2]};
+    if (r->material.texture)
+    {
+        float t[3];
+        sample_texture(r->material.texture, a[3], a[4], t);
+        base[0] *= t[0];
+        base[1] *= t[1];
+        base[2] *= t[2];
+    }
+
+    float c[3];
+    for (int k = 0; k < 3; k++)
+        c[k] = base[k] * (0.1f + diff);
+    return pack_color(c);
+}
+
+/**
+ * @brief Rasteryzuje trójkąt w prostokącie kafla.
+ *
+ * Funkcje krawędzi liczone w int64 (28.4 * 28.4), krok o piksel to
+ * jedno dodawanie. Krawędź jest „włączna” tylko dla jednego z dwóch
+ * kierunków, więc wspólna krawędź sąsiednich trójkątów jest rysowana
+ * dokładnie raz.
+ */
+static size_t raster_triangle(SoftRenderer *r, const SoftTri *t, int rx0, int ry0, int rx1, int ry1)
+{
+    int x0 = t->minx > rx0 ? t->minx : rx0;
+    int y0 = t->miny > ry0 ? t->miny : ry0;
+    int x1 = t->maxx < rx1 ? t->maxx : rx1;
+    int y1 = t->maxy < ry1 ? t->maxy : ry1;
+    if (x0 > x1 || y0 > y1)
+        return 0;
+
+    int64_t row[3], stepX[3], stepY[3];
+    int64_t px = (int64_t)x0 * 16 + 8;
+    int64_t py = (int64_t)y0 * 16 + 8;
+    for (int e = 0; e < 3; e++)
+    {
+        // krawędź naprzeciw wierzchołka e: a -> b
+        int a = (e + 1) % 3, b = (e + 2) % 3;
+        int64_t dx = (int64_t)t->x[b] - t->x[a];
+        int64_t dy = (int64_t)t->y[b] - t->y[a];
+        int64_t bias = (dy > 0 || (dy == 0 && dx < 0)) ? 0 : -1;
+        row[e] = dx * (py - t->y[a]) - dy * (px - t->x[a]) + bias;
+        stepX[e] = -dy * 16;
+        stepY[e] = dx * 16;
+    }
+
+    size_t written = 0;
+    for (int y = y0; y <= y1; y++)
+    {
+        int64_t e0 = row[0], e1 = row[1], e2 = row[2];
+        size_t base = (size_t)y * (size_t)r->width;
+
+        for (int x = x0; x <= x1; x++)
+        {
+            if ((e0 | e1 | e2) >= 0)
+            {
+                float l1 = (float)e1 * t->inv_area;
+                float l2 = (float)e2 * t->inv_area;
+                float l0 = 1.0f - l1 - l2;
+                float z = t->z[0] * l0 + t->z[1] * l1 + t->z[2] * l2;
+
+                float *d = &r->depth[base + (size_t)x];
+                if (z < *d)
+                {
+                    float w = 1.0f / (t->iw[0] * l0 + t->iw[1] * l1 + t->iw[2] * l2);
+                    float a[SOFT_ATTRS];
+                    for (int k = 0; k < SOFT_ATTRS; k++)
+                        a[k] = (t->attr[0][k] * l0 + t->attr[1][k] * l1 + t->attr[2][k] * l2) * w;
+
+                    *d = z;
+                    r->color[base + (size_t)x] = shade(r, a);
+                    written++;
+                }
+            }
+            e0 += stepX[0];
+            e1 += stepX[1];
+            e2 += stepX[2];
+        }
+        row[0] += stepY[0];
+        row[1] += stepY[1];
+        row[2] += stepY[2];
+    }
+    return written;
+}
+
+static void task_raster(SoftRenderer *r, int task, int worker)
+{
+    (void)worker;
+    int tx = task % r->tiles_x, ty = task / r->tiles_x;
+    int rx0 = tx * SOFT_TILE_SIZE, ry0 = ty * SOFT_TILE_SIZE;
+    int rx1 = rx0 + SOFT_TILE_SIZE - 1, ry1 = ry0 + SOFT_TILE_SIZE - 1;
+    if (rx1 > r->width - 1) rx1 = r->width - 1;
+    if (ry1 > r->height - 1) ry1 = r->height - 1;
+
+    // fragmenty po kolei -> kolejność trójkątów jak w buforze indeksów
+    size_t written = 0;
+    for (int c = 0; c < r->chunk_count; c++)
+    {
+        const SoftChunk *ch = &r->chunks[c];
+        const SoftTileBin *bin = &ch->bins[task];
+        for (uint32_t i = 0; i < bin->count; i++)
+            written += raster_triangle(r, &ch->tris[bin->items[i]], rx0, ry0, rx1, ry1);
+    }
+    r->tile_pixels[task] = written;
+}
+
+/* =========================================================
+   API
+   ========================================================= */
+
+int soft_renderer_init(SoftRenderer *r, int width, int height, int threads)
+{
+    memset(r, 0, sizeof(*r));
+    if (width <= 0 || height <= 0)
+        return 0;
+
+    r->width = width;
+    r->height = height;
+    r->tiles_x = (width + SOFT_TILE_SIZE - 1) / SOFT_TILE_SIZE;
+    r->tiles_y = (height + SOFT_TILE_SIZE - 1) / SOFT_TILE_SIZE;
+    int tiles = r->tiles_x * r->tiles_y;
+
+    r->color = (uint32_t *)malloc((size_t)width * (size_t)height * sizeof(uint32_t));
+    r->depth = (float *)malloc((size_t)width * (size_t)height * sizeof(float));
+    r->tile_pixels = (size_t *)calloc((size_t)tiles, sizeof(size_t));
+    r->chunks = (SoftChunk *)calloc(SOFT_MAX_CHUNKS, sizeof(SoftChunk));
+    if (!r->color || !r->depth || !r->tile_pixels || !r->chunks)
+    {
+        soft_renderer_destroy(r);
+        return 0;
+    }
+    for (int c = 0; c < SOFT_MAX_CHUNKS; c++)
+    {
+        r->chunks[c].bins = (SoftTileBin *)calloc((size_t)tiles, sizeof(SoftTileBin));
+        if (!r->chunks[c].bins)
+        {
+            soft_renderer_destroy(r);
+            return 0;
+        }
+    }
+
+    if (threads <= 0)
+        threads = cpu_count();
+    if (threads > SOFT_MAX_THREADS)
+        threads = SOFT_MAX_THREADS;
+
+    pthread_mutex_init(&r->lock, NULL);
+    pthread_cond_init(&r->wake, NULL);
+    pthread_cond_init(&r->done, NULL);
+    for (int w = 0; w < SOFT_MAX_THREADS; w++)
+    {
+        pthread_mutex_init(&r->queues[w].lock, NULL);
+        r->queues[w].owner = r;
+        r->queues[w].index = w;
+    }
+
+    // wątek 0 to wątek wywołujący; przy błędzie tworzenia zostajemy z mniejszą pulą
+    r->threads = 1;
+    for (int w = 1; w < threads; w++)
+    {
+        if (pthread_create(&r->th[w], NULL, worker_main, &r->queues[w]) != 0)
+            break;
+        r->started[w] = 1;
+        r->threads = w + 1;
+    }
+
+    float black[3] = {0.0f, 0.0f, 0.0f};
+    soft_renderer_clear(r, black);
+    return 1;
+}
+
+void soft_renderer_clear(SoftRenderer *r, const float color[3])
+{
+    size_t n = (size_t)r->width * (size_t)r->height;
+    uint32_t c = pack_color(color);
+    for (size_t i = 0; i < n; i++)
+    {
+        r->color[i] = c;
+        r->depth[i] = 1.0f;
+    }
+}
+
+void soft_renderer_draw(SoftRenderer *r, const Vertex *vertices, size_t vertex_count,
+                        const unsigned int *indices, size_t index_count,
+                        const float model[16], const float normal[9],
+                        const float view_proj[16], const float light_dir[3],
+                        const SoftMaterial *mat)
+{
+    double t0 = now_ms();
+    size_t triCount = index_count / 3;
+    if (vertex_count == 0 || triCount == 0)
+        return;
+
+    if (vertex_count > r->vert_cap)
+    {
+        float *n = (float *)realloc(r->verts, vertex_count * SOFT_VERTEX_FLOATS * sizeof(float));
+        if (!n)
+        {
+            printf("ERROR: software renderer out of memory (%zu vertices)\n", vertex_count);
+            return;
+        }
+        r->verts = n;
+        r->vert_cap = vertex_count;
+    }
+
+    r->in_vertices = vertices;
+    r->in_indices = indices;
+    r->in_vertex_count = vertex_count;
+    r->in_triangle_count = triCount;
+    r->material = *mat;
+    mat4_mul(view_proj, model, r->mvp);
+    for (int c = 0; c < 3; c++)
+    {
+        r->normal[c * 4 + 0] = normal[c * 3 + 0];
+        r->normal[c * 4 + 1] = normal[c * 3 + 1];
+        r->normal[c * 4 + 2] = normal[c * 3 + 2];
+        r->normal[c * 4 + 3] = 0.0f;
+    }
+
+    // basic.frag: lightDir = normalize(-uLightDir)
+    float len = sqrtf(light_dir[0] * light_dir[0] + light_dir[1] * light_dir[1] +
+                      light_dir[2] * light_dir[2]);
+    for (int k = 0; k < 3; k++)
+        r->light_dir[k] = len > 0.0f ? -light_dir[k] / len : 0.0f;
+
+    /* 1. wierzchołki */
+    size_t vtasks = (vertex_count + SOFT_VERTS_PER_TASK - 1) / SOFT_VERTS_PER_TASK;
+    if (vtasks > SOFT_MAX_TRANSFORM_TASKS)
+        vtasks = SOFT_MAX_TRANSFORM_TASKS;
+    pool_run(r, (int)vtasks, task_transform);
+    double t1 = now_ms();
+
+    /* 2. setup + kosze (liczba fragmentów nie zależy od liczby wątków) */
+    size_t chunks = (triCount + SOFT_TRIS_PER_CHUNK - 1) / SOFT_TRIS_PER_CHUNK;
+    if (chunks > SOFT_MAX_CHUNKS)
+        chunks = SOFT_MAX_CHUNKS;
+    r->chunk_count = (int)chunks;
+    for (size_t c = 0; c < chunks; c++)
+    {
+        r->chunks[c].begin = triCount * c / chunks;
+        r->chunks[c].end = triCount * (c + 1) / chunks;
+        r->chunks[c].failed = 0;
+    }
+    pool_run(r, r->chunk_count, task_bin);
+    double t2 = now_ms();
+
+    /* 3. kafle */
+    int tiles = r->tiles_x * r->tiles_y;
+    pool_run(r, tiles, task_raster);
+    double t3 = now_ms();
+
+    int failed = 0;
+    for (int c = 0; c < r->chunk_count; c++)
+    {
+        r->stats.triangles_setup += r->chunks[c].tri_count;
+        failed |= r->chunks[c].failed;
+    }
+    if (failed)
+        printf("WARNING: software renderer dropped triangles (out of memory)\n");
+    for (int t = 0; t < tiles; t++)
+        r->stats.pixels += r->tile_pixels[t];
+
+    unsigned long steals = 0;
+    for (int w = 0; w < r->threads; w++)
+        steals += r->queues[w].steals;
+    r->stats.steals = steals;
+
+    r->stats.triangles += triCount;
+    r->stats.transform_ms += t1 - t0;
+    r->stats.bin_ms += t2 - t1;
+    r->stats.raster_ms += t3 - t2;
+    r->stats.total_ms += t3 - t0;
+}
+
+void soft_renderer_reset_stats(SoftRenderer *r)
+{
+    memset(&r->stats, 0, sizeof(r->stats));
+    for (int w = 0; w < r->threads; w++)
+        r->queues[w].steals = 0;
+}
+
+int soft_renderer_write_ppm(const SoftRenderer *r, const char *path)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f)
+    {
+        printf("Cannot write image: %s\n", path);
+        return 0;
+    }
+
+    fprintf(f, "P6\n%d %d\n255\n", r->width, r->height);
+    unsigned char *row = (unsigned char *)malloc((size_t)r->width * 3);
+    int ok = row != NULL;
+    for (int y = 0; ok && y < r->height; y++)
+    {
+        const uint32_t *src = r->color + (size_t)y * (size_t)r->width;
+        for (int x = 0; x < r->width; x++)
+        {
+            row[x * 3 + 0] = (unsigned char)(src[x] & 0xff);
+            row[x * 3 + 1] = (unsigned char)((src[x] >> 8) & 0xff);
+            row[x * 3 + 2] = (unsigned char)((src[x] >> 16) & 0xff);
+        }
+        ok = fwrite(row, 3, (size_t)r->width, f) == (size_t)r->width;
+    }
+    free(row);
+    if (fclose(f) != 0)
+        ok = 0;
+    if (!ok)
+        printf("Cannot write image: %s\n", path);
+    return ok;
+}
+
+void soft_renderer_destroy(SoftRenderer *r)
+{
+    // threads > 0 -> pula (mutexy, wątki) została utworzona
+    if (r->threads > 0)
+    {
+        pthread_mutex_lock(&r->lock);
+        r->quit = 1;
+        pthread_cond_broadcast(&r->wake);
+        pthread_mutex_unlock(&r->lock);
+        for (int w = 1; w < SOFT_MAX_THREADS; w++)
+            if (r->started[w])
+                pthread_join(r->th[w], NULL);
+
+        pthread_mutex_destroy(&r->lock);
+        pthread_cond_destroy(&r->wake);
+        pthread_cond_destroy(&r->done);
+        for (int w = 0; w < SOFT_MAX_THREADS; w++)
+            pthread_mutex_destroy(&r->queues[w].lock);
+    }
+
+    if (r->chunks)
+    {
+        for (int c = 0; c < SOFT_MAX_CHUNKS; c++)
+        {
+            SoftChunk *ch = &r->chunks[c];
+            if (ch->bins)
+            {
+                for (int t = 0; t < r->tiles_x * r->tiles_y; t++)
+                    free(ch->bins[t].items);
+                free(ch->bins);
+            }
+            free(ch->tris);
+        }
+        free(r->chunks);
+    }
+    free(r->color);
+    free(r->depth);
+    free(r->verts);
+    free(r->tile_pixels);
+    memset(r, 0, sizeof(*r));
+}
@@ -0,0 +1,162 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "Mesh.h"
+#include "Material.h"
+
+#define SOFT_MAX_THREADS 64
+#define SOFT_TILE_SIZE 64 // piksele; kafel rasteryzuje zawsze jeden wątek
+
+/**
+ * @brief Materiał dla renderera CPU (odpowiednik uniformów basic.frag).
+ */
+typedef struct SoftMaterial
+{
+    float diffuse[3];           // Kd
+    const TextureImage *texture; // map_Kd (NULL jeśli brak), odwrócona w pionie jak dla GL
+} SoftMaterial;
+
+/**
+ * @brief Kolejka zadań jednego wątku: zakres [lo, hi) indeksów.
+ *
+ * Właściciel pobiera od dołu, złodziej zabiera górną połowę zakresu.
+ */
+typedef struct SoftWorkQueue
+{
+    pthread_mutex_t lock;
+    int lo, hi;
+    unsigned long steals;
+    struct SoftRenderer *owner;
+    int index;
+    char pad[64]; // osobne linie cache dla kolejek sąsiednich wątków
+} SoftWorkQueue;
+
+typedef struct SoftChunk SoftChunk;
+
+/**
+ * @brief Statystyki ostatniego rysowania (sumowane od soft_renderer_reset_stats).
+ */
+typedef struct SoftRasterStats
+{
+    size_t triangles;        // trójkąty wejściowe
+    size_t triangles_setup;  // po odrzuceniu i obcięciu (trafiły do kafli)
+    size_t pixels;           // fragmenty, które przeszły test głębokości
+    unsigned long steals;    // zakresy przejęte przez inne wątki
+    double transform_ms;
+    double bin_ms;
+    double raster_ms;
+    double total_ms;
+} SoftRasterStats;
+
+/**
+ * @brief Programowy renderer: ten sam Vertex/indeksy co mesh_draw().
+ *
+ * Potok jednego rysowania (każdy etap równolegle):
+ *  1. transformacja wierzchołków (SSE: kolumny macierzy * składowe),
+ *  2. obcinanie (near/far + pas ochronny), setup i przydział trójkątów
+ *     do kafli SOFT_TILE_SIZE — każdy fragment listy trójkątów ma własne
+ *     kosze, więc bez blokad,
+ *  3. rasteryzacja kafli (krawędzie w stałym przecinku 28.4, reguła
+ *     top-left, test głębokości LESS, cieniowanie jak basic.frag).
+ *
+ * Zadania rozdzielane są między stałą pulę wątków z podkradaniem pracy.
+ * Kolejność trójkątów w kaflu odpowiada kolejności indeksów, więc obraz
+ * nie zależy od liczby wątków (złote obrazy na CI).
+ */
+typedef struct SoftRenderer
+{
+    int width, height;
+    uint32_t *color; // RGBA8, wiersz 0 = góra obrazu
+    float *depth;    // [0, 1], wyczyszczony do 1
+
+    int tiles_x, tiles_y;
+
+    /* pula wątków */
+    int threads;
+    pthread_t th[SOFT_MAX_THREADS];
+    int started[SOFT_MAX_THREADS];
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    unsigned long generation;
+    int pending;
+    int quit;
+    void (*task_fn)(struct SoftRenderer *r, int task, int worker);
+    int task_count;
+    SoftWorkQueue queues[SOFT_MAX_THREADS];
+
+    /* dane rysowania */
+    float *verts;     // przetransformowane wierzchołki (clip + atrybuty)
+    size_t vert_cap;
+    SoftChunk *chunks;
+    int chunk_count;
+    size_t *tile_pixels;
+
+    const Vertex *in_vertices;
+    const unsigned int *in_indices;
+    size_t in_vertex_count;
+    size_t in_triangle_count;
+    float mvp[16];
+    float normal[12]; // mat3 jako 3 kolumny po 4
+    float light_dir[3];
+    SoftMaterial material;
+
+    SoftRasterStats stats;
+} SoftRenderer;
+
+/**
+ * @brief Tworzy bufory obrazu i pulę wątków.
+ *
+ * @param r       Renderer.
+ * @param width   Szerokość obrazu.
+ * @param height  Wysokość obrazu.
+ * @param threads Liczba wątków (0 -> liczba rdzeni).
+ * @return 1 jeśli OK, 0 jeśli błąd alokacji.
+ */
+int soft_renderer_init(SoftRenderer *r, int width, int height, int threads);
+
+/**
+ * @brief Czyści kolor i głębokość (jak glClear).
+ */
+void soft_renderer_clear(SoftRenderer *r, const float color[3]);
+
+/**
+ * @brief Rysuje siatkę trójkątów (odpowiednik mesh_draw z basic.vert/basic.frag).
+ *
+ * Macierze kolumnowe (jak w cglm / glUniformMatrix4fv).
+ *
+ * @param r            Renderer.
+ * @param vertices     Wierzchołki.
+ * @param vertex_count Liczba wierzchołków.
+ * @param indices      Indeksy trójkątów.
+ * @param index_count  Liczba indeksów.
+ * @param model        Macierz świata (uModel).
+ * @param normal       Macierz normalnych 3x3 (uNormalMatrix).
+ * @param view_proj    uProjection * uView.
+ * @param light_dir    Kierunek światła (uLightDir).
+ * @param mat          Materiał.
+ */
+void soft_renderer_draw(SoftRenderer *r, const Vertex *vertices, size_t vertex_count,
+                        const unsigned int *indices, size_t index_count,
+                        const float model[16], const float normal[9],
+                        const float view_proj[16], const float light_dir[3],
+                        const SoftMaterial *mat);
+
+/**
+ * @brief Zeruje statystyki (np. przed serią klatek benchmarku).
+ */
+void soft_renderer_reset_stats(SoftRenderer *r);
+
+/**
+ * @brief Zapisuje obraz jako binarny PPM (P6).
+ *
+ * @return 1 jeśli OK, 0 jeśli błąd zapisu.
+ */
+int soft_renderer_write_ppm(const SoftRenderer *r, const char *path);
+
+/**
+ * @brief Zatrzymuje wątki i zwalnia pamięć.
+ */
+void soft_renderer_destroy(SoftRenderer *r);
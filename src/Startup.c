@@ -0,0 +1,303 @@
+#include "Startup.h"
+#include "MeshCodec.h"
+#include "ObjIndex.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* =========================================================
+   Zadania CPU (workery)
+   ========================================================= */
+
+static void job_read_vertex(void *arg)
+{
+    Startup *s = (Startup *)arg;
+    s->vertex_src = shader_read_file(s->params.vertex_path);
+}
+
+static void job_read_fragment(void *arg)
+{
+    Startup *s = (Startup *)arg;
+    s->fragment_src = shader_read_file(s->params.fragment_path);
+}
+
+#define STARTUP_MAX_OBJECTS 64
+
+/**
+ * @brief Wybrane obiekty OBJ przez indeks (path.idx budowany przy pierwszym użyciu).
+ */
+static int load_objects(const StartupParams *p, ObjModelData *out)
+{
+    char list[1024];
+    snprintf(list, sizeof(list), "%s", p->objects);
+
+    const char *names[STARTUP_MAX_OBJECTS];
+    size_t count = 0;
+    for (char *tok = strtok(list, ","); tok && count < STARTUP_MAX_OBJECTS; tok = strtok(NULL, ","))
+        names[count++] = tok;
+
+    ObjIndex index;
+    if (!obj_index_open(p->obj_path, &index))
+        return 0;
+
+    ObjIndexLoadStats st;
+    int ok = obj_index_load_objects(&index, p->obj_path, names, count, out, &p->normals, &st);
+    if (ok)
+        obj_index_print_load_stats(&st);
+    obj_index_free(&index);
+    return ok;
+}
+
+static void job_decode_texture(void *arg)
+{
+    StartupDecode *d = (StartupDecode *)arg;
+    ModelMaterials *m = &d->s->materials;
+    for (size_t t = d->first; t < m->texture_count; t += STARTUP_DECODE_JOBS)
+        model_materials_decode(m, t);
+}
+
+/**
+ * @brief Biblioteka MTL modelu z wieloma usemtl i zadania dekodowania jego tekstur.
+ *
+ * Wołane z zadania load model: upload model już na nie czeka, więc
+ * dołożone zależności zdążą przed jego startem.
+ */
+static void spawn_texture_decodes(Startup *s)
+{
+    s->materials_parsed = model_materials_parse(&s->materials, s->params.mtl_path, s->params.tex_pack);
+    if (!s->materials_parsed)
+        return;
+
+    size_t count = s->materials.texture_count;
+    size_t jobs = count < STARTUP_DECODE_JOBS ? count : STARTUP_DECODE_JOBS;
+    for (size_t i = 0; i < jobs; i++)
+    {
+        StartupDecode *d = &s->decodes[i];
+        d->s = s;
+        d->first = i;
+        JobId id = job_create(&s->jobs, "decode texture", job_decode_texture, d, 0);
+        if (id == JOB_NONE)
+        {
+            // pula pełna: ta część na bieżącym workerze
+            job_decode_texture(d);
+            continue;
+        }
+        job_depend(&s->jobs, s->upload_model, id);
+        job_submit(&s->jobs, id);
+    }
+}
+
+static void job_load_model(void *arg)
+{
+    Startup *s = (Startup *)arg;
+    const StartupParams *p = &s->params;
+
+    if (p->mesh_path)
+        s->model_loaded = mesh_codec_load(p->mesh_path, &s->model);
+    else if (p->objects)
+        s->model_loaded = load_objects(p, &s->model);
+    else
+        s->model_loaded = obj_load_ex(p->obj_path, &s->model, &p->normals);
+    if (s->model_loaded && p->weld.position_eps > 0.0f)
+    {
+        WeldStats ws;
+        if (weld_model(&s->model, &p->weld, &ws))
+            weld_print_stats(&ws);
+    }
+
+    // usemtl -> materiały z biblioteki MTL, tekstury równolegle przed upload model
+    if (s->model_loaded && s->model.submesh_count > 0 && p->mtl_path && !s->cancelled)
+        spawn_texture_decodes(s);
+}
+
+static void job_load_points(void *arg)
+{
+    Startup *s = (Startup *)arg;
+    s->has_points = point_cloud_load_obj(&s->points, s->params.points_path);
+    if (s->has_points)
+    {
+        memcpy(s->bmin, s->points.bmin, sizeof(s->bmin));
+        memcpy(s->bmax, s->points.bmax, sizeof(s->bmax));
+    }
+}
+
+/**
+ * @brief MTL i tekstura pierwszego materiału.
+ *
+ * Rusza przed poznaniem modelu; dla modelu z wieloma usemtl wynik
+ * jest odrzucany (materiały wczytuje wtedy ModelMaterials).
+ */
+static void job_load_material(void *arg)
+{
+    Startup *s = (Startup *)arg;
+    s->material_parsed = material_parse_mtl(s->params.mtl_path, &s->material_desc);
+    if (s->material_parsed && s->material_desc.diffuseMap[0])
+        texture_image_load(s->material_desc.diffuseMap, &s->texture);
+}
+
+/* =========================================================
+   Zadania GL (wątek główny)
+   ========================================================= */
+
+static void job_compile_shaders(void *arg)
+{
+    Startup *s = (Startup *)arg;
+    if (!s->cancelled && s->vertex_src && s->fragment_src)
+    {
+        // źródła zostają w wariantach; bazowy od razu (błąd składni = błąd startu)
+        shader_variants_init(&s->shaders, s->vertex_src, s->fragment_src,
+                             s->params.vertex_path, s->params.fragment_path);
+        s->vertex_src = s->fragment_src = NULL;
+        s->shader.id = shader_variants_get(&s->shaders, 0);
+    }
+    free(s->vertex_src);
+    free(s->fragment_src);
+    s->vertex_src = s->fragment_src = NULL;
+}
+
+static void job_upload_model(void *arg)
+{
+    Startup *s = (Startup *)arg;
+    if (!s->model_loaded)
+        return;
+
+    if (!s->cancelled)
+    {
+        // tekstury zdekodowane w zadaniach; przestawia indeksy, więc przed mesh_create
+        if (s->materials_parsed)
+        {
+            s->multi_material = model_materials_upload(&s->materials, &s->model);
+            if (!s->multi_material)
+                printf("Failed to set up materials: %s\n", s->params.mtl_path);
+        }
+
+        s->mesh = mesh_create(s->model.vertices, (unsigned int)s->model.vertex_count,
+                              s->model.indices, (unsigned int)s->model.index_count);
+        s->has_mesh = 1;
+        obj_compute_bounds(&s->model, s->bmin, s->bmax);
+        if (s->params.streamer)
+            s->uv_density = texture_stream_uv_density(s->model.vertices, s->model.indices, s->model.index_count);
+    }
+
+    // dane CPU nie są już potrzebne po wrzuceniu do GPU
+    if (s->materials_parsed && !s->multi_material)
+        model_materials_destroy(&s->materials); // anulowanie: same obrazy, bez obiektów GL
+    s->materials_parsed = 0;
+    obj_free(&s->model);
+}
+
+static void job_upload_material(void *arg)
+{
+    Startup *s = (Startup *)arg;
+    material_init(&s->material);
+
+    if (!s->cancelled && s->material_parsed && !s->multi_material)
+    {
+        memcpy(s->material.diffuse, s->material_desc.diffuse, sizeof(s->material.diffuse));
+        if (s->params.streamer && s->texture.pixels)
+        {
+            // na GPU sam ogon łańcucha mip; streamer przejmuje obraz
+            s->texture_stream = texture_streamer_add(s->params.streamer, s->material_desc.diffuseMap, &s->texture);
+            s->material.diffuseTex = texture_streamer_texture(s->params.streamer, s->texture_stream);
+        }
+        else
+        {
+            s->material.diffuseTex = texture_create_2d(&s->texture);
+        }
+    }
+    texture_image_free(&s->texture);
+}
+
+/* =========================================================
+   API
+   ========================================================= */
+
+int startup_begin(Startup *s, const StartupParams *params)
+{
+    memset(s, 0, sizeof(*s));
+    s->params = *params;
+    material_init(&s->material);
+    s->texture_stream = -1;
+
+    if (!job_system_init(&s->jobs, params->serial ? 0 : -1))
+        return 0;
+
+    // kolejność zgłoszeń = dawna kolejność szeregowa (tryb --serial-startup)
+    JobSystem *js = &s->jobs;
+    JobId readVert = job_create(js, "read vert", job_read_vertex, s, 0);
+    JobId readFrag = job_create(js, "read frag", job_read_fragment, s, 0);
+    JobId compile = job_create(js, "compile shaders", job_compile_shaders, s, 1);
+    job_depend(js, compile, readVert);
+    job_depend(js, compile, readFrag);
+    job_submit(js, readVert);
+    job_submit(js, readFrag);
+    job_submit(js, compile);
+
+    JobId uploadModel = JOB_NONE;
+    if (params->obj_path || params->mesh_path)
+    {
+        JobId loadModel = job_create(js, "load model", job_load_model, s, 0);
+        uploadModel = job_create(js, "upload model", job_upload_model, s, 1);
+        s->upload_model = uploadModel;
+        job_depend(js, uploadModel, loadModel);
+        // GL po kolei: shader, potem siatka (jak dotąd)
+        job_depend(js, uploadModel, compile);
+        job_submit(js, loadModel);
+        job_submit(js, uploadModel);
+    }
+
+    if (params->points_path)
+        job_submit(js, job_create(js, "load points", job_load_points, s, 0));
+
+    if (params->mtl_path)
+    {
+        JobId loadMaterial = job_create(js, "load material", job_load_material, s, 0);
+        JobId uploadMaterial = job_create(js, "upload material", job_upload_material, s, 1);
+        job_depend(js, uploadMaterial, loadMaterial);
+        job_depend(js, uploadMaterial, compile);
+        job_depend(js, uploadMaterial, uploadModel);
+        job_submit(js, loadMaterial);
+        job_submit(js, uploadMaterial);
+    }
+    return 1;
+}
+
+int startup_finish(Startup *s)
+{
+    job_system_wait_all(&s->jobs);
+    job_system_print_stats(&s->jobs);
+    job_system_destroy(&s->jobs);
+
+    int hasModel = s->params.obj_path || s->params.mesh_path;
+    int hasPoints = s->params.points_path != NULL;
+    if (s->shader.id && (!hasModel || s->has_mesh) && (!hasPoints || s->has_points))
+        return 1;
+
+    if (!s->shader.id)
+        printf("Shader load failed\n");
+    if (hasModel && !s->has_mesh)
+        printf("Failed to load %s\n", s->params.mesh_path ? s->params.mesh_path : s->params.obj_path);
+    if (hasPoints && !s->has_points)
+        printf("Failed to load %s\n", s->params.points_path);
+
+    shader_variants_destroy(&s->shaders);
+    s->shader.id = 0;
+    if (s->has_mesh)
+        mesh_destroy(&s->mesh);
+    if (s->multi_material)
+        model_materials_destroy(&s->materials);
+    material_destroy(&s->material);
+    if (s->has_points)
+        point_cloud_free(&s->points);
+    return 0;
+}
+
+void startup_cancel(Startup *s)
+{
+    // zadania GL zobaczą cancelled i tylko zwolnią dane CPU
+    s->cancelled = 1;
+    job_system_destroy(&s->jobs);
+    if (s->has_points)
+        point_cloud_free(&s->points); // bez kontekstu: węzły nie były jeszcze na GPU
+}
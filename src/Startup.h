@@ -0,0 +1,120 @@
+#pragma once
+#include "JobSystem.h"
+#include "Shader.h"
+#include "Mesh.h"
+#include "Material.h"
+#include "ModelMaterials.h"
+#include "ObjLoader.h"
+#include "Weld.h"
+#include "PointCloud.h"
+#include "TextureStream.h"
+
+/**
+ * @brief Co wczytać przy starcie.
+ */
+typedef struct StartupParams
+{
+    const char *vertex_path;
+    const char *fragment_path;
+    const char *obj_path;  // NULL -> bez modelu (paczka .pak / octree)
+    const char *mesh_path; // .omc zamiast obj_path (może być NULL)
+    const char *objects;   // "a,b,c": tylko te obiekty/grupy obj_path, przez indeks .idx (może być NULL)
+    const char *mtl_path;
+    const char *points_path; // OBJ z samymi liniami v -> chmura punktów (może być NULL)
+    NormalGenParams normals;
+    WeldParams weld;
+    int tex_pack; // modele z wieloma usemtl: tablice tekstur
+    int serial;   // 1 -> wszystko na wątku głównym po utworzeniu okna (dawna kolejność)
+    TextureStreamer *streamer; // tekstura materiału strumieniowana (może być NULL)
+} StartupParams;
+
+#define STARTUP_DECODE_JOBS 32 // najwyżej tyle zadań dekodowania tekstur materiałów
+
+struct Startup;
+
+/**
+ * @brief Zadanie dekodowania: tekstury first, first + STARTUP_DECODE_JOBS, ...
+ */
+typedef struct StartupDecode
+{
+    struct Startup *s;
+    size_t first;
+} StartupDecode;
+
+/**
+ * @brief Start jako graf zadań.
+ *
+ * Część CPU (odczyt shaderów, parsowanie OBJ/.omc i scalanie,
+ * parsowanie MTL i dekodowanie tekstury) rusza na workerach od razu
+ * w startup_begin(), równolegle z tworzeniem okna i kontekstu.
+ * Część GL (kompilacja shaderów, mesh_create, tekstury) wykonuje wątek
+ * główny w startup_finish(), każdą zaraz po zakończeniu jej danych.
+ *
+ *   read vert ─┐
+ *   read frag ─┴─> compile shaders (GL)
+ *   load model ──> upload model (GL) ─┐
+ *   load material ────────────────────┴─> upload material (GL)
+ *   load points (octree budowane na workerach; na GPU węzły w locie)
+ *
+ * Model z wieloma usemtl: load model parsuje bibliotekę MTL i dokłada
+ * do grafu zadanie dekodowania na każdą teksturę (do STARTUP_DECODE_JOBS),
+ * od których zależy upload model (tekstury / tablice tekstur).
+ *
+ *   load model ──> decode texture × N ──> upload model (GL)
+ */
+typedef struct Startup
+{
+    StartupParams params;
+    JobSystem jobs;
+    int cancelled;
+
+    /* dane CPU (workery) */
+    char *vertex_src;
+    char *fragment_src;
+    ObjModelData model;
+    int model_loaded;
+    MaterialDesc material_desc;
+    TextureImage texture;
+    int material_parsed;
+    int materials_parsed;   // s->materials po model_materials_parse() (obrazy dekodują zadania)
+    JobId upload_model;     // czeka na zadania dekodowania
+    StartupDecode decodes[STARTUP_DECODE_JOBS];
+    PointCloud points;
+    int has_points;
+
+    /* wyniki (wątek główny) */
+    ShaderVariants shaders;
+    ShaderProgram shader; // wariant bazowy z shaders (bez cech; własność shaders)
+    Mesh mesh;
+    int has_mesh;
+    ModelMaterials materials;
+    int multi_material;
+    Material material;
+    int texture_stream;  // uchwyt w params.streamer (-1 -> material.diffuseTex jest własna)
+    float uv_density;    // texture_stream_uv_density() siatki (0 bez streamera)
+    float bmin[3];
+    float bmax[3];
+} Startup;
+
+/**
+ * @brief Buduje graf i uruchamia zadania CPU (przed utworzeniem okna).
+ *
+ * @return 1 jeśli OK, 0 jeśli nie udało się uruchomić systemu zadań.
+ */
+int startup_begin(Startup *s, const StartupParams *params);
+
+/**
+ * @brief Wykonuje zadania GL w miarę gotowości danych i czeka na całość.
+ *
+ * Wołać z wątku głównego z aktywnym kontekstem GL. Wyniki w s->shaders
+ * (i s->shader), s->mesh, s->materials / s->material, s->points, s->bmin / s->bmax; zwalniać
+ * jak dotąd w main.c.
+ *
+ * @return 1 jeśli shader (i model, jeśli był) wczytany, 0 jeśli błąd.
+ */
+int startup_finish(Startup *s);
+
+/**
+ * @brief Przerywa start bez kontekstu GL (np. okno się nie utworzyło).
+ */
+void startup_cancel(Startup *s);
@@ -0,0 +1,378 @@
+#include "TexturePack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TEXPACK_ATLAS_MIN 256
+#define TEXPACK_ALIGN 8   // wyrównanie slotów (spójne texele do poziomu mip 3)
+#define TEXPACK_WHITE 8   // bok białego fragmentu dla materiałów bez tekstury
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+}
+
+static int align_up(int v)
+{
+    return (v + TEXPACK_ALIGN - 1) & ~(TEXPACK_ALIGN - 1);
+}
+
+/* =========================================================
+ * Konwersja i kopiowanie pikseli
+ * ========================================================= */
+
+/**
+ * @brief Kopiuje obraz do RGBA8 (w tablicy tekstur wszystkie warstwy mają ten sam format).
+ */
+static void copy_rgba(unsigned char *dst, const TextureImage *img)
+{
+    size_t n = (size_t)img->width * img->height;
+    if (img->channels == 4) {
+        memcpy(dst, img->pixels, n * 4);
+        return;
+    }
+    const unsigned char *src = img->pixels;
+    for (size_t i = 0; i < n; i++) {
+        dst[i * 4 + 0] = src[i * 3 + 0];
+        dst[i * 4 + 1] = src[i * 3 + 1];
+        dst[i * 4 + 2] = src[i * 3 + 2];
+        dst[i * 4 + 3] = 255;
+    }
+}
+
+/**
+ * @brief Wpisuje obraz do strony atlasu razem z ramką.
+ *
+ * Ramka powtarza obraz tak jak GL_REPEAT, więc filtrowanie na brzegu
+ * (i mipmapy do poziomu log2(TEXPACK_PADDING)) widzi te same texele,
+ * co przy osobnej teksturze.
+ */
+static void blit_padded(unsigned char *page, int page_size, int x, int y, const TextureImage *img)
+{
+    const int P = TEXPACK_PADDING;
+    int w = img->width, h = img->height;
+    for (int dy = 0; dy < h + 2 * P; dy++) {
+        int sy = ((dy - P) % h + h) % h;
+        unsigned char *row = page + ((size_t)(y + dy) * page_size + x) * 4;
+        for (int dx = 0; dx < w + 2 * P; dx++) {
+            int sx = ((dx - P) % w + w) % w;
+            const unsigned char *s = img->pixels + ((size_t)sy * w + sx) * img->channels;
+            row[dx * 4 + 0] = s[0];
+            row[dx * 4 + 1] = s[1];
+            row[dx * 4 + 2] = s[2];
+            row[dx * 4 + 3] = img->channels == 4 ? s[3] : 255;
+        }
+    }
+}
+
+/* =========================================================
+ * Upload
+ * ========================================================= */
+
+static size_t mip_chain_bytes(int w, int h, int layers, int levels)
+{
+    size_t bytes = 0;
+    for (int l = 0; l < levels; l++) {
+        bytes += (size_t)w * h * layers * 4;
+        if (w == 1 && h == 1)
+            break;
+        w = w > 1 ? w / 2 : 1;
+        h = h > 1 ? h / 2 : 1;
+    }
+    return bytes;
+}
+
+static int full_levels(int w, int h)
+{
+    int levels = 1;
+    while (w > 1 || h > 1) {
+        w = w > 1 ? w / 2 : 1;
+        h = h > 1 ? h / 2 : 1;
+        levels++;
+    }
+    return levels;
+}
+
+/**
+ * @brief Tworzy tablicę tekstur; warstwy to kolejne bloki w*h*4 bajtów.
+ */
+static GLuint upload_array(int w, int h, int layers, const unsigned char *pixels, int max_level)
+{
+    GLuint tex;
+    glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, tex);
+
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, w, h, layers, 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, max_level);
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    return tex;
+}
+
+static TexturePackArray *push_array(TexturePack *p)
+{
+    TexturePackArray *grown = (TexturePackArray *)realloc(p->arrays,
+                                                          (size_t)(p->array_count + 1) * sizeof(TexturePackArray));
+    if (!grown)
+        return NULL;
+    p->arrays = grown;
+    TexturePackArray *a = &p->arrays[p->array_count++];
+    memset(a, 0, sizeof(*a));
+    return a;
+}
+
+/* =========================================================
+ * Atlas (półki)
+ * ========================================================= */
+
+typedef struct AtlasItem
+{
+    size_t image;   // indeks obrazu lub (size_t)-1 dla białego fragmentu
+    int w, h;       // rozmiar slotu z ramką, wyrównany
+    int x, y, page;
+} AtlasItem;
+
+static int cmp_item_height(const void *a, const void *b)
+{
+    const AtlasItem *x = (const AtlasItem *)a, *y = (const AtlasItem *)b;
+    if (x->h != y->h)
+        return y->h - x->h;
+    return y->w - x->w;
+}
+
+/**
+ * @brief Układa sloty półkami na stronach size x size.
+ *
+ * @return Liczba stron.
+ */
+static int shelf_pack(AtlasItem *items, size_t count, int size)
+{
+    int page = 0, x = 0, y = 0, shelf = 0;
+    for (size_t i = 0; i < count; i++) {
+        AtlasItem *it = &items[i];
+        if (x + it->w > size) {
+            x = 0;
+            y += shelf;
+            shelf = 0;
+        }
+        if (y + it->h > size) {
+            page++;
+            x = y = shelf = 0;
+        }
+        it->x = x;
+        it->y = y;
+        it->page = page;
+        x += it->w;
+        if (it->h > shelf)
+            shelf = it->h;
+    }
+    return count ? page + 1 : 0;
+}
+
+/**
+ * @brief Buduje strony atlasu dla tekstur bez pary i białego fragmentu.
+ */
+static int build_atlas(TexturePack *p, const TextureImage *images, const size_t *list, size_t count)
+{
+    const int P = TEXPACK_PADDING;
+    unsigned char white[TEXPACK_WHITE * TEXPACK_WHITE * 4];
+    memset(white, 255, sizeof(white));
+    TextureImage white_img = {white, TEXPACK_WHITE, TEXPACK_WHITE, 4};
+
+    AtlasItem *items = (AtlasItem *)malloc((count + 1) * sizeof(AtlasItem));
+    if (!items)
+        return 0;
+
+    size_t area = 0;
+    for (size_t i = 0; i <= count; i++) {
+        const TextureImage *img = i < count ? &images[list[i]] : &white_img;
+        items[i].image = i < count ? list[i] : (size_t)-1;
+        items[i].w = align_up(img->width + 2 * P);
+        items[i].h = align_up(img->height + 2 * P);
+        area += (size_t)items[i].w * items[i].h;
+    }
+    qsort(items, count + 1, sizeof(AtlasItem), cmp_item_height);
+
+    // najmniejsza strona potęgi dwójki, na której wszystko mieści się na jednej stronie
+    int size = TEXPACK_ATLAS_MIN;
+    while (size < TEXPACK_ATLAS_MAX &&
+           ((size_t)size * size < area || shelf_pack(items, count + 1, size) > 1))
+        size *= 2;
+    int pages = shelf_pack(items, count + 1, size);
+
+    size_t page_bytes = (size_t)size * size * 4;
+    unsigned char *pixels = (unsigned char *)calloc((size_t)pages, page_bytes);
+    TexturePackArray *a = pixels ? push_array(p) : NULL;
+    if (!a) {
+        free(pixels);
+        free(items);
+        return 0;
+    }
+    int array = p->array_count - 1;
+
+    for (size_t i = 0; i <= count; i++) {
+        const AtlasItem *it = &items[i];
+        int white_slot = it->image == (size_t)-1;
+        const TextureImage *img = white_slot ? &white_img : &images[it->image];
+        blit_padded(pixels + page_bytes * it->page, size, it->x, it->y, img);
+
+        TexturePackEntry e;
+        e.array = array;
+        e.layer = (float)it->page;
+        if (white_slot) {
+            // stała próbka ze środka fragmentu
+            e.uv_scale[0] = e.uv_scale[1] = 0.0f;
+            e.uv_offset[0] = (it->x + P + TEXPACK_WHITE * 0.5f) / size;
+            e.uv_offset[1] = (it->y + P + TEXPACK_WHITE * 0.5f) / size;
+            for (size_t k = 0; k < p->entry_count; k++)
+                if (!images[k].pixels)
+                    p->entries[k] = e;
+        } else {
+            e.uv_scale[0] = (float)img->width / size;
+            e.uv_scale[1] = (float)img->height / size;
+            e.uv_offset[0] = (float)(it->x + P) / size;
+            e.uv_offset[1] = (float)(it->y + P) / size;
+            p->entries[it->image] = e;
+        }
+    }
+
+    a->width = a->height = size;
+    a->layers = pages;
+    a->atlas = 1;
+    a->texture = upload_array(size, size, pages, pixels, TEXPACK_ATLAS_LEVELS - 1);
+
+    p->stats.atlas_pages = pages;
+    p->stats.atlas_textures = (int)count;
+    p->stats.bytes += mip_chain_bytes(size, size, pages, TEXPACK_ATLAS_LEVELS);
+
+    free(pixels);
+    free(items);
+    return 1;
+}
+
+/* =========================================================
+ * Budowa
+ * ========================================================= */
+
+static const TextureImage *g_sort_images; // qsort nie przyjmuje kontekstu
+
+/**
+ * @brief Porządek: rozmiar, potem indeks (stabilny przydział warstw).
+ */
+static int cmp_image_size(const void *a, const void *b)
+{
+    size_t ia = *(const size_t *)a, ib = *(const size_t *)b;
+    const TextureImage *x = &g_sort_images[ia], *y = &g_sort_images[ib];
+    if (x->width != y->width)
+        return x->width - y->width;
+    if (x->height != y->height)
+        return x->height - y->height;
+    return (ia > ib) - (ia < ib);
+}
+
+int texture_pack_build(TexturePack *p, const TextureImage *images, size_t count)
+{
+    memset(p, 0, sizeof(*p));
+    double t0 = now_ms();
+
+    p->entries = (TexturePackEntry *)calloc(count ? count : 1, sizeof(TexturePackEntry));
+    size_t *order = (size_t *)malloc((count ? count : 1) * sizeof(size_t));
+    size_t *singles = (size_t *)malloc((count ? count : 1) * sizeof(size_t));
+    if (!p->entries || !order || !singles) {
+        free(order);
+        free(singles);
+        texture_pack_destroy(p);
+        return 0;
+    }
+    p->entry_count = count;
+
+    size_t textured = 0;
+    for (size_t i = 0; i < count; i++)
+        if (images[i].pixels)
+            order[textured++] = i;
+    p->stats.textures = (int)textured;
+
+    // grupy o identycznym rozmiarze (wszystko jest wysyłane jako RGBA8)
+    g_sort_images = images;
+    qsort(order, textured, sizeof(size_t), cmp_image_size);
+
+    const int atlas_limit = TEXPACK_ATLAS_MAX - 2 * TEXPACK_PADDING;
+    size_t single_count = 0;
+    int ok = 1;
+    for (size_t i = 0; i < textured && ok;) {
+        const TextureImage *first = &images[order[i]];
+        size_t j = i + 1;
+        while (j < textured && images[order[j]].width == first->width &&
+               images[order[j]].height == first->height)
+            j++;
+
+        size_t layers = j - i;
+        if (layers == 1 && first->width <= atlas_limit && first->height <= atlas_limit) {
+            singles[single_count++] = order[i];
+            i = j;
+            continue;
+        }
+
+        size_t layer_bytes = (size_t)first->width * first->height * 4;
+        unsigned char *pixels = (unsigned char *)malloc(layer_bytes * layers);
+        TexturePackArray *a = pixels ? push_array(p) : NULL;
+        if (!a) {
+            free(pixels);
+            ok = 0;
+            break;
+        }
+        for (size_t k = 0; k < layers; k++) {
+            copy_rgba(pixels + layer_bytes * k, &images[order[i + k]]);
+            TexturePackEntry *e = &p->entries[order[i + k]];
+            e->array = p->array_count - 1;
+            e->layer = (float)k;
+            e->uv_scale[0] = e->uv_scale[1] = 1.0f;
+            e->uv_offset[0] = e->uv_offset[1] = 0.0f;
+        }
+
+        a->width = first->width;
+        a->height = first->height;
+        a->layers = (int)layers;
+        int levels = full_levels(a->width, a->height);
+        a->texture = upload_array(a->width, a->height, a->layers, pixels, levels - 1);
+        p->stats.arrays++;
+        p->stats.bytes += mip_chain_bytes(a->width, a->height, a->layers, levels);
+        free(pixels);
+        i = j;
+    }
+
+    // atlas jest zawsze tworzony: zawiera też biały fragment dla materiałów bez tekstury
+    if (ok)
+        ok = build_atlas(p, images, singles, single_count);
+
+    free(order);
+    free(singles);
+    if (!ok) {
+        printf("Texture packing failed (out of memory)\n");
+        texture_pack_destroy(p);
+        return 0;
+    }
+
+    p->stats.ms = now_ms() - t0;
+    return 1;
+}
+
+void texture_pack_destroy(TexturePack *p)
+{
+    for (int i = 0; i < p->array_count; i++)
+        if (p->arrays[i].texture)
+            glDeleteTextures(1, &p->arrays[i].texture);
+    free(p->arrays);
+    free(p->entries);
+    memset(p, 0, sizeof(*p));
+}
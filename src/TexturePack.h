@@ -0,0 +1,78 @@
+#pragma once
+#include <stddef.h>
+#include <glad/glad.h>
+
+#include "Material.h"
+
+#define TEXPACK_ATLAS_MAX 2048 // maksymalny bok strony atlasu
+#define TEXPACK_PADDING 8      // ramka wokół tekstury w atlasie (texele)
+#define TEXPACK_ATLAS_LEVELS 4 // mipmapy atlasu: poziomy 0..log2(TEXPACK_PADDING)
+
+/**
+ * @brief Gdzie trafiła tekstura materiału.
+ *
+ * Próbkowanie w shaderze: uv' = uv_offset + fract(uv) * uv_scale,
+ * warstwa layer tablicy array (textureGrad z pochodnymi * uv_scale).
+ */
+typedef struct TexturePackEntry
+{
+    int array;          // indeks w TexturePack.arrays
+    float layer;
+    float uv_scale[2];
+    float uv_offset[2];
+} TexturePackEntry;
+
+/**
+ * @brief Jedna tekstura GL_TEXTURE_2D_ARRAY (warstwy o wspólnym rozmiarze).
+ */
+typedef struct TexturePackArray
+{
+    GLuint texture;
+    int width, height;
+    int layers;
+    int atlas;          // 1 = strony atlasu (tekstury o nietypowych rozmiarach)
+} TexturePackArray;
+
+typedef struct TexturePackStats
+{
+    int textures;       // tekstury wejściowe (bez materiałów bez map_Kd)
+    int arrays;         // tablice tekstur z warstwami 1:1
+    int atlas_pages;
+    int atlas_textures; // tekstury umieszczone w atlasie
+    size_t bytes;       // pamięć GPU z mipmapami
+    double ms;
+} TexturePackStats;
+
+/**
+ * @brief Tekstury wielu materiałów upakowane w kilka tablic tekstur.
+ *
+ * Tekstury o tym samym rozmiarze trafiają do wspólnej tablicy (warstwa
+ * = tekstura). Pozostałe są układane półkami na stronach atlasu z ramką
+ * TEXPACK_PADDING powtarzającą brzegi (jak GL_REPEAT), dzięki czemu
+ * filtrowanie i pierwsze poziomy mip nie mieszają sąsiadów. Materiały
+ * bez tekstury dostają biały fragment atlasu — w shaderze nie ma
+ * osobnej ścieżki „bez tekstury”.
+ */
+typedef struct TexturePack
+{
+    TexturePackArray *arrays;
+    int array_count;
+    TexturePackEntry *entries; // jeden na obraz wejściowy
+    size_t entry_count;
+    TexturePackStats stats;
+} TexturePack;
+
+/**
+ * @brief Pakuje obrazy i wysyła tablice tekstur na GPU.
+ *
+ * @param p      Wynik.
+ * @param images Obrazy (pixels == NULL -> materiał bez tekstury).
+ * @param count  Liczba obrazów.
+ * @return 1 jeśli OK, 0 jeśli błąd alokacji.
+ */
+int texture_pack_build(TexturePack *p, const TextureImage *images, size_t count);
+
+/**
+ * @brief Usuwa tekstury i zwalnia pamięć.
+ */
+void texture_pack_destroy(TexturePack *p);
@@ -0,0 +1,587 @@
+#include "TextureStream.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TEXTURE_STREAM_MIN_DISTANCE 1.0e-4f
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+}
+
+/* =========================================================
+   Poziomy mip
+   ========================================================= */
+
+static int level_dim(int size, int level)
+{
+    int d = size >> level;
+    return d > 0 ? d : 1;
+}
+
+/**
+ * @brief Pamięć poziomu na GPU (RGB8 sterowniki i tak trzymają jako RGBA8).
+ */
+static size_t level_bytes(const StreamedTexture *t, int level)
+{
+    return (size_t)level_dim(t->width, level) * (size_t)level_dim(t->height, level) * 4;
+}
+
+/**
+ * @brief Pamięć poziomów [first, levels-1].
+ */
+static size_t chain_bytes(const StreamedTexture *t, int first)
+{
+    size_t sum = 0;
+    for (int l = first; l < t->levels; l++)
+        sum += level_bytes(t, l);
+    return sum;
+}
+
+/**
+ * @brief Poziom mip o połowę mniejszy (filtr pudełkowy 2x2).
+ */
+static void downsample(const unsigned char *src, int sw, int sh, unsigned char *dst, int dw, int dh, int ch)
+{
+    for (int y = 0; y < dh; y++)
+    {
+        int y0 = y * 2 < sh ? y * 2 : sh - 1;
+        int y1 = y * 2 + 1 < sh ? y * 2 + 1 : y0;
+        for (int x = 0; x < dw; x++)
+        {
+            int x0 = x * 2 < sw ? x * 2 : sw - 1;
+            int x1 = x * 2 + 1 < sw ? x * 2 + 1 : x0;
+            for (int c = 0; c < ch; c++)
+            {
+                int s = src[(y0 * sw + x0) * ch + c] + src[(y0 * sw + x1) * ch + c] +
+                        src[(y1 * sw + x0) * ch + c] + src[(y1 * sw + x1) * ch + c];
+                dst[(y * dw + x) * ch + c] = (unsigned char)((s + 2) / 4);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Łańcuch mip na CPU (jeden blok, poziomy od 0); bez GL, dowolny wątek.
+ */
+static unsigned char *build_chain(const TextureImage *img, int levels, size_t offsets[TEXTURE_STREAM_MAX_LEVELS])
+{
+    size_t total = 0;
+    for (int l = 0; l < levels; l++)
+    {
+        offsets[l] = total;
+        total += (size_t)level_dim(img->width, l) * (size_t)level_dim(img->height, l) * (size_t)img->channels;
+    }
+
+    unsigned char *chain = (unsigned char *)malloc(total);
+    if (!chain)
+        return NULL;
+
+    memcpy(chain, img->pixels, (size_t)img->width * (size_t)img->height * (size_t)img->channels);
+    for (int l = 1; l < levels; l++)
+        downsample(chain + offsets[l - 1], level_dim(img->width, l - 1), level_dim(img->height, l - 1),
+                   chain + offsets[l], level_dim(img->width, l), level_dim(img->height, l), img->channels);
+    return chain;
+}
+
+static void upload_level(const StreamedTexture *t, int level)
+{
+    GLenum format = t->channels == 3 ? GL_RGB : GL_RGBA;
+    glTexImage2D(GL_TEXTURE_2D, level, (GLint)format, level_dim(t->width, level), level_dim(t->height, level), 0,
+                 format, GL_UNSIGNED_BYTE, t->cpu + t->level_offset[level]);
+}
+
+/* =========================================================
+   Wątek I/O (bez GL)
+   ========================================================= */
+
+static void *io_thread_main(void *arg)
+{
+    TextureStreamer *ts = (TextureStreamer *)arg;
+
+    pthread_mutex_lock(&ts->lock);
+    while (!ts->quit)
+    {
+        // FIFO; wpisy usunięte lub już niepotrzebne są pomijane
+        int pick = -1;
+        while (ts->request_count > 0 && pick < 0)
+        {
+            int i = ts->requests[0];
+            memmove(ts->requests, ts->requests + 1, (ts->request_count - 1) * sizeof(int));
+            ts->request_count--;
+            if (ts->textures[i].used && ts->textures[i].state == TEX_STREAM_QUEUED)
+                pick = i;
+        }
+        if (pick < 0)
+        {
+            pthread_cond_wait(&ts->cond, &ts->lock);
+            continue;
+        }
+
+        StreamedTexture *t = &ts->textures[pick];
+        t->state = TEX_STREAM_LOADING;
+        StreamedTexture copy = *t;
+        pthread_mutex_unlock(&ts->lock);
+
+        double t0 = now_ms();
+        unsigned char *chain = NULL;
+        TextureImage img;
+        if (texture_image_load(copy.path, &img))
+        {
+            // plik zmieniony od dodania -> poziomy nie pasowałyby do ogona na GPU
+            if (img.width == copy.width && img.height == copy.height && img.channels == copy.channels)
+                chain = build_chain(&img, copy.levels, copy.level_offset);
+            else
+                printf("WARNING: %s changed size, streaming stopped at the current level\n", copy.path);
+            texture_image_free(&img);
+        }
+        double ms = now_ms() - t0;
+
+        pthread_mutex_lock(&ts->lock);
+        t = &ts->textures[pick]; // tablica mogła urosnąć
+        if (t->used && t->generation == copy.generation && t->state == TEX_STREAM_LOADING)
+        {
+            t->cpu = chain;
+            t->state = chain ? TEX_STREAM_CPU : TEX_STREAM_EMPTY;
+            t->failed = !chain;
+            ts->loads += chain != NULL;
+            ts->load_ms += chain ? ms : 0.0;
+        }
+        else
+        {
+            free(chain);
+        }
+    }
+    pthread_mutex_unlock(&ts->lock);
+    return NULL;
+}
+
+/* =========================================================
+   API
+   ========================================================= */
+
+int texture_streamer_init(TextureStreamer *ts, size_t gpu_budget, size_t upload_budget)
+{
+    memset(ts, 0, sizeof(*ts));
+    ts->gpu_budget = gpu_budget;
+    ts->upload_budget = upload_budget;
+
+    pthread_mutex_init(&ts->lock, NULL);
+    pthread_cond_init(&ts->cond, NULL);
+    if (pthread_create(&ts->thread, NULL, io_thread_main, ts) != 0)
+    {
+        printf("ERROR: cannot start the texture streaming thread\n");
+        pthread_cond_destroy(&ts->cond);
+        pthread_mutex_destroy(&ts->lock);
+        return 0;
+    }
+    ts->thread_started = 1;
+    return 1;
+}
+
+/**
+ * @brief Wolny wpis (pod lock: wątek I/O może właśnie czytać tablicę).
+ */
+static int alloc_slot(TextureStreamer *ts)
+{
+    for (int i = 0; i < ts->count; i++)
+        if (!ts->textures[i].used)
+            return i;
+
+    if (ts->count == ts->capacity)
+    {
+        int cap = ts->capacity ? ts->capacity * 2 : 32;
+        StreamedTexture *p = (StreamedTexture *)realloc(ts->textures, (size_t)cap * sizeof(*p));
+        if (!p)
+            return -1;
+        ts->textures = p;
+        ts->capacity = cap;
+    }
+    memset(&ts->textures[ts->count], 0, sizeof(StreamedTexture));
+    return ts->count++;
+}
+
+int texture_streamer_add(TextureStreamer *ts, const char *path, TextureImage *img)
+{
+    TextureImage local;
+    if (!img)
+    {
+        if (!texture_image_load(path, &local))
+            return -1;
+        img = &local;
+    }
+    if (!img->pixels)
+        return -1;
+
+    StreamedTexture t;
+    memset(&t, 0, sizeof(t));
+    snprintf(t.path, sizeof(t.path), "%s", path);
+    t.width = img->width;
+    t.height = img->height;
+    t.channels = img->channels;
+    int size = t.width > t.height ? t.width : t.height;
+    while (t.levels < TEXTURE_STREAM_MAX_LEVELS && (size >> t.levels) > 0)
+        t.levels++;
+    while (t.tail < t.levels - 1 && (size >> t.tail) > TEXTURE_STREAM_TAIL_SIZE)
+        t.tail++;
+
+    t.cpu = build_chain(img, t.levels, t.level_offset);
+    texture_image_free(img);
+    if (!t.cpu)
+        return -1;
+
+    // start: sam ogon łańcucha, drobniejsze poziomy dopiero na żądanie
+    glGenTextures(1, &t.id);
+    glBindTexture(GL_TEXTURE_2D, t.id);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int l = t.tail; l < t.levels; l++)
+        upload_level(&t, l);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, t.tail);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, t.levels - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    t.used = 1;
+    t.base = t.tail;
+    t.demand = t.wanted = t.tail;
+    t.last_used = ts->frame;
+    // łańcuch zostaje w RAM do pierwszej aktualizacji (zwykle zaraz potrzebny)
+    t.state = TEX_STREAM_CPU;
+    if (t.tail == 0)
+    {
+        free(t.cpu);
+        t.cpu = NULL;
+        t.state = TEX_STREAM_EMPTY;
+    }
+
+    pthread_mutex_lock(&ts->lock);
+    int h = alloc_slot(ts);
+    if (h >= 0)
+    {
+        t.generation = ts->textures[h].generation;
+        ts->textures[h] = t;
+        ts->gpu_used += chain_bytes(&t, t.base);
+    }
+    pthread_mutex_unlock(&ts->lock);
+
+    if (h < 0)
+    {
+        glDeleteTextures(1, &t.id);
+        free(t.cpu);
+    }
+    return h;
+}
+
+static StreamedTexture *get(const TextureStreamer *ts, int handle)
+{
+    if (handle < 0 || handle >= ts->count || !ts->textures[handle].used)
+        return NULL;
+    return &ts->textures[handle];
+}
+
+GLuint texture_streamer_texture(const TextureStreamer *ts, int handle)
+{
+    const StreamedTexture *t = get(ts, handle);
+    return t ? t->id : 0;
+}
+
+void texture_streamer_remove(TextureStreamer *ts, int handle)
+{
+    pthread_mutex_lock(&ts->lock);
+    StreamedTexture *t = get(ts, handle);
+    if (t)
+    {
+        glDeleteTextures(1, &t->id);
+        ts->gpu_used -= chain_bytes(t, t->base);
+        // w trakcie wczytywania dane zwolni wątek I/O (inna generacja)
+        if (t->state != TEX_STREAM_LOADING)
+            free(t->cpu);
+        unsigned generation = t->generation + 1;
+        memset(t, 0, sizeof(*t));
+        t->generation = generation;
+    }
+    pthread_mutex_unlock(&ts->lock);
+}
+
+void texture_streamer_begin_frame(TextureStreamer *ts)
+{
+    ts->frame++;
+    for (int i = 0; i < ts->count; i++)
+        ts->textures[i].demand = ts->textures[i].tail;
+}
+
+void texture_streamer_request(TextureStreamer *ts, int handle, float uv_density, const float bmin[3],
+                              const float bmax[3], const float cam_model[3], float pixels_per_unit)
+{
+    StreamedTexture *t = get(ts, handle);
+    if (!t)
+        return;
+    t->last_used = ts->frame;
+    if (uv_density <= 0.0f || pixels_per_unit <= 0.0f)
+        return;
+
+    // najbliższy punkt AABB: tam tekstura jest największa na ekranie
+    float d2 = 0.0f;
+    for (int k = 0; k < 3; k++)
+    {
+        float d = 0.0f;
+        if (cam_model[k] < bmin[k])
+            d = bmin[k] - cam_model[k];
+        else if (cam_model[k] > bmax[k])
+            d = cam_model[k] - bmax[k];
+        d2 += d * d;
+    }
+    float distance = sqrtf(d2);
+    if (distance < TEXTURE_STREAM_MIN_DISTANCE)
+        distance = TEXTURE_STREAM_MIN_DISTANCE;
+
+    // texele poziomu 0 na piksel ekranu -> każdy poziom mip to połowa
+    float size = (float)(t->width > t->height ? t->width : t->height);
+    float texelsPerPixel = uv_density * size * distance / pixels_per_unit;
+    int level = texelsPerPixel > 1.0f ? (int)floorf(log2f(texelsPerPixel)) : 0;
+    if (level < t->demand)
+        t->demand = level;
+}
+
+/**
+ * @brief Zwalnia najdrobniejszy poziom tekstury (poza zakresem BASE_LEVEL).
+ */
+static void evict_level(TextureStreamer *ts, StreamedTexture *t)
+{
+    int level = t->base;
+    glBindTexture(GL_TEXTURE_2D, t->id);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level + 1);
+    glTexImage2D(GL_TEXTURE_2D, level, t->channels == 3 ? GL_RGB : GL_RGBA, 0, 0, 0,
+                 t->channels == 3 ? GL_RGB : GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    t->base = level + 1;
+    ts->gpu_used -= level_bytes(t, level);
+    ts->evictions++;
+}
+
+/**
+ * @brief Robi miejsce na bytes, zwalniając niechciane poziomy najdawniej używanych tekstur.
+ *
+ * @return 1 jeśli się zmieści, 0 jeśli zostały same chciane poziomy.
+ */
+static int make_room(TextureStreamer *ts, size_t bytes)
+{
+    while (ts->gpu_used + bytes > ts->gpu_budget)
+    {
+        StreamedTexture *victim = NULL;
+        for (int i = 0; i < ts->count; i++)
+        {
+            StreamedTexture *t = &ts->textures[i];
+            if (!t->used || t->base >= t->wanted)
+                continue;
+            if (!victim || t->last_used < victim->last_used)
+                victim = t;
+        }
+        if (!victim)
+            return 0;
+        evict_level(ts, victim);
+    }
+    return 1;
+}
+
+size_t texture_streamer_update(TextureStreamer *ts)
+{
+    /* ---- żądania klatki -> poziomy chciane w budżecie ---- */
+    size_t need = 0;
+    for (int i = 0; i < ts->count; i++)
+    {
+        StreamedTexture *t = &ts->textures[i];
+        if (!t->used)
+            continue;
+        // nieużywane w tej klatce nie chcą niczego ponad ogon (ich poziomy zwolni LRU)
+        t->wanted = t->last_used == ts->frame ? t->demand : t->tail;
+        if (t->failed && t->wanted < t->base)
+            t->wanted = t->base;
+        need += chain_bytes(t, t->wanted);
+    }
+    if (need > ts->gpu_budget)
+        ts->over_budget++;
+    while (need > ts->gpu_budget)
+    {
+        // obniż teksturę, której najdrobniejszy chciany poziom jest największy
+        StreamedTexture *worst = NULL;
+        for (int i = 0; i < ts->count; i++)
+        {
+            StreamedTexture *t = &ts->textures[i];
+            if (t->used && t->wanted < t->tail &&
+                (!worst || level_bytes(t, t->wanted) > level_bytes(worst, worst->wanted)))
+                worst = t;
+        }
+        if (!worst)
+            break;
+        need -= level_bytes(worst, worst->wanted);
+        worst->wanted++;
+    }
+
+    /* ---- wczytanie i wysłanie brakujących poziomów ---- */
+    size_t uploaded = 0, levels = 0;
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int i = 0; i < ts->count && uploaded < ts->upload_budget; i++)
+    {
+        StreamedTexture *t = &ts->textures[i];
+        if (!t->used || t->wanted >= t->base)
+            continue;
+
+        pthread_mutex_lock(&ts->lock);
+        int state = t->state;
+        if (state == TEX_STREAM_EMPTY)
+        {
+            if (ts->request_count == ts->request_capacity)
+            {
+                size_t cap = ts->request_capacity ? ts->request_capacity * 2 : 64;
+                int *p = (int *)realloc(ts->requests, cap * sizeof(int));
+                if (p)
+                {
+                    ts->requests = p;
+                    ts->request_capacity = cap;
+                }
+            }
+            if (ts->request_count < ts->request_capacity)
+            {
+                ts->requests[ts->request_count++] = i;
+                t->state = TEX_STREAM_QUEUED;
+                pthread_cond_signal(&ts->cond);
+            }
+        }
+        pthread_mutex_unlock(&ts->lock);
+        if (state != TEX_STREAM_CPU)
+            continue;
+
+        // od najgrubszego brakującego: obraz ostrzeje stopniowo
+        while (t->wanted < t->base)
+        {
+            size_t bytes = level_bytes(t, t->base - 1);
+            if (uploaded > 0 && uploaded + bytes > ts->upload_budget)
+                break;
+            if (!make_room(ts, bytes))
+                break;
+            glBindTexture(GL_TEXTURE_2D, t->id);
+            upload_level(t, t->base - 1);
+            t->base--;
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, t->base);
+            ts->gpu_used += bytes;
+            ts->uploads++;
+            ts->upload_bytes += bytes;
+            uploaded += bytes;
+            levels++;
+        }
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    /* ---- łańcuchy CPU, które nie mają już nic do wysłania ---- */
+    pthread_mutex_lock(&ts->lock);
+    for (int i = 0; i < ts->count; i++)
+    {
+        StreamedTexture *t = &ts->textures[i];
+        if (t->used && t->state == TEX_STREAM_CPU && t->base <= t->wanted)
+        {
+            free(t->cpu);
+            t->cpu = NULL;
+            t->state = TEX_STREAM_EMPTY;
+        }
+    }
+    pthread_mutex_unlock(&ts->lock);
+    return levels;
+}
+
+int texture_streamer_busy(TextureStreamer *ts)
+{
+    int busy = 0;
+    pthread_mutex_lock(&ts->lock);
+    for (int i = 0; i < ts->count && !busy; i++)
+    {
+        const StreamedTexture *t = &ts->textures[i];
+        busy = t->used && t->wanted < t->base && t->state != TEX_STREAM_EMPTY;
+    }
+    pthread_mutex_unlock(&ts->lock);
+    return busy;
+}
+
+float texture_stream_uv_density(const Vertex *vertices, const unsigned int *indices, size_t index_count)
+{
+    double uvArea = 0.0, area = 0.0;
+    for (size_t i = 0; i + 2 < index_count; i += 3)
+    {
+        const Vertex *a = &vertices[indices[i]], *b = &vertices[indices[i + 1]], *c = &vertices[indices[i + 2]];
+
+        float e1[3], e2[3];
+        for (int k = 0; k < 3; k++)
+        {
+            e1[k] = b->position[k] - a->position[k];
+            e2[k] = c->position[k] - a->position[k];
+        }
+        double cx = (double)e1[1] * e2[2] - (double)e1[2] * e2[1];
+        double cy = (double)e1[2] * e2[0] - (double)e1[0] * e2[2];
+        double cz = (double)e1[0] * e2[1] - (double)e1[1] * e2[0];
+        area += 0.5 * sqrt(cx * cx + cy * cy + cz * cz);
+
+        double u1 = b->texcoord[0] - a->texcoord[0], v1 = b->texcoord[1] - a->texcoord[1];
+        double u2 = c->texcoord[0] - a->texcoord[0], v2 = c->texcoord[1] - a->texcoord[1];
+        uvArea += 0.5 * fabs(u1 * v2 - u2 * v1);
+    }
+    return area > 0.0 ? (float)sqrt(uvArea / area) : 0.0f;
+}
+
+void texture_streamer_print_stats(TextureStreamer *ts)
+{
+    pthread_mutex_lock(&ts->lock);
+    int live = 0, full = 0, cpu = 0;
+    size_t pending = ts->request_count;
+    for (int i = 0; i < ts->count; i++)
+    {
+        const StreamedTexture *t = &ts->textures[i];
+        if (!t->used)
+            continue;
+        live++;
+        full += t->base == 0;
+        cpu += t->state == TEX_STREAM_CPU;
+    }
+    printf("[texstream] %d textures (%d at full resolution, %d mip chains in RAM, %zu queued) | "
+           "GPU %.1f / %.1f MB\n",
+           live, full, cpu, pending, ts->gpu_used / 1048576.0, ts->gpu_budget / 1048576.0);
+    printf("[texstream] %zu levels uploaded (%.1f MB), %zu evicted, %zu files decoded (%.1f ms avg), "
+           "%zu frames over budget\n",
+           ts->uploads, ts->upload_bytes / 1048576.0, ts->evictions, ts->loads,
+           ts->loads ? ts->load_ms / (double)ts->loads : 0.0, ts->over_budget);
+    pthread_mutex_unlock(&ts->lock);
+}
+
+void texture_streamer_destroy(TextureStreamer *ts)
+{
+    if (ts->thread_started)
+    {
+        pthread_mutex_lock(&ts->lock);
+        ts->quit = 1;
+        pthread_cond_signal(&ts->cond);
+        pthread_mutex_unlock(&ts->lock);
+        pthread_join(ts->thread, NULL);
+        pthread_cond_destroy(&ts->cond);
+        pthread_mutex_destroy(&ts->lock);
+    }
+    for (int i = 0; i < ts->count; i++)
+    {
+        StreamedTexture *t = &ts->textures[i];
+        if (!t->used)
+            continue;
+        glDeleteTextures(1, &t->id);
+        free(t->cpu);
+    }
+    free(ts->textures);
+    free(ts->requests);
+    memset(ts, 0, sizeof(*ts));
+}
@@ -0,0 +1,174 @@
+#pragma once
+#include <stddef.h>
+#include <pthread.h>
+#include <glad/glad.h>
+
+#include "Material.h"
+#include "Mesh.h"
+
+#define TEXTURE_STREAM_MAX_LEVELS 16
+#define TEXTURE_STREAM_TAIL_SIZE 64 // poziomy nie większe niż 64x64 są zawsze na GPU
+
+/**
+ * @brief Stan danych CPU tekstury (łańcuch mip w RAM).
+ */
+typedef enum TextureStreamState
+{
+    TEX_STREAM_EMPTY = 0, // brak danych w RAM
+    TEX_STREAM_QUEUED,    // w kolejce wątku I/O
+    TEX_STREAM_LOADING,   // wątek I/O dekoduje plik
+    TEX_STREAM_CPU        // łańcuch mip w RAM, czeka na wysłanie
+} TextureStreamState;
+
+/**
+ * @brief Tekstura strumieniowana.
+ *
+ * Na GPU są poziomy [base, levels-1]; [tail, levels-1] są tam zawsze.
+ * Poziomy drobniejsze niż base są zwolnione (glTexImage2D 0x0) i poza
+ * zakresem GL_TEXTURE_BASE_LEVEL, więc tekstura jest kompletna.
+ */
+typedef struct StreamedTexture
+{
+    int used;
+    unsigned generation;      // rośnie przy usunięciu (wynik wątku I/O dla starego wpisu jest odrzucany)
+    char path[256];
+    GLuint id;
+    int width, height, channels;
+    int levels;
+    int tail;                 // pierwszy poziom zawsze obecny
+    int base;                 // najdrobniejszy poziom na GPU (GL_TEXTURE_BASE_LEVEL)
+    int demand;               // najdrobniejszy poziom z zapytań tej klatki
+    int wanted;               // demand po dopasowaniu do budżetu
+    unsigned long last_used;  // klatka ostatniego zapytania (LRU)
+
+    int state;                // TextureStreamState (chroniony lock)
+    int failed;               // ponowne wczytanie się nie udało: zostają obecne poziomy
+    unsigned char *cpu;       // łańcuch mip (TEX_STREAM_CPU)
+    size_t level_offset[TEXTURE_STREAM_MAX_LEVELS];
+} StreamedTexture;
+
+/**
+ * @brief Strumieniowanie poziomów mip tekstur pod stałym budżetem VRAM.
+ *
+ * Tekstura startuje z samym ogonem łańcucha mip (do 64x64). Co klatkę
+ * wołający zgłasza dla każdego użycia gęstość UV siatki i jej AABB;
+ * potrzebny poziom to log2(texele na piksel) przy odległości kamery od
+ * AABB. Potem texture_streamer_update() na wątku głównym:
+ *  - obcina żądania do budżetu GPU (najpierw obniżany jest poziom
+ *    tekstury o największym brakującym poziomie),
+ *  - brakujące dane zleca wątkowi I/O (dekodowanie pliku + mipmapy
+ *    na CPU, bez GL),
+ *  - wysyła gotowe poziomy po jednym, od najgrubszego, z limitem bajtów
+ *    na klatkę, i przesuwa GL_TEXTURE_BASE_LEVEL,
+ *  - gdy brakuje miejsca, zwalnia niepotrzebne poziomy tekstur używanych
+ *    najdawniej (LRU).
+ *
+ * Łańcuch mip w RAM jest zwalniany, gdy wszystkie chciane poziomy są na
+ * GPU; przybliżenie kamery wczytuje plik ponownie w tle.
+ */
+typedef struct TextureStreamer
+{
+    StreamedTexture *textures; // chronione lock (wątek I/O czyta path i zapisuje cpu/state)
+    int count;
+    int capacity;
+
+    size_t gpu_budget;
+    size_t gpu_used;           // poziomy na GPU (szacunek: 4 bajty na texel)
+    size_t upload_budget;      // bajty wysyłane w jednej klatce
+    unsigned long frame;
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int thread_started;
+    int quit;
+    int *requests;             // indeksy tekstur do wczytania (FIFO)
+    size_t request_count;
+    size_t request_capacity;
+
+    /* statystyki */
+    size_t uploads;
+    size_t upload_bytes;
+    size_t evictions;
+    size_t loads;
+    double load_ms;            // wątek I/O: dekodowanie + mipmapy
+    size_t over_budget;        // klatki, w których żądania obcięto do budżetu
+} TextureStreamer;
+
+/**
+ * @brief Uruchamia wątek I/O (bez wywołań GL).
+ *
+ * @param ts            Streamer.
+ * @param gpu_budget    Budżet VRAM tekstur (bajty).
+ * @param upload_budget Bajty wysyłane na GPU w jednej klatce.
+ * @return 1 jeśli OK, 0 jeśli błąd.
+ */
+int texture_streamer_init(TextureStreamer *ts, size_t gpu_budget, size_t upload_budget);
+
+/**
+ * @brief Dodaje teksturę z pliku; na GPU trafia od razu ogon łańcucha mip.
+ *
+ * @param ts   Streamer.
+ * @param path Plik obrazu (wczytywany ponownie przy potrzebie drobniejszych poziomów).
+ * @param img  Już zdekodowany obraz (przejmowany i zwalniany) albo NULL.
+ * @return Uchwyt (>= 0) albo -1, jeśli obrazu nie da się wczytać.
+ */
+int texture_streamer_add(TextureStreamer *ts, const char *path, TextureImage *img);
+
+/**
+ * @brief Nazwa tekstury GL (stała przez cały czas życia uchwytu).
+ */
+GLuint texture_streamer_texture(const TextureStreamer *ts, int handle);
+
+/**
+ * @brief Usuwa teksturę (GL i dane CPU).
+ */
+void texture_streamer_remove(TextureStreamer *ts, int handle);
+
+/**
+ * @brief Zaczyna zbieranie zapytań klatki.
+ */
+void texture_streamer_begin_frame(TextureStreamer *ts);
+
+/**
+ * @brief Zapytanie o teksturę użytą na siatce w tej klatce.
+ *
+ * @param ts              Streamer.
+ * @param handle          Uchwyt tekstury.
+ * @param uv_density      Jednostki UV na jednostkę modelu (texture_stream_uv_density()).
+ * @param bmin            AABB siatki (przestrzeń modelu).
+ * @param bmax
+ * @param cam_model       Pozycja kamery w przestrzeni modelu.
+ * @param pixels_per_unit Piksele na jednostkę w odległości 1 (wysokość / (2 tg(fov/2))).
+ */
+void texture_streamer_request(TextureStreamer *ts, int handle, float uv_density, const float bmin[3],
+                              const float bmax[3], const float cam_model[3], float pixels_per_unit);
+
+/**
+ * @brief Budżet, kolejka I/O, wysyłanie i zwalnianie poziomów (wątek główny, GL).
+ *
+ * @return Liczba poziomów wysłanych w tej klatce (0 = bez zmian).
+ */
+size_t texture_streamer_update(TextureStreamer *ts);
+
+/**
+ * @brief Czy zostały poziomy do wczytania lub wysłania (tryb on-demand).
+ */
+int texture_streamer_busy(TextureStreamer *ts);
+
+/**
+ * @brief Średnia gęstość UV siatki: sqrt(pole UV / pole trójkątów w modelu).
+ *
+ * @return Jednostki UV na jednostkę modelu (0 dla siatki bez UV).
+ */
+float texture_stream_uv_density(const Vertex *vertices, const unsigned int *indices, size_t index_count);
+
+/**
+ * @brief Wypisuje pamięć, poziomy tekstur i liczniki.
+ */
+void texture_streamer_print_stats(TextureStreamer *ts);
+
+/**
+ * @brief Zatrzymuje wątek I/O i usuwa wszystkie tekstury.
+ */
+void texture_streamer_destroy(TextureStreamer *ts);
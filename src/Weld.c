@@ -0,0 +1,398 @@
+#include "Weld.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#define WELD_MAX_THREADS 64
+#define WELD_MIN_VERTS_PER_THREAD 65536
+
+/* =========================================================
+   Dane wątków
+   ========================================================= */
+
+typedef struct WeldJob
+{
+    const Vertex *verts;
+    size_t begin, end; // zakres wierzchołków albo indeksów
+
+    /* siatka */
+    float inv_cell;
+    uint32_t table_mask;
+    const uint32_t *bucket_start; // CSR: kubełek -> wierzchołki (rosnąco)
+    const uint32_t *bucket_verts;
+    uint32_t *bucket;             // kubełek każdego wierzchołka
+
+    /* tolerancje */
+    float eps2;
+    float cos_angle;
+    float uv_eps;
+
+    uint32_t *first;              // najmniejszy zgodny indeks
+    unsigned int *indices;        // przemapowanie indeksów
+    const uint32_t *remap;
+} WeldJob;
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+}
+
+static int cpu_count(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return (int)si.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+static uint64_t mix_u64(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+/* =========================================================
+   Siatka przestrzenna
+   ========================================================= */
+
+static int32_t cell_coord(float p, float inv_cell)
+{
+    float c = floorf(p * inv_cell);
+    if (c < -2147483000.0f) return -2147483000;
+    if (c > 2147483000.0f) return 2147483000;
+    return (int32_t)c;
+}
+
+static uint32_t cell_bucket(int32_t x, int32_t y, int32_t z, uint32_t mask)
+{
+    uint64_t h = mix_u64(((uint64_t)(uint32_t)x * 73856093u) ^
+                         ((uint64_t)(uint32_t)y * 19349663u << 21) ^
+                         ((uint64_t)(uint32_t)z * 83492791u << 42));
+    return (uint32_t)h & mask;
+}
+
+static int compatible(const WeldJob *j, const Vertex *a, const Vertex *b)
+{
+    float dx = a->position[0] - b->position[0];
+    float dy = a->position[1] - b->position[1];
+    float dz = a->position[2] - b->position[2];
+    if (dx * dx + dy * dy + dz * dz > j->eps2)
+        return 0;
+
+    if (fabsf(a->texcoord[0] - b->texcoord[0]) > j->uv_eps ||
+        fabsf(a->texcoord[1] - b->texcoord[1]) > j->uv_eps)
+        return 0;
+
+    // normalne z pliku nie muszą być jednostkowe
+    float d = a->normal[0] * b->normal[0] + a->normal[1] * b->normal[1] + a->normal[2] * b->normal[2];
+    float la = a->normal[0] * a->normal[0] + a->normal[1] * a->normal[1] + a->normal[2] * a->normal[2];
+    float lb = b->normal[0] * b->normal[0] + b->normal[1] * b->normal[1] + b->normal[2] * b->normal[2];
+    if (la == 0.0f || lb == 0.0f)
+        return la == lb;
+    return d >= j->cos_angle * sqrtf(la * lb);
+}
+
+static void *bucket_main(void *arg)
+{
+    WeldJob *j = (WeldJob *)arg;
+    for (size_t i = j->begin; i < j->end; i++)
+    {
+        const float *p = j->verts[i].position;
+        j->bucket[i] = cell_bucket(cell_coord(p[0], j->inv_cell), cell_coord(p[1], j->inv_cell),
+                                   cell_coord(p[2], j->inv_cell), j->table_mask);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Dla każdego wierzchołka najmniejszy zgodny indeks z 8 komórek.
+ *
+ * Komórka ma bok 2 * eps, więc sąsiad w odległości eps leży w komórce
+ * wierzchołka albo w sąsiedniej po stronie bliższej ściany — na każdej
+ * osi wystarczą 2 komórki zamiast 3.
+ */
+static void *search_main(void *arg)
+{
+    WeldJob *j = (WeldJob *)arg;
+    for (size_t i = j->begin; i < j->end; i++)
+    {
+        const Vertex *v = &j->verts[i];
+        int32_t c[3], side[3];
+        for (int a = 0; a < 3; a++)
+        {
+            float p = v->position[a] * j->inv_cell;
+            c[a] = cell_coord(v->position[a], j->inv_cell);
+            side[a] = (p - floorf(p) < 0.5f) ? -1 : 1;
+        }
+        uint32_t best = (uint32_t)i;
+
+        for (int dz = 0; dz < 2; dz++)
+            for (int dy = 0; dy < 2; dy++)
+                for (int dx = 0; dx < 2; dx++)
+                {
+                    uint32_t b = cell_bucket(c[0] + dx * side[0], c[1] + dy * side[1],
+                                             c[2] + dz * side[2], j->table_mask);
+                    for (uint32_t k = j->bucket_start[b]; k < j->bucket_start[b + 1]; k++)
+                    {
+                        uint32_t u = j->bucket_verts[k];
+                        if (u >= best)
+                            break; // kubełki są rosnące
+                        if (compatible(j, v, &j->verts[u]))
+                        {
+                            best = u;
+                            break;
+                        }
+                    }
+                }
+        j->first[i] = best;
+    }
+    return NULL;
+}
+
+static void *remap_main(void *arg)
+{
+    WeldJob *j = (WeldJob *)arg;
+    for (size_t k = j->begin; k < j->end; k++)
+        j->indices[k] = j->remap[j->indices[k]];
+    return NULL;
+}
+
+/**
+ * @brief Uruchamia fn na wszystkich zadaniach; zadanie 0 na bieżącym wątku.
+ */
+static void run_jobs(WeldJob *jobs, int count, void *(*fn)(void *))
+{
+    pthread_t th[WELD_MAX_THREADS];
+    int started[WELD_MAX_THREADS] = {0};
+
+    for (int i = 1; i < count; i++)
+        started[i] = pthread_create(&th[i], NULL, fn, &jobs[i]) == 0;
+    fn(&jobs[0]);
+    for (int i = 1; i < count; i++)
+    {
+        if (started[i])
+            pthread_join(th[i], NULL);
+        else
+            fn(&jobs[i]); // brak wątku -> licz na bieżącym
+    }
+}
+
+static void split_range(WeldJob *jobs, int threads, size_t count)
+{
+    for (int i = 0; i < threads; i++)
+    {
+        jobs[i].begin = count * (size_t)i / (size_t)threads;
+        jobs[i].end = count * (size_t)(i + 1) / (size_t)threads;
+    }
+}
+
+/**
+ * @brief Usuwa trójkąty z powtórzonym indeksem, poprawia zakresy usemtl.
+ */
+static size_t drop_degenerate(ObjModelData *data)
+{
+    unsigned int *idx = data->indices;
+    size_t out = 0;
+    ObjSubmesh whole = {"", 0, data->index_count};
+    ObjSubmesh *ranges = data->submesh_count ? data->submeshes : &whole;
+    size_t rangeCount = data->submesh_count ? data->submesh_count : 1;
+
+    for (size_t r = 0; r < rangeCount; r++)
+    {
+        size_t begin = ranges[r].index_offset;
+        size_t end = begin + ranges[r].index_count;
+        ranges[r].index_offset = out;
+        for (size_t k = begin; k + 2 < end; k += 3)
+        {
+            unsigned int a = idx[k], b = idx[k + 1], c = idx[k + 2];
+            if (a == b || b == c || a == c)
+                continue;
+            idx[out++] = a;
+            idx[out++] = b;
+            idx[out++] = c;
+        }
+        ranges[r].index_count = out - ranges[r].index_offset;
+    }
+    data->index_count = out;
+    return out;
+}
+
+/* =========================================================
+   API
+   ========================================================= */
+
+WeldParams weld_params_default(void)
+{
+    WeldParams p;
+    p.position_eps = 0.0f;
+    p.normal_angle = 10.0f;
+    p.uv_eps = 1.0e-3f;
+    p.threads = 0;
+    return p;
+}
+
+int weld_model(ObjModelData *data, const WeldParams *params, WeldStats *stats)
+{
+    double t0 = now_ms();
+    WeldParams prm = params ? *params : weld_params_default();
+    WeldStats st = {0};
+    size_t vcount = data->vertex_count;
+
+    st.vertices_before = st.vertices_after = vcount;
+    st.triangles_before = st.triangles_after = data->index_count / 3;
+    if (stats)
+        *stats = st;
+    if (prm.position_eps <= 0.0f || vcount == 0)
+        return 1;
+    if (vcount >= UINT32_MAX / 2)
+    {
+        printf("ERROR: mesh too large for welding\n");
+        return 0;
+    }
+
+    int threads = prm.threads > 0 ? prm.threads : cpu_count();
+    size_t maxUseful = 1 + vcount / WELD_MIN_VERTS_PER_THREAD;
+    if ((size_t)threads > maxUseful) threads = (int)maxUseful;
+    if (threads > WELD_MAX_THREADS) threads = WELD_MAX_THREADS;
+    if (threads < 1) threads = 1;
+
+    uint32_t tableSize = 1024;
+    while (tableSize < vcount * 2)
+        tableSize *= 2;
+
+    uint32_t *bucket = (uint32_t *)malloc(vcount * sizeof(uint32_t));
+    uint32_t *start = (uint32_t *)calloc((size_t)tableSize + 1, sizeof(uint32_t));
+    uint32_t *verts = (uint32_t *)malloc(vcount * sizeof(uint32_t));
+    uint32_t *cursor = (uint32_t *)malloc((size_t)tableSize * sizeof(uint32_t));
+    uint32_t *first = (uint32_t *)malloc(vcount * sizeof(uint32_t));
+    WeldJob *jobs = (WeldJob *)calloc((size_t)threads, sizeof(WeldJob));
+    int ok = bucket && start && verts && cursor && first && jobs;
+
+    if (ok)
+    {
+        float angle = prm.normal_angle < 0.0f ? 0.0f : (prm.normal_angle > 180.0f ? 180.0f : prm.normal_angle);
+        for (int i = 0; i < threads; i++)
+        {
+            WeldJob *j = &jobs[i];
+            j->verts = data->vertices;
+            j->inv_cell = 0.5f / prm.position_eps;
+            j->table_mask = tableSize - 1;
+            j->bucket_start = start;
+            j->bucket_verts = verts;
+            j->bucket = bucket;
+            j->eps2 = prm.position_eps * prm.position_eps;
+            j->cos_angle = cosf(angle * 3.14159265f / 180.0f);
+            j->uv_eps = prm.uv_eps;
+            j->first = first;
+        }
+
+        split_range(jobs, threads, vcount);
+        run_jobs(jobs, threads, bucket_main);
+
+        // CSR kubełków (zliczanie, O(n)); wierzchołki w kubełku rosnąco
+        for (size_t i = 0; i < vcount; i++)
+            start[bucket[i] + 1]++;
+        for (uint32_t b = 0; b < tableSize; b++)
+            start[b + 1] += start[b];
+        memcpy(cursor, start, (size_t)tableSize * sizeof(uint32_t));
+        for (size_t i = 0; i < vcount; i++)
+            verts[cursor[bucket[i]]++] = (uint32_t)i;
+
+        run_jobs(jobs, threads, search_main);
+    }
+
+    if (ok)
+    {
+        // reprezentant: tylko gdy wierzchołek mieści się w jego tolerancji
+        Vertex *v = data->vertices;
+        uint32_t *remap = bucket; // ponowne użycie: nowy indeks wierzchołka
+        for (size_t i = 0; i < vcount; i++)
+        {
+            uint32_t r = first[i];
+            if (r == i)
+                continue;
+            uint32_t rep = first[r]; // r < i: już rozstrzygnięty
+            first[i] = (rep == r || compatible(&jobs[0], &v[i], &v[rep])) ? rep : (uint32_t)i;
+        }
+
+        // kompaktowanie z zachowaniem kolejności (next <= i: kopiowanie w przód)
+        uint32_t next = 0;
+        for (size_t i = 0; i < vcount; i++)
+        {
+            if (first[i] == i)
+            {
+                remap[i] = next;
+                v[next++] = v[i];
+            }
+            else
+            {
+                remap[i] = remap[first[i]];
+            }
+        }
+
+        for (int i = 0; i < threads; i++)
+        {
+            jobs[i].indices = data->indices;
+            jobs[i].remap = remap;
+        }
+        split_range(jobs, threads, data->index_count);
+        run_jobs(jobs, threads, remap_main);
+
+        data->vertex_count = next;
+        Vertex *shrunk = (Vertex *)realloc(data->vertices, (next ? next : 1) * sizeof(Vertex));
+        if (shrunk)
+            data->vertices = shrunk;
+        drop_degenerate(data);
+    }
+
+    free(bucket);
+    free(start);
+    free(verts);
+    free(cursor);
+    free(first);
+    free(jobs);
+
+    if (!ok)
+    {
+        printf("ERROR: out of memory while welding vertices\n");
+        return 0;
+    }
+
+    st.vertices_after = data->vertex_count;
+    st.triangles_after = data->index_count / 3;
+    st.bytes_saved = (st.vertices_before - st.vertices_after) * sizeof(Vertex) +
+                     (st.triangles_before - st.triangles_after) * 3 * sizeof(unsigned int);
+    st.threads = threads;
+    st.ms = now_ms() - t0;
+    if (stats)
+        *stats = st;
+    return 1;
+}
+
+void weld_print_stats(const WeldStats *s)
+{
+    printf("[weld] %zu -> %zu vertices, %zu -> %zu triangles, %.1f KB saved in %.1f ms, %d threads\n",
+           s->vertices_before, s->vertices_after, s->triangles_before, s->triangles_after,
+           (double)s->bytes_saved / 1024.0, s->ms, s->threads);
+}
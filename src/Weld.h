@@ -0,0 +1,58 @@
+#pragma once
+#include <stddef.h>
+#include "ObjLoader.h"
+
+/**
+ * @brief Tolerancje scalania wierzchołków.
+ */
+typedef struct WeldParams
+{
+    float position_eps; // maksymalna odległość pozycji (<= 0 -> scalanie wyłączone)
+    float normal_angle; // stopnie; maksymalny kąt między normalnymi
+    float uv_eps;       // maksymalna różnica każdej współrzędnej UV
+    int threads;        // 0 -> liczba rdzeni
+} WeldParams;
+
+/**
+ * @brief Wynik scalania (do logów / porównań).
+ */
+typedef struct WeldStats
+{
+    size_t vertices_before;
+    size_t vertices_after;
+    size_t triangles_before;
+    size_t triangles_after; // bez zdegenerowanych
+    size_t bytes_saved;     // VBO + EBO
+    int threads;
+    double ms;
+} WeldStats;
+
+/**
+ * @brief Domyślne parametry: scalanie wyłączone, 10°, UV 1e-3, wszystkie rdzenie.
+ */
+WeldParams weld_params_default(void);
+
+/**
+ * @brief Scala wierzchołki bliższe niż position_eps o zgodnych normalnych i UV.
+ *
+ * Siatka przestrzenna o boku 2 * position_eps (kubełki haszowane), więc
+ * kandydaci są tylko w 8 komórkach najbliższych wierzchołkowi.
+ * Wyszukiwanie idzie równolegle: każdy wierzchołek znajduje najmniejszy
+ * zgodny indeks,
+ * a przejście w kolejności indeksów przypisuje reprezentanta tylko
+ * wtedy, gdy wierzchołek mieści się w tolerancji samego reprezentanta
+ * (bez łańcuchów dryfujących poza epsilon). Wierzchołki są kompaktowane
+ * z zachowaniem kolejności, indeksy przemapowane, trójkąty zdegenerowane
+ * usunięte (zakresy usemtl poprawione).
+ *
+ * @param data   Model (modyfikowany w miejscu).
+ * @param params Parametry (NULL -> domyślne, czyli bez zmian).
+ * @param stats  Statystyki (może być NULL).
+ * @return 1 jeśli OK, 0 jeśli błąd alokacji (dane pozostają poprawne).
+ */
+int weld_model(ObjModelData *data, const WeldParams *params, WeldStats *stats);
+
+/**
+ * @brief Wypisuje statystyki scalania w jednej linii.
+ */
+void weld_print_stats(const WeldStats *stats);
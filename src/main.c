@@ -1,5 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -9,7 +11,28 @@
 #include "Mesh.h"
 #include "Camera.h"
 #include "ObjLoader.h"
+#include "Weld.h"
 #include "Material.h"
+#include "ModelMaterials.h"
+#include "Renderer.h"
+#include "Redraw.h"
+#include "Options.h"
+#include "SceneGraph.h"
+#include "ClusteredLights.h"
+#include "OctreePager.h"
+#include "HotReload.h"
+#include "GpuRing.h"
+#include "DebugDraw.h"
+#include "FrameCapture.h"
+#include "Startup.h"
+#include "FramePacer.h"
+#include "Resources.h"
+#include "SceneFile.h"
+#include "GlRecord.h"
+#include "DepthPrepass.h"
+#include "TextureStream.h"
+#include "OcclusionCull.h"
+#include "DynamicResolution.h"
 
 /* =========================================================
    Zmienne globalne do obsługi kamery i inputu
@@ -22,6 +45,23 @@ float lastX = 640.0f;
 float lastY = 360.0f;
 int firstMouse = 1;
 
+// nazwy zasobów: ścieżki luźnych plików i zarazem nazwy wpisów w paczce .pak
+#define MODEL_OBJ_PATH "assets/models/model.obj"
+#define MODEL_MTL_PATH "assets/models/model.mtl"
+
+#define TEX_STREAM_UPLOAD_BYTES ((size_t)8 << 20) // poziomy mip wysyłane w jednej klatce
+
+RedrawState redraw;
+FramePacer pacer;
+DynamicResolution dynRes;
+int lightsOrbit = 0;
+int printStats = 0;
+int showDebug = 0;
+int toggleCapture = 0;
+int toggleDepthPrepass = 0;
+int toggleOcclusion = 0;
+int toggleDynamicRes = 0;
+
 /* =========================================================
    Callbacki GLFW
    ========================================================= */
@@ -31,11 +71,22 @@ int firstMouse = 1;
  */
 static void framebuffer_size_callback(GLFWwindow *window, int width, int height)
 {
-    glViewport(0, 0, width, height);
+    // viewport i cele renderowania ustawiane leniwie na początku klatki (jedna alokacja po serii zdarzeń)
+    dynamic_resolution_resize(&dynRes, width, height);
+    redraw_mark(&redraw, REDRAW_RESIZE);
 }
 
 /**
- * @brief Callback klawiatury (WASD).
+ * @brief Callback klawiatury (WASD + przełączniki trybów).
+ *
+ * F1 — przełącza tryb render on demand.
+ * F2 — włącza/wyłącza krążenie świateł (animacja).
+ * F3 — wypisuje statystyki.
+ * F4 — linie pomocnicze (AABB modelu, pozycje świateł).
+ * F5 — pauza / wznowienie zapisu klatek (--capture).
+ * F6 — przebieg głębi przed głównym rysowaniem (--depth-prepass).
+ * F7 — zapytania o zasłonięcie i rysowanie warunkowe (--occlusion).
+ * F8 — dynamiczna rozdzielczość (--dynamic-res).
  */
 static void key_callback(GLFWwindow *window, int key, int scancode, int action, int mods)
 {
@@ -46,6 +97,43 @@ static void key_callback(GLFWwindow *window, int key, int scancode, int action,
         else if (action == GLFW_RELEASE)
             keys[key] = 0;
     }
+
+    if (action == GLFW_PRESS && key == GLFW_KEY_F1)
+    {
+        redraw_report(&redraw, glfwGetTime());
+        redraw_set_enabled(&redraw, !redraw.enabled);
+        printf("Render on demand: %s\n", redraw.enabled ? "ON" : "OFF");
+    }
+
+    if (action == GLFW_PRESS && key == GLFW_KEY_F2)
+    {
+        lightsOrbit = !lightsOrbit;
+        if (lightsOrbit)
+            redraw_animation_begin(&redraw);
+        else
+            redraw_animation_end(&redraw);
+    }
+
+    if (action == GLFW_PRESS && key == GLFW_KEY_F3)
+        printStats = 1;
+
+    if (action == GLFW_PRESS && key == GLFW_KEY_F4)
+        showDebug = !showDebug;
+
+    if (action == GLFW_PRESS && key == GLFW_KEY_F5)
+        toggleCapture = 1;
+
+    if (action == GLFW_PRESS && key == GLFW_KEY_F6)
+        toggleDepthPrepass = 1;
+
+    if (action == GLFW_PRESS && key == GLFW_KEY_F7)
+        toggleOcclusion = 1;
+
+    if (action == GLFW_PRESS && key == GLFW_KEY_F8)
+        toggleDynamicRes = 1;
+
+    frame_pacer_input(&pacer);
+    redraw_mark(&redraw, REDRAW_INPUT);
 }
 
 /**
@@ -67,18 +155,406 @@ static void mouse_callback(GLFWwindow *window, double xpos, double ypos)
     lastY = (float)ypos;
 
     camera_process_mouse(&camera, dx, dy);
+    frame_pacer_input(&pacer);
+    redraw_mark(&redraw, REDRAW_CAMERA);
+}
+
+/* =========================================================
+   Bloki uniformów (std140, wysyłane przez GpuRing)
+   ========================================================= */
+
+#define UBO_PER_FRAME 0
+#define UBO_PER_DRAW 1
+
+typedef struct FrameUniforms
+{
+    float view[16];
+    float projection[16];
+} FrameUniforms;
+
+typedef struct DrawUniforms
+{
+    float model[16];
+    float normal[12]; // mat3 w std140: 3 kolumny po vec4
+} DrawUniforms;
+
+static void upload_frame_uniforms(GpuRing *ring, mat4 view, mat4 proj)
+{
+    FrameUniforms u;
+    memcpy(u.view, view, sizeof(u.view));
+    memcpy(u.projection, proj, sizeof(u.projection));
+    gpu_ring_bind_uniform(ring, UBO_PER_FRAME, &u, sizeof(u));
+}
+
+/**
+ * @brief Blok PerDraw w pierścieniu.
+ *
+ * @return 1 jeśli OK, 0 jeśli pierścień jest pełny (blok nie jest zmieniony — nie rysować).
+ */
+static int upload_draw_uniforms(GpuRing *ring, const float *world, const float *normal)
+{
+    DrawUniforms u;
+    memcpy(u.model, world, sizeof(u.model));
+    for (int c = 0; c < 3; c++)
+    {
+        u.normal[c * 4 + 0] = normal[c * 3 + 0];
+        u.normal[c * 4 + 1] = normal[c * 3 + 1];
+        u.normal[c * 4 + 2] = normal[c * 3 + 2];
+        u.normal[c * 4 + 3] = 0.0f;
+    }
+    return gpu_ring_bind_uniform(ring, UBO_PER_DRAW, &u, sizeof(u));
+}
+
+/**
+ * @brief Transformacja węzła do RenderItem (pierścień + macierze z grafu sceny).
+ */
+typedef struct NodeTransform
+{
+    GpuRing *ring;
+    const float *world;
+    const float *normal;
+} NodeTransform;
+
+static int bind_node_transform(const void *state, GLuint program)
+{
+    (void)program;
+    const NodeTransform *t = (const NodeTransform *)state;
+    return upload_draw_uniforms(t->ring, t->world, t->normal);
+}
+
+/**
+ * @brief Pozycja kamery w przestrzeni modelu narysowanego z macierzą world.
+ *
+ * Testy na AABB siatki (poziom mip tekstury, kamera w pudełku zasłonięcia)
+ * idą w przestrzeni modelu. Odległość razy gęstość UV na jednostkę modelu
+ * daje to samo co w świecie przy jednolitej skali.
+ */
+static void camera_model_position(const float *world, vec3 out)
+{
+    mat4 w, invWorld;
+    memcpy(w, world, sizeof(w));
+    glm_mat4_inv(w, invWorld);
+    glm_mat4_mulv3(invWorld, camera.position, 1.0f, out);
+}
+
+/**
+ * @brief Stan programu po linkowaniu: bloki uniformów, światło, samplery.
+ *
+ * Dla programu viewera i dla programów wczytanych przez menedżer zasobów.
+ */
+static void setup_program(GLuint program, void *user)
+{
+    (void)user;
+    ShaderProgram s = {program};
+    shader_use(s);
+    glUniform3f(glGetUniformLocation(program, "uLightDir"), -0.3f, -1.0f, -0.5f);
+    shader_bind_block(s, "PerFrame", UBO_PER_FRAME);
+    shader_bind_block(s, "PerDraw", UBO_PER_DRAW);
+    glUniform1f(glGetUniformLocation(program, "uShininess"), 32.0f);
+    model_materials_setup_program(program);
+}
+
+/**
+ * @brief Kompiluje warianty shadera potrzebne materiałom (przed pierwszą klatką).
+ *
+ * Uniformy klastrów są ustawiane na początku klatki tylko dla już
+ * skompilowanych wariantów, więc wariant nie powinien powstawać dopiero
+ * przy budowie kolejki.
+ */
+static void warm_variants(ShaderVariants *v, const ModelMaterials *materials, const Material *mat)
+{
+    if (materials && materials->packed)
+        shader_variants_get(v, SHADER_FEATURE_PACKED);
+    else if (materials)
+    {
+        for (size_t i = 0; i < materials->count; i++)
+            shader_variants_get(v, material_shader_features(&materials->classic[i]));
+    }
+    if (mat)
+        shader_variants_get(v, material_shader_features(mat));
+}
+
+/**
+ * @brief Uniformy klastrów dla każdego skompilowanego wariantu.
+ */
+static void bind_cluster_variants(const ClusterGrid *clusters, const ShaderVariants *v, int fbw, int fbh)
+{
+    for (unsigned i = 0; i < SHADER_VARIANT_COUNT; i++)
+    {
+        if (!v->programs[i])
+            continue;
+        glUseProgram(v->programs[i]);
+        cluster_grid_bind(clusters, v->programs[i], 1, fbw, fbh);
+    }
+}
+
+/* =========================================================
+   Benchmark kolejki rysowania
+   ========================================================= */
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+}
+
+static unsigned int bench_rand(unsigned int *state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Mierzy koszt kluczy i sortowania oraz zmiany stanu dla N rysowań.
+ *
+ * Syntetyczna scena (bez GL): obiekty z losowym materiałem, siatką
+ * i głębokością, w kolejności „z grafu sceny”. Zmiany stanu liczone
+ * dla kolejności dodania i po sortowaniu.
+ */
+static int run_queue_benchmark(int draws)
+{
+    enum { PROGRAMS = 4, TEXTURES = 256, MATERIALS = 1024, MESHES = 64, FRAMES = 100 };
+    static Material materials[MATERIALS];
+
+    RenderQueue queue;
+    if (!render_queue_init(&queue, (size_t)draws, 100.0f))
+        return -1;
+
+    for (int i = 0; i < MATERIALS; i++)
+    {
+        material_init(&materials[i]);
+        materials[i].diffuseTex = 1 + (GLuint)(i % TEXTURES);
+    }
+
+    uint64_t *copy = (uint64_t *)malloc((size_t)draws * sizeof(uint64_t));
+    double pushMs = 0.0, sortMs = 0.0, sortMin = 1e30, qsortMs = 0.0;
+    RenderQueueStats unsorted, sorted;
+
+    for (int f = 0; f < FRAMES && copy; f++)
+    {
+        unsigned int rng = 1234u;
+        double t0 = now_ms();
+        render_queue_begin(&queue);
+        for (int i = 0; i < draws; i++)
+        {
+            RenderItem item;
+            memset(&item, 0, sizeof(item));
+            unsigned int mat = bench_rand(&rng) % MATERIALS;
+            item.program = 1 + mat % PROGRAMS;
+            item.vao = 1 + bench_rand(&rng) % MESHES;
+            render_item_from_material(&item, &materials[mat]);
+            item.transform = (const void *)(uintptr_t)(i + 1); // własne macierze (tylko porównywane)
+            item.primitive_base = -1;
+            item.index_count = 36;
+            render_queue_push(&queue, RENDER_PASS_OPAQUE, &item,
+                              (float)(bench_rand(&rng) % 10000) * 0.01f);
+        }
+        double t1 = now_ms();
+        memcpy(copy, queue.keys, (size_t)draws * sizeof(uint64_t));
+        render_queue_sort(&queue);
+        double t2 = now_ms();
+        qsort(copy, (size_t)draws, sizeof(uint64_t), cmp_u64);
+        double t3 = now_ms();
+
+        pushMs += t1 - t0;
+        sortMs += queue.stats.sort_ms;
+        if (queue.stats.sort_ms < sortMin)
+            sortMin = queue.stats.sort_ms;
+        qsortMs += t3 - t2;
+    }
+
+    render_queue_count_changes(&queue, 0, &unsorted);
+    render_queue_count_changes(&queue, 1, &sorted);
+
+    printf("[bench-queue] %d draws, %d programs, %d textures, %d materials, %d meshes, %d frames\n",
+           draws, PROGRAMS, TEXTURES, MATERIALS, MESHES, FRAMES);
+    printf("[bench-queue] per frame: push %.3f ms, radix sort %.3f ms (min %.3f), qsort %.3f ms\n",
+           pushMs / FRAMES, sortMs / FRAMES, sortMin, qsortMs / FRAMES);
+    printf("[bench-queue] %-12s %10s %10s\n", "changes", "unsorted", "sorted");
+    printf("[bench-queue] %-12s %10zu %10zu\n", "programs", unsorted.programs, sorted.programs);
+    printf("[bench-queue] %-12s %10zu %10zu\n", "VAOs", unsorted.vaos, sorted.vaos);
+    printf("[bench-queue] %-12s %10zu %10zu\n", "textures", unsorted.textures, sorted.textures);
+    printf("[bench-queue] %-12s %10zu %10zu\n", "materials", unsorted.materials, sorted.materials);
+    printf("[bench-queue] %-12s %10zu %10zu\n", "transforms", unsorted.transforms, sorted.transforms);
+
+    free(copy);
+    render_queue_destroy(&queue);
+    return 0;
+}
+
+/* =========================================================
+   Benchmark oświetlenia
+   ========================================================= */
+
+/**
+ * @brief Mierzy koszt oświetlenia klastrowego dla rosnącej liczby świateł.
+ *
+ * Dla każdej liczby świateł: czas budowy list na CPU (z wysyłką)
+ * i czas rysowania modelu na GPU (GL_TIME_ELAPSED), plus średnia
+ * i maksymalna liczba świateł na klaster — koszt fragmentu powinien
+ * rosnąć z lokalną, a nie całkowitą liczbą świateł.
+ */
+static void run_light_benchmark(GLFWwindow *window, ShaderProgram sh, GpuRing *ring,
+                                mat4 proj, const float *world, const float *normal,
+                                ClusterGrid *clusters, LightSet *lights,
+                                const vec3 bmin, const vec3 bmax,
+                                const Material *mat, const Mesh *mesh)
+{
+    static const int counts[] = {0, 16, 64, 256, 1024, 4096, 16384};
+    const int warmup = 10;
+    const int frames = 60;
+
+    GLuint query;
+    glGenQueries(1, &query);
+
+    mat4 view;
+    camera_get_view_matrix(&camera, view);
+
+    printf("[bench-lights] %8s %10s %10s %12s %12s\n",
+           "lights", "cpu_ms", "gpu_ms", "avg/cluster", "max/cluster");
+
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+    {
+        light_set_scatter(lights, (size_t)counts[c], bmin, bmax, 1234u);
+
+        double cpuMs = 0.0, gpuMs = 0.0, avgPerCluster = 0.0;
+        size_t maxPerCluster = 0;
+
+        for (int f = 0; f < warmup + frames; f++)
+        {
+            int fbw, fbh;
+            glfwGetFramebufferSize(window, &fbw, &fbh);
+
+            glClearColor(0.1f, 0.12f, 0.16f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+            gpu_ring_begin_frame(ring);
+            shader_use(sh);
+            upload_frame_uniforms(ring, view, proj);
+            upload_draw_uniforms(ring, world, normal);
+            cluster_grid_build(clusters, lights, view);
+            cluster_grid_bind(clusters, sh.id, 1, fbw, fbh);
+            material_bind(mat, sh.id);
+
+            glBeginQuery(GL_TIME_ELAPSED, query);
+            mesh_draw(mesh);
+            glEndQuery(GL_TIME_ELAPSED);
+
+            gpu_ring_end_frame(ring);
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+
+            GLuint64 ns = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &ns);
+            if (f >= warmup)
+            {
+                cpuMs += clusters->build_ms;
+                gpuMs += (double)ns / 1.0e6;
+                avgPerCluster += (double)clusters->index_count / CLUSTER_COUNT;
+                if (clusters->max_per_cluster > maxPerCluster)
+                    maxPerCluster = clusters->max_per_cluster;
+            }
+        }
+
+        printf("[bench-lights] %8d %10.3f %10.3f %12.2f %12zu\n",
+               counts[c], cpuMs / frames, gpuMs / frames, avgPerCluster / frames, maxPerCluster);
+    }
+
+    glDeleteQueries(1, &query);
 }
 
 /* =========================================================
    MAIN
    ========================================================= */
 
-int main(void)
+int main(int argc, char **argv)
 {
+    double processStart = now_ms();
+    AppOptions opts;
+    options_init(&opts);
+    if (!options_parse(argc, argv, &opts))
+        return -1;
+
+    // tylko CPU: bez okna i kontekstu GL
+    if (opts.bench_queue > 0)
+        return run_queue_benchmark(opts.bench_queue);
+
+    int paged = opts.octree_path != NULL;
+    int packed = opts.pack_path != NULL;
+    int sceneMode = opts.scene_path != NULL;
+    int pointMode = opts.points_path != NULL;
+    if (sceneMode + pointMode + paged + packed > 1 || ((sceneMode || pointMode) && opts.mesh_path))
+    {
+        printf("ERROR: --scene, --points, --pack, --octree and --mesh are mutually exclusive\n");
+        return -1;
+    }
+    if (opts.objects && (sceneMode || pointMode || paged || packed || opts.mesh_path))
+    {
+        printf("ERROR: --objects selects objects of model.obj and cannot be combined with another model source\n");
+        return -1;
+    }
+
+    // wiele świateł -> phong z oświetleniem klastrowym (chmura punktów: bez oświetlenia)
+    int clustered = !pointMode && (opts.lights > 0 || opts.bench_lights);
+
+    // brakujące vn (wczytanie i przeładowanie na gorąco)
+    NormalGenParams normalParams = normal_gen_params_default();
+    normalParams.weighting = opts.area_normals ? NORMAL_WEIGHT_AREA : NORMAL_WEIGHT_ANGLE;
+    normalParams.crease_angle = opts.crease_angle;
+
+    // scalanie wierzchołków z szumem (eksporty CAD)
+    WeldParams weldParams = weld_params_default();
+    weldParams.position_eps = opts.weld_eps;
+    weldParams.normal_angle = opts.weld_angle;
+    weldParams.uv_eps = opts.weld_uv;
+
+    /* ---------- Start: zadania CPU ruszają przed utworzeniem okna ---------- */
+    StartupParams startupParams;
+    memset(&startupParams, 0, sizeof(startupParams));
+    startupParams.vertex_path = clustered ? "shaders/phong.vert" : "shaders/basic.vert";
+    startupParams.fragment_path = clustered ? "shaders/phong.frag" : "shaders/basic.frag";
+    if (pointMode)
+    {
+        startupParams.vertex_path = "shaders/points.vert";
+        startupParams.fragment_path = "shaders/points.frag";
+        startupParams.points_path = opts.points_path;
+    }
+    if (!paged && !packed && !sceneMode && !pointMode)
+    {
+        startupParams.obj_path = MODEL_OBJ_PATH;
+        startupParams.mesh_path = opts.mesh_path;
+        startupParams.objects = opts.objects;
+    }
+    // scena: modele i materiały wczytuje menedżer zasobów
+    startupParams.mtl_path = packed || sceneMode || pointMode ? NULL : MODEL_MTL_PATH;
+    startupParams.normals = normalParams;
+    startupParams.weld = weldParams;
+    startupParams.tex_pack = !opts.no_tex_pack;
+    startupParams.serial = opts.serial_startup;
+
+    // tekstury materiałów (model i scena) startują z ogonem łańcucha mip; wątek I/O bez GL rusza już teraz
+    TextureStreamer texStream;
+    int streaming = opts.tex_stream_mb > 0 && !paged && !packed && !pointMode &&
+                    texture_streamer_init(&texStream, (size_t)opts.tex_stream_mb << 20, TEX_STREAM_UPLOAD_BYTES);
+    if (streaming)
+        startupParams.streamer = &texStream;
+
+    Startup startup;
+    if (!startup_begin(&startup, &startupParams))
+        return -1;
+
     /* ---------- GLFW init ---------- */
     if (!glfwInit())
     {
         printf("GLFW init failed\n");
+        startup_cancel(&startup);
         return -1;
     }
 
@@ -90,6 +566,7 @@ int main(void)
     if (!window)
     {
         printf("Window creation failed\n");
+        startup_cancel(&startup);
         glfwTerminate();
         return -1;
     }
@@ -104,30 +581,51 @@ int main(void)
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
     {
         printf("Failed to init GLAD\n");
+        startup_cancel(&startup);
         glfwTerminate();
         return -1;
     }
 
-    glEnable(GL_DEPTH_TEST);
+    // nagranie od pierwszego polecenia GL: dziennik odtwarza też tworzenie zasobów
+    if (opts.record_path)
+    {
+        int fbw, fbh;
+        glfwGetFramebufferSize(window, &fbw, &fbh);
+        if (!gl_record_start(opts.record_path, fbw, fbh))
+        {
+            startup_cancel(&startup);
+            glfwTerminate();
+            return -1;
+        }
+    }
 
-    /* ---------- Shader ---------- */
-    ShaderProgram sh = shader_load_from_files(
-        "shaders/basic.vert",
-        "shaders/basic.frag");
+    glEnable(GL_DEPTH_TEST);
 
-    if (!sh.id)
+    /* ---------- Shader, model, materiał: zadania GL w miarę gotowości danych ---------- */
+    double assetStart = glfwGetTime();
+    if (!startup_finish(&startup))
     {
-        printf("Shader load failed\n");
         glfwTerminate();
         return -1;
     }
+    ShaderProgram sh = startup.shader;
 
     /* ---------- Kamera ---------- */
     camera_init(&camera);
 
+    /* ---------- Graf sceny ---------- */
+    SceneGraph scene;
+    if (!scene_graph_init(&scene, 16))
+    {
+        shader_variants_destroy(&startup.shaders);
+        glfwTerminate();
+        return -1;
+    }
+    int modelNode = scene_graph_add_node(&scene, -1);
+    scene_graph_update(&scene);
+
     /* ---------- Macierze ---------- */
-    mat4 model, proj;
-    glm_mat4_identity(model);
+    mat4 proj;
 
     glm_perspective(
         glm_rad(60.0f),
@@ -136,72 +634,682 @@ int main(void)
         100.0f,
         proj);
 
-    shader_use(sh);
-    glUniform3f(
-        glGetUniformLocation(sh.id, "uLightDir"),
-        -0.3f, -1.0f, -0.5f);
+    shader_variants_set_setup(&startup.shaders, setup_program, NULL);
 
-    GLint locModel = glGetUniformLocation(sh.id, "uModel");
-    GLint locView = glGetUniformLocation(sh.id, "uView");
-    GLint locProj = glGetUniformLocation(sh.id, "uProjection");
+    /* ---------- Scena: wiele modeli, wspólne zasoby wczytane raz ---------- */
+    ResourceManager resources;
+    SceneFile sceneFile;
+    NodeTransform *sceneTransforms = NULL;
+    ShaderVariants **sceneVariants = NULL; // programy inne niż sh (klastry wiązane osobno)
+    size_t sceneVariantCount = 0;
+    if (sceneMode)
+    {
+        int ok = resources_init(&resources, (size_t)opts.res_budget_mb << 20);
+        if (ok)
+        {
+            resources.normals = normalParams;
+            resources.weld = weldParams;
+            resources.tex_pack = !opts.no_tex_pack;
+            resources.program_setup = setup_program;
+            resources.streamer = streaming ? &texStream : NULL;
+            ok = scene_file_load(opts.scene_path, &resources, &scene, &sceneFile);
+            if (!ok)
+                resources_destroy(&resources);
+        }
+        if (ok)
+        {
+            sceneTransforms = (NodeTransform *)malloc(sceneFile.count * sizeof(NodeTransform));
+            sceneVariants = (ShaderVariants **)malloc(sceneFile.count * sizeof(ShaderVariants *));
+            ok = sceneTransforms && sceneVariants;
+            for (size_t i = 0; ok && i < sceneFile.count; i++)
+            {
+                ShaderVariants *v = resources_program_variants(&resources, sceneFile.instances[i].program);
+                size_t k = 0;
+                while (k < sceneVariantCount && sceneVariants[k] != v)
+                    k++;
+                if (v && k == sceneVariantCount)
+                    sceneVariants[sceneVariantCount++] = v;
+            }
+            if (!ok)
+            {
+                scene_file_unload(&sceneFile, &resources);
+                resources_destroy(&resources);
+            }
+        }
+        if (!ok)
+        {
+            free(sceneTransforms);
+            free(sceneVariants);
+            scene_graph_free(&scene);
+            shader_variants_destroy(&startup.shaders);
+            glfwTerminate();
+            return -1;
+        }
+        printf("Scene %s: %zu instances\n", opts.scene_path, sceneFile.count);
+        resources_print_stats(&resources);
+    }
 
-    glUniformMatrix4fv(locModel, 1, GL_FALSE, (float *)model);
-    glUniformMatrix4fv(locProj, 1, GL_FALSE, (float *)proj);
+    /* ---------- Model: OBJ, paczka .pak albo stronicowane octree ---------- */
+    Mesh modelMesh = startup.mesh;
+    ModelMaterials materials = startup.materials;
+    int multiMaterial = startup.multi_material;
+    PointCloud points = startup.points;
+    points.point_budget = (size_t)(opts.point_budget_m * 1.0e6f);
+    points.gpu_budget = (size_t)opts.gpu_budget_mb << 20;
+    points.max_pixel_error = opts.point_error;
+    vec3 modelMin, modelMax, modelCenter;
+    OctreePager pager;
 
-    /* ---------- Mesh (trójkąt testowy) ---------- */
-    ObjModelData modelData;
-    if (!obj_load("assets/models/model.obj", &modelData))
+    AssetPack pack;
+    if (packed && !asset_pack_open(&pack, opts.pack_path))
     {
-        printf("Failed to load OBJ\n");
-        shader_destroy(&sh);
+        scene_graph_free(&scene);
+        shader_variants_destroy(&startup.shaders);
         glfwTerminate();
         return -1;
     }
-    Material mat;
-    material_load_mtl("assets/models/model.mtl", &mat);
 
-    Mesh modelMesh = mesh_create(
-        modelData.vertices,
-        (unsigned int)modelData.vertex_count,
-        modelData.indices,
-        (unsigned int)modelData.index_count);
+    if (paged)
+    {
+        if (!octree_pager_open(&pager, opts.octree_path,
+                               (size_t)opts.cpu_budget_mb << 20,
+                               (size_t)opts.gpu_budget_mb << 20))
+        {
+            if (packed)
+                asset_pack_close(&pack);
+            scene_graph_free(&scene);
+            shader_variants_destroy(&startup.shaders);
+            glfwTerminate();
+            return -1;
+        }
+        glm_vec3_copy(pager.header.bmin, modelMin);
+        glm_vec3_copy(pager.header.bmax, modelMax);
+    }
+    else if (packed)
+    {
+        // bufory wysyłane prosto ze zmapowanego pliku
+        const AssetMeshHeader *mh;
+        const void *packVerts;
+        const uint32_t *packIndices;
+        if (!asset_pack_mesh(&pack, MODEL_OBJ_PATH, &mh, &packVerts, &packIndices))
+        {
+            printf("Failed to load mesh from pack: %s\n", MODEL_OBJ_PATH);
+            asset_pack_close(&pack);
+            scene_graph_free(&scene);
+            shader_variants_destroy(&startup.shaders);
+            glfwTerminate();
+            return -1;
+        }
+        modelMesh = mesh_create((const Vertex *)packVerts, mh->vertex_count,
+                                packIndices, mh->index_count);
+        glm_vec3_copy((float *)mh->bmin, modelMin);
+        glm_vec3_copy((float *)mh->bmax, modelMax);
+    }
+    else if (sceneMode)
+    {
+        // AABB wszystkich instancji (światła, linie debug)
+        glm_vec3_copy(sceneFile.bmin, modelMin);
+        glm_vec3_copy(sceneFile.bmax, modelMax);
+    }
+    else
+    {
+        // wczytany w startup_finish()
+        glm_vec3_copy(startup.bmin, modelMin);
+        glm_vec3_copy(startup.bmax, modelMax);
+    }
+    glm_vec3_lerp(modelMin, modelMax, 0.5f, modelCenter);
+
+    Material mat = startup.material;
+    if (packed)
+    {
+        material_load_from_pack(&pack, MODEL_MTL_PATH, &mat);
+        asset_pack_close(&pack);
+    }
+
+    // warianty shadera wszystkich materiałów (cechy znane dopiero po wczytaniu)
+    warm_variants(&startup.shaders, multiMaterial ? &materials : NULL, &mat);
+    for (size_t i = 0; sceneMode && i < sceneFile.count; i++)
+    {
+        const SceneInstance *inst = &sceneFile.instances[i];
+        const ResourceMesh *rmesh = resources_mesh(&resources, inst->mesh);
+        const ResourceMaterial *rmat = resources_material(&resources, inst->material);
+        ShaderVariants *variants = resources_program_variants(&resources, inst->program);
+        warm_variants(variants ? variants : &startup.shaders,
+                      rmesh && rmesh->multi_material ? &rmesh->materials : NULL,
+                      rmat ? &rmat->material : &mat);
+    }
+
+    // czas startu zasobów łącznie z wysłaniem na GPU (porównanie pak / luźne pliki)
+    glFinish();
+    const char *assetSource = opts.mesh_path ? opts.mesh_path : "loose files";
+    if (sceneMode || pointMode)
+        assetSource = sceneMode ? opts.scene_path : opts.points_path;
+    printf("[startup] assets from %s: %.1f ms\n",
+           packed ? opts.pack_path : assetSource, (glfwGetTime() - assetStart) * 1000.0);
 
-    // dane CPU nie są już potrzebne po wrzuceniu do GPU
-    obj_free(&modelData);
+    // przeładowanie na gorąco tylko dla luźnych plików
+    ModelReloader reloader;
+    int reloading = !paged && !packed && !sceneMode && !pointMode && !opts.mesh_path && !opts.objects &&
+                    !opts.no_watch;
+    if (reloading && multiMaterial)
+    {
+        // przeładowanie podmienia jeden materiał; zakresy usemtl by się rozjechały
+        printf("Hot reload disabled for multi-material models\n");
+        reloading = 0;
+    }
+    if (reloading && startup.texture_stream >= 0)
+    {
+        // przeładowanie podmienia teksturę materiału, a tę zwalnia streamer
+        printf("Hot reload disabled while streaming textures\n");
+        reloading = 0;
+    }
+    if (reloading)
+        reloading = model_reloader_start(&reloader, MODEL_OBJ_PATH, MODEL_MTL_PATH, &normalParams,
+                                         &weldParams);
+
+    /* ---------- Światła (oświetlenie klastrowe) ---------- */
+    LightSet lights;
+    ClusterGrid clusters;
+    light_set_init(&lights);
+    if (clustered)
+    {
+        if (!cluster_grid_init(&clusters, proj, 0.1f, 100.0f))
+            clustered = 0;
+        else
+            light_set_scatter(&lights, (size_t)opts.lights, modelMin, modelMax, 1234u);
+    }
+
+    /* ---------- Bufor pierścieniowy (uniformy, linie debug) ---------- */
+    GpuRing ring;
+    // zapisy przez trwałe mapowanie omijają GL -> nagranie wymaga ścieżki z glMapBufferRange
+    if (!gpu_ring_init(&ring, (GLsizeiptr)4 << 20, !opts.ring_unsync && !opts.record_path))
+    {
+        printf("GPU ring buffer init failed\n");
+        glfwSetWindowShouldClose(window, 1);
+    }
+    DebugDraw debugDraw;
+    int debugReady = debug_draw_init(&debugDraw, UBO_PER_FRAME);
+
+    /* ---------- Kolejka rysowania ---------- */
+    RenderQueue queue;
+    if (!render_queue_init(&queue, 256, 100.0f))
+    {
+        printf("Render queue init failed\n");
+        glfwSetWindowShouldClose(window, 1);
+    }
+
+    // przebieg głębi tylko dla kolejki (octree i chmura punktów rysują same)
+    DepthPrepass depthPrepass;
+    int prepassReady = !paged && !pointMode &&
+                       depth_prepass_init(&depthPrepass, UBO_PER_FRAME, UBO_PER_DRAW, opts.depth_prepass);
+
+    // zapytania o zasłonięcie też tylko dla kolejki; wyłączone działają jak pierwsza klatka (bez warunku)
+    OcclusionCuller occlusion;
+    int occlusionReady = !paged && !pointMode &&
+                         occlusion_init(&occlusion, UBO_PER_FRAME, UBO_PER_DRAW, opts.occlusion);
+
+    // scena w FBO o skali dobieranej do czasu klatki GPU; bez --dynamic-res tylko viewport okna
+    {
+        int fbw, fbh;
+        glfwGetFramebufferSize(window, &fbw, &fbh);
+        if (!dynamic_resolution_init(&dynRes, fbw, fbh, opts.dynamic_res_ms, opts.dynamic_res_min, opts.sharpen))
+            printf("Dynamic resolution disabled\n");
+    }
+
+    if (clustered && opts.bench_lights && ring.buffer)
+    {
+        scene_graph_update(&scene);
+        ShaderProgram matShader = {shader_variants_get(&startup.shaders, material_shader_features(&mat))};
+        if (!paged && !sceneMode)
+            run_light_benchmark(window, matShader, &ring, proj,
+                                scene_graph_world(&scene, modelNode),
+                                scene_graph_normal(&scene, modelNode),
+                                &clusters, &lights,
+                                modelMin, modelMax, &mat, &modelMesh);
+        glfwSetWindowShouldClose(window, 1);
+    }
 
     /* ---------- Pętla renderująca ---------- */
     float lastFrame = 0.0f;
+    int firstFrameDone = 0;
+
+    redraw_init(&redraw, opts.on_demand, glfwGetTime());
+
+    // zapis klatek: rysujemy każdą klatkę (stałe tempo nagrania)
+    FrameCapture capture;
+    int capturing = opts.capture_path && frame_capture_start(&capture, opts.capture_path,
+                                                             opts.capture_sync);
+    if (capturing)
+        redraw_animation_begin(&redraw);
+
+    // opóźnienie wejście -> swap mierzone zawsze; limit klatek i sen tylko z --pacing/--target-fps
+    frame_pacer_init(&pacer, opts.max_frames_in_flight, opts.target_fps);
+    int pacing = pacer.max_in_flight > 0 || pacer.target_ms > 0.0;
 
     while (!glfwWindowShouldClose(window))
     {
+        // raport zużycia klatek co minutę
+        if (glfwGetTime() - redraw.stats_start >= 60.0)
+            redraw_report(&redraw, glfwGetTime());
+
+        // wątek przeładowania budzi pętlę przez glfwPostEmptyEvent()
+        if (reloading && model_reloader_busy(&reloader))
+            redraw_mark(&redraw, REDRAW_UPLOAD);
+
+        // nic się nie zmieniło -> śpij do najbliższego zdarzenia
+        if (!redraw_needed(&redraw))
+        {
+            redraw_wait(&redraw, glfwGetTime());
+            continue;
+        }
+
+        // GPU najwyżej max_in_flight klatek z tyłu; wejście zbierane dopiero teraz
+        frame_pacer_begin(&pacer);
+        if (pacing)
+            glfwPollEvents();
+        frame_pacer_latch(&pacer);
+
+        if (toggleOcclusion)
+        {
+            toggleOcclusion = 0;
+            if (occlusionReady)
+            {
+                occlusion.enabled = !occlusion.enabled;
+                printf("Occlusion culling: %s\n", occlusion.enabled ? "ON" : "OFF");
+            }
+        }
+
+        if (toggleDynamicRes)
+        {
+            toggleDynamicRes = 0;
+            if (dynRes.available)
+            {
+                dynamic_resolution_set_enabled(&dynRes, !dynRes.enabled);
+                printf("Dynamic resolution: %s\n", dynRes.enabled ? "ON" : "OFF");
+            }
+        }
+
+        if (toggleDepthPrepass)
+        {
+            toggleDepthPrepass = 0;
+            if (prepassReady)
+            {
+                depthPrepass.enabled = !depthPrepass.enabled;
+                printf("Depth pre-pass: %s\n", depthPrepass.enabled ? "ON" : "OFF");
+            }
+        }
+
         float currentFrame = (float)glfwGetTime();
         float deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
+        // po uśpieniu delta obejmowałaby cały czas czekania
+        if (redraw_frame_begin(&redraw))
+            deltaTime = 0.0f;
+
         if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
             glfwSetWindowShouldClose(window, 1);
 
-        camera_process_keyboard(&camera, deltaTime, keys);
+        if (camera_process_keyboard(&camera, deltaTime, keys))
+            redraw_mark(&redraw, REDRAW_CAMERA);
+
+        // granica klatki: podmiana przeładowanej siatki/materiału
+        if (reloading && model_reloader_update(&reloader, &modelMesh, &mat, modelMin, modelMax))
+        {
+            glm_vec3_lerp(modelMin, modelMax, 0.5f, modelCenter);
+            // tekstura mogła dojść lub zniknąć: wariant przed wiązaniem klastrów
+            warm_variants(&startup.shaders, NULL, &mat);
+        }
+
+        // rozmiar sceny tej klatki; doszlifowanie w bezczynności bez limitu czasu -> pełna rozdzielczość
+        int renderWidth, renderHeight;
+        if (dynamic_resolution_begin(&dynRes, redraw.refine_level > 0, &renderWidth, &renderHeight))
+            redraw_mark(&redraw, REDRAW_REFINE);
+        // krok doszlifowania tylko wtedy, gdy zmieni obraz (scena szła w obniżonej rozdzielczości)
+        redraw.refine_max = dynRes.active && dynRes.scale < 1.0f;
 
         glClearColor(0.1f, 0.12f, 0.16f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+        // segment sprzed GPU_RING_FRAMES klatek musi być już przeczytany
+        gpu_ring_begin_frame(&ring);
+
         shader_use(sh);
 
         mat4 view;
         camera_get_view_matrix(&camera, view);
-        glUniformMatrix4fv(locView, 1, GL_FALSE, (float *)view);
+        upload_frame_uniforms(&ring, view, proj);
+
+        // zmienione węzły (animacje itp.) -> przelicz macierze w jednym przebiegu
+        scene_graph_update(&scene);
+
+        // per draw tylko gotowe macierze — bez odwracania w shaderze
+        NodeTransform modelTransform = {&ring, scene_graph_world(&scene, modelNode),
+                                        scene_graph_normal(&scene, modelNode)};
+
+        if (clustered)
+        {
+            if (lightsOrbit)
+                light_set_orbit(&lights, modelCenter, deltaTime * 0.5f);
+
+            cluster_grid_build(&clusters, &lights, view);
+            bind_cluster_variants(&clusters, &startup.shaders, renderWidth, renderHeight);
+            for (size_t i = 0; i < sceneVariantCount; i++)
+                bind_cluster_variants(&clusters, sceneVariants[i], renderWidth, renderHeight);
+            shader_use(sh);
+        }
+
+        if (paged)
+        {
+            int perDrawOk = upload_draw_uniforms(&ring, modelTransform.world, modelTransform.normal);
+            GLuint matProgram = shader_variants_get(&startup.shaders, material_shader_features(&mat));
+            glUseProgram(matProgram);
+            material_bind(&mat, matProgram);
+
+            // frustum + priorytety w przestrzeni modelu
+            mat4 world, invWorld, vp, mvp;
+            vec3 camModel;
+            memcpy(world, scene_graph_world(&scene, modelNode), sizeof(world));
+            glm_mat4_mul(proj, view, vp);
+            glm_mat4_mul(vp, world, mvp);
+            glm_mat4_inv(world, invWorld);
+            glm_mat4_mulv3(invWorld, camera.position, 1.0f, camModel);
+
+            if (octree_pager_update(&pager, mvp, camModel) || octree_pager_busy(&pager))
+                redraw_mark(&redraw, REDRAW_UPLOAD);
+            if (perDrawOk)
+                octree_pager_draw(&pager);
+        }
+        else if (pointMode)
+        {
+            int perDrawOk = upload_draw_uniforms(&ring, modelTransform.world, modelTransform.normal);
+
+            // LOD w przestrzeni modelu: frustum, odstęp punktów w pikselach, budżety
+            mat4 world, invWorld, vp, mvp;
+            vec3 camModel;
+            memcpy(world, scene_graph_world(&scene, modelNode), sizeof(world));
+            glm_mat4_mul(proj, view, vp);
+            glm_mat4_mul(vp, world, mvp);
+            glm_mat4_inv(world, invWorld);
+            glm_mat4_mulv3(invWorld, camera.position, 1.0f, camModel);
+
+            float screenScale = (float)renderHeight / (2.0f * tanf(glm_rad(60.0f) * 0.5f));
+            if (point_cloud_update(&points, mvp, camModel, screenScale))
+                redraw_mark(&redraw, REDRAW_UPLOAD);
+            if (perDrawOk)
+                point_cloud_draw(&points, sh.id);
+        }
+        else
+        {
+            // widoczne rysowania -> klucze -> radix sort -> rysowanie bez powtórzeń stanu
+            vec3 centerWorld, centerView;
+            glm_mat4_mulv3((vec4 *)modelTransform.world, modelCenter, 1.0f, centerWorld);
+            glm_mat4_mulv3(view, centerWorld, 1.0f, centerView);
+            float depth = -centerView[2];
+
+            // poziomy mip tekstur według wielkości siatek na ekranie w tej klatce
+            float pixelsPerUnit = (float)renderHeight / (2.0f * tanf(glm_rad(60.0f) * 0.5f));
+            if (streaming)
+                texture_streamer_begin_frame(&texStream);
+
+            // wyniki testów tej klatki decydują o następnej: po ruchu kamery jeszcze jedna klatka
+            mat4 viewProj;
+            glm_mat4_mul(proj, view, viewProj);
+            if (occlusionReady && occlusion_begin_frame(&occlusion, (float *)viewProj) && occlusion.enabled)
+                redraw_mark(&redraw, REDRAW_UPLOAD);
+
+            render_queue_begin(&queue);
+            if (sceneMode)
+            {
+                // jedna siatka GPU na model, wiele instancji -> te same VAO/tekstury w kolejce
+                for (size_t i = 0; i < sceneFile.count; i++)
+                {
+                    const SceneInstance *inst = &sceneFile.instances[i];
+                    const ResourceMesh *rmesh = resources_mesh(&resources, inst->mesh);
+                    const ResourceMaterial *rmat = resources_material(&resources, inst->material);
+                    ShaderVariants *variants = resources_program_variants(&resources, inst->program);
+                    if (!variants)
+                        variants = &startup.shaders;
 
-        material_bind(&mat, sh.id);
-        mesh_draw(&modelMesh);
+                    NodeTransform *t = &sceneTransforms[i];
+                    t->ring = &ring;
+                    t->world = scene_graph_world(&scene, inst->node);
+                    t->normal = scene_graph_normal(&scene, inst->node);
+
+                    vec3 center;
+                    glm_vec3_lerp((float *)rmesh->bmin, (float *)rmesh->bmax, 0.5f, center);
+                    glm_mat4_mulv3((vec4 *)t->world, center, 1.0f, centerWorld);
+                    glm_mat4_mulv3(view, centerWorld, 1.0f, centerView);
+
+                    // obiekt zasłonięcia = instancja (indeks i)
+                    vec3 camModel;
+                    camera_model_position(t->world, camModel);
+                    GLuint query = occlusionReady ? occlusion_query(&occlusion, (int)i, rmesh->bmin, rmesh->bmax,
+                                                                    camModel, t, bind_node_transform)
+                                                  : 0;
+
+                    if (rmesh->multi_material)
+                    {
+                        model_materials_enqueue(&rmesh->materials, &queue, variants, &rmesh->mesh,
+                                                t, bind_node_transform, -centerView[2], query);
+                        continue;
+                    }
+                    const ResourceTexture *rtex = rmat ? resources_texture(&resources, rmat->texture) : NULL;
+                    if (streaming && rtex)
+                        texture_streamer_request(&texStream, rtex->stream, rmesh->uv_density, rmesh->bmin,
+                                                 rmesh->bmax, camModel, pixelsPerUnit);
+
+                    const Material *m = rmat ? &rmat->material : &mat;
+                    RenderItem item;
+                    memset(&item, 0, sizeof(item));
+                    item.program = shader_variants_get(variants, material_shader_features(m));
+                    item.vao = rmesh->mesh.VAO;
+                    item.depth_vao = rmesh->mesh.depthVAO;
+                    render_item_from_material(&item, m);
+                    item.transform = t;
+                    item.bind_transform = bind_node_transform;
+                    item.primitive_base = -1;
+                    item.index_count = rmesh->mesh.index_count;
+                    item.occlusion_query = query;
+                    render_queue_push(&queue, RENDER_PASS_OPAQUE, &item, -centerView[2]);
+                }
+            }
+            else
+            {
+                // jeden model: obiekt zasłonięcia 0
+                vec3 camModel;
+                camera_model_position(modelTransform.world, camModel);
+                if (streaming)
+                    texture_streamer_request(&texStream, startup.texture_stream, startup.uv_density, modelMin,
+                                             modelMax, camModel, pixelsPerUnit);
+                GLuint query = occlusionReady ? occlusion_query(&occlusion, 0, modelMin, modelMax, camModel,
+                                                                &modelTransform, bind_node_transform)
+                                              : 0;
+
+                if (multiMaterial)
+                {
+                    model_materials_enqueue(&materials, &queue, &startup.shaders, &modelMesh,
+                                            &modelTransform, bind_node_transform, depth, query);
+                }
+                else
+                {
+                    RenderItem item;
+                    memset(&item, 0, sizeof(item));
+                    item.program = shader_variants_get(&startup.shaders, material_shader_features(&mat));
+                    item.vao = modelMesh.VAO;
+                    item.depth_vao = modelMesh.depthVAO;
+                    render_item_from_material(&item, &mat);
+                    item.transform = &modelTransform;
+                    item.bind_transform = bind_node_transform;
+                    item.primitive_base = -1;
+                    item.index_count = modelMesh.index_count;
+                    item.occlusion_query = query;
+                    render_queue_push(&queue, RENDER_PASS_OPAQUE, &item, depth);
+                }
+            }
+            render_queue_sort(&queue);
+            // brakujące poziomy: wczytanie w tle, wysyłanie w limicie na klatkę
+            if (streaming && (texture_streamer_update(&texStream) > 0 || texture_streamer_busy(&texStream)))
+                redraw_mark(&redraw, REDRAW_UPLOAD);
+            if (prepassReady)
+                depth_prepass_begin(&depthPrepass, &queue, renderWidth, renderHeight);
+            render_queue_submit(&queue);
+            if (prepassReady)
+                depth_prepass_end(&depthPrepass);
+            // pudełka na pełnym buforze głębi tej klatki -> warunki rysowań następnej
+            if (occlusionReady)
+                occlusion_test(&occlusion);
+        }
+
+        if (showDebug && debugReady)
+        {
+            static const float boxColor[3] = {1.0f, 0.8f, 0.2f};
+            static const float lightColor[3] = {0.3f, 1.0f, 0.4f};
+            float extent = glm_vec3_distance(modelMin, modelMax);
+
+            debug_draw_box(&debugDraw, modelMin, modelMax, boxColor);
+            if (clustered)
+            {
+                for (size_t i = 0; i < lights.count; i++)
+                {
+                    float p[3] = {lights.px[i], lights.py[i], lights.pz[i]};
+                    debug_draw_cross(&debugDraw, p, extent * 0.01f, lightColor);
+                }
+            }
+            debug_draw_flush(&debugDraw, &ring);
+        }
+
+        // skalowanie do okna przed odczytem --capture i podmianą
+        dynamic_resolution_end(&dynRes);
+
+        gpu_ring_end_frame(&ring);
+        // pominięte rysowania: następna klatka z większym pierścieniem
+        if (ring.rejected > 0)
+            redraw_mark(&redraw, REDRAW_UPLOAD);
+
+        // tylny bufor przed podmianą: odczyt do PBO, bez czekania na GPU
+        if (capturing)
+        {
+            if (toggleCapture)
+            {
+                capture.active = !capture.active;
+                if (capture.active)
+                    redraw_animation_begin(&redraw);
+                else
+                    redraw_animation_end(&redraw);
+                printf("Capture: %s\n", capture.active ? "ON" : "PAUSED");
+            }
+            int fbw, fbh;
+            glfwGetFramebufferSize(window, &fbw, &fbh);
+            frame_capture_frame(&capture, fbw, fbh);
+        }
+        toggleCapture = 0;
+
+        if (printStats)
+        {
+            printStats = 0;
+            redraw_report(&redraw, glfwGetTime());
+            gpu_ring_print_stats(&ring);
+            frame_pacer_print_stats(&pacer);
+            if (capturing)
+                frame_capture_print_stats(&capture);
+            if (paged)
+                octree_pager_print_stats(&pager);
+            if (pointMode)
+                point_cloud_print_stats(&points);
+            if (!paged && !pointMode)
+                render_queue_print_stats(&queue);
+            if (prepassReady)
+                depth_prepass_print_stats(&depthPrepass);
+            if (occlusionReady)
+                occlusion_print_stats(&occlusion);
+            if (opts.dynamic_res_ms > 0.0f)
+                dynamic_resolution_print_stats(&dynRes);
+            if (multiMaterial)
+                model_materials_print_stats(&materials);
+            if (sceneMode)
+                resources_print_stats(&resources);
+            if (streaming)
+                texture_streamer_print_stats(&texStream);
+        }
 
         glfwSwapBuffers(window);
-        glfwPollEvents();
+        gl_record_frame();
+        frame_pacer_end(&pacer);
+        if (!firstFrameDone)
+        {
+            // czas do pierwszej klatki: graf zadań vs dawna kolejność (--serial-startup)
+            glFinish();
+            printf("[startup] first frame after %.1f ms (%s)\n", now_ms() - processStart,
+                   opts.serial_startup ? "serial" : "task graph");
+            firstFrameDone = 1;
+        }
+        redraw_frame_end(&redraw, glfwGetTime());
+        if (!pacing)
+            glfwPollEvents();
     }
 
+    redraw_report(&redraw, glfwGetTime());
+    gpu_ring_print_stats(&ring);
+    frame_pacer_print_stats(&pacer);
+    if (pointMode)
+        point_cloud_print_stats(&points);
+    if (!paged && !pointMode)
+        render_queue_print_stats(&queue);
+    if (prepassReady)
+        depth_prepass_print_stats(&depthPrepass);
+    if (occlusionReady)
+        occlusion_print_stats(&occlusion);
+    if (opts.dynamic_res_ms > 0.0f)
+        dynamic_resolution_print_stats(&dynRes);
+    if (multiMaterial)
+        model_materials_print_stats(&materials);
+    if (sceneMode)
+        resources_print_stats(&resources);
+    if (streaming)
+        texture_streamer_print_stats(&texStream);
+
     /* ---------- Cleanup ---------- */
-    mesh_destroy(&modelMesh);
-    shader_destroy(&sh);
+    if (capturing)
+        frame_capture_stop(&capture);
+    if (debugReady)
+        debug_draw_destroy(&debugDraw);
+    render_queue_destroy(&queue);
+    if (prepassReady)
+        depth_prepass_destroy(&depthPrepass);
+    if (occlusionReady)
+        occlusion_destroy(&occlusion);
+    dynamic_resolution_destroy(&dynRes);
+    frame_pacer_destroy(&pacer);
+    gpu_ring_destroy(&ring);
+    if (clustered)
+        cluster_grid_destroy(&clusters);
+    light_set_free(&lights);
+    if (reloading)
+        model_reloader_stop(&reloader);
+    if (startup.texture_stream >= 0)
+        mat.diffuseTex = 0; // zwalnia texture_streamer_destroy()
+    material_destroy(&mat);
+    if (multiMaterial)
+        model_materials_destroy(&materials);
+    if (paged)
+        octree_pager_close(&pager);
+    else
+        mesh_destroy(&modelMesh);
+    if (pointMode)
+        point_cloud_free(&points);
+    if (sceneMode)
+    {
+        scene_file_unload(&sceneFile, &resources);
+        resources_destroy(&resources);
+        free(sceneTransforms);
+        free(sceneVariants);
+    }
+    if (streaming)
+        texture_streamer_destroy(&texStream);
+    scene_graph_free(&scene);
+    shader_variants_destroy(&startup.shaders);
+    gl_record_stop();
 
     glfwTerminate();
     return 0;
@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "GlReplay.h"
+#include "MappedFile.h"
+
+/**
+ * @brief Narzędzie: odtwarzanie dziennika poleceń GL (ObjViewer --record).
+ *
+ * Dziennik jest wykonywany jak najszybciej w ukrytym oknie (kontekst
+ * GL 3.3 core, framebuffer o rozmiarze z nagrania, bez swapów i vsync),
+ * co mierzy koszt sterownika i GPU bez aplikacji: wczytywania modeli,
+ * kamery, budowy kolejki rysowania.
+ *
+ * Użycie:
+ *   ObjGlReplay capture.glr [loops]
+ */
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        printf("Usage: %s capture.glr [loops]\n", argv[0]);
+        return 1;
+    }
+    int loops = argc >= 3 ? atoi(argv[2]) : 1;
+    if (loops < 1)
+        loops = 1;
+
+    MappedFile log;
+    if (!mapped_file_open(argv[1], &log))
+    {
+        printf("ERROR: cannot open %s\n", argv[1]);
+        return 1;
+    }
+    GlRecordHeader h;
+    if (log.size < sizeof(h))
+    {
+        printf("ERROR: %s is not a GL command log\n", argv[1]);
+        mapped_file_close(&log);
+        return 1;
+    }
+    memcpy(&h, log.data, sizeof(h));
+
+    if (!glfwInit())
+    {
+        printf("ERROR: GLFW init failed\n");
+        mapped_file_close(&log);
+        return 1;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    int width = h.width > 0 ? (int)h.width : 1280;
+    int height = h.height > 0 ? (int)h.height : 720;
+    GLFWwindow *window = glfwCreateWindow(width, height, "OBJ GL replay", NULL, NULL);
+    if (!window)
+    {
+        printf("ERROR: cannot create an offscreen GL 3.3 context\n");
+        glfwTerminate();
+        mapped_file_close(&log);
+        return 1;
+    }
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        printf("ERROR: failed to load GL functions\n");
+        glfwTerminate();
+        mapped_file_close(&log);
+        return 1;
+    }
+
+    printf("[replay] %s: %.2f MB, %dx%d, %d loop(s)\n", argv[1], log.size / 1048576.0, width, height, loops);
+
+    GlReplayStats st;
+    memset(&st, 0, sizeof(st));
+    int ok = 1;
+    for (int i = 0; i < loops && ok; i++)
+        ok = gl_replay_run(log.data, log.size, &st);
+    gl_replay_print_stats(&st);
+
+    glfwTerminate();
+    mapped_file_close(&log);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "MeshCodec.h"
+#include "ObjLoader.h"
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void print_stats(const MeshCodecStats *st)
+{
+    printf("[codec] %.2f MB -> %.2f MB (%.2fx), ACMR %.3f -> %.3f, max position error %g, %.1f ms\n",
+           st->raw_bytes / 1048576.0, st->packed_bytes / 1048576.0,
+           st->packed_bytes ? (double)st->raw_bytes / (double)st->packed_bytes : 0.0,
+           st->acmr_before, st->acmr_after, st->max_position_error, st->ms);
+}
+
+/**
+ * @brief Porównanie: obj_load(), zwykły zapis binarny (kopia z pamięci) i dekoder .omc.
+ *
+ * Czasy to mediana z iterations przebiegów na danych już w pamięci,
+ * więc liczy się sam koszt CPU (odczyt z dysku dochodzi proporcjonalnie
+ * do rozmiaru pliku).
+ */
+static int run_bench(const char *obj_path, int iterations)
+{
+    ObjModelData model;
+    double t0 = now_ms();
+    if (!obj_load(obj_path, &model))
+        return 1;
+    double obj_ms = now_ms() - t0;
+
+    void *packed;
+    size_t packed_size;
+    MeshCodecStats st;
+    if (!mesh_codec_encode(&model, &packed, &packed_size, &st))
+    {
+        obj_free(&model);
+        return 1;
+    }
+    print_stats(&st);
+
+    const MeshCodecHeader *h = mesh_codec_header(packed, packed_size);
+    size_t raw_size = model.vertex_count * sizeof(Vertex) + model.index_count * sizeof(unsigned int);
+    size_t out_size = (size_t)h->vertex_count * sizeof(Vertex) + (size_t)h->index_count * sizeof(unsigned int);
+    unsigned char *raw = (unsigned char *)malloc(raw_size ? raw_size : 1);
+    unsigned char *copy = (unsigned char *)malloc(raw_size ? raw_size : 1);
+    Vertex *vertices = (Vertex *)malloc(((size_t)h->vertex_count + 1) * sizeof(Vertex));
+    unsigned int *indices = (unsigned int *)malloc(((size_t)h->index_count + 1) * sizeof(unsigned int));
+    double *raw_ms = (double *)malloc((size_t)iterations * sizeof(double));
+    double *dec_ms = (double *)malloc((size_t)iterations * sizeof(double));
+    int ok = raw && copy && vertices && indices && raw_ms && dec_ms;
+
+    if (ok)
+    {
+        memcpy(raw, model.vertices, model.vertex_count * sizeof(Vertex));
+        memcpy(raw + model.vertex_count * sizeof(Vertex), model.indices, model.index_count * sizeof(unsigned int));
+
+        for (int it = 0; it < iterations && ok; it++)
+        {
+            t0 = now_ms();
+            memcpy(copy, raw, raw_size);
+            raw_ms[it] = now_ms() - t0;
+
+            t0 = now_ms();
+            ok = mesh_codec_decode(packed, packed_size, vertices, indices);
+            dec_ms[it] = now_ms() - t0;
+        }
+        if (!ok)
+            printf("ERROR: decode failed\n");
+    }
+
+    if (ok)
+    {
+        qsort(raw_ms, (size_t)iterations, sizeof(double), cmp_double);
+        qsort(dec_ms, (size_t)iterations, sizeof(double), cmp_double);
+        double raw_med = raw_ms[iterations / 2], dec_med = dec_ms[iterations / 2];
+
+        printf("  obj_load():   %8.2f MB  %9.2f ms\n", raw_size / 1048576.0, obj_ms);
+        printf("  binary copy:  %8.2f MB  %9.3f ms  %6.2f GB/s\n", raw_size / 1048576.0, raw_med,
+               raw_med > 0.0 ? raw_size / (raw_med * 1.0e6) : 0.0);
+        printf("  .omc decode:  %8.2f MB  %9.3f ms  %6.2f GB/s (output)\n", packed_size / 1048576.0, dec_med,
+               dec_med > 0.0 ? out_size / (dec_med * 1.0e6) : 0.0);
+    }
+
+    free(raw);
+    free(copy);
+    free(vertices);
+    free(indices);
+    free(raw_ms);
+    free(dec_ms);
+    free(packed);
+    obj_free(&model);
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Narzędzie: kompresja siatek OBJ do .omc i pomiar dekodera.
+ *
+ * Użycie:
+ *   ObjMeshCodec encode model.obj model.omc
+ *   ObjMeshCodec bench model.obj [iterations]
+ */
+int main(int argc, char **argv)
+{
+    if (argc >= 4 && strcmp(argv[1], "encode") == 0)
+    {
+        ObjModelData model;
+        if (!obj_load(argv[2], &model))
+            return 1;
+
+        MeshCodecStats st;
+        int ok = mesh_codec_save(argv[3], &model, &st);
+        if (ok)
+            print_stats(&st);
+        obj_free(&model);
+        return ok ? 0 : 1;
+    }
+    if (argc >= 3 && strcmp(argv[1], "bench") == 0)
+    {
+        int iterations = argc >= 4 ? atoi(argv[3]) : 20;
+        return run_bench(argv[2], iterations > 0 ? iterations : 1);
+    }
+
+    printf("Usage: %s encode model.obj model.omc\n"
+           "       %s bench model.obj [iterations]\n",
+           argv[0], argv[0]);
+    return 1;
+}
@@ -0,0 +1,37 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Octree.h"
+
+/**
+ * @brief Narzędzie: dzieli duży OBJ na plik .oct do stronicowania w viewerze.
+ *
+ * Użycie: ObjOctreeBuild input.obj output.oct [--max-tris N] [--max-depth N]
+ */
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        printf("Usage: %s input.obj output.oct [--max-tris N] [--max-depth N]\n", argv[0]);
+        return 1;
+    }
+
+    OctreeBuildParams params;
+    octree_build_params_default(&params);
+
+    for (int i = 3; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--max-tris") == 0 && i + 1 < argc)
+            params.max_triangles = (unsigned int)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--max-depth") == 0 && i + 1 < argc)
+            params.max_depth = (unsigned int)strtoul(argv[++i], NULL, 10);
+        else
+        {
+            printf("ERROR: unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    return octree_build_from_obj(argv[1], argv[2], &params) ? 0 : 1;
+}
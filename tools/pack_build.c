@@ -0,0 +1,22 @@
+#include <stdio.h>
+
+#include "AssetPack.h"
+
+/**
+ * @brief Narzędzie: pakuje luźne zasoby do jednego pliku .pak.
+ *
+ * Użycie: ObjPackBuild output.pak file.obj file.mtl [texture.png ...]
+ *
+ * Ścieżki podane tutaj są nazwami wpisów, więc należy je podawać tak,
+ * jak odwołuje się do nich viewer (względem katalogu roboczego).
+ */
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        printf("Usage: %s output.pak file.obj file.mtl [texture ...]\n", argv[0]);
+        return 1;
+    }
+
+    return asset_pack_build(argv[1], (const char **)(argv + 2), argc - 2) ? 0 : 1;
+}
@@ -0,0 +1,396 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cglm/cglm.h>
+#include <stb_image.h>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include "ObjLoader.h"
+#include "Material.h"
+#include "SoftRaster.h"
+
+/**
+ * @brief Narzędzie: renderuje OBJ na CPU (bez GPU) — złote obrazy na CI i miniatury.
+ *
+ * Użycie: ObjSoftRender [opcje] model.obj [model2.obj ...]
+ *
+ * Materiał: plik .mtl o tej samej nazwie co .obj (jeśli istnieje).
+ * Światło i cieniowanie jak w viewerze (basic.frag), kamera ustawiana
+ * automatycznie na podstawie AABB modelu.
+ */
+
+typedef struct RenderSettings
+{
+    int width, height;
+    int threads;
+    float yaw, pitch; // stopnie
+    const char *output;
+    const char *golden;
+    int tolerance;
+    int bench_frames; // 0 -> bez benchmarku
+} RenderSettings;
+
+typedef struct LoadedModel
+{
+    ObjModelData data;
+    SoftMaterial material;
+    TextureImage texture;
+    mat4 view_proj;
+} LoadedModel;
+
+static const float kLightDir[3] = {-0.3f, -1.0f, -0.5f}; // jak uLightDir w viewerze
+static const float kClearColor[3] = {0.1f, 0.12f, 0.16f};
+
+static void print_usage(const char *exe)
+{
+    printf("Usage: %s [options] model.obj [model2.obj ...]\n"
+           "  -o PATH         output image (.png or .ppm); with several models a directory\n"
+           "  --size WxH      image size (default 512x512)\n"
+           "  --threads N     worker threads (default: all cores)\n"
+           "  --yaw DEG       camera orbit around the model (default 30)\n"
+           "  --pitch DEG     camera elevation (default 20)\n"
+           "  --compare FILE  golden image; exit code 1 if a channel differs by more than --tolerance\n"
+           "  --tolerance N   allowed per-channel difference (default 2)\n"
+           "  --bench FRAMES  render FRAMES frames per thread count, print triangles/s and pixels/s\n",
+           exe);
+}
+
+static int has_suffix(const char *s, const char *suffix)
+{
+    size_t n = strlen(s), m = strlen(suffix);
+    return n >= m && strcmp(s + n - m, suffix) == 0;
+}
+
+/**
+ * @brief model.obj -> model.mtl (wynik w buforze out).
+ */
+static void mtl_path_for(const char *obj, char *out, size_t size)
+{
+    snprintf(out, size, "%s", obj);
+    size_t n = strlen(out);
+    if (n >= 4 && strcmp(out + n - 4, ".obj") == 0)
+        memcpy(out + n - 4, ".mtl", 4);
+}
+
+static int load_model(const char *path, const RenderSettings *s, LoadedModel *m)
+{
+    memset(m, 0, sizeof(*m));
+    if (!obj_load_ex(path, &m->data, NULL))
+    {
+        printf("Failed to load OBJ: %s\n", path);
+        return 0;
+    }
+
+    m->material.diffuse[0] = m->material.diffuse[1] = m->material.diffuse[2] = 1.0f;
+
+    char mtl[1024];
+    mtl_path_for(path, mtl, sizeof(mtl));
+    FILE *f = fopen(mtl, "r");
+    if (f)
+    {
+        fclose(f);
+        MaterialDesc desc;
+        if (material_parse_mtl(mtl, &desc))
+        {
+            memcpy(m->material.diffuse, desc.diffuse, sizeof(desc.diffuse));
+            if (desc.diffuseMap[0] && texture_image_load(desc.diffuseMap, &m->texture))
+                m->material.texture = &m->texture;
+        }
+    }
+
+    // kamera na sferze opisanej na AABB
+    vec3 bmin, bmax, center;
+    obj_compute_bounds(&m->data, bmin, bmax);
+    glm_vec3_lerp(bmin, bmax, 0.5f, center);
+    float radius = glm_vec3_distance(bmin, bmax) * 0.5f;
+    if (radius <= 0.0f)
+        radius = 1.0f;
+
+    float fov = glm_rad(60.0f);
+    float dist = radius / sinf(fov * 0.5f) * 1.05f;
+    float yaw = glm_rad(s->yaw), pitch = glm_rad(s->pitch);
+    vec3 eye = {center[0] + dist * cosf(pitch) * sinf(yaw),
+                center[1] + dist * sinf(pitch),
+                center[2] + dist * cosf(pitch) * cosf(yaw)};
+    vec3 up = {0.0f, 1.0f, 0.0f};
+
+    float nearPlane = dist - radius * 1.5f;
+    if (nearPlane < dist * 0.01f)
+        nearPlane = dist * 0.01f;
+
+    mat4 view, proj;
+    glm_lookat(eye, center, up, view);
+    glm_perspective(fov, (float)s->width / (float)s->height, nearPlane, dist + radius * 1.5f, proj);
+    glm_mat4_mul(proj, view, m->view_proj);
+    return 1;
+}
+
+static void free_model(LoadedModel *m)
+{
+    obj_free(&m->data);
+    if (m->material.texture)
+        texture_image_free(&m->texture);
+}
+
+static void render_model(SoftRenderer *r, LoadedModel *m)
+{
+    mat4 model;
+    mat3 normal;
+    glm_mat4_identity(model);
+    glm_mat3_identity(normal);
+
+    soft_renderer_clear(r, kClearColor);
+    soft_renderer_draw(r, m->data.vertices, m->data.vertex_count,
+                       m->data.indices, m->data.index_count,
+                       (const float *)model, (const float *)normal,
+                       (const float *)m->view_proj, kLightDir, &m->material);
+}
+
+static int write_image(const SoftRenderer *r, const char *path)
+{
+    if (has_suffix(path, ".png"))
+    {
+        // bufor RGBA8 w kolejności bajtów r, g, b, a
+        if (!stbi_write_png(path, r->width, r->height, 4, r->color, r->width * 4))
+        {
+            printf("Cannot write image: %s\n", path);
+            return 0;
+        }
+        return 1;
+    }
+    return soft_renderer_write_ppm(r, path);
+}
+
+/**
+ * @brief Porównanie ze złotym obrazem (PNG lub PPM).
+ *
+ * @return 1 jeśli żaden kanał nie różni się o więcej niż tolerance.
+ */
+static int compare_golden(const SoftRenderer *r, const char *path, int tolerance)
+{
+    int w, h, n;
+    stbi_set_flip_vertically_on_load(0);
+    unsigned char *golden = stbi_load(path, &w, &h, &n, 4);
+    if (!golden)
+    {
+        printf("Cannot load golden image: %s\n", path);
+        return 0;
+    }
+    if (w != r->width || h != r->height)
+    {
+        printf("[golden] size mismatch: %dx%d vs %dx%d\n", w, h, r->width, r->height);
+        stbi_image_free(golden);
+        return 0;
+    }
+
+    size_t bad = 0;
+    int maxDiff = 0;
+    size_t pixels = (size_t)w * (size_t)h;
+    for (size_t i = 0; i < pixels; i++)
+    {
+        int worst = 0;
+        for (int k = 0; k < 3; k++)
+        {
+            int a = (int)((r->color[i] >> (8 * k)) & 0xff);
+            int d = abs(a - (int)golden[i * 4 + k]);
+            if (d > worst)
+                worst = d;
+        }
+        if (worst > maxDiff)
+            maxDiff = worst;
+        if (worst > tolerance)
+            bad++;
+    }
+    stbi_image_free(golden);
+
+    printf("[golden] %s: max diff %d, %zu of %zu pixels over tolerance %d -> %s\n",
+           path, maxDiff, bad, pixels, tolerance, bad ? "FAIL" : "OK");
+    return bad == 0;
+}
+
+/**
+ * @brief Przepustowość dla liczby wątków 1, 2, 4, ... aż do liczby rdzeni.
+ */
+static int run_bench(LoadedModel *m, const RenderSettings *s)
+{
+    SoftRenderer probe;
+    if (!soft_renderer_init(&probe, s->width, s->height, s->threads))
+        return 0;
+    int maxThreads = probe.threads;
+    soft_renderer_destroy(&probe);
+
+    uint32_t *reference = NULL;
+    double baseMs = 0.0;
+
+    printf("[bench-soft] %dx%d, %zu triangles, %d frames\n",
+           s->width, s->height, m->data.index_count / 3, s->bench_frames);
+    printf("[bench-soft] %7s %9s %12s %12s %8s %8s %8s %8s %8s %s\n",
+           "threads", "ms/frame", "Mtris/s", "Mpixels/s", "speedup",
+           "xform", "bin", "raster", "steals", "image");
+
+    int counts[16], countN = 0;
+    for (int t = 1; t < maxThreads && countN < 15; t *= 2)
+        counts[countN++] = t;
+    counts[countN++] = maxThreads;
+
+    for (int c = 0; c < countN; c++)
+    {
+        int t = counts[c];
+        SoftRenderer r;
+        if (!soft_renderer_init(&r, s->width, s->height, t))
+            break;
+
+        render_model(&r, m); // rozgrzewka (alokacje koszy)
+        soft_renderer_reset_stats(&r);
+        for (int f = 0; f < s->bench_frames; f++)
+            render_model(&r, m);
+
+        const SoftRasterStats *st = &r.stats;
+        double frames = (double)s->bench_frames;
+        double ms = st->total_ms / frames;
+        if (c == 0)
+            baseMs = ms;
+
+        // wynik nie może zależeć od liczby wątków
+        size_t bytes = (size_t)r.width * (size_t)r.height * sizeof(uint32_t);
+        const char *image = "reference";
+        if (!reference)
+        {
+            reference = (uint32_t *)malloc(bytes);
+            if (reference)
+                memcpy(reference, r.color, bytes);
+        }
+        else
+        {
+            image = memcmp(reference, r.color, bytes) == 0 ? "identical" : "DIFFERENT";
+        }
+
+        printf("[bench-soft] %7d %9.2f %12.2f %12.2f %7.2fx %8.2f %8.2f %8.2f %8lu %s\n",
+               r.threads, ms,
+               (double)st->triangles / (st->total_ms / 1000.0) / 1.0e6,
+               (double)st->pixels / (st->total_ms / 1000.0) / 1.0e6,
+               baseMs / ms,
+               st->transform_ms / frames, st->bin_ms / frames, st->raster_ms / frames,
+               st->steals, image);
+
+        soft_renderer_destroy(&r);
+    }
+    free(reference);
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    RenderSettings s = {512, 512, 0, 30.0f, 20.0f, NULL, NULL, 2, 0};
+    const char *inputs[256];
+    int inputCount = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *a = argv[i];
+        const char *next = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(a, "-h") == 0 || strcmp(a, "--help") == 0)
+        {
+            print_usage(argv[0]);
+            return 0;
+        }
+        else if (strcmp(a, "-o") == 0 && next)
+            s.output = argv[++i];
+        else if (strcmp(a, "--size") == 0 && next)
+        {
+            if (sscanf(argv[++i], "%dx%d", &s.width, &s.height) != 2 || s.width <= 0 || s.height <= 0)
+            {
+                printf("ERROR: invalid size: %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (strcmp(a, "--threads") == 0 && next)
+            s.threads = atoi(argv[++i]);
+        else if (strcmp(a, "--yaw") == 0 && next)
+            s.yaw = (float)atof(argv[++i]);
+        else if (strcmp(a, "--pitch") == 0 && next)
+            s.pitch = (float)atof(argv[++i]);
+        else if (strcmp(a, "--compare") == 0 && next)
+            s.golden = argv[++i];
+        else if (strcmp(a, "--tolerance") == 0 && next)
+            s.tolerance = atoi(argv[++i]);
+        else if (strcmp(a, "--bench") == 0 && next)
+            s.bench_frames = atoi(argv[++i]);
+        else if (a[0] == '-')
+        {
+            printf("ERROR: unknown option: %s\n", a);
+            print_usage(argv[0]);
+            return 1;
+        }
+        else if (inputCount < (int)(sizeof(inputs) / sizeof(inputs[0])))
+            inputs[inputCount++] = a;
+    }
+
+    if (inputCount == 0)
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (s.golden && inputCount != 1)
+    {
+        printf("ERROR: --compare needs exactly one model\n");
+        return 1;
+    }
+
+    SoftRenderer r;
+    if (!soft_renderer_init(&r, s.width, s.height, s.threads))
+    {
+        printf("ERROR: software renderer init failed\n");
+        return 1;
+    }
+
+    int ok = 1;
+    for (int i = 0; i < inputCount; i++)
+    {
+        LoadedModel m;
+        if (!load_model(inputs[i], &s, &m))
+        {
+            ok = 0;
+            continue;
+        }
+
+        if (s.bench_frames > 0)
+            ok &= run_bench(&m, &s);
+
+        soft_renderer_reset_stats(&r);
+        render_model(&r, &m);
+        printf("[soft] %s: %zu triangles, %zu pixels, %.2f ms on %d threads\n",
+               inputs[i], r.stats.triangles, r.stats.pixels, r.stats.total_ms, r.threads);
+
+        if (s.output)
+        {
+            char path[1024];
+            if (inputCount == 1)
+            {
+                snprintf(path, sizeof(path), "%s", s.output);
+            }
+            else
+            {
+                // miniatury: katalog/nazwa_modelu.png
+                const char *base = strrchr(inputs[i], '/');
+                base = base ? base + 1 : inputs[i];
+                snprintf(path, sizeof(path), "%s/%.*s.png", s.output,
+                         has_suffix(base, ".obj") ? (int)strlen(base) - 4 : (int)strlen(base), base);
+            }
+            ok &= write_image(&r, path);
+        }
+
+        if (s.golden)
+            ok &= compare_golden(&r, s.golden, s.tolerance);
+
+        free_model(&m);
+    }
+
+    soft_renderer_destroy(&r);
+    return ok ? 0 : 1;
+}